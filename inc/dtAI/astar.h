@@ -25,12 +25,11 @@
 #include <dtAI/export.h> //included to get rid of warning 4355- 'this' used in base member initializer list
 
 #include <dtAI/astarconfig.h>
+#include <dtAI/astarpolicy.h>
 #include <dtAI/pathfinding.h>
 #include <dtUtil/functor.h>
 
-#include <algorithm>
 #include <vector>
-#include <set>
 
 namespace dtAI
 {
@@ -59,6 +58,10 @@ namespace dtAI
     *               granularity of time is only relevant to the user and should match the AStarConfig's
     *               MaxTime.
     *
+    *        Policy: Chooses the open list, closed list and node allocation, see AStarPolicy.h.
+    *                The default is AStarDefaultPolicy.  For large graphs use AStarIndexedPolicy, which
+    *                keeps every list operation at O(log n) or better, but needs a hash for DataType.
+    *
     * @usage To find a path between two points you can call Reset() with the two points
     *        and then FindPath().  Alternatively, you can set a config type which contains
     *        the path points and holds statistical info as well as pathing constraints.  If you
@@ -81,20 +84,21 @@ namespace dtAI
     *
     * Bradley Anderegg
     */
-   template<class _NodeType, class _CostFunc, class _Container, class _Timer>
+   template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy = AStarDefaultPolicy>
    class AStar
    {
    public:
       typedef _NodeType node_type;
       typedef typename _NodeType::cost_type cost_type;
       typedef typename _NodeType::data_type data_type;
-      typedef std::vector<node_type*> AStarContainer;
-      typedef std::set<data_type> AStarClosedContainer;
-      typedef typename AStarContainer::iterator AStarIterator;
+      typedef typename _Policy::template Containers<_NodeType> policy_containers;
+      typedef typename policy_containers::open_list AStarContainer;
+      typedef typename policy_containers::closed_list AStarClosedContainer;
+      typedef typename policy_containers::node_storage AStarNodeStorage;
       typedef _CostFunc cost_function;
       typedef _Container container_type;
       typedef AStarConfig<data_type, cost_type, container_type> config_type;
-      typedef AStar<node_type, cost_function, container_type, _Timer> MyType;
+      typedef AStar<node_type, cost_function, container_type, _Timer, _Policy> MyType;
 
       typedef dtUtil::Functor<node_type*, TYPELIST_4(node_type*, data_type, cost_type, cost_type)> CreateNodeFunctor;
 
@@ -175,26 +179,24 @@ namespace dtAI
       void FreeMem();
 
       /**
-       * Internal helper functions, pulled out of main loop to be optimized
-       * at a later date
+       * Internal helper functions, pulled out of main loop
        */
       void AddNodeLink(node_type* pParent, data_type pData);
-      typename AStarContainer::iterator Contains(AStarContainer& pCont, const data_type& pData);
-      typename AStarClosedContainer::iterator Contains(AStarClosedContainer& pCont, const data_type& pData);
-      void Remove(AStarContainer& pCont, typename AStarContainer::iterator iterToErase);
-      node_type* FindLowestCost(AStarContainer& pCont);
-      void Insert(AStarContainer& pCont, node_type* pNode);
-      void Insert(AStarClosedContainer& pCont, const data_type& pData);
+      node_type* CreateNodeLink(node_type* pParent, data_type pData);
+      node_type* NewNode(node_type* pParent, data_type pData, cost_type pGn, cost_type pHn);
 
       node_type* CreateNode(node_type* pParent, data_type datatype, cost_type pGn, cost_type pHn);
 
       config_type mConfig;
-      AStarContainer mOpen, mDeleteMe;
+      AStarContainer mOpen;
       AStarClosedContainer mClosed;
+      AStarNodeStorage mNodes;
       cost_function mCostFunc;
       _Timer mTimer;
 
       CreateNodeFunctor mFuncCreateNode;
+      /// true when the nodes come from a user supplied functor, so mNodes must take ownership of them
+      bool mAdoptCreatedNodes;
    };
 
 #include "astar.inl"
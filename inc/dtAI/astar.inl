@@ -19,82 +19,49 @@
  * Bradley Anderegg 06/28/2006
  */
 
-struct delete_func
-{
-   template<class T>
-      void operator()(T* pElement)
-   {
-      delete pElement;
-      pElement = NULL;
-   }
-};
-
-
-struct node_type_gtr_func
-{
-   template<class T>
-   bool operator()(T& pElement1, T& pElement2)
-   {
-      return pElement2->operator<(*pElement1);
-   }
-};
-
-
-template<class T, class E>
-struct node_type_comp_func
-{
-   node_type_comp_func(const T data): mData(data){}
-
-   bool operator()(const E* pElement)
-   {
-      return pElement->GetData() == mData;
-   }
-private:
-   const T mData;
-};
-
-
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-AStar<_NodeType, _CostFunc, _Container, _Timer>::AStar()
-   : mFuncCreateNode(this, &AStar<_NodeType, _CostFunc, _Container, _Timer>::CreateNode)
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::AStar()
+   : mFuncCreateNode(this, &AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::CreateNode)
+   , mAdoptCreatedNodes(false)
 {
 
 }
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-AStar<_NodeType, _CostFunc, _Container, _Timer>::AStar(CreateNodeFunctor createFunc)
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::AStar(CreateNodeFunctor createFunc)
    : mFuncCreateNode(createFunc)
+   , mAdoptCreatedNodes(true)
 {
 }
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-AStar<_NodeType, _CostFunc, _Container, _Timer>::AStar(const config_type& pConfig):
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::AStar(const config_type& pConfig):
    mConfig(pConfig)
+   , mFuncCreateNode(this, &AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::CreateNode)
+   , mAdoptCreatedNodes(false)
 {
    AddNodeLink(0, pConfig.mStart);
 }
 
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-AStar<_NodeType, _CostFunc, _Container, _Timer>::~AStar()
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::~AStar()
 {
    FreeMem();
 }
 
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-void AStar<_NodeType, _CostFunc, _Container, _Timer>::FreeMem()
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+void AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::FreeMem()
 {
-   std::for_each(mDeleteMe.begin(), mDeleteMe.end(), delete_func());
-
-   mOpen.clear();
-   mDeleteMe.clear();
-   mClosed.clear();
+   mOpen.Clear();
+   mClosed.Clear();
+   mNodes.Clear();
 }
 
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-void AStar<_NodeType, _CostFunc, _Container, _Timer>::Reset(const config_type& pConfig)
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+void AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::Reset(const config_type& pConfig)
 {
    FreeMem();
    mConfig = pConfig;
@@ -102,16 +69,16 @@ void AStar<_NodeType, _CostFunc, _Container, _Timer>::Reset(const config_type& p
 }
 
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-void AStar<_NodeType, _CostFunc, _Container, _Timer>::Reset(data_type pFrom, data_type pTo)
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+void AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::Reset(data_type pFrom, data_type pTo)
 {
    FreeMem();
    mConfig.Reset(pFrom, pTo);
    AddNodeLink(0, mConfig.Start());
 }
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-void AStar<_NodeType, _CostFunc, _Container, _Timer>::Reset(const std::vector<data_type>& pFrom, const std::vector<data_type>& pTo)
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+void AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::Reset(const std::vector<data_type>& pFrom, const std::vector<data_type>& pTo)
 {
    if (pFrom.empty() || pTo.empty()) { return; }
 
@@ -126,95 +93,52 @@ void AStar<_NodeType, _CostFunc, _Container, _Timer>::Reset(const std::vector<da
 
    while (iter != endOfList)
    {
-      node_type* newNode = mFuncCreateNode(NULL, *iter, mCostFunc(pFrom[0], *iter), mCostFunc(*iter, pTo[0]));
-      mOpen.push_back(newNode);
-      mDeleteMe.push_back(newNode);
+      mOpen.Push(NewNode(NULL, *iter, mCostFunc(pFrom[0], *iter), mCostFunc(*iter, pTo[0])));
       ++iter;
    }
+}
 
-   std::make_heap(mOpen.begin(), mOpen.end(), node_type_gtr_func());
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+void AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::AddNodeLink(node_type* pParent, data_type pData)
+{
+   mOpen.Push(CreateNodeLink(pParent, pData));
 }
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-void AStar<_NodeType, _CostFunc, _Container, _Timer>::AddNodeLink(node_type* pParent, data_type pData)
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+_NodeType* AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::CreateNodeLink(node_type* pParent, data_type pData)
 {
    if (!pParent)
    {
-      node_type* newNode = mFuncCreateNode(NULL, pData, 0, mCostFunc(mConfig.Start(), mConfig.Finish()));
-      Insert(mOpen, newNode);
-      mDeleteMe.push_back(newNode);
+      return NewNode(NULL, pData, 0, mCostFunc(mConfig.Start(), mConfig.Finish()));
    }
    else
    {
       cost_type costFromParent = mCostFunc(pParent->GetData(), pData);
       cost_type costToFinish   = mCostFunc(pData, mConfig.Finish());
-      node_type* newNode = mFuncCreateNode(pParent, pData, pParent->GetCostToNode() + costFromParent, costToFinish);
-      Insert(mOpen, newNode);
-      mDeleteMe.push_back(newNode);
+      return NewNode(pParent, pData, pParent->GetCostToNode() + costFromParent, costToFinish);
    }
 }
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-void AStar<_NodeType, _CostFunc, _Container, _Timer>::Insert(AStarContainer& pCont, node_type* pNode)
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+_NodeType* AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::NewNode(node_type* pParent, data_type pData, cost_type pGn, cost_type pHn)
 {
-   pCont.push_back(pNode);
-   std::push_heap(pCont.begin(), pCont.end(), node_type_gtr_func());
-}
-
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-void AStar<_NodeType, _CostFunc, _Container, _Timer>::Insert(AStarClosedContainer& pCont, const data_type& pData)
-{
-   pCont.insert(pData);
-}
-
-// This needs to be optimized once we have a more suitable container implementation
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-typename AStar<_NodeType, _CostFunc, _Container, _Timer>::AStarContainer::iterator AStar<_NodeType, _CostFunc, _Container, _Timer>::Contains(AStarContainer& pCont, const data_type& pData)
-{
-   return std::find_if (pCont.begin(), pCont.end(), node_type_comp_func<data_type, node_type>(pData));
-}
-
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-typename AStar<_NodeType, _CostFunc, _Container, _Timer>::AStarClosedContainer::iterator AStar<_NodeType, _CostFunc, _Container, _Timer>::Contains(AStarClosedContainer& pCont, const data_type& pData)
-{
-   return pCont.find(pData);
-}
-
-// This needs to be optimized once we have a more suitable container implementation
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-void AStar<_NodeType, _CostFunc, _Container, _Timer>::Remove(AStarContainer& pCont, typename AStarContainer::iterator iterToErase)
-{
-   pCont.erase(iterToErase, iterToErase + 1);
-   std::make_heap(mOpen.begin(), mOpen.end(), node_type_gtr_func());
-}
-
-
-// This needs to be optimized once we have a more suitable container implementation
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-_NodeType* AStar<_NodeType, _CostFunc, _Container, _Timer>::FindLowestCost(AStarContainer& pCont)
-{
-   if (pCont.empty())
-   {
-      return 0;
-   }
-   else
+   node_type* newNode = mFuncCreateNode(pParent, pData, pGn, pHn);
+   if (mAdoptCreatedNodes)
    {
-      node_type* node = pCont.front();
-      std::pop_heap(pCont.begin(), pCont.end(), node_type_gtr_func());
-      pCont.pop_back();
-      return node;
+      mNodes.Adopt(newNode);
    }
+   return newNode;
 }
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-_NodeType* AStar<_NodeType, _CostFunc, _Container, _Timer>::CreateNode(node_type* pParent, data_type datatype, cost_type pGn, cost_type pHn)
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+_NodeType* AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::CreateNode(node_type* pParent, data_type datatype, cost_type pGn, cost_type pHn)
 {
-   return new node_type(pParent, datatype, pGn, pHn);
+   return mNodes.Create(pParent, datatype, pGn, pHn);
 }
 
 
-template<class _NodeType, class _CostFunc, class _Container, class _Timer>
-PathFindResult AStar<_NodeType, _CostFunc, _Container, _Timer>::FindPath()
+template<class _NodeType, class _CostFunc, class _Container, class _Timer, class _Policy>
+PathFindResult AStar<_NodeType, _CostFunc, _Container, _Timer, _Policy>::FindPath()
 {
    // increment our iteration
    // reset our constraint bookkeeping vars
@@ -232,7 +156,7 @@ PathFindResult AStar<_NodeType, _CostFunc, _Container, _Timer>::FindPath()
       }
 
       // start with the node of lowest cost in the open list
-      node_type* pStart = FindLowestCost(mOpen);
+      node_type* pStart = mOpen.Pop();
 
       // check if we found a path to the end or if we have exceeded a constraint
       cost_type pCost = (pStart->GetCostToNode() + pStart->GetCostToGoal());
@@ -247,8 +171,7 @@ PathFindResult AStar<_NodeType, _CostFunc, _Container, _Timer>::FindPath()
       // if we have exceeded a constraint or found a path to the end return
       if (pHasPathToFinish || pExceededMaxCost || pHasExceededTimeLimit || pAtOrExceedingMaxDepth || (mConfig.mNodesExplored >= mConfig.mMaxNodesExplored))
       {
-         // we simply add it back to the container so it will be deleted later
-         mClosed.insert(pStart->GetData());
+         mClosed.Insert(pStart->GetData());
 
          // \todo combine partial lists instead of clearing them
          mConfig.mResult.clear();
@@ -272,22 +195,21 @@ PathFindResult AStar<_NodeType, _CostFunc, _Container, _Timer>::FindPath()
          ++mConfig.mNodesExplored;
 
          // add it onto the closed list
-         Insert(mClosed, pStart->GetData());
+         mClosed.Insert(pStart->GetData());
 
          // we will iterate through the potential places this node can take us
          typename node_type::iterator iter = pStart->begin();
          typename node_type::iterator endOfList = pStart->end();
 
-         // \todo refactor this with a better container type
          while (iter != endOfList)
          {
             data_type pNode = *iter;
             // if its not in the closed list
-            if (!mConfig.mCheckClosedList || Contains(mClosed, pNode) == mClosed.end())
+            if (!mConfig.mCheckClosedList || !mClosed.Contains(pNode))
             {
                // if it isnt in the open list
-               typename AStarContainer::iterator pNodeLinkIter = Contains(mOpen, pNode);
-               if (pNodeLinkIter == mOpen.end())
+               node_type* pOpenNode = mOpen.Find(pNode);
+               if (pOpenNode == NULL)
                {
                   // create a new path in the open list
                   AddNodeLink(pStart, pNode);
@@ -297,12 +219,11 @@ PathFindResult AStar<_NodeType, _CostFunc, _Container, _Timer>::FindPath()
                   // compute cost to pNode from pStart
                   cost_type pNewCost = pStart->GetCostToNode() + mCostFunc(pStart->GetData(), pNode);
 
-                  // if the new g(n) cost is cheaper then the old one delete the old one
-                  // and add the new one as the best potential path to pNode
-                  if (pNewCost < (*pNodeLinkIter)->GetCostToNode())
+                  // if the new g(n) cost is cheaper then the old one replace the old one
+                  // with the new one as the best potential path to pNode
+                  if (pNewCost < pOpenNode->GetCostToNode())
                   {
-                     Remove(mOpen, pNodeLinkIter);
-                     AddNodeLink(pStart, pNode);
+                     mOpen.Replace(pOpenNode, CreateNodeLink(pStart, pNode));
                   }
                }
             }
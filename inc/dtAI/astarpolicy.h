@@ -0,0 +1,593 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2004-2006 MOVES Institute
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef __DELTA_ASTARPOLICY_H__
+#define __DELTA_ASTARPOLICY_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <set>
+#include <vector>
+
+namespace dtAI
+{
+   /**
+    * The bookkeeping containers AStar uses are chosen by its _Policy template argument.
+    * A policy is a class with a nested template Containers<NodeType> that defines three types:
+    *
+    *    open_list:    the nodes waiting to be expanded, ordered by cost.  Must support
+    *                  Push(node), Pop(), Find(data), Replace(oldNode, cheaperNode), empty() and Clear().
+    *
+    *    closed_list:  the data of the nodes already expanded.  Must support Insert(data),
+    *                  Contains(data) and Clear().
+    *
+    *    node_storage: owns every node created during a search.  Must support
+    *                  Create(parent, data, gn, hn), Adopt(node) for nodes made by a user supplied
+    *                  creation functor, and Clear(), which frees them all.
+    *
+    * AStarDefaultPolicy is the original implementation and works with any data type that has
+    * operator== and operator<.  AStarIndexedPolicy is much faster on large graphs, but needs a hash
+    * function for the data type, see AStarDataHash.
+    */
+
+   ////////////////////////////////////////////////////////////////////////////////
+   // AStarDefaultPolicy containers
+   ////////////////////////////////////////////////////////////////////////////////
+
+   /**
+    * A binary heap in a vector.  Finding a node is a linear search and replacing one re-sorts the heap.
+    */
+   template<class _NodeType>
+   class AStarHeapOpenList
+   {
+   public:
+      typedef _NodeType node_type;
+      typedef typename _NodeType::data_type data_type;
+
+      bool empty() const { return mHeap.empty(); }
+      size_t size() const { return mHeap.size(); }
+
+      void Push(node_type* pNode)
+      {
+         mHeap.push_back(pNode);
+         std::push_heap(mHeap.begin(), mHeap.end(), GreaterCost());
+      }
+
+      node_type* Pop()
+      {
+         if (mHeap.empty())
+         {
+            return NULL;
+         }
+
+         node_type* node = mHeap.front();
+         std::pop_heap(mHeap.begin(), mHeap.end(), GreaterCost());
+         mHeap.pop_back();
+         return node;
+      }
+
+      /// @return the open node holding the data, or NULL if there isn't one.
+      node_type* Find(const data_type& pData) const
+      {
+         typename std::vector<node_type*>::const_iterator i = std::find_if(mHeap.begin(), mHeap.end(), SameData(pData));
+         return (i == mHeap.end()) ? NULL : *i;
+      }
+
+      /// Swaps an open node for a cheaper path to the same data.
+      void Replace(node_type* pOldNode, node_type* pNewNode)
+      {
+         typename std::vector<node_type*>::iterator i = std::find(mHeap.begin(), mHeap.end(), pOldNode);
+         if (i != mHeap.end())
+         {
+            mHeap.erase(i);
+            std::make_heap(mHeap.begin(), mHeap.end(), GreaterCost());
+         }
+         Push(pNewNode);
+      }
+
+      void Clear() { mHeap.clear(); }
+
+   private:
+      struct GreaterCost
+      {
+         bool operator()(const node_type* pElement1, const node_type* pElement2) const
+         {
+            return *pElement2 < *pElement1;
+         }
+      };
+
+      struct SameData
+      {
+         SameData(const data_type& pData): mData(pData) {}
+         bool operator()(const node_type* pElement) const { return pElement->GetData() == mData; }
+         const data_type& mData;
+      };
+
+      std::vector<node_type*> mHeap;
+   };
+
+   /**
+    * The closed list as a std::set.
+    */
+   template<class _DataType>
+   class AStarSetClosedList
+   {
+   public:
+      void Insert(const _DataType& pData) { mClosed.insert(pData); }
+      bool Contains(const _DataType& pData) const { return mClosed.find(pData) != mClosed.end(); }
+      void Clear() { mClosed.clear(); }
+
+   private:
+      std::set<_DataType> mClosed;
+   };
+
+   /**
+    * Allocates every node with new and deletes them on Clear().
+    */
+   template<class _NodeType>
+   class AStarNodeList
+   {
+   public:
+      typedef _NodeType node_type;
+      typedef typename _NodeType::data_type data_type;
+      typedef typename _NodeType::cost_type cost_type;
+
+      ~AStarNodeList() { Clear(); }
+
+      node_type* Create(node_type* pParent, data_type pData, cost_type pGn, cost_type pHn)
+      {
+         node_type* node = new node_type(pParent, pData, pGn, pHn);
+         mNodes.push_back(node);
+         return node;
+      }
+
+      void Adopt(node_type* pNode) { mNodes.push_back(pNode); }
+
+      void Clear()
+      {
+         for (typename std::vector<node_type*>::iterator i = mNodes.begin(); i != mNodes.end(); ++i)
+         {
+            delete *i;
+         }
+         mNodes.clear();
+      }
+
+   private:
+      std::vector<node_type*> mNodes;
+   };
+
+   /**
+    * The original AStar containers.  A vector heap for the open list, a std::set
+    * for the closed list and a new for every node.
+    */
+   struct AStarDefaultPolicy
+   {
+      template<class _NodeType>
+      struct Containers
+      {
+         typedef AStarHeapOpenList<_NodeType> open_list;
+         typedef AStarSetClosedList<typename _NodeType::data_type> closed_list;
+         typedef AStarNodeList<_NodeType> node_storage;
+      };
+   };
+
+   ////////////////////////////////////////////////////////////////////////////////
+   // AStarIndexedPolicy containers
+   ////////////////////////////////////////////////////////////////////////////////
+
+   /**
+    * The default hash for AStarIndexedPolicy.  It hashes the bytes of the data, which works for
+    * integers, pointers and plain structs without padding.  Data types with padding or with
+    * members that point elsewhere need their own hash functor.
+    */
+   struct AStarDataHash
+   {
+      template<class T>
+      size_t operator()(const T& pData) const
+      {
+         return HashBytes(reinterpret_cast<const unsigned char*>(&pData), sizeof(T));
+      }
+
+      size_t operator()(float pData) const
+      {
+         // -0 and 0 compare equal, so they must hash the same.
+         if (pData == 0.0f) { pData = 0.0f; }
+         return HashBytes(reinterpret_cast<const unsigned char*>(&pData), sizeof(pData));
+      }
+
+      size_t operator()(double pData) const
+      {
+         if (pData == 0.0) { pData = 0.0; }
+         return HashBytes(reinterpret_cast<const unsigned char*>(&pData), sizeof(pData));
+      }
+
+      /// 32 bit FNV-1a
+      static size_t HashBytes(const unsigned char* pBytes, size_t pCount)
+      {
+         unsigned hash = 2166136261U;
+         for (size_t i = 0; i < pCount; ++i)
+         {
+            hash ^= pBytes[i];
+            hash *= 16777619U;
+         }
+         return size_t(hash);
+      }
+   };
+
+   /**
+    * An open addressing hash table with linear probing.  Entries can't be erased one at a time, but
+    * Clear() is constant time, because each slot is stamped with the generation it was written in
+    * and clearing just starts a new generation.  That way one table serves many searches without
+    * being reallocated or swept.
+    *
+    * The key type must be default constructible and have operator==.
+    */
+   template<class _KeyType, class _ValueType, class _Hash>
+   class AStarHashTable
+   {
+   public:
+      AStarHashTable()
+         : mSlots(MIN_CAPACITY)
+         , mMask(MIN_CAPACITY - 1)
+         , mCount(0)
+         , mGeneration(1)
+      {
+      }
+
+      /// @return the value stored with the key or NULL if there isn't one.
+      _ValueType* Find(const _KeyType& pKey)
+      {
+         for (size_t i = mHash(pKey) & mMask; ; i = (i + 1) & mMask)
+         {
+            Slot& slot = mSlots[i];
+            if (slot.mGeneration != mGeneration)
+            {
+               return NULL;
+            }
+            if (slot.mKey == pKey)
+            {
+               return &slot.mValue;
+            }
+         }
+      }
+
+      /// Stores the value with the key, replacing the value it had.
+      void Set(const _KeyType& pKey, const _ValueType& pValue)
+      {
+         // Keep the table at most half full so the probe sequences stay short.
+         if ((mCount + 1) * 2 > mSlots.size())
+         {
+            Grow();
+         }
+
+         for (size_t i = mHash(pKey) & mMask; ; i = (i + 1) & mMask)
+         {
+            Slot& slot = mSlots[i];
+            if (slot.mGeneration != mGeneration)
+            {
+               slot.mGeneration = mGeneration;
+               slot.mKey = pKey;
+               slot.mValue = pValue;
+               ++mCount;
+               return;
+            }
+            if (slot.mKey == pKey)
+            {
+               slot.mValue = pValue;
+               return;
+            }
+         }
+      }
+
+      void Clear()
+      {
+         mCount = 0;
+         ++mGeneration;
+         if (mGeneration == 0)
+         {
+            // The generation wrapped, so old stamps could look current again.
+            for (typename std::vector<Slot>::iterator i = mSlots.begin(); i != mSlots.end(); ++i)
+            {
+               i->mGeneration = 0;
+            }
+            mGeneration = 1;
+         }
+      }
+
+      size_t size() const { return mCount; }
+
+   private:
+      static const size_t MIN_CAPACITY = 64;
+
+      struct Slot
+      {
+         Slot(): mGeneration(0), mKey(), mValue() {}
+
+         unsigned mGeneration;
+         _KeyType mKey;
+         _ValueType mValue;
+      };
+
+      void Grow()
+      {
+         std::vector<Slot> oldSlots(mSlots.size() * 2);
+         oldSlots.swap(mSlots);
+         mMask = mSlots.size() - 1;
+
+         unsigned oldGeneration = mGeneration;
+         mGeneration = 1;
+         mCount = 0;
+
+         for (typename std::vector<Slot>::iterator i = oldSlots.begin(); i != oldSlots.end(); ++i)
+         {
+            if (i->mGeneration == oldGeneration)
+            {
+               Set(i->mKey, i->mValue);
+            }
+         }
+      }
+
+      std::vector<Slot> mSlots;
+      size_t mMask;
+      size_t mCount;
+      unsigned mGeneration;
+      _Hash mHash;
+   };
+
+   /**
+    * A binary heap that remembers the position of each node in a hash table, so finding an
+    * open node is a lookup and a cheaper path replaces the old node in place (decrease-key).
+    */
+   template<class _NodeType, class _Hash>
+   class AStarIndexedOpenList
+   {
+   public:
+      typedef _NodeType node_type;
+      typedef typename _NodeType::data_type data_type;
+
+      bool empty() const { return mHeap.empty(); }
+      size_t size() const { return mHeap.size(); }
+
+      void Push(node_type* pNode)
+      {
+         // The same data may only be open once, so keep the cheaper of the two.
+         node_type* openNode = Find(pNode->GetData());
+         if (openNode != NULL)
+         {
+            if (*pNode < *openNode)
+            {
+               Replace(openNode, pNode);
+            }
+            return;
+         }
+
+         mHeap.push_back(pNode);
+         SiftUp(mHeap.size() - 1);
+      }
+
+      node_type* Pop()
+      {
+         if (mHeap.empty())
+         {
+            return NULL;
+         }
+
+         node_type* node = mHeap.front();
+         mIndex.Set(node->GetData(), NOT_OPEN);
+
+         node_type* last = mHeap.back();
+         mHeap.pop_back();
+         if (!mHeap.empty())
+         {
+            Place(last, 0);
+            SiftDown(0);
+         }
+         return node;
+      }
+
+      /// @return the open node holding the data, or NULL if there isn't one.
+      node_type* Find(const data_type& pData)
+      {
+         size_t* index = mIndex.Find(pData);
+         return (index == NULL || *index == NOT_OPEN) ? NULL : mHeap[*index];
+      }
+
+      /// Swaps an open node for a cheaper path to the same data.
+      void Replace(node_type* pOldNode, node_type* pNewNode)
+      {
+         size_t* index = mIndex.Find(pOldNode->GetData());
+         if (index == NULL || *index == NOT_OPEN)
+         {
+            Push(pNewNode);
+            return;
+         }
+
+         size_t position = *index;
+         Place(pNewNode, position);
+         position = SiftUp(position);
+         SiftDown(position);
+      }
+
+      void Clear()
+      {
+         mHeap.clear();
+         mIndex.Clear();
+      }
+
+   private:
+      static const size_t NOT_OPEN = size_t(-1);
+
+      void Place(node_type* pNode, size_t pPosition)
+      {
+         mHeap[pPosition] = pNode;
+         mIndex.Set(pNode->GetData(), pPosition);
+      }
+
+      size_t SiftUp(size_t pPosition)
+      {
+         node_type* node = mHeap[pPosition];
+         while (pPosition > 0)
+         {
+            size_t parent = (pPosition - 1) / 2;
+            if (!(*node < *mHeap[parent]))
+            {
+               break;
+            }
+            Place(mHeap[parent], pPosition);
+            pPosition = parent;
+         }
+         Place(node, pPosition);
+         return pPosition;
+      }
+
+      void SiftDown(size_t pPosition)
+      {
+         node_type* node = mHeap[pPosition];
+         const size_t count = mHeap.size();
+         for (;;)
+         {
+            size_t child = pPosition * 2 + 1;
+            if (child >= count)
+            {
+               break;
+            }
+            if (child + 1 < count && *mHeap[child + 1] < *mHeap[child])
+            {
+               ++child;
+            }
+            if (!(*mHeap[child] < *node))
+            {
+               break;
+            }
+            Place(mHeap[child], pPosition);
+            pPosition = child;
+         }
+         Place(node, pPosition);
+      }
+
+      std::vector<node_type*> mHeap;
+      AStarHashTable<data_type, size_t, _Hash> mIndex;
+   };
+
+   template<class _NodeType, class _Hash>
+   const size_t AStarIndexedOpenList<_NodeType, _Hash>::NOT_OPEN;
+
+   /**
+    * The closed list as an AStarHashTable.
+    */
+   template<class _DataType, class _Hash>
+   class AStarHashedClosedList
+   {
+   public:
+      void Insert(const _DataType& pData) { mClosed.Set(pData, true); }
+      bool Contains(const _DataType& pData) { return mClosed.Find(pData) != NULL; }
+      void Clear() { mClosed.Clear(); }
+
+   private:
+      AStarHashTable<_DataType, bool, _Hash> mClosed;
+   };
+
+   /**
+    * Constructs nodes in blocks of raw memory that are kept between searches.  Clear() runs the node
+    * destructors but doesn't give the memory back, so repeated searches don't allocate at all once
+    * the pool is big enough.
+    */
+   template<class _NodeType>
+   class AStarNodePool
+   {
+   public:
+      typedef _NodeType node_type;
+      typedef typename _NodeType::data_type data_type;
+      typedef typename _NodeType::cost_type cost_type;
+
+      static const size_t NODES_PER_BLOCK = 1024;
+
+      AStarNodePool(): mUsed(0) {}
+
+      ~AStarNodePool()
+      {
+         Clear();
+         for (std::vector<void*>::iterator i = mBlocks.begin(); i != mBlocks.end(); ++i)
+         {
+            ::operator delete(*i);
+         }
+      }
+
+      node_type* Create(node_type* pParent, data_type pData, cost_type pGn, cost_type pHn)
+      {
+         size_t block = mUsed / NODES_PER_BLOCK;
+         if (block == mBlocks.size())
+         {
+            mBlocks.push_back(::operator new(NODES_PER_BLOCK * sizeof(node_type)));
+         }
+
+         void* memory = static_cast<char*>(mBlocks[block]) + (mUsed % NODES_PER_BLOCK) * sizeof(node_type);
+         node_type* node = new (memory) node_type(pParent, pData, pGn, pHn);
+         ++mUsed;
+         return node;
+      }
+
+      void Adopt(node_type* pNode) { mAdopted.push_back(pNode); }
+
+      void Clear()
+      {
+         for (size_t i = 0; i < mUsed; ++i)
+         {
+            void* memory = static_cast<char*>(mBlocks[i / NODES_PER_BLOCK]) + (i % NODES_PER_BLOCK) * sizeof(node_type);
+            static_cast<node_type*>(memory)->~node_type();
+         }
+         mUsed = 0;
+
+         for (typename std::vector<node_type*>::iterator i = mAdopted.begin(); i != mAdopted.end(); ++i)
+         {
+            delete *i;
+         }
+         mAdopted.clear();
+      }
+
+   private:
+      AStarNodePool(const AStarNodePool&); // not implemented by design
+      AStarNodePool& operator=(const AStarNodePool&); // not implemented by design
+
+      std::vector<void*> mBlocks;
+      size_t mUsed;
+      std::vector<node_type*> mAdopted;
+   };
+
+   /**
+    * An indexed binary heap with decrease-key for the open list, an open addressing hash set for the
+    * closed list and pooled nodes.  Every open and closed list operation is O(1) or O(log n),
+    * where the default policy's open list lookups are O(n).
+    */
+   template<class _Hash = AStarDataHash>
+   struct AStarIndexedPolicy
+   {
+      template<class _NodeType>
+      struct Containers
+      {
+         typedef AStarIndexedOpenList<_NodeType, _Hash> open_list;
+         typedef AStarHashedClosedList<typename _NodeType::data_type, _Hash> closed_list;
+         typedef AStarNodePool<_NodeType> node_storage;
+      };
+   };
+
+} // namespace dtAI
+
+#endif // __DELTA_ASTARPOLICY_H__
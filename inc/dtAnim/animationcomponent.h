@@ -30,6 +30,8 @@
 #include <dtCore/refptr.h>
 
 #include <dtGame/datacentricgmcomponent.h>
+#include <dtGame/basegroundclamper.h>
+#include <dtGame/gameactorproxy.h>
 
 #include <dtAnim/animationhelper.h>
 #include <dtUtil/threadpool.h>
@@ -113,10 +115,13 @@ public:
 protected:
    virtual ~AnimationComponent();
 
+   /**
+    * Queues the ground clamping queries of every actor in one batch, then runs the batch on the
+    * thread pool together with the skeletal updates, and writes the clamped positions back.
+    */
    virtual void TickLocal(float dt);
-   void BuildThreadWorkerTasks();
-   // creates batches of isector queries
-   void GroundClamp(BaseClass::ActorCompMapping&);
+   // queues the ground clamping query of every registered actor into one batch
+   void GroundClampActors();
    void ExecuteCommands(BaseClass::ActorCompMapping&);
 
 private:
@@ -125,6 +130,15 @@ private:
 
    dtCore::RefPtr<dtGame::BaseGroundClamper> mGroundClamper;
 
+   /// The actor and clamping data for each registered actor.  The clamper holds on to the data until FinishUp.
+   struct GroundClampEntry
+   {
+      dtGame::GameActorWeakPtr mActor;
+      dtGame::GroundClampingData mData;
+   };
+   typedef std::map<dtCore::UniqueId, GroundClampEntry> GroundClampMap;
+   GroundClampMap mGroundClampEntries;
+
    // A field used exclusively for the event sending code.
    // This tracks the current actor that whose helper's commands
    // are currently being executed. This information is important
@@ -47,6 +47,11 @@ XERCES_CPP_NAMESPACE_BEGIN
   class DOMDocument;
 XERCES_CPP_NAMESPACE_END
 
+namespace dtUtil
+{
+   class DataStream;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace dtAudio
@@ -589,6 +594,12 @@ namespace dtAudio
       /** turns the FrameData into its XML representation.*/
       XERCES_CPP_NAMESPACE_QUALIFIER DOMElement* Serialize(const FrameData* d, XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument* doc) const;
 
+      /** Writes the FrameData to a dtCore::BinaryRecorder file. */
+      void Serialize(const FrameData* d, dtUtil::DataStream& stream) const;
+
+      /** Reads a FrameData written by the binary Serialize. */
+      FrameData* Deserialize(dtUtil::DataStream& stream);
+
       /**
        * Get the duration of time (in seconds) it takes to play this sound.
        *
@@ -0,0 +1,366 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ */
+
+#ifndef DELTA_BINARYRECORDER
+#define DELTA_BINARYRECORDER
+
+#include <dtCore/recorder.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/recordingfile.h>
+
+namespace dtCore
+{
+   /**
+    * A Recorder that can also use the binary format of dtUtil::RecordingFileWriter.  The binary format can be
+    * written while recording with RecordToFile, so the frames are not kept in memory, and played straight from
+    * the file with PlayFile.  XML files still work as they do with Recorder.
+    *
+    * Besides what Recorder needs, the RecordableT must have
+    * @code
+    *    void Serialize(const FrameDataT* data, dtUtil::DataStream& stream) const;
+    *    FrameDataT* Deserialize(dtUtil::DataStream& stream);
+    * @endcode
+    */
+   template<typename RecordableT, typename FrameDataT>
+   class BinaryRecorder : public Recorder<RecordableT, FrameDataT>
+   {
+   public:
+      typedef Recorder<RecordableT, FrameDataT>                BaseClass;
+      typedef typename BaseClass::FrameDataPtrContainer        FrameDataPtrContainer;
+      typedef typename BaseClass::KeyFrame                     KeyFrame;
+      typedef typename BaseClass::KeyFrameContainer            KeyFrameContainer;
+      typedef typename BaseClass::RecordablePtrContainer       RecordablePtrContainer;
+
+      /**
+        * Constructor.
+        *
+        * @param name the instance name
+        */
+      BinaryRecorder(const std::string& name = "recorder")
+      : BaseClass(name)
+      , mPlayChunkIndex(0)
+      , mPlayFrameIndex(0)
+      {
+         mFrameStream.SetForceLittleEndian(true);
+      }
+
+   protected:
+      /**
+        * Destructor.
+        */
+      virtual ~BinaryRecorder()
+      {
+         CloseFiles();
+      }
+
+   public:
+      /**
+        * Starts recording events in memory.
+        */
+      virtual void Record()
+      {
+         CloseFiles();
+         BaseClass::Record();
+      }
+
+      /**
+        * Starts recording events, writing each frame to a binary recording file as it is captured instead of
+        * keeping it in memory.  The file is finished when Stop is called.
+        *
+        * @param filename the name of the file to write
+        * @return false if the file could not be created.
+        */
+      bool RecordToFile(const std::string& filename)
+      {
+         CloseFiles();
+         this->GetKeyFrames().clear();
+
+         mWriter = new dtUtil::RecordingFileWriter();
+         if (!mWriter->Open(filename, unsigned(this->GetSources().size())))
+         {
+            mWriter = NULL;
+            return false;
+         }
+
+         BaseClass::Record();
+         return true;
+      }
+
+      /**
+        * Starts playing events.  If a file was opened with PlayFile, it is played from the start.
+        */
+      virtual void Play()
+      {
+         BaseClass::Play();
+         if (mReader.valid())
+         {
+            LoadPlayChunk(0);
+         }
+      }
+
+      /**
+        * Opens a binary recording file and starts playing it.  Only the chunk being played is decoded,
+        * so the recording is never loaded in memory as a whole.
+        *
+        * @param filename the name of the file to play
+        * @return false if the file could not be opened, or was recorded with a different number of sources.
+        */
+      bool PlayFile(const std::string& filename)
+      {
+         CloseFiles();
+
+         std::string file = dtUtil::FindFileInPathList(filename);
+         mReader = new dtUtil::RecordingFileReader();
+         if (file.empty() || !mReader->Open(file))
+         {
+            LOG_WARNING("The recording file, " + filename + " could not be opened.");
+            mReader = NULL;
+            return false;
+         }
+
+         if (mReader->GetNumSources() != this->GetSources().size())
+         {
+            LOG_WARNING("The recording file, " + filename + " has data for " + dtUtil::ToString(mReader->GetNumSources())
+                     + " sources, but the recorder has " + dtUtil::ToString(this->GetSources().size()) + ".");
+            mReader = NULL;
+            return false;
+         }
+
+         Play();
+         return true;
+      }
+
+      /**
+        * Moves the playback position to the first frame at or after the given time code.  When playing a file,
+        * this decodes only the chunk that holds the time.
+        */
+      virtual void Seek(double timeCode)
+      {
+         if (!mReader.valid())
+         {
+            BaseClass::Seek(timeCode);
+         }
+         else if (LoadPlayChunk(mReader->FindChunk(timeCode)))
+         {
+            const std::vector<dtUtil::RecordingFileReader::Frame>& frames = mPlayChunk.mFrames;
+            while (mPlayFrameIndex < frames.size() && frames[mPlayFrameIndex].mTime < timeCode)
+            {
+               ++mPlayFrameIndex;
+            }
+         }
+      }
+
+      /**
+        * Stops recording or playing events.  If recording to a file, the file is finished and closed.
+        */
+      virtual void Stop()
+      {
+         BaseClass::Stop();
+
+         if (mWriter.valid())
+         {
+            mWriter->Close();
+            mWriter = NULL;
+         }
+      }
+
+      /**
+        * Saves the recording in memory to the specified file in the binary format.
+        *
+        * @param filename the name of the file to save
+        * @return false if the file could not be created.
+        */
+      bool SaveBinaryFile(const std::string& filename)
+      {
+         dtCore::RefPtr<dtUtil::RecordingFileWriter> writer = new dtUtil::RecordingFileWriter();
+         if (!writer->Open(filename, unsigned(this->GetSources().size())))
+         {
+            return false;
+         }
+
+         typename KeyFrameContainer::iterator kfiter = this->GetKeyFrames().begin();
+         typename KeyFrameContainer::iterator kfend = this->GetKeyFrames().end();
+         for (; kfiter != kfend; ++kfiter)
+         {
+            WriteFrame(*writer, kfiter->first, kfiter->second);
+         }
+
+         writer->Close();
+         return true;
+      }
+
+      /**
+        * Loads a recording from the specified file.  A binary recording file is loaded into memory as a whole.
+        * Use PlayFile to play one without loading it.  Anything else is loaded as XML by Recorder.
+        *
+        * @param filename the name of the file to load
+        */
+      virtual void LoadFile(const std::string& filename)
+      {
+         CloseFiles();
+
+         std::string file = dtUtil::FindFileInPathList(filename);
+         if (file.empty() || !dtUtil::RecordingFileReader::IsRecordingFile(file))
+         {
+            BaseClass::LoadFile(filename);
+            return;
+         }
+
+         this->GetKeyFrames().clear();
+         LoadBinaryFile(file);
+      }
+
+   protected:
+      /// Writes the frame to the file when recording to one, otherwise keeps it in memory.
+      virtual void StoreFrame(double timeCode, const FrameDataPtrContainer& sourcedata)
+      {
+         if (mWriter.valid())
+         {
+            WriteFrame(*mWriter, timeCode, sourcedata);
+         }
+         else
+         {
+            BaseClass::StoreFrame(timeCode, sourcedata);
+         }
+      }
+
+      /// Plays the next frame from the file opened with PlayFile, otherwise from memory.
+      virtual bool PlayNextFrame()
+      {
+         if (!mReader.valid())
+         {
+            return BaseClass::PlayNextFrame();
+         }
+
+         while (mPlayFrameIndex >= mPlayChunk.mFrames.size())
+         {
+            if (mPlayChunkIndex + 1 >= mReader->GetNumChunks() || !LoadPlayChunk(mPlayChunkIndex + 1))
+            {
+               return false;
+            }
+         }
+
+         const dtUtil::RecordingFileReader::Frame& frame = mPlayChunk.mFrames[mPlayFrameIndex];
+         ++mPlayFrameIndex;
+
+         FrameDataPtrContainer sourcedata;
+         ReadFrame(mPlayChunk.mData.empty() ? NULL : &mPlayChunk.mData[frame.mOffset], frame.mSize, sourcedata);
+         RecordablePtrContainer& sources = this->GetSources();
+         for (unsigned i = 0; i < sourcedata.size(); ++i)
+         {
+            sources[i]->UseFrameData(sourcedata[i].get());
+         }
+         return true;
+      }
+
+   private:
+      void WriteFrame(dtUtil::RecordingFileWriter& writer, double timeCode, const FrameDataPtrContainer& sourcedata)
+      {
+         mFrameStream.ClearBuffer();
+         typename FrameDataPtrContainer::const_iterator fditer = sourcedata.begin();
+         typename RecordablePtrContainer::iterator srciter = this->GetSources().begin();
+         typename RecordablePtrContainer::iterator srcend = this->GetSources().end();
+         while (srciter != srcend)
+         {
+            // assumes an equal number of framedata iterators for source iterators
+            (*srciter)->Serialize((*fditer).get(), mFrameStream);
+            ++fditer;
+            ++srciter;
+         }
+         writer.WriteFrame(timeCode, mFrameStream.GetBuffer(), mFrameStream.GetBufferSize());
+      }
+
+      /// Has each source read its frame data from the frame.
+      void ReadFrame(const char* data, unsigned size, FrameDataPtrContainer& sourcedata)
+      {
+         sourcedata.clear();
+         sourcedata.reserve(this->GetSources().size());
+         if (size == 0)
+         {
+            return;
+         }
+
+         // The stream is only read, so it is safe to point it at the chunk data.
+         dtUtil::DataStream stream(const_cast<char*>(data), size, false);
+         stream.SetForceLittleEndian(true);
+         typename RecordablePtrContainer::iterator srciter = this->GetSources().begin();
+         typename RecordablePtrContainer::iterator srcend = this->GetSources().end();
+         for (; srciter != srcend; ++srciter)
+         {
+            sourcedata.push_back((*srciter)->Deserialize(stream));
+         }
+      }
+
+      void LoadBinaryFile(const std::string& file)
+      {
+         dtCore::RefPtr<dtUtil::RecordingFileReader> reader = new dtUtil::RecordingFileReader();
+         if (!reader->Open(file))
+         {
+            return;
+         }
+
+         if (reader->GetNumSources() != this->GetSources().size())
+         {
+            LOG_WARNING("The recording file, " + file + " has data for a different number of sources than the recorder.");
+            return;
+         }
+
+         KeyFrameContainer& keyFrames = this->GetKeyFrames();
+         keyFrames.reserve(reader->GetNumFrames());
+         dtUtil::RecordingFileReader::Chunk chunk;
+         for (unsigned i = 0; i < reader->GetNumChunks() && reader->ReadChunk(i, chunk); ++i)
+         {
+            for (unsigned f = 0; f < chunk.mFrames.size(); ++f)
+            {
+               const dtUtil::RecordingFileReader::Frame& frame = chunk.mFrames[f];
+               keyFrames.push_back(KeyFrame(frame.mTime, FrameDataPtrContainer()));
+               ReadFrame(chunk.mData.empty() ? NULL : &chunk.mData[frame.mOffset], frame.mSize, keyFrames.back().second);
+            }
+         }
+      }
+
+      bool LoadPlayChunk(unsigned chunkIndex)
+      {
+         mPlayChunkIndex = chunkIndex;
+         mPlayFrameIndex = 0;
+         return mReader->ReadChunk(chunkIndex, mPlayChunk);
+      }
+
+      void CloseFiles()
+      {
+         if (mWriter.valid())
+         {
+            mWriter->Close();
+            mWriter = NULL;
+         }
+         mReader = NULL;
+         mPlayChunk.mData.clear();
+         mPlayChunk.mFrames.clear();
+      }
+
+      dtCore::RefPtr<dtUtil::RecordingFileWriter> mWriter;    /// Set while recording to a file.
+      dtCore::RefPtr<dtUtil::RecordingFileReader> mReader;    /// Set while playing a file.
+      dtUtil::RecordingFileReader::Chunk mPlayChunk;          /// The decoded chunk being played.
+      unsigned mPlayChunkIndex;
+      unsigned mPlayFrameIndex;
+      dtUtil::DataStream mFrameStream;                        /// Reused to serialize each frame.
+   };
+}
+
+#endif // DELTA_BINARYRECORDER
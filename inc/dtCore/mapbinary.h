@@ -0,0 +1,225 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_MAPBINARY
+#define DELTA_MAPBINARY
+
+#include <dtCore/export.h>
+#include <dtCore/map.h>
+#include <dtCore/actortype.h>
+#include <dtCore/refptr.h>
+#include <dtUtil/hashmap.h>
+#include <osg/Referenced>
+
+#include <iosfwd>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dtUtil
+{
+   class DataStream;
+   class MappedFile;
+}
+
+namespace dtCore
+{
+   class ActorProperty;
+   class PropertyContainer;
+   class BaseActorObject;
+
+   /**
+    * Constants describing the binary map layout.  Everything is little endian.
+    *
+    * The file starts with the magic, the version and the flags, followed by a string table that every
+    * later section refers to by index.  Actor types are listed once in a type table so they are only
+    * looked up in the ActorFactory once per type, and each property is written as its name index, its
+    * DataType id, the payload size and then the value in its native binary form.  The size lets the
+    * loader skip properties that no longer exist or have changed type.
+    */
+   namespace MapBinaryConstants
+   {
+      DT_CORE_EXPORT extern const char MAGIC[8];
+      DT_CORE_EXPORT extern const unsigned VERSION;
+      DT_CORE_EXPORT extern const unsigned FLAG_PREFAB;
+      /// Used in place of a string or actor type index when there is no value.
+      DT_CORE_EXPORT extern const unsigned NO_INDEX;
+   }
+
+   /**
+    * @class MapBinaryParser
+    * @brief Loads a map written by MapBinaryWriter.  The file is memory mapped rather than read.
+    * @note Like the MapParser, this is not part of the public api.  Load maps through the Project.
+    */
+   class DT_CORE_EXPORT MapBinaryParser : public osg::Referenced
+   {
+   public:
+      MapBinaryParser();
+
+      /**
+       * @return true if the file exists and starts with the binary map magic.
+       */
+      static bool IsBinaryMap(const std::string& fileName);
+
+      /**
+       * Completely loads a binary map file.
+       * @param fileName The full path to the file.
+       * @param prefab true to load the file as a prefab, which means the actors get new ids.
+       * @return the loaded map.
+       * @throws MapParsingException if the file is not a valid binary map.
+       */
+      MapPtr Parse(const std::string& fileName, bool prefab = false);
+
+      /**
+       * Loads a binary map from a buffer in memory.
+       * @see #Parse
+       */
+      MapPtr ParseBuffer(const char* data, size_t size, bool prefab = false);
+
+      /**
+       * Reads only the map header, such as the name and description.  The actors are not created.
+       * @throws MapParsingException if the file is not a valid binary map.
+       */
+      MapPtr ParseMapHeaderData(const std::string& fileName, bool prefab = false);
+
+      /// @return true if a map is being loaded.
+      bool IsParsing() const;
+
+      /// @return the map being loaded or NULL if nothing is loading.
+      Map* GetMapBeingParsed();
+      const Map* GetMapBeingParsed() const;
+
+      const std::set<std::string>& GetMissingActorTypes() const;
+      const std::vector<std::string>& GetMissingLibraries() const;
+      bool HasDeprecatedProperty() const;
+
+   protected:
+      virtual ~MapBinaryParser();
+
+   private:
+      MapBinaryParser(const MapBinaryParser&);
+      MapBinaryParser& operator=(const MapBinaryParser&);
+
+      typedef dtUtil::HashMap<std::string, BaseActorObject*> ActorIdMap;
+
+      /// Holds a value that can't be set until all of the actors exist.
+      struct DeferredValue
+      {
+         dtCore::RefPtr<PropertyContainer> mContainer;
+         std::string mPropertyName;
+         std::string mValue;
+         bool mIsGroup;
+      };
+
+      void Reset();
+      MapPtr ParseData(dtUtil::DataStream& stream, bool prefab, bool headerOnly);
+
+      void ReadStringTable(dtUtil::DataStream& stream);
+      const std::string& ReadString(dtUtil::DataStream& stream) const;
+
+      void ReadHeader(dtUtil::DataStream& stream, bool prefab);
+      void ReadLibraries(dtUtil::DataStream& stream);
+      void ReadEvents(dtUtil::DataStream& stream);
+      void ReadActorTypes(dtUtil::DataStream& stream);
+      void ReadActor(dtUtil::DataStream& stream, BaseActorObject* parentActor, bool prefab);
+      void ReadGroups(dtUtil::DataStream& stream);
+      void ReadPresetCameras(dtUtil::DataStream& stream);
+
+      /**
+       * Reads a list of property records and applies each to the property of the same name
+       * on the container.
+       */
+      void ReadProperties(dtUtil::DataStream& stream, PropertyContainer* container);
+
+      /**
+       * Reads a property value into the property.  If the property is NULL or doesn't match,
+       * the payload is skipped.
+       * @param container the container that owns the property directly, or NULL if the property
+       *                  is an element of an array or an ActorProperty container.
+       */
+      void ReadValue(dtUtil::DataStream& stream, unsigned typeId, unsigned size,
+               ActorProperty* prop, PropertyContainer* container);
+
+      void ReadNestedRecords(dtUtil::DataStream& stream, ActorProperty& prop);
+
+      void LinkDeferredValues();
+
+      std::vector<std::string> mStrings;
+      std::vector<dtCore::ActorTypePtr> mActorTypes;
+      ActorIdMap mActorsByFileId;
+      std::vector<DeferredValue> mDeferredValues;
+      std::string mEnvironmentActorId;
+
+      dtCore::RefPtr<Map> mMap;
+      std::set<std::string> mMissingActorTypes;
+      std::vector<std::string> mMissingLibraries;
+      bool mHasDeprecatedProperty;
+      bool mParsing;
+   };
+
+   typedef dtCore::RefPtr<MapBinaryParser> MapBinaryParserPtr;
+
+   /**
+    * @class MapBinaryWriter
+    * @brief Writes a map in the binary layout described in MapBinaryConstants.
+    */
+   class DT_CORE_EXPORT MapBinaryWriter : public osg::Referenced
+   {
+   public:
+      MapBinaryWriter();
+
+      /**
+       * Saves the map to a binary file.
+       * The create time will be set on the map if this is the first time it has been saved.
+       * @throws MapSaveException if any errors occur saving the file.
+       */
+      void Save(Map& map, const std::string& filePath, bool prefab = false);
+
+      /// Saves the map into a stream.  The stream should be opened in binary mode.
+      void Save(Map& map, std::ostream& stream, bool prefab = false);
+
+   protected:
+      virtual ~MapBinaryWriter();
+
+   private:
+      MapBinaryWriter(const MapBinaryWriter&);
+      MapBinaryWriter& operator=(const MapBinaryWriter&);
+
+      typedef dtUtil::HashMap<std::string, unsigned> StringIndexMap;
+
+      void Reset();
+
+      /// @return the index of the string in the string table, adding it if needed.
+      unsigned GetStringIndex(const std::string& str);
+      unsigned GetActorTypeIndex(const ActorType& type);
+
+      void WriteActor(dtUtil::DataStream& stream, BaseActorObject& actor);
+      void WriteProperties(dtUtil::DataStream& stream, PropertyContainer& container);
+      void WriteProperty(dtUtil::DataStream& stream, const ActorProperty& prop);
+      void WriteValue(dtUtil::DataStream& stream, const ActorProperty& prop);
+
+      std::vector<std::string> mStrings;
+      StringIndexMap mStringIndices;
+      std::vector<dtCore::ActorTypePtr> mActorTypes;
+      dtUtil::HashMap<std::string, unsigned> mActorTypeIndices;
+   };
+
+   typedef dtCore::RefPtr<MapBinaryWriter> MapBinaryWriterPtr;
+}
+
+#endif // DELTA_MAPBINARY
@@ -27,6 +27,7 @@
 #include <dtCore/baseactorobject.h>
 #include <dtUtil/tree.h>
 #include <dtCore/map.h>
+#include <dtCore/mapbinary.h>
 
 namespace dtCore
 {
@@ -55,6 +56,7 @@ namespace dtCore
          /**
           * Completely parses a map file.  Be sure store an dtCore::RefPtr to the map immediately, otherwise
           * if the parser is deleted or another map file is parse, the map will get deleted.
+          * Files written by the MapBinaryWriter are detected by their magic and loaded without xerces.
           * @param path The file path to the map.
           * @param handler The content handler to be used when parsing.
           * @return A pointer to the loaded map.
@@ -64,7 +66,7 @@ namespace dtCore
          bool Parse(std::istream& stream, Map** map, bool prefab = false);
 
          /**
-          * Reads the supplied filename as a Map xml file and extracts the Map
+          * Reads the supplied filename as a Map file and extracts the Map
           * file's header data. Will not create a Map nor anything contained in the Map.
           * @param mapFilename The Map file to parse
           * @param prefab      if this map refers to a prefab.
@@ -97,7 +99,13 @@ namespace dtCore
       MapParser(const MapParser& copyParser);
       MapParser& operator=(const MapParser& assignParser);
 
+      /// @return the full path if the file is a binary map, otherwise an empty string.
+      static std::string FindBinaryMap(const std::string& path);
+
       dtCore::RefPtr<MapContentHandler> mMapHandler;
+      dtCore::RefPtr<MapBinaryParser> mBinaryParser;
+      /// true if the last or current map was a binary map, so the queries go to the binary parser.
+      bool mUsedBinaryParser;
    };
    typedef RefPtr<MapParser> MapParserPtr;
 
@@ -135,6 +143,13 @@ namespace dtCore
        */
       void Save(Map& map, std::ostream& stream, bool prefab = false);
 
+      /**
+       * Set to true to write the binary map format instead of XML.  The MapParser detects
+       * either format, so the file extension does not change.
+       */
+      void SetBinary(bool binary);
+      bool GetBinary() const;
+
 
    protected:
       virtual ~MapWriter(); ///Protected destructor so that this could be subclassed.
@@ -151,13 +166,14 @@ namespace dtCore
    private:
 
       //disable copy constructor
-      MapWriter(const MapWriter& toCopy): BaseXMLWriter(toCopy), mPropSerializer(NULL) {}
+      MapWriter(const MapWriter& toCopy): BaseXMLWriter(toCopy), mPropSerializer(NULL), mBinary(false) {}
       //disable operator =
       MapWriter& operator=(const MapWriter&) { return *this; }
 
       //void WriteHierarchyBranch(dtCore::ActorComponentContainer& actor);
 
       ActorPropertySerializer* mPropSerializer;
+      bool mBinary;
    };
    typedef RefPtr<MapWriter> MapWriterPtr;
 }
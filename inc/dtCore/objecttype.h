@@ -30,10 +30,13 @@
 #include <dtCore/refptr.h>
 #include <dtCore/namedparameter.h>
 #include <dtUtil/hashmap.h>
+#include <OpenThreads/Mutex>
 #include <iosfwd>
 
 namespace dtCore
 {
+   class PropertySchema;
+
    class DT_CORE_EXPORT ObjectType: public osg::Referenced
    {
    public:
@@ -171,6 +174,19 @@ namespace dtCore
       /// This is used to see if the defaults have been initialized.
       bool DefaultsEmpty() const { return mDefaultValues.empty(); }
 
+      /**
+       * @return the property schema shared by the containers of this type, or NULL if no container has
+       *         finished building yet.
+       * @see PropertyContainer::InitDefaults
+       */
+      dtCore::RefPtr<PropertySchema> GetPropertySchema() const;
+
+      /**
+       * Sets the schema shared by the containers of this type if one isn't already set.
+       * @return the schema the type ends up with, which is the existing one if there was one.
+       */
+      dtCore::RefPtr<PropertySchema> SetPropertySchemaIfNotSet(PropertySchema& schema);
+
    protected:
       //Object can only be deleted through the ref_ptr interface.
       virtual ~ObjectType();
@@ -195,6 +211,10 @@ namespace dtCore
 
       typedef dtUtil::HashMap<dtUtil::RefString, dtCore::RefPtr<NamedParameter> > ValMap;
       ValMap mDefaultValues;
+
+      // Actors may be created on the thread pool, so the schema is guarded.
+      mutable OpenThreads::Mutex mPropertySchemaMutex;
+      dtCore::RefPtr<PropertySchema> mPropertySchema;
    };
 
    ///Provide a method for printing the actor type to a stream.
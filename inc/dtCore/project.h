@@ -42,6 +42,11 @@ namespace dtUtil
    class FileUtils;
 }
 
+namespace OpenThreads
+{
+   class ReentrantMutex;
+}
+
 namespace dtCore
 {
    class Scene;
@@ -427,6 +432,13 @@ namespace dtCore
        */
       void SaveMapBackup(Map& map);
 
+      /**
+       * Set to true to save maps, prefabs and backups in the binary map format instead of XML.
+       * Loading detects the format of each file, so a context may hold both.  Defaults to false.
+       */
+      void SetSaveMapsAsBinary(bool binary);
+      bool GetSaveMapsAsBinary() const;
+
       /**
        * @param map the map to get the backups count for.
        * @return true if the Map has a backup file, false otherwise
@@ -524,6 +536,26 @@ namespace dtCore
        */
       const std::string GetResourcePath(const ResourceDescriptor& resource, bool isCategory = false) const;
 
+      /**
+       * Drops the resolved resource paths and the index of the files in the contexts that GetResourcePath uses.
+       * They are rebuilt on the next call.  Changes made through this class do this automatically, so it is only needed
+       * if files in a context are moved or deleted by something else.  New files are found without it.
+       */
+      void RefreshResourcePathCache();
+
+      /**
+       * Turns the resolved resource path cache and file index on or off.  It's on by default.  With it off,
+       * GetResourcePath checks the file system on every call.
+       */
+      void SetResourcePathCacheEnabled(bool enabled);
+      bool GetResourcePathCacheEnabled() const;
+
+      /// @return the number of GetResourcePath calls that were answered from the resolved path cache.
+      unsigned GetResourcePathCacheHits() const;
+
+      /// @return the number of GetResourcePath calls that had to search the contexts.
+      unsigned GetResourcePathCacheMisses() const;
+
       /**
        * Adds a resource to the project by copying it into the project.
        * @param newName the new name of the resource.
@@ -649,6 +681,14 @@ namespace dtCore
        */
       MapParser* GetCurrentMapParser();
 
+      /**
+       * The project isn't thread safe.  Code using it off the main thread holds this lock while it uses
+       * the project, and should release it between separate pieces of work, such as between maps, so the
+       * main thread isn't held up.  Changing the contexts and opening, creating, closing or deleting maps
+       * take the lock too, so they wait for that work to finish.
+       */
+      OpenThreads::ReentrantMutex& GetMutex() const;
+
    private:
       static dtCore::RefPtr<Project> mInstance; //< the instance of the project.
 
@@ -30,6 +30,7 @@
 #include <dtCore/export.h>
 #include <dtCore/actorproperty.h>
 #include <dtCore/objecttype.h>
+#include <dtCore/propertyschema.h>
 #include <osg/Referenced>
 #include <dtUtil/breakoverride.h>
 
@@ -53,6 +54,8 @@ namespace dtCore
    public:
       /**
        * Initializes the default values of this actor.
+       * This is called once the properties are built, so it also switches the container to the property
+       * schema shared by its ObjectType if it has the same properties.
        */
       void InitDefaults();
 
@@ -131,6 +134,24 @@ namespace dtCore
        */
       const ActorProperty* GetProperty(const std::string& name) const;
 
+      /**
+       * @return the index of the property with the given name in the property list, or -1 if there isn't one.
+       * @see #GetPropertySchema
+       */
+      int GetPropertyIndex(const std::string& name) const;
+
+      /// @return the property at the given index in the property list, or NULL if the index is out of range.
+      ActorProperty* GetPropertyByIndex(unsigned index);
+      const ActorProperty* GetPropertyByIndex(unsigned index) const;
+
+      /**
+       * @return the names of the properties in order with their lookup table, or NULL if there are no properties.
+       * Containers that return the same schema have the same properties at the same indices, so code that
+       * looks properties up by name over and over can find the index once per schema and then use
+       * GetPropertyByIndex.
+       */
+      const PropertySchema* GetPropertySchema() const;
+
       /// Perform the given action for each property.
       template <typename UnaryFunctor>
       void ForEachProperty(UnaryFunctor func);
@@ -204,14 +225,22 @@ namespace dtCore
       BREAK_OVERRIDE(GetDefaultPropertyKey() const); // removed 12/2014
    private:
 
-      typedef std::map<dtUtil::RefString, RefPtr<ActorProperty> > PropertyMapType;
       typedef std::vector<RefPtr<ActorProperty> > PropertyVectorType;
 
-      ///Map of properties.
-      PropertyMapType mPropertyMap;
+      /// @return the schema to add names to, copying it first if it is shared.
+      PropertySchema& GetWritableSchema();
+
+      /// Replaces the schema with a new one matching the property list.
+      void RebuildSchema();
+
+      /// Switches to the schema of the ObjectType, or gives it this one if it has none.
+      void SharePropertySchema();
 
       ///vector of properties (for order).
       PropertyVectorType mProperties;
+
+      /// The names of the properties in mProperties, either shared with the other containers of the type or owned by this one.
+      RefPtr<PropertySchema> mSchema;
    };
 
    typedef RefPtr<PropertyContainer> PropertyContainerPtr;
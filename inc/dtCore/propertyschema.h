@@ -0,0 +1,104 @@
+/* -*-c++-*-
+ * Delta3D
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_PROPERTYSCHEMA
+#define DELTA_PROPERTYSCHEMA
+
+#include <dtCore/export.h>
+#include <dtUtil/refstring.h>
+#include <osg/Referenced>
+
+#include <string>
+#include <vector>
+
+namespace dtCore
+{
+   /**
+    * The ordered list of property names of a PropertyContainer, with a flat hash table from each
+    * name to its index.  A lookup hashes the name once and probes an array, so it doesn't walk a tree or
+    * take the RefString intern lock.
+    *
+    * Containers of the same ObjectType with the same properties share one schema once they are built,
+    * at which point it no longer changes.  That means a property index found through a shared schema
+    * can be cached and used on any container that returns the same schema.
+    * @see PropertyContainer::GetPropertySchema
+    */
+   class DT_CORE_EXPORT PropertySchema : public osg::Referenced
+   {
+   public:
+      PropertySchema();
+
+      /// Makes a schema with the same names as another.  The copy is not shared.
+      explicit PropertySchema(const PropertySchema& toCopy);
+
+      /// @return the index of the property with the given name, or -1 if it doesn't exist.
+      int GetIndex(const dtUtil::RefString& name) const;
+
+      /// @return the index of the property with the given name, or -1 if it doesn't exist.
+      int GetIndex(const std::string& name) const;
+
+      unsigned GetNumProperties() const { return unsigned(mNames.size()); }
+
+      const dtUtil::RefString& GetName(unsigned index) const { return mNames[index]; }
+
+      /// Adds a name to the end.  This may not be called once the schema is shared.
+      void AddName(const dtUtil::RefString& name);
+
+      /// Sets all the names, replacing the ones in the schema.  This may not be called once the schema is shared.
+      void SetNames(const std::vector<dtUtil::RefString>& names);
+
+      /// @return true if this schema has the same names in the same order as the list.
+      template <typename PropertyPtrVector>
+      bool Matches(const PropertyPtrVector& properties) const
+      {
+         if (properties.size() != mNames.size())
+         {
+            return false;
+         }
+         for (size_t i = 0; i < mNames.size(); ++i)
+         {
+            // RefStrings compare by pointer.
+            if (!(properties[i]->GetName() == mNames[i]))
+            {
+               return false;
+            }
+         }
+         return true;
+      }
+
+      /// Marks the schema as shared between containers, after which it must not be changed.
+      void SetShared() { mShared = true; }
+      bool IsShared() const { return mShared; }
+
+   protected:
+      virtual ~PropertySchema();
+
+   private:
+      PropertySchema& operator=(const PropertySchema&);
+
+      void RebuildTable();
+      void InsertIntoTable(unsigned index);
+
+      std::vector<dtUtil::RefString> mNames;
+      /// Open addressing table of indices into mNames.  The size is a power of 2, and -1 marks an empty slot.
+      std::vector<int> mTable;
+      bool mShared;
+   };
+}
+
+#endif /* DELTA_PROPERTYSCHEMA */
@@ -46,6 +46,8 @@
 #include <dtUtil/xerceserrorhandler.h>
 #include <dtUtil/keyframedecoder.h>
 
+#include <algorithm>
+
 namespace dtCore
 {
    /**
@@ -55,6 +57,8 @@ namespace dtCore
     *
     * The class has been completely re-engineered by John K. Grant.
     *
+    * Recordings are kept in memory and saved as XML.  dtCore::BinaryRecorder adds a streaming binary file format.
+    *
     * @param RecorderableT is a type that supports the interfaces necessary for recording.  This class knows how to create and serialize FrameDataT types.
     * @param FrameDataT is the type to be stored in memory.
     */
@@ -158,37 +162,34 @@ namespace dtCore
       /**
         * Starts recording events.
         */
-      void Record()
+      virtual void Record()
       {
          mState = Recording;
          mStartTime = mClock.Tick();
-
-         FrameDataPtrContainer sourcedata;
-         sourcedata.reserve(mSources.size());
-         typename RecordablePtrContainer::iterator iter = mSources.begin();
-         typename RecordablePtrContainer::iterator enditer = mSources.end();
-         while (iter != enditer)
-         {
-            // orders framedata the same as sources are ordered in the source container
-            sourcedata.push_back((*iter)->CreateFrameData());
-            ++iter;
-         }
-         mKeyFrames.push_back( KeyFrame(0.0,sourcedata) );
+         CaptureFrame(0.0);
       }
 
       /**
         * Starts playing events.
         */
-      void Play()
+      virtual void Play()
       {
          mState = Playing;
          mKeyFrameIter = mKeyFrames.begin();
       }
 
+      /**
+        * Moves the playback position to the first key frame at or after the given time code.
+        */
+      virtual void Seek(double timeCode)
+      {
+         mKeyFrameIter = std::lower_bound(mKeyFrames.begin(), mKeyFrames.end(), timeCode, KeyFrameTimeLess());
+      }
+
       /**
         * Stops recording or playing events.
         */
-      void Stop()
+      virtual void Stop()
       {
          if (mState == Recording)
          {
@@ -268,7 +269,7 @@ namespace dtCore
         *
         * @param filename the name of the file to load
         */
-      void LoadFile(const std::string& filename)
+      virtual void LoadFile(const std::string& filename)
       {
          // check to see if the file exits
          std::string file = dtUtil::FindFileInPathList(filename);
@@ -309,18 +310,7 @@ namespace dtCore
                {
                   mDeltaTime = mClock.Tick();
                   double timeCode = mClock.DeltaSec(mStartTime, mDeltaTime);
-
-                  FrameDataPtrContainer sourcedata;
-                  sourcedata.reserve( mSources.size() );
-                  typename RecordablePtrContainer::iterator iter = mSources.begin();
-                  typename RecordablePtrContainer::iterator enditer = mSources.end();
-                  while (iter != enditer)
-                  {
-                     // orders framedata the same as sources
-                     sourcedata.push_back((*iter)->CreateFrameData());
-                     iter++;
-                  }
-                  mKeyFrames.push_back(KeyFrame(timeCode,sourcedata));
+                  CaptureFrame(timeCode);
                }
             } break;
 
@@ -329,25 +319,7 @@ namespace dtCore
             {
                if (str == dtCore::System::MESSAGE_PRE_FRAME)
                {
-                  if (mKeyFrameIter != mKeyFrames.end())
-                  {
-                     // key frame stuff
-                     //double timecode = (*mKeyFrameIter).first;
-                     typename FrameDataPtrContainer::iterator framedataiter = (*mKeyFrameIter).second.begin();
-
-                     // sources
-                     typename RecordablePtrContainer::iterator srciter = mSources.begin();
-                     typename RecordablePtrContainer::iterator srcend = mSources.end();
-                     while (srciter != srcend)
-                     {
-                        // assumes sources are ordered the same as framedata
-                        (*srciter)->UseFrameData( (*framedataiter).get() );
-                        ++srciter;
-                        ++framedataiter;
-                     }
-                     mKeyFrameIter++;
-                  }
-                  else
+                  if (!PlayNextFrame())
                   {
                      mState = Stopped;
                   }
@@ -360,7 +332,67 @@ namespace dtCore
          }
       }
 
+   protected:
+      /**
+        * Called with each frame captured while recording.  Keeps the frame in memory.
+        * Override to send the frame somewhere else.
+        */
+      virtual void StoreFrame(double timeCode, const FrameDataPtrContainer& sourcedata)
+      {
+         mKeyFrames.push_back(KeyFrame(timeCode, sourcedata));
+      }
+
+      /**
+        * Called each frame while playing.  Applies the next key frame in memory to the sources.
+        * @return false when there are no frames left to play.
+        */
+      virtual bool PlayNextFrame()
+      {
+         if (mKeyFrameIter == mKeyFrames.end())
+         {
+            return false;
+         }
+
+         // key frame stuff
+         //double timecode = (*mKeyFrameIter).first;
+         typename FrameDataPtrContainer::iterator framedataiter = (*mKeyFrameIter).second.begin();
+
+         // sources
+         typename RecordablePtrContainer::iterator srciter = mSources.begin();
+         typename RecordablePtrContainer::iterator srcend = mSources.end();
+         while (srciter != srcend)
+         {
+            // assumes sources are ordered the same as framedata
+            (*srciter)->UseFrameData( (*framedataiter).get() );
+            ++srciter;
+            ++framedataiter;
+         }
+         mKeyFrameIter++;
+         return true;
+      }
+
    private:
+      struct KeyFrameTimeLess
+      {
+         bool operator()(const KeyFrame& keyFrame, double timeCode) const { return keyFrame.first < timeCode; }
+      };
+
+      /// Creates a frame from each source and hands it to StoreFrame.
+      void CaptureFrame(double timeCode)
+      {
+         FrameDataPtrContainer sourcedata;
+         sourcedata.reserve(mSources.size());
+         typename RecordablePtrContainer::iterator iter = mSources.begin();
+         typename RecordablePtrContainer::iterator enditer = mSources.end();
+         while (iter != enditer)
+         {
+            // orders framedata the same as sources are ordered in the source container
+            sourcedata.push_back((*iter)->CreateFrameData());
+            ++iter;
+         }
+         StoreFrame(timeCode, sourcedata);
+      }
+
       RecordablePtrContainer mSources;                  /// The object to record.
       RecorderState mState;                             /// The state of this recorder.
       dtCore::Timer mClock;                             /// The clock object.
@@ -23,9 +23,11 @@
 
 #include <dtCore/deltadrawable.h>
 #include <dtUtil/enumeration.h>
+#include <dtUtil/functor.h>
 
 // Must include because it's a typedef
 #include <osg/Matrix>
+#include <vector>
 /// @cond DOXYGEN_SHOULD_SKIP_THIS
 struct dContact;
 namespace osg
@@ -169,6 +171,53 @@ namespace dtCore
        */
       static bool GetAbsoluteMatrix(const osg::Node* node, osg::Matrix& wcMatrix, const osg::Node* stopNode = NULL);
 
+      /**
+       * Gets the world coordinate matrix of this Transformable.  This uses the cached matrix
+       * if the absolute matrix cache is enabled and still valid.
+       * @see SetCacheAbsoluteMatrix
+       */
+      void GetAbsoluteMatrix(osg::Matrix& wcMatrix) const;
+
+      /**
+       * Computes the world coordinate matrices of many Transformables in one pass.  The matrix of a parent shared
+       * by several of them is only computed once, and the caches of the ones that keep a cache are filled.
+       * @param xformables the Transformables to compute.
+       * @param matricesOut resized to match xformables and filled with their absolute matrices.
+       */
+      static void GetAbsoluteMatrices(const std::vector<Transformable*>& xformables, std::vector<osg::Matrix>& matricesOut);
+
+      /**
+       * Keeps the absolute matrix of this Transformable between calls instead of walking the parents each time.
+       * The cache is cleared when the matrix of this or a parent Transformable is set, when this is added to or
+       * removed from a parent, and at the start of each System step.  Changes to plain OSG transforms above this node
+       * are not seen until the next step unless InvalidateAbsoluteMatrixCache is called.
+       * The cache is filled when it is read, so don't enable it on Transformables read from several threads at once.
+       * It is off by default.
+       */
+      void SetCacheAbsoluteMatrix(bool enable);
+      bool GetCacheAbsoluteMatrix() const;
+
+      /**
+       * Clears the cached absolute matrix of this and all child Transformables and calls their
+       * transform changed callbacks.
+       */
+      void InvalidateAbsoluteMatrixCache();
+
+      /// Starts a new cache frame, which makes every cached absolute matrix stale.  System calls this each step.
+      static void AdvanceAbsoluteMatrixCacheFrame();
+
+      typedef dtUtil::Functor<void, TYPELIST_1(dtCore::Transformable&), 4 * sizeof(void*)> TransformChangedCallback;
+
+      /**
+       * Sets a callback that is called when the matrix of this Transformable or of a parent Transformable is set,
+       * and when this is added to or removed from a parent.  Like the cache, changes to plain OSG transforms above
+       * this node are not seen unless InvalidateAbsoluteMatrixCache is called.  There is only one callback, and the
+       * GameManager sets it on the drawables of its actors.  It may be called from the thread that moved this.
+       * Pass an empty callback to clear it.
+       */
+      void SetTransformChangedCallback(TransformChangedCallback callback);
+      const TransformChangedCallback& GetTransformChangedCallback() const;
+
       ///Automatically rescales normals if you scale your objects.
       void SetNormalRescaling(bool enable);
 
@@ -40,43 +40,125 @@ namespace dtUtil
 namespace dtCore
 {
 
-   ///Conforms to OSF DCE 1.1
+   /**
+    * Conforms to OSF DCE 1.1
+    *
+    * The id is stored as 16 bytes so comparing, hashing and copying it never touch a string.
+    * Ids in the canonical, lower case, 36 character form, which is what new ids are generated in,
+    * are stored as their binary value and only formatted when ToString is called.  Any other text,
+    * such as upper case uuids from older map files or the names used as ids in tests, is kept in a
+    * shared table and the id holds its index, so every id still converts back to exactly the text
+    * it was created from.  Table entries are reference counted by the ids holding them and are freed
+    * with the last one, so text received from the network doesn't stay around.
+    */
    class DT_CORE_EXPORT UniqueId
    {
    public:
+      /// Number of bytes in the binary form of a uuid.
+      static const unsigned BYTE_COUNT = 16U;
+
       /**
        * @param createNewId if true, generates a new id.  If not, it sets the id to empty.
        */
       explicit UniqueId(bool createNewId = true);
-      UniqueId(const UniqueId& toCopy) { mId = toCopy.mId; }
-
-      explicit UniqueId(const std::string& stringId) : mId(stringId) {}
-      explicit UniqueId(const char* stringId) : mId(stringId) {}
-      virtual ~UniqueId() {}
-
-      bool IsNull() const { return mId.empty(); }
-
-      bool operator==(const UniqueId& rhs) const { return mId == rhs.mId; }
-      bool operator!=(const UniqueId& rhs) const { return mId != rhs.mId; }
-      bool operator< (const UniqueId& rhs) const { return mId <  rhs.mId; }
-      bool operator> (const UniqueId& rhs) const { return mId >  rhs.mId; }
 
-      const std::string& ToString() const;
+      explicit UniqueId(const std::string& stringId)
+         : mHigh(0ULL)
+         , mLow(0ULL)
+      {
+         SetFromString(stringId.data(), stringId.size());
+      }
+      explicit UniqueId(const char* stringId);
+
+      UniqueId(const UniqueId& rhs)
+         : mHigh(rhs.mHigh)
+         , mLow(rhs.mLow)
+      {
+         if (IsText())
+         {
+            AddTextRef(mLow);
+         }
+      }
+
+      ~UniqueId()
+      {
+         if (IsText())
+         {
+            ReleaseText(mLow);
+         }
+      }
+
+      /// Copying a binary id is two words.  Only ids kept as text touch the shared table.
+      UniqueId& operator=(const UniqueId& rhs)
+      {
+         if (rhs.IsText())
+         {
+            AddTextRef(rhs.mLow);
+         }
+         if (IsText())
+         {
+            ReleaseText(mLow);
+         }
+         mHigh = rhs.mHigh;
+         mLow = rhs.mLow;
+         return *this;
+      }
+
+      bool IsNull() const { return mHigh == 0ULL && mLow == 0ULL; }
+
+      bool operator==(const UniqueId& rhs) const { return mHigh == rhs.mHigh && mLow == rhs.mLow; }
+      bool operator!=(const UniqueId& rhs) const { return !(*this == rhs); }
+
+      /// Binary ids order the same as their text.  Ids kept as text are compared as text.
+      bool operator< (const UniqueId& rhs) const
+      {
+         if (mHigh != 0ULL && rhs.mHigh != 0ULL)
+         {
+            return mHigh < rhs.mHigh || (mHigh == rhs.mHigh && mLow < rhs.mLow);
+         }
+         return LessAsText(rhs);
+      }
+      bool operator> (const UniqueId& rhs) const { return rhs < *this; }
+
+      /// Formats the id.  This allocates, so keep it out of code that runs every frame.
+      std::string ToString() const;
 
       /**
        * The assignment operator is public so that unique id's can be changed if they are
        * member variables.  Use const to control when they are changed.
        */
-      UniqueId& operator=(const UniqueId& rhs);
+      UniqueId& operator=(const std::string& rhs);
 
       /**
-       * The assignment operator is public so that unique id's can be changed if they are
-       * member variables.  Use const to control when they are changed.
+       * Copies the binary form of the id.
+       * @return false if the id is null or is not a canonical, lower case uuid.
        */
-      UniqueId& operator=(const std::string& rhs);
+      bool ToBytes(unsigned char bytesOut[BYTE_COUNT]) const;
+
+      /// Sets the id to a binary uuid.  ToString will return it in the canonical, lower case form.
+      void FromBytes(const unsigned char bytes[BYTE_COUNT]);
+
+      size_t GetHash() const
+      {
+         unsigned long long h = mHigh ^ (mLow * 0x9E3779B97F4A7C15ULL);
+         return size_t(h ^ (h >> 32));
+      }
+
+   private:
+      bool IsText() const { return mHigh == 0ULL && mLow != 0ULL; }
 
-   protected:
-      std::string mId;
+      void SetFromString(const char* text, size_t length);
+      /// Sets the id to the text table entry, which already counts the reference, and releases the old one.
+      void SetText(unsigned long long textIndex);
+      bool LessAsText(const UniqueId& rhs) const;
+
+      static void AddTextRef(unsigned long long textIndex);
+      static void ReleaseText(unsigned long long textIndex);
+
+      /// The first 8 bytes of a binary id, big endian.  0 for null ids and ids kept as text.
+      unsigned long long mHigh;
+      /// The last 8 bytes of a binary id, big endian, or the text table index + 1 if mHigh is 0.
+      unsigned long long mLow;
    };
 
    ////////////////////////////////////////////////////
@@ -86,10 +168,19 @@ namespace dtCore
 
    DT_CORE_EXPORT std::istream& operator >> (std::istream& i, UniqueId& id);
 
+   /// Writes the id as a string, which every version of the engine can read.
    DT_CORE_EXPORT dtUtil::DataStream& operator << (dtUtil::DataStream& ds, const UniqueId& id);
 
+   /// Reads an id written either as a string or by WriteCompactUniqueId.
    DT_CORE_EXPORT dtUtil::DataStream& operator >> (dtUtil::DataStream& ds, UniqueId& id);
 
+   /**
+    * Writes a binary id as a 2 byte marker and its 16 bytes, and any other id as a string the same way
+    * operator << does.  No string written in either byte order starts with the marker's bytes, so
+    * operator >> can tell the two apart.
+    */
+   DT_CORE_EXPORT void WriteCompactUniqueId(dtUtil::DataStream& ds, const UniqueId& id);
+
 } // namespace dtCore
 
 namespace dtUtil
@@ -98,7 +189,7 @@ namespace dtUtil
    struct hash<dtCore::UniqueId>
    {
      size_t operator()(const dtCore::UniqueId& id) const
-     { return dtUtil::__hash_string(id.ToString().c_str()); }
+     { return id.GetHash(); }
    };
 
 } // namespace dtUtil
@@ -26,8 +26,13 @@
 #include <dtDIS/pluginmanager.h>     // for member
 #include <dtDIS/connection.h>        // for member
 #include <dtDIS/outgoingmessage.h>   // for member
+#include <dtDIS/packetring.h>        // for member
+#include <dtDIS/packetreceiver.h>    // for member
+#include <dtUtil/getsetmacros.h>     // for accessors
 #include <DIS/IncomingMessage.h>     // for member
+#include <memory>                    // for member
 #include <string>                    // for parameter, member
+#include <vector>                    // for member
 #include <dtDIS/dtdisexport.h>       // for export symbols
 
 namespace dtDIS
@@ -100,6 +105,26 @@ namespace dtDIS
       /// @return the SharedState instance.
       const SharedState* GetSharedState() const;
 
+      /// Read datagrams on a separate thread so the socket is emptied between frames.
+      /// Otherwise the socket is drained on each TICK_LOCAL.  Set it before adding the component to the GameManager.
+      DT_DECLARE_ACCESSOR(bool, UseReceiveThread);
+
+      /// The number of datagrams that can be held between ticks.  Set it before adding the component to the GameManager.
+      DT_DECLARE_ACCESSOR(unsigned, ReceiveBufferCount);
+
+      /// Pack as many outgoing PDUs as fit in the MTU into each datagram.  The standard allows it, but some older
+      /// receivers only read the first PDU of a datagram, so it's off by default.
+      DT_DECLARE_ACCESSOR(bool, CoalesceOutgoingPDUs);
+
+      /// @return the number of datagrams received since the component was added to the GameManager.
+      unsigned GetReceivedDatagramCount() const;
+
+      /// @return the number of datagrams thrown away because the receive buffers were full.
+      unsigned GetDroppedDatagramCount() const;
+
+      /// @return the number of datagrams sent since the component was added to the GameManager.
+      unsigned GetSentDatagramCount() const;
+
    protected:
       ~MasterComponent();
 
@@ -119,6 +144,15 @@ namespace dtDIS
       void LoadPlugins(const std::string& directory);
       void UnloadPlugins();
 
+      /// passes every received datagram to the IncomingMessage.
+      void ProcessReceivedPackets();
+
+      /// sends every queued outgoing PDU.
+      void SendOutgoingPackets();
+
+      /// sends the PDUs packed so far as one datagram.
+      void FlushSendBuffer();
+
    private:
       PluginManager mPluginManager;
       Connection mConnection;
@@ -126,6 +160,10 @@ namespace dtDIS
       OutgoingMessage mOutgoingMessage;
       SharedState* mConfig;
       DefaultPlugin* mDefaultPlugin;
+      std::unique_ptr<PacketRing> mReceiveRing;
+      std::unique_ptr<PacketReceiver> mReceiver;
+      std::vector<char> mSendBuffer;
+      unsigned mSentDatagramCount;
    };
 }
 
@@ -0,0 +1,74 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef __DELTA_DTDIS_PACKET_RECEIVER_H__
+#define __DELTA_DTDIS_PACKET_RECEIVER_H__
+
+#include <dtDIS/dtdisexport.h>           // for library export definitions
+#include <OpenThreads/Thread>            // for base class
+#include <OpenThreads/Atomic>            // for member
+#include <vector>                        // for member
+
+namespace dtDIS
+{
+   class Connection;
+   class PacketRing;
+
+   ///\brief Drains every pending datagram from a Connection into a PacketRing.
+   ///
+   /// Drain may be called from the thread that reads the ring, or the receiver may be started
+   /// as its own thread so the socket keeps being emptied between frames.
+   class DT_DIS_EXPORT PacketReceiver : public OpenThreads::Thread
+   {
+   public:
+      PacketReceiver(Connection& connection, PacketRing& ring);
+      virtual ~PacketReceiver();
+
+      /// reads datagrams until the socket is empty or maxPackets have been read.
+      /// Datagrams that arrive while the ring is full are read and counted as dropped.
+      /// @return the number of datagrams read from the socket.
+      unsigned Drain(unsigned maxPackets);
+
+      /// the thread loop, it drains the socket until Stop is called.
+      virtual void run();
+
+      /// ends the thread loop and waits for it to exit.
+      void Stop();
+
+      /// @return the number of datagrams placed in the ring.
+      unsigned GetReceivedCount() const;
+
+      /// @return the number of datagrams thrown away because the ring was full.
+      unsigned GetDroppedCount() const;
+
+      /// microseconds the thread sleeps when the socket is empty.
+      void SetIdleSleep(unsigned microseconds);
+      unsigned GetIdleSleep() const;
+
+   private:
+      Connection& mConnection;
+      PacketRing& mRing;
+      std::vector<char> mOverflow;
+      unsigned mIdleSleep;
+      OpenThreads::Atomic mStopRequested;
+      OpenThreads::Atomic mReceivedCount;
+      OpenThreads::Atomic mDroppedCount;
+   };
+}
+
+#endif  // __DELTA_DTDIS_PACKET_RECEIVER_H__
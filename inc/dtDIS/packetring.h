@@ -0,0 +1,74 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef __DELTA_DTDIS_PACKET_RING_H__
+#define __DELTA_DTDIS_PACKET_RING_H__
+
+#include <dtDIS/dtdisexport.h>           // for library export definitions
+#include <OpenThreads/Atomic>            // for member
+#include <cstddef>                       // for size_t definition
+#include <vector>                        // for member
+
+namespace dtDIS
+{
+   ///\brief A fixed ring of preallocated datagram buffers passed from one writer thread to one reader thread.
+   ///
+   /// Neither side locks or allocates.  The writer fills the slot from BeginWrite and publishes it with EndWrite,
+   /// the reader takes slots in order with BeginRead and gives them back with EndRead.
+   class DT_DIS_EXPORT PacketRing
+   {
+   public:
+      /// @param capacity the number of buffers, rounded up to a power of two.
+      /// @param packetSize the size of each buffer, usually the network MTU.
+      PacketRing(unsigned capacity, size_t packetSize);
+
+      /// @return the buffer to write the next packet into, or NULL if the ring is full.  Writer thread only.
+      char* BeginWrite();
+
+      /// publishes the buffer returned by BeginWrite holding numbytes of data.  Writer thread only.
+      void EndWrite(size_t numbytes);
+
+      /// @return the oldest published packet, or NULL if the ring is empty.  Reader thread only.
+      const char* BeginRead(size_t& numbytes);
+
+      /// releases the packet returned by BeginRead so it can be written again.  Reader thread only.
+      void EndRead();
+
+      /// @return the number of packets waiting to be read.
+      unsigned GetSize() const;
+
+      unsigned GetCapacity() const;
+
+      size_t GetPacketSize() const;
+
+   private:
+      PacketRing(const PacketRing&);               ///< not implemented by design.
+      PacketRing& operator=(const PacketRing&);    ///< not implemented by design.
+
+      unsigned mMask;
+      size_t mPacketSize;
+      std::vector<char> mBuffers;
+      std::vector<size_t> mSizes;
+
+      // Counts of packets written and read.  They only ever increase, and wrap together.
+      OpenThreads::Atomic mWriteCount;
+      OpenThreads::Atomic mReadCount;
+   };
+}
+
+#endif  // __DELTA_DTDIS_PACKET_RING_H__
@@ -0,0 +1,138 @@
+/* -*-c++-*-
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ */
+
+#ifndef DELTA_ASYNCLOGSTREAMWRITER
+#define DELTA_ASYNCLOGSTREAMWRITER
+
+#include <dtGame/export.h>
+#include <OpenThreads/Thread>
+#include <OpenThreads/Atomic>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace dtGame
+{
+   /**
+    * Writes records to a file on its own thread so the thread producing them never waits on the disk.
+    *
+    * Records are copied into a fixed ring of preallocated buffers.  When a buffer can't hold the next
+    * record it is handed to the IO thread, which writes each buffer with one fwrite.  Only one thread may
+    * call Write, Flush, and Stop, and neither side locks.
+    *
+    * If every buffer is waiting to be written, Write either waits for the IO thread, counting a stall, or
+    * drops the record, counting it, depending on SetDropWhenFull.  A record is never partly written.
+    * If the thread isn't running, full buffers are written on the calling thread instead.
+    */
+   class DT_GAME_EXPORT AsyncLogStreamWriter : public OpenThreads::Thread
+   {
+   public:
+      static const unsigned DEFAULT_NUM_BUFFERS = 8;
+      static const size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+      /**
+       * @param file the file to append to.  It is not closed by the writer.
+       * @param numBuffers the number of buffers in the ring, rounded up to a power of two.
+       * @param bufferSize the size of each buffer.  A record larger than this grows the buffer it lands in.
+       */
+      AsyncLogStreamWriter(FILE* file, unsigned numBuffers = DEFAULT_NUM_BUFFERS,
+               size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+      /// Calls Stop.
+      virtual ~AsyncLogStreamWriter();
+
+      /**
+       * Appends one record made of a header and a body, either of which may be empty.
+       * @return false if the record was dropped because the ring was full or writing has failed.
+       */
+      bool Write(const char* header, size_t headerSize, const char* body = NULL, size_t bodySize = 0);
+
+      /// Hands the partly filled buffer to the IO thread, waits until everything is written, and flushes the file.
+      void Flush();
+
+      /// The thread loop.  It writes buffers as they fill until Stop is called.
+      virtual void run();
+
+      /// Flushes, then ends the thread and waits for it to exit.
+      void Stop();
+
+      /// @return the file offset the next record will be written at.
+      long GetFileOffset() const;
+
+      /// @return true if a write to the file failed.  Everything written after that is thrown away.
+      bool HasError() const;
+
+      /// @return the reason for the failure if HasError is true.
+      const std::string& GetError() const;
+
+      /// Set to true to drop records rather than wait when the IO thread falls behind.  Defaults to false.
+      void SetDropWhenFull(bool drop);
+      bool GetDropWhenFull() const;
+
+      /// @return the number of records thrown away because the ring was full.
+      unsigned GetDroppedCount() const;
+
+      /// @return the number of times Write had to wait for the IO thread to free a buffer.
+      unsigned GetStallCount() const;
+
+      /// @return the number of filled buffers waiting for the IO thread.
+      unsigned GetNumPendingBuffers() const;
+
+      /// microseconds the threads sleep while waiting on each other.
+      void SetIdleSleep(unsigned microseconds);
+      unsigned GetIdleSleep() const;
+
+   private:
+      AsyncLogStreamWriter(const AsyncLogStreamWriter&);            ///< not implemented by design.
+      AsyncLogStreamWriter& operator=(const AsyncLogStreamWriter&); ///< not implemented by design.
+
+      /// Takes the next free buffer for filling.  @return false if the record should be dropped.
+      bool AcquireBuffer();
+      /// Hands the buffer being filled to the IO thread.
+      void PublishBuffer();
+      /// Writes every published buffer to the file.  @return the number of buffers written.
+      unsigned WritePublished();
+
+      FILE* mFile;
+      long mFileOffset;
+      unsigned mMask;
+      std::vector<std::vector<char> > mBuffers;
+      std::vector<size_t> mSizes;
+
+      /// The buffer being filled by Write, if mFilling is true.
+      unsigned mFillSlot;
+      size_t mFillSize;
+      bool mFilling;
+
+      bool mDropWhenFull;
+      unsigned mIdleSleep;
+      std::string mError;
+
+      // Counts of buffers published and written.  They only ever increase, and wrap together.
+      OpenThreads::Atomic mWriteCount;
+      OpenThreads::Atomic mReadCount;
+      OpenThreads::Atomic mStopRequested;
+      OpenThreads::Atomic mErrorFlag;
+      OpenThreads::Atomic mDroppedCount;
+      OpenThreads::Atomic mStallCount;
+   };
+}
+
+#endif // DELTA_ASYNCLOGSTREAMWRITER
@@ -244,6 +244,14 @@ namespace dtGame
           */
          virtual void FinishUp() = 0;
 
+         /**
+          * Optionally starts the queries queued by ClampToGround on the thread pool's IMMEDIATE queue,
+          * so they can run alongside other tasks.  The caller must then call FinishUp, which waits for them
+          * and writes the results back to the actors.  The caller may call dtUtil::ThreadPool::ExecuteTasks
+          * first to help run them.  The base class does nothing, so the queries run in FinishUp as usual.
+          */
+         virtual void AddBatchTasksToThreadPool();
+
       protected:
          dtUtil::Log& GetLogger();
 
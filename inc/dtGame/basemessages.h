@@ -97,6 +97,17 @@ namespace dtGame
          dtCore::RefPtr<ArrayMessageParameter> mMapNames;
    };
 
+   /**
+    * Sent while the actors of the new maps are added to the GM over several frames.
+    * @see GMSettings::GetMapLoadTimeSliceMS
+    */
+   DT_DECLARE_MESSAGE_BEGIN(MapLoadProgressMessage, MapMessage, DT_GAME_EXPORT)
+      /// The number of actors added to the GM so far.
+      DECLARE_PARAMETER_INLINE(unsigned int, ActorsAdded)
+      /// The total number of actors that will be added.
+      DECLARE_PARAMETER_INLINE(unsigned int, TotalActors)
+   DT_DECLARE_MESSAGE_END()
+
    class DT_GAME_EXPORT GameEventMessage : public Message
    {
       public:
@@ -131,6 +142,49 @@ namespace dtGame
       DECLARE_PARAMETER_INLINE(std::string, RejectionMessage)
    DT_DECLARE_MESSAGE_END()
 
+   /**
+    * Sent between network components once a connection is accepted.  It tells the peer the newest
+    * message wire format the sender is able to decode.  Peers that don't know this message type just
+    * drop it and keep talking in the original format.
+    */
+   DT_DECLARE_MESSAGE_BEGIN(NetWireFormatMessage, Message, DT_GAME_EXPORT)
+      /// The newest wire format version the sender can read.
+      DECLARE_PARAMETER_INLINE(unsigned int, WireFormatVersion)
+   DT_DECLARE_MESSAGE_END()
+
+   /**
+    * Sent back across a network connection to acknowledge delta compressed actor updates.  Each entry
+    * pairs an actor id with the sequence number of the newest update received for that actor.  A sequence
+    * number of 0 asks the sender to forget its baseline for the actor and send the next update in full.
+    */
+   class DT_GAME_EXPORT NetActorUpdateAckMessage : public Message
+   {
+      public:
+         static const dtUtil::RefString PARAM_ACTOR_IDS;
+         static const dtUtil::RefString PARAM_SEQUENCES;
+
+         /// Constructor
+         NetActorUpdateAckMessage();
+
+         /// Adds an acknowledgement.
+         void AddAck(const dtCore::UniqueId& actorId, unsigned int sequence);
+
+         /// @return the number of acknowledgements in this message.
+         unsigned int GetAckCount() const;
+
+         /// @return the actor id of the acknowledgement at the given index.
+         const dtCore::UniqueId& GetAckActorId(unsigned int index) const;
+
+         /// @return the sequence number of the acknowledgement at the given index.
+         unsigned int GetAckSequence(unsigned int index) const;
+
+      protected:
+         /// Destructor
+         virtual ~NetActorUpdateAckMessage();
+
+         dtCore::RefPtr<ActorMessageParameter> mActorIds;
+         dtCore::RefPtr<UnsignedIntMessageParameter> mSequences;
+   };
 
    class DT_GAME_EXPORT RestartMessage : public Message
    {
@@ -285,6 +339,45 @@ namespace dtGame
       virtual ~MachineInfoMessage();
    };
 
+   /**
+    * @class NetConnectionMessage
+    * @brief The MachineInfoMessage sent to request a network connection and to accept one.  It also carries
+    * the network protocol version of the sender.
+    *
+    * The version is written after the machine info parameters, behind PROTOCOL_VERSION_MARKER.  A peer that
+    * predates it reads the marker as the type id of a causing message it doesn't know and drops it,
+    * so the connection still works.  A message from such a peer reads back with a protocol version of 0.
+    */
+   class DT_GAME_EXPORT NetConnectionMessage : public MachineInfoMessage
+   {
+   public:
+      /// Message type id written in front of the protocol version.  It must never be registered.
+      static const unsigned short PROTOCOL_VERSION_MARKER = 0xFFFE;
+
+      static const dtUtil::RefString PARAM_PROTOCOL_VERSION;
+
+      /// Constructor
+      NetConnectionMessage();
+
+      /// @return the network protocol version of the sender, or 0 if the sender predates it.
+      unsigned int GetProtocolVersion() const;
+
+      /// Sets the network protocol version of the sender.
+      void SetProtocolVersion(unsigned int version);
+
+      /// Writes the machine info parameters, then the marker and the protocol version.
+      virtual void ToDataStream(dtUtil::DataStream& stream) const;
+
+      /// Reads the machine info parameters, then the protocol version if it follows them.
+      virtual bool FromDataStream(dtUtil::DataStream& stream);
+
+   protected:
+      /// Destructor
+      virtual ~NetConnectionMessage();
+
+      dtCore::RefPtr<UnsignedIntMessageParameter> mProtocolVersion;
+   };
+
    /**
     * @class ServerFrameSyncMessage
     * @brief A ServerFrameSyncMessage is sent from the server at the end of EVERY frame. This message
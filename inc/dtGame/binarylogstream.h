@@ -23,11 +23,23 @@
 #define DELTA_BINARYLOGSTREAM
 
 #include <cstdio>
+#include <deque>
+#include <set>
 #include <dtGame/logstream.h>
 #include <dtGame/export.h>
+#include <dtUtil/datastream.h>
+#include <dtCore/refptr.h>
+#include <dtCore/uniqueid.h>
+
+namespace dtUtil
+{
+   class MappedFile;
+}
 
 namespace dtGame
 {
+   class AsyncLogStreamWriter;
+
    /**
     * This is a log stream class which supports a binary log file format.
     * The stream actually manages two separate files.  The first file contains
@@ -48,7 +60,7 @@ namespace dtGame
       ///Logger major version number.  Equals 1
       static const unsigned char LOGGER_MAJOR_VERSION;
 
-      ///Logger minor version number.  Equals 1
+      ///Logger minor version number.  Equals 2.  Version 1.2 writes the unique ids in their compact form.
       static const unsigned char LOGGER_MINOR_VERSION;
 
       /**
@@ -117,14 +129,18 @@ namespace dtGame
          std::vector<std::string>& logs);
 
       /**
-       * Writes a game message to the message database file.
+       * Writes a game message to the message database file.  With async writes on, the message is
+       * serialized into a buffer that a background thread writes to the file.
        * @param msg The message to write.
        * @param timeStamp The time stamp matched to this message.
+       * @note A LOGGER_IO_EXCEPTION is thrown if the file is invalid, or if the background thread
+       *    failed to write an earlier message.
        */
       virtual void WriteMessage(const Message& msg, double timeStamp);
 
       /**
-       * Reads a game message from the messages database file.
+       * Reads a game message from the messages database file.  If the log is mapped, the message
+       * is decoded straight out of the mapping, or was already decoded ahead on the thread pool.
        * @param This parameter will contain the time stamp of the read
        *    message.
        * @return The next game message in file.
@@ -151,6 +167,15 @@ namespace dtGame
        */
       virtual void JumpToKeyFrame(const LogKeyframe& keyFrame);
 
+      /**
+       * Positions a mapped log so the next call to ReadMessage returns the first message at or after
+       * the given time, found with a binary search of the time index.  Messages are logged out of time
+       * order now and then, so a message shortly after it may still have an earlier time stamp.
+       * @param simTime The time to go to.
+       * @return false if the log was not opened with mapped reads, in which case nothing changes.
+       */
+      bool SeekToTime(double simTime);
+
       /**
        * Gets the list of tags in this log stream.  The tags are
        * located in the index table.
@@ -173,6 +198,44 @@ namespace dtGame
        */
       virtual void Flush();
 
+      /**
+       * Sets whether messages are written to the file by a background thread so WriteMessage never
+       * waits on the disk.  Takes effect the next time a log is created.  Defaults to true.
+       */
+      void SetAsyncWrites(bool async);
+      bool GetAsyncWrites() const;
+
+      /**
+       * Sets whether messages are dropped, rather than making WriteMessage wait, when the background
+       * thread falls behind.  Takes effect the next time a log is created.  Defaults to false.
+       */
+      void SetDropMessagesWhenBehind(bool drop);
+      bool GetDropMessagesWhenBehind() const;
+
+      /// @return the number of messages dropped since the log was created.
+      virtual unsigned GetNumDroppedMessages() const;
+
+      /// @return the number of times WriteMessage waited for the background thread since the log was created.
+      virtual unsigned GetNumWriteStalls() const;
+
+      /**
+       * Sets whether Open maps the messages file into memory rather than reading it a piece at a time.
+       * Mapped logs index every message by time when they are opened, so seeking is a binary search.
+       * Takes effect the next time a log is opened.  Defaults to true.
+       */
+      void SetMappedReads(bool mapped);
+      bool GetMappedReads() const;
+
+      /**
+       * Sets how many messages past the read position of a mapped log are decoded ahead as background
+       * tasks on the thread pool.  0, or a thread pool that isn't initialized, turns this off.  Defaults to 256.
+       */
+      void SetPrefetchWindow(unsigned numMessages);
+      unsigned GetPrefetchWindow() const;
+
+      /// @return the number of messages in the log if it was opened with mapped reads, otherwise 0.
+      unsigned GetNumIndexedMessages() const;
+
    protected:
       ///The postfix string attached to the base log file name corresponding to
       ///the file containing the database of messages.
@@ -211,7 +274,8 @@ namespace dtGame
                return false;
             }
 
-            if (minorVersion != BinaryLogStream::LOGGER_MINOR_VERSION)
+            // Older minor versions are still read.
+            if (minorVersion > BinaryLogStream::LOGGER_MINOR_VERSION)
             {
                error = "Minor version mismatch.";
                return false;
@@ -249,7 +313,8 @@ namespace dtGame
                return false;
             }
 
-            if (minorVersion != BinaryLogStream::LOGGER_MINOR_VERSION)
+            // Older minor versions are still read.
+            if (minorVersion > BinaryLogStream::LOGGER_MINOR_VERSION)
             {
                error = "Minor version mismatch.";
                return false;
@@ -352,7 +417,59 @@ namespace dtGame
        */
       LogTag ReadTag();
 
+      /**
+       * Writes out everything the background writer holds and stops it.  Called before the messages
+       * file is closed or rewritten.  A write error is logged, since this runs from the destructor.
+       */
+      void StopMessageWriter();
+
+      /**
+       * Maps the messages file and indexes every message in it.  A partly written message at the end of
+       * the file, which a crash while recording leaves behind, ends the index with a warning.
+       * @param firstMessageOffset The offset of the first message, just past the file header.
+       * @return false if the file could not be mapped.
+       */
+      bool MapMessages(long firstMessageOffset);
+
+      /// Waits for the prefetch tasks, unmaps the messages file, and clears the index.
+      void UnmapMessages();
+
+      /**
+       * Decodes a message of a mapped log.  This runs on the thread pool too, so it only reads the
+       * mapping and the index.
+       */
+      dtCore::RefPtr<Message> DecodeMappedMessage(unsigned index, double& timeStamp);
+
+      /// Queues tasks to decode the messages in the prefetch window that aren't queued yet.
+      void StartPrefetch();
+
+      /// @return the message at the index if a prefetch task decoded it, or NULL.
+      dtCore::RefPtr<Message> TakePrefetchedMessage(unsigned index, double& timeStamp);
+
+      /// Cancels or waits for every prefetch task and throws away what they decoded.
+      void CancelPrefetch();
+
    private:
+      /// Decodes a range of messages of a mapped log on the thread pool.
+      class PrefetchTask;
+
+      struct MessageIndexEntry
+      {
+         size_t mOffset;
+         /// The latest time stamp of this message and all the ones before it, so the index is sorted by it.
+         double mLatestTime;
+
+         static bool LessByOffset(const MessageIndexEntry& lhs, const MessageIndexEntry& rhs)
+         {
+            return lhs.mOffset < rhs.mOffset;
+         }
+
+         static bool LessByTime(const MessageIndexEntry& lhs, const MessageIndexEntry& rhs)
+         {
+            return lhs.mLatestTime < rhs.mLatestTime;
+         }
+      };
+
       FILE* mMessagesFile;
       std::string mMessagesFileName;
 
@@ -375,6 +492,35 @@ namespace dtGame
 
       int mCurrentMinorVersion;
 
+      ///Writes the messages file on its own thread while recording with async writes.
+      AsyncLogStreamWriter* mMessageWriter;
+
+      ///Reused for each message so writing doesn't allocate.
+      dtUtil::DataStream mRecordStream;
+
+      bool mAsyncWrites;
+      bool mDropMessagesWhenBehind;
+      unsigned mNumDroppedMessages;
+      unsigned mNumWriteStalls;
+
+      ///The ids of the existing and new keyframes, so a jump doesn't search the lists.
+      std::set<dtCore::UniqueId> mKeyFrameIds;
+
+      ///Reused for each message read when the log is not mapped.
+      std::vector<char> mReadBuffer;
+
+      ///The messages file mapped for playback, if mapped reads are on.
+      dtCore::RefPtr<dtUtil::MappedFile> mMappedMessages;
+      std::vector<MessageIndexEntry> mMessageIndex;
+      unsigned mNextMessageIndex;
+
+      ///Prefetch tasks in the order of the messages they decode.
+      std::deque<dtCore::RefPtr<PrefetchTask> > mPrefetchTasks;
+      ///The index past the last message a prefetch task was queued for.
+      unsigned mPrefetchEnd;
+      unsigned mPrefetchWindow;
+      bool mMappedReads;
+
       // Tracks whether we have opened the files for write mode (typically RECORD only)
       // or for read mode (typically playback).
       bool mFilesAreOpenForWriting;
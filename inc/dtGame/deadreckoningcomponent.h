@@ -24,7 +24,10 @@
 #include <string>
 #include <map>
 
+#include <vector>
+
 #include <dtCore/refptr.h>
+#include <dtCore/observerptr.h>
 #include <dtUtil/nodecollector.h>
 
 #include <dtGame/export.h>
@@ -51,6 +54,12 @@ namespace dtGame
 
       static const std::string DEFAULT_NAME;
 
+      /**
+       * The fewest remote actors dead-reckoned by one thread pool task.  Fewer actors than twice this
+       * are dead-reckoned on the calling thread because the task overhead would cost more than it saves.
+       */
+      static const unsigned MIN_ACTORS_PER_TASK = 32;
+
       DeadReckoningComponent(dtCore::SystemComponentType& type = *TYPE);
 
       /**
@@ -157,7 +166,36 @@ namespace dtGame
             const osg::Vec3& currLocation, const osg::Vec3& currentRate,
             float simTimeDelta, bool isPositional = false) const;
 
+      /**
+       * The per tick state of one registered actor, kept in a vector so the dead reckoning math can be split
+       * into contiguous chunks for the thread pool.  Rebuilt from mRegisteredActors when it changes.
+       */
+      struct RemoteEntry
+      {
+         RemoteEntry();
+
+         dtCore::ObserverPtr<dtGame::GameActorProxy> mActor;
+         dtCore::Transformable* mDrawable;
+         DeadReckoningActorComponent* mHelper;
+         dtCore::Transform mXform;
+         BaseGroundClamper::GroundClampRangeType* mGroundClampType;
+         bool mTransformChanged;
+      };
+
+      /// Dead-reckons a range of the remote entries.  Defined in the cpp.
+      class DeadReckonTask;
+
+      /// Fills mRemoteEntries from mRegisteredActors if registration has changed since the last tick.
+      void UpdateRemoteEntries();
+
+      /// Runs IncrementTimeSinceUpdate and DoDR on the entries in [begin, end).  Safe to call concurrently on separate ranges.
+      void DeadReckonEntries(unsigned begin, unsigned end, float simTimeDelta, double simTime);
+
       std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningActorComponent> > mRegisteredActors;
+      std::vector<RemoteEntry> mRemoteEntries;
+      std::vector<dtCore::RefPtr<DeadReckonTask> > mDeadReckonTasks;
+      bool mRemoteEntriesDirty;
+
       dtCore::RefPtr<dtGame::BaseGroundClamper> mGroundClamper;
 
       dtUtil::Log* mLogger;
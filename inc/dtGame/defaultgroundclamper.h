@@ -28,6 +28,7 @@
 
 #include <dtCore/transform.h>
 #include <dtCore/batchisector.h>
+#include <dtUtil/threadpool.h>
 
 #include <osg/Referenced>
 
@@ -228,6 +229,12 @@ namespace dtGame
           */
          virtual void FinishUp();
 
+         /**
+          * Adds a task to the thread pool for each group of 32 queued single point queries, since that is
+          * what one BatchIsector holds.  FinishUp then only has to write back the results.
+          */
+         virtual void AddBatchTasksToThreadPool();
+
          /**
           * Modify the specified transform to be oriented to the specified
           * surface points.
@@ -295,9 +302,8 @@ namespace dtGame
 
          /**
           * This should be called manually at the end an group of ground clamping calls.
-          * It will go through any remaining ground clamping queries and run them in a batch.
-          * This is normally called when the number queued reaches a threshold, but in most cases
-          * some are left waiting at the end of a group of calls.
+          * It will go through the queued ground clamping queries and run them in a batch,
+          * unless AddBatchTasksToThreadPool already ran them, and then sets the actor transforms.
           */
          void RunClampBatch();
 
@@ -312,9 +318,12 @@ namespace dtGame
           */
          virtual RuntimeData& GetOrCreateRuntimeData(dtGame::GroundClampingData& data);
 
+         /// @return the isector for the first 32 queries of the single point batch.
          dtCore::BatchIsector& GetGroundClampIsector();
 
       private:
+         /// Fills one isector per 32 queued queries.
+         void SetupClampBatchIsectors();
 
          typedef std::pair<dtCore::TransformableActorProxy*, GroundClampingData*> ProxyAndData;
          typedef std::vector<std::pair<dtCore::Transform, ProxyAndData> > BatchVector;
@@ -322,7 +331,12 @@ namespace dtGame
          BatchVector mGroundClampBatch;
 
          dtCore::RefPtr<dtCore::BatchIsector> mTripleIsector;
-         dtCore::RefPtr<dtCore::BatchIsector> mIsector;
+         /// One isector for each 32 queries in the batch.  Only the ones the batch needs are used.
+         std::vector<dtCore::RefPtr<dtCore::BatchIsector> > mIsectors;
+         /// Runs the isector with the same index.
+         std::vector<dtCore::RefPtr<dtUtil::ThreadPoolTask> > mIsectorTasks;
+         /// The number of queries the thread pool tasks were set up for, or 0 if none were added.
+         unsigned mNumQueriesInTasks;
    };
 
 }
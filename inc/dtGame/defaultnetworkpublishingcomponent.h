@@ -41,7 +41,10 @@ namespace dtGame
       static const dtCore::RefPtr<dtCore::SystemComponentType> TYPE;
       static const std::string DEFAULT_NAME;
 
-      /// Constructor
+      /**
+       * Constructor.  The component is GMComponent::ConcurrentSafe because it only reads the actors and sends
+       * network messages.  A subclass that does more in the ProcessUnhandled methods should turn that off.
+       */
       DefaultNetworkPublishingComponent(dtCore::SystemComponentType& type = *TYPE);
 
       /**
@@ -261,6 +261,12 @@ namespace dtGame
        */
       void GetInvokables(std::vector<const Invokable*>& toFill) const;
 
+      /**
+       * @return a number that changes each time an invokable is added or removed, so the GameManager
+       *         can keep the invokables its listeners refer to without looking them up by name for every message.
+       */
+      unsigned GetInvokablesRevision() const { return mInvokablesRevision; }
+
       /**
        * Creates an ActorUpdateMessage, populates it with ALL properties on the actor
        * and calls SendMessage() on the Game Manager.
@@ -778,6 +784,7 @@ namespace dtGame
       std::map<std::string, dtCore::RefPtr<Invokable> > mInvokables;
       std::multimap<const MessageType*, dtCore::RefPtr<Invokable> > mMessageHandlers;
       std::set<dtUtil::RefString> mLocalUpdatePropertyAcceptList;
+      unsigned mInvokablesRevision;
       bool mIsInGM;
       bool mPublished;
       bool mRemote;
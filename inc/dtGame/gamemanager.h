@@ -32,6 +32,9 @@
 #include <dtCore/timer.h>
 #include <dtUtil/enumeration.h> //for ComponentPriority
 #include <dtGame/exceptionenum.h>
+#include <osg/Vec3>
+#include <osg/BoundingBox>
+#include <cfloat>
 
 namespace dtUtil
 {
@@ -694,6 +697,49 @@ namespace dtGame
        */
       void FindActorsByClassName(const std::string& className, dtCore::ActorPtrVector& toFill);
 
+      /**
+       * Fills a vector with the actors whose drawable is a transformable within a radius of a point.
+       * The positions come from a spatial index.  The drawables tell the index when they move, and the actors that
+       * moved are read again by the next query.  Call UpdateSpatialIndex after giving an actor in the GM a new drawable.
+       * @param center the center of the search in world coordinates
+       * @param radius the search radius
+       * @param toFill The vector to fill.  It will be cleared before searching.  The order is undefined.
+       */
+      void FindActorsInRadius(const osg::Vec3& center, float radius, dtCore::ActorPtrVector& toFill);
+
+      /**
+       * Fills a vector with the actors whose drawable is a transformable inside a world space box.
+       * @see FindActorsInRadius for when the positions are read.
+       * @param box The box to search
+       * @param toFill The vector to fill.  It will be cleared before searching.  The order is undefined.
+       */
+      void FindActorsInBox(const osg::BoundingBox& box, dtCore::ActorPtrVector& toFill);
+
+      /**
+       * Fills a vector with the actors whose drawable is a transformable nearest a point, nearest first.
+       * @see FindActorsInRadius for when the positions are read.
+       * @param center the point to search from in world coordinates
+       * @param count the number of actors to find.
+       * @param toFill The vector to fill.  It will be cleared before searching.
+       * @param maxDistance actors further away than this are ignored.
+       */
+      void FindNearestActors(const osg::Vec3& center, unsigned count, dtCore::ActorPtrVector& toFill,
+               float maxDistance = FLT_MAX);
+
+      /**
+       * Reads the transforms of all the actors into the spatial index used by FindActorsInRadius, FindActorsInBox
+       * and FindNearestActors.  Moves are picked up without it, but a drawable that replaced an actor's drawable,
+       * or a plain OSG transform above one that changed, is not.
+       */
+      void UpdateSpatialIndex();
+
+      /**
+       * Sets the size of the cells of the spatial index.  It should be about the radius of the common searches.
+       * The default is 16.
+       */
+      void SetSpatialIndexCellSize(float cellSize);
+      float GetSpatialIndexCellSize() const;
+
 
       /**
        * Returns the game actor proxy whose is matches the parameter
@@ -757,6 +803,8 @@ namespace dtGame
        * If a map or maps is currently open, it will send INFO_MAP_UNLOAD_BEGIN.
        * Once that map or map set is closed, it will set INFO_MAP_UNLOADED
        * Right before it begins loading maps, it sends INFO_MAP_LOAD_BEGIN
+       * If GMSettings::GetMapLoadTimeSliceMS is set, the actors are added over several frames and it sends
+       * INFO_MAP_CHANGE_LOAD_PROGRESS after each one.
        * When that finishes, it will send INFO_MAP_LOADED.
        * At the very end it sends INFO_MAP_CHANGED.
        *
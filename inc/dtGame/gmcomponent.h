@@ -90,6 +90,23 @@ namespace dtGame
        */
       DT_DECLARE_ACCESSOR(dtUtil::EnumerationPointer<GameManager::ComponentPriority>, ComponentPriority);
 
+      /**
+       * Set this in the constructor of a component that may process a message at the same time as other components.
+       * When GMSettings::ConcurrentComponentDispatch is on, the GM hands each message to all such components in parallel
+       * on the thread pool and waits for them before the rest get it on the main thread in priority order.
+       * So ProcessMessage and DispatchNetworkMessage may read the message and the GM, send messages and change the
+       * component's own data, but nothing else.  Loggers, statistics and network publishers are typical examples.
+       * Default is false.
+       */
+      DT_DECLARE_ACCESSOR(bool, ConcurrentSafe);
+
+      /**
+       * Override this if only some messages are safe to process concurrently.  It's called on the main thread before
+       * the message is sent to any component.
+       * @return GetConcurrentSafe() by default.
+       */
+      virtual bool IsConcurrentSafeFor(const Message& message) const;
+
       void BuildPropertyMap() override;
 
       /**
@@ -23,12 +23,14 @@
 
 #include <dtGame/export.h>
 
+#include <deque>
 #include <queue>
 #include <set>
 #include <list>
 #include <map>
 
 #include <dtCore/uniqueid.h>
+#include <dtCore/observerptr.h>
 #include <dtCore/timer.h>
 #include <dtGame/gmstatistics.h>
 #include <dtGame/gmsettings.h>
@@ -39,19 +41,25 @@
 #include <dtGame/mapchangestatedata.h>
 #include <dtGame/gmcomponent.h>
 #include <dtGame/environmentactor.h>
+#include <dtGame/timerwheel.h>
 #include <dtCore/scene.h>
 
 #include <dtUtil/hashmap.h>
+#include <dtUtil/spatialgrid.h>
+#include <dtUtil/threadpool.h>
+#include <OpenThreads/Mutex>
 
 
 namespace dtCore
 {
    class BaseActorObject;
+   class Transformable;
 }
 
 namespace dtGame
 {
    class GameActorProxy;
+   class Invokable;
 
    // exception class known only to the GM that fires when shutting down to make the GM exit its tick.
    class GMShutdownException
@@ -69,6 +77,56 @@ namespace dtGame
       ~BatchData() {}
    };
 
+   /// Hands one message to one concurrent safe component on the thread pool.
+   class ComponentDispatchTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      ComponentDispatchTask(dtUtil::Log& logger);
+
+      void Setup(GMComponent& component, const Message& message, bool toNetwork, bool timed);
+
+      /// Drops the references to the component and message so the task can be reused.
+      void Clear();
+
+      void operator()() override;
+
+      GMComponent* GetComponent() const { return mComponent.get(); }
+
+      /// @return the seconds the component spent on the message, if timed was passed to Setup.
+      double GetElapsedTime() const { return mElapsedTime; }
+      bool GetTimed() const { return mTimed; }
+
+   protected:
+      ~ComponentDispatchTask() {}
+
+   private:
+      dtUtil::Log& mLogger;
+      dtCore::RefPtr<GMComponent> mComponent;
+      dtCore::RefPtr<const Message> mMessage;
+      dtCore::Timer mClock;
+      double mElapsedTime;
+      bool mToNetwork;
+      bool mTimed;
+   };
+
+   /**
+    * An actor registered for messages, with its invokable looked up once rather than by name for every message.
+    * The invokable is looked up again only when the actor's invokables change.
+    */
+   struct MessageListener
+   {
+      MessageListener(GameActorProxy& actor, const std::string& invokableName);
+
+      /// @return the invokable named mInvokableName on mActor or NULL if it has none with that name.
+      Invokable* GetInvokable();
+
+      /// NULL once unregistered while messages are being sent.  The entry is erased afterwards.
+      dtCore::RefPtr<GameActorProxy> mActor;
+      std::string mInvokableName;
+      Invokable* mInvokable;
+      unsigned mInvokablesRevision;
+   };
+
    /// A wrapper for data like stats to prevent includes wherever gamemanager.h is used - uses the pimpl pattern (like system)
    class DT_GAME_EXPORT GMImpl
    {
@@ -76,41 +134,21 @@ namespace dtGame
 
       GMImpl(dtCore::Scene& scene);
       
-      ~GMImpl()
-      {
-      }
-
-      struct TimerInfo
-      {
-         std::string name;
-         dtCore::UniqueId aboutActor;
-         dtCore::Timer_t time;
-         bool repeat;
-         dtCore::Timer_t interval;
-
-         bool operator < (const TimerInfo& rhs) const
-         {
-            if (time == rhs.time)
-            {
-               return this <& rhs;
-            }
-            return time < rhs.time;
-         }
-      };
-
-      /// Does the work of ClearTimer for each of the timer info sets.
-      void ClearTimerSingleSet(std::set<TimerInfo>& timerSet,
-                               const std::string& name, const GameActorProxy* proxy);
+      ~GMImpl();
 
-      void ClearTimersForActor(std::set<TimerInfo>& timerSet, const GameActorProxy& parent);
+      /// Removes the timers about an actor that is leaving the GM from both timer wheels.
+      void ClearTimersForActor(const GameActorProxy& actor);
 
       /**
        * Helper method to process the timers. This is called from PreFrame
-       * @param listToProcess The timer list to process
+       * @param timers The timer wheel to process
        * @param clockTime The time to use
-       * @note The clock time should correspond to the list to be processed
+       * @note The clock time should correspond to the wheel to be processed
        */
-      void ProcessTimers(GameManager& gm, std::set<TimerInfo>& listToProcess, dtCore::Timer_t clockTime);
+      void ProcessTimers(GameManager& gm, TimerWheel& timers, dtCore::Timer_t clockTime);
+
+      /// Sets the message pool sizes from mGMSettings on the factory if they changed since they were last set.
+      void UpdateMessagePoolSizes();
 
       /**
        * Removes the proxy from the scene
@@ -137,6 +175,71 @@ namespace dtGame
 
       void ReparentDanglingDrawables(GameManager& gm, dtCore::DeltaDrawable* dd);
 
+      /**
+       * Sends a message to a component, logging anything it throws.
+       */
+      static void DeliverMessageToComponent(GMComponent& component, const Message& message, bool toNetwork, dtUtil::Log& logger);
+
+      typedef std::vector<dtCore::RefPtr<ComponentDispatchTask> > ComponentDispatchTasks;
+
+      /**
+       * Creates a task for each valid component that is GMComponent::IsConcurrentSafeFor the message and queues all
+       * but the first on the thread pool.  Nothing is queued if the pool has no immediate worker threads.
+       * @param timed true to time each component for the statistics.
+       */
+      void StartConcurrentComponentDispatch(const Message& message, bool toNetwork, bool timed, ComponentDispatchTasks& tasksOut);
+
+      /**
+       * Runs the tasks from StartConcurrentComponentDispatch that weren't queued, waits for the rest and adds their
+       * timing to the statistics.
+       */
+      void FinishConcurrentComponentDispatch(ComponentDispatchTasks& tasks, bool tickLocal);
+
+      /// @return true if one of the tasks sent the message to the component.
+      static bool WasDispatchedConcurrently(const ComponentDispatchTasks& tasks, const GMComponent& component);
+
+      /// Keeps finished tasks for the next StartConcurrentComponentDispatch and clears the list.
+      void RecycleComponentDispatchTasks(ComponentDispatchTasks& tasks);
+
+      typedef std::queue<dtCore::RefPtr<const Message> > MessageQueue;
+
+      /// Adds a message to one of the send queues.  Components may send messages from the thread pool.
+      void PushQueuedMessage(MessageQueue& queue, const Message& message);
+
+      /// Takes the next message off one of the send queues.  @return false if the queue is empty.
+      bool PopQueuedMessage(MessageQueue& queue, dtCore::RefPtr<const Message>& messageOut);
+
+      /**
+       * Sends a message to each listener in the list that was registered before the call, skipping the ones
+       * that are unregistered or whose actor left the GM.  Listeners may register and unregister while this runs.
+       */
+      void InvokeMessageListeners(const Message& message, MessageListenerList& listeners, bool tickLocalStats);
+
+      /**
+       * Unregisters a listener.  It's erased now if no message is being sent, otherwise it's cleared and
+       * erased when the messages are done so the lists being sent to don't change underneath.
+       * @return the listener after the one removed.
+       */
+      MessageListenerList::iterator RemoveMessageListener(MessageListenerList& listeners, MessageListenerList::iterator i);
+
+      /// Erases the listeners that were unregistered while messages were being sent.
+      void CompactMessageListeners();
+
+      /// Reads the positions of the actors whose drawables moved since the last update into the spatial index.
+      void UpdateActorSpatialIndex();
+
+      /// Reads the position of every actor into the spatial index, which also picks up drawables that were replaced.
+      void RefreshActorSpatialIndex();
+
+      /// Adds, moves or removes one actor in the spatial index based on its drawable.
+      void UpdateActorInSpatialIndex(dtCore::BaseActorObject& actor);
+
+      /// Removes an actor that is leaving the GM from the spatial index.
+      void RemoveActorFromSpatialIndex(dtCore::BaseActorObject& actor);
+
+      /// The transform changed callback set on the drawables in the spatial index.  It only queues the actor.
+      void OnActorTransformChanged(dtCore::Transformable& xformable);
+
       typedef dtUtil::HashMap< dtCore::UniqueId, dtCore::RefPtr<GameActorProxy> > GameActorMap;
       typedef dtUtil::HashMap< dtCore::UniqueId, dtCore::RefPtr<dtCore::BaseActorObject> > ActorMap;
 
@@ -153,22 +256,58 @@ namespace dtGame
       // the map code can modify game manager with some control.
       //bool mSendCreatesAndDeletes;
       //bool mAddActorsToScene;
-      std::set<TimerInfo> mSimulationTimers, mRealTimeTimers;
+      TimerWheel mSimulationTimers, mRealTimeTimers;
+      /// Reused by ProcessTimers.
+      std::vector<TimerWheel::ExpiredTimer> mExpiredTimers;
       MessageFactory mFactory;
 
-      typedef std::pair<dtCore::RefPtr<GameActorProxy>, std::string> ProxyInvokablePair;
-      typedef dtUtil::HashMultiMap<const MessageType*, ProxyInvokablePair > GlobalMessageListenerMap;
+      typedef std::vector<MessageListener> MessageListenerList;
+      typedef dtUtil::HashMap<const MessageType*, MessageListenerList> GlobalMessageListenerMap;
       GlobalMessageListenerMap mGlobalMessageListeners;
 
-      typedef std::multimap<dtCore::UniqueId, ProxyInvokablePair > ProxyInvokableMap;
-      typedef dtUtil::HashMap<const MessageType*,  ProxyInvokableMap> ActorMessageListenerMap;
+      typedef dtUtil::HashMap<dtCore::UniqueId, MessageListenerList> AboutActorListenerMap;
+      typedef dtUtil::HashMap<const MessageType*, AboutActorListenerMap> ActorMessageListenerMap;
       ActorMessageListenerMap mActorMessageListeners;
 
+      /// How many messages are being sent to actors right now.  Listeners are only erased when it's 0.
+      unsigned mListenerDispatchDepth;
+      /// True when a listener was unregistered while a message was being sent.
+      bool mListenersNeedCompacting;
+      /// Reused by InvokeForActorInvokables, one per nested message, so it doesn't allocate for every message.
+      /// A deque so adding one for a deeper message doesn't move the ones being used.
+      std::deque<std::vector<Invokable*> > mMessageHandlerScratch;
+
+      typedef dtUtil::SpatialGrid<dtCore::BaseActorObject*> ActorSpatialIndex;
+
+      struct ActorSpatialEntry
+      {
+         ActorSpatialIndex::Handle mHandle;
+         /// The drawable the callback was set on, so it can be cleared even if the actor's drawable was replaced.
+         dtCore::ObserverPtr<dtCore::Transformable> mTransformable;
+         /// The key in mSpatialActorsByDrawable, which is only compared, since the drawable may be gone.
+         const dtCore::Transformable* mDrawableKey;
+         /// True while the actor is in mMovedSpatialActors.
+         bool mMoved;
+      };
+
+      typedef dtUtil::HashMap<dtCore::BaseActorObject*, ActorSpatialEntry> ActorSpatialEntryMap;
+      typedef dtUtil::HashMap<const dtCore::Transformable*, dtCore::BaseActorObject*> SpatialActorsByDrawableMap;
+      /// Actor positions for the FindActorsIn* queries.  Moved actors are read again by the next query.
+      ActorSpatialIndex mActorSpatialIndex;
+      ActorSpatialEntryMap mActorSpatialEntries;
+      SpatialActorsByDrawableMap mSpatialActorsByDrawable;
+      /// The actors whose drawables moved since the index was last updated.  They may be removed since.
+      std::vector<dtCore::BaseActorObject*> mMovedSpatialActors;
+      /// Drawables may be moved from task threads, such as dead reckoning.
+      OpenThreads::Mutex mMovedSpatialActorsMutex;
+
       typedef std::list<dtCore::RefPtr<dtGame::GMComponent> > GMComponentContainer;
       GMComponentContainer mComponentList;
 
-      std::queue<dtCore::RefPtr<const Message> > mSendNetworkMessageQueue;
-      std::queue<dtCore::RefPtr<const Message> > mSendMessageQueue;
+      MessageQueue mSendNetworkMessageQueue;
+      MessageQueue mSendMessageQueue;
+      /// Guards both send queues.
+      OpenThreads::Mutex mMessageQueueMutex;
 
       dtCore::RefPtr<dtCore::Scene> mScene;
       dtCore::RefPtr<dtCore::ActorFactory> mLibMgr;
@@ -181,9 +320,16 @@ namespace dtGame
       dtUtil::Log* mLogger;
 
       dtCore::RefPtr<GMSettings> mGMSettings;
+      /// The pool sizes UpdateMessagePoolSizes last set.  They start at 0, which is what the factory starts with.
+      unsigned mTickMessagePoolSize;
+      unsigned mTimerMessagePoolSize;
+      unsigned mActorUpdateMessagePoolSize;
 
       dtCore::RefPtr<BatchData> mBatchData;
 
+      /// Idle tasks for StartConcurrentComponentDispatch, so messages don't allocate them.
+      ComponentDispatchTasks mFreeComponentDispatchTasks;
+
       bool mRemoveGameEventsOnMapChange;
       bool mShuttingDown;
    };
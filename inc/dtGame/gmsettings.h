@@ -65,6 +65,42 @@ namespace dtGame
        */
       DT_DECLARE_ACCESSOR(bool, EditorMode);
 
+      /**
+       * When this is on and the thread pool is initialized, each message goes first to the components that are
+       * GMComponent::ConcurrentSafe in parallel on the thread pool, and then to the other components on the
+       * main thread in priority order.  Off by default.
+       */
+      DT_DECLARE_ACCESSOR(bool, ConcurrentComponentDispatch);
+
+      /**
+       * The number of milliseconds per frame the map change may spend adding the actors of the new maps
+       * to the GM.  When this is greater than 0, the actors are added over as many frames as it takes and
+       * an INFO_MAP_CHANGE_LOAD_PROGRESS message is sent after each frame's slice.  0, the default,
+       * adds them all in one frame.
+       */
+      DT_DECLARE_ACCESSOR(float, MapLoadTimeSliceMS);
+
+      /**
+       * When this is on and the thread pool is initialized, a map change parses the new maps and creates their
+       * actors on the IO thread pool queue so the application keeps running while they open.  Off by default.
+       * Nothing else should open or close maps on the Project while the maps are opening.
+       */
+      DT_DECLARE_ACCESSOR(bool, OpenMapsInBackground);
+
+      /**
+       * The pool size the GM sets on its MessageFactory for each of the tick and system messages it sends every
+       * frame, so they don't churn the heap.  0 turns pooling off.  Defaults to 4.  The pool sizes in these settings
+       * are applied at the start of the GM's next system tick, and again whenever they change.
+       * @see MessageFactory::SetMessagePoolSize
+       */
+      DT_DECLARE_ACCESSOR(unsigned, TickMessagePoolSize);
+
+      /// The pool size for INFO_TIMER_ELAPSED messages.  0 turns pooling off.  Defaults to 64.  @see GetTickMessagePoolSize
+      DT_DECLARE_ACCESSOR(unsigned, TimerMessagePoolSize);
+
+      /// The pool size for INFO_ACTOR_UPDATED messages.  0 turns pooling off.  Defaults to 1024.  @see GetTickMessagePoolSize
+      DT_DECLARE_ACCESSOR(unsigned, ActorUpdateMessagePoolSize);
+
    private:
    };
 
@@ -38,6 +38,7 @@ namespace dtUtil
 namespace dtGame
 {
    class GameManager;
+   class MessageType;
 
    class GMStatistics
    {
@@ -163,6 +164,7 @@ namespace dtGame
          bool                 mDoStatsForDisplay;                                   ///< Do we compute stats for the sake of visual stat tracking?
 
          std::map<dtCore::UniqueId, dtCore::RefPtr<LogDebugInformation> > mDebugLoggerInformation; ///< hold onto all the information.
+         std::map<const MessageType*, std::pair<unsigned, unsigned> > mStatsLastMessagePoolCounts; ///< message pool hits and misses at the last print out.
          ////////////////////////////////////////////////
    };
 }
@@ -52,6 +52,8 @@ namespace dtGame
     *    Parameter: EstPlaybackTimeRemaining: Estimated time remaining for playback of cur file (playback only, double).\n
     *    Parameter: CurrentRecordDuration: Current length of the active recoring (record only, double).\n
     *    Parameter: NumRecordedMessages: Number of messages logged in current recording (record only, unsigned long).\n
+    *    Parameter: NumDroppedMessages: Number of messages the log stream dropped because it fell behind (record only, unsigned long).\n
+    *    Parameter: NumWriteStalls: Number of times recording waited for the log stream to catch up (record only, unsigned long).\n
     */
    class DT_GAME_EXPORT LogStatusMessage : public MapMessage
    {      
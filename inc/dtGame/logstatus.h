@@ -160,6 +160,32 @@ namespace dtGame
          mNumMessages = numMessages;
       }
 
+      /**
+       * Gets the number of messages the log stream threw away in the current recording because
+       * it could not write them as fast as they came in.
+       * @return The number of dropped messages.
+       */
+      unsigned long GetNumDroppedMessages() const { return mNumDroppedMessages; }
+
+      /**
+       * Sets the number of dropped messages. This should only be set by the server logger component itself.
+       * @param numDropped The number of dropped messages.
+       */
+      void SetNumDroppedMessages(unsigned long numDropped) { mNumDroppedMessages = numDropped; }
+
+      /**
+       * Gets the number of times recording a message had to wait for the log stream to catch up
+       * with writing in the current recording.
+       * @return The number of write stalls.
+       */
+      unsigned long GetNumWriteStalls() const { return mNumWriteStalls; }
+
+      /**
+       * Sets the number of write stalls. This should only be set by the server logger component itself.
+       * @param numStalls The number of write stalls.
+       */
+      void SetNumWriteStalls(unsigned long numStalls) { mNumWriteStalls = numStalls; }
+
       /**
        * Prints the log status to a stream.
        * @param stream Standard stream
@@ -175,6 +201,8 @@ namespace dtGame
       double mAutoRecordKeyframeInterval;
       double mCurrentRecordDuration;
       unsigned long mNumMessages;
+      unsigned long mNumDroppedMessages;
+      unsigned long mNumWriteStalls;
    };
 
 } // namespace dtGame
@@ -184,6 +184,18 @@ namespace dtGame
        */
       virtual void SetRecordDuration(double value);
 
+      /**
+       * Streams that write on another thread may throw away messages when they can't keep up.
+       * @return the number of messages dropped since the stream was created.  The default is 0.
+       */
+      virtual unsigned GetNumDroppedMessages() const;
+
+      /**
+       * Streams that write on another thread may make WriteMessage wait when they can't keep up.
+       * @return the number of times writing waited since the stream was created.  The default is 0.
+       */
+      virtual unsigned GetNumWriteStalls() const;
+
       /**
        * Gets a reference to this stream's MessageFactory.
        * @return The MessageFactory assigned to this stream.
@@ -26,10 +26,18 @@
 #include <osg/Referenced>
 
 #include <dtUtil/enumeration.h>
+#include <dtUtil/threadpool.h>
 #include <dtCore/observerptr.h>
+#include <dtCore/refptr.h>
+#include <dtCore/baseactorobject.h>
 #include <dtGame/export.h> 
 #include <dtGame/gamemanager.h>
 
+namespace dtCore
+{
+   class Map;
+}
+
 namespace dtGame
 {
    class MessageType;
@@ -54,6 +62,9 @@ namespace dtGame
                ///State for unloading the old map.
                static const MapChangeState UNLOAD;
 
+               ///State while the new maps are opened on the thread pool.
+               static const MapChangeState OPEN;
+
                ///State for loading the new map.
                static const MapChangeState LOAD;
 
@@ -94,6 +105,12 @@ namespace dtGame
           */
          void LoadSingleMapIntoGM(const std::string& mapName);
 
+         /// @return the number of actors added to the GM so far in the current map load.
+         unsigned GetNumActorsAdded() const { return mNextActorToAdd; }
+
+         /// @return the number of actors the current map load will add to the GM.
+         unsigned GetTotalActorsToAdd() const { return unsigned(mActorsToAdd.size()); }
+
          /// Closes a single map from the Project, remove the map's gameEvent
          /**
           This utility might be used either during a whole Change Map routine,
@@ -104,12 +121,40 @@ namespace dtGame
           */
          void CloseSingleMap(const std::string& mapName, bool deleteLibraries = true);
 
+         /**
+          * Stops opening the new maps on the thread pool and waits for the map being opened, closes the maps
+          * that were opened, and goes back to IDLE.  It does nothing if the maps aren't being opened.
+          */
+         void CancelOpenNewMaps();
+
 
       protected:         
 
+         virtual ~MapChangeStateData();
+
          // Opens all of the new maps in the new map vector. Returns true if successful
          bool OpenNewMaps();
 
+         // Starts opening the new maps on the thread pool.
+         void BeginOpenNewMaps();
+
+         // Checks if the maps opening on the thread pool are done, and if so, moves to the next state.
+         void ContinueOpenNewMaps();
+
+         // Adds the events of the map to the main game event manager and the environment actor to the GM.
+         void AddMapEventsAndEnvironment(dtCore::Map& map);
+
+         // Fills the vector with the actors in the map that should be added to the GM.
+         void GetActorsToAdd(dtCore::Map& map, dtCore::ActorRefPtrVector& toFill);
+
+         // Adds the next actors to the GM until the time slice runs out. Returns true when all are added.
+         bool AddActorsToGM(float timeSliceMS);
+
+         void AddActorToGM(dtCore::BaseActorObject& actor);
+
+         // Sends the closing messages for the new maps and goes back to idle.
+         void EndMapChange();
+
          // Closes all of the old maps in the old map vector.
          void CloseOldMaps();         
 
@@ -122,10 +167,17 @@ namespace dtGame
          const MapChangeState* mCurrentState;
          bool mAddBillboards;
 
+         dtCore::RefPtr<dtUtil::ThreadPoolTask> mOpenMapsTask;
+         // The actors from the new maps, which are added a slice at a time.
+         dtCore::ActorRefPtrVector mActorsToAdd;
+         unsigned mNextActorToAdd;
+         bool mLoadStarted;
+
          //disable copy constructor and operator = 
          MapChangeStateData(const MapChangeStateData&) {}
          MapChangeStateData& operator = (const MapChangeStateData&) { return *this; }
          void SendMapMessage(const MessageType& type, const NameVector& names);
+         void SendProgressMessage();
    };
 }
 
@@ -31,6 +31,7 @@
 #include <dtGame/export.h>
 #include <dtGame/message.h>
 #include <dtGame/machineinfo.h>
+#include <OpenThreads/Mutex>
 
 namespace dtGame
 {
@@ -141,6 +142,42 @@ namespace dtGame
           */
          dtCore::RefPtr<Message> CreateMessage(const MessageType& msgType) const;
 
+         /**
+          * Makes CreateMessage reuse messages of the given type rather than allocating a new one each time.
+          * The factory keeps up to maxPooled messages of the type, and hands one out again once nothing else
+          * references it, after resetting it to the values of a newly created message.
+          * Only pool types whose message class keeps all its data in message parameters, since the reset
+          * copies the parameters and header of a new message.
+          * @param maxPooled the most messages of the type to keep.  0, the default, turns pooling off and frees the pool.
+          */
+         void SetMessagePoolSize(const MessageType& type, unsigned maxPooled);
+
+         /// @return the most messages of the given type that are pooled, or 0 if the type isn't pooled.
+         unsigned GetMessagePoolSize(const MessageType& type) const;
+
+         /// How well the pool for one message type is working.
+         struct MessagePoolStatistics
+         {
+            MessagePoolStatistics()
+            : mMessageType(NULL)
+            , mMaxPooled(0U)
+            , mNumPooled(0U)
+            , mHits(0U)
+            , mMisses(0U)
+            {}
+
+            const MessageType* mMessageType;
+            unsigned mMaxPooled;
+            unsigned mNumPooled;
+            /// Messages CreateMessage reused.
+            unsigned mHits;
+            /// Messages CreateMessage had to allocate because all the pooled ones were in use.
+            unsigned mMisses;
+         };
+
+         /// Fills the vector with the statistics of each pooled message type.
+         void GetMessagePoolStatistics(std::vector<MessagePoolStatistics>& toFill) const;
+
          /**
           * Make a copy of a message.  It makes sure the right type is created and then
           * calls the message to copy the data.
@@ -153,10 +190,35 @@ namespace dtGame
       private:
          static void ThrowIdException(const MessageType& type);
 
+         struct MessagePool
+         {
+            MessagePool()
+            : mMaxPooled(0U)
+            , mNextToCheck(0U)
+            , mHits(0U)
+            , mMisses(0U)
+            {}
+
+            /// A newly created message the reused ones are reset from.
+            dtCore::RefPtr<Message> mDefaults;
+            std::vector<dtCore::RefPtr<Message> > mMessages;
+            unsigned mMaxPooled;
+            unsigned mNextToCheck;
+            unsigned mHits;
+            unsigned mMisses;
+         };
+
+         /// @return a message of the type from its pool, a new one, or NULL if the type isn't pooled.
+         dtCore::RefPtr<Message> CreatePooledMessage(const MessageType& msgType) const;
+
          std::string mName, mDescription;
 
          dtCore::RefPtr<const MachineInfo> mMachine;
 
+         // Messages are created on the network threads, too.
+         mutable OpenThreads::Mutex mPoolMutex;
+         mutable std::map<const MessageType*, MessagePool> mMessagePools;
+
          static dtCore::RefPtr<dtUtil::ObjectFactory<const MessageType*, Message> > mMessageFactory;
 
          static std::map<unsigned short, const MessageType*> mIdMap;
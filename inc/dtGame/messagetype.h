@@ -108,6 +108,8 @@ namespace dtGame
          // renamed to INFO_MAP_CHANGE_UNLOAD_BEGIN
          static const MessageType& INFO_MAP_UNLOAD_BEGIN;
          static const MessageType INFO_MAP_CHANGE_BEGIN;
+         /// Sent each frame while the actors of the new maps are added when the map load is time sliced.
+         static const MessageType INFO_MAP_CHANGE_LOAD_PROGRESS;
          static const MessageType INFO_MAP_CHANGE_END;
          // renamed to INFO_MAP_CHANGE_END
          static const MessageType& INFO_MAP_CHANGED;
@@ -139,6 +141,8 @@ namespace dtGame
          static const MessageType NETSERVER_REJECT_CONNECTION;
          static const MessageType NETSERVER_SYNC_CONTROL;
          static const MessageType NETSERVER_FRAME_SYNC;
+         static const MessageType NET_WIRE_FORMAT;
+         static const MessageType NET_ACTOR_UPDATE_ACK;
 
          //LOGGER MESSAGES
          static const MessageType LOG_REQ_CHANGESTATE_PLAYBACK;
@@ -74,6 +74,12 @@ namespace dtGame
        */
       virtual void ProcessMessage(const Message& message);
 
+      /**
+       * Only messages that are just written to the stream while recording are processed concurrently.
+       * The log requests, timers and playback change the GM, so they are handled in order with the other components.
+       */
+      virtual bool IsConcurrentSafeFor(const Message& message) const;
+
       /**
        * Gets the LogStream in use by this logger component.
        * @return A constant reference to the log stream interface.
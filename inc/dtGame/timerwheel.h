@@ -0,0 +1,185 @@
+/* -*-c++-*-
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ */
+
+#ifndef DELTA_TIMERWHEEL
+#define DELTA_TIMERWHEEL
+
+#include <dtGame/export.h>
+#include <dtCore/timer.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/hashmap.h>
+#include <dtUtil/refstring.h>
+
+#include <vector>
+
+namespace dtGame
+{
+   /**
+    * Holds the timers of the GameManager in a hierarchical timer wheel.
+    *
+    * Times are in microseconds, and are bucketed into ticks of the resolution passed to the constructor.
+    * The wheel has NUM_LEVELS levels of SLOTS_PER_LEVEL slots, each level covering SLOTS_PER_LEVEL times the
+    * span of the one below it.  A timer goes in the lowest level whose span reaches its tick, and moves down a
+    * level each time the wheel turns past the start of its slot, so adding, removing and expiring a timer are
+    * all constant time no matter how many timers there are.
+    *
+    * Timers are also linked per about actor so all the timers for an actor can be removed without looking
+    * at any others.  Timer names are interned so comparing them is a pointer compare.
+    */
+   class DT_GAME_EXPORT TimerWheel
+   {
+   public:
+      static const unsigned SLOT_BITS = 8;
+      static const unsigned SLOTS_PER_LEVEL = 1U << SLOT_BITS;
+      static const unsigned NUM_LEVELS = 4;
+      /// The default tick resolution, 1 millisecond.
+      static const dtCore::Timer_t DEFAULT_RESOLUTION = 1000;
+
+      /// Identifies a timer.  A handle stays invalid once its timer is removed or expires, even if its slot is reused.
+      struct Handle
+      {
+         Handle();
+         bool operator==(const Handle& other) const { return mIndex == other.mIndex && mGeneration == other.mGeneration; }
+         bool operator!=(const Handle& other) const { return !(*this == other); }
+
+         unsigned mIndex;
+         unsigned mGeneration;
+      };
+
+      /// A timer that elapsed in a call to Advance.
+      struct ExpiredTimer
+      {
+         dtUtil::RefString mName;
+         dtCore::UniqueId mAboutActor;
+         /// The time the timer was due.
+         dtCore::Timer_t mTime;
+      };
+
+      /// @param resolution the microseconds in a tick of the wheel.
+      explicit TimerWheel(dtCore::Timer_t resolution = DEFAULT_RESOLUTION);
+      ~TimerWheel();
+
+      /**
+       * Adds a timer.  Timers with the same name and about actor may exist at the same time.
+       * @param time the clock time the timer is due.
+       * @param repeat true to add interval to the time and keep the timer each time it expires.
+       * @return the handle to use to remove just this timer.
+       */
+      Handle Add(const dtUtil::RefString& name, const dtCore::UniqueId& aboutActor, dtCore::Timer_t time,
+               bool repeat = false, dtCore::Timer_t interval = 0);
+
+      /// Removes one timer.  @return false if the timer had already been removed or expired.
+      bool Remove(Handle handle);
+
+      /// @return true if the timer of the handle has not been removed or expired.
+      bool IsActive(Handle handle) const;
+
+      /**
+       * Removes timers by name.
+       * @param aboutActor the id of the about actor of the timers to remove, or NULL to remove the timers
+       *    with the name for every actor, which has to look at every timer.
+       * @return the number of timers removed.
+       */
+      unsigned Remove(const dtUtil::RefString& name, const dtCore::UniqueId* aboutActor);
+
+      /// Removes every timer about an actor.  @return the number of timers removed.
+      unsigned RemoveForActor(const dtCore::UniqueId& aboutActor);
+
+      /// Removes every timer.
+      void Clear();
+
+      unsigned GetNumTimers() const;
+
+      dtCore::Timer_t GetResolution() const;
+
+      /**
+       * Turns the wheel to a clock time and expires the timers due at or before it.
+       * Repeating timers are rescheduled, but expire at most once per call.
+       * If the clock time is earlier than the last call, nothing expires that isn't due at the new time.
+       * @param expiredOut filled, in time order, with the timers that expired.  It is cleared first.
+       */
+      void Advance(dtCore::Timer_t clockTime, std::vector<ExpiredTimer>& expiredOut);
+
+   private:
+      TimerWheel(const TimerWheel&);            ///< not implemented by design.
+      TimerWheel& operator=(const TimerWheel&); ///< not implemented by design.
+
+      static const unsigned NONE = ~0U;
+      /// The slot for timers further out than the top level.
+      static const unsigned OVERFLOW_SLOT = NUM_LEVELS * SLOTS_PER_LEVEL;
+
+      struct Timer
+      {
+         dtUtil::RefString mName;
+         dtCore::UniqueId mAboutActor;
+         dtCore::Timer_t mTime;
+         dtCore::Timer_t mInterval;
+         /// Breaks ties between timers due at the same time so they expire in the order they were added.
+         unsigned long long mSequence;
+         unsigned mGeneration;
+         unsigned mSlot;
+         unsigned mPrev, mNext;
+         unsigned mActorPrev, mActorNext;
+         bool mRepeat;
+         bool mInUse;
+      };
+
+      /// Orders timer indices by due time, then by the order they were added.
+      struct DueLess
+      {
+         DueLess(const std::vector<Timer>& timers) : mTimers(timers) {}
+         bool operator()(unsigned lhs, unsigned rhs) const;
+         const std::vector<Timer>& mTimers;
+      };
+
+      unsigned AllocateTimer();
+      void FreeTimer(unsigned index);
+      /// Unlinks a timer from its slot and actor and frees it.
+      void Erase(unsigned index);
+
+      /// Puts a timer in the slot for its time relative to the current tick.
+      void Schedule(unsigned index);
+      void LinkSlot(unsigned index, unsigned slot);
+      void UnlinkSlot(unsigned index);
+      void LinkActor(unsigned index);
+      void UnlinkActor(unsigned index);
+
+      /// Reschedules every timer in a slot.  Done when the wheel turns onto the start of the slot.
+      void Cascade(unsigned slot);
+      /// Moves the wheel to a tick and reschedules every timer.  Used when the clock jumps.
+      void Rebuild(unsigned long long tick);
+
+      dtCore::Timer_t mResolution;
+      unsigned long long mCurrentTick;
+      unsigned long long mNextSequence;
+      unsigned mNumTimers;
+
+      std::vector<Timer> mTimers;
+      unsigned mFreeHead;
+      std::vector<unsigned> mSlots;
+
+      typedef dtUtil::HashMap<dtCore::UniqueId, unsigned> ActorTimerMap;
+      ActorTimerMap mActorTimers;
+
+      std::vector<unsigned> mScratch;
+      std::vector<unsigned> mExpiredScratch;
+   };
+}
+
+#endif // DELTA_TIMERWHEEL
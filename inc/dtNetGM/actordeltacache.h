@@ -0,0 +1,159 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2005-2010, Alion Science and Technology.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_ACTORDELTACACHE
+#define DELTA_ACTORDELTACACHE
+
+#include <dtNetGM/export.h>
+#include <dtCore/uniqueid.h>
+#include <osg/Referenced>
+#include <OpenThreads/Mutex>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dtUtil
+{
+   class DataStream;
+}
+
+namespace dtCore
+{
+   class DataType;
+}
+
+namespace dtGame
+{
+   class ActorUpdateMessage;
+   class NetActorUpdateAckMessage;
+}
+
+namespace dtNetGM
+{
+   /**
+    * @class ActorDeltaCache
+    * @brief Delta compresses the actor update messages sent across one NetworkBridge.
+    *
+    * Both ends keep a baseline for each actor: the values of the last update the receiver acknowledged.
+    * An update is written as a bitmask of the baseline parameters it carries, a bitmask of the ones whose values
+    * changed, and only those values.  Parameters the baseline does not have yet are written in full.
+    * The receiver acknowledges the updates it decoded with a NET_ACTOR_UPDATE_ACK message, and only
+    * acknowledged updates become the baseline, so an update never refers to a baseline the receiver lacks.
+    *
+    * The receiver rebuilds exactly the message that was sent, with the same parameters and the same partial
+    * update flag, so the GameManager on the other side sees no difference.
+    *
+    * Updates are written on the dispatch and network threads and read on the network thread, so every
+    * method locks.
+    */
+   class DT_NETGM_EXPORT ActorDeltaCache : public osg::Referenced
+   {
+   public:
+      /// Unacknowledged updates an actor may have in flight before updates are sent without a baseline.
+      static const unsigned MAX_UNACKED_UPDATES = 32U;
+      /// Decoded updates kept per actor so a baseline that is acknowledged late can still be found.
+      static const unsigned MAX_RECEIVED_STATES = 64U;
+
+      ActorDeltaCache();
+
+      /**
+       * Writes the parameters of an update against the acknowledged baseline for its about actor.
+       * This replaces Message::ToDataStream for the update.
+       */
+      void WriteUpdate(const dtGame::ActorUpdateMessage& message, dtUtil::DataStream& stream);
+
+      /**
+       * Reads an update written by WriteUpdate on the other end.  This replaces Message::FromDataStream,
+       * so the about actor id must already be set on the message.
+       * @return false if the baseline the update refers to is unknown.  The sender is then asked to
+       *         drop its baseline for the actor, and the update should be discarded.
+       */
+      bool ReadUpdate(dtGame::ActorUpdateMessage& message, dtUtil::DataStream& stream);
+
+      /// Applies the acknowledgements sent back by the other end.
+      void ProcessAcks(const dtGame::NetActorUpdateAckMessage& ackMessage);
+
+      /**
+       * Moves the acknowledgements for the updates read since the last call into the message.
+       * @return false if there was nothing to acknowledge.
+       */
+      bool TakePendingAcks(dtGame::NetActorUpdateAckMessage& ackMessage);
+
+      /// Forgets the baselines for an actor in both directions, i.e. when it is deleted.
+      void RemoveActor(const dtCore::UniqueId& actorId);
+
+      /// Forgets all baselines, i.e. when the connection drops.
+      void Clear();
+
+      /// @return the number of updates written against an acknowledged baseline.
+      unsigned GetDeltaUpdatesWritten() const;
+
+      /// @return the number of updates written without a baseline.
+      unsigned GetFullUpdatesWritten() const;
+
+   protected:
+      virtual ~ActorDeltaCache();
+
+   private:
+      /// One update parameter of a baseline with its value as written by NamedParameter::ToDataStream.
+      struct ParameterSlot
+      {
+         dtCore::DataType* mType;
+         std::string mName;
+         bool mIsList;
+         std::string mValue;
+      };
+
+      /// The values of an actor after an update was applied, numbered by the sender.
+      struct ActorState
+      {
+         ActorState() : mSequence(0U) {}
+
+         unsigned mSequence;
+         std::string mHeader;
+         std::vector<ParameterSlot> mSlots;
+      };
+
+      struct SentActor
+      {
+         SentActor() : mNextSequence(1U) {}
+
+         unsigned mNextSequence;
+         ActorState mAcked;
+         std::deque<ActorState> mPending;
+      };
+
+      typedef std::deque<ActorState> ReceivedStates;
+
+      static int FindSlot(const ActorState& state, const std::string& name);
+
+      ActorDeltaCache(const ActorDeltaCache&);
+      ActorDeltaCache& operator=(const ActorDeltaCache&);
+
+      mutable OpenThreads::Mutex mMutex;
+      std::map<dtCore::UniqueId, SentActor> mSent;
+      std::map<dtCore::UniqueId, ReceivedStates> mReceived;
+      std::map<dtCore::UniqueId, unsigned> mPendingAcks;
+      unsigned mDeltaUpdatesWritten;
+      unsigned mFullUpdatesWritten;
+   };
+}
+
+#endif // DELTA_ACTORDELTACACHE
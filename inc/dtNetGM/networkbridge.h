@@ -28,6 +28,8 @@
 #endif
 
 #include <dtNetGM/export.h>
+#include <dtNetGM/wireformat.h>
+#include <dtNetGM/actordeltacache.h>
 #include <gnelib/ConnectionListener.h>
 #include <gnelib/Error.h>
 #include <dtCore/refptr.h>
@@ -101,6 +103,25 @@ namespace dtNetGM
        */
       void SetClientConnected(bool client = true) { mConnectedClient = client; };
 
+      /**
+       * Sets the wire format used for messages sent to this host.  The NetworkComponent sets
+       * this once the host has told it which formats it can read.
+       * @param The wire format
+       */
+      void SetWireFormat(const WireFormat& format) { mWireFormat = &format; };
+
+      /**
+       * Gets the wire format used for messages sent to this host.  It starts out as WireFormat::TEXT_IDS.
+       * @return the wire format
+       */
+      const WireFormat& GetWireFormat() const { return *mWireFormat; };
+
+      /**
+       * Gets the actor update baselines shared with this host.  They are only used with WireFormat::BINARY_DELTA.
+       * @return the delta cache
+       */
+      ActorDeltaCache& GetActorDeltaCache() const { return *mActorDeltaCache; };
+
       /**
        * Sends a DataStream across the network
        * @param The messagepacket
@@ -181,6 +202,8 @@ namespace dtNetGM
 
       GNE::Connection* mGneConnection; // Our GNE network connection for sending Packets
       bool mConnectedClient; // bool containing accepted client status
+      const WireFormat* mWireFormat; // format used for messages sent to this host
+      dtCore::RefPtr<ActorDeltaCache> mActorDeltaCache; // actor update baselines for this host
 
       unsigned int mLastStream;
       dtUtil::DataStream mDataStream;
@@ -33,6 +33,7 @@
 #include <osgDB/Serializer>
 
 #include <dtNetGM/export.h>
+#include <dtNetGM/wireformat.h>
 #include <string>
 #include <gnelib.h>
 #include <dtGame/gmcomponent.h>
@@ -56,6 +57,8 @@ namespace dtGame
    class NetServerRejectMessage;
    class ServerMessageRejected;
    class MachineInfoMessage;
+   class NetWireFormatMessage;
+   class NetActorUpdateAckMessage;
 }
 
 namespace dtNetGM
@@ -123,6 +126,20 @@ namespace dtNetGM
       DT_DECLARE_ACCESSOR(int, GameVersion);
       DT_DECLARE_ACCESSOR(std::string, GNELogFile);
 
+      /**
+       * If true, this component offers the binary wire format to each peer once the connection is accepted,
+       * and uses it for every peer that offers it back.  Defaults to true.  Turn it off to force the original
+       * text id format on all connections.
+       */
+      DT_DECLARE_ACCESSOR(bool, BinaryWireFormatEnabled);
+
+      /**
+       * If true, and the binary wire format is enabled, actor updates sent to peers that support it only carry
+       * the parameters that changed since the last update the peer acknowledged.  Defaults to true.
+       * @see ActorDeltaCache
+       */
+      DT_DECLARE_ACCESSOR(bool, ActorUpdateDeltasEnabled);
+
       /**
        * Called immediately after a component is added to the GM. Used to register
        * 'additional' Network Messages on the GameManager
@@ -206,6 +223,30 @@ namespace dtNetGM
        */
       virtual void ProcessNetServerRejectMessage(const dtGame::ServerMessageRejected& msg) { };
 
+      /**
+       * Processes a MessageType::NET_WIRE_FORMAT Message.  This is called on the network thread as soon
+       * as the message arrives, and the message is not passed on to the GameManager.  It sets the wire format
+       * used for messages sent to the host on the given bridge.
+       * @param msg The message
+       * @param networkBridge The bridge the message arrived on.
+       */
+      virtual void ProcessNetWireFormat(const dtGame::NetWireFormatMessage& msg, NetworkBridge& networkBridge);
+
+      /**
+       * Sends a MessageType::NET_WIRE_FORMAT message to the given host telling it the newest
+       * format this component can read.  Called once a connection has been accepted.
+       * @param destination The host to send it to.
+       */
+      void SendWireFormatMessage(const dtGame::MachineInfo& destination);
+
+      /**
+       * Processes a MessageType::NET_ACTOR_UPDATE_ACK Message.  Like NET_WIRE_FORMAT, it is handled on the network
+       * thread and not passed on to the GameManager.  It moves the actor update baselines for the given bridge forward.
+       * @param msg The message
+       * @param networkBridge The bridge the message arrived on.
+       */
+      virtual void ProcessNetActorUpdateAck(const dtGame::NetActorUpdateAckMessage& msg, NetworkBridge& networkBridge);
+
       /**
        * Sets the connection Parameters to be used by GNE
        * @param reliable The reliability of the connection
@@ -298,9 +339,34 @@ namespace dtNetGM
       virtual MessageActionCode& OnBeforeSendMessage(const dtGame::Message& message, std::string& rejectReason);
 
 
-      dtUtil::DataStream CreateDataStream(const dtGame::Message& message);
+      /**
+       * Encodes a message and its causing message, if any, for sending across the network.
+       * @param message The message to encode
+       * @param format The wire format the receiving host has agreed to.
+       * @param networkBridge The connection the stream will be sent on.  WireFormat::BINARY_DELTA needs it to
+       *                      encode actor updates against that connection's baselines.  Without it,
+       *                      the stream is written as WireFormat::BINARY instead.
+       */
+      dtUtil::DataStream CreateDataStream(const dtGame::Message& message, const WireFormat& format = WireFormat::TEXT_IDS,
+            NetworkBridge* networkBridge = NULL);
+
+      /// Same as CreateDataStream, but appends to an existing stream so callers may reuse the buffer.
+      void WriteToDataStream(const dtGame::Message& message, dtUtil::DataStream& stream, const WireFormat& format,
+            NetworkBridge* networkBridge = NULL);
+
+      /**
+       * Decodes a message written by CreateDataStream.  Every wire format is accepted, whatever format
+       * was agreed with the sender, so messages that were already in flight when the format changed
+       * are still read correctly.
+       */
       dtCore::RefPtr<dtGame::Message> CreateMessage(dtUtil::DataStream& dataStream, const NetworkBridge& networkBridge);
 
+      /**
+       * Reads the message type id at the start of an encoded message in any wire format,
+       * then rewinds the stream.
+       */
+      static unsigned short PeekMessageTypeId(dtUtil::DataStream& dataStream);
+
       /**
        * Is our GNE connection reliable
        * @return The reliability of the connection
@@ -474,6 +540,9 @@ namespace dtNetGM
       /// When the tick is over, we force a final send. The subclasses might also do work.  
       virtual void DoEndOfTick();
 
+      /// Sends each connection the acknowledgements for the delta compressed actor updates it sent since the last call.
+      void SendActorUpdateAcks();
+
       /// Starts the message send background task.
       void StartSendTask();
 
@@ -498,6 +567,9 @@ namespace dtNetGM
       MessageBufferType mMessageBufferWorking;
 
    private:
+      /// @return the newest wire format this component is willing to use given its properties.
+      const WireFormat& GetNewestEnabledWireFormat() const;
+
       // out buffer doesn't need a mutex because it is only accessed on the main thread
       // despite the fact that the outgoing messages are sent in a background thread.
       MessageBufferType mMessageBufferOut;
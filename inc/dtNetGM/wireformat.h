@@ -0,0 +1,117 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2005-2010, Alion Science and Technology.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_WIREFORMAT
+#define DELTA_WIREFORMAT
+
+#include <dtNetGM/export.h>
+#include <dtUtil/enumeration.h>
+
+namespace dtUtil
+{
+   class DataStream;
+}
+
+namespace dtCore
+{
+   class UniqueId;
+}
+
+namespace dtNetGM
+{
+   /**
+    * @class WireFormat
+    * @brief The encodings a dtGame::Message may use when it is sent across a NetworkBridge.
+    *
+    * The format is chosen per connection.  Every connection starts with TEXT_IDS, which every
+    * version of dtNetGM can read.  Once a connection is accepted, and if both sides announced a protocol
+    * version of at least 1 (see NETWORK_PROTOCOL_VERSION), both send a NET_WIRE_FORMAT message and each side
+    * switches to the newest format both ends understand.
+    */
+   class DT_NETGM_EXPORT WireFormat : public dtUtil::Enumeration
+   {
+      DECLARE_ENUM(WireFormat);
+   public:
+      /// The original format.  The header unique ids are sent as strings.
+      static const WireFormat TEXT_IDS;
+      /// The header starts with BINARY_STREAM_MARKER and the unique ids are sent as 16 raw bytes.
+      static const WireFormat BINARY;
+      /**
+       * Same as BINARY, but actor updates only carry the parameters that changed since the last
+       * update the peer acknowledged.  See ActorDeltaCache.
+       */
+      static const WireFormat BINARY_DELTA;
+
+      /**
+       * Message type id written in place of the real one at the start of a binary stream.
+       * An older peer that somehow receives one will just see an unsupported message type.
+       */
+      static const unsigned short BINARY_STREAM_MARKER = 0xFFFF;
+
+      /// @return the version number sent in a NET_WIRE_FORMAT message.  Higher is newer.
+      unsigned GetVersion() const { return mVersion; }
+
+      /// @return the newest format that is not newer than the given version.
+      static const WireFormat& GetByVersion(unsigned version);
+
+      /// @return the newest format this build can read and write.
+      static const WireFormat& GetNewest() { return BINARY_DELTA; }
+
+   private:
+      WireFormat(const std::string& name, unsigned version);
+      virtual ~WireFormat() {}
+
+      unsigned mVersion;
+   };
+
+   /// Number of bytes in the raw form of a uuid.
+   const unsigned UNIQUE_ID_BYTE_COUNT = 16U;
+
+   /**
+    * Converts a unique id to its 16 raw bytes.  Only the canonical, lower case, 36 character form
+    * is converted, because that is the only form UniqueIdFromBytes gives back unchanged.
+    * @return false if the id is not in that form.
+    */
+   DT_NETGM_EXPORT bool UniqueIdToBytes(const dtCore::UniqueId& id, unsigned char bytesOut[UNIQUE_ID_BYTE_COUNT]);
+
+   /// Converts 16 raw bytes back into the canonical, lower case form of a unique id.
+   DT_NETGM_EXPORT void UniqueIdFromBytes(const unsigned char bytes[UNIQUE_ID_BYTE_COUNT], dtCore::UniqueId& idOut);
+
+   /**
+    * Writes a unique id in the compact form used by the BINARY wire format.  Ids in the canonical,
+    * lower case, 36 character uuid form take one tag byte and 16 raw bytes.  Anything else, such as
+    * the temporary host name ids a NetworkBridge uses, is written as a tag byte and a string so
+    * it round trips exactly.
+    */
+   DT_NETGM_EXPORT void WriteBinaryUniqueId(dtUtil::DataStream& stream, const dtCore::UniqueId& id);
+
+   /**
+    * Reads a unique id written by WriteBinaryUniqueId.
+    * @return false if the tag byte is not known.
+    */
+   DT_NETGM_EXPORT bool ReadBinaryUniqueId(dtUtil::DataStream& stream, dtCore::UniqueId& idOut);
+
+   /**
+    * The dtNetGM connection protocol version, sent in the dtGame::NetConnectionMessage of a connection
+    * request or accept.  Version 1 added the NET_WIRE_FORMAT exchange.
+    */
+   const unsigned NETWORK_PROTOCOL_VERSION = 1U;
+}
+
+#endif // DELTA_WIREFORMAT
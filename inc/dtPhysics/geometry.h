@@ -63,8 +63,38 @@ namespace dtPhysics
 
       /**
        * Converts an node to a triangle mesh and caches it.  It will simply pull the date back from the cache if it is exists.
+       * If a disk cache directory is set and the source file the node was loaded from is given, the cooked data
+       * is also looked up in, and written to, the disk cache.
+       * @see SetDiskCacheDirectory
        */
-      static void GetOrCreateCachedDataForNode(dtCore::RefPtr<VertexData>& dataOut, const osg::Node* nodeToParse, const std::string& cacheKey, bool polytope);
+      static void GetOrCreateCachedDataForNode(dtCore::RefPtr<VertexData>& dataOut, const osg::Node* nodeToParse, const std::string& cacheKey, bool polytope,
+               const std::string& sourceFile = std::string());
+
+      /**
+       * Sets the directory used to keep cooked triangle data between runs.  It may be shared by several processes.
+       * Entries are named by a hash of the cache key and the size and modification time of the source file, so an entry
+       * for a changed source file is never found, and the directory may be deleted at any time.  Empty disables it, which is the default.
+       */
+      static void SetDiskCacheDirectory(const std::string& dir);
+      static const std::string& GetDiskCacheDirectory();
+
+      /**
+       * @return the disk cache file for the given key and source file, or empty if the disk cache is disabled or the source file does not exist.
+       */
+      static std::string GetDiskCacheFileName(const std::string& cacheKey, const std::string& sourceFile);
+
+      /**
+       * Fills the data from the disk cache entry for the key and source file.
+       * @return true if a valid entry was found and loaded.
+       */
+      static bool LoadFromDiskCache(VertexData& dataOut, const std::string& cacheKey, const std::string& sourceFile);
+
+      /**
+       * Writes the data to the disk cache for the key and source file.  The entry is written to a temporary
+       * file and renamed into place so other processes never read a partial entry.
+       * @return true if the entry was written.
+       */
+      static bool SaveToDiskCache(const VertexData& data, const std::string& cacheKey, const std::string& sourceFile);
 
       /**
        * creates a new cached vertex data object or returns an existing one based on the key
@@ -158,6 +158,9 @@ namespace dtUtil
          ///changes time to be system local time
          void SetToLocalTime();
 
+         ///changes time to be the system local time of a time_t read earlier, such as when a log message was queued.
+         void SetToLocalTime(time_t t);
+
          ///changes time to be GMT- or Greenwich Mean Time
          void SetToGMTTime();
 
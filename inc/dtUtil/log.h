@@ -271,6 +271,31 @@ namespace dtUtil
        */
       static void SetLogTimeProvider(LogTimeProvider* ltp);
 
+      /**
+       * Turns asynchronous logging on or off for all logs.  While it is on, LogMessage copies the message into a
+       * lock free queue owned by the calling thread and returns without taking a lock.  A single background thread
+       * empties the queues, converts the time and file name, and calls the file, console, and custom observers.
+       * Messages from one thread stay in order, but messages from different threads may be written in a slightly
+       * different order than they were logged.  Turning it off writes out everything queued.  Defaults to off.
+       */
+      static void SetAsynchronous(bool async);
+      static bool IsAsynchronous();
+
+      /**
+       * Sets how many bytes of messages may wait in the asynchronous queues.  A message that would go over the
+       * budget, or that finds its thread's queue full, is dropped and counted rather than making the caller wait.
+       * The background thread writes a warning with the number dropped.  Defaults to 4 MB.  On top of it, each
+       * thread's queue keeps up to a few hundred bytes per slot of memory it has used.
+       */
+      static void SetAsyncMemoryBudget(unsigned bytes);
+      static unsigned GetAsyncMemoryBudget();
+
+      /// @return the number of messages asynchronous logging has dropped.
+      static unsigned GetNumDroppedMessages();
+
+      /// Waits until every message queued before the call has been sent to the observers.
+      static void FlushAsynchronous();
+
       /**
         *  Add an observer that receives all log messages via callback.  The
         *  TO_OBSERVER OutputStreamOptions bit must be set in order for LogObservers
@@ -349,6 +374,7 @@ namespace dtUtil
       ~Log();
 
    private:
+      friend class LogManager;
       LogImpl* mImpl;
    };
 
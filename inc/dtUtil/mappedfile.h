@@ -0,0 +1,73 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_MAPPEDFILE
+#define DELTA_MAPPEDFILE
+
+#include <dtUtil/export.h>
+#include <osg/Referenced>
+#include <string>
+#include <cstddef>
+
+namespace dtUtil
+{
+   /**
+    * A read only view of a whole file mapped into memory.  The pages are read by the OS as they are touched,
+    * so opening a large file is cheap, and several processes mapping the same file share the memory.
+    */
+   class DT_UTIL_EXPORT MappedFile : public osg::Referenced
+   {
+   public:
+      MappedFile();
+
+      /**
+       * Maps the file, closing any file already open.
+       * @return false if the file could not be opened or mapped.  An empty file can't be mapped.
+       */
+      bool Open(const std::string& fileName);
+
+      /// Unmaps the file.  Any pointers into the data are invalid after this.
+      void Close();
+
+      bool IsOpen() const;
+
+      /// @return the start of the file data, or NULL if no file is open.
+      const char* GetData() const;
+
+      /// @return the size of the file in bytes.
+      size_t GetSize() const;
+
+      const std::string& GetFileName() const;
+
+   protected:
+      virtual ~MappedFile();
+
+   private:
+      MappedFile(const MappedFile&);               ///< not implemented by design.
+      MappedFile& operator=(const MappedFile&);    ///< not implemented by design.
+
+      std::string mFileName;
+      const char* mData;
+      size_t mSize;
+      // The file and mapping HANDLEs on windows, unused elsewhere.
+      void* mFileHandle;
+      void* mMappingHandle;
+   };
+}
+
+#endif // DELTA_MAPPEDFILE
@@ -0,0 +1,206 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_RECORDINGFILE
+#define DELTA_RECORDINGFILE
+
+#include <dtUtil/export.h>
+#include <dtUtil/datastream.h>
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace dtUtil
+{
+   class MappedFile;
+
+   /**
+    * The binary file format used by dtCore::Recorder for long, high rate recordings.
+    *
+    * Frames are appended to the file as they are recorded, grouped into chunks.  Each frame in a chunk is
+    * stored as the XOR of its bytes with the frame before it, with the runs of zeros that leaves
+    * run length encoded, so data that changes little from frame to frame takes little space.  Every chunk
+    * can be decoded on its own.  When the file is closed an index of the chunks and their time ranges
+    * is written at the end so a reader can seek to a time without reading the frames before it.
+    * A file that was never closed has no index, but its chunks can still be read.
+    */
+   namespace RecordingFileConstants
+   {
+      DT_UTIL_EXPORT extern const char MAGIC[8];
+      DT_UTIL_EXPORT extern const char INDEX_MAGIC[8];
+      DT_UTIL_EXPORT extern const unsigned VERSION;
+   }
+
+   /**
+    * Writes frames to a recording file as they are captured.  Only the chunk being filled is held in memory.
+    */
+   class DT_UTIL_EXPORT RecordingFileWriter : public osg::Referenced
+   {
+   public:
+      static const unsigned DEFAULT_FRAMES_PER_CHUNK = 256;
+
+      RecordingFileWriter();
+
+      /**
+       * Creates the file and writes the header, closing any file already open.
+       * @param numSources the number of sources that will write data into each frame.
+       * @return false if the file could not be created.
+       */
+      bool Open(const std::string& fileName, unsigned numSources);
+
+      /// Writes the chunk being filled, the chunk index and closes the file.
+      void Close();
+
+      bool IsOpen() const;
+
+      /**
+       * Appends a frame.  Frames must be written in time order.
+       * @param time the time code of the frame.
+       * @param data the frame data, which is opaque to the file.
+       */
+      void WriteFrame(double time, const char* data, unsigned size);
+
+      /// Writes the chunk being filled to the file.  This is done automatically when a chunk is full.
+      void Flush();
+
+      /// Sets the number of frames to put in each chunk.  Larger chunks compress slightly better but take longer to seek in.
+      void SetFramesPerChunk(unsigned framesPerChunk);
+      unsigned GetFramesPerChunk() const;
+
+      /// @return the number of frames written since the file was opened.
+      unsigned GetNumFrames() const;
+
+   protected:
+      virtual ~RecordingFileWriter();
+
+   private:
+      RecordingFileWriter(const RecordingFileWriter&);            ///< not implemented by design.
+      RecordingFileWriter& operator=(const RecordingFileWriter&); ///< not implemented by design.
+
+      struct ChunkInfo
+      {
+         unsigned long long mOffset;
+         double mFirstTime;
+         double mLastTime;
+         unsigned mNumFrames;
+      };
+
+      void WriteIndex();
+
+      std::ofstream mStream;
+      unsigned long long mFileOffset;
+      std::vector<ChunkInfo> mChunks;
+
+      dtUtil::DataStream mChunkData;
+      ChunkInfo mCurrentChunk;
+      unsigned mCurrentChunkRawSize;
+      std::vector<char> mPreviousFrame;
+      std::vector<char> mDelta;
+      std::vector<char> mEncoded;
+
+      unsigned mFramesPerChunk;
+      unsigned mNumFrames;
+   };
+
+   /**
+    * Reads a recording file.  The file is mapped rather than read, so only the chunks that are decoded are paged in.
+    */
+   class DT_UTIL_EXPORT RecordingFileReader : public osg::Referenced
+   {
+   public:
+      /// A frame in a decoded chunk.  The data is the bytes in the chunk data from mOffset to mOffset + mSize.
+      struct Frame
+      {
+         double mTime;
+         unsigned mOffset;
+         unsigned mSize;
+      };
+
+      /// A decoded chunk.  The buffers are reused when a chunk is decoded into the same instance.
+      struct Chunk
+      {
+         std::vector<char> mData;
+         std::vector<Frame> mFrames;
+      };
+
+      RecordingFileReader();
+
+      /// @return true if the file exists and starts with the recording file magic number.
+      static bool IsRecordingFile(const std::string& fileName);
+
+      /**
+       * Opens a file and reads its chunk index.  If the file has no index, it is rebuilt by
+       * walking the chunk headers.
+       * @return false if the file could not be opened or is not a recording file.
+       */
+      bool Open(const std::string& fileName);
+
+      void Close();
+
+      bool IsOpen() const;
+
+      unsigned GetNumSources() const;
+      unsigned GetNumChunks() const;
+      unsigned GetNumFrames() const;
+
+      /// @return the time of the first frame, or 0 if there are no frames.
+      double GetStartTime() const;
+      /// @return the time of the last frame, or 0 if there are no frames.
+      double GetEndTime() const;
+
+      /**
+       * Finds the chunk holding a time with a binary search of the index.
+       * @return the index of the last chunk starting at or before the time, or 0 if the time is before the first chunk.
+       */
+      unsigned FindChunk(double time) const;
+
+      /**
+       * Decodes a chunk.
+       * @return false if the chunk index is out of range or the chunk data is corrupt.
+       */
+      bool ReadChunk(unsigned chunkIndex, Chunk& chunkOut) const;
+
+   protected:
+      virtual ~RecordingFileReader();
+
+   private:
+      RecordingFileReader(const RecordingFileReader&);            ///< not implemented by design.
+      RecordingFileReader& operator=(const RecordingFileReader&); ///< not implemented by design.
+
+      struct ChunkInfo
+      {
+         unsigned long long mOffset;
+         double mFirstTime;
+         double mLastTime;
+         unsigned mNumFrames;
+      };
+
+      bool ReadIndex();
+      void ScanChunks();
+
+      osg::ref_ptr<MappedFile> mFile;
+      std::vector<ChunkInfo> mChunks;
+      unsigned mNumSources;
+      unsigned mNumFrames;
+   };
+}
+
+#endif // DELTA_RECORDINGFILE
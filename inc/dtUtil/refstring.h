@@ -13,10 +13,20 @@ namespace dtUtil
     * A string wrapper that will "intern" all of the strings so that strings with the same
     * value will point to the same memory.  The strings are always only accessible as const, but
     * a new string may be assigned to the refstring
+    *
+    * Since every value exists only once, comparing two RefStrings for equality just compares pointers, and
+    * the hash is computed once when a value is first interned.
     */
    class DT_UTIL_EXPORT RefString
    {
       public:
+         /// The shared value and its hash.
+         struct Entry
+         {
+            std::string mString;
+            size_t mHash;
+         };
+
          /// @return the number of shared strings.
          static size_t GetSharedStringCount();
 
@@ -25,23 +35,24 @@ namespace dtUtil
          RefString(const RefString& toCopy);
          ~RefString();
 
-         operator const std::string&() const { return *mString; }
+         operator const std::string&() const { return mEntry->mString; }
          dtUtil::RefString& operator=(const std::string& value);
          dtUtil::RefString& operator=(const dtUtil::RefString& value);
 
          RefString operator+(const std::string& string) const;
          RefString operator+(const RefString& refString) const;
          RefString operator+(const char* str) const;
-         const std::string* operator->() const { return mString; }
-         std::string::value_type operator[](int index) const { return (*mString)[index]; }
+         const std::string* operator->() const { return &mEntry->mString; }
+         std::string::value_type operator[](int index) const { return mEntry->mString[index]; }
 
-         const char* c_str() const { return mString->c_str(); }
+         const char* c_str() const { return mEntry->mString.c_str(); }
 
          bool operator<(const dtUtil::RefString& toCompare) const
-         { return this->Get() < toCompare.Get(); }
+         { return mEntry != toCompare.mEntry && this->Get() < toCompare.Get(); }
 
+         /// Interned strings are equal only if they are the same entry.
          bool operator==(const dtUtil::RefString& toCompare) const
-         { return this->Get() == toCompare.Get(); }
+         { return mEntry == toCompare.mEntry; }
 
          bool operator!=(const dtUtil::RefString& toCompare) const
          { return !(*this == toCompare); }
@@ -58,11 +69,14 @@ namespace dtUtil
          bool operator!=(const std::string& toCompare) const
          { return !(*this == toCompare); }
 
-         const std::string& Get() const { return *mString; }
+         const std::string& Get() const { return mEntry->mString; }
+
+         /// @return the hash of the string, which was computed when it was interned.
+         size_t GetHash() const { return mEntry->mHash; }
       private:
-         const std::string* mString;
+         const Entry* mEntry;
 
-         void Intern(const std::string& value);
+         void Intern(const char* value, size_t length);
    };
 
    inline bool operator==(const std::string& s1, const RefString& s2)
@@ -86,14 +100,14 @@ namespace dtUtil
    struct hash<const dtUtil::RefString>
    {
      size_t operator()(const dtUtil::RefString& string) const
-     { return dtUtil::__hash_string(string.c_str()); }
+     { return string.GetHash(); }
    };
 
    template<>
    struct hash<dtUtil::RefString>
    {
      size_t operator()(const dtUtil::RefString& string) const
-     { return dtUtil::__hash_string(string.c_str()); }
+     { return string.GetHash(); }
    };
 }
 
@@ -0,0 +1,517 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2005-2010, Alion Science and Technology.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef DELTA_SPATIALGRID
+#define DELTA_SPATIALGRID
+
+#include <dtUtil/hashmap.h>
+#include <osg/Vec3>
+#include <osg/BoundingBox>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace dtUtil
+{
+   /**
+    * @class SpatialGrid
+    * @brief A hashed uniform grid for radius, box and nearest neighbor queries over points that move.
+    *
+    * Space is divided into cubic cells and only the cells that hold an item are stored, keyed by their packed
+    * cell coordinates in a hash map.  Moving an item within its cell is a single store and moving it to another
+    * cell is a swap remove and a push, so the grid can be kept up to date every frame.  The KDTree has faster
+    * queries on static data, but it has to be rebuilt when the points move.
+    *
+    * The cell size should be about the radius of the common queries.  Much smaller cells make large queries
+    * visit many empty cells, much larger ones make every query test many items.
+    *
+    * Cell coordinates are clamped to 21 bits per axis, so items further than about a million cells from the
+    * origin share the boundary cells.  They are still found, but queries there get slower.
+    *
+    * The grid is not thread safe.
+    */
+   template <typename T>
+   class SpatialGrid
+   {
+   public:
+      typedef unsigned Handle;
+
+      static const Handle INVALID_HANDLE = ~0U;
+
+      explicit SpatialGrid(float cellSize = 16.0f)
+      : mCellSize(cellSize)
+      , mInvCellSize(1.0f / cellSize)
+      , mSize(0U)
+      {
+         ResetBounds();
+      }
+
+      /**
+       * Changes the cell size and re-buckets every item.
+       */
+      void SetCellSize(float cellSize)
+      {
+         if (cellSize <= 0.0f || cellSize == mCellSize)
+         {
+            return;
+         }
+
+         mCellSize = cellSize;
+         mInvCellSize = 1.0f / cellSize;
+
+         mCells.clear();
+         ResetBounds();
+         for (Handle h = 0; h < Handle(mEntries.size()); ++h)
+         {
+            Entry& entry = mEntries[h];
+            if (entry.mInUse)
+            {
+               AddToCell(h, CellOf(entry.mPosition));
+            }
+         }
+      }
+
+      float GetCellSize() const { return mCellSize; }
+
+      /// @return the number of items in the grid.
+      size_t GetSize() const { return mSize; }
+
+      bool IsEmpty() const { return mSize == 0U; }
+
+      /**
+       * Adds an item at a position.
+       * @return the handle used to move, remove or read the item.  Handles of removed items are reused.
+       */
+      Handle Insert(const T& item, const osg::Vec3& position)
+      {
+         Handle h;
+         if (!mFreeHandles.empty())
+         {
+            h = mFreeHandles.back();
+            mFreeHandles.pop_back();
+         }
+         else
+         {
+            h = Handle(mEntries.size());
+            mEntries.push_back(Entry());
+         }
+
+         Entry& entry = mEntries[h];
+         entry.mItem = item;
+         entry.mPosition = position;
+         entry.mInUse = true;
+         AddToCell(h, CellOf(position));
+         ++mSize;
+         return h;
+      }
+
+      /**
+       * Changes the position of an item.
+       */
+      void Move(Handle h, const osg::Vec3& position)
+      {
+         Entry& entry = mEntries[h];
+         entry.mPosition = position;
+         CellKey newCell = CellOf(position);
+         if (newCell != entry.mCell)
+         {
+            RemoveFromCell(h);
+            AddToCell(h, newCell);
+         }
+      }
+
+      /**
+       * Removes an item.  The handle is invalid afterwards.
+       */
+      void Remove(Handle h)
+      {
+         Entry& entry = mEntries[h];
+         if (!entry.mInUse)
+         {
+            return;
+         }
+
+         RemoveFromCell(h);
+         entry.mInUse = false;
+         entry.mItem = T();
+         mFreeHandles.push_back(h);
+         --mSize;
+      }
+
+      void Clear()
+      {
+         mCells.clear();
+         mEntries.clear();
+         mFreeHandles.clear();
+         mSize = 0U;
+         ResetBounds();
+      }
+
+      const T& Get(Handle h) const { return mEntries[h].mItem; }
+
+      const osg::Vec3& GetPosition(Handle h) const { return mEntries[h].mPosition; }
+
+      /**
+       * Adds the items within a radius of a point to the result.  The result is not cleared or sorted.
+       */
+      void FindInRadius(const osg::Vec3& center, float radius, std::vector<T>& result) const
+      {
+         if (radius < 0.0f)
+         {
+            return;
+         }
+
+         osg::Vec3 extent(radius, radius, radius);
+         VisitBox(center - extent, center + extent, RadiusTest(center, radius * radius), result);
+      }
+
+      /**
+       * Adds the items inside a box to the result, including the ones on its faces.
+       * The result is not cleared or sorted.
+       */
+      void FindInBox(const osg::BoundingBox& box, std::vector<T>& result) const
+      {
+         if (!box.valid())
+         {
+            return;
+         }
+
+         VisitBox(box._min, box._max, BoxTest(box), result);
+      }
+
+      /**
+       * Adds the nearest items to a point to the result, nearest first.
+       * @param count the number of items to find.  Fewer are added if there are not enough within maxDistance.
+       * @param maxDistance items further away than this are ignored.
+       */
+      void FindNearest(const osg::Vec3& center, unsigned count, std::vector<T>& result,
+               float maxDistance = FLT_MAX) const
+      {
+         if (count == 0U || mSize == 0U || maxDistance < 0.0f)
+         {
+            return;
+         }
+
+         float maxDist2 = maxDistance < std::sqrt(FLT_MAX) ? maxDistance * maxDistance : FLT_MAX;
+
+         // A max heap on distance holding the best candidates found so far.
+         std::vector<Candidate> best;
+         best.reserve(std::min<size_t>(count, mSize) + 1U);
+
+         int cx, cy, cz;
+         CellCoords(center, cx, cy, cz);
+
+         // Items may be far away from the query, so start at the first shell that touches an occupied cell.
+         int startRing = std::max(0, std::max(DistanceToRange(cx, mMinX, mMaxX),
+                  std::max(DistanceToRange(cy, mMinY, mMaxY), DistanceToRange(cz, mMinZ, mMaxZ))));
+
+         for (int ring = startRing; ; ++ring)
+         {
+            // The query point may lie anywhere in its cell, so everything outside the shells visited so far
+            // is at least one cell less than the shell distance away.
+            float reached = float(std::max(ring - 1, 0)) * mCellSize;
+            if (best.size() == count && best.front().first <= reached * reached)
+            {
+               break;
+            }
+            if (reached * reached > maxDist2)
+            {
+               break;
+            }
+            if (cx - ring < mMinX && cx + ring > mMaxX &&
+                cy - ring < mMinY && cy + ring > mMaxY &&
+                cz - ring < mMinZ && cz + ring > mMaxZ)
+            {
+               break;
+            }
+
+            // Once a shell has more cells than are occupied, testing every item is cheaper than walking it.
+            size_t ringCells = ring == 0 ? 1U : size_t(24 * ring * ring + 2);
+            if (ringCells > mCells.size())
+            {
+               best.clear();
+               for (Handle h = 0; h < Handle(mEntries.size()); ++h)
+               {
+                  if (mEntries[h].mInUse)
+                  {
+                     Consider(h, center, count, maxDist2, best);
+                  }
+               }
+               break;
+            }
+
+            for (int dx = -ring; dx <= ring; ++dx)
+            {
+               for (int dy = -ring; dy <= ring; ++dy)
+               {
+                  bool onFace = dx == -ring || dx == ring || dy == -ring || dy == ring;
+                  int dzStep = onFace || ring == 0 ? 1 : 2 * ring;
+                  for (int dz = -ring; dz <= ring; dz += dzStep)
+                  {
+                     typename CellMap::const_iterator cell = mCells.find(PackCell(cx + dx, cy + dy, cz + dz));
+                     if (cell == mCells.end())
+                     {
+                        continue;
+                     }
+
+                     const Cell& handles = cell->second;
+                     for (size_t i = 0; i < handles.size(); ++i)
+                     {
+                        Consider(handles[i], center, count, maxDist2, best);
+                     }
+                  }
+               }
+            }
+         }
+
+         std::sort_heap(best.begin(), best.end());
+         for (size_t i = 0; i < best.size(); ++i)
+         {
+            result.push_back(mEntries[best[i].second].mItem);
+         }
+      }
+
+   private:
+      typedef unsigned long long CellKey;
+      typedef std::vector<Handle> Cell;
+      typedef std::pair<float, Handle> Candidate;
+
+      static const int CELL_BITS = 21;
+      static const int CELL_OFFSET = 1 << (CELL_BITS - 1);
+      static const int CELL_MIN = -CELL_OFFSET;
+      static const int CELL_MAX = CELL_OFFSET - 1;
+
+      struct CellKeyHash
+      {
+         size_t operator()(CellKey key) const
+         {
+            // Mix the bits so neighboring cells do not land in neighboring buckets.
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdULL;
+            key ^= key >> 33;
+            return size_t(key);
+         }
+      };
+
+      typedef dtUtil::HashMap<CellKey, Cell, CellKeyHash> CellMap;
+
+      struct Entry
+      {
+         Entry() : mItem(), mCell(0U), mSlot(0U), mInUse(false) {}
+
+         T mItem;
+         osg::Vec3 mPosition;
+         CellKey mCell;
+         unsigned mSlot;
+         bool mInUse;
+      };
+
+      struct RadiusTest
+      {
+         RadiusTest(const osg::Vec3& center, float radius2) : mCenter(center), mRadius2(radius2) {}
+         bool operator()(const osg::Vec3& pos) const { return (pos - mCenter).length2() <= mRadius2; }
+         osg::Vec3 mCenter;
+         float mRadius2;
+      };
+
+      struct BoxTest
+      {
+         BoxTest(const osg::BoundingBox& box) : mBox(box) {}
+         bool operator()(const osg::Vec3& pos) const { return mBox.contains(pos); }
+         osg::BoundingBox mBox;
+      };
+
+      static int ClampCell(float coord)
+      {
+         float c = std::floor(coord);
+         if (!(c >= float(CELL_MIN)))
+         {
+            return CELL_MIN;
+         }
+         if (c > float(CELL_MAX))
+         {
+            return CELL_MAX;
+         }
+         return int(c);
+      }
+
+      static CellKey PackCell(int x, int y, int z)
+      {
+         const CellKey mask = (CellKey(1) << CELL_BITS) - 1U;
+         return ((CellKey(x + CELL_OFFSET) & mask) << (2 * CELL_BITS))
+              | ((CellKey(y + CELL_OFFSET) & mask) << CELL_BITS)
+              | (CellKey(z + CELL_OFFSET) & mask);
+      }
+
+      static int DistanceToRange(int c, int minC, int maxC)
+      {
+         if (c < minC) return minC - c;
+         if (c > maxC) return c - maxC;
+         return 0;
+      }
+
+      void CellCoords(const osg::Vec3& pos, int& x, int& y, int& z) const
+      {
+         x = ClampCell(pos.x() * mInvCellSize);
+         y = ClampCell(pos.y() * mInvCellSize);
+         z = ClampCell(pos.z() * mInvCellSize);
+      }
+
+      CellKey CellOf(const osg::Vec3& pos) const
+      {
+         int x, y, z;
+         CellCoords(pos, x, y, z);
+         return PackCell(x, y, z);
+      }
+
+      void ResetBounds()
+      {
+         mMinX = mMinY = mMinZ = CELL_MAX;
+         mMaxX = mMaxY = mMaxZ = CELL_MIN;
+      }
+
+      void AddToCell(Handle h, CellKey key)
+      {
+         Entry& entry = mEntries[h];
+         Cell& cell = mCells[key];
+         entry.mCell = key;
+         entry.mSlot = unsigned(cell.size());
+         cell.push_back(h);
+
+         // The bounds only grow until the grid is cleared.  They are only used to stop searches early.
+         int x, y, z;
+         CellCoords(entry.mPosition, x, y, z);
+         mMinX = std::min(mMinX, x); mMaxX = std::max(mMaxX, x);
+         mMinY = std::min(mMinY, y); mMaxY = std::max(mMaxY, y);
+         mMinZ = std::min(mMinZ, z); mMaxZ = std::max(mMaxZ, z);
+      }
+
+      void RemoveFromCell(Handle h)
+      {
+         Entry& entry = mEntries[h];
+         typename CellMap::iterator cellIter = mCells.find(entry.mCell);
+         Cell& cell = cellIter->second;
+
+         Handle last = cell.back();
+         cell[entry.mSlot] = last;
+         mEntries[last].mSlot = entry.mSlot;
+         cell.pop_back();
+
+         if (cell.empty())
+         {
+            mCells.erase(cellIter);
+         }
+      }
+
+      void Consider(Handle h, const osg::Vec3& center, unsigned count, float maxDist2,
+               std::vector<Candidate>& best) const
+      {
+         float dist2 = (mEntries[h].mPosition - center).length2();
+         if (dist2 > maxDist2)
+         {
+            return;
+         }
+
+         if (best.size() < count)
+         {
+            best.push_back(Candidate(dist2, h));
+            std::push_heap(best.begin(), best.end());
+         }
+         else if (dist2 < best.front().first)
+         {
+            std::pop_heap(best.begin(), best.end());
+            best.back() = Candidate(dist2, h);
+            std::push_heap(best.begin(), best.end());
+         }
+      }
+
+      template <typename Test>
+      void VisitBox(const osg::Vec3& minPos, const osg::Vec3& maxPos, const Test& test,
+               std::vector<T>& result) const
+      {
+         if (mSize == 0U)
+         {
+            return;
+         }
+
+         int minX, minY, minZ, maxX, maxY, maxZ;
+         CellCoords(minPos, minX, minY, minZ);
+         CellCoords(maxPos, maxX, maxY, maxZ);
+         minX = std::max(minX, mMinX); maxX = std::min(maxX, mMaxX);
+         minY = std::max(minY, mMinY); maxY = std::min(maxY, mMaxY);
+         minZ = std::max(minZ, mMinZ); maxZ = std::min(maxZ, mMaxZ);
+         if (minX > maxX || minY > maxY || minZ > maxZ)
+         {
+            return;
+         }
+
+         double boxCells = double(maxX - minX + 1) * double(maxY - minY + 1) * double(maxZ - minZ + 1);
+         if (boxCells > double(mCells.size()))
+         {
+            // The box covers more cells than are occupied, so walk the occupied ones instead.
+            typename CellMap::const_iterator i, iend = mCells.end();
+            for (i = mCells.begin(); i != iend; ++i)
+            {
+               VisitCell(i->second, test, result);
+            }
+            return;
+         }
+
+         for (int x = minX; x <= maxX; ++x)
+         {
+            for (int y = minY; y <= maxY; ++y)
+            {
+               for (int z = minZ; z <= maxZ; ++z)
+               {
+                  typename CellMap::const_iterator cell = mCells.find(PackCell(x, y, z));
+                  if (cell != mCells.end())
+                  {
+                     VisitCell(cell->second, test, result);
+                  }
+               }
+            }
+         }
+      }
+
+      template <typename Test>
+      void VisitCell(const Cell& cell, const Test& test, std::vector<T>& result) const
+      {
+         for (size_t i = 0; i < cell.size(); ++i)
+         {
+            const Entry& entry = mEntries[cell[i]];
+            if (test(entry.mPosition))
+            {
+               result.push_back(entry.mItem);
+            }
+         }
+      }
+
+      float mCellSize;
+      float mInvCellSize;
+      size_t mSize;
+      CellMap mCells;
+      std::vector<Entry> mEntries;
+      std::vector<Handle> mFreeHandles;
+      int mMinX, mMinY, mMinZ, mMaxX, mMaxY, mMaxZ;
+   };
+}
+
+#endif // DELTA_SPATIALGRID
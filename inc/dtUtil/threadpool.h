@@ -27,9 +27,12 @@
 
 #include <osg/Referenced>
 #include <OpenThreads/Block>
+#include <OpenThreads/Mutex>
+#include <dtCore/refptr.h>
 #include <dtUtil/export.h>
 #include <dtUtil/getsetmacros.h>
 #include <dtUtil/refstring.h>
+#include <vector>
 
 namespace dtUtil
 {
@@ -55,10 +58,53 @@ namespace dtUtil
       /// Will block the current thread until this task completes.
       bool WaitUntilComplete(int timeoutMS = -1);
 
+      /**
+       * Makes this task a continuation of another one.  Call this before adding either task to the pool.
+       * When this task is added, it is held back until every task it depends on has run, and then it is put
+       * in the queue it was added to by whichever worker finished the last of them.  That way a staged
+       * pipeline can run start to finish without returning to the main thread in between.
+       * A task that is set to Keep only releases its continuations when it runs for the last time.
+       * A dependency on a task that is never added to the pool will never be satisfied.
+       * A dependency on a task that already ran is satisfied right away, so call ResetCompletion on a reused
+       * prerequisite before adding dependencies on its next run.
+       */
+      void AddDependency(ThreadPoolTask& prerequisite);
+
+      /**
+       * Marks a task that already ran as not run, so tasks that depend on it wait for its next run.
+       * Adding the task to the pool does this too, but dependencies are normally added before that.
+       */
+      void ResetCompletion();
+
+      /// @return the number of tasks this task is still waiting on.
+      unsigned GetNumPendingDependencies() const;
+
    protected:
       virtual ~ThreadPoolTask();
    private:
+      friend class ThreadPool;
+      friend class TaskQueue;
+
+      /**
+       * Called by the threadpool when the task is added.
+       * @return true if the task has to wait for its dependencies, in which case it will be queued on the given
+       *         queue once they complete.
+       */
+      bool DeferUntilDependenciesComplete(int queue);
+
+      /// Called by the threadpool after the task ran for the last time.  Queues the continuations that are ready.
+      void Complete();
+
+      /// @return the queue to add this task to if this was the last dependency it was waiting on, or -1.
+      int ReleaseDependency();
+
       OpenThreads::Block mBlockUntilComplete;
+
+      mutable OpenThreads::Mutex mDependencyMutex;
+      std::vector<dtCore::RefPtr<ThreadPoolTask> > mContinuations;
+      unsigned mPendingDependencies;
+      int mDeferredQueue;
+      bool mComplete;
    };
 
    /**
@@ -98,6 +144,12 @@ namespace dtUtil
     * pool on a single core box or request 0 threads, then there will still be a  thread just for doing background tasks
     * so that things like IO specific tasks will still run in the background and not block the main thread.
     * </p>
+    * <p>
+    * Each worker thread has its own task deque with its own lock.  Tasks added from a worker thread, such as
+    * continuations or tasks that split up their own work, go into that worker's deque, and tasks added from other
+    * threads are spread across all of them.  A worker with nothing to do steals from the others, so the
+    * threads only contend when they are out of work.
+    * </p>
     */
    class DT_UTIL_EXPORT ThreadPool
    {
@@ -122,7 +174,8 @@ namespace dtUtil
 
 
       /**
-       * Adds a task for the worker threads to execute.
+       * Adds a task for the worker threads to execute.  If the task has dependencies that haven't run yet,
+       * it is queued when the last of them completes.  See ThreadPoolTask::AddDependency.
        * @param task the task to execute
        * @param queue the queue to put the task in.
        */
@@ -131,7 +184,8 @@ namespace dtUtil
       /**
        * After adding tasks to the pool, you then call Execute tasks and it will run the set of tasks
        * on both this thread and the additional worker threads until they all complete.
-       * Only IMMEDIATE tasks are affected by this method.
+       * Only IMMEDIATE tasks are affected by this method.  IMMEDIATE continuations of IMMEDIATE tasks
+       * are queued before the task they depend on counts as done, so this waits for them, too.
        */
       static void ExecuteTasks();
 
@@ -140,6 +194,12 @@ namespace dtUtil
        */
       static unsigned GetNumImmediateWorkerThreads();
 
+      /**
+       * @return true if worker threads run IMMEDIATE tasks on their own.  If the pool was initialized with 0 threads,
+       *         IMMEDIATE tasks only run inside ExecuteTasks, so calling WaitUntilComplete on one would block forever.
+       */
+      static bool HasImmediateWorkerThreads();
+
    private:
       // Hide all constructors and destructors
       ThreadPool();
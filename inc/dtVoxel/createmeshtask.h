@@ -34,6 +34,8 @@
 #include <openvdb/openvdb.h>
 #include <OpenThreads/Atomic>
 
+#include <vector>
+
 namespace dtVoxel
 {
     
@@ -51,7 +53,7 @@ namespace dtVoxel
 
       osg::Geode* TakeGeometry();
 
-      void SetMode();
+      void SetMode(GenerateMode mode);
       GenerateMode GetMode() const;
       
       bool IsDone() const;
@@ -64,20 +66,44 @@ namespace dtVoxel
       void UpdateWithBounds(const osg::BoundingBox& bb);
 
       DT_DECLARE_ACCESSOR_INLINE(bool, SkipBackFaces);
+      /// Keeps the grid samples between runs so a run after UpdateWithBounds only samples the bounds again.
       DT_DECLARE_ACCESSOR_INLINE(bool, CacheTriangleData);
       DT_DECLARE_ACCESSOR_INLINE(int, NumThreads);
 
    private:
-            
-      int ComputeIndex(int i, int j, int k) const;
-      
+      typedef openvdb::tools::GridSampler<openvdb::FloatGrid::ConstAccessor, openvdb::tools::PointSampler> SamplerType;
+
+      /**
+       * A slab of the cell layers along z.  The slabs are sampled and meshed in parallel and each one writes its
+       * vertices and indices into its own range of the preallocated output, found by a prefix sum over the counts.
+       * A slab covers the sample layers mBeginZ to mEndZ, owns the cell edges that start on them and meshes the
+       * cells whose lowest corner is on them.
+       */
+      struct MeshChunk
+      {
+         int mBeginZ;
+         int mEndZ;
+         unsigned mNumVerts;
+         unsigned mNumIndices;
+         unsigned mFirstVert;
+         unsigned mFirstIndex;
+         unsigned mIndicesWritten;
+      };
+
+      int ComputeSampleIndex(int i, int j, int k) const;
+
       void RunMultiThreads();
       void RunSingleThreaded();
 
-      int SampleSingleCell(int i, int j, int k, openvdb::tools::GridSampler<openvdb::FloatGrid::ConstAccessor, openvdb::tools::PointSampler>& sampler, TRIANGLE* triangles);
-      double SampleCoord(double x, double y, double z, openvdb::tools::GridSampler<openvdb::FloatGrid::ConstAccessor, openvdb::tools::PointSampler>& fastSampler);
+      /// Samples, counts and writes the mesh one slab at a time, on the tbb threads if parallel is true.
+      void BuildMesh(bool parallel);
 
-      void CopyTriangleData(const TRIANGLE* triData, TRIANGLE* toFill, int numTris);
+      void SampleChunk(const MeshChunk& chunk, bool onlyDirty);
+      void CountChunk(MeshChunk& chunk);
+      void WriteChunkVertices(const MeshChunk& chunk, osg::Vec3* verts);
+      void WriteChunkIndices(MeshChunk& chunk, const osg::Vec3* verts, GLuint* indices);
+
+      double SampleCoord(double x, double y, double z, SamplerType& fastSampler);
 
       volatile bool mIsDone;
            
@@ -94,16 +120,13 @@ namespace dtVoxel
       osg::BoundingBox mDirtyBounds;
       dtCore::RefPtr<osg::Geode> mMesh;
       openvdb::FloatGrid::Ptr mGrid;
-      
-      typedef struct {
-         TRIANGLE mTris[5];
-      } TRI_GROUP;
 
-      typedef std::vector<TRI_GROUP> TriangleMap;
-      typedef std::vector<char> TriangleOccupancyArray;
-      
-      TriangleMap mCacheData;
-      TriangleOccupancyArray mOccupancy;
+      std::vector<MeshChunk> mChunks;
+      /// The grid sampled at the cell corners, resolution + 1 per axis, x fastest.  Kept between runs if
+      /// CacheTriangleData is on so only the samples in the dirty bounds are read again.
+      std::vector<float> mSamples;
+      /// The vertex on each cell edge the surface crosses, three edges (+x, +y, +z) per sample.
+      std::vector<GLuint> mEdgeVertices;
    };
    
 } /* namespace dtVoxel */
@@ -49,6 +49,33 @@ namespace dtVoxel
    */
    DT_VOXEL_EXPORT int PolygonizeCube(GRIDCELL g, float iso, TRIANGLE *tri, osg::Vec3* vertArray);
 
+   /*-------------------------------------------------------------------------
+   The cube index PolygonizeCube uses for a cell, one bit per corner whose
+   value is below the isolevel.  The corners are numbered as in GRIDCELL.
+   */
+   inline int ComputeCubeIndex(const float* val, float iso)
+   {
+      int cubeIndex = 0;
+      for (int i = 0; i < 8; ++i)
+      {
+         cubeIndex |= int(val[i] < iso) << i;
+      }
+      return cubeIndex;
+   }
+
+   /*-------------------------------------------------------------------------
+   Returns a bit mask of the cell edges the surface crosses for a cube index.
+   0 means the cell has no triangles.
+   */
+   DT_VOXEL_EXPORT int GetCubeEdges(int cubeIndex);
+
+   /*-------------------------------------------------------------------------
+   Returns the cell edges of the triangles for a cube index, three per
+   triangle, terminated with -1.  Edge n joins the corners PolygonizeCube
+   interpolates into vertArray[n].
+   */
+   DT_VOXEL_EXPORT const int* GetCubeTriangleEdges(int cubeIndex);
+
 
 } /* namespace dtVoxel */
 
@@ -24,6 +24,7 @@
 #include <dtVoxel/voxelcell.h>
 #include <dtCore/refptr.h>
 #include <osgVolume/Volume>
+#include <map>
 
 namespace dtVoxel
 {
@@ -38,9 +39,17 @@ namespace dtVoxel
       dtCore::ObserverPtr<osg::PagedLOD> mLODNode;
 
       osg::Vec3i mCellIndex;
+      /// The world space center of the cell, so updates can start nearest the camera.
+      osg::Vec3 mCenter;
       bool mStarted;
    };
 
+   /***
+    * The cells waiting for a new mesh, keyed by the morton code of their position.  Cells near each other in
+    * space are near each other in the map, and a cell is only in it once.
+    */
+   typedef std::map<unsigned long long, VoxelCellUpdateInfo> VoxelCellUpdateMap;
+
 
     /***
     *  A VoxelBlock represents a 3d block of VoxelCells.
@@ -72,7 +81,7 @@ namespace dtVoxel
       void RegenerateAABB(VoxelActor& voxelActor, const osg::BoundingBox& bb, const osg::Vec3i& textureResolution);
       void RegenerateCell(VoxelActor& voxelActor, VoxelCell* cell, osg::Group* nodeToUpdate, const osg::Vec3i& cellIndex, const osg::Vec3i& textureResolution, float viewDistance);
 
-      void CollectDirtyCells(VoxelActor& voxelActor, const osg::BoundingBox& bb, const osg::Vec3i& textureResolution, std::list<VoxelCellUpdateInfo>& dirtyCells);
+      void CollectDirtyCells(VoxelActor& voxelActor, const osg::BoundingBox& bb, const osg::Vec3i& textureResolution, VoxelCellUpdateMap& dirtyCells);
 
 
       //void AllocateCell(const osg::Vec3& pos, const osg::Vec3i& textureResolution);
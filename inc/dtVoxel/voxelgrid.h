@@ -126,7 +126,9 @@ namespace dtVoxel
       std::string mFullPathToFileCache;
       std::string mCacheFolder;
       std::vector<bool> mBlockVisibility;
-      std::list<VoxelCellUpdateInfo> mDirtyCells;
+      VoxelCellUpdateMap mDirtyCells;
+      /// Reused by BeginNewUpdates to order the dirty cells by distance.
+      std::vector<std::pair<float, VoxelCellUpdateInfo*> > mUpdateOrder;
       VoxelBlock* mBlocks;
 
    };
@@ -133,7 +133,7 @@ void MotionAction::StepObject(const PathPoint& cp)
    mLocalTransform.Get(local);
    if (mTargetObject.valid())
    {
-      mTargetObject->GetMatrixNode()->setMatrix(local * pTransform);
+      mTargetObject->SetMatrix(local * pTransform);
    }
 }
 
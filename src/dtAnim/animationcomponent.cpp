@@ -62,6 +62,7 @@ void AnimationComponent::ProcessMessage(const dtGame::Message& message)
    else if (message.GetMessageType() == dtGame::MessageType::INFO_MAP_UNLOADED)
    {
       SetTerrainActor(NULL);
+      mGroundClampEntries.clear();
    }
 }
 
@@ -69,11 +70,19 @@ void AnimationComponent::ProcessMessage(const dtGame::Message& message)
 /////////////////////////////////////////////////////////////////////////////////
 void AnimationComponent::TickLocal(float dt)
 {
-   BaseClass::TickLocal(dt);
+   const bool groundClamp = mGroundClamper->GetTerrainActor() != NULL;
+   if (groundClamp)
+   {
+      GroundClampActors();
+      mGroundClamper->AddBatchTasksToThreadPool();
+   }
+
+   BaseClass::BuildThreadWorkerTasks(dt);
+   dtUtil::ThreadPool::ExecuteTasks();
 
-   if (mGroundClamper->GetTerrainActor() != NULL)
+   if (groundClamp)
    {
-      ForEachActorComponent(dtUtil::MakeFunctor(&AnimationComponent::GroundClamp, this));
+      mGroundClamper->FinishUp();
    }
 
    ForEachActorComponent(dtUtil::MakeFunctor(&AnimationComponent::ExecuteCommands, this));
@@ -89,6 +98,11 @@ bool AnimationComponent::RegisterActor(dtGame::GameActorProxy& actor, dtAnim::An
       // when any animatable reaches a particular state.
       AnimEventCallback callback(this, &AnimationComponent::OnAnimationEvent);
       helper.SetSendEventCallback(callback);
+
+      GroundClampEntry& entry = mGroundClampEntries[actor.GetId()];
+      entry.mActor = &actor;
+      entry.mData.SetAdjustRotationToGround(false);
+      entry.mData.SetUseModelDimensions(false);
    }
    return result;
 }
@@ -101,6 +115,7 @@ bool AnimationComponent::UnregisterActor(const dtCore::UniqueId& actorId)
    {
       actorComp->SetSendEventCallback(AnimEventCallback());
    }
+   mGroundClampEntries.erase(actorId);
    return BaseClass::UnregisterActor(actorId);
 }
 
@@ -175,23 +190,27 @@ void AnimationComponent::ExecuteCommands(BaseClass::ActorCompMapping& item)
 }
 
 /////////////////////////////////////////////////////////////////////////////////
-void AnimationComponent::GroundClamp(BaseClass::ActorCompMapping& item)
+void AnimationComponent::GroundClampActors()
 {
-   dtGame::GameManager* gm = GetGameManager();
+   mGroundClamper->UpdateEyePoint();
 
-   dtGame::GroundClampingData gcData;
-   gcData.SetAdjustRotationToGround(false);
-   gcData.SetUseModelDimensions(false);
-
-   dtGame::GameActorProxy* pProxy = gm->FindGameActorById(item.first);
-   if (pProxy != NULL)
+   dtCore::Transform xform;
+   GroundClampMap::iterator i, iend;
+   i = mGroundClampEntries.begin();
+   iend = mGroundClampEntries.end();
+   for (; i != iend; ++i)
    {
-      dtCore::Transform xform;
-      pProxy->GetDrawable<dtCore::Transformable>()->GetTransform(xform, dtCore::Transformable::REL_CS);
+      GroundClampEntry& entry = i->second;
+      dtGame::GameActorProxy* pProxy = entry.mActor.get();
+      if (pProxy != NULL)
+      {
+         pProxy->GetDrawable<dtCore::Transformable>()->GetTransform(xform, dtCore::Transformable::REL_CS);
 
-      mGroundClamper->ClampToGround(dtGame::BaseGroundClamper::GroundClampRangeType::RANGED,
-               0.0, xform, *pProxy, gcData, true);
-   } // if
+         // The data must outlive the call, since the clamper only queues the query until FinishUp.
+         mGroundClamper->ClampToGround(dtGame::BaseGroundClamper::GroundClampRangeType::RANGED,
+                  0.0, xform, *pProxy, entry.mData, true);
+      }
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #include <dtCore/system.h>
 #include <dtCore/transform.h>
 #include <dtCore/project.h>
+#include <dtUtil/datastream.h>
 #include <dtUtil/serializer.h>
 #include <dtUtil/mathdefines.h>
 
@@ -983,6 +984,18 @@ DOMElement* Sound::Serialize(const FrameData* d, XERCES_CPP_NAMESPACE_QUALIFIER
    return element;
 }
 
+void Sound::Serialize(const FrameData* d, dtUtil::DataStream& stream) const
+{
+   stream << d->mGain << d->mPitch << d->mPlaying;
+}
+
+Sound::FrameData* Sound::Deserialize(dtUtil::DataStream& stream)
+{
+   FrameData* fd = new FrameData();
+   stream >> fd->mGain >> fd->mPitch >> fd->mPlaying;
+   return fd;
+}
+
 float Sound::GetDurationOfPlay() const
 {
    int dataSize = 0, bitsPerSample = 0, numChannels = 0;
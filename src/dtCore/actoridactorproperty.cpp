@@ -103,7 +103,7 @@ namespace dtCore
    dtCore::BaseActorObject* ActorIDActorProperty::GetActor()
    {
       dtCore::UniqueId idValue = GetValue();
-      if (idValue.ToString().empty()) return NULL;
+      if (idValue.IsNull()) return NULL;
 
       try
       {
@@ -149,7 +149,7 @@ namespace dtCore
    const dtCore::BaseActorObject* ActorIDActorProperty::GetActor() const
    {
       dtCore::UniqueId idValue = GetValue();
-      if (idValue.ToString().empty()) return NULL;
+      if (idValue.IsNull()) return NULL;
 
       try
       {
@@ -226,7 +226,7 @@ namespace dtCore
          return actor->GetName();
       }
 
-      if (!GetValue().ToString().empty())
+      if (!GetValue().IsNull())
       {
          return "Unknown";
       }
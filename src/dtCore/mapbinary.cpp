@@ -0,0 +1,1305 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <prefix/dtcoreprefix.h>
+#include <dtCore/mapbinary.h>
+
+#include <dtCore/actoractorproperty.h>
+#include <dtCore/actorcomponentcontainer.h>
+#include <dtCore/actorfactory.h>
+#include <dtCore/actoridactorproperty.h>
+#include <dtCore/arrayactorpropertybase.h>
+#include <dtCore/bitmaskactorproperty.h>
+#include <dtCore/booleanactorproperty.h>
+#include <dtCore/colorrgbaactorproperty.h>
+#include <dtCore/containeractorproperty.h>
+#include <dtCore/containerselectoractorproperty.h>
+#include <dtCore/datatype.h>
+#include <dtCore/deltadrawable.h>
+#include <dtCore/doubleactorproperty.h>
+#include <dtCore/environmentactor.h>
+#include <dtCore/exceptionenum.h>
+#include <dtCore/floatactorproperty.h>
+#include <dtCore/gameevent.h>
+#include <dtCore/gameeventactorproperty.h>
+#include <dtCore/gameeventmanager.h>
+#include <dtCore/intactorproperty.h>
+#include <dtCore/longactorproperty.h>
+#include <dtCore/mapcontenthandler.h>
+#include <dtCore/mapxmlconstants.h>
+#include <dtCore/project.h>
+#include <dtCore/propertycontainer.h>
+#include <dtCore/propertycontaineractorproperty.h>
+#include <dtCore/resourceactorproperty.h>
+#include <dtCore/vectoractorproperties.h>
+
+#include <dtUtil/datastream.h>
+#include <dtUtil/datetime.h>
+#include <dtUtil/log.h>
+#include <dtUtil/mappedfile.h>
+#include <dtUtil/mathdefines.h>
+
+#include <cstring>
+#include <fstream>
+
+namespace dtCore
+{
+   namespace MapBinaryConstants
+   {
+      const char MAGIC[8] = { 'D', 'T', 'M', 'A', 'P', 'B', 'I', 'N' };
+      const unsigned VERSION = 1;
+      const unsigned FLAG_PREFAB = 1;
+      const unsigned NO_INDEX = 0xFFFFFFFFU;
+   }
+
+   static const std::string EMPTY_STRING;
+
+   /////////////////////////////////////////////////////////////////////////////
+   // DataStream::AppendDataStream reallocates on every call, which is quadratic when
+   // thousands of actor and property records are appended, so grow geometrically instead.
+   static void AppendRecord(dtUtil::DataStream& dest, const dtUtil::DataStream& record)
+   {
+      unsigned size = record.GetBufferSize();
+      if (size == 0)
+      {
+         return;
+      }
+
+      unsigned available = dest.GetBufferCapacity() - dest.GetWritePosition();
+      if (available < size)
+      {
+         dest.IncreaseBufferSize(dtUtil::Max(size - available, dest.GetBufferCapacity()));
+      }
+      dest.WriteBinary(record.GetBuffer(), size);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MapBinaryParser::MapBinaryParser()
+      : mHasDeprecatedProperty(false)
+      , mParsing(false)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MapBinaryParser::~MapBinaryParser()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool MapBinaryParser::IsBinaryMap(const std::string& fileName)
+   {
+      std::ifstream stream(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+      if (!stream.is_open())
+      {
+         return false;
+      }
+
+      char magic[sizeof(MapBinaryConstants::MAGIC)];
+      stream.read(magic, sizeof(magic));
+      return stream.gcount() == std::streamsize(sizeof(magic))
+         && memcmp(magic, MapBinaryConstants::MAGIC, sizeof(magic)) == 0;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MapPtr MapBinaryParser::Parse(const std::string& fileName, bool prefab)
+   {
+      dtCore::RefPtr<dtUtil::MappedFile> file = new dtUtil::MappedFile();
+      if (!file->Open(fileName))
+      {
+         throw dtCore::MapParsingException("Unable to map binary map file \"" + fileName + "\".", __FILE__, __LINE__);
+      }
+      return ParseBuffer(file->GetData(), file->GetSize(), prefab);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MapPtr MapBinaryParser::ParseBuffer(const char* data, size_t size, bool prefab)
+   {
+      // The stream is only read, so it is safe to point it at the read only pages.
+      dtUtil::DataStream stream(const_cast<char*>(data), unsigned(size), false);
+      return ParseData(stream, prefab, false);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MapPtr MapBinaryParser::ParseMapHeaderData(const std::string& fileName, bool prefab)
+   {
+      dtCore::RefPtr<dtUtil::MappedFile> file = new dtUtil::MappedFile();
+      if (!file->Open(fileName))
+      {
+         throw dtCore::MapParsingException("Unable to map binary map file \"" + fileName + "\".", __FILE__, __LINE__);
+      }
+
+      dtUtil::DataStream stream(const_cast<char*>(file->GetData()), unsigned(file->GetSize()), false);
+      return ParseData(stream, prefab, true);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::Reset()
+   {
+      mStrings.clear();
+      mActorTypes.clear();
+      mActorsByFileId.clear();
+      mDeferredValues.clear();
+      mEnvironmentActorId.clear();
+      mMissingActorTypes.clear();
+      mMissingLibraries.clear();
+      mHasDeprecatedProperty = false;
+      mMap = NULL;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MapPtr MapBinaryParser::ParseData(dtUtil::DataStream& stream, bool prefab, bool headerOnly)
+   {
+      Reset();
+      stream.SetForceLittleEndian(true);
+
+      MapPtr result;
+      mParsing = true;
+      try
+      {
+         char magic[sizeof(MapBinaryConstants::MAGIC)];
+         if (stream.ReadBinary(magic, sizeof(magic)) != sizeof(magic)
+            || memcmp(magic, MapBinaryConstants::MAGIC, sizeof(magic)) != 0)
+         {
+            throw dtCore::MapParsingException("The file is not a binary map.", __FILE__, __LINE__);
+         }
+
+         unsigned version = 0, flags = 0;
+         stream >> version >> flags;
+         if (version > MapBinaryConstants::VERSION)
+         {
+            throw dtCore::MapParsingException("The binary map was written by a newer version.", __FILE__, __LINE__);
+         }
+
+         mMap = new Map("", "");
+
+         ReadStringTable(stream);
+         ReadHeader(stream, prefab);
+
+         if (!headerOnly)
+         {
+            ReadLibraries(stream);
+            ReadEvents(stream);
+            mEnvironmentActorId = ReadString(stream);
+            ReadActorTypes(stream);
+
+            unsigned actorCount = 0;
+            stream >> actorCount;
+            for (unsigned i = 0; i < actorCount; ++i)
+            {
+               ReadActor(stream, NULL, prefab);
+            }
+
+            ReadGroups(stream);
+            ReadPresetCameras(stream);
+            LinkDeferredValues();
+
+            if (!prefab && !mEnvironmentActorId.empty())
+            {
+               BaseActorObject* envActor = mMap->GetProxyById(dtCore::UniqueId(mEnvironmentActorId));
+               if (envActor != NULL)
+               {
+                  if (dynamic_cast<IEnvironmentActor*>(envActor->GetDrawable()) == NULL)
+                  {
+                     throw dtCore::InvalidActorException(
+                        "The environment actor proxy's actor should be an environment, but a dynamic_cast failed", __FILE__, __LINE__);
+                  }
+                  mMap->SetEnvironmentActor(envActor);
+               }
+            }
+         }
+      }
+      catch (const dtUtil::DataStreamBufferReadError& ex)
+      {
+         mParsing = false;
+         mMap = NULL;
+         throw dtCore::MapParsingException("The binary map is truncated or corrupt: " + ex.What(), __FILE__, __LINE__);
+      }
+      catch (...)
+      {
+         mParsing = false;
+         mMap = NULL;
+         throw;
+      }
+
+      mParsing = false;
+      result = mMap;
+      mMap = NULL;
+      mActorsByFileId.clear();
+      mDeferredValues.clear();
+      return result;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadStringTable(dtUtil::DataStream& stream)
+   {
+      unsigned count = 0;
+      stream >> count;
+      mStrings.resize(count);
+      for (unsigned i = 0; i < count; ++i)
+      {
+         unsigned length = 0;
+         stream >> length;
+         if (length > stream.GetRemainingReadSize())
+         {
+            throw dtUtil::DataStreamBufferReadError("String table entry runs past the end of the file.", __FILE__, __LINE__);
+         }
+         mStrings[i].assign(stream.GetBuffer() + stream.GetReadPosition(), length);
+         stream.Seekg(length, dtUtil::DataStream::SeekTypeEnum::CURRENT);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const std::string& MapBinaryParser::ReadString(dtUtil::DataStream& stream) const
+   {
+      unsigned index = 0;
+      stream >> index;
+      if (index == MapBinaryConstants::NO_INDEX)
+      {
+         return EMPTY_STRING;
+      }
+      if (index >= mStrings.size())
+      {
+         throw dtCore::MapParsingException("The binary map refers to a string that is not in the string table.", __FILE__, __LINE__);
+      }
+      return mStrings[index];
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadHeader(dtUtil::DataStream& stream, bool prefab)
+   {
+      const std::string& name = ReadString(stream);
+      const std::string& description = ReadString(stream);
+      const std::string& author = ReadString(stream);
+      const std::string& comment = ReadString(stream);
+      const std::string& copyright = ReadString(stream);
+      const std::string& createTime = ReadString(stream);
+      // last update time, editor version and schema version are ignored, just as with the xml.
+      ReadString(stream);
+      ReadString(stream);
+      ReadString(stream);
+      const std::string& icon = ReadString(stream);
+
+      mMap->SetDescription(description);
+      mMap->SetCreateDateTime(createTime);
+      if (!prefab)
+      {
+         mMap->SetName(name);
+         mMap->SetAuthor(author);
+         mMap->SetComment(comment);
+         mMap->SetCopyright(copyright);
+      }
+      else
+      {
+         mMap->SetIconFile(icon);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadLibraries(dtUtil::DataStream& stream)
+   {
+      unsigned count = 0;
+      stream >> count;
+      for (unsigned i = 0; i < count; ++i)
+      {
+         const std::string& libName = ReadString(stream);
+         const std::string& libVersion = ReadString(stream);
+         try
+         {
+            if (ActorFactory::GetInstance().GetRegistry(libName) == NULL)
+            {
+               ActorFactory::GetInstance().LoadActorRegistry(libName);
+            }
+            mMap->AddLibrary(libName, libVersion);
+         }
+         catch (const dtUtil::Exception& e)
+         {
+            mMissingLibraries.push_back(libName);
+            LOG_ERROR("Error loading library " + libName + " version " + libVersion + ".  Exception message to follow.");
+            e.LogException(dtUtil::Log::LOG_ERROR);
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadEvents(dtUtil::DataStream& stream)
+   {
+      unsigned count = 0;
+      stream >> count;
+      for (unsigned i = 0; i < count; ++i)
+      {
+         dtCore::RefPtr<GameEvent> gameEvent = new GameEvent();
+         gameEvent->SetUniqueId(dtCore::UniqueId(ReadString(stream)));
+         gameEvent->SetName(ReadString(stream));
+         gameEvent->SetDescription(ReadString(stream));
+         mMap->GetEventManager().AddEvent(*gameEvent);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadActorTypes(dtUtil::DataStream& stream)
+   {
+      unsigned count = 0;
+      stream >> count;
+      mActorTypes.resize(count);
+      for (unsigned i = 0; i < count; ++i)
+      {
+         const std::string& category = ReadString(stream);
+         const std::string& name = ReadString(stream);
+         mActorTypes[i] = MapContentHandler::FindActorType(category, name);
+         if (mActorTypes[i] == NULL)
+         {
+            // Keep a placeholder so components created in code can still be matched by name.
+            mActorTypes[i] = new ActorType(name, category, std::string());
+            mMissingActorTypes.insert(mActorTypes[i]->GetFullName());
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadActor(dtUtil::DataStream& stream, BaseActorObject* parentActor, bool prefab)
+   {
+      unsigned typeIndex = 0, recordSize = 0;
+      stream >> typeIndex >> recordSize;
+      unsigned recordEnd = stream.GetReadPosition() + recordSize;
+
+      if (typeIndex >= mActorTypes.size())
+      {
+         throw dtCore::MapParsingException("The binary map refers to an actor type that is not in the type table.", __FILE__, __LINE__);
+      }
+      ActorTypePtr actorType = mActorTypes[typeIndex];
+      bool typeMissing = mMissingActorTypes.find(actorType->GetFullName()) != mMissingActorTypes.end();
+
+      ActorComponentContainer* compContainer = dynamic_cast<ActorComponentContainer*>(parentActor);
+
+      dtCore::RefPtr<BaseActorObject> actor;
+      if (compContainer != NULL)
+      {
+         ActorPtrVector existingComponents;
+         compContainer->GetComponents(actorType, existingComponents);
+         if (!existingComponents.empty())
+         {
+            actor = existingComponents[0];
+            // Actor components created in code won't have their defaults initialized unless the developer
+            // created it through the factory.
+            actor->InitDefaults();
+         }
+      }
+
+      bool newActorComponent = !actor.valid();
+      if (!actor.valid() && !typeMissing)
+      {
+         actor = ActorFactory::GetInstance().CreateActor(*actorType);
+      }
+
+      if (!actor.valid())
+      {
+         if (!typeMissing)
+         {
+            LOG_WARNING("An actor could not be created for ActorType \"" + actorType->GetFullName() + "\".");
+            mMissingActorTypes.insert(actorType->GetFullName());
+         }
+         stream.Seekg(recordEnd, dtUtil::DataStream::SeekTypeEnum::SET);
+         return;
+      }
+
+      actor->OnMapLoadBegin();
+      if (compContainer != NULL && newActorComponent)
+      {
+         compContainer->AddComponent(*actor);
+      }
+
+      const std::string& fileId = ReadString(stream);
+      if (!prefab)
+      {
+         actor->SetId(dtCore::UniqueId(fileId));
+      }
+      actor->SetName(ReadString(stream));
+      const std::string& parentId = ReadString(stream);
+      mActorsByFileId[fileId] = actor.get();
+
+      unsigned componentCount = 0;
+      stream >> componentCount;
+      for (unsigned i = 0; i < componentCount; ++i)
+      {
+         ReadActor(stream, actor.get(), prefab);
+      }
+
+      ReadProperties(stream, actor.get());
+
+      if (!actor->IsActorComponent())
+      {
+         ActorComponentContainer* extendedActor = dynamic_cast<ActorComponentContainer*>(actor.get());
+         if (extendedActor != NULL && !parentId.empty())
+         {
+            // Parents are always written before their children.
+            ActorIdMap::iterator parentIter = mActorsByFileId.find(parentId);
+            if (parentIter != mActorsByFileId.end())
+            {
+               extendedActor->SetParentBaseActor(parentIter->second);
+            }
+         }
+         mMap->AddProxy(*actor);
+      }
+      actor->OnMapLoadEnd();
+
+      stream.Seekg(recordEnd, dtUtil::DataStream::SeekTypeEnum::SET);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadGroups(dtUtil::DataStream& stream)
+   {
+      unsigned groupCount = 0;
+      stream >> groupCount;
+      for (unsigned i = 0; i < groupCount; ++i)
+      {
+         int groupIndex = mMap->GetGroupCount();
+         unsigned actorCount = 0;
+         stream >> actorCount;
+         for (unsigned j = 0; j < actorCount; ++j)
+         {
+            ActorIdMap::iterator found = mActorsByFileId.find(ReadString(stream));
+            if (found != mActorsByFileId.end())
+            {
+               mMap->AddActorToGroup(groupIndex, *found->second);
+            }
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadPresetCameras(dtUtil::DataStream& stream)
+   {
+      unsigned count = 0;
+      stream >> count;
+      for (unsigned i = 0; i < count; ++i)
+      {
+         int index = 0;
+         osg::Vec4d rotation;
+         Map::PresetCameraData data;
+         stream >> index >> data.persPosition >> rotation;
+         stream >> data.topPosition >> data.topZoom;
+         stream >> data.sidePosition >> data.sideZoom;
+         stream >> data.frontPosition >> data.frontZoom;
+         data.persRotation.set(rotation);
+         data.isValid = true;
+         mMap->SetPresetCameraData(index, data);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadProperties(dtUtil::DataStream& stream, PropertyContainer* container)
+   {
+      unsigned count = 0;
+      stream >> count;
+      for (unsigned i = 0; i < count; ++i)
+      {
+         const std::string& name = ReadString(stream);
+         unsigned char typeId = 0;
+         unsigned size = 0;
+         stream >> typeId >> size;
+
+         dtCore::RefPtr<ActorProperty> prop;
+         if (container != NULL)
+         {
+            prop = container->GetProperty(name);
+            if (!prop.valid())
+            {
+               prop = container->GetDeprecatedProperty(name);
+               mHasDeprecatedProperty = mHasDeprecatedProperty || prop.valid();
+            }
+         }
+         ReadValue(stream, typeId, size, prop.get(), container);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadNestedRecords(dtUtil::DataStream& stream, ActorProperty& prop)
+   {
+      unsigned count = 0;
+      stream >> count;
+
+      ArrayActorPropertyBase* arrayProp = dynamic_cast<ArrayActorPropertyBase*>(&prop);
+      if (arrayProp != NULL)
+      {
+         int arraySize = int(count);
+         int minSize = dtUtil::Max(arrayProp->GetMinArraySize(), 0);
+         int maxSize = arrayProp->GetMaxArraySize() < 0 ? arraySize : arrayProp->GetMaxArraySize();
+         dtUtil::Clamp(arraySize, minSize, maxSize);
+
+         arrayProp->SetIndex(0);
+         while (arraySize > arrayProp->GetArraySize())
+         {
+            arrayProp->PushBack();
+         }
+         while (arraySize < arrayProp->GetArraySize())
+         {
+            arrayProp->PopBack();
+         }
+      }
+
+      ContainerActorProperty* containerProp = dynamic_cast<ContainerActorProperty*>(&prop);
+
+      for (unsigned i = 0; i < count; ++i)
+      {
+         const std::string& name = ReadString(stream);
+         unsigned char typeId = 0;
+         unsigned size = 0;
+         stream >> typeId >> size;
+
+         ActorProperty* element = NULL;
+         if (arrayProp != NULL && int(i) < arrayProp->GetArraySize())
+         {
+            arrayProp->SetIndex(int(i));
+            element = arrayProp->GetArrayProperty();
+         }
+         else if (containerProp != NULL)
+         {
+            element = containerProp->GetProperty(name);
+         }
+         ReadValue(stream, typeId, size, element, NULL);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::ReadValue(dtUtil::DataStream& stream, unsigned typeId, unsigned size,
+            ActorProperty* prop, PropertyContainer* container)
+   {
+      unsigned valueEnd = stream.GetReadPosition() + size;
+      if (size > stream.GetRemainingReadSize())
+      {
+         throw dtUtil::DataStreamBufferReadError("Property value runs past the end of the file.", __FILE__, __LINE__);
+      }
+
+      if (prop == NULL || prop->IsReadOnly() || prop->GetDataType().GetTypeId() != typeId)
+      {
+         if (prop != NULL && !prop->IsReadOnly())
+         {
+            LOG_WARNING("Property \"" + prop->GetName() + "\" has changed type since the map was saved, so its value was skipped.");
+         }
+         stream.Seekg(valueEnd, dtUtil::DataStream::SeekTypeEnum::SET);
+         return;
+      }
+
+      switch (typeId)
+      {
+      case DataType::FLOAT_ID:
+         {
+            float value;
+            stream >> value;
+            static_cast<FloatActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::DOUBLE_ID:
+         {
+            double value;
+            stream >> value;
+            static_cast<DoubleActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::INT_ID:
+         {
+            int value;
+            stream >> value;
+            static_cast<IntActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::LONGINT_ID:
+         {
+            long long value;
+            stream >> value;
+            static_cast<LongActorProperty*>(prop)->SetValue(long(value));
+            break;
+         }
+      case DataType::BOOLEAN_ID:
+         {
+            bool value;
+            stream >> value;
+            static_cast<BooleanActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::BIT_MASK_ID:
+         {
+            unsigned value;
+            stream >> value;
+            static_cast<BitMaskActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::STRING_ID:
+      case DataType::ENUMERATION_ID:
+         prop->FromString(ReadString(stream));
+         break;
+      case DataType::GAMEEVENT_ID:
+         {
+            const std::string& eventId = ReadString(stream);
+            GameEvent* gameEvent = eventId.empty() ? NULL : mMap->GetEventManager().FindEvent(dtCore::UniqueId(eventId));
+            if (gameEvent != NULL)
+            {
+               static_cast<GameEventActorProperty*>(prop)->SetValue(gameEvent);
+            }
+            else
+            {
+               prop->FromString(eventId);
+            }
+            break;
+         }
+      case DataType::ACTOR_ID:
+         {
+            const std::string& actorId = ReadString(stream);
+            ActorActorProperty* aap = dynamic_cast<ActorActorProperty*>(prop);
+            if (aap == NULL)
+            {
+               prop->FromString(actorId);
+            }
+            else if (actorId.empty())
+            {
+               aap->SetValue(NULL);
+            }
+            else if (container != NULL)
+            {
+               DeferredValue deferred;
+               deferred.mContainer = container;
+               deferred.mPropertyName = prop->GetName();
+               deferred.mValue = actorId;
+               deferred.mIsGroup = false;
+               mDeferredValues.push_back(deferred);
+            }
+            else
+            {
+               // Elements of arrays have no name to find them by later, so link to whatever already exists.
+               ActorIdMap::iterator found = mActorsByFileId.find(actorId);
+               if (found != mActorsByFileId.end())
+               {
+                  aap->SetValue(found->second);
+               }
+            }
+            break;
+         }
+      case DataType::VEC2_ID:
+      case DataType::VEC2F_ID:
+         {
+            osg::Vec2f value;
+            stream >> value;
+            static_cast<Vec2fActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::VEC2D_ID:
+         {
+            osg::Vec2d value;
+            stream >> value;
+            static_cast<Vec2dActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::VEC3_ID:
+      case DataType::VEC3F_ID:
+         {
+            osg::Vec3f value;
+            stream >> value;
+            static_cast<Vec3fActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::VEC3D_ID:
+         {
+            osg::Vec3d value;
+            stream >> value;
+            static_cast<Vec3dActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::VEC4_ID:
+      case DataType::VEC4F_ID:
+      case DataType::RGBACOLOR_ID:
+         {
+            osg::Vec4f value;
+            stream >> value;
+            static_cast<Vec4fActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::VEC4D_ID:
+         {
+            osg::Vec4d value;
+            stream >> value;
+            static_cast<Vec4dActorProperty*>(prop)->SetValue(value);
+            break;
+         }
+      case DataType::GROUP_ID:
+         {
+            // Groups may hold actor references, so they are assigned last like the xml parser does.
+            if (container != NULL)
+            {
+               DeferredValue deferred;
+               deferred.mContainer = container;
+               deferred.mPropertyName = prop->GetName();
+               deferred.mValue = ReadString(stream);
+               deferred.mIsGroup = true;
+               mDeferredValues.push_back(deferred);
+            }
+            else
+            {
+               prop->FromString(ReadString(stream));
+            }
+            break;
+         }
+      case DataType::ARRAY_ID:
+      case DataType::CONTAINER_ID:
+         ReadNestedRecords(stream, *prop);
+         break;
+      case DataType::CONTAINER_SELECTOR_ID:
+         {
+            ContainerSelectorActorProperty* selector = static_cast<ContainerSelectorActorProperty*>(prop);
+            selector->FromString(ReadString(stream));
+            ReadProperties(stream, selector->GetContainer());
+            break;
+         }
+      case DataType::PROPERTY_CONTAINER_ID:
+         {
+            BasePropertyContainerActorProperty* pcProp = dynamic_cast<BasePropertyContainerActorProperty*>(prop);
+            PropertyContainer* pc = NULL;
+            if (pcProp != NULL)
+            {
+               pc = pcProp->GetValue();
+               if (pc == NULL)
+               {
+                  pcProp->CreateNew();
+                  pc = pcProp->GetValue();
+               }
+            }
+            ReadProperties(stream, pc);
+            break;
+         }
+      default:
+         {
+            if (prop->GetDataType().IsResource())
+            {
+               const std::string& displayName = ReadString(stream);
+               const std::string& identifier = ReadString(stream);
+               ResourceActorProperty* resourceProp = static_cast<ResourceActorProperty*>(prop);
+               if (identifier.empty())
+               {
+                  resourceProp->SetValue(ResourceDescriptor::NULL_RESOURCE);
+               }
+               else
+               {
+                  resourceProp->SetValue(ResourceDescriptor(displayName, identifier));
+               }
+            }
+            break;
+         }
+      }
+
+      stream.Seekg(valueEnd, dtUtil::DataStream::SeekTypeEnum::SET);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryParser::LinkDeferredValues()
+   {
+      // Actor links first so the groups see the same state the xml parser leaves.
+      for (unsigned pass = 0; pass < 2; ++pass)
+      {
+         bool groups = pass == 1;
+         std::vector<DeferredValue>::iterator i, iend = mDeferredValues.end();
+         for (i = mDeferredValues.begin(); i != iend; ++i)
+         {
+            if (i->mIsGroup != groups)
+            {
+               continue;
+            }
+
+            dtCore::RefPtr<ActorProperty> prop = i->mContainer->GetProperty(i->mPropertyName);
+            if (!prop.valid())
+            {
+               prop = i->mContainer->GetDeprecatedProperty(i->mPropertyName);
+            }
+            if (!prop.valid())
+            {
+               continue;
+            }
+
+            if (groups)
+            {
+               prop->FromString(i->mValue);
+               continue;
+            }
+
+            ActorIdMap::iterator found = mActorsByFileId.find(i->mValue);
+            if (found == mActorsByFileId.end())
+            {
+               LOG_ERROR("Actor property " + i->mPropertyName + " refers to actor " + i->mValue
+                  + ", but that actor does not exist in the map.");
+               continue;
+            }
+            static_cast<ActorActorProperty*>(prop.get())->SetValue(found->second);
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool MapBinaryParser::IsParsing() const
+   {
+      return mParsing;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   Map* MapBinaryParser::GetMapBeingParsed()
+   {
+      return mParsing ? mMap.get() : NULL;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const Map* MapBinaryParser::GetMapBeingParsed() const
+   {
+      return mParsing ? mMap.get() : NULL;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const std::set<std::string>& MapBinaryParser::GetMissingActorTypes() const
+   {
+      return mMissingActorTypes;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const std::vector<std::string>& MapBinaryParser::GetMissingLibraries() const
+   {
+      return mMissingLibraries;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool MapBinaryParser::HasDeprecatedProperty() const
+   {
+      return mHasDeprecatedProperty;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   //////////////////////////////////////////////////////////////////////////
+
+   /////////////////////////////////////////////////////////////////////////////
+   MapBinaryWriter::MapBinaryWriter()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MapBinaryWriter::~MapBinaryWriter()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryWriter::Reset()
+   {
+      mStrings.clear();
+      mStringIndices.clear();
+      mActorTypes.clear();
+      mActorTypeIndices.clear();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned MapBinaryWriter::GetStringIndex(const std::string& str)
+   {
+      StringIndexMap::iterator found = mStringIndices.find(str);
+      if (found != mStringIndices.end())
+      {
+         return found->second;
+      }
+
+      unsigned index = unsigned(mStrings.size());
+      mStrings.push_back(str);
+      mStringIndices.insert(std::make_pair(str, index));
+      return index;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned MapBinaryWriter::GetActorTypeIndex(const ActorType& type)
+   {
+      std::string fullName = type.GetFullName();
+      dtUtil::HashMap<std::string, unsigned>::iterator found = mActorTypeIndices.find(fullName);
+      if (found != mActorTypeIndices.end())
+      {
+         return found->second;
+      }
+
+      unsigned index = unsigned(mActorTypes.size());
+      mActorTypes.push_back(&type);
+      mActorTypeIndices.insert(std::make_pair(fullName, index));
+      return index;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryWriter::Save(Map& map, const std::string& filePath, bool prefab)
+   {
+      std::ofstream stream(filePath.c_str(), std::ios_base::trunc|std::ios_base::binary);
+      if (!stream.is_open())
+      {
+         throw dtCore::MapSaveException( std::string("Unable to open map file \"") + filePath + "\" for writing.", __FILE__, __LINE__);
+      }
+      Save(map, stream, prefab);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryWriter::Save(Map& map, std::ostream& outStream, bool prefab)
+   {
+      Reset();
+      map.CorrectLibraryList(false);
+
+      const std::string& utcTime = dtUtil::DateTime::ToString(dtUtil::DateTime(dtUtil::DateTime::TimeOrigin::LOCAL_TIME),
+         dtUtil::DateTime::TimeFormat::CALENDAR_DATE_AND_TIME_FORMAT);
+      if (map.GetCreateDateTime().empty())
+      {
+         map.SetCreateDateTime(utcTime);
+      }
+
+      // The body is written first so the string and type tables are complete when the file header goes out.
+      dtUtil::DataStream body;
+      body.SetForceLittleEndian(true);
+
+      body << GetStringIndex(map.GetName());
+      body << GetStringIndex(map.GetDescription());
+      body << GetStringIndex(map.GetAuthor());
+      body << GetStringIndex(map.GetComment());
+      body << GetStringIndex(map.GetCopyright());
+      body << GetStringIndex(map.GetCreateDateTime());
+      body << GetStringIndex(utcTime);
+      body << GetStringIndex(MapXMLConstants::EDITOR_VERSION);
+      body << GetStringIndex(MapXMLConstants::SCHEMA_VERSION);
+      body << GetStringIndex(map.GetIconFile());
+
+      const std::vector<std::string>& libs = map.GetAllLibraries();
+      body << unsigned(libs.size());
+      for (std::vector<std::string>::const_iterator i = libs.begin(); i != libs.end(); ++i)
+      {
+         body << GetStringIndex(*i) << GetStringIndex(map.GetLibraryVersion(*i));
+      }
+
+      std::vector<GameEvent*> events;
+      if (!prefab)
+      {
+         map.GetEventManager().GetAllEvents(events);
+      }
+      body << unsigned(events.size());
+      for (std::vector<GameEvent*>::const_iterator i = events.begin(); i != events.end(); ++i)
+      {
+         body << GetStringIndex((*i)->GetUniqueId().ToString());
+         body << GetStringIndex((*i)->GetName());
+         body << GetStringIndex((*i)->GetDescription());
+      }
+
+      if (!prefab && map.GetEnvironmentActor() != NULL)
+      {
+         body << GetStringIndex(map.GetEnvironmentActor()->GetId().ToString());
+      }
+      else
+      {
+         body << MapBinaryConstants::NO_INDEX;
+      }
+
+      // Actors go to their own stream because the type table must precede them.
+      dtUtil::DataStream actors;
+      actors.SetForceLittleEndian(true);
+      unsigned actorCount = 0;
+
+      typedef std::map<dtCore::UniqueId, dtCore::RefPtr<BaseActorObject> > ActorMap;
+      const ActorMap& actorMap = map.GetAllProxies();
+      for (ActorMap::const_iterator curIter = actorMap.begin(); curIter != actorMap.end(); ++curIter)
+      {
+         BaseActorObject* actor = curIter->second.get();
+         bool isActorComp = actor->IsActorComponent();
+         ActorComponentContainer* compContainer = isActorComp ? NULL : dynamic_cast<ActorComponentContainer*>(actor);
+
+         // Children are written after their top level parent, so skip them here.
+         if (actor->IsGhost() || (compContainer != NULL && compContainer->GetParentBaseActor() != NULL))
+         {
+            continue;
+         }
+
+         if (isActorComp)
+         {
+            LOG_ERROR("Cannot write an ActorComponent \"" + actor->GetName()
+               + "\" (type " + actor->GetActorType().GetName()
+               + ") directly to the map root. The actor component must be contained within an actor.");
+         }
+         else if (compContainer == NULL)
+         {
+            WriteActor(actors, *actor);
+            ++actorCount;
+         }
+         else
+         {
+            dtCore::RefPtr<ActorComponentContainer::ActorIterator> iter = compContainer->GetIterator();
+            while (!iter->IsAtEnd())
+            {
+               BaseActorObject* curActor = *(*iter);
+               if (!curActor->IsGhost())
+               {
+                  WriteActor(actors, *curActor);
+                  ++actorCount;
+               }
+               ++(*iter);
+            }
+         }
+      }
+
+      body << unsigned(mActorTypes.size());
+      for (std::vector<dtCore::ActorTypePtr>::const_iterator i = mActorTypes.begin(); i != mActorTypes.end(); ++i)
+      {
+         body << GetStringIndex((*i)->GetCategory()) << GetStringIndex((*i)->GetName());
+      }
+      body << actorCount;
+      AppendRecord(body, actors);
+
+      int groupCount = prefab ? 0 : map.GetGroupCount();
+      body << unsigned(groupCount);
+      for (int groupIndex = 0; groupIndex < groupCount; ++groupIndex)
+      {
+         std::vector<std::string> ids;
+         int count = map.GetGroupActorCount(groupIndex);
+         for (int actorIndex = 0; actorIndex < count; ++actorIndex)
+         {
+            BaseActorObject* actor = map.GetActorFromGroup(groupIndex, actorIndex);
+            if (actor != NULL)
+            {
+               ids.push_back(actor->GetId().ToString());
+            }
+         }
+         body << unsigned(ids.size());
+         for (size_t i = 0; i < ids.size(); ++i)
+         {
+            body << GetStringIndex(ids[i]);
+         }
+      }
+
+      std::vector<int> presetIndices;
+      for (int presetIndex = 0; !prefab && presetIndex < 10; ++presetIndex)
+      {
+         if (map.GetPresetCameraData(presetIndex).isValid)
+         {
+            presetIndices.push_back(presetIndex);
+         }
+      }
+      body << unsigned(presetIndices.size());
+      for (size_t i = 0; i < presetIndices.size(); ++i)
+      {
+         Map::PresetCameraData data = map.GetPresetCameraData(presetIndices[i]);
+         body << presetIndices[i] << data.persPosition << osg::Vec4d(data.persRotation.asVec4());
+         body << data.topPosition << data.topZoom;
+         body << data.sidePosition << data.sideZoom;
+         body << data.frontPosition << data.frontZoom;
+      }
+
+      dtUtil::DataStream header;
+      header.SetForceLittleEndian(true);
+      header.WriteBinary(MapBinaryConstants::MAGIC, sizeof(MapBinaryConstants::MAGIC));
+      header << MapBinaryConstants::VERSION << (prefab ? MapBinaryConstants::FLAG_PREFAB : 0U);
+      header << unsigned(mStrings.size());
+      for (std::vector<std::string>::const_iterator i = mStrings.begin(); i != mStrings.end(); ++i)
+      {
+         header << unsigned(i->size());
+         header.WriteBinary(i->data(), unsigned(i->size()));
+      }
+
+      outStream.write(header.GetBuffer(), header.GetBufferSize());
+      outStream.write(body.GetBuffer(), body.GetBufferSize());
+      if (outStream.fail())
+      {
+         throw dtCore::MapSaveException(std::string("Error writing map \"") + map.GetName() + "\".", __FILE__, __LINE__);
+      }
+      Reset();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryWriter::WriteActor(dtUtil::DataStream& stream, BaseActorObject& actor)
+   {
+      dtUtil::DataStream record;
+      record.SetForceLittleEndian(true);
+
+      record << GetStringIndex(actor.GetId().ToString());
+      record << GetStringIndex(actor.GetName());
+
+      ActorComponentContainer* compContainer = dynamic_cast<ActorComponentContainer*>(&actor);
+      BaseActorObject* parent = compContainer != NULL ? compContainer->GetParentBaseActor() : NULL;
+      record << (parent != NULL ? GetStringIndex(parent->GetId().ToString()) : MapBinaryConstants::NO_INDEX);
+
+      // Components come before the properties so they exist when deprecated properties are handled.
+      ActorPtrVector comps;
+      if (compContainer != NULL)
+      {
+         compContainer->GetAllComponents(comps);
+      }
+      record << unsigned(comps.size());
+      for (ActorPtrVector::iterator i = comps.begin(); i != comps.end(); ++i)
+      {
+         WriteActor(record, **i);
+      }
+
+      WriteProperties(record, actor);
+
+      stream << GetActorTypeIndex(actor.GetActorType()) << record.GetBufferSize();
+      AppendRecord(stream, record);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryWriter::WriteProperties(dtUtil::DataStream& stream, PropertyContainer& container)
+   {
+      std::vector<const ActorProperty*> propList;
+      container.GetPropertyList(propList);
+
+      dtUtil::DataStream records;
+      records.SetForceLittleEndian(true);
+      unsigned count = 0;
+      for (std::vector<const ActorProperty*>::const_iterator i = propList.begin(); i != propList.end(); ++i)
+      {
+         if (container.ShouldPropertySave(**i))
+         {
+            WriteProperty(records, **i);
+            ++count;
+         }
+      }
+
+      stream << count;
+      AppendRecord(stream, records);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryWriter::WriteProperty(dtUtil::DataStream& stream, const ActorProperty& prop)
+   {
+      dtUtil::DataStream value;
+      value.SetForceLittleEndian(true);
+      WriteValue(value, prop);
+
+      stream << GetStringIndex(prop.GetName());
+      stream << (unsigned char)(prop.GetDataType().GetTypeId());
+      stream << value.GetBufferSize();
+      AppendRecord(stream, value);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MapBinaryWriter::WriteValue(dtUtil::DataStream& stream, const ActorProperty& prop)
+   {
+      const DataType& dataType = prop.GetDataType();
+      switch (dataType.GetTypeId())
+      {
+      case DataType::FLOAT_ID:
+         stream << static_cast<const FloatActorProperty&>(prop).GetValue();
+         break;
+      case DataType::DOUBLE_ID:
+         stream << static_cast<const DoubleActorProperty&>(prop).GetValue();
+         break;
+      case DataType::INT_ID:
+         stream << static_cast<const IntActorProperty&>(prop).GetValue();
+         break;
+      case DataType::LONGINT_ID:
+         // long differs in size between platforms.
+         stream << (long long)(static_cast<const LongActorProperty&>(prop).GetValue());
+         break;
+      case DataType::BOOLEAN_ID:
+         stream << static_cast<const BooleanActorProperty&>(prop).GetValue();
+         break;
+      case DataType::BIT_MASK_ID:
+         stream << static_cast<const BitMaskActorProperty&>(prop).GetValue();
+         break;
+      case DataType::STRING_ID:
+      case DataType::ENUMERATION_ID:
+      case DataType::GAMEEVENT_ID:
+      case DataType::ACTOR_ID:
+      case DataType::GROUP_ID:
+         stream << GetStringIndex(prop.ToString());
+         break;
+      case DataType::VEC2_ID:
+      case DataType::VEC2F_ID:
+         stream << static_cast<const Vec2fActorProperty&>(prop).GetValue();
+         break;
+      case DataType::VEC2D_ID:
+         stream << static_cast<const Vec2dActorProperty&>(prop).GetValue();
+         break;
+      case DataType::VEC3_ID:
+      case DataType::VEC3F_ID:
+         stream << static_cast<const Vec3fActorProperty&>(prop).GetValue();
+         break;
+      case DataType::VEC3D_ID:
+         stream << static_cast<const Vec3dActorProperty&>(prop).GetValue();
+         break;
+      case DataType::VEC4_ID:
+      case DataType::VEC4F_ID:
+      case DataType::RGBACOLOR_ID:
+         stream << static_cast<const Vec4fActorProperty&>(prop).GetValue();
+         break;
+      case DataType::VEC4D_ID:
+         stream << static_cast<const Vec4dActorProperty&>(prop).GetValue();
+         break;
+      case DataType::ARRAY_ID:
+         {
+            const ArrayActorPropertyBase& arrayProp = static_cast<const ArrayActorPropertyBase&>(prop);
+            int arraySize = arrayProp.GetArraySize();
+            stream << unsigned(arraySize);
+            for (int index = 0; index < arraySize; ++index)
+            {
+               arrayProp.SetIndex(index);
+               WriteProperty(stream, *arrayProp.GetArrayProperty());
+            }
+            break;
+         }
+      case DataType::CONTAINER_ID:
+         {
+            const ContainerActorProperty& containerProp = static_cast<const ContainerActorProperty&>(prop);
+            stream << unsigned(containerProp.GetPropertyCount());
+            for (int index = 0; index < containerProp.GetPropertyCount(); ++index)
+            {
+               WriteProperty(stream, *containerProp.GetProperty(index));
+            }
+            break;
+         }
+      case DataType::CONTAINER_SELECTOR_ID:
+         {
+            const ContainerSelectorActorProperty& selector = static_cast<const ContainerSelectorActorProperty&>(prop);
+            stream << GetStringIndex(selector.GetValue());
+            PropertyContainer* selected = selector.GetContainer();
+            if (selected != NULL)
+            {
+               WriteProperties(stream, *selected);
+            }
+            else
+            {
+               stream << 0U;
+            }
+            break;
+         }
+      case DataType::PROPERTY_CONTAINER_ID:
+         {
+            PropertyContainer* pc = static_cast<const BasePropertyContainerActorProperty&>(prop).GetValue();
+            if (pc != NULL)
+            {
+               WriteProperties(stream, *pc);
+            }
+            else
+            {
+               stream << 0U;
+            }
+            break;
+         }
+      default:
+         {
+            if (dataType.IsResource())
+            {
+               ResourceDescriptor rd = static_cast<const ResourceActorProperty&>(prop).GetValue();
+               stream << (rd.IsEmpty() ? MapBinaryConstants::NO_INDEX : GetStringIndex(rd.GetDisplayName()));
+               stream << (rd.IsEmpty() ? MapBinaryConstants::NO_INDEX : GetStringIndex(rd.GetResourceIdentifier()));
+            }
+            else
+            {
+               LOG_ERROR("Unhandled datatype in MapBinaryWriter: " + dataType.GetName() + ".");
+            }
+            break;
+         }
+      }
+   }
+}
@@ -238,6 +238,8 @@ namespace dtCore
    MapParser::MapParser()
    : BaseXMLParser()
    , mMapHandler(new MapContentHandler())
+   , mBinaryParser(new MapBinaryParser())
+   , mUsedBinaryParser(false)
    {
       SetHandler(mMapHandler.get());
 
@@ -270,9 +272,39 @@ namespace dtCore
    {
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   std::string MapParser::FindBinaryMap(const std::string& path)
+   {
+      std::string filename = dtUtil::FindFileInPathList(path);
+      if (!filename.empty() && MapBinaryParser::IsBinaryMap(filename))
+      {
+         return filename;
+      }
+      return std::string();
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    bool MapParser::Parse(const std::string& path, Map** map, bool prefab)
    {
+      std::string binaryFile = FindBinaryMap(path);
+      mUsedBinaryParser = !binaryFile.empty();
+      if (mUsedBinaryParser)
+      {
+         SetParsing(true);
+         try
+         {
+            dtCore::RefPtr<Map> mapRef = mBinaryParser->Parse(binaryFile, prefab);
+            SetParsing(false);
+            *map = mapRef.release();
+         }
+         catch (...)
+         {
+            SetParsing(false);
+            throw;
+         }
+         return true;
+      }
+
       bool result = false;
       dtCore::RefPtr<MapReaderWriter::MapStream> mapStreamObject;
 
@@ -339,6 +371,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    bool MapParser::Parse(std::istream& stream, Map** map, bool prefab)
    {
+      mUsedBinaryParser = false;
       if (!prefab)
          mMapHandler->SetMapMode();
       else
@@ -445,6 +478,12 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    MapPtr MapParser::ParseMapHeaderData(const std::string& path, bool prefab) const
    {
+      std::string binaryFile = FindBinaryMap(path);
+      if (!binaryFile.empty())
+      {
+         return mBinaryParser->ParseMapHeaderData(binaryFile, prefab);
+      }
+
       osgDB::Registry* reg = osgDB::Registry::instance();
       dtCore::RefPtr<MapReaderWriter::MapStream> mapStreamObject;
 
@@ -506,6 +545,10 @@ namespace dtCore
          return NULL;
       }
 
+      if (mUsedBinaryParser)
+      {
+         return mBinaryParser->GetMapBeingParsed();
+      }
       return mMapHandler->GetMap();
    }
 
@@ -517,24 +560,40 @@ namespace dtCore
          return NULL;
       }
 
+      if (mUsedBinaryParser)
+      {
+         return mBinaryParser->GetMapBeingParsed();
+      }
       return mMapHandler->GetMap();
    }
 
    /////////////////////////////////////////////////////////////////////////////
    const std::set<std::string>& MapParser::GetMissingActorTypes()
    {
+      if (mUsedBinaryParser)
+      {
+         return mBinaryParser->GetMissingActorTypes();
+      }
       return mMapHandler->GetMissingActorTypes();
    }
 
    /////////////////////////////////////////////////////////////////////////////
    const std::vector<std::string>& MapParser::GetMissingLibraries()
    {
+      if (mUsedBinaryParser)
+      {
+         return mBinaryParser->GetMissingLibraries();
+      }
       return mMapHandler->GetMissingLibraries();
    }
 
    /////////////////////////////////////////////////////////////////////////////
    bool MapParser::HasDeprecatedProperty() const
    {
+      if (mUsedBinaryParser)
+      {
+         return mBinaryParser->HasDeprecatedProperty();
+      }
       return mMapHandler->HasDeprecatedProperty();
    }
 
@@ -546,6 +605,7 @@ namespace dtCore
    MapWriter::MapWriter()
       : BaseXMLWriter()
       , mPropSerializer(NULL)
+      , mBinary(false)
    {
       mPropSerializer = new ActorPropertySerializer(this);
    }
@@ -567,9 +627,28 @@ namespace dtCore
       Save(map, stream, prefab);
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   void MapWriter::SetBinary(bool binary)
+   {
+      mBinary = binary;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool MapWriter::GetBinary() const
+   {
+      return mBinary;
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    void MapWriter::Save(Map& map, std::ostream& stream, bool prefab)
    {
+      if (mBinary)
+      {
+         dtCore::RefPtr<MapBinaryWriter> binaryWriter = new MapBinaryWriter();
+         binaryWriter->Save(map, stream, prefab);
+         return;
+      }
+
       map.CorrectLibraryList(false);
       mFormatTarget.SetOutputStream(&stream);
       mPropSerializer->Reset();
@@ -24,6 +24,8 @@
 
 #include <prefix/dtcoreprefix.h>
 #include <dtCore/objecttype.h>
+#include <dtCore/propertyschema.h>
+#include <OpenThreads/ScopedLock>
 
 #include <iostream>
 
@@ -200,6 +202,25 @@ namespace dtCore
       mDefaultValues[propName] = &defaultValue;
    }
 
+   ///////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<PropertySchema> ObjectType::GetPropertySchema() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPropertySchemaMutex);
+      return mPropertySchema;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<PropertySchema> ObjectType::SetPropertySchemaIfNotSet(PropertySchema& schema)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPropertySchemaMutex);
+      if (!mPropertySchema.valid())
+      {
+         schema.SetShared();
+         mPropertySchema = &schema;
+      }
+      return mPropertySchema;
+   }
+
    ///////////////////////////////////////////////////////////////////////////
    bool ObjectType::operator<(const ObjectType& rhs) const
    {
@@ -26,6 +26,11 @@
 #include <cassert>
 
 #include <osgDB/FileNameUtils>
+#include <osgDB/FileUtils>
+
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ReentrantMutex>
+#include <OpenThreads/ScopedLock>
 
 #include <dtCore/scene.h>
 
@@ -33,6 +38,8 @@
 #include <dtUtil/stringutils.h>
 #include <dtUtil/datapathutils.h>
 #include <dtUtil/fileutils.h>
+#include <dtUtil/hashmap.h>
+#include <dtUtil/threadpool.h>
 #include <dtUtil/wrapperosgobject.h>
 
 #include <dtCore/project.h>
@@ -60,6 +67,29 @@ namespace dtCore
    const std::string Project::MAP_DIRECTORY("maps");
    const std::string Project::MAP_BACKUP_SUB_DIRECTORY(".backups");
 
+   /////////////////////////////////////////////////////////////////////////////
+   // The directory of a resource category relative to a context.
+   static std::string GetCategoryRelativePath(const DataType& type, const std::string& category)
+   {
+      std::string result = type.GetName();
+      if (!category.empty())
+      {
+         result += dtUtil::FileUtils::PATH_SEPARATOR;
+         for (std::string::const_iterator i = category.begin(); i != category.end(); ++i)
+         {
+            if (*i == ResourceDescriptor::DESCRIPTOR_SEPARATOR)
+            {
+               result += dtUtil::FileUtils::PATH_SEPARATOR;
+            }
+            else
+            {
+               result += *i;
+            }
+         }
+      }
+      return result;
+   }
+
    struct MapFileData
    {
       std::string mOrigName;
@@ -67,12 +97,100 @@ namespace dtCore
       Project::ContextSlot mSlotId;
    };
 
+   // A file or directory found while indexing a context, keyed by its relative path.
+   // The keys keep the case on disk, so a lookup with a different case misses the index and
+   // falls back to the case insensitive search of the file system.
+   struct IndexedFile
+   {
+      dtUtil::FileType mFileType;
+      std::string mRelativePath;
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   // Lists everything under one top level directory of a context for the resource path index.
+   class ResourceIndexTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      typedef std::vector<std::pair<std::string, IndexedFile> > EntryList;
+
+      // Keeps a symbolic link loop from walking forever.
+      static const unsigned MAX_DEPTH = 32U;
+
+      ResourceIndexTask(const std::string& context, const std::string& relativeDir)
+      : mContext(context)
+      , mRelativeDir(relativeDir)
+      {
+      }
+
+      virtual void operator()()
+      {
+         Walk(mRelativeDir, 0U);
+      }
+
+      const EntryList& GetEntries() const { return mEntries; }
+
+   private:
+      void Walk(const std::string& relativeDir, unsigned depth)
+      {
+         if (depth > MAX_DEPTH)
+         {
+            return;
+         }
+
+         osgDB::DirectoryContents contents = osgDB::getDirectoryContents(mContext + dtUtil::FileUtils::PATH_SEPARATOR + relativeDir);
+         osgDB::DirectoryContents::const_iterator i, iend;
+         i = contents.begin();
+         iend = contents.end();
+         for (; i != iend; ++i)
+         {
+            if (*i == "." || *i == "..")
+            {
+               continue;
+            }
+
+            IndexedFile entry;
+            entry.mRelativePath = relativeDir + dtUtil::FileUtils::PATH_SEPARATOR + *i;
+
+            osgDB::FileType type = osgDB::fileType(mContext + dtUtil::FileUtils::PATH_SEPARATOR + entry.mRelativePath);
+            if (type == osgDB::DIRECTORY)
+            {
+               entry.mFileType = dtUtil::DIRECTORY;
+            }
+            else if (type == osgDB::REGULAR_FILE)
+            {
+               entry.mFileType = dtUtil::REGULAR_FILE;
+            }
+            else
+            {
+               continue;
+            }
+
+            mEntries.push_back(std::make_pair(entry.mRelativePath, entry));
+
+            if (entry.mFileType == dtUtil::DIRECTORY)
+            {
+               Walk(entry.mRelativePath, depth + 1U);
+            }
+         }
+      }
+
+      std::string mContext;
+      std::string mRelativeDir;
+      EntryList mEntries;
+   };
+
    class ProjectImpl {
    public:
       ProjectImpl()
       : mContextReadOnly(true)
       , mResourcesIndexed(false)
       , mEditMode(false)
+      , mSaveMapsAsBinary(false)
+      , mResourcePathCacheEnabled(true)
+      , mFileIndexBuilt(false)
+      , mFileIndexGeneration(0U)
+      , mResourcePathCacheHits(0U)
+      , mResourcePathCacheMisses(0U)
       {
          libraryManager = &ActorFactory::GetInstance();
          mLogger = &dtUtil::Log::GetInstance(Project::LOG_NAME);
@@ -94,6 +212,8 @@ namespace dtCore
       //set to true if we are running via stage - banderegg
       bool mEditMode;
 
+      bool mSaveMapsAsBinary;
+
       typedef std::map<std::string, MapFileData> MapListType;
       MapListType mMapList; //< The list of maps by name mapped to the file names.
       mutable std::set<std::string> mMapNames; //< The list of map names.
@@ -111,10 +231,45 @@ namespace dtCore
 
       dtUtil::Log* mLogger;
 
+      // Resolved resource paths and an index of the files in each context so GetResourcePath
+      // doesn't have to go to the file system.  All of it is guarded by mResourcePathMutex.
+      typedef dtUtil::HashMap<std::string, IndexedFile> ContextFileIndex;
+      typedef dtUtil::HashMap<std::string, std::string> ResolvedPathCache;
+      bool mResourcePathCacheEnabled;
+      mutable bool mFileIndexBuilt;
+      // Incremented on every clear so an index built while the cache was cleared is thrown away.
+      unsigned mFileIndexGeneration;
+      mutable std::vector<ContextFileIndex> mFileIndex;
+      mutable ResolvedPathCache mResolvedFilePaths;
+      mutable ResolvedPathCache mResolvedCategoryPaths;
+      mutable unsigned mResourcePathCacheHits;
+      mutable unsigned mResourcePathCacheMisses;
+      mutable OpenThreads::Mutex mResourcePathMutex;
+
+      // See Project::GetMutex.
+      mutable OpenThreads::ReentrantMutex mProjectMutex;
+
+      // Drops the resolved paths and the file index so they are rebuilt on the next lookup.
+      void ClearResourcePathCache();
+      // Re-reads one file or directory of a context into the file index after the project changed it
+      // and drops the resolved paths, so the rest of the index doesn't have to be walked again.
+      void UpdateIndexedPath(Project::ContextSlot slot, const std::string& relativePath);
+      // Indexes a context that was just added, if the other contexts are already indexed.
+      void IndexAddedContext(Project::ContextSlot slot);
+      // Removes the index for a context that was just removed.
+      void RemoveContextFromIndex(Project::ContextSlot slot);
+      // Lists the files in the given contexts, one index per context.  It doesn't lock because it
+      // may run tasks from the thread pool that themselves look up resources.
+      void BuildFileIndex(const std::vector<std::string>& contexts, std::vector<ContextFileIndex>& indexOut) const;
+      // Searches the contexts in order for the resource path.  It uses the file index if useIndex is true, otherwise the file system.
+      dtUtil::FileType FindResource(const std::string& path, bool isCategory, bool useIndex, std::string& fileNameOut, bool& foundADirOut) const;
+
       // Internal context add that doesn't refresh
       Project::ContextSlot InternalAddContext(const std::string& path);
       // Internal context remove that doesn't refresh
       void InternalRemoveContext(Project::ContextSlot slot);
+      // Reloads the map list and clears the resource tree, but leaves the resource path cache alone.
+      void RefreshMapsAndResources();
 
       std::string InternalSaveMapOrPrefab(Map& map, const std::string& categoryPath, Project::ContextSlot slot, bool prefab);
 
@@ -205,6 +360,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void Project::SetupFromProjectConfig(const ProjectConfig& config)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       ClearAllContexts();
 
       SetReadOnly(config.GetReadOnly());
@@ -352,6 +508,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void Project::SetContext(const std::string& path, bool openReadOnly)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       ClearAllContexts();
 
       SetReadOnly(openReadOnly);
@@ -362,8 +519,16 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    Project::ContextSlot Project::AddContext(const std::string& path)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       Project::ContextSlot slot = mImpl->InternalAddContext(path);
-      Refresh();
+      if (!IsContextValid())
+      {
+         throw dtCore::ProjectInvalidContextException(
+         std::string("The context is not valid."), __FILE__, __LINE__);
+      }
+
+      // Only the new context needs indexing, so the resource path cache is kept.
+      mImpl->RefreshMapsAndResources();
       return slot;
    }
 
@@ -433,6 +598,8 @@ namespace dtCore
 
       dtUtil::SetDataFilePathList(searchPath + ':' + context);
 
+      IndexAddedContext(mContexts.size() - 1U);
+
       return mContexts.size() - 1U;
 
    }
@@ -440,10 +607,17 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void Project::RemoveContext(ContextSlot slot)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       if (slot < GetContextSlotCount() )
       {
          mImpl->InternalRemoveContext(slot);
-         Refresh();
+         if (!IsContextValid())
+         {
+            throw dtCore::ProjectInvalidContextException(
+            std::string("The context is not valid."), __FILE__, __LINE__);
+         }
+
+         mImpl->RefreshMapsAndResources();
       }
    }
 
@@ -464,12 +638,14 @@ namespace dtCore
             dtUtil::SetDataFilePathList(searchPath);
          }
          mContexts.erase(mContexts.begin() + slot);
+         RemoveContextFromIndex(slot);
       }
    }
 
    /////////////////////////////////////////////////////////////////////////////
    void Project::ClearAllContexts()
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       mImpl->mOpenMaps.clear();
       //clear the references to all the open maps
       mImpl->mMapList.clear();
@@ -478,6 +654,7 @@ namespace dtCore
       //clear out the list of mResources.
       mImpl->mResources.clear();
       mImpl->mResourcesIndexed = false;
+      mImpl->ClearResourcePathCache();
 
       while (!mImpl->mContexts.empty())
       {
@@ -543,21 +720,30 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void Project::Refresh()
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       if (!IsContextValid())
       {
          throw dtCore::ProjectInvalidContextException(
          std::string("The context is not valid."), __FILE__, __LINE__);
       }
 
+      mImpl->RefreshMapsAndResources();
+      // Files may have been changed by hand, so the whole index has to be walked again.
+      mImpl->ClearResourcePathCache();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void ProjectImpl::RefreshMapsAndResources()
+   {
       //clear the references to all the open maps
-      mImpl->mMapList.clear();
-      mImpl->mMapNames.clear();
-      mImpl->mMapTree.clear();
-      GetMapNames();
+      mMapList.clear();
+      mMapNames.clear();
+      mMapTree.clear();
+      GenerateMapList();
 
       //clear out the list of mResources.
-      mImpl->mResources.clear();
-      mImpl->mResourcesIndexed = false;
+      mResources.clear();
+      mResourcesIndexed = false;
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -918,6 +1104,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    Map& Project::GetMap(const std::string& name)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       if (!IsContextValid())
       {
          throw dtCore::ProjectInvalidContextException(
@@ -951,12 +1138,14 @@ namespace dtCore
    //////////////////////////////////////////////////////////////////////////
    bool Project::IsMapOpen(const std::string& name)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       return mImpl->mOpenMaps.find(name) != mImpl->mOpenMaps.end();
    }
 
    //////////////////////////////////////////////////////////////////////////
    std::vector<Map*> Project::GetOpenMaps()
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       std::vector<Map*> maps;
       std::map<std::string, dtCore::RefPtr<Map> >::iterator iter;
       for (iter = mImpl->mOpenMaps.begin(); iter != mImpl->mOpenMaps.end(); ++iter)
@@ -969,6 +1158,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    Map& Project::OpenMapBackup(const std::string& name)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       if (!IsContextValid())
       {
          throw dtCore::ProjectInvalidContextException(
@@ -1004,6 +1194,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    Map& Project::CreateMap(const std::string& name, const std::string& fileName, ContextSlot slot)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       if (slot == DEFAULT_SLOT_VALUE)
       {
          slot = 0;
@@ -1375,6 +1566,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void Project::CloseMap(Map& map, bool unloadLibraries)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       if (!IsContextValid())
       {
          throw dtCore::ProjectInvalidContextException(
@@ -1397,6 +1589,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void Project::CloseAllMaps(bool unloadLibraries)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       std::map<std::string, dtCore::RefPtr<Map> >::iterator mapIter = mImpl->mOpenMaps.begin();
       std::map<std::string, dtCore::RefPtr<Map> >::iterator mapIterEnd = mImpl->mOpenMaps.end();
       while (mapIter != mapIterEnd)
@@ -1412,6 +1605,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void Project::DeleteMap(Map& map, bool unloadLibraries)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       if (!IsContextValid())
       {
          throw dtCore::ProjectInvalidContextException(
@@ -1445,6 +1639,7 @@ namespace dtCore
    /////////////////////////////////////////////////////////////////////////////
    void Project::DeleteMap(const std::string& mapName, bool unloadLibraries)
    {
+      OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(mImpl->mProjectMutex);
       if (!IsContextValid())
       {
          throw dtCore::ProjectInvalidContextException(
@@ -1492,7 +1687,8 @@ namespace dtCore
       ReloadMapNames();
 
       dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
-      dtUtil::DirectoryPush dp(GetMapsDirectory(mContexts[mapFileData.mSlotId], false).fileName);
+      dtUtil::FileInfo mapsDir = GetMapsDirectory(mContexts[mapFileData.mSlotId], false);
+      dtUtil::DirectoryPush dp(mapsDir.fileName);
       if (fileUtils.FileExists(mapFileData.mFileName))
       {
          fileUtils.FileDelete(mapFileData.mFileName);
@@ -1502,6 +1698,8 @@ namespace dtCore
          mLogger->LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
                              "Specified map was part of the project, but the map file did not exist.");
       }
+
+      UpdateIndexedPath(mapFileData.mSlotId, mapsDir.baseName + dtUtil::FileUtils::PATH_SEPARATOR + mapFileData.mFileName);
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -1692,6 +1890,7 @@ namespace dtCore
       //save the file to a separate name first so that
       //it won't blast the old one unless it is successful.
       dtCore::RefPtr<MapWriter> writer = new MapWriter();
+      writer->SetBinary(mSaveMapsAsBinary);
       writer->Save(map, fullPathSaving, prefab);
       return fullPathSaving;
    }
@@ -1710,12 +1909,14 @@ namespace dtCore
          }
       }
 
-      std::string mapDir = GetMapsDirectory(mContexts[slot], true).fileName;
+      dtUtil::FileInfo mapsDirInfo = GetMapsDirectory(mContexts[slot], true);
+      std::string mapDir = mapsDirInfo.fileName;
 
       std::string finalPath = mapDir + dtUtil::FileUtils::PATH_SEPARATOR + map.GetFileName();
 
       dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
       fileUtils.FileMove(InternalSaveMapOrPrefab(map, mapDir, slot, false), finalPath, true);
+      UpdateIndexedPath(slot, mapsDirInfo.baseName + dtUtil::FileUtils::PATH_SEPARATOR + map.GetFileName());
 
       //Update the internal lists to make sure that
       //map is keyed properly by name.
@@ -1785,6 +1986,7 @@ namespace dtCore
       //save the file to a "saving" file so that if it blows or is killed while saving, the data
       //will not be lost.
       dtCore::RefPtr<MapWriter> writer = new MapWriter();
+      writer->SetBinary(mImpl->mSaveMapsAsBinary);
       writer->Save(map, fileName);
 
 
@@ -1792,6 +1994,18 @@ namespace dtCore
       fileUtils.FileMove(fileName, finalFileName, true);
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   void Project::SetSaveMapsAsBinary(bool binary)
+   {
+      mImpl->mSaveMapsAsBinary = binary;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool Project::GetSaveMapsAsBinary() const
+   {
+      return mImpl->mSaveMapsAsBinary;
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    bool Project::HasBackup(Map& map) const
    {
@@ -2124,7 +2338,84 @@ namespace dtCore
 
       const std::string& path = mImpl->mResourceHelper.GetResourcePath(resource);
 
+      ProjectImpl::ResolvedPathCache& resolvedPaths = isCategory ? mImpl->mResolvedCategoryPaths : mImpl->mResolvedFilePaths;
+      if (mImpl->mResourcePathCacheEnabled)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImpl->mResourcePathMutex);
+         ProjectImpl::ResolvedPathCache::const_iterator found = resolvedPaths.find(resource.GetResourceIdentifier());
+         if (found != resolvedPaths.end())
+         {
+            ++mImpl->mResourcePathCacheHits;
+            return found->second;
+         }
+         ++mImpl->mResourcePathCacheMisses;
+      }
+
+      dtUtil::FileType expectedType = dtUtil::REGULAR_FILE;
+      if (isCategory)
+      {
+         expectedType = dtUtil::DIRECTORY;
+      }
+
+      //for proper error handling.
+      bool foundADir = false;
+
+      std::string resultFileName;
+
+      dtUtil::FileType ftype = mImpl->FindResource(path, isCategory, mImpl->mResourcePathCacheEnabled, resultFileName, foundADir);
+
+      // Files added behind the project's back aren't in the index, so check the disk before giving up.
+      if (ftype != expectedType && mImpl->mResourcePathCacheEnabled)
+      {
+         foundADir = false;
+         ftype = mImpl->FindResource(path, isCategory, false, resultFileName, foundADir);
+      }
+
+      if (ftype != expectedType)
+      {
 
+         if (!isCategory)
+         {
+            if (!foundADir)
+            {
+               throw ProjectFileNotFoundException(
+                  std::string("The specified resource was not found: [") + path + "]", __FILE__, __LINE__);
+            }
+            else
+            {
+               throw ProjectResourceErrorException(
+                      std::string("The resource identifier specifies a category or directory: ") + path, __FILE__, __LINE__);
+            }
+         }
+         else
+         {
+            if (ftype == dtUtil::FILE_NOT_FOUND)
+            {
+               throw ProjectFileNotFoundException(
+                  std::string("The specified resource was not found: [") + path + "]", __FILE__, __LINE__);
+            }
+            else
+            {
+               throw ProjectResourceErrorException(
+                      std::string("The resource identifier specifies a regular file, not a category/directory: ") + path, __FILE__, __LINE__);
+            }
+         }
+
+      }
+
+      if (mImpl->mResourcePathCacheEnabled)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mImpl->mResourcePathMutex);
+         resolvedPaths[resource.GetResourceIdentifier()] = resultFileName;
+      }
+
+      return resultFileName;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   dtUtil::FileType ProjectImpl::FindResource(const std::string& path, bool isCategory, bool useIndex,
+            std::string& fileNameOut, bool& foundADirOut) const
+   {
       dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
 
       // Init to file not found.
@@ -2136,18 +2427,56 @@ namespace dtCore
          expectedType = dtUtil::DIRECTORY;
       }
 
-      //for proper error handling.
-      bool foundADir = false;
+      std::string indexKey;
+      if (useIndex)
+      {
+         indexKey = path;
 
-      dtUtil::FileInfo resultInfo;
+         bool built;
+         unsigned generation;
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mResourcePathMutex);
+            built = mFileIndexBuilt;
+            generation = mFileIndexGeneration;
+         }
 
-      std::vector<std::string>::const_iterator i, iend;
-      i = mImpl->mContexts.begin();
-      iend = mImpl->mContexts.end();
-      for (; i != iend && ftype != expectedType; ++i)
+         if (!built)
+         {
+            std::vector<ContextFileIndex> newIndex;
+            BuildFileIndex(mContexts, newIndex);
+
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mResourcePathMutex);
+            if (!mFileIndexBuilt && generation == mFileIndexGeneration)
+            {
+               mFileIndex.swap(newIndex);
+               mFileIndexBuilt = true;
+            }
+         }
+      }
+
+      for (unsigned slot = 0; slot < mContexts.size() && ftype != expectedType; ++slot)
       {
-         resultInfo = fileUtils.GetFileInfo(*i + dtUtil::FileUtils::PATH_SEPARATOR + path, true);
-         ftype = resultInfo.fileType;
+         const std::string& context = mContexts[slot];
+         if (useIndex)
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mResourcePathMutex);
+            ftype = dtUtil::FILE_NOT_FOUND;
+            if (slot < mFileIndex.size())
+            {
+               ContextFileIndex::const_iterator found = mFileIndex[slot].find(indexKey);
+               if (found != mFileIndex[slot].end())
+               {
+                  ftype = found->second.mFileType;
+                  fileNameOut = context + dtUtil::FileUtils::PATH_SEPARATOR + found->second.mRelativePath;
+               }
+            }
+         }
+         else
+         {
+            dtUtil::FileInfo resultInfo = fileUtils.GetFileInfo(context + dtUtil::FileUtils::PATH_SEPARATOR + path, true);
+            ftype = resultInfo.fileType;
+            fileNameOut = resultInfo.fileName;
+         }
 
          if (ftype == dtUtil::DIRECTORY)
          {
@@ -2155,7 +2484,7 @@ namespace dtCore
             {
                // didn't find the resource, but found a directory with that same name.
                // This is only an error if no file is found in a later path.
-               foundADir = true;
+               foundADirOut = true;
             }
          }
 
@@ -2168,39 +2497,298 @@ namespace dtCore
          }
       }
 
-      if (ftype != expectedType)
-      {
+      return ftype;
+   }
 
-         if (!isCategory)
+   /////////////////////////////////////////////////////////////////////////////
+   void ProjectImpl::BuildFileIndex(const std::vector<std::string>& contexts, std::vector<ContextFileIndex>& indexOut) const
+   {
+      typedef std::vector<std::pair<unsigned, dtCore::RefPtr<ResourceIndexTask> > > TaskList;
+      TaskList tasks;
+
+      indexOut.clear();
+      indexOut.resize(contexts.size());
+
+      // One task per top level directory, so the resource type folders are walked in parallel.
+      for (unsigned slot = 0; slot < contexts.size(); ++slot)
+      {
+         const std::string& context = contexts[slot];
+         osgDB::DirectoryContents contents = osgDB::getDirectoryContents(context);
+         osgDB::DirectoryContents::const_iterator i, iend;
+         i = contents.begin();
+         iend = contents.end();
+         for (; i != iend; ++i)
          {
-            if (!foundADir)
+            if (*i == "." || *i == "..")
             {
-               throw ProjectFileNotFoundException(
-                  std::string("The specified resource was not found: [") + path + "]", __FILE__, __LINE__);
+               continue;
+            }
+
+            IndexedFile entry;
+            entry.mRelativePath = *i;
+            osgDB::FileType type = osgDB::fileType(context + dtUtil::FileUtils::PATH_SEPARATOR + *i);
+            if (type == osgDB::DIRECTORY)
+            {
+               entry.mFileType = dtUtil::DIRECTORY;
+               tasks.push_back(std::make_pair(slot, new ResourceIndexTask(context, *i)));
+            }
+            else if (type == osgDB::REGULAR_FILE)
+            {
+               entry.mFileType = dtUtil::REGULAR_FILE;
             }
             else
             {
-               throw ProjectResourceErrorException(
-                      std::string("The resource identifier specifies a category or directory: ") + path, __FILE__, __LINE__);
+               continue;
             }
+
+            indexOut[slot][*i] = entry;
+         }
+      }
+
+      // Without worker threads, immediate tasks only run in ExecuteTasks, which would also run unrelated work.
+      bool threaded = dtUtil::ThreadPool::HasImmediateWorkerThreads();
+      TaskList::iterator ti, tiend;
+      tiend = tasks.end();
+      for (ti = tasks.begin(); ti != tiend; ++ti)
+      {
+         // The calling thread walks the first directory itself.
+         if (threaded && ti != tasks.begin())
+         {
+            dtUtil::ThreadPool::AddTask(*ti->second);
+         }
+      }
+
+      for (ti = tasks.begin(); ti != tiend; ++ti)
+      {
+         if (threaded && ti != tasks.begin())
+         {
+            ti->second->WaitUntilComplete();
          }
          else
          {
-            if (ftype == dtUtil::FILE_NOT_FOUND)
-            {
-               throw ProjectFileNotFoundException(
-                  std::string("The specified resource was not found: [") + path + "]", __FILE__, __LINE__);
-            }
-            else
+            (*ti->second)();
+         }
+
+         ContextFileIndex& index = indexOut[ti->first];
+         const ResourceIndexTask::EntryList& entries = ti->second->GetEntries();
+         ResourceIndexTask::EntryList::const_iterator ei, eiend;
+         ei = entries.begin();
+         eiend = entries.end();
+         for (; ei != eiend; ++ei)
+         {
+            index[ei->first] = ei->second;
+         }
+      }
+
+      if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+      {
+         size_t count = 0;
+         for (unsigned slot = 0; slot < indexOut.size(); ++slot)
+         {
+            count += indexOut[slot].size();
+         }
+         std::ostringstream ss;
+         ss << "Indexed " << count << " files and directories in " << contexts.size() << " project contexts.";
+         mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__, ss.str());
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void ProjectImpl::ClearResourcePathCache()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mResourcePathMutex);
+      mFileIndex.clear();
+      mFileIndexBuilt = false;
+      ++mFileIndexGeneration;
+      mResolvedFilePaths.clear();
+      mResolvedCategoryPaths.clear();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void ProjectImpl::UpdateIndexedPath(Project::ContextSlot slot, const std::string& relativePath)
+   {
+      // Read the disk before taking the lock so lookups aren't blocked by the walk.
+      IndexedFile entry;
+      entry.mFileType = dtUtil::FILE_NOT_FOUND;
+      entry.mRelativePath = relativePath;
+      dtCore::RefPtr<ResourceIndexTask> walk;
+      if (slot < mContexts.size())
+      {
+         const std::string& context = mContexts[slot];
+         osgDB::FileType type = osgDB::fileType(context + dtUtil::FileUtils::PATH_SEPARATOR + relativePath);
+         if (type == osgDB::DIRECTORY)
+         {
+            entry.mFileType = dtUtil::DIRECTORY;
+            walk = new ResourceIndexTask(context, relativePath);
+            (*walk)();
+         }
+         else if (type == osgDB::REGULAR_FILE)
+         {
+            entry.mFileType = dtUtil::REGULAR_FILE;
+         }
+      }
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mResourcePathMutex);
+      mResolvedFilePaths.clear();
+      mResolvedCategoryPaths.clear();
+
+      if (!mFileIndexBuilt)
+      {
+         // An index being built right now may have listed the context before the change.
+         ++mFileIndexGeneration;
+         return;
+      }
+
+      if (slot >= mFileIndex.size())
+      {
+         return;
+      }
+
+      ContextFileIndex& index = mFileIndex[slot];
+
+      ContextFileIndex::iterator found = index.find(relativePath);
+      if (found != index.end())
+      {
+         bool wasDir = found->second.mFileType == dtUtil::DIRECTORY;
+         index.erase(found);
+         if (wasDir)
+         {
+            const std::string prefix = relativePath + dtUtil::FileUtils::PATH_SEPARATOR;
+            ContextFileIndex::iterator i = index.begin();
+            while (i != index.end())
             {
-               throw ProjectResourceErrorException(
-                      std::string("The resource identifier specifies a regular file, not a category/directory: ") + path, __FILE__, __LINE__);
+               if (i->first.compare(0, prefix.size(), prefix) == 0)
+               {
+                  index.erase(i++);
+               }
+               else
+               {
+                  ++i;
+               }
             }
          }
+      }
+
+      if (entry.mFileType == dtUtil::FILE_NOT_FOUND)
+      {
+         return;
+      }
+
+      index[relativePath] = entry;
 
+      // A new file may have created its parent directories, too.
+      IndexedFile parent;
+      parent.mFileType = dtUtil::DIRECTORY;
+      std::string::size_type sep = relativePath.rfind(dtUtil::FileUtils::PATH_SEPARATOR);
+      while (sep != std::string::npos && sep > 0)
+      {
+         parent.mRelativePath = relativePath.substr(0, sep);
+         if (index.find(parent.mRelativePath) != index.end())
+         {
+            break;
+         }
+         index[parent.mRelativePath] = parent;
+         sep = relativePath.rfind(dtUtil::FileUtils::PATH_SEPARATOR, sep - 1);
       }
 
-      return resultInfo.fileName;
+      if (walk.valid())
+      {
+         const ResourceIndexTask::EntryList& entries = walk->GetEntries();
+         ResourceIndexTask::EntryList::const_iterator ei, eiend;
+         ei = entries.begin();
+         eiend = entries.end();
+         for (; ei != eiend; ++ei)
+         {
+            index[ei->first] = ei->second;
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void ProjectImpl::IndexAddedContext(Project::ContextSlot slot)
+   {
+      unsigned generation;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mResourcePathMutex);
+         if (!mFileIndexBuilt)
+         {
+            // Nothing is indexed yet, so the new context is picked up on the first lookup.
+            ++mFileIndexGeneration;
+            return;
+         }
+         generation = mFileIndexGeneration;
+      }
+
+      std::vector<ContextFileIndex> newIndex;
+      BuildFileIndex(std::vector<std::string>(1U, mContexts[slot]), newIndex);
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mResourcePathMutex);
+      if (mFileIndexBuilt && generation == mFileIndexGeneration && mFileIndex.size() == slot)
+      {
+         mFileIndex.push_back(ContextFileIndex());
+         mFileIndex.back().swap(newIndex.front());
+      }
+      else
+      {
+         mFileIndex.clear();
+         mFileIndexBuilt = false;
+         ++mFileIndexGeneration;
+         mResolvedFilePaths.clear();
+         mResolvedCategoryPaths.clear();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void ProjectImpl::RemoveContextFromIndex(Project::ContextSlot slot)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mResourcePathMutex);
+      // Paths resolved to the removed context, or past it, are stale.
+      mResolvedFilePaths.clear();
+      mResolvedCategoryPaths.clear();
+      if (mFileIndexBuilt && slot < mFileIndex.size())
+      {
+         mFileIndex.erase(mFileIndex.begin() + slot);
+      }
+      else
+      {
+         mFileIndex.clear();
+         mFileIndexBuilt = false;
+         ++mFileIndexGeneration;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Project::RefreshResourcePathCache()
+   {
+      mImpl->ClearResourcePathCache();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void Project::SetResourcePathCacheEnabled(bool enabled)
+   {
+      if (!enabled)
+      {
+         mImpl->ClearResourcePathCache();
+      }
+      mImpl->mResourcePathCacheEnabled = enabled;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool Project::GetResourcePathCacheEnabled() const
+   {
+      return mImpl->mResourcePathCacheEnabled;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned Project::GetResourcePathCacheHits() const
+   {
+      return mImpl->mResourcePathCacheHits;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned Project::GetResourcePathCacheMisses() const
+   {
+      return mImpl->mResourcePathCacheMisses;
    }
 
 
@@ -2251,7 +2839,8 @@ namespace dtCore
          }
 
          // TODO see what this does if it thinks it has this resource already.
-         mImpl->mResourceHelper.CreateResourceCategory(category, type, curSlot, dataTypeTree, categoryInTree);
+         const std::string categoryPath = mImpl->mResourceHelper.CreateResourceCategory(category, type, curSlot, dataTypeTree, categoryInTree);
+         mImpl->UpdateIndexedPath(ContextSlot(i - mImpl->mContexts.begin()), categoryPath);
          ++curSlot;
       }
    }
@@ -2299,6 +2888,8 @@ namespace dtCore
       // some.
       bool result = true;
 
+      const std::string categoryPath = GetCategoryRelativePath(type, category);
+
       for (; i != iend; ++i)
       {
          dtUtil::DirectoryPush dp(*i);
@@ -2310,6 +2901,7 @@ namespace dtCore
 
          // TODO see what it does if it things it's already removed it.
          result = result && mImpl->mResourceHelper.RemoveResourceCategory(category, type, recursive, dataTypeTree);
+         mImpl->UpdateIndexedPath(ContextSlot(i - mImpl->mContexts.begin()), categoryPath);
       }
       return result;
 
@@ -2360,6 +2952,8 @@ namespace dtCore
          dataTypeTree = &mImpl->GetResourcesOfType(type);
 
       result = mImpl->mResourceHelper.AddResource(newName, pathToFile, category, type, dataTypeTree, slot);
+      // Importing may copy more than the one file, so the whole category is indexed again.
+      mImpl->UpdateIndexedPath(slot, GetCategoryRelativePath(type, category));
 
       return result;
    }
@@ -2387,6 +2981,14 @@ namespace dtCore
          last = GetContextSlotCount();
       }
 
+      // The handler may remove more than the one file, so the whole category is indexed again.
+      std::string categoryPath = mImpl->mResourceHelper.GetResourcePath(resource);
+      std::string::size_type lastSep = categoryPath.rfind(dtUtil::FileUtils::PATH_SEPARATOR);
+      if (lastSep != std::string::npos)
+      {
+         categoryPath.erase(lastSep);
+      }
+
       for (ContextSlot i = first; i < last; ++i)
       {
          dtUtil::DirectoryPush dp(mImpl->mContexts[i]);
@@ -2397,6 +2999,7 @@ namespace dtCore
          }
 
          mImpl->mResourceHelper.RemoveResource(resource, resourceTree);
+         mImpl->UpdateIndexedPath(i, categoryPath);
       }
    }
 
@@ -2549,4 +3152,10 @@ namespace dtCore
    {
       return mImpl->mParser.get();
    }
+
+   /////////////////////////////////////////////////////////////////////////////
+   OpenThreads::ReentrantMutex& Project::GetMutex() const
+   {
+      return mImpl->mProjectMutex;
+   }
 }
@@ -44,6 +44,8 @@ namespace dtCore
    ////////////////////////////////////////////////////////////////////////////////
    void PropertyContainer::InitDefaults()
    {
+      SharePropertySchema();
+
       // Must const cast to be able to set the defaults.
       ObjectType& type = const_cast<ObjectType&>(GetObjectType());
 
@@ -83,23 +85,21 @@ namespace dtCore
             "AddProperty cannot add a NULL property", __FILE__, __LINE__);
       }
 
-      PropertyMapType::iterator itor =
-         mPropertyMap.find(newProp->GetName());
-      if(itor != mPropertyMap.end())
+      if (mSchema.valid() && mSchema->GetIndex(newProp->GetName()) >= 0)
       {
          LOGN_ERROR("propertycontainer.cpp", "Could not add new property " + newProp->GetName() + " because a property with that name already exists.");
       }
       else
       {
-         mPropertyMap.insert(std::make_pair(dtUtil::RefString(newProp->GetName()),newProp));
-
          if (index >= 0 && index < (int)mProperties.size())
          {
             mProperties.insert(mProperties.begin() + index, newProp);
+            RebuildSchema();
          }
          else
          {
             mProperties.push_back(newProp);
+            GetWritableSchema().AddName(newProp->GetName());
          }
       }
    }
@@ -108,31 +108,22 @@ namespace dtCore
    void PropertyContainer::RemoveProperty(ActorProperty* toRemove)
    {
       if (toRemove == NULL) return;
-      PropertyMapType::iterator itor =
-         mPropertyMap.find(toRemove->GetName());
-      if (itor != mPropertyMap.end() && itor->second == toRemove)
+      int index = GetPropertyIndex(toRemove->GetName());
+      if (index >= 0 && mProperties[index] == toRemove)
       {
-         mPropertyMap.erase(itor);
-         mProperties.erase(std::remove(mProperties.begin(), mProperties.end(), dtCore::RefPtr<ActorProperty>(toRemove)), mProperties.end());
+         mProperties.erase(mProperties.begin() + index);
+         RebuildSchema();
       }
    }
 
    ///////////////////////////////////////////////////////////////////////////////////////
    void PropertyContainer::RemoveProperty(const std::string& nameToRemove)
    {
-      PropertyMapType::iterator itor =
-         mPropertyMap.find(nameToRemove);
-      if (itor != mPropertyMap.end())
+      int index = GetPropertyIndex(nameToRemove);
+      if (index >= 0)
       {
-         mPropertyMap.erase(itor);
-         for (size_t i = 0; i < mProperties.size(); ++i)
-         {
-            if (mProperties[i]->GetName() == nameToRemove)
-            {
-               mProperties.erase(mProperties.begin() + i);
-               break;
-            }
-         }
+         mProperties.erase(mProperties.begin() + index);
+         RebuildSchema();
       }
       else
       {
@@ -143,32 +134,89 @@ namespace dtCore
    ///////////////////////////////////////////////////////////////////////////////////////
    ActorProperty* PropertyContainer::GetProperty(const std::string& name)
    {
-      PropertyMapType::iterator itor =
-         mPropertyMap.find(name);
+      int index = GetPropertyIndex(name);
+      return index < 0 ? NULL : mProperties[index].get();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   const ActorProperty* PropertyContainer::GetProperty(const std::string& name) const
+   {
+      int index = GetPropertyIndex(name);
+      return index < 0 ? NULL : mProperties[index].get();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   int PropertyContainer::GetPropertyIndex(const std::string& name) const
+   {
+      return mSchema.valid() ? mSchema->GetIndex(name) : -1;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   ActorProperty* PropertyContainer::GetPropertyByIndex(unsigned index)
+   {
+      return index < mProperties.size() ? mProperties[index].get() : NULL;
+   }
 
-      if (itor == mPropertyMap.end())
+   ///////////////////////////////////////////////////////////////////////////////////////
+   const ActorProperty* PropertyContainer::GetPropertyByIndex(unsigned index) const
+   {
+      return index < mProperties.size() ? mProperties[index].get() : NULL;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   const PropertySchema* PropertyContainer::GetPropertySchema() const
+   {
+      return mSchema.get();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////////////
+   PropertySchema& PropertyContainer::GetWritableSchema()
+   {
+      if (!mSchema.valid())
       {
-         return NULL;
+         mSchema = new PropertySchema;
       }
-      else
+      else if (mSchema->IsShared())
       {
-         return itor->second.get();
+         mSchema = new PropertySchema(*mSchema);
       }
+      return *mSchema;
    }
 
    ///////////////////////////////////////////////////////////////////////////////////////
-   const ActorProperty* PropertyContainer::GetProperty(const std::string& name) const
+   void PropertyContainer::RebuildSchema()
    {
-      PropertyMapType::const_iterator itor =
-         mPropertyMap.find(name);
+      std::vector<dtUtil::RefString> names;
+      names.reserve(mProperties.size());
+      for (size_t i = 0; i < mProperties.size(); ++i)
+      {
+         names.push_back(mProperties[i]->GetName());
+      }
+
+      mSchema = new PropertySchema;
+      mSchema->SetNames(names);
+   }
 
-      if (itor == mPropertyMap.end())
+   ///////////////////////////////////////////////////////////////////////////////////////
+   void PropertyContainer::SharePropertySchema()
+   {
+      if (!mSchema.valid() || mSchema->IsShared())
       {
-         return NULL;
+         return;
       }
-      else
+
+      // Must const cast to be able to set the schema.
+      ObjectType& type = const_cast<ObjectType&>(GetObjectType());
+      dtCore::RefPtr<PropertySchema> typeSchema = type.GetPropertySchema();
+      if (!typeSchema.valid())
+      {
+         typeSchema = type.SetPropertySchemaIfNotSet(*mSchema);
+      }
+
+      // Containers that added or removed properties keep their own.
+      if (typeSchema->Matches(mProperties))
       {
-         return itor->second.get();
+         mSchema = typeSchema;
       }
    }
 
@@ -278,9 +326,21 @@ namespace dtCore
    void PropertyContainer::CopyPropertiesFrom(const PropertyContainer& copyFrom, bool copyMetadata)
    {
       //Now copy all of the properties from this proxy to the clone.
+      // Containers with the same schema have the same properties in the same order.
+      const bool sameSchema = mSchema.valid() && mSchema == copyFrom.mSchema;
       for (size_t i = 0; i < mProperties.size(); ++i)
       {
-         const ActorProperty* prop = copyFrom.GetProperty(mProperties[i]->GetName());
+         const ActorProperty* prop = NULL;
+         if (sameSchema)
+         {
+            prop = copyFrom.mProperties[i].get();
+         }
+         else if (copyFrom.mSchema.valid())
+         {
+            int index = copyFrom.mSchema->GetIndex(mProperties[i]->GetName());
+            prop = index < 0 ? NULL : copyFrom.mProperties[index].get();
+         }
+
          if (prop != nullptr)
          {
             if (!prop->IsReadOnly())
@@ -0,0 +1,150 @@
+/* -*-c++-*-
+ * Delta3D
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <prefix/dtcoreprefix.h>
+#include <dtCore/propertyschema.h>
+#include <dtUtil/hash.h>
+
+namespace dtCore
+{
+   /// The smallest table.  The table is kept at least twice the size of the name list so the probe sequences stay short.
+   static const size_t MIN_TABLE_SIZE = 16;
+
+   ////////////////////////////////////////////////////////////////////////////////
+   // The string hash is weak in the low bits, so fold in some higher ones.
+   static inline size_t FirstSlot(size_t hash, size_t mask)
+   {
+      return (hash ^ (hash >> 11)) & mask;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   PropertySchema::PropertySchema()
+   : osg::Referenced()
+   , mShared(false)
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   PropertySchema::PropertySchema(const PropertySchema& toCopy)
+   : osg::Referenced()
+   , mNames(toCopy.mNames)
+   , mTable(toCopy.mTable)
+   , mShared(false)
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   PropertySchema::~PropertySchema()
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   int PropertySchema::GetIndex(const dtUtil::RefString& name) const
+   {
+      if (mTable.empty())
+      {
+         return -1;
+      }
+
+      const size_t mask = mTable.size() - 1;
+      for (size_t slot = FirstSlot(name.GetHash(), mask); ; slot = (slot + 1) & mask)
+      {
+         int index = mTable[slot];
+         if (index < 0 || mNames[index] == name)
+         {
+            return index;
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   int PropertySchema::GetIndex(const std::string& name) const
+   {
+      if (mTable.empty())
+      {
+         return -1;
+      }
+
+      // Same hash a RefString of the name would have, without interning it.
+      const size_t hash = dtUtil::__hash_string(name.c_str());
+      const size_t mask = mTable.size() - 1;
+      for (size_t slot = FirstSlot(hash, mask); ; slot = (slot + 1) & mask)
+      {
+         int index = mTable[slot];
+         if (index < 0)
+         {
+            return -1;
+         }
+
+         const dtUtil::RefString& current = mNames[index];
+         if (current.GetHash() == hash && current.Get() == name)
+         {
+            return index;
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void PropertySchema::AddName(const dtUtil::RefString& name)
+   {
+      mNames.push_back(name);
+      if (mTable.size() < mNames.size() * 2)
+      {
+         RebuildTable();
+      }
+      else
+      {
+         InsertIntoTable(unsigned(mNames.size() - 1));
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void PropertySchema::SetNames(const std::vector<dtUtil::RefString>& names)
+   {
+      mNames = names;
+      RebuildTable();
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void PropertySchema::RebuildTable()
+   {
+      size_t size = MIN_TABLE_SIZE;
+      while (size < mNames.size() * 2)
+      {
+         size *= 2;
+      }
+
+      mTable.assign(size, -1);
+      for (unsigned i = 0; i < mNames.size(); ++i)
+      {
+         InsertIntoTable(i);
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void PropertySchema::InsertIntoTable(unsigned index)
+   {
+      const size_t mask = mTable.size() - 1;
+      size_t slot = FirstSlot(mNames[index].GetHash(), mask);
+      while (mTable[slot] >= 0)
+      {
+         slot = (slot + 1) & mask;
+      }
+      mTable[slot] = int(index);
+   }
+}
@@ -8,6 +8,7 @@
 #include <dtUtil/bits.h>
 #include <dtUtil/mswinmacros.h>
 #include <dtCore/deltawin.h>
+#include <dtCore/transformable.h>
 
 #include <osgViewer/GraphicsWindow>
 #include <ctime>
@@ -534,6 +535,9 @@ namespace dtCore
       // update real time variable(s)
       mRealClockTime += Timer_t(realDT * 1000000);
 
+      // Cached absolute matrices may not have seen changes made directly to the scene graph last step.
+      Transformable::AdvanceAbsoluteMatrixCacheFrame();
+
       if (mPaused)
       {
          mTotalFrameTime = 0.0;  // reset frame timer for stats
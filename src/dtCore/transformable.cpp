@@ -3,6 +3,7 @@
 #include <dtCore/scene.h>
 #include <dtCore/transformable.h>
 #include <dtCore/transform.h>
+#include <dtUtil/hashmap.h>
 #include <dtUtil/log.h>
 #include <dtUtil/matrixutil.h>
 #include <dtUtil/nodemask.h>
@@ -73,9 +74,16 @@ namespace dtCore
       , mNode(&node)
       , mRenderingGeometry(false)
       , mRenderProxyNode(false)
+      , mCacheAbsoluteMatrix(false)
+      , mAbsoluteMatrixValid(false)
+      , mAbsoluteMatrixFrame(0U)
       {
 
       }
+
+      bool IsAbsoluteMatrixCurrent() const;
+
+      void SetCachedAbsoluteMatrix(const osg::Matrix& wcMatrix) const;
       /**
        *  Pointer to the collision geometry representation
        */
@@ -99,7 +107,44 @@ namespace dtCore
       ///used for the rendering of the proxy node
       dtCore::RefPtr<PointAxis> mPointAxis;
 
+      bool mCacheAbsoluteMatrix;
+
+      /// The absolute matrix cache, it's filled on read, so it's mutable.
+      mutable bool mAbsoluteMatrixValid;
+      mutable unsigned mAbsoluteMatrixFrame;
+      mutable osg::Matrix mAbsoluteMatrix;
+
+      /// The current cache frame. Cached matrices from other frames are stale.
+      static unsigned mCurrentCacheFrame;
+
+      Transformable::TransformChangedCallback mTransformChangedCallback;
+
+      /// The number of Transformables with the cache enabled.  While it's 0, there is nothing to invalidate.
+      static unsigned mNumCaching;
+      /// The number of Transformables with a transform changed callback.
+      static unsigned mNumWithCallback;
    };
+
+   unsigned TransformableImpl::mCurrentCacheFrame = 0U;
+   unsigned TransformableImpl::mNumCaching = 0U;
+   unsigned TransformableImpl::mNumWithCallback = 0U;
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool TransformableImpl::IsAbsoluteMatrixCurrent() const
+   {
+      return mCacheAbsoluteMatrix && mAbsoluteMatrixValid && mAbsoluteMatrixFrame == mCurrentCacheFrame;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void TransformableImpl::SetCachedAbsoluteMatrix(const osg::Matrix& wcMatrix) const
+   {
+      if (mCacheAbsoluteMatrix)
+      {
+         mAbsoluteMatrix = wcMatrix;
+         mAbsoluteMatrixFrame = mCurrentCacheFrame;
+         mAbsoluteMatrixValid = true;
+      }
+   }
 }
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -146,6 +191,9 @@ Transformable::~Transformable()
 
    DeregisterInstance(this);
 
+   SetCacheAbsoluteMatrix(false);
+   SetTransformChangedCallback(TransformChangedCallback());
+
    delete mImpl;
    mImpl = nullptr;
 }
@@ -266,6 +314,178 @@ bool Transformable::GetAbsoluteMatrix(const osg::Node* node, osg::Matrix& wcMatr
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+void Transformable::GetAbsoluteMatrix(osg::Matrix& wcMatrix) const
+{
+   if (!mImpl->mCacheAbsoluteMatrix)
+   {
+      GetAbsoluteMatrix(GetMatrixNode(), wcMatrix);
+      return;
+   }
+
+   if (mImpl->IsAbsoluteMatrixCurrent())
+   {
+      wcMatrix = mImpl->mAbsoluteMatrix;
+      return;
+   }
+
+   // If the parent Transformable is right above this in the scene graph, start from its matrix
+   // so its cache is used.
+   const Transformable* parent = nullptr;
+   if (GetParent() != nullptr && GetOSGNode()->getNumParents() > 0U)
+   {
+      parent = const_cast<DeltaDrawable*>(GetParent())->AsTransformable();
+      if (parent != nullptr && parent->GetOSGNode() != GetOSGNode()->getParent(0))
+      {
+         parent = nullptr;
+      }
+   }
+
+   if (parent != nullptr)
+   {
+      parent->GetAbsoluteMatrix(wcMatrix);
+      GetMatrixNode()->computeLocalToWorldMatrix(wcMatrix, nullptr);
+   }
+   else
+   {
+      GetAbsoluteMatrix(GetMatrixNode(), wcMatrix);
+   }
+
+   mImpl->SetCachedAbsoluteMatrix(wcMatrix);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Transformable::GetAbsoluteMatrices(const std::vector<Transformable*>& xformables, std::vector<osg::Matrix>& matricesOut)
+{
+   typedef dtUtil::HashMap<const osg::Node*, osg::Matrix> NodeMatrixMap;
+   NodeMatrixMap computed;
+
+   std::vector<const osg::Node*> nodePath;
+   nodePath.reserve(15U);
+
+   matricesOut.resize(xformables.size());
+   for (unsigned i = 0; i < xformables.size(); ++i)
+   {
+      const Transformable& xformable = *xformables[i];
+      if (xformable.mImpl->IsAbsoluteMatrixCurrent())
+      {
+         matricesOut[i] = xformable.mImpl->mAbsoluteMatrix;
+         computed.insert(std::make_pair(xformable.GetOSGNode(), matricesOut[i]));
+         continue;
+      }
+
+      // Walk up until a node computed earlier in this pass, the root, or an absolute camera.
+      // This stops at the same places GetAbsoluteMatrix does.
+      osg::Matrix wcMatrix;
+      nodePath.clear();
+      const osg::Node* curNode = xformable.GetOSGNode();
+      while (curNode != nullptr)
+      {
+         NodeMatrixMap::const_iterator found = computed.find(curNode);
+         if (found != computed.end())
+         {
+            wcMatrix = found->second;
+            break;
+         }
+
+         const osg::Camera* camera = curNode->asTransform() != nullptr ? dynamic_cast<const osg::Camera*>(curNode) : nullptr;
+         if (camera != nullptr && (camera->getReferenceFrame() != osg::Transform::RELATIVE_RF || camera->getNumParents() == 0))
+         {
+            break;
+         }
+
+         nodePath.push_back(curNode);
+         curNode = curNode->getNumParents() > 0U ? curNode->getParent(0) : nullptr;
+      }
+
+      std::vector<const osg::Node*>::reverse_iterator j = nodePath.rbegin(), jend = nodePath.rend();
+      for (; j != jend; ++j)
+      {
+         const osg::Transform* txNode = (*j)->asTransform();
+         if (txNode != nullptr)
+         {
+            txNode->computeLocalToWorldMatrix(wcMatrix, nullptr);
+         }
+         computed.insert(std::make_pair(*j, wcMatrix));
+      }
+
+      matricesOut[i] = wcMatrix;
+      xformable.mImpl->SetCachedAbsoluteMatrix(wcMatrix);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Transformable::SetCacheAbsoluteMatrix(bool enable)
+{
+   if (enable && !mImpl->mCacheAbsoluteMatrix)
+   {
+      ++TransformableImpl::mNumCaching;
+   }
+   else if (!enable && mImpl->mCacheAbsoluteMatrix)
+   {
+      --TransformableImpl::mNumCaching;
+   }
+   mImpl->mCacheAbsoluteMatrix = enable;
+   mImpl->mAbsoluteMatrixValid = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Transformable::GetCacheAbsoluteMatrix() const
+{
+   return mImpl->mCacheAbsoluteMatrix;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Transformable::InvalidateAbsoluteMatrixCache()
+{
+   // Called on every SetMatrix, so don't walk the children unless some Transformable keeps a cache or a callback.
+   if (TransformableImpl::mNumCaching == 0U && TransformableImpl::mNumWithCallback == 0U)
+   {
+      return;
+   }
+
+   mImpl->mAbsoluteMatrixValid = false;
+   if (mImpl->mTransformChangedCallback.valid())
+   {
+      mImpl->mTransformChangedCallback(*this);
+   }
+
+   for (unsigned i = 0; i < GetNumChildren(); ++i)
+   {
+      Transformable* child = GetChild(i)->AsTransformable();
+      if (child != nullptr)
+      {
+         child->InvalidateAbsoluteMatrixCache();
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Transformable::AdvanceAbsoluteMatrixCacheFrame()
+{
+   ++TransformableImpl::mCurrentCacheFrame;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Transformable::SetTransformChangedCallback(TransformChangedCallback callback)
+{
+   if (callback.valid() && !mImpl->mTransformChangedCallback.valid())
+   {
+      ++TransformableImpl::mNumWithCallback;
+   }
+   else if (!callback.valid() && mImpl->mTransformChangedCallback.valid())
+   {
+      --TransformableImpl::mNumWithCallback;
+   }
+   mImpl->mTransformChangedCallback = callback;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const Transformable::TransformChangedCallback& Transformable::GetTransformChangedCallback() const
+{
+   return mImpl->mTransformChangedCallback;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Transformable::SetTransform(const Transform& xform, CoordSysEnum cs)
 {
@@ -289,17 +509,17 @@ void Transformable::SetTransform(const Transform& xform, CoordSysEnum cs)
          osg::Matrix relMat = newMat * osg::Matrix::inverse(parentMat);
 
          //pass the rel matrix to this node
-         GetMatrixNode()->setMatrix(relMat);
+         SetMatrix(relMat);
       }
       else
       {
          //pass the xform to the this node
-         GetMatrixNode()->setMatrix(newMat);
+         SetMatrix(newMat);
       }
    }
    else if(cs == REL_CS)
    {
-     GetMatrixNode()->setMatrix(newMat);
+     SetMatrix(newMat);
    }
 }
 
@@ -311,7 +531,7 @@ void Transformable::GetTransform(Transform& xform, CoordSysEnum cs) const
    if(cs == ABS_CS)
    {
       osg::Matrix newMat;
-      GetAbsoluteMatrix(mt, newMat);
+      GetAbsoluteMatrix(newMat);
       xform.Set(newMat);
    }
    else if(cs == REL_CS)
@@ -343,6 +563,7 @@ const osg::Matrix& Transformable::GetMatrix() const
 void Transformable::SetMatrix(const osg::Matrix& mat)
 {
    mImpl->mNode->setMatrix(mat);
+   InvalidateAbsoluteMatrixCache();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -352,6 +573,10 @@ bool Transformable::AddChild(DeltaDrawable* child)
    if (DeltaDrawable::AddChild(child))
    {
       GetMatrixNode()->addChild(child->GetOSGNode());
+      if (child->AsTransformable() != nullptr)
+      {
+         child->AsTransformable()->InvalidateAbsoluteMatrixCache();
+      }
       return true;
    }
    else
@@ -365,6 +590,10 @@ void Transformable::RemoveChild(DeltaDrawable* child)
 {
    GetMatrixNode()->removeChild(child->GetOSGNode());
    DeltaDrawable::RemoveChild(child);
+   if (child->AsTransformable() != nullptr)
+   {
+      child->AsTransformable()->InvalidateAbsoluteMatrixCache();
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1,35 +1,393 @@
 #include <prefix/dtcoreprefix.h>
 #include <dtCore/uniqueid.h>
 #include <dtUtil/datastream.h>
+#include <dtUtil/hashmap.h>
 #include <iostream>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <new>
+
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
 
 namespace dtCore
 {
+   static const unsigned UUID_TEXT_LENGTH = 36U;
+   static const char HEX_DIGITS[] = "0123456789abcdef";
+   /**
+    * Starts a compact id in a data stream.  See WriteCompactUniqueId.  Short strings start with a byte below
+    * 0x80.  Long strings start with their negated length as a short, whose high byte is 0x80 or above, so the
+    * marker would be a positive length little endian and a length of 32768 big endian.  Neither is written.
+    */
+   static const unsigned COMPACT_ID_MARKER_SIZE = 2U;
+   static const char COMPACT_ID_MARKER[COMPACT_ID_MARKER_SIZE] = { char(0x80), char(0x00) };
+
+   /**
+    * The text of the ids that aren't canonical uuids.  An id holds its index + 1.  Each entry counts the
+    * ids holding it and is freed with the last one, and its index is reused.
+    * Entries are allocated in chunks that never move, so an id can reach its entry without the lock.  The
+    * count is atomic, so copying and destroying ids doesn't lock, and the text of an entry doesn't change while
+    * an id holds it, so it can be read without the lock.  The lock is only taken to intern and free entries.
+    */
+   struct TextIdTable
+   {
+      typedef dtUtil::HashMap<std::string, unsigned long long> IndexMap;
+
+      struct Entry
+      {
+         Entry() : mRefCount(0U), mInUse(false) {}
+         std::string mText;
+         OpenThreads::Atomic mRefCount;
+         /// Guarded by the mutex.  A count can reach 0 on two threads before either frees the entry.
+         bool mInUse;
+      };
+
+      static const unsigned CHUNK_SIZE = 4096U;
+      static const unsigned MAX_CHUNKS = 4096U;
+
+      TextIdTable()
+         : mSize(0ULL)
+      {
+         std::fill(mChunks, mChunks + MAX_CHUNKS, static_cast<Entry*>(NULL));
+      }
+
+      Entry& Get(unsigned long long index)
+      {
+         --index;
+         return mChunks[size_t(index / CHUNK_SIZE)][size_t(index % CHUNK_SIZE)];
+      }
+
+      OpenThreads::Mutex mMutex;
+      Entry* mChunks[MAX_CHUNKS];
+      unsigned long long mSize;
+      std::vector<unsigned long long> mFreeIndices;
+      IndexMap mIndices;
+   };
+
    ////////////////////////////////////////////////
-   const std::string& UniqueId::ToString() const
+   // Ids are created by static initializers, so the table is created on first use and never deleted.
+   static TextIdTable& GetTextIdTable()
    {
-      return mId;
+      static TextIdTable* table = new TextIdTable;
+      return *table;
    }
 
    ////////////////////////////////////////////////
-   UniqueId& UniqueId::operator=(const UniqueId& rhs)
+   static inline bool IsDashPosition(unsigned i)
    {
-      if (this == &rhs)
+      return i == 8U || i == 13U || i == 18U || i == 23U;
+   }
+
+   ////////////////////////////////////////////////
+   static inline int HexValue(char c)
+   {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+      // Upper case is rejected on purpose.  It would come back out as lower case.
+      return -1;
+   }
+
+   ////////////////////////////////////////////////
+   static bool ParseCanonical(const char* text, size_t length, unsigned char bytesOut[UniqueId::BYTE_COUNT])
+   {
+      if (length != UUID_TEXT_LENGTH)
       {
-         return *this;
+         return false;
       }
 
-      mId = rhs.mId;
-      return *this;
+      unsigned byteIndex = 0U;
+      for (unsigned i = 0U; i < UUID_TEXT_LENGTH; )
+      {
+         if (IsDashPosition(i))
+         {
+            if (text[i] != '-')
+            {
+               return false;
+            }
+            ++i;
+            continue;
+         }
+
+         int high = HexValue(text[i]);
+         int low = HexValue(text[i + 1]);
+         if (high < 0 || low < 0)
+         {
+            return false;
+         }
+         bytesOut[byteIndex++] = (unsigned char)((high << 4) | low);
+         i += 2;
+      }
+      return true;
+   }
+
+   ////////////////////////////////////////////////
+   static void FormatCanonical(const unsigned char bytes[UniqueId::BYTE_COUNT], char textOut[UUID_TEXT_LENGTH])
+   {
+      unsigned byteIndex = 0U;
+      for (unsigned i = 0U; i < UUID_TEXT_LENGTH; )
+      {
+         if (IsDashPosition(i))
+         {
+            textOut[i++] = '-';
+            continue;
+         }
+         textOut[i++] = HEX_DIGITS[bytes[byteIndex] >> 4];
+         textOut[i++] = HEX_DIGITS[bytes[byteIndex] & 0x0F];
+         ++byteIndex;
+      }
+   }
+
+   ////////////////////////////////////////////////
+   static unsigned long long ReadBigEndian(const unsigned char* bytes)
+   {
+      unsigned long long result = 0ULL;
+      for (unsigned i = 0U; i < 8U; ++i)
+      {
+         result = (result << 8) | bytes[i];
+      }
+      return result;
+   }
+
+   ////////////////////////////////////////////////
+   static void WriteBigEndian(unsigned long long value, unsigned char* bytesOut)
+   {
+      for (int i = 7; i >= 0; --i)
+      {
+         bytesOut[i] = (unsigned char)(value & 0xFF);
+         value >>= 8;
+      }
+   }
+
+   ////////////////////////////////////////////////
+   /// @return the index + 1 of the text in the table, adding it if it's new.  The caller owns one reference.
+   static unsigned long long InternText(const std::string& text)
+   {
+      TextIdTable& table = GetTextIdTable();
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(table.mMutex);
+      TextIdTable::IndexMap::iterator found = table.mIndices.find(text);
+      if (found != table.mIndices.end())
+      {
+         // The count may be 0 if the last id is being released right now.  That release won't free it now.
+         ++table.Get(found->second).mRefCount;
+         return found->second;
+      }
+
+      unsigned long long index;
+      if (table.mFreeIndices.empty())
+      {
+         if (table.mSize % TextIdTable::CHUNK_SIZE == 0ULL)
+         {
+            size_t chunk = size_t(table.mSize / TextIdTable::CHUNK_SIZE);
+            if (chunk >= TextIdTable::MAX_CHUNKS)
+            {
+               throw std::bad_alloc();
+            }
+            table.mChunks[chunk] = new TextIdTable::Entry[TextIdTable::CHUNK_SIZE];
+         }
+         index = ++table.mSize;
+      }
+      else
+      {
+         index = table.mFreeIndices.back();
+         table.mFreeIndices.pop_back();
+      }
+
+      TextIdTable::Entry& entry = table.Get(index);
+      entry.mText = text;
+      entry.mRefCount.exchange(1U);
+      entry.mInUse = true;
+      table.mIndices.insert(std::make_pair(text, index));
+      return index;
+   }
+
+   ////////////////////////////////////////////////
+   void UniqueId::AddTextRef(unsigned long long textIndex)
+   {
+      // The id being copied holds a reference, so the entry can't be freed meanwhile.
+      ++GetTextIdTable().Get(textIndex).mRefCount;
+   }
+
+   ////////////////////////////////////////////////
+   void UniqueId::ReleaseText(unsigned long long textIndex)
+   {
+      TextIdTable& table = GetTextIdTable();
+      TextIdTable::Entry& entry = table.Get(textIndex);
+      if (--entry.mRefCount != 0U)
+      {
+         return;
+      }
+
+      // Interning the same text again may have brought it back, or another release may have freed it already.
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(table.mMutex);
+      if (entry.mInUse && unsigned(entry.mRefCount) == 0U)
+      {
+         entry.mInUse = false;
+         table.mIndices.erase(entry.mText);
+         std::string().swap(entry.mText);
+         table.mFreeIndices.push_back(textIndex);
+      }
+   }
+
+   ////////////////////////////////////////////////
+   void UniqueId::SetText(unsigned long long textIndex)
+   {
+      if (IsText())
+      {
+         ReleaseText(mLow);
+      }
+      mHigh = 0ULL;
+      mLow = textIndex;
+   }
+
+   ////////////////////////////////////////////////
+   /**
+    * Points text at an id's text for comparing.  Binary ids are formatted into the buffer, and text ids point
+    * into the table entry, which the id holds a reference to.
+    */
+   static void GetComparableText(unsigned long long high, unsigned long long low, TextIdTable& table,
+            char buffer[UUID_TEXT_LENGTH], const char*& textOut, size_t& lengthOut)
+   {
+      if (high != 0ULL)
+      {
+         unsigned char bytes[UniqueId::BYTE_COUNT];
+         WriteBigEndian(high, bytes);
+         WriteBigEndian(low, bytes + 8);
+         FormatCanonical(bytes, buffer);
+         textOut = buffer;
+         lengthOut = UUID_TEXT_LENGTH;
+      }
+      else
+      {
+         const std::string& text = table.Get(low).mText;
+         textOut = text.data();
+         lengthOut = text.size();
+      }
+   }
+
+   ////////////////////////////////////////////////
+   UniqueId::UniqueId(const char* stringId)
+      : mHigh(0ULL)
+      , mLow(0ULL)
+   {
+      SetFromString(stringId, stringId != NULL ? std::strlen(stringId) : 0U);
+   }
+
+   ////////////////////////////////////////////////
+   void UniqueId::SetFromString(const char* text, size_t length)
+   {
+      unsigned char bytes[BYTE_COUNT];
+      if (length == 0U)
+      {
+         SetText(0ULL);
+      }
+      else if (ParseCanonical(text, length, bytes))
+      {
+         FromBytes(bytes);
+      }
+      else
+      {
+         SetText(InternText(std::string(text, length)));
+      }
+   }
+
+   ////////////////////////////////////////////////
+   std::string UniqueId::ToString() const
+   {
+      if (mHigh != 0ULL)
+      {
+         unsigned char bytes[BYTE_COUNT];
+         WriteBigEndian(mHigh, bytes);
+         WriteBigEndian(mLow, bytes + 8);
+
+         char text[UUID_TEXT_LENGTH];
+         FormatCanonical(bytes, text);
+         return std::string(text, UUID_TEXT_LENGTH);
+      }
+
+      if (mLow == 0ULL)
+      {
+         return std::string();
+      }
+
+      return GetTextIdTable().Get(mLow).mText;
    }
 
    ////////////////////////////////////////////////
    UniqueId& UniqueId::operator=(const std::string& rhs)
    {
-      mId = rhs;
+      SetFromString(rhs.data(), rhs.size());
       return *this;
    }
 
+   ////////////////////////////////////////////////
+   bool UniqueId::ToBytes(unsigned char bytesOut[BYTE_COUNT]) const
+   {
+      if (mHigh == 0ULL)
+      {
+         if (mLow == 0ULL)
+         {
+            return false;
+         }
+         // A uuid with its first 8 bytes 0 is kept as text, but it's still a uuid.
+         std::string text = ToString();
+         return ParseCanonical(text.data(), text.size(), bytesOut);
+      }
+
+      WriteBigEndian(mHigh, bytesOut);
+      WriteBigEndian(mLow, bytesOut + 8);
+      return true;
+   }
+
+   ////////////////////////////////////////////////
+   void UniqueId::FromBytes(const unsigned char bytes[BYTE_COUNT])
+   {
+      unsigned long long high = ReadBigEndian(bytes);
+      if (high == 0ULL)
+      {
+         // A high half of 0 marks a text id, so store this rare uuid as its text.
+         char text[UUID_TEXT_LENGTH];
+         FormatCanonical(bytes, text);
+         SetText(InternText(std::string(text, UUID_TEXT_LENGTH)));
+         return;
+      }
+
+      SetText(0ULL);
+      mHigh = high;
+      mLow = ReadBigEndian(bytes + 8);
+   }
+
+   ////////////////////////////////////////////////
+   bool UniqueId::LessAsText(const UniqueId& rhs) const
+   {
+      if (rhs.IsNull())
+      {
+         return false;
+      }
+      if (IsNull())
+      {
+         return true;
+      }
+      if (*this == rhs)
+      {
+         return false;
+      }
+
+      char lhsBuffer[UUID_TEXT_LENGTH];
+      char rhsBuffer[UUID_TEXT_LENGTH];
+      const char* lhsText;
+      const char* rhsText;
+      size_t lhsLength, rhsLength;
+
+      TextIdTable& table = GetTextIdTable();
+      GetComparableText(mHigh, mLow, table, lhsBuffer, lhsText, lhsLength);
+      GetComparableText(rhs.mHigh, rhs.mLow, table, rhsBuffer, rhsText, rhsLength);
+
+      int result = std::memcmp(lhsText, rhsText, std::min(lhsLength, rhsLength));
+      return result < 0 || (result == 0 && lhsLength < rhsLength);
+   }
+
    ////////////////////////////////////////////////
    std::ostream& operator << (std::ostream& o, const UniqueId& id)
    {
@@ -56,9 +414,35 @@ namespace dtCore
    ////////////////////////////////////////////////
    dtUtil::DataStream& operator >> (dtUtil::DataStream& ds, UniqueId& id)
    {
+      if (ds.GetRemainingReadSize() >= COMPACT_ID_MARKER_SIZE
+               && std::memcmp(ds.GetBuffer() + ds.GetReadPosition(), COMPACT_ID_MARKER, COMPACT_ID_MARKER_SIZE) == 0)
+      {
+         char marker[COMPACT_ID_MARKER_SIZE];
+         unsigned char bytes[UniqueId::BYTE_COUNT];
+         ds.ReadBinary(marker, COMPACT_ID_MARKER_SIZE);
+         ds.ReadBinary(reinterpret_cast<char*>(bytes), UniqueId::BYTE_COUNT);
+         id.FromBytes(bytes);
+         return ds;
+      }
+
       std::string value;
       ds >> value;
       id = value;
       return ds;
    }
+
+   ////////////////////////////////////////////////
+   void WriteCompactUniqueId(dtUtil::DataStream& ds, const UniqueId& id)
+   {
+      unsigned char bytes[UniqueId::BYTE_COUNT];
+      if (id.ToBytes(bytes))
+      {
+         ds.WriteBinary(COMPACT_ID_MARKER, COMPACT_ID_MARKER_SIZE);
+         ds.WriteBinary(reinterpret_cast<const char*>(bytes), UniqueId::BYTE_COUNT);
+      }
+      else
+      {
+         ds << id.ToString();
+      }
+   }
 }
@@ -7,16 +7,16 @@
 using namespace dtCore;
 
 UniqueId::UniqueId(bool createNewId)
+: mHigh(0ULL)
+, mLow(0ULL)
 {
    if (createNewId)
    {
       uuid_t uuid;
       uuid_generate( uuid );
 
-      char buffer[37];
-      uuid_unparse( uuid, buffer );
-
-      mId = std::string( buffer );
+      // uuid_t is the 16 bytes in the same order uuid_unparse prints them.
+      FromBytes( uuid );
    }
 }
 
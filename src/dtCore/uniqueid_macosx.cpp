@@ -6,38 +6,25 @@
 
 using namespace dtCore;
 
-std::string CFStringRefToStdString(CFStringRef stringRef)
-{
-   CFIndex  size =
-   CFStringGetMaximumSizeForEncoding(CFStringGetLength(stringRef),
-                                     kCFStringEncodingASCII);
-   char* buf = new char[size + 1];
-   std::string result;
-
-   if(CFStringGetCString(stringRef, buf, size + 1, kCFStringEncodingASCII) != TRUE) {
-      //Need to log, but really this should never happen.
-      result = "Memory Allocation Error";
-   } else {
-      result = buf;
-   }
-
-   delete[] buf;
-   return result;
-}
-
 UniqueId::UniqueId(bool createNewId)
+: mHigh(0ULL)
+, mLow(0ULL)
 {
    if (createNewId)
    {
-      CFUUIDRef uuid;
-      CFStringRef string;
-      uuid = CFUUIDCreate( NULL );
-      string = CFUUIDCreateString(NULL, uuid);
-
-      mId = CFStringRefToStdString(string);
-
-      if (string) CFRelease(string);
+      CFUUIDRef uuid = CFUUIDCreate( NULL );
+      CFUUIDBytes uuidBytes = CFUUIDGetUUIDBytes( uuid );
       CFRelease(uuid);
+
+      // The bytes are in the order CFUUIDCreateString prints them.
+      const unsigned char bytes[BYTE_COUNT] =
+      {
+         uuidBytes.byte0, uuidBytes.byte1, uuidBytes.byte2, uuidBytes.byte3,
+         uuidBytes.byte4, uuidBytes.byte5, uuidBytes.byte6, uuidBytes.byte7,
+         uuidBytes.byte8, uuidBytes.byte9, uuidBytes.byte10, uuidBytes.byte11,
+         uuidBytes.byte12, uuidBytes.byte13, uuidBytes.byte14, uuidBytes.byte15
+      };
+      FromBytes(bytes);
    }
 }
 
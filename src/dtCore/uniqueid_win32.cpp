@@ -15,6 +15,8 @@
 using namespace dtCore;
    
 UniqueId::UniqueId(bool createNewId)
+: mHigh(0ULL)
+, mLow(0ULL)
 {
    if (createNewId)
    {
@@ -22,20 +24,21 @@ UniqueId::UniqueId(bool createNewId)
 
       if( UuidCreate( &guid ) == RPC_S_OK )
       {
-         unsigned char* guidChar;
-
-         if( UuidToString( const_cast<UUID*>(&guid), &guidChar ) == RPC_S_OK )
-         {
-            mId = std::string( reinterpret_cast<const char*>(guidChar) );
-            if(RpcStringFree(&guidChar) != RPC_S_OK)
-            {
-               LOG_ERROR("Could not free memory.");
-            }
-         }
-         else
+         // Laid out in the order UuidToString prints the fields, which print their values big endian.
+         unsigned char bytes[BYTE_COUNT];
+         bytes[0] = (unsigned char)(guid.Data1 >> 24);
+         bytes[1] = (unsigned char)(guid.Data1 >> 16);
+         bytes[2] = (unsigned char)(guid.Data1 >> 8);
+         bytes[3] = (unsigned char)(guid.Data1);
+         bytes[4] = (unsigned char)(guid.Data2 >> 8);
+         bytes[5] = (unsigned char)(guid.Data2);
+         bytes[6] = (unsigned char)(guid.Data3 >> 8);
+         bytes[7] = (unsigned char)(guid.Data3);
+         for (unsigned i = 0; i < 8; ++i)
          {
-            LOG_WARNING("Could not convert UniqueId to std::string." );
+            bytes[8 + i] = guid.Data4[i];
          }
+         FromBytes(bytes);
       }
       else
       {
@@ -14,6 +14,7 @@
 #include <dtActors/coordinateconfigactor.h>
 #include <dtGame/message.h>
 #include <dtGame/messagetype.h>
+#include <dtUtil/log.h>
 
 namespace dtDIS
 {
@@ -25,12 +26,16 @@ const std::string MasterComponent::DEFAULT_NAME = TYPE->GetName();
 ///\todo what should set the network stream's endian type?  the SharedState's connection data?
 MasterComponent::MasterComponent(SharedState* config)
    : dtGame::GMComponent(*TYPE)
+   , mUseReceiveThread(false)
+   , mReceiveBufferCount(1024U)
+   , mCoalesceOutgoingPDUs(false)
    , mPluginManager()
    , mConnection()
    , mIncomingMessage()
    , mOutgoingMessage(DIS::BIG, config->GetConnectionData().exercise_id)
    , mConfig(config)
    , mDefaultPlugin(new dtDIS::DefaultPlugin())
+   , mSentDatagramCount(0U)
 {
    // add support for the network packets
    LoadPlugins(mConfig->GetConnectionData().plug_dir);
@@ -39,6 +44,7 @@ MasterComponent::MasterComponent(SharedState* config)
 ////////////////////////////////////////////////////////////////////////////////
 MasterComponent::~MasterComponent()
 {
+   mReceiver.reset();
    delete mDefaultPlugin;
 
    // release the memory for the packet support plugins
@@ -70,6 +76,18 @@ void MasterComponent::OnAddedToGM()
 
    // make a connection to the DIS multicast network
    mConnection.Connect(connect_data.port, connect_data.ip.c_str(), connect_data.use_broadcast);
+
+   // the receive buffers are all allocated up front so reading never allocates.
+   const size_t mtu = connect_data.MTU > 0 ? connect_data.MTU : 1500U;
+   mReceiveRing.reset(new PacketRing(mReceiveBufferCount, mtu));
+   mReceiver.reset(new PacketReceiver(mConnection, *mReceiveRing));
+   mSendBuffer.reserve(mtu);
+   mSentDatagramCount = 0U;
+
+   if (mUseReceiveThread)
+   {
+      mReceiver->start();
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,6 +108,8 @@ void MasterComponent::OnRemovedFromGM()
    mConfig->GetActiveEntityControl().ClearAll();
 
    // stop reading the port
+   mReceiver.reset();
+   mReceiveRing.reset();
    mConnection.Disconnect();
 }
 
@@ -140,34 +160,14 @@ void MasterComponent::ProcessMessage(const dtGame::Message& msg)
    if(mt == dtGame::MessageType::TICK_LOCAL)
    {
       // read the incoming packets
-      const unsigned int MTU = 1500;
-      char buffer[MTU];
-      size_t recvd(0);
-      recvd = mConnection.Receive(buffer , MTU);
-      if (recvd != 0)
+      if (mReceiver != nullptr && !mReceiver->isRunning())
       {
-         mIncomingMessage.Process(buffer , recvd , DIS::BIG);
+         mReceiver->Drain(mReceiveRing->GetCapacity());
       }
+      ProcessReceivedPackets();
 
       // write the outgoing packets
-      {
-         OutgoingMessage::DataStreamContainer& streams = mOutgoingMessage.GetData();
-
-         while (!streams.empty())
-         {
-            const DIS::DataStream& ds = streams.front();
-            if (ds.size() > MTU)
-            {
-               LOG_WARNING("Network buffer is bigger than LAN supports.")
-            }
-
-            if (ds.size() > 0)
-            {
-               mConnection.Send(&(ds[0]), ds.size());
-            }
-            streams.pop();
-         }
-      }
+      SendOutgoingPackets();
    }
    else if (mt == dtGame::MessageType::INFO_MAP_LOADED)
    {
@@ -186,6 +186,100 @@ void MasterComponent::ProcessMessage(const dtGame::Message& msg)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void MasterComponent::ProcessReceivedPackets()
+{
+   if (mReceiveRing == nullptr)
+   {
+      return;
+   }
+
+   // Only process what is in the ring now so a flood can't keep the frame from ending.
+   for (unsigned count = mReceiveRing->GetSize(); count > 0; --count)
+   {
+      size_t recvd = 0;
+      const char* buffer = mReceiveRing->BeginRead(recvd);
+      if (recvd != 0)
+      {
+         mIncomingMessage.Process(buffer, recvd, DIS::BIG);
+      }
+      mReceiveRing->EndRead();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MasterComponent::SendOutgoingPackets()
+{
+   const size_t mtu = mReceiveRing != nullptr ? mReceiveRing->GetPacketSize() : 1500U;
+
+   OutgoingMessage::DataStreamContainer& streams = mOutgoingMessage.GetData();
+   mSendBuffer.clear();
+
+   while (!streams.empty())
+   {
+      const DIS::DataStream& ds = streams.front();
+      if (ds.size() > mtu)
+      {
+         LOG_WARNING("Network buffer is bigger than LAN supports.")
+      }
+
+      if (ds.size() > 0)
+      {
+         if (mSendBuffer.size() + ds.size() > mtu)
+         {
+            FlushSendBuffer();
+         }
+
+         if (mCoalesceOutgoingPDUs && ds.size() <= mtu)
+         {
+            mSendBuffer.insert(mSendBuffer.end(), &(ds[0]), &(ds[0]) + ds.size());
+         }
+         else
+         {
+            mConnection.Send(&(ds[0]), ds.size());
+            ++mSentDatagramCount;
+         }
+      }
+      streams.pop();
+   }
+
+   FlushSendBuffer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MasterComponent::FlushSendBuffer()
+{
+   if (!mSendBuffer.empty())
+   {
+      mConnection.Send(&mSendBuffer[0], mSendBuffer.size());
+      ++mSentDatagramCount;
+      mSendBuffer.clear();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DT_IMPLEMENT_ACCESSOR(MasterComponent, bool, UseReceiveThread);
+DT_IMPLEMENT_ACCESSOR(MasterComponent, unsigned, ReceiveBufferCount);
+DT_IMPLEMENT_ACCESSOR(MasterComponent, bool, CoalesceOutgoingPDUs);
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned MasterComponent::GetReceivedDatagramCount() const
+{
+   return mReceiver != nullptr ? mReceiver->GetReceivedCount() : 0U;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned MasterComponent::GetDroppedDatagramCount() const
+{
+   return mReceiver != nullptr ? mReceiver->GetDroppedCount() : 0U;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned MasterComponent::GetSentDatagramCount() const
+{
+   return mSentDatagramCount;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 DIS::IncomingMessage& MasterComponent::GetIncomingMessage()
 {
@@ -0,0 +1,97 @@
+// Must be first because of a hawknl conflict with osg.  This is not a directly required include, but indirectly
+#include <osgDB/Serializer>
+#include <dtDIS/packetreceiver.h>
+#include <dtDIS/packetring.h>
+#include <dtDIS/connection.h>
+
+using namespace dtDIS;
+
+PacketReceiver::PacketReceiver(Connection& connection, PacketRing& ring)
+   : mConnection(connection)
+   , mRing(ring)
+   , mOverflow(ring.GetPacketSize())
+   , mIdleSleep(500U)
+   , mStopRequested(0U)
+   , mReceivedCount(0U)
+   , mDroppedCount(0U)
+{
+}
+
+PacketReceiver::~PacketReceiver()
+{
+   Stop();
+}
+
+unsigned PacketReceiver::Drain(unsigned maxPackets)
+{
+   unsigned numRead = 0;
+   while (numRead < maxPackets)
+   {
+      char* buffer = mRing.BeginWrite();
+      bool full = buffer == NULL;
+      if (full)
+      {
+         // Still empty the socket so the newest data isn't stuck behind what the OS buffered.
+         buffer = &mOverflow[0];
+      }
+
+      size_t recvd = mConnection.Receive(buffer, mRing.GetPacketSize());
+      if (recvd == 0)
+      {
+         break;
+      }
+
+      ++numRead;
+      if (full)
+      {
+         ++mDroppedCount;
+      }
+      else
+      {
+         mRing.EndWrite(recvd);
+         ++mReceivedCount;
+      }
+   }
+   return numRead;
+}
+
+void PacketReceiver::run()
+{
+   while (unsigned(mStopRequested) == 0U)
+   {
+      if (Drain(mRing.GetCapacity()) == 0)
+      {
+         microSleep(mIdleSleep);
+      }
+   }
+}
+
+void PacketReceiver::Stop()
+{
+   if (isRunning())
+   {
+      mStopRequested.exchange(1U);
+      join();
+   }
+   mStopRequested.exchange(0U);
+}
+
+unsigned PacketReceiver::GetReceivedCount() const
+{
+   return mReceivedCount;
+}
+
+unsigned PacketReceiver::GetDroppedCount() const
+{
+   return mDroppedCount;
+}
+
+void PacketReceiver::SetIdleSleep(unsigned microseconds)
+{
+   mIdleSleep = microseconds;
+}
+
+unsigned PacketReceiver::GetIdleSleep() const
+{
+   return mIdleSleep;
+}
@@ -0,0 +1,70 @@
+#include <dtDIS/packetring.h>
+
+using namespace dtDIS;
+
+PacketRing::PacketRing(unsigned capacity, size_t packetSize)
+   : mMask(0)
+   , mPacketSize(packetSize)
+   , mWriteCount(0U)
+   , mReadCount(0U)
+{
+   unsigned roundedCapacity = 1U;
+   while (roundedCapacity < capacity)
+   {
+      roundedCapacity <<= 1U;
+   }
+   mMask = roundedCapacity - 1U;
+
+   mBuffers.resize(roundedCapacity * mPacketSize);
+   mSizes.resize(roundedCapacity, 0);
+}
+
+char* PacketRing::BeginWrite()
+{
+   unsigned written = mWriteCount;
+   if (written - unsigned(mReadCount) > mMask)
+   {
+      return NULL;
+   }
+   return &mBuffers[(written & mMask) * mPacketSize];
+}
+
+void PacketRing::EndWrite(size_t numbytes)
+{
+   mSizes[unsigned(mWriteCount) & mMask] = numbytes;
+   // The increment is a full barrier, so the data and size are visible before the reader sees the count.
+   ++mWriteCount;
+}
+
+const char* PacketRing::BeginRead(size_t& numbytes)
+{
+   unsigned read = mReadCount;
+   if (read == unsigned(mWriteCount))
+   {
+      numbytes = 0;
+      return NULL;
+   }
+   unsigned slot = read & mMask;
+   numbytes = mSizes[slot];
+   return &mBuffers[slot * mPacketSize];
+}
+
+void PacketRing::EndRead()
+{
+   ++mReadCount;
+}
+
+unsigned PacketRing::GetSize() const
+{
+   return unsigned(mWriteCount) - unsigned(mReadCount);
+}
+
+unsigned PacketRing::GetCapacity() const
+{
+   return mMask + 1U;
+}
+
+size_t PacketRing::GetPacketSize() const
+{
+   return mPacketSize;
+}
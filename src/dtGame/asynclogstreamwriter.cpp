@@ -0,0 +1,285 @@
+/* -*-c++-*-
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ */
+#include <prefix/dtgameprefix.h>
+#include <dtGame/asynclogstreamwriter.h>
+
+#include <cstring>
+#include <cerrno>
+
+namespace dtGame
+{
+   //////////////////////////////////////////////////////////////////////////
+   AsyncLogStreamWriter::AsyncLogStreamWriter(FILE* file, unsigned numBuffers, size_t bufferSize)
+      : mFile(file)
+      , mFileOffset(file != NULL ? ftell(file) : 0L)
+      , mMask(0)
+      , mFillSlot(0)
+      , mFillSize(0)
+      , mFilling(false)
+      , mDropWhenFull(false)
+      , mIdleSleep(500U)
+      , mWriteCount(0U)
+      , mReadCount(0U)
+      , mStopRequested(0U)
+      , mErrorFlag(0U)
+      , mDroppedCount(0U)
+      , mStallCount(0U)
+   {
+      unsigned roundedCount = 1U;
+      while (roundedCount < numBuffers)
+      {
+         roundedCount <<= 1U;
+      }
+      mMask = roundedCount - 1U;
+
+      mBuffers.resize(roundedCount);
+      for (unsigned i = 0; i < roundedCount; ++i)
+      {
+         mBuffers[i].resize(bufferSize);
+      }
+      mSizes.resize(roundedCount, 0);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   AsyncLogStreamWriter::~AsyncLogStreamWriter()
+   {
+      Stop();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool AsyncLogStreamWriter::Write(const char* header, size_t headerSize, const char* body, size_t bodySize)
+   {
+      if (HasError())
+      {
+         return false;
+      }
+
+      const size_t recordSize = headerSize + bodySize;
+      if (mFilling && mFillSize + recordSize > mBuffers[mFillSlot].size())
+      {
+         PublishBuffer();
+      }
+
+      if (!mFilling && !AcquireBuffer())
+      {
+         ++mDroppedCount;
+         return false;
+      }
+
+      std::vector<char>& buffer = mBuffers[mFillSlot];
+      if (recordSize > buffer.size())
+      {
+         // The buffer is empty here, because it was published above if the record didn't fit.
+         buffer.resize(recordSize);
+      }
+
+      if (headerSize > 0)
+      {
+         memcpy(&buffer[mFillSize], header, headerSize);
+      }
+      if (bodySize > 0)
+      {
+         memcpy(&buffer[mFillSize + headerSize], body, bodySize);
+      }
+      mFillSize += recordSize;
+      mFileOffset += long(recordSize);
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool AsyncLogStreamWriter::AcquireBuffer()
+   {
+      bool stalled = false;
+      while (unsigned(mWriteCount) - unsigned(mReadCount) > mMask)
+      {
+         if (!isRunning())
+         {
+            WritePublished();
+            continue;
+         }
+
+         if (mDropWhenFull)
+         {
+            return false;
+         }
+
+         if (!stalled)
+         {
+            stalled = true;
+            ++mStallCount;
+         }
+         microSleep(mIdleSleep);
+      }
+
+      mFillSlot = unsigned(mWriteCount) & mMask;
+      mFillSize = 0;
+      mFilling = true;
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogStreamWriter::PublishBuffer()
+   {
+      if (!mFilling)
+      {
+         return;
+      }
+
+      mFilling = false;
+      if (mFillSize == 0)
+      {
+         return;
+      }
+
+      mSizes[mFillSlot] = mFillSize;
+      // The increment is a full barrier, so the data and size are visible before the IO thread sees the count.
+      ++mWriteCount;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned AsyncLogStreamWriter::WritePublished()
+   {
+      unsigned numWritten = 0;
+      unsigned read = mReadCount;
+      while (read != unsigned(mWriteCount))
+      {
+         const unsigned slot = read & mMask;
+         const size_t size = mSizes[slot];
+         if (!HasError() && fwrite(&mBuffers[slot][0], 1, size, mFile) < size)
+         {
+            const int error = errno;
+            mError = "Error writing to IO stream.  Data not written: ";
+            mError += error != 0 ? strerror(error) : "unknown error";
+            ++mErrorFlag;
+         }
+
+         // Buffers are still released after an error so Write never waits on a writer that has given up.
+         ++mReadCount;
+         ++read;
+         ++numWritten;
+      }
+      return numWritten;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogStreamWriter::run()
+   {
+      while (true)
+      {
+         if (WritePublished() == 0)
+         {
+            if (unsigned(mStopRequested) != 0U)
+            {
+               break;
+            }
+            microSleep(mIdleSleep);
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogStreamWriter::Flush()
+   {
+      PublishBuffer();
+
+      while (GetNumPendingBuffers() > 0 && isRunning())
+      {
+         microSleep(mIdleSleep);
+      }
+      // Nothing is left unless the thread isn't running.
+      WritePublished();
+
+      if (mFile != NULL)
+      {
+         fflush(mFile);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogStreamWriter::Stop()
+   {
+      Flush();
+      if (isRunning())
+      {
+         mStopRequested.exchange(1U);
+         join();
+      }
+      mStopRequested.exchange(0U);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   long AsyncLogStreamWriter::GetFileOffset() const
+   {
+      return mFileOffset;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool AsyncLogStreamWriter::HasError() const
+   {
+      return unsigned(mErrorFlag) != 0U;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   const std::string& AsyncLogStreamWriter::GetError() const
+   {
+      return mError;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogStreamWriter::SetDropWhenFull(bool drop)
+   {
+      mDropWhenFull = drop;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool AsyncLogStreamWriter::GetDropWhenFull() const
+   {
+      return mDropWhenFull;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned AsyncLogStreamWriter::GetDroppedCount() const
+   {
+      return mDroppedCount;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned AsyncLogStreamWriter::GetStallCount() const
+   {
+      return mStallCount;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned AsyncLogStreamWriter::GetNumPendingBuffers() const
+   {
+      return unsigned(mWriteCount) - unsigned(mReadCount);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void AsyncLogStreamWriter::SetIdleSleep(unsigned microseconds)
+   {
+      mIdleSleep = microseconds;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned AsyncLogStreamWriter::GetIdleSleep() const
+   {
+      return mIdleSleep;
+   }
+}
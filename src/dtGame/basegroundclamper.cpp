@@ -182,6 +182,11 @@ namespace dtGame
       return mIntermittentGroundClampingSmoothingTime;
    }
 
+   /////////////////////////////////////////////////////////////////////////////
+   void BaseGroundClamper::AddBatchTasksToThreadPool()
+   {
+   }
+
    /////////////////////////////////////////////////////////////////////////////
    void BaseGroundClamper::UpdateEyePoint()
    {
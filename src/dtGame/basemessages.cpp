@@ -23,6 +23,8 @@
 #include <dtGame/basemessages.h>
 #include <dtCore/gameeventmanager.h>
 #include <dtUtil/stringutils.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/mathdefines.h>
 #include <algorithm>
 #include <sstream>
 
@@ -120,6 +122,14 @@ namespace dtGame
    //////////////////////////////////////////////////////////////////////////////
    //////////////////////////////////////////////////////////////////////////////
 
+   DT_IMPLEMENT_MESSAGE_BEGIN(MapLoadProgressMessage)
+      DT_ADD_PARAMETER(unsigned int, ActorsAdded)
+      DT_ADD_PARAMETER(unsigned int, TotalActors)
+   DT_IMPLEMENT_MESSAGE_END()
+
+   //////////////////////////////////////////////////////////////////////////////
+   //////////////////////////////////////////////////////////////////////////////
+
    void GameEventMessage::SetGameEvent(const dtCore::GameEvent& event)
    {
       GameEventMessageParameter* mp = static_cast<GameEventMessageParameter*>(GetParameter("GameEvent"));
@@ -146,6 +156,51 @@ namespace dtGame
       DT_ADD_PARAMETER(std::string, RejectionMessage)
    DT_IMPLEMENT_MESSAGE_END()
 
+   DT_IMPLEMENT_MESSAGE_BEGIN(NetWireFormatMessage)
+      DT_ADD_PARAMETER(unsigned int, WireFormatVersion)
+   DT_IMPLEMENT_MESSAGE_END()
+
+   //////////////////////////////////////////////////////////////////////////////
+   //////////////////////////////////////////////////////////////////////////////
+   const dtUtil::RefString NetActorUpdateAckMessage::PARAM_ACTOR_IDS("ActorIds");
+   const dtUtil::RefString NetActorUpdateAckMessage::PARAM_SEQUENCES("Sequences");
+
+   NetActorUpdateAckMessage::NetActorUpdateAckMessage() : Message()
+   {
+      mActorIds = new ActorMessageParameter(PARAM_ACTOR_IDS, dtCore::UniqueId(false), true);
+      mSequences = new UnsignedIntMessageParameter(PARAM_SEQUENCES, 0, true);
+      // list parameters start out holding the default value.
+      mActorIds->GetValueList().clear();
+      mSequences->GetValueList().clear();
+      AddParameter(mActorIds.get());
+      AddParameter(mSequences.get());
+   }
+
+   //////////////////////////////////////////////////////////////////////////////
+   void NetActorUpdateAckMessage::AddAck(const dtCore::UniqueId& actorId, unsigned int sequence)
+   {
+      mActorIds->GetValueList().push_back(actorId);
+      mSequences->GetValueList().push_back(sequence);
+   }
+
+   //////////////////////////////////////////////////////////////////////////////
+   unsigned int NetActorUpdateAckMessage::GetAckCount() const
+   {
+      return unsigned(dtUtil::Min(mActorIds->GetValueList().size(), mSequences->GetValueList().size()));
+   }
+
+   //////////////////////////////////////////////////////////////////////////////
+   const dtCore::UniqueId& NetActorUpdateAckMessage::GetAckActorId(unsigned int index) const
+   {
+      return mActorIds->GetValueList()[index];
+   }
+
+   //////////////////////////////////////////////////////////////////////////////
+   unsigned int NetActorUpdateAckMessage::GetAckSequence(unsigned int index) const
+   {
+      return mSequences->GetValueList()[index];
+   }
+
    //////////////////////////////////////////////////////////////////////////////
    //////////////////////////////////////////////////////////////////////////////
 
@@ -300,6 +355,83 @@ namespace dtGame
       SetPing(machineInfo.GetPing());
    }
 
+   ////////////////////////////////////////////////////////////////////
+   ////////////////////////////////////////////////////////////////////
+   const dtUtil::RefString NetConnectionMessage::PARAM_PROTOCOL_VERSION("ProtocolVersion");
+
+   NetConnectionMessage::NetConnectionMessage()
+   {
+      mProtocolVersion = new UnsignedIntMessageParameter(PARAM_PROTOCOL_VERSION, 0U);
+      AddParameter(mProtocolVersion.get());
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   unsigned int NetConnectionMessage::GetProtocolVersion() const
+   {
+      return mProtocolVersion->GetValue();
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void NetConnectionMessage::SetProtocolVersion(unsigned int version)
+   {
+      mProtocolVersion->SetValue(version);
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void NetConnectionMessage::ToDataStream(dtUtil::DataStream& stream) const
+   {
+      // The machine info parameters go first, in the order an older peer expects them.
+      std::vector<const MessageParameter*> params;
+      GetParameterList(params);
+      for (unsigned i = 0; i < params.size(); ++i)
+      {
+         if (params[i] != mProtocolVersion.get())
+         {
+            params[i]->ToDataStream(stream);
+         }
+      }
+
+      stream.Write(PROTOCOL_VERSION_MARKER);
+      stream.Write(mProtocolVersion->GetValue());
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   bool NetConnectionMessage::FromDataStream(dtUtil::DataStream& stream)
+   {
+      bool okay = true;
+
+      std::vector<const MessageParameter*> params;
+      GetParameterList(params);
+      for (unsigned i = 0; i < params.size(); ++i)
+      {
+         if (params[i] != mProtocolVersion.get())
+         {
+            okay = okay && GetParameter(params[i]->GetName())->FromDataStream(stream);
+         }
+      }
+
+      mProtocolVersion->SetValue(0U);
+      if (stream.GetRemainingReadSize() >= sizeof(unsigned short) + sizeof(unsigned int))
+      {
+         unsigned int startPos = stream.GetReadPosition();
+         unsigned short marker = 0;
+         stream.Read(marker);
+         if (marker == PROTOCOL_VERSION_MARKER)
+         {
+            unsigned int version = 0U;
+            stream.Read(version);
+            mProtocolVersion->SetValue(version);
+         }
+         else
+         {
+            // Not a version, so leave it for whoever reads the rest of the stream.
+            stream.Seekg(startPos, dtUtil::DataStream::SeekTypeEnum::SET);
+         }
+      }
+
+      return okay;
+   }
+
    ////////////////////////////////////////////////////////////////////
    ServerFrameSyncMessage::ServerFrameSyncMessage()
    {
@@ -391,9 +523,11 @@ namespace dtGame
    ServerSyncControlMessage::~ServerSyncControlMessage() { }
    ServerFrameSyncMessage::~ServerFrameSyncMessage() { }
    MachineInfoMessage::~MachineInfoMessage() { }
+   NetConnectionMessage::~NetConnectionMessage() { }
    ServerMessageRejected::~ServerMessageRejected() {}
    MapMessage::~MapMessage() { }
    GameEventMessage::~GameEventMessage() { }
    RestartMessage::~RestartMessage() { }
+   NetActorUpdateAckMessage::~NetActorUpdateAckMessage() { }
 
 }
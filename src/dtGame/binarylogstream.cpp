@@ -20,14 +20,20 @@
  */
 #include <prefix/dtgameprefix.h>
 #include <dtGame/binarylogstream.h>
+#include <dtGame/asynclogstreamwriter.h>
 #include <dtGame/messagetype.h>
 #include <dtUtil/exception.h>
 #include <dtUtil/fileutils.h>
 #include <dtUtil/datastream.h>
+#include <dtUtil/mappedfile.h>
+#include <dtUtil/threadpool.h>
 #include <dtCore/uniqueid.h>
+#include <OpenThreads/Atomic>
 
+#include <algorithm>
 #include <iostream>
 #include <set>
+#include <sstream>
 
 #include <osgDB/FileNameUtils>
 
@@ -41,7 +47,7 @@ namespace dtGame
    const std::string BinaryLogStream::LOGGER_MSGDB_MAGIC_NUMBER("GMLOGMSGDB");
    const std::string BinaryLogStream::LOGGER_INDEX_MAGIC_NUMBER("GMLOGINDEXTAB");
    const unsigned char BinaryLogStream::LOGGER_MAJOR_VERSION = 1;
-   const unsigned char BinaryLogStream::LOGGER_MINOR_VERSION = 1;
+   const unsigned char BinaryLogStream::LOGGER_MINOR_VERSION = 2;
 
    const std::string BinaryLogStream::MESSAGE_DB_EXT(".dlm");
    const std::string BinaryLogStream::INDEX_EXT(".dli");
@@ -51,12 +57,91 @@ namespace dtGame
    const unsigned char BinaryLogStream::KEYFRAME_DEID = 2;
    const unsigned char BinaryLogStream::END_SECTION_DEID = 255;
 
+   // The element id, message type id, time stamp, and size that come before each message's data.
+   static const size_t MESSAGE_HEADER_SIZE = 1 + sizeof(unsigned short) + sizeof(double) + sizeof(unsigned int);
+
+   //////////////////////////////////////////////////////////////////////////
+   class BinaryLogStream::PrefetchTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      PrefetchTask(BinaryLogStream& stream, unsigned first, unsigned count)
+         : mStream(stream)
+         , mFirst(first)
+         , mNumDecoded(0)
+         , mMessages(count)
+         , mTimeStamps(count)
+         , mClaimed(0U)
+         , mFinished(false)
+      {
+      }
+
+      virtual void operator()()
+      {
+         if (!Claim())
+         {
+            return;
+         }
+
+         try
+         {
+            for (; mNumDecoded < mMessages.size(); ++mNumDecoded)
+            {
+               mMessages[mNumDecoded] = mStream.DecodeMappedMessage(mFirst + mNumDecoded, mTimeStamps[mNumDecoded]);
+            }
+         }
+         catch (const dtUtil::Exception&)
+         {
+            // ReadMessage decodes the bad message again on the calling thread, which throws the error there.
+         }
+      }
+
+      /**
+       * Called on the reading thread before using the results.  If no worker has started the task yet,
+       * it is cancelled rather than waited for, and nothing is decoded.
+       */
+      void Finish()
+      {
+         if (!mFinished)
+         {
+            if (!Claim())
+            {
+               WaitUntilComplete();
+            }
+            mFinished = true;
+         }
+      }
+
+      unsigned GetEnd() const { return mFirst + unsigned(mMessages.size()); }
+
+      BinaryLogStream& mStream;
+      unsigned mFirst;
+      unsigned mNumDecoded;
+      std::vector<dtCore::RefPtr<Message> > mMessages;
+      std::vector<double> mTimeStamps;
+
+   private:
+      /// @return true for whichever thread gets to the task first.
+      bool Claim() { return mClaimed.exchange(1U) == 0U; }
+
+      OpenThreads::Atomic mClaimed;
+      bool mFinished;
+   };
+
    //////////////////////////////////////////////////////////////////////////
    BinaryLogStream::BinaryLogStream(MessageFactory& msgFactory)
       : LogStream(msgFactory)
       , mMessagesFile(NULL)
       , mIndexTablesFile(NULL)
       , mCurrentMinorVersion(0)
+      , mMessageWriter(NULL)
+      , mAsyncWrites(true)
+      , mDropMessagesWhenBehind(false)
+      , mNumDroppedMessages(0)
+      , mNumWriteStalls(0)
+      , mNextMessageIndex(0)
+      , mPrefetchEnd(0)
+      , mPrefetchWindow(256)
+      , mMappedReads(true)
       , mFilesAreOpenForWriting(false)
    {
    }
@@ -78,6 +163,10 @@ namespace dtGame
       // Flush uses this, so don't set this until after FLUSH.
       mFilesAreOpenForWriting = false;
 
+      // Flush normally stops the writer and unmaps the messages already.
+      StopMessageWriter();
+      UnmapMessages();
+
       if (mMessagesFile != NULL)
       {
          LOG_DEBUG("Closing logger messages database file: " + mMessagesFileName);
@@ -96,6 +185,7 @@ namespace dtGame
       mNewTags.clear();
       mExistingKeyFrames.clear();
       mNewKeyFrames.clear();
+      mKeyFrameIds.clear();
    }
 
    //////////////////////////////////////////////////////////////////////////
@@ -151,6 +241,19 @@ namespace dtGame
 
       mFilesAreOpenForWriting = true; // Write mode - Probably in a Record mode.
 
+      mNumDroppedMessages = 0;
+      mNumWriteStalls = 0;
+      if (mAsyncWrites)
+      {
+         mMessageWriter = new AsyncLogStreamWriter(mMessagesFile);
+         mMessageWriter->SetDropWhenFull(mDropMessagesWhenBehind);
+         // If the thread can't start, the writer writes each buffer as it fills on this thread instead.
+         if (mMessageWriter->start() != 0)
+         {
+            LOG_WARNING("Could not start the thread to write the log messages file.  Writing it on the calling thread.");
+         }
+      }
+
       mEndOfStream = false;
    }
 
@@ -207,6 +310,12 @@ namespace dtGame
       ReadMessageDataBaseHeader(msgHeader);
       SetRecordDuration(msgHeader.recordLength);
 
+      if (mMappedReads && !MapMessages(ftell(mMessagesFile)))
+      {
+         LOG_WARNING("Could not map the logger messages database file " + mMessagesFileName +
+            " into memory.  Reading it from the file instead.");
+      }
+
       // For the index file, we need to read the header and the keyframe/log entries
       // contained in it.
       IndexTableHeader indexHeader;
@@ -454,25 +563,43 @@ namespace dtGame
             "Message database file is not valid.", __FILE__, __LINE__);
       }
 
-      unsigned short msgID = msg.GetMessageType().GetId();
-      WriteToLog((char*)&BinaryLogStream::MESSAGE_DEID, 1, 1, mMessagesFile);
-      WriteToLog((char*)&msgID, sizeof(unsigned short), 1, mMessagesFile);
-      WriteToLog((char*)&timeStamp, sizeof(double), 1, mMessagesFile);
-
-      // Make sure we wrote the data properly.
-      CheckFileStatus(mMessagesFile);
+      if (mMessageWriter != NULL && mMessageWriter->HasError())
+      {
+         throw dtGame::LogStreamIOException(mMessageWriter->GetError(), __FILE__, __LINE__);
+      }
 
       // Get the size of the message and write that along with the message data stream.
-      unsigned int bufferSize;
-      dtUtil::DataStream dataStream;
+      mRecordStream.Rewind();
+      dtCore::WriteCompactUniqueId(mRecordStream, msg.GetAboutActorId());
+      dtCore::WriteCompactUniqueId(mRecordStream, msg.GetSendingActorId());
+      msg.ToDataStream(mRecordStream);
+      // The stream is reused, so its size is from the largest message, not this one.
+      unsigned int bufferSize = mRecordStream.GetWritePosition();
+
+      unsigned short msgID = msg.GetMessageType().GetId();
+      char header[MESSAGE_HEADER_SIZE];
+      char* headerPos = header;
+      *headerPos++ = char(BinaryLogStream::MESSAGE_DEID);
+      memcpy(headerPos, &msgID, sizeof(unsigned short));
+      headerPos += sizeof(unsigned short);
+      memcpy(headerPos, &timeStamp, sizeof(double));
+      headerPos += sizeof(double);
+      memcpy(headerPos, &bufferSize, sizeof(unsigned int));
+
+      if (mMessageWriter != NULL)
+      {
+         if (!mMessageWriter->Write(header, sizeof(header), mRecordStream.GetBuffer(), bufferSize)
+                  && mMessageWriter->HasError())
+         {
+            throw dtGame::LogStreamIOException(mMessageWriter->GetError(), __FILE__, __LINE__);
+         }
+         return;
+      }
 
-      dataStream << msg.GetAboutActorId() << msg.GetSendingActorId();
-      msg.ToDataStream(dataStream);
-      bufferSize = dataStream.GetBufferSize();
-      WriteToLog((char*)&bufferSize, sizeof(unsigned int), 1, mMessagesFile);
+      WriteToLog(header, 1, sizeof(header), mMessagesFile);
       if (bufferSize != 0)
       {
-         WriteToLog((char*)dataStream.GetBuffer(), 1, bufferSize, mMessagesFile);
+         WriteToLog(mRecordStream.GetBuffer(), 1, bufferSize, mMessagesFile);
       }
 
       CheckFileStatus(mMessagesFile);
@@ -488,6 +615,24 @@ namespace dtGame
             "Message database file is not valid.", __FILE__, __LINE__);
       }
 
+      if (mMappedMessages.valid())
+      {
+         if (mNextMessageIndex >= mMessageIndex.size())
+         {
+            mEndOfStream = true;
+            return NULL;
+         }
+
+         dtCore::RefPtr<Message> msg = TakePrefetchedMessage(mNextMessageIndex, timeStamp);
+         if (!msg.valid())
+         {
+            msg = DecodeMappedMessage(mNextMessageIndex, timeStamp);
+         }
+         ++mNextMessageIndex;
+         StartPrefetch();
+         return msg;
+      }
+
       if (feof(mMessagesFile))
       {
          mEndOfStream = true;
@@ -520,17 +665,20 @@ namespace dtGame
       dtCore::RefPtr<Message> msg = NULL;
       msg = GetMessageFactory().CreateMessage(msgType);
 
-      // Create a temporary buffer, and read the message from it.
+      // Read the message into the reused buffer, and read the message from it.
       unsigned int bufferSize;
       numRead = fread((char*)&bufferSize, sizeof(unsigned int), 1, mMessagesFile);
       CheckFileStatus(mMessagesFile);
       if (bufferSize != 0)
       {
-         char* tempBuffer = new char[bufferSize];
-         numRead = fread(&tempBuffer[0], 1, bufferSize, mMessagesFile);
+         if (mReadBuffer.size() < bufferSize)
+         {
+            mReadBuffer.resize(bufferSize);
+         }
+         numRead = fread(&mReadBuffer[0], 1, bufferSize, mMessagesFile);
          CheckFileStatus(mMessagesFile);
 
-         dtUtil::DataStream stream(tempBuffer, bufferSize);
+         dtUtil::DataStream stream(&mReadBuffer[0], bufferSize, false);
 
          dtCore::UniqueId sendingActorId, aboutActorId;
          stream >> aboutActorId >> sendingActorId;
@@ -543,6 +691,167 @@ namespace dtGame
       return msg;
    }
 
+   //////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<Message> BinaryLogStream::DecodeMappedMessage(unsigned index, double& timeStamp)
+   {
+      // MapMessages checked that the whole message is in the file.
+      const char* record = mMappedMessages->GetData() + mMessageIndex[index].mOffset;
+      unsigned short msgID;
+      unsigned int bufferSize;
+      memcpy(&msgID, record + 1, sizeof(unsigned short));
+      memcpy(&timeStamp, record + 1 + sizeof(unsigned short), sizeof(double));
+      memcpy(&bufferSize, record + 1 + sizeof(unsigned short) + sizeof(double), sizeof(unsigned int));
+
+      const MessageType& msgType = GetMessageFactory().GetMessageTypeById(msgID);
+      dtCore::RefPtr<Message> msg = GetMessageFactory().CreateMessage(msgType);
+      if (bufferSize != 0)
+      {
+         // The stream is only read, so it is safe to point it at the read only pages.
+         dtUtil::DataStream stream(const_cast<char*>(record + MESSAGE_HEADER_SIZE), bufferSize, false);
+
+         dtCore::UniqueId sendingActorId, aboutActorId;
+         stream >> aboutActorId >> sendingActorId;
+         msg->SetAboutActorId(aboutActorId);
+         msg->SetSendingActorId(sendingActorId);
+         msg->FromDataStream(stream);
+      }
+      return msg;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool BinaryLogStream::MapMessages(long firstMessageOffset)
+   {
+      UnmapMessages();
+
+      dtCore::RefPtr<dtUtil::MappedFile> file = new dtUtil::MappedFile();
+      if (firstMessageOffset < 0 || !file->Open(mMessagesFileName))
+      {
+         return false;
+      }
+
+      // Only the headers are read here.  The pages of message data are read by the OS as playback reaches them.
+      const char* data = file->GetData();
+      const size_t size = file->GetSize();
+      size_t offset = size_t(firstMessageOffset);
+      double latestTime = 0.0;
+      while (offset < size)
+      {
+         unsigned int bufferSize = 0;
+         double timeStamp = 0.0;
+         if (size - offset < MESSAGE_HEADER_SIZE || data[offset] != char(BinaryLogStream::MESSAGE_DEID))
+         {
+            break;
+         }
+         memcpy(&timeStamp, data + offset + 1 + sizeof(unsigned short), sizeof(double));
+         memcpy(&bufferSize, data + offset + 1 + sizeof(unsigned short) + sizeof(double), sizeof(unsigned int));
+         if (size - offset - MESSAGE_HEADER_SIZE < bufferSize)
+         {
+            break;
+         }
+
+         if (mMessageIndex.empty() || timeStamp > latestTime)
+         {
+            latestTime = timeStamp;
+         }
+
+         MessageIndexEntry entry;
+         entry.mOffset = offset;
+         entry.mLatestTime = latestTime;
+         mMessageIndex.push_back(entry);
+         offset += MESSAGE_HEADER_SIZE + bufferSize;
+      }
+
+      if (offset < size)
+      {
+         std::ostringstream ss;
+         ss << "The logger messages database file " << mMessagesFileName << " has a partial or malformed message at "
+            << "offset " << offset << ".  Playback will end with the " << mMessageIndex.size() << " messages before it.";
+         LOG_WARNING(ss.str());
+      }
+
+      mMappedMessages = file;
+      mNextMessageIndex = 0;
+      mPrefetchEnd = 0;
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void BinaryLogStream::UnmapMessages()
+   {
+      // The tasks read the mapping, so they have to be done first.
+      CancelPrefetch();
+      mMappedMessages = NULL;
+      mMessageIndex.clear();
+      mNextMessageIndex = 0;
+      mPrefetchEnd = 0;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void BinaryLogStream::StartPrefetch()
+   {
+      if (mPrefetchWindow == 0 || !dtUtil::ThreadPool::IsInitialized())
+      {
+         return;
+      }
+
+      // Half windows, so one batch can be decoded while the one before it is read.
+      const unsigned batchSize = std::max(mPrefetchWindow / 2U, 1U);
+      const unsigned numMessages = unsigned(mMessageIndex.size());
+      mPrefetchEnd = std::max(mPrefetchEnd, mNextMessageIndex);
+      while (mPrefetchEnd < numMessages && mPrefetchEnd - mNextMessageIndex < mPrefetchWindow)
+      {
+         const unsigned count = std::min(batchSize, numMessages - mPrefetchEnd);
+         dtCore::RefPtr<PrefetchTask> task = new PrefetchTask(*this, mPrefetchEnd, count);
+         mPrefetchTasks.push_back(task);
+         dtUtil::ThreadPool::AddTask(*task, dtUtil::ThreadPool::BACKGROUND);
+         mPrefetchEnd += count;
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<Message> BinaryLogStream::TakePrefetchedMessage(unsigned index, double& timeStamp)
+   {
+      while (!mPrefetchTasks.empty() && mPrefetchTasks.front()->GetEnd() <= index)
+      {
+         mPrefetchTasks.front()->Finish();
+         mPrefetchTasks.pop_front();
+      }
+
+      if (mPrefetchTasks.empty() || index < mPrefetchTasks.front()->mFirst)
+      {
+         return NULL;
+      }
+
+      PrefetchTask& task = *mPrefetchTasks.front();
+      task.Finish();
+
+      dtCore::RefPtr<Message> msg;
+      const unsigned taskIndex = index - task.mFirst;
+      if (taskIndex < task.mNumDecoded)
+      {
+         msg = task.mMessages[taskIndex];
+         task.mMessages[taskIndex] = NULL;
+         timeStamp = task.mTimeStamps[taskIndex];
+      }
+
+      if (index + 1 == task.GetEnd())
+      {
+         mPrefetchTasks.pop_front();
+      }
+      return msg;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void BinaryLogStream::CancelPrefetch()
+   {
+      for (size_t i = 0; i < mPrefetchTasks.size(); ++i)
+      {
+         mPrefetchTasks[i]->Finish();
+      }
+      mPrefetchTasks.clear();
+      mPrefetchEnd = mNextMessageIndex;
+   }
+
    //////////////////////////////////////////////////////////////////////////
    void BinaryLogStream::ReadIndexTables()
    {
@@ -566,6 +875,7 @@ namespace dtGame
 
          case BinaryLogStream::KEYFRAME_DEID:
             mExistingKeyFrames.push_back(ReadKeyFrame());
+            mKeyFrameIds.insert(mExistingKeyFrames.back().GetUniqueId());
             break;
 
          default:
@@ -647,8 +957,10 @@ namespace dtGame
             "The messages database file is invalid.", __FILE__, __LINE__);
       }
 
-      newKeyFrame.SetLogFileOffset(ftell(mMessagesFile));
+      // The writer knows where the next message will land even if it hasn't been written yet.
+      newKeyFrame.SetLogFileOffset(mMessageWriter != NULL ? mMessageWriter->GetFileOffset() : ftell(mMessagesFile));
       mNewKeyFrames.push_back(newKeyFrame);
+      mKeyFrameIds.insert(newKeyFrame.GetUniqueId());
    }
 
    //////////////////////////////////////////////////////////////////////////
@@ -661,40 +973,57 @@ namespace dtGame
       }
 
       // First determine if this keyframe exists within the keyframe index.
-      bool validKeyFrame = false;
-      std::vector<LogKeyframe>::iterator itor;
-
-      for (itor = mExistingKeyFrames.begin(); itor != mExistingKeyFrames.end(); ++itor)
+      if (mKeyFrameIds.find(keyFrame.GetUniqueId()) == mKeyFrameIds.end())
       {
-         if (itor->GetUniqueId() == keyFrame.GetUniqueId())
-         {
-            validKeyFrame = true;
-            break;
-         }
+         throw dtGame::LogStreamIOException( "Cannot jump to keyframe:" +
+            keyFrame.GetName() + " .  The Keyframe has not been added.", __FILE__, __LINE__);
       }
 
-      if (!validKeyFrame)
+      // Now we can proceed with the jump.
+      if (mMappedMessages.valid())
       {
-         for (itor = mNewKeyFrames.begin(); itor != mNewKeyFrames.end(); ++itor)
+         // Find the message the keyframe starts at.  The offsets in the index are in file order.
+         MessageIndexEntry target;
+         target.mOffset = size_t(keyFrame.GetLogFileOffset());
+         target.mLatestTime = 0.0;
+         std::vector<MessageIndexEntry>::const_iterator found = std::lower_bound(mMessageIndex.begin(),
+            mMessageIndex.end(), target, MessageIndexEntry::LessByOffset);
+         bool atEnd = found == mMessageIndex.end();
+         if (keyFrame.GetLogFileOffset() < 0 || (!atEnd && found->mOffset != target.mOffset) ||
+            (atEnd && target.mOffset != mMappedMessages->GetSize()))
          {
-            if (itor->GetUniqueId() == keyFrame.GetUniqueId())
-            {
-               validKeyFrame = true;
-               break;
-            }
+            throw dtGame::LogStreamIOException( "Cannot jump to keyframe:" +
+               keyFrame.GetName() + " .  Its offset is not at a message in the log.", __FILE__, __LINE__);
          }
+
+         mNextMessageIndex = unsigned(found - mMessageIndex.begin());
+         CancelPrefetch();
       }
+      else
+      {
+         fseek(mMessagesFile, keyFrame.GetLogFileOffset(), SEEK_SET);
+         CheckFileStatus(mMessagesFile);
+      }
+      mEndOfStream = false;
+   }
 
-      if (!validKeyFrame)
+   //////////////////////////////////////////////////////////////////////////
+   bool BinaryLogStream::SeekToTime(double simTime)
+   {
+      if (!mMappedMessages.valid())
       {
-         throw dtGame::LogStreamIOException( "Cannot jump to keyframe:" +
-            keyFrame.GetName() + " .  The Keyframe has not been added.", __FILE__, __LINE__);
+         return false;
       }
 
-      // Now we can proceed with the jump.
-      fseek(mMessagesFile, keyFrame.GetLogFileOffset(), SEEK_SET);
-      CheckFileStatus(mMessagesFile);
+      MessageIndexEntry target;
+      target.mOffset = 0;
+      target.mLatestTime = simTime;
+      std::vector<MessageIndexEntry>::const_iterator found = std::lower_bound(mMessageIndex.begin(),
+         mMessageIndex.end(), target, MessageIndexEntry::LessByTime);
+      mNextMessageIndex = unsigned(found - mMessageIndex.begin());
+      CancelPrefetch();
       mEndOfStream = false;
+      return true;
    }
 
    //////////////////////////////////////////////////////////////////////////
@@ -703,6 +1032,10 @@ namespace dtGame
       std::vector<LogTag>::iterator tagItor;
       std::vector<LogKeyframe>::iterator keyFrameItor;
 
+      // The messages file is closed and its header rewritten below, so every message has to be written first.
+      StopMessageWriter();
+      UnmapMessages();
+
       if (mFilesAreOpenForWriting)
       {
          if (mIndexTablesFile == NULL)
@@ -781,14 +1114,107 @@ namespace dtGame
       mMessagesFile = NULL;
    }
 
+   //////////////////////////////////////////////////////////////////////////
+   void BinaryLogStream::StopMessageWriter()
+   {
+      if (mMessageWriter == NULL)
+      {
+         return;
+      }
+
+      mMessageWriter->Stop();
+      mNumDroppedMessages = mMessageWriter->GetDroppedCount();
+      mNumWriteStalls = mMessageWriter->GetStallCount();
+      if (mMessageWriter->HasError())
+      {
+         LOG_ERROR("Failed writing the logger messages database file " + mMessagesFileName + ": " +
+            mMessageWriter->GetError());
+      }
+
+      delete mMessageWriter;
+      mMessageWriter = NULL;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void BinaryLogStream::SetAsyncWrites(bool async)
+   {
+      mAsyncWrites = async;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool BinaryLogStream::GetAsyncWrites() const
+   {
+      return mAsyncWrites;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void BinaryLogStream::SetDropMessagesWhenBehind(bool drop)
+   {
+      mDropMessagesWhenBehind = drop;
+      if (mMessageWriter != NULL)
+      {
+         mMessageWriter->SetDropWhenFull(drop);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool BinaryLogStream::GetDropMessagesWhenBehind() const
+   {
+      return mDropMessagesWhenBehind;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned BinaryLogStream::GetNumDroppedMessages() const
+   {
+      return mMessageWriter != NULL ? mMessageWriter->GetDroppedCount() : mNumDroppedMessages;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned BinaryLogStream::GetNumWriteStalls() const
+   {
+      return mMessageWriter != NULL ? mMessageWriter->GetStallCount() : mNumWriteStalls;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void BinaryLogStream::SetMappedReads(bool mapped)
+   {
+      mMappedReads = mapped;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool BinaryLogStream::GetMappedReads() const
+   {
+      return mMappedReads;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void BinaryLogStream::SetPrefetchWindow(unsigned numMessages)
+   {
+      mPrefetchWindow = numMessages;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned BinaryLogStream::GetPrefetchWindow() const
+   {
+      return mPrefetchWindow;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned BinaryLogStream::GetNumIndexedMessages() const
+   {
+      return unsigned(mMessageIndex.size());
+   }
+
    //////////////////////////////////////////////////////////////////////////
    void BinaryLogStream::WriteTag(const LogTag& tag)
    {
       DataStream stream;
       unsigned int bufferSize;
 
-      stream << tag.GetName() << tag.GetDescription() << tag.GetSimTimeStamp() <<
-         tag.GetUniqueId() << tag.GetKeyframeUniqueId() << tag.GetCaptureKeyframe();
+      stream << tag.GetName() << tag.GetDescription() << tag.GetSimTimeStamp();
+      dtCore::WriteCompactUniqueId(stream, tag.GetUniqueId());
+      dtCore::WriteCompactUniqueId(stream, tag.GetKeyframeUniqueId());
+      stream << tag.GetCaptureKeyframe();
       bufferSize = stream.GetBufferSize();
 
       WriteToLog((char*)&BinaryLogStream::TAG_DEID,1,1,mIndexTablesFile);
@@ -832,8 +1258,9 @@ namespace dtGame
       DataStream stream;
       unsigned int bufferSize;
 
-      stream << keyFrame.GetName() << keyFrame.GetDescription() << keyFrame.GetSimTimeStamp() <<
-         keyFrame.GetUniqueId() << keyFrame.GetTagUniqueId();
+      stream << keyFrame.GetName() << keyFrame.GetDescription() << keyFrame.GetSimTimeStamp();
+      dtCore::WriteCompactUniqueId(stream, keyFrame.GetUniqueId());
+      dtCore::WriteCompactUniqueId(stream, keyFrame.GetTagUniqueId());
 
       const LogKeyframe::NameVector& mapNames = keyFrame.GetActiveMaps();
 
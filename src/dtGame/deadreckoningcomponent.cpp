@@ -28,6 +28,7 @@
 #include <dtUtil/log.h>
 #include <dtUtil/mathdefines.h>
 #include <dtUtil/matrixutil.h>
+#include <dtUtil/threadpool.h>
 #include <dtCore/actortype.h>
 #include <dtGame/gameactor.h>
 #include <dtGame/messagetype.h>
@@ -39,6 +40,40 @@
 
 namespace dtGame
 {
+   //////////////////////////////////////////////////////////////////////
+   class DeadReckoningComponent::DeadReckonTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      DeadReckonTask(DeadReckoningComponent& component)
+         : mComponent(component)
+         , mBegin(0)
+         , mEnd(0)
+         , mSimTimeDelta(0.0f)
+         , mSimTime(0.0)
+      {
+      }
+
+      virtual void operator()()
+      {
+         mComponent.DeadReckonEntries(mBegin, mEnd, mSimTimeDelta, mSimTime);
+      }
+
+      /// The component owns the task, so this doesn't hold a reference.
+      DeadReckoningComponent& mComponent;
+      unsigned mBegin, mEnd;
+      float mSimTimeDelta;
+      double mSimTime;
+   };
+
+   //////////////////////////////////////////////////////////////////////
+   DeadReckoningComponent::RemoteEntry::RemoteEntry()
+      : mDrawable(NULL)
+      , mHelper(NULL)
+      , mGroundClampType(&BaseGroundClamper::GroundClampRangeType::NONE)
+      , mTransformChanged(false)
+   {
+   }
+
    //////////////////////////////////////////////////////////////////////
    const dtCore::RefPtr<dtCore::SystemComponentType> DeadReckoningComponent::TYPE(new dtCore::SystemComponentType("DeadReckoning","GMComponents",
          "Dead-reckons actors.  It can be used on remote controlled actors, and it can be used to calculate dead-reckoning on local actors so it can use that to decide to send updates",
@@ -48,6 +83,7 @@ namespace dtGame
    //////////////////////////////////////////////////////////////////////
    DeadReckoningComponent::DeadReckoningComponent(dtCore::SystemComponentType& type)
       : dtGame::GMComponent(type)
+      , mRemoteEntriesDirty(true)
       , mGroundClamper(new DefaultGroundClamper)
       , mArticSmoothTime(0.5f)
    {
@@ -87,6 +123,8 @@ namespace dtGame
       else if (message.GetMessageType()  == dtGame::MessageType::INFO_MAP_UNLOAD_BEGIN)
       {
          mRegisteredActors.clear();
+         mRemoteEntries.clear();
+         mRemoteEntriesDirty = true;
          mGroundClamper->SetEyePointActor(NULL);
          mGroundClamper->SetTerrainActor(NULL);
       }
@@ -179,7 +217,10 @@ namespace dtGame
             "\" is already registered with a helper in the DeadReckoingComponent with name \"" +
             GetName() +  ".\"" , __FILE__, __LINE__);
       }
-      else if (helper.IsUpdated())
+
+      mRemoteEntriesDirty = true;
+
+      if (helper.IsUpdated())
       {
          if (helper.GetEffectiveUpdateMode(toRegister.IsRemote())
             == DeadReckoningActorComponent::UpdateMode::CALCULATE_AND_MOVE_ACTOR)
@@ -225,6 +266,7 @@ namespace dtGame
       if (itor != mRegisteredActors.end())
       {
          mRegisteredActors.erase(itor);
+         mRemoteEntriesDirty = true;
       }
    }
 
@@ -237,23 +279,52 @@ namespace dtGame
    }
 
    //////////////////////////////////////////////////////////////////////
-   void DeadReckoningComponent::TickRemote(const dtGame::TickMessage& tickMessage)
+   void DeadReckoningComponent::UpdateRemoteEntries()
    {
-      mGroundClamper->UpdateEyePoint();
+      if (!mRemoteEntriesDirty)
+      {
+         return;
+      }
+
+      mRemoteEntriesDirty = false;
+      mRemoteEntries.clear();
+      mRemoteEntries.reserve(mRegisteredActors.size());
 
       for (std::map<dtCore::UniqueId, dtCore::RefPtr<DeadReckoningActorComponent> >::iterator i = mRegisteredActors.begin();
          i != mRegisteredActors.end(); ++i)
       {
-
          dtGame::GameActorProxy* actor = GetGameManager()->FindGameActorById(i->first);
          if (actor == NULL)
+         {
+            // Registered before it was added to the game manager, so look again next tick.
+            mRemoteEntriesDirty = true;
+            continue;
+         }
+
+         RemoteEntry entry;
+         entry.mActor = actor;
+         actor->GetDrawable(entry.mDrawable);
+         entry.mHelper = i->second.get();
+         if (entry.mDrawable != NULL)
+         {
+            mRemoteEntries.push_back(entry);
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::DeadReckonEntries(unsigned begin, unsigned end, float simTimeDelta, double simTime)
+   {
+      for (unsigned i = begin; i < end; ++i)
+      {
+         RemoteEntry& entry = mRemoteEntries[i];
+         const dtGame::GameActorProxy* actor = entry.mActor.get();
+         if (actor == NULL)
          {
             continue;
          }
 
-         dtCore::Transformable* drawable = NULL;
-         actor->GetDrawable(drawable);
-         DeadReckoningActorComponent& helper = *i->second;
+         DeadReckoningActorComponent& helper = *entry.mHelper;
 
          if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
          {
@@ -263,20 +334,83 @@ namespace dtGame
                actor->GetActorType().GetFullName().c_str());
          }
 
-         dtCore::Transform xform;
          //Init the transform with the last deadreckoned position, not
          //the current actual position, because the current actual can be clamped
-         xform.SetTranslation(helper.GetCurrentDeadReckonedTranslation());
-         xform.SetRotation(helper.GetCurrentDeadReckonedRotation());
-
-         // Get the current time delta.
-         float simTimeDelta = tickMessage.GetDeltaSimTime();
-         helper.IncrementTimeSinceUpdate(simTimeDelta, tickMessage.GetSimulationTime());
+         entry.mXform.SetTranslation(helper.GetCurrentDeadReckonedTranslation());
+         entry.mXform.SetRotation(helper.GetCurrentDeadReckonedRotation());
 
+         helper.IncrementTimeSinceUpdate(simTimeDelta, simTime);
 
          // Actual dead reckoning code moved into the helper..
-         BaseGroundClamper::GroundClampRangeType* groundClampingType = &BaseGroundClamper::GroundClampRangeType::NONE;
-         bool transformChanged = helper.DoDR(*drawable, xform, mLogger, groundClampingType);
+         entry.mGroundClampType = &BaseGroundClamper::GroundClampRangeType::NONE;
+         entry.mTransformChanged = helper.DoDR(*entry.mDrawable, entry.mXform, mLogger, entry.mGroundClampType);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////
+   void DeadReckoningComponent::TickRemote(const dtGame::TickMessage& tickMessage)
+   {
+      mGroundClamper->UpdateEyePoint();
+
+      UpdateRemoteEntries();
+
+      const unsigned numEntries = unsigned(mRemoteEntries.size());
+      const float simTimeDelta = tickMessage.GetDeltaSimTime();
+      const double simTime = tickMessage.GetSimulationTime();
+
+      // The dead reckoning of each actor only touches its own helper and transform, so it runs in chunks on
+      // the thread pool.  Clamping and moving the actors is done after, on this thread.
+      unsigned numTasks = 1;
+      if (numEntries >= 2 * MIN_ACTORS_PER_TASK && dtUtil::ThreadPool::HasImmediateWorkerThreads())
+      {
+         // That count includes this thread, which works on the tasks, too.
+         numTasks = std::min(dtUtil::ThreadPool::GetNumImmediateWorkerThreads(), numEntries / MIN_ACTORS_PER_TASK);
+      }
+
+      if (numTasks > 1)
+      {
+         while (mDeadReckonTasks.size() < numTasks)
+         {
+            mDeadReckonTasks.push_back(new DeadReckonTask(*this));
+         }
+
+         const unsigned entriesPerTask = (numEntries + numTasks - 1) / numTasks;
+         for (unsigned i = 0; i < numTasks; ++i)
+         {
+            DeadReckonTask& task = *mDeadReckonTasks[i];
+            task.mBegin = std::min(i * entriesPerTask, numEntries);
+            task.mEnd = std::min(task.mBegin + entriesPerTask, numEntries);
+            task.mSimTimeDelta = simTimeDelta;
+            task.mSimTime = simTime;
+            // The first chunk is left for this thread.
+            if (i > 0)
+            {
+               dtUtil::ThreadPool::AddTask(task);
+            }
+         }
+
+         // Only the dead reckoning tasks are waited on.  ExecuteTasks would also join any other immediate work in the pool.
+         (*mDeadReckonTasks[0])();
+         for (unsigned i = 1; i < numTasks; ++i)
+         {
+            mDeadReckonTasks[i]->WaitUntilComplete();
+         }
+      }
+      else
+      {
+         DeadReckonEntries(0, numEntries, simTimeDelta, simTime);
+      }
+
+      for (unsigned i = 0; i < numEntries; ++i)
+      {
+         RemoteEntry& entry = mRemoteEntries[i];
+         dtGame::GameActorProxy* actor = entry.mActor.get();
+         if (actor == NULL)
+         {
+            continue;
+         }
+
+         DeadReckoningActorComponent& helper = *entry.mHelper;
 
          if (helper.GetDeadReckoningAlgorithm() != DeadReckoningAlgorithm::NONE)
          {
@@ -288,9 +422,9 @@ namespace dtGame
 
                // Call the ground clamper for the current object. The ground clamper should 
                // be smart enough to know what to do with the supplied values.
-               mGroundClamper->ClampToGround(*groundClampingType, tickMessage.GetSimulationTime(),
-                        xform, *actor,
-                        helper.GetGroundClampingData(), transformChanged, velocity);
+               mGroundClamper->ClampToGround(*entry.mGroundClampType, simTime,
+                        entry.mXform, *actor,
+                        helper.GetGroundClampingData(), entry.mTransformChanged, velocity);
 
                if(mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
                {
@@ -303,13 +437,14 @@ namespace dtGame
                }
             }
 
-            DoArticulation(helper, *drawable, tickMessage);
+            DoArticulation(helper, *entry.mDrawable, tickMessage);
          }
          // Clear the updated flag.
          helper.ClearUpdated();
       }
 
-      // Make sure all remaining queued objects for batch clamping are clamped.
+      // Run the batched clamp queries on the thread pool, then write back every clamped transform at once.
+      mGroundClamper->AddBatchTasksToThreadPool();
       mGroundClamper->FinishUp();
    }
 
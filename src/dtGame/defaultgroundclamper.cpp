@@ -30,6 +30,7 @@
 #include <dtUtil/boundingshapeutils.h>
 #include <dtUtil/mathdefines.h>
 #include <dtUtil/matrixutil.h>
+#include <dtUtil/threadpool.h>
 #include <osg/io_utils>
 #include <osg/Matrix>
 #include <cmath>
@@ -39,15 +40,42 @@
 
 namespace dtGame
 {
+   /// The number of line segments one BatchIsector can hold.
+   static const unsigned QUERIES_PER_ISECTOR = 32;
+
+   /////////////////////////////////////////////////////////////////////////////
+   // Runs one isector of the single point clamp batch, either on the thread pool or directly.
+   class ClampBatchIsectorTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      ClampBatchIsectorTask(dtCore::BatchIsector& isector)
+         : mIsector(&isector)
+         , mUseHighestLOD(true)
+      {
+      }
+
+      virtual void operator()()
+      {
+         mIsector->Update(mEyePoint, mUseHighestLOD);
+      }
+
+      /// Owned by the clamper, which also owns this task.
+      dtCore::BatchIsector* mIsector;
+      osg::Vec3 mEyePoint;
+      bool mUseHighestLOD;
+   };
+
    /////////////////////////////////////////////////////////////////////////////
    // DEFAULT GROUND CLAMPER
    /////////////////////////////////////////////////////////////////////////////
    DefaultGroundClamper::DefaultGroundClamper()
       : dtGame::BaseGroundClamper()
       , mTripleIsector(new dtCore::BatchIsector)
-      , mIsector(new dtCore::BatchIsector)
+      , mNumQueriesInTasks(0)
    {
-      mGroundClampBatch.reserve(32);
+      mGroundClampBatch.reserve(QUERIES_PER_ISECTOR);
+      mIsectors.push_back(new dtCore::BatchIsector);
+      mIsectorTasks.push_back(new ClampBatchIsectorTask(*mIsectors.back()));
    }
 
    /////////////////////////////////////////////////////////////////////////////
@@ -70,7 +98,7 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////////////////
    dtCore::BatchIsector& DefaultGroundClamper::GetGroundClampIsector()
    {
-      return *mIsector;
+      return *mIsectors.front();
    }
    
    /////////////////////////////////////////////////////////////////////////////
@@ -394,10 +422,6 @@ namespace dtGame
       {
          runtimeData.SetLastClampedTime(currentTime);
          mGroundClampBatch.push_back(std::make_pair(xform, std::make_pair(&actor, &data)));
-         if(mGroundClampBatch.size() == 32)
-         {
-            RunClampBatch();
-         }
       }
       else
       {
@@ -421,28 +445,33 @@ namespace dtGame
    }
 
    /////////////////////////////////////////////////////////////////////////////
-   void DefaultGroundClamper::RunClampBatch()
+   void DefaultGroundClamper::SetupClampBatchIsectors()
    {
-      if (mGroundClampBatch.empty())
-      {
-         return;
-      }
-
       dtUtil::Log& logger = GetLogger();
       bool debugEnabled = logger.IsLevelEnabled(dtUtil::Log::LOG_DEBUG);
 
-      if(mGroundClampBatch.size() > 32)
+      const unsigned numIsectors = unsigned((mGroundClampBatch.size() + QUERIES_PER_ISECTOR - 1) / QUERIES_PER_ISECTOR);
+      while (mIsectors.size() < numIsectors)
       {
-         logger.LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__, 
-            "Attempted to batch %u entities, when 32 is the max.", mGroundClampBatch.size());        
+         mIsectors.push_back(new dtCore::BatchIsector);
+         mIsectorTasks.push_back(new ClampBatchIsectorTask(*mIsectors.back()));
       }
 
-      mIsector->Reset();
-      mIsector->SetQueryRoot(GetTerrainActor());
+      bool ignoreEyePoint = GetEyePointActor() == NULL;
+      for (unsigned i = 0; i < numIsectors; ++i)
+      {
+         mIsectors[i]->Reset();
+         mIsectors[i]->SetQueryRoot(GetTerrainActor());
+
+         ClampBatchIsectorTask& task = static_cast<ClampBatchIsectorTask&>(*mIsectorTasks[i]);
+         task.mEyePoint = GetLastEyePoint();
+         task.mUseHighestLOD = ignoreEyePoint;
+      }
 
       for (size_t i = 0; i < mGroundClampBatch.size(); ++i)
       {
-         dtCore::BatchIsector::SingleISector& single = mIsector->EnableAndGetISector(i);
+         dtCore::BatchIsector::SingleISector& single =
+            mIsectors[i / QUERIES_PER_ISECTOR]->EnableAndGetISector(int(i % QUERIES_PER_ISECTOR));
 
          if(debugEnabled)
          {
@@ -456,18 +485,63 @@ namespace dtGame
          single.SetSectorAsLineSegment(osg::Vec3(singlePoint[0], singlePoint[1], singlePoint[2] + 100.0f),
                osg::Vec3(singlePoint[0], singlePoint[1], singlePoint[2] - 100.0f));
       }
+   }
 
-      bool ignoreEyePoint = GetEyePointActor() == NULL;
-      if (!mIsector->Update(GetLastEyePoint(), ignoreEyePoint))
+   /////////////////////////////////////////////////////////////////////////////
+   void DefaultGroundClamper::AddBatchTasksToThreadPool()
+   {
+      // Without worker threads, the queries would only run in ExecuteTasks, so let RunClampBatch run them.
+      if (mGroundClampBatch.empty() || !dtUtil::ThreadPool::HasImmediateWorkerThreads())
       {
-         if(debugEnabled)
+         return;
+      }
+
+      SetupClampBatchIsectors();
+      mNumQueriesInTasks = unsigned(mGroundClampBatch.size());
+
+      const unsigned numIsectors = (mNumQueriesInTasks + QUERIES_PER_ISECTOR - 1) / QUERIES_PER_ISECTOR;
+      for (unsigned i = 0; i < numIsectors; ++i)
+      {
+         dtUtil::ThreadPool::AddTask(*mIsectorTasks[i]);
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void DefaultGroundClamper::RunClampBatch()
+   {
+      const bool tasksAdded = mNumQueriesInTasks > 0;
+      if (tasksAdded)
+      {
+         // Make sure the tasks are done with the isectors before reading or reusing them.  Only these tasks
+         // are waited on, and it returns right away for the ones the caller already executed.
+         const unsigned numIsectors = (mNumQueriesInTasks + QUERIES_PER_ISECTOR - 1) / QUERIES_PER_ISECTOR;
+         for (unsigned i = 0; i < numIsectors; ++i)
          {
-            std::ostringstream ss;
-            ss << "Found no hits with batch query.";
-            logger.LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__, ss.str().c_str());
+            mIsectorTasks[i]->WaitUntilComplete();
          }
       }
 
+      if (mGroundClampBatch.empty())
+      {
+         mNumQueriesInTasks = 0;
+         return;
+      }
+
+      dtUtil::Log& logger = GetLogger();
+      bool debugEnabled = logger.IsLevelEnabled(dtUtil::Log::LOG_DEBUG);
+
+      // If more were queued after the tasks were added, run the whole batch here.
+      if (!tasksAdded || mNumQueriesInTasks != mGroundClampBatch.size())
+      {
+         SetupClampBatchIsectors();
+         const size_t numIsectors = (mGroundClampBatch.size() + QUERIES_PER_ISECTOR - 1) / QUERIES_PER_ISECTOR;
+         for (size_t i = 0; i < numIsectors; ++i)
+         {
+            (*mIsectorTasks[i])();
+         }
+      }
+      mNumQueriesInTasks = 0;
+
       // Set the positions even if there are no hits.
       osg::Vec3 normal;
       osg::Vec3 hp;
@@ -485,7 +559,8 @@ namespace dtGame
          osg::Vec3 singlePoint;
          xform.GetTranslation(singlePoint);
 
-         dtCore::BatchIsector::SingleISector& single = mIsector->EnableAndGetISector(index);
+         dtCore::BatchIsector::SingleISector& single =
+            mIsectors[index / QUERIES_PER_ISECTOR]->EnableAndGetISector(int(index % QUERIES_PER_ISECTOR));
 
          dtCore::TransformableActorProxy* actor = i->second.first;
          GroundClampingData* gcData = i->second.second;
@@ -597,10 +672,6 @@ namespace dtGame
          {
             // this should be moved.
             mGroundClampBatch.push_back(std::make_pair(xform, std::make_pair(&actor, &data)));
-            if (mGroundClampBatch.size() == 32)
-            {
-               RunClampBatch();
-            }
          }
          else
          {
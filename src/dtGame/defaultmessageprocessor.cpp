@@ -224,7 +224,7 @@ namespace dtGame
       dtGame::GameManager* gm = GetGameManager();
 
       const dtCore::UniqueId* prototypeID = &msg.GetPrototypeID();
-      bool prototypeEmpty = prototypeID->ToString().empty();
+      bool prototypeEmpty = prototypeID->IsNull();
 
       dtCore::RefPtr<dtGame::GameActorProxy> gap;
       dtCore::RefPtr<const dtCore::ActorType> type = msg.GetActorType();
@@ -236,7 +236,7 @@ namespace dtGame
          if (actor != NULL)
          {
             prototypeID = &actor->GetId();
-            prototypeEmpty = prototypeID->ToString().empty();
+            prototypeEmpty = prototypeID->IsNull();
          }
       }
 
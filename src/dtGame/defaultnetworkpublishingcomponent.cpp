@@ -38,6 +38,7 @@ namespace dtGame
       mLogger = &dtUtil::Log::GetInstance("defaultnetworkpublishingcomponent.cpp");
       //Set the name so subclasses get the same name.
       SetName(DEFAULT_NAME);
+      SetConcurrentSafe(true);
    }
 
    /////////////////////////////////////////////////////////////////////////////
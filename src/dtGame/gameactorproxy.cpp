@@ -131,6 +131,7 @@ namespace dtGame
    , mOwnership(&GameActorProxy::Ownership::SERVER_LOCAL)
    , mLocalActorUpdatePolicy(&GameActorProxy::LocalActorUpdatePolicy::ACCEPT_ALL)
    , mLogger(dtUtil::Log::GetInstance("gameactor.cpp"))
+   , mInvokablesRevision(0U)
    , mIsInGM(false)
    , mPublished(false)
    , mRemote(false)
@@ -1020,6 +1021,7 @@ namespace dtGame
       else
       {
          mInvokables.insert(std::make_pair(newInvokable.GetName(), dtCore::RefPtr<Invokable>(&newInvokable)));
+         ++mInvokablesRevision;
       }
    }
 
@@ -1031,6 +1033,7 @@ namespace dtGame
       if (itor != mInvokables.end())
       {
          mInvokables.erase(itor);
+         ++mInvokablesRevision;
       }
    }
 
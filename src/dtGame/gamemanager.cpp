@@ -262,6 +262,9 @@ namespace dtGame
                   "GM Starting delta message \"" + str + "\"");
       }
 
+      // Applied here rather than in the constructor so the app can change or turn off the pools in the GMSettings first.
+      mGMImpl->UpdateMessagePoolSizes();
+
       if (str == dtCore::System::MESSAGE_POST_EVENT_TRAVERSAL)
       {
          PostEventTraversal(deltaSim, deltaReal);
@@ -301,13 +304,13 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::SendNetworkMessage(const Message& message)
    {
-      mGMImpl->mSendNetworkMessageQueue.push(dtCore::RefPtr<const Message>(&message));
+      mGMImpl->PushQueuedMessage(mGMImpl->mSendNetworkMessageQueue, message);
    }
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::SendMessage(const Message& message)
    {
-      mGMImpl->mSendMessageQueue.push(dtCore::RefPtr<const Message>(&message));
+      mGMImpl->PushQueuedMessage(mGMImpl->mSendMessageQueue, message);
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -435,7 +438,7 @@ namespace dtGame
             // Update mLoadedMaps only when a Map Change takes place.
             // This check is needed to keep the name vec consistent, as single maps may be loaded/unloaded
             // without changing the whole set.
-            if ((*pPrevState == MapChangeStateData::MapChangeState::LOAD || *pPrevState == MapChangeStateData::MapChangeState::UNLOAD) &&
+            if (*pPrevState != MapChangeStateData::MapChangeState::IDLE &&
                mGMImpl->mMapChangeStateData->GetCurrentState() == MapChangeStateData::MapChangeState::IDLE)
             {
                mGMImpl->mLoadedMaps = mGMImpl->mMapChangeStateData->GetNewMapNames();
@@ -520,6 +523,7 @@ namespace dtGame
          {
             id = itor->first;
             UnregisterAllMessageListenersForActor(gameActorProxy);
+            mGMImpl->RemoveActorFromSpatialIndex(gameActorProxy);
             mGMImpl->mGameActorProxyMap.erase(itor);
             mGMImpl->ReparentDanglingDrawables(*this, gameActorProxy.GetDrawable());
             gameActorProxy.SetParentActor(NULL);
@@ -530,8 +534,7 @@ namespace dtGame
             {
                dd->Emancipate();
             }
-            mGMImpl->ClearTimersForActor(mGMImpl->mSimulationTimers, gameActorProxy);
-            mGMImpl->ClearTimersForActor(mGMImpl->mRealTimeTimers, gameActorProxy);
+            mGMImpl->ClearTimersForActor(gameActorProxy);
          }
 
          gameActorProxy.SetGameManager(NULL);
@@ -545,19 +548,19 @@ namespace dtGame
    void GameManager::DoSendNetworkMessages()
    {
       // SEND MESSAGES - Forward Send Messages to all components (no actors)
-      while (!mGMImpl->mSendNetworkMessageQueue.empty())
+      dtCore::RefPtr<const Message> messageRef;
+      while (mGMImpl->PopQueuedMessage(mGMImpl->mSendNetworkMessageQueue, messageRef))
       {
          mGMImpl->mGMStatistics.mStatsNumSendNetworkMessages += 1;
 
-         if (!mGMImpl->mSendNetworkMessageQueue.front().valid())
+         if (!messageRef.valid())
          {
             mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
                "Message in send to network queue is NULL.  Something is majorly wrong with the GameManager.");
             continue;
          }
 
-         DoSendMessageToComponents(*mGMImpl->mSendNetworkMessageQueue.front(), true);
-         mGMImpl->mSendNetworkMessageQueue.pop();
+         DoSendMessageToComponents(*messageRef, true);
       }
    }
 
@@ -569,6 +572,18 @@ namespace dtGame
       dtCore::Timer_t frameTickStartCurrent(0);
       bool isATickLocalMessage = (message.GetMessageType() == MessageType::TICK_LOCAL);
 
+      // Concurrent safe components get the message first, in parallel on the thread pool.  They are finished
+      // before the rest get it below, in order, so they may read the GM while nothing changes it.
+      GMImpl::ComponentDispatchTasks concurrentTasks;
+      if (mGMImpl->mGMSettings->GetConcurrentComponentDispatch() && dtUtil::ThreadPool::IsInitialized())
+      {
+         mGMImpl->StartConcurrentComponentDispatch(message, toNetwork, logComponents, concurrentTasks);
+         if (!concurrentTasks.empty())
+         {
+            mGMImpl->FinishConcurrentComponentDispatch(concurrentTasks, isATickLocalMessage);
+         }
+      }
+
       // Components get messages first
       GMImpl::GMComponentContainer::iterator compItr = mGMImpl->mComponentList.begin();
       while (compItr != mGMImpl->mComponentList.end())
@@ -585,15 +600,21 @@ namespace dtGame
             continue;
          }
 
+         //RefPtr in case it get deleted during a Message. We need to hang onto it for a bit.
+         dtCore::RefPtr<GMComponent>& component = *compItr;
+
+         if (!concurrentTasks.empty() && GMImpl::WasDispatchedConcurrently(concurrentTasks, *component))
+         {
+            ++compItr;
+            continue;
+         }
+
          // Statistics information
          if (logComponents)
          {
             frameTickStartCurrent = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
          }
 
-         //RefPtr in case it get deleted during a Message. We need to hang onto it for a bit.
-         dtCore::RefPtr<GMComponent>& component = *compItr;
-
          if (mGMImpl->mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
          {
             mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
@@ -601,29 +622,7 @@ namespace dtGame
                component->GetName() + "\"");
          }
 
-         try
-         {
-            if (toNetwork)
-            {
-               component->DispatchNetworkMessage(message);
-            }
-            else
-            {
-               component->ProcessMessage(message);
-            }
-         }
-         catch (const dtUtil::Exception& ex)
-         {
-            ex.LogException(dtUtil::Log::LOG_ERROR, *mGMImpl->mLogger);
-         }
-         catch (const std::exception& ex)
-         {
-            LOG_ERROR(std::string("Caught a std::exception derivative: ") + ex.what());
-         }
-         catch (...)
-         {
-            LOG_ERROR("Caught an unknown exception in the GM!  Continuing.");
-         }
+         GMImpl::DeliverMessageToComponent(*component, message, toNetwork, *mGMImpl->mLogger);
 
          // Statistics information
          if (logComponents)
@@ -639,6 +638,34 @@ namespace dtGame
 
          ++compItr;
       }
+
+      mGMImpl->RecycleComponentDispatchTasks(concurrentTasks);
+   }
+
+   namespace
+   {
+      /// Keeps the message listeners from being erased while a message is sent to actors, and erases the unregistered ones after.
+      class ListenerDispatchScope
+      {
+      public:
+         ListenerDispatchScope(GMImpl& impl)
+         : mImpl(impl)
+         {
+            ++mImpl.mListenerDispatchDepth;
+         }
+
+         ~ListenerDispatchScope()
+         {
+            --mImpl.mListenerDispatchDepth;
+            if (mImpl.mListenerDispatchDepth == 0U && mImpl.mListenersNeedCompacting)
+            {
+               mImpl.CompactMessageListeners();
+            }
+         }
+
+      private:
+         GMImpl& mImpl;
+      };
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -653,10 +680,12 @@ namespace dtGame
          throw GMShutdownException();
       }
 
+      ListenerDispatchScope dispatchScope(*mGMImpl);
+
       InvokeGlobalInvokables(message);
 
       // ABOUT ACTOR - The actor itself and others registered against a particular actor
-      if (!message.GetAboutActorId().ToString().empty())
+      if (!message.GetAboutActorId().IsNull())
       {
          // if we have an about actor, first try to send it to the actor itself
          GameActorProxy* aboutActor = FindGameActorById(message.GetAboutActorId());
@@ -673,14 +702,11 @@ namespace dtGame
    void GameManager::DoSendMessages()
    {
       // PROCESS MESSAGES - Send all Process messages to components and interested actors
-      while (!mGMImpl->mSendMessageQueue.empty())
+      dtCore::RefPtr<const Message> messageRef;
+      while (mGMImpl->PopQueuedMessage(mGMImpl->mSendMessageQueue, messageRef))
       {
          mGMImpl->mGMStatistics.mStatsNumProcMessages += 1;
 
-         // Forward to Components first
-         dtCore::RefPtr<const Message> messageRef = mGMImpl->mSendMessageQueue.front();
-         mGMImpl->mSendMessageQueue.pop();
-
          if (!messageRef.valid())
          {
             mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
@@ -696,108 +722,12 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::InvokeGlobalInvokables(const Message& message)
    {
-      // statistics stuff.
-      const bool logActors = mGMImpl->mGMStatistics.ShouldWeLogActors();
-      dtCore::Timer_t frameTickStartCurrent(0);
-      const bool isATickLocalMessage = (message.GetMessageType() == MessageType::TICK_LOCAL);
-
       // GLOBAL INVOKABLES - Process it on globally registered invokables
-
-      //find all matches of MessageType
-      typedef std::pair<GMImpl::GlobalMessageListenerMap::iterator, GMImpl::GlobalMessageListenerMap::iterator> IterPair;
-      IterPair msgTypeMatches = mGMImpl->mGlobalMessageListeners.equal_range(&message.GetMessageType());
-
-      GMImpl::GlobalMessageListenerMap::iterator itor = msgTypeMatches.first;
-
-      while (itor != msgTypeMatches.second)
+      GMImpl::GlobalMessageListenerMap::iterator itor = mGMImpl->mGlobalMessageListeners.find(&message.GetMessageType());
+      if (itor != mGMImpl->mGlobalMessageListeners.end())
       {
-         GMImpl::ProxyInvokablePair& listener = itor->second;
-
-         // hold onto the actor in a refptr so that the stats code
-         // won't crash if the actor unregisters for the message.
-         dtCore::RefPtr<GameActorProxy> listenerActorProxy = listener.first;
-
-         if (listenerActorProxy.valid() == false)
-         {
-            //Erase this value from the container and move on.
-            //Note the postfix operator to increment to the next item
-            mGMImpl->mGlobalMessageListeners.erase(itor++);
-            continue;
-         }
-
-         ++itor;
-
-         Invokable* invokable = NULL;
-
-         if (listenerActorProxy->IsInGM())
-         {
-            invokable = listenerActorProxy->GetInvokable(listener.second);
-         }
-
-
-         if (invokable != NULL)
-         {
-            // Statistics information
-            if (logActors)
-            {
-               frameTickStartCurrent = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
-            }
-
-            try
-            {
-               if (mGMImpl->mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
-               {
-                  mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
-                           "Sending Message Type \"" + message.GetMessageType().GetName() + "\" to Actor \"" +
-                           listenerActorProxy->GetName() + "\" of Type \"" + listenerActorProxy->GetActorType().GetFullName()
-                           + "\"");
-               }
-               invokable->Invoke(message);
-            }
-            catch (const dtUtil::Exception& ex)
-            {
-               ex.LogException(dtUtil::Log::LOG_ERROR, *mGMImpl->mLogger);
-            }
-
-            // Statistics information
-            if (logActors)
-            {
-               double frameTickDelta
-               = mGMImpl->mGMStatistics.mStatsTickClock.DeltaSec(frameTickStartCurrent,
-                                                        mGMImpl->mGMStatistics.mStatsTickClock.Tick());
-
-               mGMImpl->mGMStatistics.UpdateDebugStats(listenerActorProxy->GetId(),
-                                                       listenerActorProxy->GetName(),
-                                                       frameTickDelta,
-                                                       false, isATickLocalMessage);
-            }
-         }
-         else
-         {
-            if (listenerActorProxy->IsInGM())
-            {
-               if (mGMImpl->mLogger->IsLevelEnabled(dtUtil::Log::LOG_WARNING))
-               {
-                  mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
-                                      "Invokable named %s is registered as a listener, but "
-                                      "Proxy %s does not have an invokable by that name.",
-                                      listener.second.c_str(),
-                                      listener.first->GetActorType().GetName().c_str());
-               }
-            }
-            else
-            {
-               if (mGMImpl->mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
-               {
-                  mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
-                                      "Invokable named %s is registered as a listener, "
-                                      "but Proxy %s is no longer in the GM and is probably "
-                                      "being deleted.",
-                                      listener.second.c_str(),
-                                      listenerActorProxy->GetActorType().GetName().c_str());
-               }
-            }
-         }
+         const bool isATickLocalMessage = (message.GetMessageType() == MessageType::TICK_LOCAL);
+         mGMImpl->InvokeMessageListeners(message, itor->second, isATickLocalMessage);
       }
    }
 
@@ -808,7 +738,14 @@ namespace dtGame
       bool logActors = mGMImpl->mGMStatistics.ShouldWeLogActors();
       dtCore::Timer_t frameTickStartCurrent(0);
 
-      std::vector<dtGame::Invokable*> aboutActorInvokables;
+      // The handlers are copied in case one changes the actor's handlers, but into a vector that is kept
+      // for each level of nested messages, so this doesn't allocate once it has grown.
+      std::deque<std::vector<dtGame::Invokable*> >& scratch = mGMImpl->mMessageHandlerScratch;
+      if (scratch.size() < mGMImpl->mListenerDispatchDepth)
+      {
+         scratch.resize(mGMImpl->mListenerDispatchDepth);
+      }
+      std::vector<dtGame::Invokable*>& aboutActorInvokables = scratch[mGMImpl->mListenerDispatchDepth - 1];
 
       aboutActor.GetMessageHandlers(message.GetMessageType(), aboutActorInvokables);
 
@@ -851,89 +788,25 @@ namespace dtGame
                                            frameTickDelta, false, false);
          }
       }
+
+      aboutActorInvokables.clear();
    }
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::InvokeOtherActorInvokables(const Message& message)
    {
-      // statistics stuff.
-      bool logActors = mGMImpl->mGMStatistics.ShouldWeLogActors();
-      dtCore::Timer_t frameTickStartCurrent(0);
-
       // next, sent it to all actors listening to that actor for that message type.
-      // TODO - This should be refactored like we did for the Global
-      // Invokables a few lines up. It should work with the map directly instead of filling lists repeatedly
-      std::vector<std::pair<GameActorProxy*, std::string > > toFill;
-      GetRegistrantsForMessagesAboutActor(message.GetMessageType(), message.GetAboutActorId(), toFill);
-
-      std::vector<std::pair<GameActorProxy*, std::string > >::iterator i, iend;
-      i = toFill.begin();
-      iend = toFill.end();
-      for (;i != iend; ++i)
+      GMImpl::ActorMessageListenerMap::iterator typeItor = mGMImpl->mActorMessageListeners.find(&message.GetMessageType());
+      if (typeItor == mGMImpl->mActorMessageListeners.end())
       {
-         std::pair<GameActorProxy*, std::string >& listener = *i;
-         GameActorProxy& currentProxy = *listener.first;
-         Invokable* invokable = NULL;
-
-         /// Don't want to invoke
-         if (currentProxy.IsInGM())
-         {
-            invokable = currentProxy.GetInvokable(listener.second);
-         }
-
-         if (invokable != NULL)
-         {
-            // Statistics information
-            if (logActors)
-            {
-               frameTickStartCurrent = mGMImpl->mGMStatistics.mStatsTickClock.Tick();
-            }
-
-            try
-            {
-               if (mGMImpl->mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
-               {
-                   mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
-                            "Sending Message Type \"" + message.GetMessageType().GetName() + "\" to Actor \"" +
-                            currentProxy.GetName() + "\" of Type \"" + currentProxy.GetActorType().GetFullName()
-                            + "\"");
-               }
-               invokable->Invoke(message);
-            }
-            catch (const dtUtil::Exception& ex)
-            {
-               ex.LogException(dtUtil::Log::LOG_ERROR, *mGMImpl->mLogger);
-            }
-
-            if (logActors)
-            {
-               double frameTickDelta =
-                  mGMImpl->mGMStatistics.mStatsTickClock.DeltaSec(frameTickStartCurrent,
-                                                         mGMImpl->mGMStatistics.mStatsTickClock.Tick());
-               mGMImpl->mGMStatistics.UpdateDebugStats(currentProxy.GetId(), currentProxy.GetName(),
-                                              frameTickDelta, false, false);
-            }
-         }
-         else if (currentProxy.IsInGM())
-         {
-            if (mGMImpl->mLogger->IsLevelEnabled(dtUtil::Log::LOG_WARNING))
-            {
-               mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
-                                   "Invokable named %s is registered as a listener, but Proxy %s does not have an invokable by that name.",
-                                   listener.second.c_str(), currentProxy.GetActorType().GetName().c_str());
-            }
-         }
-         else
-         {
-            if (mGMImpl->mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
-            {
-               mGMImpl->mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
-                                   "Invokable named %s is registered as a listener, but Proxy %s is no longer in the GM and is probably being deleted.",
-                                   listener.second.c_str(), currentProxy.GetActorType().GetName().c_str());
-            }
-         }
+         return;
       }
 
+      GMImpl::AboutActorListenerMap::iterator actorItor = typeItor->second.find(message.GetAboutActorId());
+      if (actorItor != typeItor->second.end())
+      {
+         mGMImpl->InvokeMessageListeners(message, actorItor->second, false);
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -1158,7 +1031,7 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::AddActor(dtCore::BaseActorObject& actor)
    {
-      if (actor.GetId().ToString().empty())
+      if (actor.GetId().IsNull())
       {
          throw dtGame::InvalidActorStateException(
             "Actors may not be added the GM with an empty unique id", __FILE__, __LINE__);
@@ -1222,6 +1095,7 @@ namespace dtGame
          mGMImpl->AddActorToScene(actor);
 
          mGMImpl->mBaseActorObjectMap.insert(std::make_pair(actor.GetId(), &actor));
+         mGMImpl->UpdateActorInSpatialIndex(actor);
       }
    }
 
@@ -1307,6 +1181,7 @@ namespace dtGame
          bool envChanged = mGMImpl->AddActorToScene(actor);
 
          mGMImpl->mGameActorProxyMap.insert(std::make_pair(actor.GetId(), &actor));
+         mGMImpl->UpdateActorInSpatialIndex(actor);
          if (envChanged) mGMImpl->SendEnvironmentChangedMessage(*this, mGMImpl->mEnvironment.get());
 
 
@@ -1514,8 +1389,7 @@ namespace dtGame
          }
 
          UnregisterAllMessageListenersForActor(gameActorProxy);
-         mGMImpl->ClearTimersForActor(mGMImpl->mSimulationTimers, gameActorProxy);
-         mGMImpl->ClearTimersForActor(mGMImpl->mRealTimeTimers, gameActorProxy);
+         mGMImpl->ClearTimersForActor(gameActorProxy);
 
          gameActorProxy.SetRemote(!local);
 
@@ -1563,6 +1437,7 @@ namespace dtGame
                //mGMImpl->RemoveActorFromScene(*this, *itor->second);
                dd->Emancipate();
                mGMImpl->ReparentDanglingDrawables(*this, dd);
+               mGMImpl->RemoveActorFromSpatialIndex(*itor->second);
                mGMImpl->mBaseActorObjectMap.erase(itor);
             }
          }
@@ -1653,8 +1528,8 @@ namespace dtGame
       // Clear all the timers first so the delete actor calls don't have to
       // iterate over the lists a bunch of times.  We have to clear this list anyway
       // to get rid of the timers not related to actors if no one has cleaned them up.
-      mGMImpl->mRealTimeTimers.clear();
-      mGMImpl->mSimulationTimers.clear();
+      mGMImpl->mRealTimeTimers.Clear();
+      mGMImpl->mSimulationTimers.Clear();
 
       while (!mGMImpl->mBaseActorObjectMap.empty())
       {
@@ -1881,6 +1756,49 @@ namespace dtGame
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::FindActorsInRadius(const osg::Vec3& center, float radius, dtCore::ActorPtrVector& toFill)
+   {
+      toFill.clear();
+      mGMImpl->UpdateActorSpatialIndex();
+      mGMImpl->mActorSpatialIndex.FindInRadius(center, radius, toFill);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::FindActorsInBox(const osg::BoundingBox& box, dtCore::ActorPtrVector& toFill)
+   {
+      toFill.clear();
+      mGMImpl->UpdateActorSpatialIndex();
+      mGMImpl->mActorSpatialIndex.FindInBox(box, toFill);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::FindNearestActors(const osg::Vec3& center, unsigned count, dtCore::ActorPtrVector& toFill,
+            float maxDistance)
+   {
+      toFill.clear();
+      mGMImpl->UpdateActorSpatialIndex();
+      mGMImpl->mActorSpatialIndex.FindNearest(center, count, toFill, maxDistance);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::UpdateSpatialIndex()
+   {
+      mGMImpl->RefreshActorSpatialIndex();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::SetSpatialIndexCellSize(float cellSize)
+   {
+      mGMImpl->mActorSpatialIndex.SetCellSize(cellSize);
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   float GameManager::GetSpatialIndexCellSize() const
+   {
+      return mGMImpl->mActorSpatialIndex.GetCellSize();
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::FindPrototypesByActorType(const dtCore::ActorType& type, dtCore::ActorPtrVector& toFill) const
    {
@@ -2107,30 +2025,22 @@ namespace dtGame
    void GameManager::SetTimer(const std::string& name, const GameActorProxy* aboutActor,
       float time, bool repeat, bool realTime)
    {
-      GMImpl::TimerInfo t;
-      t.name = name;
-
-      if (aboutActor == NULL)
+      dtCore::UniqueId aboutActorId(false);
+      if (aboutActor != NULL)
       {
-         t.aboutActor = dtCore::UniqueId(false);
-      }
-      else
-      {
-         t.aboutActor = aboutActor->GetId();
+         aboutActorId = aboutActor->GetId();
       }
 
-      t.interval = dtCore::Timer_t(time * 1e6);
+      dtCore::Timer_t interval = dtCore::Timer_t(time * 1e6);
       if (realTime)
       {
-         t.time = GetRealClockTime() + t.interval;
+         mGMImpl->mRealTimeTimers.Add(name, aboutActorId, GetRealClockTime() + interval, repeat, interval);
       }
       else
       {
-         t.time = dtCore::Timer_t(GetSimTimeSinceStartup() * 1000000.0) + t.interval;
+         mGMImpl->mSimulationTimers.Add(name, aboutActorId,
+                  dtCore::Timer_t(GetSimTimeSinceStartup() * 1000000.0) + interval, repeat, interval);
       }
-
-      t.repeat = repeat;
-      realTime ? mGMImpl->mRealTimeTimers.insert(t) : mGMImpl->mSimulationTimers.insert(t);
    }
 
 
@@ -2138,31 +2048,41 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::ClearTimer(const std::string& name, const GameActorProxy* actor)
    {
-      mGMImpl->ClearTimerSingleSet(mGMImpl->mRealTimeTimers, name, actor);
-      mGMImpl->ClearTimerSingleSet(mGMImpl->mSimulationTimers, name, actor);
+      dtUtil::RefString timerName(name);
+      const dtCore::UniqueId* aboutActorId = actor != NULL ? &actor->GetId() : NULL;
+      mGMImpl->mRealTimeTimers.Remove(timerName, aboutActorId);
+      mGMImpl->mSimulationTimers.Remove(timerName, aboutActorId);
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void GameManager::GetRegistrantsForMessages(const MessageType& type,
-         std::vector< std::pair<GameActorProxy*, std::string> >& toFill) const
+   static void FillRegistrants(const GMImpl::MessageListenerList& listeners,
+         std::vector< std::pair<GameActorProxy*, std::string> >& toFill)
    {
-      typedef std::pair<GMImpl::GlobalMessageListenerMap::const_iterator,
-                        GMImpl::GlobalMessageListenerMap::const_iterator> IterPair;
-      IterPair msgTypeMatches = mGMImpl->mGlobalMessageListeners.equal_range(&type);
-
-      toFill.clear();
-      toFill.reserve(std::distance(msgTypeMatches.first, msgTypeMatches.second));
-
-      GMImpl::GlobalMessageListenerMap::const_iterator itor = msgTypeMatches.first;
+      toFill.reserve(listeners.size());
 
-      while (itor != msgTypeMatches.second)
+      GMImpl::MessageListenerList::const_iterator i, iend;
+      i = listeners.begin();
+      iend = listeners.end();
+      for (; i != iend; ++i)
       {
          // add the game actor and invokable name to a new pair in the vector.
-         if (itor->second.first.valid())
+         if (i->mActor.valid())
          {
-            toFill.push_back(std::make_pair(itor->second.first.get(), itor->second.second));
+            toFill.push_back(std::make_pair(i->mActor.get(), i->mInvokableName));
          }
-         ++itor;
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void GameManager::GetRegistrantsForMessages(const MessageType& type,
+         std::vector< std::pair<GameActorProxy*, std::string> >& toFill) const
+   {
+      toFill.clear();
+
+      GMImpl::GlobalMessageListenerMap::const_iterator itor = mGMImpl->mGlobalMessageListeners.find(&type);
+      if (itor != mGMImpl->mGlobalMessageListeners.end())
+      {
+         FillRegistrants(itor->second, toFill);
       }
    }
 
@@ -2177,18 +2097,10 @@ namespace dtGame
 
       if (itor != mGMImpl->mActorMessageListeners.end())
       {
-         typedef std::pair<GMImpl::ProxyInvokableMap::const_iterator,
-                           GMImpl::ProxyInvokableMap::const_iterator> IterPair;
-
-         //second on itor is the internal map.
-         IterPair foundBeginEnd = itor->second.equal_range(targetActorId);
-         toFill.reserve(std::distance(foundBeginEnd.first, foundBeginEnd.second));
-
-         GMImpl::ProxyInvokableMap::const_iterator targetActorItor = foundBeginEnd.first;
-         while (targetActorItor != foundBeginEnd.second)
+         GMImpl::AboutActorListenerMap::const_iterator actorItor = itor->second.find(targetActorId);
+         if (actorItor != itor->second.end())
          {
-            toFill.push_back(std::make_pair(targetActorItor->second.first.get(), targetActorItor->second.second));
-            ++targetActorItor;
+            FillRegistrants(actorItor->second, toFill);
          }
       }
    }
@@ -2214,32 +2126,25 @@ namespace dtGame
    {
       ValidateMessageType(type, actor, invokableName);
 
-      mGMImpl->mGlobalMessageListeners.insert(
-            std::make_pair(&type,
-                  std::make_pair(dtCore::RefPtr<GameActorProxy>(&actor), invokableName)));
-
+      mGMImpl->mGlobalMessageListeners[&type].push_back(MessageListener(actor, invokableName));
    }
 
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::UnregisterForMessages(const MessageType& type, GameActorProxy& actor,
                                            const std::string& invokableName)
    {
-      typedef std::pair<GMImpl::GlobalMessageListenerMap::iterator, GMImpl::GlobalMessageListenerMap::iterator> IterPair;
-
-      //find all matches of MessageType
-      IterPair msgTypeMatches = mGMImpl->mGlobalMessageListeners.equal_range(&type);
+      GMImpl::GlobalMessageListenerMap::iterator itor = mGMImpl->mGlobalMessageListeners.find(&type);
+      if (itor == mGMImpl->mGlobalMessageListeners.end())
+      {
+         return;
+      }
 
-      //NULL out the one that also match the supplied actor and invokableName
-      for (GMImpl::GlobalMessageListenerMap::iterator itor = msgTypeMatches.first;
-                                              itor != msgTypeMatches.second;
-                                              ++itor)
+      GMImpl::MessageListenerList& listeners = itor->second;
+      for (GMImpl::MessageListenerList::iterator i = listeners.begin(); i != listeners.end(); ++i)
       {
-         if (itor->second.first.get() == &actor &&
-             itor->second.second == invokableName)
+         if (i->mActor.get() == &actor && i->mInvokableName == invokableName)
          {
-            //we'll actually erase this item next time it's invoked
-            itor->second.first = NULL;
-            itor->second.second = "";
+            mGMImpl->RemoveMessageListener(listeners, i);
             return;
          }
       }
@@ -2252,8 +2157,8 @@ namespace dtGame
    {
       ValidateMessageType(type, actor, invokableName);
 
-      GMImpl::ProxyInvokableMap& mapForType = mGMImpl->mActorMessageListeners[&type];
-      mapForType.insert(std::make_pair(targetActorId, std::make_pair(dtCore::RefPtr<GameActorProxy>(&actor), invokableName)));
+      GMImpl::MessageListenerList& listeners = mGMImpl->mActorMessageListeners[&type][targetActorId];
+      listeners.push_back(MessageListener(actor, invokableName));
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -2265,23 +2170,49 @@ namespace dtGame
 
       if (itor != mGMImpl->mActorMessageListeners.end())
       {
-         //second on itor is the internal map.
-         GMImpl::ProxyInvokableMap::iterator itorInner = itor->second.find(targetActorId);
-         while (itorInner != itor->second.end() && itorInner->first == targetActorId)
+         GMImpl::AboutActorListenerMap::iterator actorItor = itor->second.find(targetActorId);
+         if (actorItor == itor->second.end())
          {
-            //second is a pair.
-            //second.first is the game actor to receive the message second.second is the name of the invokable
-            if (itorInner->second.first.get() == &actor && itorInner->second.second == invokableName)
+            return;
+         }
+
+         GMImpl::MessageListenerList& listeners = actorItor->second;
+         GMImpl::MessageListenerList::iterator i = listeners.begin();
+         while (i != listeners.end())
+         {
+            if (i->mActor.get() == &actor && i->mInvokableName == invokableName)
             {
-               GMImpl::ProxyInvokableMap::iterator toDelete = itorInner;
-               ++itorInner;
-               itor->second.erase(toDelete);
+               i = mGMImpl->RemoveMessageListener(listeners, i);
             }
             else
             {
-               ++itorInner;
+               ++i;
             }
          }
+
+         // The list can only be erased when no message is using it.
+         if (listeners.empty() && mGMImpl->mListenerDispatchDepth == 0U)
+         {
+            itor->second.erase(actorItor);
+         }
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   static void RemoveAllMessageListeners(GMImpl& impl, GMImpl::AboutActorListenerMap& aboutActorListeners,
+         GMImpl::AboutActorListenerMap::iterator aboutItor)
+   {
+      if (impl.mListenerDispatchDepth == 0U)
+      {
+         aboutActorListeners.erase(aboutItor);
+         return;
+      }
+
+      GMImpl::MessageListenerList& listeners = aboutItor->second;
+      GMImpl::MessageListenerList::iterator i = listeners.begin();
+      while (i != listeners.end())
+      {
+         i = impl.RemoveMessageListener(listeners, i);
       }
    }
 
@@ -2289,30 +2220,72 @@ namespace dtGame
    void GameManager::UnregisterAllMessageListenersForActor(GameActorProxy& actor)
    {
       for (GMImpl::GlobalMessageListenerMap::iterator i = mGMImpl->mGlobalMessageListeners.begin();
-           i != mGMImpl->mGlobalMessageListeners.end();)
+           i != mGMImpl->mGlobalMessageListeners.end(); ++i)
       {
-         GMImpl::GlobalMessageListenerMap::iterator toDelete = i;
-         ++i;
-         if (toDelete->second.first.get() == &actor)
+         GMImpl::MessageListenerList& listeners = i->second;
+         GMImpl::MessageListenerList::iterator j = listeners.begin();
+         while (j != listeners.end())
          {
-            mGMImpl->mGlobalMessageListeners.erase(toDelete);
+            if (j->mActor.get() == &actor)
+            {
+               j = mGMImpl->RemoveMessageListener(listeners, j);
+            }
+            else
+            {
+               ++j;
+            }
          }
       }
 
+      const dtCore::DeltaDrawable* drawable = actor.GetDrawable();
+      const bool drawableIdDiffers = drawable != NULL && drawable->GetUniqueId() != actor.GetId();
+
       for (GMImpl::ActorMessageListenerMap::iterator i = mGMImpl->mActorMessageListeners.begin(); i != mGMImpl->mActorMessageListeners.end(); ++i)
       {
-         for (GMImpl::ProxyInvokableMap::iterator j = i->second.begin(); j != i->second.end();)
+         GMImpl::AboutActorListenerMap& aboutActorListeners = i->second;
+
+         // Everything registered about the actor goes.
+         GMImpl::AboutActorListenerMap::iterator aboutItor = aboutActorListeners.find(actor.GetId());
+         if (aboutItor != aboutActorListeners.end())
+         {
+            RemoveAllMessageListeners(*mGMImpl, aboutActorListeners, aboutItor);
+         }
+
+         if (drawableIdDiffers)
          {
-            GMImpl::ProxyInvokableMap::iterator toDelete = j;
-            ++j;
-            if (toDelete->first == actor.GetId()  ||  toDelete->second.first.get() == &actor )
+            aboutItor = aboutActorListeners.find(drawable->GetUniqueId());
+            if (aboutItor != aboutActorListeners.end())
             {
-               i->second.erase(toDelete);
+               LOG_WARNING("Actor Object and drawable have different IDs and found a message registration for the drawable, not the actor.");
+               RemoveAllMessageListeners(*mGMImpl, aboutActorListeners, aboutItor);
             }
-            else if (actor.GetDrawable() != NULL && toDelete->first == actor.GetDrawable()->GetUniqueId())
+         }
+
+         // And so does everything the actor registered about other actors.
+         GMImpl::AboutActorListenerMap::iterator j = aboutActorListeners.begin();
+         while (j != aboutActorListeners.end())
+         {
+            GMImpl::MessageListenerList& listeners = j->second;
+            GMImpl::MessageListenerList::iterator k = listeners.begin();
+            while (k != listeners.end())
             {
-               LOG_WARNING("Actor Object and drawable have different IDs and found a message registration for the drawable, not the actor.");
-               i->second.erase(toDelete);
+               if (k->mActor.get() == &actor)
+               {
+                  k = mGMImpl->RemoveMessageListener(listeners, k);
+               }
+               else
+               {
+                  ++k;
+               }
+            }
+
+            if (listeners.empty() && mGMImpl->mListenerDispatchDepth == 0U)
+            {
+               aboutActorListeners.erase(j++);
+            }
+            else
+            {
+               ++j;
             }
          }
       }
@@ -2358,6 +2331,9 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    void GameManager::Shutdown()
    {
+      // Don't leave maps opening on the thread pool while everything is torn down.
+      mGMImpl->mMapChangeStateData->CancelOpenNewMaps();
+
       if (!mGMImpl->mLoadedMaps.empty())
       {
          dtCore::Project& project = dtCore::Project::GetInstance();
@@ -2401,14 +2377,13 @@ namespace dtGame
 
       mGMImpl->mGMStatistics.mDebugLoggerInformation.clear();
 
-      while (!mGMImpl->mSendNetworkMessageQueue.empty())
+      dtCore::RefPtr<const Message> discarded;
+      while (mGMImpl->PopQueuedMessage(mGMImpl->mSendNetworkMessageQueue, discarded))
       {
-         mGMImpl->mSendNetworkMessageQueue.pop();
       }
 
-      while (!mGMImpl->mSendMessageQueue.empty())
+      while (mGMImpl->PopQueuedMessage(mGMImpl->mSendMessageQueue, discarded))
       {
-         mGMImpl->mSendMessageQueue.pop();
       }
 
       mGMImpl->mShuttingDown = true;
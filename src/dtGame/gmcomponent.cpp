@@ -29,6 +29,7 @@ namespace dtGame
    GMComponent::GMComponent(dtCore::SystemComponentType& type)
    : BaseClass()
    , mComponentPriority(&GameManager::ComponentPriority::NORMAL)
+   , mConcurrentSafe(false)
    , mType(&type)
    , mParent(NULL)
    , mInitialized(false)
@@ -40,6 +41,7 @@ namespace dtGame
    GMComponent::GMComponent(const std::string& name)
    : BaseClass()
    , mComponentPriority(&GameManager::ComponentPriority::NORMAL)
+   , mConcurrentSafe(false)
    , mType(new dtCore::SystemComponentType(name, "GMComponents", "An In-code type", BaseGMComponentType))
    , mParent(NULL)
    , mInitialized(false)
@@ -75,6 +77,13 @@ namespace dtGame
    }
 
    DT_IMPLEMENT_ACCESSOR(GMComponent, dtUtil::EnumerationPointer<GameManager::ComponentPriority>, ComponentPriority)
+   DT_IMPLEMENT_ACCESSOR(GMComponent, bool, ConcurrentSafe)
+
+   //////////////////////////////////////////////
+   bool GMComponent::IsConcurrentSafeFor(const Message& message) const
+   {
+      return GetConcurrentSafe();
+   }
 
    //////////////////////////////////////////////
    /*override*/ void GMComponent::BuildPropertyMap()
@@ -119,6 +128,7 @@ namespace dtGame
    //////////////////////////////////////////////
    GMComponent::GMComponent(const GMComponent&)
    : mComponentPriority(&GameManager::ComponentPriority::NORMAL)
+   , mConcurrentSafe(false)
    , mType(NULL)
    , mParent(NULL)
    , mInitialized(false)
@@ -21,52 +21,24 @@
 #include <prefix/dtgameprefix.h>
 #include <dtGame/gmimpl.h>
 #include <dtGame/basemessages.h>
+#include <dtGame/gameactorproxy.h>
+#include <dtGame/invokable.h>
 #include <dtGame/messagetype.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
+#include <dtUtil/exception.h>
+#include <dtUtil/log.h>
+#include <OpenThreads/ScopedLock>
+
+#include <algorithm>
 
 namespace dtGame
 {
 //////////////////////////////////////////////////////////////////////////
-void GMImpl::ClearTimerSingleSet(std::set<TimerInfo> &timerSet,
-                                         const std::string &name,
-                                         const GameActorProxy *proxy)
+void GMImpl::ClearTimersForActor(const GameActorProxy& actor)
 {
-   std::set<TimerInfo>::iterator i = timerSet.begin();
-   while (i != timerSet.end())
-   {
-      std::set<TimerInfo>::iterator toDelete;
-      const TimerInfo& timer = *i;
-      if (timer.name == name &&  (proxy == NULL || timer.aboutActor == proxy->GetId()))
-      {
-         toDelete = i;
-         ++i;
-         timerSet.erase(toDelete);
-      }
-      else
-      {
-         ++i;
-      }
-   }
-}
-
-//////////////////////////////////////////////////////////////////////////
-void GMImpl::ClearTimersForActor(std::set<TimerInfo>& timerSet, const GameActorProxy& actor)
-{
-   std::set<TimerInfo>::iterator i = timerSet.begin();
-   while (i != timerSet.end())
-   {
-      std::set<TimerInfo>::iterator toDelete;
-      const TimerInfo& timer = *i;
-      if (timer.aboutActor == actor.GetId())
-      {
-         toDelete = i;
-         ++i;
-         timerSet.erase(toDelete);
-      }
-      else
-      {
-         ++i;
-      }
-   }
+   mSimulationTimers.RemoveForActor(actor.GetId());
+   mRealTimeTimers.RemoveForActor(actor.GetId());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -81,49 +53,80 @@ GMImpl::GMImpl(dtCore::Scene& scene) : mGMStatistics()
 , mApplication(NULL)
 , mLogger(&dtUtil::Log::GetInstance("gamemanager.cpp"))
 , mGMSettings(new GMSettings())
+, mTickMessagePoolSize(0U)
+, mTimerMessagePoolSize(0U)
+, mActorUpdateMessagePoolSize(0U)
+, mListenerDispatchDepth(0U)
+, mListenersNeedCompacting(false)
 , mRemoveGameEventsOnMapChange(true)
 , mShuttingDown(false)
 {
 
 }
+
 ////////////////////////////////////////////////////////////////////////////////
-void GMImpl::ProcessTimers(GameManager& gm, std::set<TimerInfo>& listToProcess, dtCore::Timer_t clockTime)
+GMImpl::~GMImpl()
 {
-   std::set<TimerInfo>::iterator itor;
-   std::set<TimerInfo> repeatingTimers;
-   for (itor=listToProcess.begin(); itor!=listToProcess.end();)
+   // Actors can outlive the GM, so their drawables must not call back into it.
+   ActorSpatialEntryMap::iterator i, iend;
+   i = mActorSpatialEntries.begin();
+   iend = mActorSpatialEntries.end();
+   for (; i != iend; ++i)
    {
-      if (itor->time <= clockTime)
+      if (i->second.mTransformable.valid())
       {
-         dtCore::RefPtr<TimerElapsedMessage> timerMsg =
-            static_cast<TimerElapsedMessage*>(mFactory.CreateMessage(MessageType::INFO_TIMER_ELAPSED).get());
+         i->second.mTransformable->SetTransformChangedCallback(dtCore::Transformable::TransformChangedCallback());
+      }
+   }
+}
 
-         timerMsg->SetTimerName(itor->name);
-         float lateTime = float((clockTime - itor->time));
-         // convert from microseconds to seconds
-         lateTime /= 1e6;
-         timerMsg->SetLateTime(lateTime);
-         timerMsg->SetAboutActorId(itor->aboutActor);
-         gm.SendMessage(*timerMsg.get());
-         if (itor->repeat)
-         {
-            TimerInfo tInfo = *itor;
-            tInfo.time += tInfo.interval;
-            repeatingTimers.insert(tInfo);
-         }
+////////////////////////////////////////////////////////////////////////////////
+void GMImpl::UpdateMessagePoolSizes()
+{
+   if (mGMSettings->GetTickMessagePoolSize() != mTickMessagePoolSize)
+   {
+      mTickMessagePoolSize = mGMSettings->GetTickMessagePoolSize();
+      mFactory.SetMessagePoolSize(MessageType::TICK_LOCAL, mTickMessagePoolSize);
+      mFactory.SetMessagePoolSize(MessageType::TICK_REMOTE, mTickMessagePoolSize);
+      mFactory.SetMessagePoolSize(MessageType::TICK_END_OF_FRAME, mTickMessagePoolSize);
+      mFactory.SetMessagePoolSize(MessageType::SYSTEM_POST_EVENT_TRAVERSAL, mTickMessagePoolSize);
+      mFactory.SetMessagePoolSize(MessageType::SYSTEM_FRAME_SYNCH, mTickMessagePoolSize);
+      mFactory.SetMessagePoolSize(MessageType::SYSTEM_POST_FRAME, mTickMessagePoolSize);
+   }
 
-         std::set<TimerInfo>::iterator toDelete = itor;
-         ++itor;
-         listToProcess.erase(toDelete);
-      }
-      else
-      {
-         break;
-      }
+   if (mGMSettings->GetTimerMessagePoolSize() != mTimerMessagePoolSize)
+   {
+      mTimerMessagePoolSize = mGMSettings->GetTimerMessagePoolSize();
+      mFactory.SetMessagePoolSize(MessageType::INFO_TIMER_ELAPSED, mTimerMessagePoolSize);
+   }
+
+   if (mGMSettings->GetActorUpdateMessagePoolSize() != mActorUpdateMessagePoolSize)
+   {
+      mActorUpdateMessagePoolSize = mGMSettings->GetActorUpdateMessagePoolSize();
+      mFactory.SetMessagePoolSize(MessageType::INFO_ACTOR_UPDATED, mActorUpdateMessagePoolSize);
    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GMImpl::ProcessTimers(GameManager& gm, TimerWheel& timers, dtCore::Timer_t clockTime)
+{
+   // Repeating timers are rescheduled by the wheel, but only expire once per call.
+   timers.Advance(clockTime, mExpiredTimers);
+   for (unsigned i = 0; i < mExpiredTimers.size(); ++i)
+   {
+      const TimerWheel::ExpiredTimer& timer = mExpiredTimers[i];
+      dtCore::RefPtr<TimerElapsedMessage> timerMsg =
+         static_cast<TimerElapsedMessage*>(mFactory.CreateMessage(MessageType::INFO_TIMER_ELAPSED).get());
 
-   // Repeating timers have to be readded so they are processed again later
-   listToProcess.insert(repeatingTimers.begin(), repeatingTimers.end());
+      timerMsg->SetTimerName(timer.mName);
+      float lateTime = float((clockTime - timer.mTime));
+      // convert from microseconds to seconds
+      lateTime /= 1e6;
+      timerMsg->SetLateTime(lateTime);
+      timerMsg->SetAboutActorId(timer.mAboutActor);
+      gm.SendMessage(*timerMsg.get());
+   }
+   mExpiredTimers.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -323,4 +326,511 @@ bool GMImpl::AddActorToScene(GameActorProxy& actor)
    return envChanged;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::DeliverMessageToComponent(GMComponent& component, const Message& message, bool toNetwork, dtUtil::Log& logger)
+{
+   try
+   {
+      if (toNetwork)
+      {
+         component.DispatchNetworkMessage(message);
+      }
+      else
+      {
+         component.ProcessMessage(message);
+      }
+   }
+   catch (const dtUtil::Exception& ex)
+   {
+      ex.LogException(dtUtil::Log::LOG_ERROR, logger);
+   }
+   catch (const std::exception& ex)
+   {
+      logger.LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
+         std::string("Caught a std::exception derivative: ") + ex.what());
+   }
+   catch (...)
+   {
+      logger.LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
+         "Caught an unknown exception in the GM!  Continuing.");
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::StartConcurrentComponentDispatch(const Message& message, bool toNetwork, bool timed, ComponentDispatchTasks& tasksOut)
+{
+   GMComponentContainer::iterator i, iend;
+   i = mComponentList.begin();
+   iend = mComponentList.end();
+   for (; i != iend; ++i)
+   {
+      // Invalid entries are erased by the serial loop.
+      if (!i->valid() || !(*i)->IsConcurrentSafeFor(message))
+      {
+         continue;
+      }
+
+      if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+      {
+         mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
+            "Sending Message Type \"" + message.GetMessageType().GetName() + "\" concurrently to GMComponent \"" +
+            (*i)->GetName() + "\"");
+      }
+
+      dtCore::RefPtr<ComponentDispatchTask> task;
+      if (mFreeComponentDispatchTasks.empty())
+      {
+         task = new ComponentDispatchTask(*mLogger);
+      }
+      else
+      {
+         task = mFreeComponentDispatchTasks.back();
+         mFreeComponentDispatchTasks.pop_back();
+      }
+
+      task->Setup(**i, message, toNetwork, timed);
+      tasksOut.push_back(task);
+      // The first task is left for the calling thread in FinishConcurrentComponentDispatch.
+      if (tasksOut.size() > 1U && dtUtil::ThreadPool::HasImmediateWorkerThreads())
+      {
+         dtUtil::ThreadPool::AddTask(*task);
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::FinishConcurrentComponentDispatch(ComponentDispatchTasks& tasks, bool tickLocal)
+{
+   // Only the dispatch tasks are waited on.  ExecuteTasks would also join any other immediate work in the pool.
+   bool queued = dtUtil::ThreadPool::HasImmediateWorkerThreads();
+
+   ComponentDispatchTasks::iterator i, iend;
+   i = tasks.begin();
+   iend = tasks.end();
+   for (; i != iend; ++i)
+   {
+      ComponentDispatchTask& task = **i;
+      if (queued && i != tasks.begin())
+      {
+         task.WaitUntilComplete();
+      }
+      else
+      {
+         task();
+      }
+
+      // The statistics aren't thread safe, so the timing is added here rather than in the tasks.
+      if (task.GetTimed())
+      {
+         mGMStatistics.UpdateDebugStats(task.GetComponent()->GetId(), task.GetComponent()->GetName(),
+            task.GetElapsedTime(), true, tickLocal);
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool GMImpl::WasDispatchedConcurrently(const ComponentDispatchTasks& tasks, const GMComponent& component)
+{
+   ComponentDispatchTasks::const_iterator i, iend;
+   i = tasks.begin();
+   iend = tasks.end();
+   for (; i != iend; ++i)
+   {
+      if ((*i)->GetComponent() == &component)
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::RecycleComponentDispatchTasks(ComponentDispatchTasks& tasks)
+{
+   ComponentDispatchTasks::iterator i, iend;
+   i = tasks.begin();
+   iend = tasks.end();
+   for (; i != iend; ++i)
+   {
+      (*i)->Clear();
+      mFreeComponentDispatchTasks.push_back(*i);
+   }
+   tasks.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::PushQueuedMessage(MessageQueue& queue, const Message& message)
+{
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMessageQueueMutex);
+   queue.push(dtCore::RefPtr<const Message>(&message));
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool GMImpl::PopQueuedMessage(MessageQueue& queue, dtCore::RefPtr<const Message>& messageOut)
+{
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMessageQueueMutex);
+   if (queue.empty())
+   {
+      return false;
+   }
+   messageOut = queue.front();
+   queue.pop();
+   return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+ComponentDispatchTask::ComponentDispatchTask(dtUtil::Log& logger)
+: mLogger(logger)
+, mElapsedTime(0.0)
+, mToNetwork(false)
+, mTimed(false)
+{
+   SetName("ComponentDispatchTask");
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ComponentDispatchTask::Setup(GMComponent& component, const Message& message, bool toNetwork, bool timed)
+{
+   mComponent = &component;
+   mMessage = &message;
+   mToNetwork = toNetwork;
+   mTimed = timed;
+   mElapsedTime = 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ComponentDispatchTask::Clear()
+{
+   mComponent = NULL;
+   mMessage = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ComponentDispatchTask::operator()()
+{
+   dtCore::Timer_t start(0);
+   if (mTimed)
+   {
+      start = mClock.Tick();
+   }
+
+   GMImpl::DeliverMessageToComponent(*mComponent, *mMessage, mToNetwork, mLogger);
+
+   if (mTimed)
+   {
+      mElapsedTime = mClock.DeltaSec(start, mClock.Tick());
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::InvokeMessageListeners(const Message& message, MessageListenerList& listeners, bool tickLocalStats)
+{
+   const bool logActors = mGMStatistics.ShouldWeLogActors();
+   dtCore::Timer_t frameTickStartCurrent(0);
+
+   // Index rather than iterate because an invokable may register a listener, which can reallocate the list.
+   // Unregistering only clears entries while this runs, so the count never shrinks.
+   const size_t numListeners = listeners.size();
+   for (size_t i = 0; i < numListeners; ++i)
+   {
+      // hold onto the actor in a refptr so that the stats code
+      // won't crash if the actor unregisters for the message.
+      dtCore::RefPtr<GameActorProxy> listenerActorProxy = listeners[i].mActor;
+
+      if (!listenerActorProxy.valid())
+      {
+         continue;
+      }
+
+      Invokable* invokable = NULL;
+
+      if (listenerActorProxy->IsInGM())
+      {
+         invokable = listeners[i].GetInvokable();
+      }
+
+      if (invokable != NULL)
+      {
+         // Statistics information
+         if (logActors)
+         {
+            frameTickStartCurrent = mGMStatistics.mStatsTickClock.Tick();
+         }
+
+         try
+         {
+            if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+            {
+               mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
+                        "Sending Message Type \"" + message.GetMessageType().GetName() + "\" to Actor \"" +
+                        listenerActorProxy->GetName() + "\" of Type \"" + listenerActorProxy->GetActorType().GetFullName()
+                        + "\"");
+            }
+            invokable->Invoke(message);
+         }
+         catch (const dtUtil::Exception& ex)
+         {
+            ex.LogException(dtUtil::Log::LOG_ERROR, *mLogger);
+         }
+
+         // Statistics information
+         if (logActors)
+         {
+            double frameTickDelta =
+               mGMStatistics.mStatsTickClock.DeltaSec(frameTickStartCurrent, mGMStatistics.mStatsTickClock.Tick());
+
+            mGMStatistics.UpdateDebugStats(listenerActorProxy->GetId(), listenerActorProxy->GetName(),
+                                           frameTickDelta, false, tickLocalStats);
+         }
+      }
+      else if (listenerActorProxy->IsInGM())
+      {
+         if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_WARNING))
+         {
+            mLogger->LogMessage(dtUtil::Log::LOG_WARNING, __FUNCTION__, __LINE__,
+                                "Invokable named %s is registered as a listener, but "
+                                "Proxy %s does not have an invokable by that name.",
+                                listeners[i].mInvokableName.c_str(),
+                                listenerActorProxy->GetActorType().GetName().c_str());
+         }
+      }
+      else
+      {
+         if (mLogger->IsLevelEnabled(dtUtil::Log::LOG_DEBUG))
+         {
+            mLogger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__, __LINE__,
+                                "Invokable named %s is registered as a listener, "
+                                "but Proxy %s is no longer in the GM and is probably "
+                                "being deleted.",
+                                listeners[i].mInvokableName.c_str(),
+                                listenerActorProxy->GetActorType().GetName().c_str());
+         }
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+GMImpl::MessageListenerList::iterator GMImpl::RemoveMessageListener(MessageListenerList& listeners, MessageListenerList::iterator i)
+{
+   if (mListenerDispatchDepth == 0U)
+   {
+      return listeners.erase(i);
+   }
+
+   i->mActor = NULL;
+   i->mInvokable = NULL;
+   mListenersNeedCompacting = true;
+   return ++i;
+}
+
+//////////////////////////////////////////////////////////////////////////
+static bool IsUnregisteredListener(const MessageListener& listener)
+{
+   return !listener.mActor.valid();
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void CompactMessageListenerList(GMImpl::MessageListenerList& listeners)
+{
+   listeners.erase(std::remove_if(listeners.begin(), listeners.end(), IsUnregisteredListener), listeners.end());
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::CompactMessageListeners()
+{
+   mListenersNeedCompacting = false;
+
+   GlobalMessageListenerMap::iterator gi, giend;
+   gi = mGlobalMessageListeners.begin();
+   giend = mGlobalMessageListeners.end();
+   for (; gi != giend; ++gi)
+   {
+      CompactMessageListenerList(gi->second);
+   }
+
+   ActorMessageListenerMap::iterator ai, aiend;
+   ai = mActorMessageListeners.begin();
+   aiend = mActorMessageListeners.end();
+   for (; ai != aiend; ++ai)
+   {
+      AboutActorListenerMap& aboutActorListeners = ai->second;
+      AboutActorListenerMap::iterator j = aboutActorListeners.begin();
+      while (j != aboutActorListeners.end())
+      {
+         CompactMessageListenerList(j->second);
+         if (j->second.empty())
+         {
+            // Actors come and go, so don't leave an entry behind for each one.
+            aboutActorListeners.erase(j++);
+         }
+         else
+         {
+            ++j;
+         }
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::UpdateActorSpatialIndex()
+{
+   std::vector<dtCore::BaseActorObject*> moved;
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMovedSpatialActorsMutex);
+      if (mMovedSpatialActors.empty())
+      {
+         return;
+      }
+      moved.swap(mMovedSpatialActors);
+      for (unsigned i = 0; i < moved.size(); ++i)
+      {
+         ActorSpatialEntryMap::iterator found = mActorSpatialEntries.find(moved[i]);
+         if (found != mActorSpatialEntries.end())
+         {
+            found->second.mMoved = false;
+         }
+      }
+   }
+
+   for (unsigned i = 0; i < moved.size(); ++i)
+   {
+      // Only actors still in the index are read, since removed ones may be gone.
+      if (mActorSpatialEntries.find(moved[i]) != mActorSpatialEntries.end())
+      {
+         UpdateActorInSpatialIndex(*moved[i]);
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::RefreshActorSpatialIndex()
+{
+   GameActorMap::iterator gi, giend;
+   gi = mGameActorProxyMap.begin();
+   giend = mGameActorProxyMap.end();
+   for (; gi != giend; ++gi)
+   {
+      UpdateActorInSpatialIndex(*gi->second);
+   }
+
+   ActorMap::iterator ai, aiend;
+   ai = mBaseActorObjectMap.begin();
+   aiend = mBaseActorObjectMap.end();
+   for (; ai != aiend; ++ai)
+   {
+      UpdateActorInSpatialIndex(*ai->second);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::UpdateActorInSpatialIndex(dtCore::BaseActorObject& actor)
+{
+   dtCore::DeltaDrawable* dd = actor.GetDrawable();
+   dtCore::Transformable* xformable = dd != NULL ? dd->AsTransformable() : NULL;
+
+   ActorSpatialEntryMap::iterator found = mActorSpatialEntries.find(&actor);
+   if (found != mActorSpatialEntries.end()
+            && (found->second.mTransformable.get() != xformable || found->second.mDrawableKey != xformable))
+   {
+      // The drawable can be swapped out, so an actor that had a position may not anymore.
+      RemoveActorFromSpatialIndex(actor);
+      found = mActorSpatialEntries.end();
+   }
+
+   if (xformable == NULL)
+   {
+      return;
+   }
+
+   dtCore::Transform xform;
+   xformable->GetTransform(xform);
+   osg::Vec3 pos;
+   xform.GetTranslation(pos);
+
+   if (found != mActorSpatialEntries.end())
+   {
+      mActorSpatialIndex.Move(found->second.mHandle, pos);
+   }
+   else
+   {
+      ActorSpatialEntry entry;
+      entry.mHandle = mActorSpatialIndex.Insert(&actor, pos);
+      entry.mTransformable = xformable;
+      entry.mDrawableKey = xformable;
+      entry.mMoved = false;
+      mActorSpatialEntries.insert(std::make_pair(&actor, entry));
+      mSpatialActorsByDrawable[xformable] = &actor;
+      xformable->SetTransformChangedCallback(
+               dtCore::Transformable::TransformChangedCallback(this, &GMImpl::OnActorTransformChanged));
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::RemoveActorFromSpatialIndex(dtCore::BaseActorObject& actor)
+{
+   ActorSpatialEntryMap::iterator found = mActorSpatialEntries.find(&actor);
+   if (found != mActorSpatialEntries.end())
+   {
+      mActorSpatialIndex.Remove(found->second.mHandle);
+      dtCore::Transformable* xformable = found->second.mTransformable.get();
+      if (xformable != NULL)
+      {
+         xformable->SetTransformChangedCallback(dtCore::Transformable::TransformChangedCallback());
+      }
+
+      // A deleted drawable's address may have been reused by another actor's drawable.
+      SpatialActorsByDrawableMap::iterator byDrawable = mSpatialActorsByDrawable.find(found->second.mDrawableKey);
+      if (byDrawable != mSpatialActorsByDrawable.end() && byDrawable->second == &actor)
+      {
+         mSpatialActorsByDrawable.erase(byDrawable);
+      }
+      mActorSpatialEntries.erase(found);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void GMImpl::OnActorTransformChanged(dtCore::Transformable& xformable)
+{
+   SpatialActorsByDrawableMap::iterator found = mSpatialActorsByDrawable.find(&xformable);
+   if (found == mSpatialActorsByDrawable.end())
+   {
+      return;
+   }
+
+   ActorSpatialEntryMap::iterator entry = mActorSpatialEntries.find(found->second);
+   if (entry == mActorSpatialEntries.end())
+   {
+      return;
+   }
+
+   OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMovedSpatialActorsMutex);
+   if (!entry->second.mMoved)
+   {
+      entry->second.mMoved = true;
+      mMovedSpatialActors.push_back(found->second);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+MessageListener::MessageListener(GameActorProxy& actor, const std::string& invokableName)
+: mActor(&actor)
+, mInvokableName(invokableName)
+, mInvokable(actor.GetInvokable(invokableName))
+, mInvokablesRevision(actor.GetInvokablesRevision())
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+Invokable* MessageListener::GetInvokable()
+{
+   if (mInvokablesRevision != mActor->GetInvokablesRevision())
+   {
+      mInvokable = mActor->GetInvokable(mInvokableName);
+      mInvokablesRevision = mActor->GetInvokablesRevision();
+   }
+   return mInvokable;
+}
+
 }
@@ -31,6 +31,12 @@ namespace dtGame
       : mServerRole(true)
       , mClientRole(true)
       , mEditorMode(false)
+      , mConcurrentComponentDispatch(false)
+      , mMapLoadTimeSliceMS(0.0f)
+      , mOpenMapsInBackground(false)
+      , mTickMessagePoolSize(4U)
+      , mTimerMessagePoolSize(64U)
+      , mActorUpdateMessagePoolSize(1024U)
    {
    }
 
@@ -45,5 +51,17 @@ namespace dtGame
 
    DT_IMPLEMENT_ACCESSOR(GMSettings, bool, EditorMode);
 
+   DT_IMPLEMENT_ACCESSOR(GMSettings, bool, ConcurrentComponentDispatch);
+
+   DT_IMPLEMENT_ACCESSOR(GMSettings, float, MapLoadTimeSliceMS);
+
+   DT_IMPLEMENT_ACCESSOR(GMSettings, bool, OpenMapsInBackground);
+
+   DT_IMPLEMENT_ACCESSOR(GMSettings, unsigned, TickMessagePoolSize);
+
+   DT_IMPLEMENT_ACCESSOR(GMSettings, unsigned, TimerMessagePoolSize);
+
+   DT_IMPLEMENT_ACCESSOR(GMSettings, unsigned, ActorUpdateMessagePoolSize);
+
 
 } // namespace dtGame
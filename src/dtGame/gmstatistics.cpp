@@ -22,6 +22,8 @@
 #include <prefix/dtgameprefix.h>
 #include <dtGame/gmstatistics.h>
 #include <dtGame/gamemanager.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
 #include <dtCore/system.h>
 #include <dtUtil/log.h>
 #include <osg/Stats>
@@ -206,6 +208,20 @@ namespace dtGame
          " Ntwrk], #Actors[" << ourGm.GetNumAllActors() << "/ Game/" <<
          ourGm.GetNumGameActors() << "]" << std::endl;
 
+      std::vector<MessageFactory::MessagePoolStatistics> poolStats;
+      ourGm.GetMessageFactory().GetMessagePoolStatistics(poolStats);
+      for (unsigned i = 0; i < poolStats.size(); ++i)
+      {
+         const MessageFactory::MessagePoolStatistics& pool = poolStats[i];
+         // The factory counts from when the pool was made, so report the change since the last report.
+         std::pair<unsigned, unsigned>& lastCounts = mStatsLastMessagePoolCounts[pool.mMessageType];
+         ss << "Message Pool: Type[" << pool.mMessageType->GetName() << "], Hits[" << pool.mHits - lastCounts.first <<
+            "], Misses[" << pool.mMisses - lastCounts.second << "], Pooled[" << pool.mNumPooled << "/" <<
+            pool.mMaxPooled << "]" << std::endl;
+         lastCounts.first = pool.mHits;
+         lastCounts.second = pool.mMisses;
+      }
+
       // reset values for next fragment
       mStatsNumFrames         = 0;
       mStatsNumProcMessages   = 0;
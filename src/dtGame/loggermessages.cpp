@@ -39,6 +39,8 @@ namespace dtGame
       AddParameter(new DoubleMessageParameter("AutoRecordKeyframeInterval"));
       AddParameter(new DoubleMessageParameter("CurrentRecordDuration"));
       AddParameter(new UnsignedIntMessageParameter("NumRecordedMessages"));
+      AddParameter(new UnsignedIntMessageParameter("NumDroppedMessages"));
+      AddParameter(new UnsignedIntMessageParameter("NumWriteStalls"));
    }
 
    //////////////////////////////////////////////////////////////////////////
@@ -75,6 +77,14 @@ namespace dtGame
          static_cast<const UnsignedIntMessageParameter*>(GetParameter("NumRecordedMessages"));
       result.SetNumMessages(numRecorded->GetValue());
 
+      const UnsignedIntMessageParameter *numDropped =
+         static_cast<const UnsignedIntMessageParameter*>(GetParameter("NumDroppedMessages"));
+      result.SetNumDroppedMessages(numDropped->GetValue());
+
+      const UnsignedIntMessageParameter *numStalls =
+         static_cast<const UnsignedIntMessageParameter*>(GetParameter("NumWriteStalls"));
+      result.SetNumWriteStalls(numStalls->GetValue());
+
       return result;
    }
 
@@ -108,6 +118,13 @@ namespace dtGame
          static_cast< UnsignedIntMessageParameter*>(GetParameter("NumRecordedMessages"));
       numRecorded->SetValue(status.GetNumMessages());
 
+      UnsignedIntMessageParameter *numDropped =
+         static_cast< UnsignedIntMessageParameter*>(GetParameter("NumDroppedMessages"));
+      numDropped->SetValue(status.GetNumDroppedMessages());
+
+      UnsignedIntMessageParameter *numStalls =
+         static_cast< UnsignedIntMessageParameter*>(GetParameter("NumWriteStalls"));
+      numStalls->SetValue(status.GetNumWriteStalls());
    }
 
    //////////////////////////////////////////////////////////////////////////
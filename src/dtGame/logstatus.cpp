@@ -37,6 +37,8 @@ namespace dtGame
       , mAutoRecordKeyframeInterval(0)
       , mCurrentRecordDuration(0)
       , mNumMessages(0)
+      , mNumDroppedMessages(0)
+      , mNumWriteStalls(0)
    {
    }
 
@@ -51,7 +53,8 @@ namespace dtGame
    {
       stream << "LogStatus: State[" << me.mStateEnum->GetName() <<
          "], SimTime[" << me.mCurrentSimTime << "], Map[" << me.mActiveMaps[0] <<
-            "], LogFile[" << me.mLogFile << "], #Messagse[" << me.mNumMessages << "]";
+            "], LogFile[" << me.mLogFile << "], #Messagse[" << me.mNumMessages << "], #Dropped[" << me.mNumDroppedMessages <<
+            "], #WriteStalls[" << me.mNumWriteStalls << "]";
       return stream;
    }
 
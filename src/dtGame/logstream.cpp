@@ -48,6 +48,18 @@ namespace dtGame
       mRecordDuration = value;
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned LogStream::GetNumDroppedMessages() const
+   {
+      return 0;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned LogStream::GetNumWriteStalls() const
+   {
+      return 0;
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    MessageFactory& LogStream::GetMessageFactory()
    {
@@ -37,14 +37,70 @@
 #include <dtGame/gmcomponent.h>
 
 #include <dtCore/system.h>
+#include <dtCore/timer.h>
+
+#include <OpenThreads/Atomic>
+
 namespace dtGame
 {
+   /**
+    * Opens the new maps on the project on the thread pool so parsing them and creating the actors
+    * doesn't hold up the application.  Project::GetMap holds the project lock while each map opens,
+    * so the main thread only waits on the project for the map in progress, not the whole list.
+    */
+   class OpenMapsTask : public dtUtil::ThreadPoolTask
+   {
+   public:
+      OpenMapsTask(const MapChangeStateData::NameVector& mapNames)
+         : mMapNames(mapNames)
+      {
+         SetName("OpenMapsTask");
+      }
+
+      void operator()()
+      {
+         dtCore::Project& project = dtCore::Project::GetInstance();
+
+         // The lock is taken per map by GetMap, so a cancel is seen between maps.
+         MapChangeStateData::NameVector::const_iterator i = mMapNames.begin();
+         MapChangeStateData::NameVector::const_iterator end = mMapNames.end();
+         for (; i != end && unsigned(mCancelled) == 0U; ++i)
+         {
+            try
+            {
+               project.GetMap(*i);
+            }
+            catch (const dtUtil::Exception& ex)
+            {
+               mFailedMapName = *i;
+               mError = ex.ToString();
+               break;
+            }
+         }
+      }
+
+      /// Stops before the next map.  The map being opened is still finished.
+      void Cancel()
+      {
+         ++mCancelled;
+      }
+
+      MapChangeStateData::NameVector mMapNames;
+      OpenThreads::Atomic mCancelled;
+      // The map that failed to open and why, or empty if they all opened.
+      std::string mFailedMapName;
+      std::string mError;
+   };
+
    IMPLEMENT_ENUM(MapChangeStateData::MapChangeState);
 
 
    ///////////////////////////////////////////////////////////////////////////////
    const MapChangeStateData::MapChangeState MapChangeStateData::MapChangeState::UNLOAD("UNLOAD");
 
+   ///////////////////////////////////////////////////////////////////////////////
+   const MapChangeStateData::MapChangeState MapChangeStateData::MapChangeState::OPEN("OPEN");
+
    ///////////////////////////////////////////////////////////////////////////////
    const MapChangeStateData::MapChangeState MapChangeStateData::MapChangeState::LOAD("LOAD");
 
@@ -54,8 +110,19 @@ namespace dtGame
    ///////////////////////////////////////////////////////////////////////////////
    MapChangeStateData::MapChangeStateData(GameManager& gm):
       osg::Referenced(), mGameManager(&gm), mCurrentState(&MapChangeStateData::MapChangeState::IDLE),
-      mAddBillboards(false)
+      mAddBillboards(false), mNextActorToAdd(0U), mLoadStarted(false)
+   {
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   MapChangeStateData::~MapChangeStateData()
    {
+      // The task doesn't reference this, but it must not go on using the project after the GM is gone.
+      if (mOpenMapsTask.valid())
+      {
+         static_cast<OpenMapsTask&>(*mOpenMapsTask).Cancel();
+         mOpenMapsTask->WaitUntilComplete();
+      }
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -74,6 +141,9 @@ namespace dtGame
       mOldMapNames = oldMapNames;
       mNewMapNames = newMapNames;
       mAddBillboards = addBillboards;
+      mActorsToAdd.clear();
+      mNextActorToAdd = 0U;
+      mLoadStarted = false;
 
       mCurrentState = &MapChangeState::UNLOAD;
 
@@ -204,9 +274,72 @@ namespace dtGame
    }
 
    ///////////////////////////////////////////////////////////////////////////////
-   void MapChangeStateData::LoadSingleMapIntoGM(const std::string& mapName)
+   void MapChangeStateData::BeginOpenNewMaps()
+   {
+      mOpenMapsTask = new OpenMapsTask(mNewMapNames);
+      dtUtil::ThreadPool::AddTask(*mOpenMapsTask, dtUtil::ThreadPool::IO);
+      mCurrentState = &MapChangeState::OPEN;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::ContinueOpenNewMaps()
+   {
+      if (!mOpenMapsTask->WaitUntilComplete(0))
+      {
+         return;
+      }
+
+      dtCore::RefPtr<OpenMapsTask> task = static_cast<OpenMapsTask*>(mOpenMapsTask.get());
+      mOpenMapsTask = NULL;
+
+      if (task->mFailedMapName.empty())
+      {
+         SendMapMessage(MessageType::INFO_MAP_LOAD_BEGIN, mNewMapNames);
+         mCurrentState = &MapChangeState::LOAD;
+      }
+      else
+      {
+         // Same as failing to open the maps on the main thread.
+         mCurrentState = &MapChangeState::IDLE;
+         SendMapMessage(MessageType::INFO_MAP_CHANGED, MapChangeStateData::NameVector());
+         dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
+            "Critical failure occurred while opening map[%s]: %s", task->mFailedMapName.c_str(), task->mError.c_str());
+         mNewMapNames.clear();
+         mGameManager->SetPaused(false);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::CancelOpenNewMaps()
+   {
+      if (!mOpenMapsTask.valid())
+      {
+         return;
+      }
+
+      static_cast<OpenMapsTask&>(*mOpenMapsTask).Cancel();
+      mOpenMapsTask->WaitUntilComplete();
+      mOpenMapsTask = NULL;
+
+      // None of the actors were added to the GM, so just close what the task opened.
+      dtCore::Project& project = dtCore::Project::GetInstance();
+      MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
+      MapChangeStateData::NameVector::const_iterator end = mNewMapNames.end();
+      for (; i != end; ++i)
+      {
+         if (project.IsMapOpen(*i))
+         {
+            project.CloseMap(project.GetMap(*i), true);
+         }
+      }
+
+      mNewMapNames.clear();
+      mCurrentState = &MapChangeState::IDLE;
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::AddMapEventsAndEnvironment(dtCore::Map& map)
    {
-      dtCore::Map& map = dtCore::Project::GetInstance().GetMap(mapName);
       // add all the events in the map to the game manager.
       std::vector<dtCore::GameEvent* > events;
       map.GetEventManager().GetAllEvents(events);
@@ -223,8 +356,6 @@ namespace dtGame
          }
       }
 
-      ScopedGMBatchAdd batch(*mGameManager);
-
       if (map.GetEnvironmentActor() != NULL)
       {
          dtGame::IEnvGameActorProxy* eap =
@@ -232,10 +363,15 @@ namespace dtGame
 
          mGameManager->SetEnvironmentActor(eap);
       }
+   }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::GetActorsToAdd(dtCore::Map& map, dtCore::ActorRefPtrVector& toFill)
+   {
       dtCore::ActorRefPtrVector proxies;
       map.GetAllProxies(proxies);
 
+      toFill.reserve(toFill.size() + proxies.size());
       for (unsigned int i = 0; i < proxies.size(); ++i)
       {
          dtCore::BaseActorObject& curAddActor = *proxies[i];
@@ -249,21 +385,83 @@ namespace dtGame
          {
             continue;
          }
-         else
+         toFill.push_back(proxies[i]);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::AddActorToGM(dtCore::BaseActorObject& actor)
+   {
+      try
+      {
+         mGameManager->AddActor(actor);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
+               "A problem occurred adding Actor with name \"%s\" of type \"%s\" to the GameManager.",
+               actor.GetName().c_str(), actor.GetActorType().GetFullName().c_str());
+         ex.LogException(dtUtil::Log::LOG_ERROR, dtUtil::Log::GetInstance("mapchangestatedata.cpp"));
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::LoadSingleMapIntoGM(const std::string& mapName)
+   {
+      dtCore::Map& map = dtCore::Project::GetInstance().GetMap(mapName);
+
+      ScopedGMBatchAdd batch(*mGameManager);
+
+      AddMapEventsAndEnvironment(map);
+
+      dtCore::ActorRefPtrVector actors;
+      GetActorsToAdd(map, actors);
+
+      for (unsigned int i = 0; i < actors.size(); ++i)
+      {
+         AddActorToGM(*actors[i]);
+      }
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   bool MapChangeStateData::AddActorsToGM(float timeSliceMS)
+   {
+      const dtCore::Timer& timer = *dtCore::Timer::Instance();
+      const dtCore::Timer_t sliceStart = timer.Tick();
+
+      ScopedGMBatchAdd batch(*mGameManager);
+
+      // Always add at least one actor so the load moves forward even if a single actor takes longer than the slice.
+      while (mNextActorToAdd < mActorsToAdd.size())
+      {
+         AddActorToGM(*mActorsToAdd[mNextActorToAdd]);
+         // Release the reference so the actor is only held by the GM from now on.
+         mActorsToAdd[mNextActorToAdd] = NULL;
+         ++mNextActorToAdd;
+
+         if (timer.DeltaMil(sliceStart, timer.Tick()) >= double(timeSliceMS))
          {
-            try
-            {
-               mGameManager->AddActor(curAddActor);
-            }
-            catch (const dtUtil::Exception& ex)
-            {
-               dtUtil::Log::GetInstance("mapchangestatedata.cpp").LogMessage(dtUtil::Log::LOG_ERROR, __FUNCTION__, __LINE__,
-                     "A problem occurred adding Actor with name \"%s\" of type \"%s\" to the GameManager.",
-                     curAddActor.GetName().c_str(), curAddActor.GetActorType().GetFullName().c_str());
-               ex.LogException(dtUtil::Log::LOG_ERROR, dtUtil::Log::GetInstance("mapchangestatedata.cpp"));
-            }
+            break;
          }
       }
+
+      return mNextActorToAdd >= mActorsToAdd.size();
+   }
+
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::EndMapChange()
+   {
+      mActorsToAdd.clear();
+      mNextActorToAdd = 0U;
+      mLoadStarted = false;
+
+      // set the app to unpause so time stepping is correct
+      mGameManager->SetPaused(false);
+
+      SendMapMessage(MessageType::INFO_MAPS_OPENED, mNewMapNames);
+      SendMapMessage(MessageType::INFO_MAP_CHANGE_LOAD_END, mNewMapNames);
+      SendMapMessage(MessageType::INFO_MAP_CHANGE_END, mNewMapNames);
+      mCurrentState = &MapChangeState::IDLE;
    }
 
    ///////////////////////////////////////////////////////////////////////////////
@@ -286,7 +484,12 @@ namespace dtGame
       {
          CloseOldMaps();
 
-         if (OpenNewMaps())
+         if (!mNewMapNames.empty() && mGameManager->GetGMSettings().GetOpenMapsInBackground()
+                  && dtUtil::ThreadPool::IsInitialized())
+         {
+            BeginOpenNewMaps();
+         }
+         else if (OpenNewMaps())
          {
             mCurrentState = &MapChangeState::LOAD;
          }
@@ -297,26 +500,65 @@ namespace dtGame
             mCurrentState = &MapChangeState::IDLE;
          }
       }
+      else if (*mCurrentState == MapChangeState::OPEN)
+      {
+         ContinueOpenNewMaps();
+      }
       else if (mCurrentState == &MapChangeState::LOAD)
       {
-         MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
-         MapChangeStateData::NameVector::const_iterator iend = mNewMapNames.end();
+         const float timeSliceMS = mGameManager->GetGMSettings().GetMapLoadTimeSliceMS();
+         if (timeSliceMS <= 0.0f)
+         {
+            MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
+            MapChangeStateData::NameVector::const_iterator iend = mNewMapNames.end();
 
-         for (; i != iend; ++i)
+            for (; i != iend; ++i)
+            {
+               LoadSingleMapIntoGM(*i);
+            }
+
+            EndMapChange();
+            return;
+         }
+
+         if (!mLoadStarted)
          {
-            LoadSingleMapIntoGM(*i);
+            mLoadStarted = true;
+
+            ScopedGMBatchAdd batch(*mGameManager);
+
+            MapChangeStateData::NameVector::const_iterator i = mNewMapNames.begin();
+            MapChangeStateData::NameVector::const_iterator iend = mNewMapNames.end();
+            for (; i != iend; ++i)
+            {
+               dtCore::Map& map = dtCore::Project::GetInstance().GetMap(*i);
+               AddMapEventsAndEnvironment(map);
+               GetActorsToAdd(map, mActorsToAdd);
+            }
          }
 
-         // set the app to unpause so time stepping is correct
-         mGameManager->SetPaused(false);
+         bool done = AddActorsToGM(timeSliceMS);
+         SendProgressMessage();
 
-         SendMapMessage(MessageType::INFO_MAPS_OPENED, mNewMapNames);
-         SendMapMessage(MessageType::INFO_MAP_CHANGE_LOAD_END, mNewMapNames);
-         SendMapMessage(MessageType::INFO_MAP_CHANGE_END, mNewMapNames);
-         mCurrentState = &MapChangeState::IDLE;
+         if (done)
+         {
+            EndMapChange();
+         }
       }
    }
 
+   ///////////////////////////////////////////////////////////////////////////////
+   void MapChangeStateData::SendProgressMessage()
+   {
+      dtCore::RefPtr<MapLoadProgressMessage> progressMessage;
+      mGameManager->GetMessageFactory().CreateMessage(MessageType::INFO_MAP_CHANGE_LOAD_PROGRESS, progressMessage);
+      progressMessage->SetMapNames(mNewMapNames);
+      progressMessage->SetActorsAdded(mNextActorToAdd);
+      progressMessage->SetTotalActors(unsigned(mActorsToAdd.size()));
+
+      mGameManager->SendMessage(*progressMessage);
+   }
+
    ///////////////////////////////////////////////////////////////////////////////
    void MapChangeStateData::SendMapMessage(const MessageType& type, const MapChangeStateData::NameVector& names)
    {
@@ -28,9 +28,11 @@
 #include <dtGame/messagefactory.h>
 #include <dtGame/messagetype.h>
 #include <dtCore/refptr.h>
+#include <OpenThreads/ScopedLock>
 #include <sstream>
 
 #include <typeinfo>
+#include <algorithm>
 
 namespace dtGame
 {
@@ -81,7 +83,13 @@ namespace dtGame
    /////////////////////////////////////////////////////////////////
    dtCore::RefPtr<Message> MessageFactory::CreateMessage(const MessageType& msgType) const
    {
-      dtCore::RefPtr<Message> msg = mMessageFactory->CreateObject(&msgType);
+      dtCore::RefPtr<Message> msg = CreatePooledMessage(msgType);
+      if (msg.valid())
+      {
+         return msg;
+      }
+
+      msg = mMessageFactory->CreateObject(&msgType);
 
       if (msg == NULL)
       {
@@ -96,6 +104,129 @@ namespace dtGame
       return msg;
    }
 
+   /////////////////////////////////////////////////////////////////
+   dtCore::RefPtr<Message> MessageFactory::CreatePooledMessage(const MessageType& msgType) const
+   {
+      // Only this many pooled messages are checked so a pool full of messages in use doesn't make this slow.
+      static const unsigned MAX_CHECKS = 8U;
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+
+      std::map<const MessageType*, MessagePool>::iterator poolItor = mMessagePools.find(&msgType);
+      if (poolItor == mMessagePools.end())
+      {
+         return NULL;
+      }
+
+      MessagePool& pool = poolItor->second;
+      const unsigned numPooled = unsigned(pool.mMessages.size());
+      const unsigned numChecks = std::min(numPooled, MAX_CHECKS);
+      for (unsigned i = 0; i < numChecks; ++i)
+      {
+         Message& pooled = *pool.mMessages[pool.mNextToCheck];
+         pool.mNextToCheck = (pool.mNextToCheck + 1U) % numPooled;
+
+         // The pool holds the only reference, so nothing can be using it.
+         if (pooled.referenceCount() == 1)
+         {
+            ++pool.mHits;
+            pool.mDefaults->CopyDataTo(pooled);
+            pooled.SetCausingMessage(NULL);
+            pooled.SetMessageType(msgType);
+            pooled.SetSource(*mMachine);
+            pooled.SetDestination(NULL);
+            return &pooled;
+         }
+      }
+
+      ++pool.mMisses;
+
+      dtCore::RefPtr<Message> msg = mMessageFactory->CreateObject(&msgType);
+      if (msg == NULL)
+      {
+         // Let CreateMessage log and throw.
+         return NULL;
+      }
+
+      msg->SetMessageType(msgType);
+      msg->SetSource(*mMachine);
+      msg->SetDestination(NULL);
+
+      if (numPooled < pool.mMaxPooled)
+      {
+         pool.mMessages.push_back(msg);
+      }
+      return msg;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void MessageFactory::SetMessagePoolSize(const MessageType& type, unsigned maxPooled)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+
+      if (maxPooled == 0U)
+      {
+         mMessagePools.erase(&type);
+         return;
+      }
+
+      MessagePool& pool = mMessagePools[&type];
+      if (!pool.mDefaults.valid())
+      {
+         pool.mDefaults = mMessageFactory->CreateObject(&type);
+         if (!pool.mDefaults.valid())
+         {
+            mMessagePools.erase(&type);
+            throw dtGame::MessageFactory::MessageTypeNotRegisteredException(
+               std::string("Could not create a pool for type ") + type.GetName(), __FILE__, __LINE__);
+         }
+      }
+
+      pool.mMaxPooled = maxPooled;
+      if (pool.mMessages.size() > maxPooled)
+      {
+         pool.mMessages.resize(maxPooled);
+         pool.mNextToCheck = 0U;
+      }
+      pool.mMessages.reserve(maxPooled);
+   }
+
+   /////////////////////////////////////////////////////////////////
+   unsigned MessageFactory::GetMessagePoolSize(const MessageType& type) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+
+      std::map<const MessageType*, MessagePool>::const_iterator poolItor = mMessagePools.find(&type);
+      if (poolItor == mMessagePools.end())
+      {
+         return 0U;
+      }
+      return poolItor->second.mMaxPooled;
+   }
+
+   /////////////////////////////////////////////////////////////////
+   void MessageFactory::GetMessagePoolStatistics(std::vector<MessagePoolStatistics>& toFill) const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPoolMutex);
+
+      toFill.clear();
+      toFill.reserve(mMessagePools.size());
+
+      std::map<const MessageType*, MessagePool>::const_iterator i, iend;
+      i = mMessagePools.begin();
+      iend = mMessagePools.end();
+      for (; i != iend; ++i)
+      {
+         MessagePoolStatistics stats;
+         stats.mMessageType = i->first;
+         stats.mMaxPooled = i->second.mMaxPooled;
+         stats.mNumPooled = unsigned(i->second.mMessages.size());
+         stats.mHits = i->second.mHits;
+         stats.mMisses = i->second.mMisses;
+         toFill.push_back(stats);
+      }
+   }
+
    /////////////////////////////////////////////////////////////////
    dtCore::RefPtr<Message> MessageFactory::CloneMessage(const Message& msg) const
    {
@@ -214,6 +345,7 @@ namespace dtGame
    const MessageType MessageType::INFO_MAP_CHANGE_UNLOAD_BEGIN("Map Unload Began", MessageType::CATEGORY_INFO, "Sent when unloading a map has begun.", 24, (MapMessage*)(NULL));
    const MessageType MessageType::INFO_MAP_CHANGE_BEGIN("Map Change Began", MessageType::CATEGORY_INFO, "Sent when the program has begun to unload a map and load a new one.  Unload and load messages will be sent", 25, (MapMessage*)(NULL));
    const MessageType MessageType::INFO_MAP_CHANGE_END("Map Changed", MessageType::CATEGORY_INFO, "Sent when the program has completed unloading and loading a new map.", 26, (MapMessage*)(NULL));
+   const MessageType MessageType::INFO_MAP_CHANGE_LOAD_PROGRESS("Map Load Progress", MessageType::CATEGORY_INFO, "Sent each frame while the actors of new maps are being added.", 34, (MapLoadProgressMessage*)(NULL));
 
    ////////////////////
    // Deprecated
@@ -243,14 +375,18 @@ namespace dtGame
    const MessageType MessageType::REQUEST_CHANGE_MAP("Request Change Map", MessageType::CATEGORY_REQUEST, "A client request to change the map set", 86, (MapMessage*)(NULL));
 
    const MessageType MessageType::SERVER_REQUEST_REJECTED("Message Rejected", "Server", "A server message sent to a client that a message it sent was rejected as invalid", 110, (ServerMessageRejected*)(NULL));
-   const MessageType MessageType::NETCLIENT_REQUEST_CONNECTION("Client Request Connection", "Client", "Sent when a client wants to connect to the server", 150, (MachineInfoMessage*)(NULL));
+   const MessageType MessageType::NETCLIENT_REQUEST_CONNECTION("Client Request Connection", "Client", "Sent when a client wants to connect to the server", 150, (NetConnectionMessage*)(NULL));
    const MessageType MessageType::NETCLIENT_NOTIFY_DISCONNECT("Client Disconnecting", "Client", "Sent when a client wishes to disconnect from the server", 151, (MachineInfoMessage*)(NULL));
-   const MessageType MessageType::NETSERVER_ACCEPT_CONNECTION("Accept Client", "Server", "Sent from a server to a client informing the client that it is ok to connect", 152, (MachineInfoMessage*)(NULL));
+   const MessageType MessageType::NETSERVER_ACCEPT_CONNECTION("Accept Client", "Server", "Sent from a server to a client informing the client that it is ok to connect", 152, (NetConnectionMessage*)(NULL));
    const MessageType MessageType::NETSERVER_REJECT_CONNECTION("Reject Client", "Server", "Sent from the server to the client if a client is not allowed to connect to the server", 153, (NetServerRejectMessage*)(NULL));
    const MessageType MessageType::NETSERVER_SYNC_CONTROL("Server Sync Control", "Server",
       "Sent from the server to tell the client about the frame sync mechanism.", 154, (ServerSyncControlMessage*)(NULL));
    const MessageType MessageType::NETSERVER_FRAME_SYNC("Server Frame Sync", "Server",
       "Sent from the server, every frame, to give clients a chance to sync up.", 155, (ServerFrameSyncMessage*)(NULL));
+   const MessageType MessageType::NET_WIRE_FORMAT("Net Wire Format", "Network",
+      "Sent to a newly accepted network peer to tell it the newest message wire format this side can read.", 156, (NetWireFormatMessage*)(NULL));
+   const MessageType MessageType::NET_ACTOR_UPDATE_ACK("Net Actor Update Ack", "Network",
+      "Sent back to a network peer to acknowledge the delta compressed actor updates it sent.", 157, (NetActorUpdateAckMessage*)(NULL));
 
     // Logger messages
    const MessageType MessageType::LOG_REQ_CHANGESTATE_PLAYBACK("Logger - Change State to Playback",
@@ -57,8 +57,11 @@ namespace dtGame
 
       mIgnoredMessageTypeList.insert(&dtGame::MessageType::INFO_MAPS_OPENED);
       mIgnoredMessageTypeList.insert(&dtGame::MessageType::INFO_MAPS_CLOSED);
+      mIgnoredMessageTypeList.insert(&dtGame::MessageType::INFO_MAP_CHANGE_LOAD_PROGRESS);
       mIgnoredMessageTypeList.insert(&dtGame::MessageType::INFO_MAP_UNLOAD_BEGIN);
       mIgnoredMessageTypeList.insert(&dtGame::MessageType::INFO_MAP_UNLOADED);
+
+      SetConcurrentSafe(true);
    }
 
    //////////////////////////////////////////////////////////////////////////
@@ -331,6 +334,8 @@ namespace dtGame
 
             // change state to RECORD
             mLogStatus.SetNumMessages(0);
+            mLogStatus.SetNumDroppedMessages(mLogStream->GetNumDroppedMessages());
+            mLogStatus.SetNumWriteStalls(mLogStream->GetNumWriteStalls());
             mLogStatus.SetCurrentRecordDuration(0.0);
             mLogStatus.SetStateEnum(LogStateEnumeration::LOGGER_STATE_RECORD);
 
@@ -646,6 +651,47 @@ namespace dtGame
       }
    }
 
+   //////////////////////////////////////////////////////////////////////////
+   bool ServerLoggerComponent::IsConcurrentSafeFor(const Message& message) const
+   {
+      if (!GetConcurrentSafe() || mLogStatus.GetStateEnum() != LogStateEnumeration::LOGGER_STATE_RECORD)
+      {
+         return false;
+      }
+
+      // These are the messages ProcessMessage does something with other than DoRecordMessage.
+      const MessageType& type = message.GetMessageType();
+      if (type.GetCategory() == "Tick" || type.GetCategory() == "System" ||
+         type == MessageType::LOG_REQ_GET_STATUS ||
+         type == MessageType::LOG_REQ_CHANGESTATE_PLAYBACK ||
+         type == MessageType::LOG_REQ_CHANGESTATE_RECORD ||
+         type == MessageType::LOG_REQ_CHANGESTATE_IDLE ||
+         type == MessageType::LOG_REQ_CAPTURE_KEYFRAME ||
+         type == MessageType::LOG_REQ_JUMP_TO_KEYFRAME ||
+         type == MessageType::LOG_REQ_GET_KEYFRAMES ||
+         type == MessageType::LOG_REQ_GET_LOGFILES ||
+         type == MessageType::LOG_REQ_GET_TAGS ||
+         type == MessageType::LOG_REQ_INSERT_TAG ||
+         type == MessageType::LOG_REQ_DELETE_LOG ||
+         type == MessageType::LOG_REQ_SET_LOGFILE ||
+         type == MessageType::LOG_REQ_SET_AUTOKEYFRAMEINTERVAL ||
+         type == MessageType::INFO_MAP_LOADED ||
+         type == MessageType::LOG_REQ_ADD_IGNORED_ACTOR ||
+         type == MessageType::LOG_REQ_REMOVE_IGNORED_ACTOR ||
+         type == MessageType::LOG_REQ_CLEAR_IGNORE_LIST ||
+         type == MessageType::LOG_INFO_PLAYBACK_END_OF_MESSAGES ||
+         type == MessageType::INFO_MAP_CHANGE_BEGIN ||
+         type == MessageType::LOG_REQ_ADD_IGNORED_MESSAGETYPE ||
+         type == MessageType::LOG_REQ_REMOVE_IGNORED_MESSAGETYPE ||
+         type == MessageType::LOG_REQ_CLEAR_IGNORED_MESSAGETYPE_LIST ||
+         type == MessageType::INFO_TIMER_ELAPSED)
+      {
+         return false;
+      }
+
+      return true;
+   }
+
    //////////////////////////////////////////////////////////////////////////
    void ServerLoggerComponent::ProcessTickMessage(const TickMessage& message)
    {
@@ -1045,7 +1091,15 @@ namespace dtGame
       try
       {
          mLogStream->WriteMessage(message, mLogStatus.GetCurrentSimTime());
-         mLogStatus.SetNumMessages(mLogStatus.GetNumMessages() + 1);
+
+         // The stream may drop the message rather than hold up the frame when it falls behind on writing.
+         const unsigned long numDropped = mLogStream->GetNumDroppedMessages();
+         if (numDropped == mLogStatus.GetNumDroppedMessages())
+         {
+            mLogStatus.SetNumMessages(mLogStatus.GetNumMessages() + 1);
+         }
+         mLogStatus.SetNumDroppedMessages(numDropped);
+         mLogStatus.SetNumWriteStalls(mLogStream->GetNumWriteStalls());
       }
       catch (const dtUtil::Exception& e)
       {
@@ -1061,7 +1115,7 @@ namespace dtGame
    void ServerLoggerComponent::HandleAddPlaybackActorMessage(const Message& message)
    {
       // Make sure no ignored actors get added when they join the playback simulation.
-      if (!message.GetAboutActorId().ToString().empty() &&
+      if (!message.GetAboutActorId().IsNull() &&
          !IsActorIdInList(message.GetAboutActorId(), mPlaybackList))
       {
          mPlaybackList.insert(message.GetAboutActorId());
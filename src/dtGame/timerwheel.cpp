@@ -0,0 +1,453 @@
+/* -*-c++-*-
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ */
+
+#include <prefix/dtgameprefix.h>
+#include <dtGame/timerwheel.h>
+
+#include <algorithm>
+
+namespace dtGame
+{
+   static const unsigned long long SLOT_MASK = TimerWheel::SLOTS_PER_LEVEL - 1;
+
+   //////////////////////////////////////////////////////////////////////////
+   TimerWheel::Handle::Handle()
+   : mIndex(~0U)
+   , mGeneration(0U)
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool TimerWheel::DueLess::operator()(unsigned lhs, unsigned rhs) const
+   {
+      const Timer& l = mTimers[lhs];
+      const Timer& r = mTimers[rhs];
+      if (l.mTime == r.mTime)
+      {
+         return l.mSequence < r.mSequence;
+      }
+      return l.mTime < r.mTime;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   TimerWheel::TimerWheel(dtCore::Timer_t resolution)
+   : mResolution(std::max(resolution, dtCore::Timer_t(1)))
+   , mCurrentTick(0ULL)
+   , mNextSequence(0ULL)
+   , mNumTimers(0U)
+   , mFreeHead(NONE)
+   , mSlots(OVERFLOW_SLOT + 1, unsigned(NONE))
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   TimerWheel::~TimerWheel()
+   {
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   TimerWheel::Handle TimerWheel::Add(const dtUtil::RefString& name, const dtCore::UniqueId& aboutActor,
+            dtCore::Timer_t time, bool repeat, dtCore::Timer_t interval)
+   {
+      unsigned index = AllocateTimer();
+      Timer& timer = mTimers[index];
+      timer.mName = name;
+      timer.mAboutActor = aboutActor;
+      timer.mTime = time;
+      timer.mInterval = interval;
+      timer.mSequence = mNextSequence++;
+      timer.mRepeat = repeat;
+
+      Schedule(index);
+      LinkActor(index);
+      ++mNumTimers;
+
+      Handle handle;
+      handle.mIndex = index;
+      handle.mGeneration = timer.mGeneration;
+      return handle;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool TimerWheel::Remove(Handle handle)
+   {
+      if (!IsActive(handle))
+      {
+         return false;
+      }
+      Erase(handle.mIndex);
+      return true;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   bool TimerWheel::IsActive(Handle handle) const
+   {
+      return handle.mIndex < mTimers.size() && mTimers[handle.mIndex].mInUse
+               && mTimers[handle.mIndex].mGeneration == handle.mGeneration;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::Remove(const dtUtil::RefString& name, const dtCore::UniqueId* aboutActor)
+   {
+      unsigned removed = 0U;
+      if (aboutActor != NULL)
+      {
+         ActorTimerMap::const_iterator found = mActorTimers.find(*aboutActor);
+         unsigned index = found != mActorTimers.end() ? found->second : NONE;
+         while (index != NONE)
+         {
+            unsigned next = mTimers[index].mActorNext;
+            if (mTimers[index].mName == name)
+            {
+               Erase(index);
+               ++removed;
+            }
+            index = next;
+         }
+      }
+      else
+      {
+         for (unsigned i = 0; i < mTimers.size(); ++i)
+         {
+            if (mTimers[i].mInUse && mTimers[i].mName == name)
+            {
+               Erase(i);
+               ++removed;
+            }
+         }
+      }
+      return removed;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::RemoveForActor(const dtCore::UniqueId& aboutActor)
+   {
+      ActorTimerMap::iterator found = mActorTimers.find(aboutActor);
+      if (found == mActorTimers.end())
+      {
+         return 0U;
+      }
+
+      unsigned index = found->second;
+      mActorTimers.erase(found);
+
+      unsigned removed = 0U;
+      while (index != NONE)
+      {
+         unsigned next = mTimers[index].mActorNext;
+         UnlinkSlot(index);
+         FreeTimer(index);
+         ++removed;
+         index = next;
+      }
+      return removed;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Clear()
+   {
+      // Free each timer rather than clearing the vector so old handles stay invalid.
+      for (unsigned i = 0; i < mTimers.size(); ++i)
+      {
+         if (mTimers[i].mInUse)
+         {
+            FreeTimer(i);
+         }
+      }
+      std::fill(mSlots.begin(), mSlots.end(), unsigned(NONE));
+      mActorTimers.clear();
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::GetNumTimers() const
+   {
+      return mNumTimers;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   dtCore::Timer_t TimerWheel::GetResolution() const
+   {
+      return mResolution;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Advance(dtCore::Timer_t clockTime, std::vector<ExpiredTimer>& expiredOut)
+   {
+      expiredOut.clear();
+
+      unsigned long long targetTick = clockTime / mResolution;
+      if (mNumTimers == 0U)
+      {
+         mCurrentTick = targetTick;
+         return;
+      }
+
+      // Turning the wheel costs a step per tick, so if the clock jumped back or further than it would
+      // cost to reschedule every timer, reschedule them all instead.
+      if (targetTick < mCurrentTick ||
+               targetTick - mCurrentTick > std::max(static_cast<unsigned long long>(SLOTS_PER_LEVEL), static_cast<unsigned long long>(mNumTimers)))
+      {
+         Rebuild(targetTick);
+      }
+
+      mExpiredScratch.clear();
+      for (;;)
+      {
+         // Only the slot of the last tick can hold timers that aren't due yet.
+         unsigned index = mSlots[mCurrentTick & SLOT_MASK];
+         while (index != NONE)
+         {
+            unsigned next = mTimers[index].mNext;
+            if (mTimers[index].mTime <= clockTime)
+            {
+               UnlinkSlot(index);
+               mExpiredScratch.push_back(index);
+            }
+            index = next;
+         }
+
+         if (mCurrentTick == targetTick)
+         {
+            break;
+         }
+
+         ++mCurrentTick;
+         // Each time a level turns over, the slot of the next level up that it is now entering moves down.
+         for (unsigned level = 1; (mCurrentTick & SLOT_MASK) == 0 && level <= NUM_LEVELS; ++level)
+         {
+            if (level == NUM_LEVELS)
+            {
+               Cascade(OVERFLOW_SLOT);
+               break;
+            }
+
+            unsigned long long levelIndex = (mCurrentTick >> (SLOT_BITS * level)) & SLOT_MASK;
+            Cascade(level * SLOTS_PER_LEVEL + unsigned(levelIndex));
+            if (levelIndex != 0)
+            {
+               break;
+            }
+         }
+      }
+
+      std::sort(mExpiredScratch.begin(), mExpiredScratch.end(), DueLess(mTimers));
+
+      expiredOut.resize(mExpiredScratch.size());
+      for (unsigned i = 0; i < mExpiredScratch.size(); ++i)
+      {
+         unsigned index = mExpiredScratch[i];
+         Timer& timer = mTimers[index];
+         ExpiredTimer& expired = expiredOut[i];
+         expired.mName = timer.mName;
+         expired.mAboutActor = timer.mAboutActor;
+         expired.mTime = timer.mTime;
+
+         if (timer.mRepeat)
+         {
+            // Rescheduled after the wheel has turned so it can't expire again in this call.
+            timer.mTime += timer.mInterval;
+            Schedule(index);
+         }
+         else
+         {
+            UnlinkActor(index);
+            FreeTimer(index);
+         }
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   unsigned TimerWheel::AllocateTimer()
+   {
+      unsigned index = mFreeHead;
+      if (index != NONE)
+      {
+         mFreeHead = mTimers[index].mNext;
+      }
+      else
+      {
+         index = unsigned(mTimers.size());
+         mTimers.push_back(Timer());
+         mTimers.back().mGeneration = 0U;
+      }
+
+      Timer& timer = mTimers[index];
+      timer.mSlot = NONE;
+      timer.mPrev = timer.mNext = NONE;
+      timer.mActorPrev = timer.mActorNext = NONE;
+      timer.mInUse = true;
+      return index;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::FreeTimer(unsigned index)
+   {
+      Timer& timer = mTimers[index];
+      timer.mInUse = false;
+      ++timer.mGeneration;
+      // Drop the reference to the interned name.
+      timer.mName = dtUtil::RefString();
+      timer.mNext = mFreeHead;
+      mFreeHead = index;
+      --mNumTimers;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Erase(unsigned index)
+   {
+      UnlinkSlot(index);
+      UnlinkActor(index);
+      FreeTimer(index);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Schedule(unsigned index)
+   {
+      unsigned long long tick = std::max(mTimers[index].mTime / mResolution, mCurrentTick);
+      // The level is the lowest one above every bit where the tick differs from the current tick.
+      unsigned long long diff = tick ^ mCurrentTick;
+      for (unsigned level = 0; level < NUM_LEVELS; ++level)
+      {
+         if ((diff >> (SLOT_BITS * (level + 1))) == 0)
+         {
+            unsigned long long levelIndex = (tick >> (SLOT_BITS * level)) & SLOT_MASK;
+            LinkSlot(index, level * SLOTS_PER_LEVEL + unsigned(levelIndex));
+            return;
+         }
+      }
+      LinkSlot(index, OVERFLOW_SLOT);
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::LinkSlot(unsigned index, unsigned slot)
+   {
+      Timer& timer = mTimers[index];
+      timer.mSlot = slot;
+      timer.mPrev = NONE;
+      timer.mNext = mSlots[slot];
+      if (timer.mNext != NONE)
+      {
+         mTimers[timer.mNext].mPrev = index;
+      }
+      mSlots[slot] = index;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::UnlinkSlot(unsigned index)
+   {
+      Timer& timer = mTimers[index];
+      if (timer.mSlot == NONE)
+      {
+         return;
+      }
+
+      if (timer.mPrev != NONE)
+      {
+         mTimers[timer.mPrev].mNext = timer.mNext;
+      }
+      else
+      {
+         mSlots[timer.mSlot] = timer.mNext;
+      }
+
+      if (timer.mNext != NONE)
+      {
+         mTimers[timer.mNext].mPrev = timer.mPrev;
+      }
+
+      timer.mSlot = NONE;
+      timer.mPrev = timer.mNext = NONE;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::LinkActor(unsigned index)
+   {
+      Timer& timer = mTimers[index];
+      std::pair<ActorTimerMap::iterator, bool> inserted =
+               mActorTimers.insert(std::make_pair(timer.mAboutActor, index));
+      if (!inserted.second)
+      {
+         timer.mActorNext = inserted.first->second;
+         mTimers[timer.mActorNext].mActorPrev = index;
+         inserted.first->second = index;
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::UnlinkActor(unsigned index)
+   {
+      Timer& timer = mTimers[index];
+      if (timer.mActorPrev != NONE)
+      {
+         mTimers[timer.mActorPrev].mActorNext = timer.mActorNext;
+      }
+      else
+      {
+         ActorTimerMap::iterator found = mActorTimers.find(timer.mAboutActor);
+         if (found != mActorTimers.end())
+         {
+            if (timer.mActorNext != NONE)
+            {
+               found->second = timer.mActorNext;
+            }
+            else
+            {
+               mActorTimers.erase(found);
+            }
+         }
+      }
+
+      if (timer.mActorNext != NONE)
+      {
+         mTimers[timer.mActorNext].mActorPrev = timer.mActorPrev;
+      }
+
+      timer.mActorPrev = timer.mActorNext = NONE;
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Cascade(unsigned slot)
+   {
+      mScratch.clear();
+      for (unsigned index = mSlots[slot]; index != NONE; index = mTimers[index].mNext)
+      {
+         mScratch.push_back(index);
+      }
+      mSlots[slot] = NONE;
+
+      for (unsigned i = 0; i < mScratch.size(); ++i)
+      {
+         Schedule(mScratch[i]);
+      }
+   }
+
+   //////////////////////////////////////////////////////////////////////////
+   void TimerWheel::Rebuild(unsigned long long tick)
+   {
+      mCurrentTick = tick;
+      std::fill(mSlots.begin(), mSlots.end(), unsigned(NONE));
+      for (unsigned i = 0; i < mTimers.size(); ++i)
+      {
+         if (mTimers[i].mInUse)
+         {
+            Schedule(i);
+         }
+      }
+   }
+}
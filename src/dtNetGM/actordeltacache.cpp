@@ -0,0 +1,486 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2005-2010, Alion Science and Technology.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <dtNetGM/actordeltacache.h>
+#include <dtGame/actorupdatemessage.h>
+#include <dtGame/basemessages.h>
+#include <dtCore/datatype.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/log.h>
+#include <OpenThreads/ScopedLock>
+
+namespace dtNetGM
+{
+   namespace
+   {
+      /// Serializes one parameter the same way it would be written inside a message.
+      std::string WriteValue(const dtGame::MessageParameter& param)
+      {
+         dtUtil::DataStream ds;
+         param.ToDataStream(ds);
+         return std::string(ds.GetBuffer(), ds.GetBufferSize());
+      }
+
+      /// Loads a value written by WriteValue into a parameter of the same type.
+      void ReadValue(dtGame::MessageParameter& param, const std::string& value)
+      {
+         // A DataStream can't wrap an empty buffer, and an empty value has nothing to read anyway.
+         if (value.empty())
+         {
+            return;
+         }
+         std::vector<char> bytes(value.begin(), value.end());
+         dtUtil::DataStream ds(&bytes[0], unsigned(bytes.size()), false);
+         param.FromDataStream(ds);
+      }
+
+      /// Reads a value from the stream into the parameter and returns the bytes it took up.
+      std::string ReadValue(dtGame::MessageParameter& param, dtUtil::DataStream& stream)
+      {
+         unsigned start = stream.GetReadPosition();
+         param.FromDataStream(stream);
+         return std::string(stream.GetBuffer() + start, stream.GetReadPosition() - start);
+      }
+
+      dtCore::DataType* FindDataType(unsigned char typeId)
+      {
+         const std::vector<dtCore::DataType*>& types = dtCore::DataType::EnumerateType();
+         for (unsigned i = 0; i < types.size(); ++i)
+         {
+            if (types[i]->GetTypeId() == typeId)
+            {
+               return types[i];
+            }
+         }
+         return NULL;
+      }
+
+      /// The message parameters other than the update group, i.e. name, actor type, and partial update flag.
+      void GetHeaderParameters(const dtGame::ActorUpdateMessage& message, std::vector<const dtGame::MessageParameter*>& toFill)
+      {
+         message.GetParameterList(toFill);
+         for (unsigned i = 0; i < toFill.size(); ++i)
+         {
+            if (toFill[i]->GetName() == dtGame::ActorUpdateMessage::UPDATE_GROUP_PARAMETER)
+            {
+               toFill.erase(toFill.begin() + i);
+               break;
+            }
+         }
+      }
+
+      inline void SetBit(std::vector<unsigned char>& mask, unsigned index)
+      {
+         mask[index >> 3] |= (unsigned char)(1U << (index & 7U));
+      }
+
+      inline bool GetBit(const std::vector<unsigned char>& mask, unsigned index)
+      {
+         return (mask[index >> 3] & (1U << (index & 7U))) != 0;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ActorDeltaCache::ActorDeltaCache()
+   : mDeltaUpdatesWritten(0U)
+   , mFullUpdatesWritten(0U)
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ActorDeltaCache::~ActorDeltaCache()
+   {
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   int ActorDeltaCache::FindSlot(const ActorState& state, const std::string& name)
+   {
+      for (unsigned i = 0; i < state.mSlots.size(); ++i)
+      {
+         if (state.mSlots[i].mName == name)
+         {
+            return int(i);
+         }
+      }
+      return -1;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ActorDeltaCache::WriteUpdate(const dtGame::ActorUpdateMessage& message, dtUtil::DataStream& stream)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      SentActor& sent = mSent[message.GetAboutActorId()];
+
+      // If the receiver has gone quiet, stop relying on its baseline.
+      static const ActorState EMPTY_STATE;
+      const ActorState& base = sent.mPending.size() < MAX_UNACKED_UPDATES ? sent.mAcked : EMPTY_STATE;
+
+      ActorState state;
+      state.mSequence = sent.mNextSequence++;
+      // skip 0 on wrap around, it means "no baseline".
+      if (sent.mNextSequence == 0U)
+      {
+         sent.mNextSequence = 1U;
+      }
+      state.mSlots = base.mSlots;
+
+      std::vector<const dtGame::MessageParameter*> headerParams;
+      GetHeaderParameters(message, headerParams);
+      dtUtil::DataStream headerStream;
+      for (unsigned i = 0; i < headerParams.size(); ++i)
+      {
+         headerParams[i]->ToDataStream(headerStream);
+      }
+      state.mHeader.assign(headerStream.GetBuffer(), headerStream.GetBufferSize());
+
+      unsigned baseSlotCount = unsigned(base.mSlots.size());
+      std::vector<unsigned char> present((baseSlotCount + 7U) / 8U, 0);
+      std::vector<unsigned char> changed(present.size(), 0);
+      std::vector<const std::string*> changedValues(baseSlotCount, (const std::string*)NULL);
+      std::vector<const dtGame::MessageParameter*> newParams;
+      std::vector<std::string> newValues;
+
+      std::vector<const dtGame::MessageParameter*> updateParams;
+      message.GetUpdateParameters(updateParams);
+      for (unsigned i = 0; i < updateParams.size(); ++i)
+      {
+         const dtGame::MessageParameter& param = *updateParams[i];
+         std::string value = WriteValue(param);
+
+         int slot = FindSlot(base, param.GetName());
+         if (slot >= 0 && base.mSlots[slot].mType == &param.GetDataType() && base.mSlots[slot].mIsList == param.IsList())
+         {
+            SetBit(present, unsigned(slot));
+            if (base.mSlots[slot].mValue != value)
+            {
+               SetBit(changed, unsigned(slot));
+               state.mSlots[slot].mValue.swap(value);
+               changedValues[slot] = &state.mSlots[slot].mValue;
+            }
+         }
+         else
+         {
+            // Unknown, or its type changed.  It's sent in full and replaces any slot with the same name.
+            newParams.push_back(&param);
+            newValues.push_back(value);
+         }
+      }
+
+      bool headerChanged = state.mHeader != base.mHeader;
+
+      stream << state.mSequence;
+      stream << base.mSequence;
+      stream << headerChanged;
+      if (headerChanged)
+      {
+         stream << state.mHeader;
+      }
+
+      stream << baseSlotCount;
+      if (baseSlotCount > 0U)
+      {
+         stream.WriteBinary(reinterpret_cast<const char*>(&present[0]), unsigned(present.size()));
+         stream.WriteBinary(reinterpret_cast<const char*>(&changed[0]), unsigned(changed.size()));
+         for (unsigned i = 0; i < baseSlotCount; ++i)
+         {
+            if (changedValues[i] != NULL)
+            {
+               stream.WriteBinary(changedValues[i]->data(), unsigned(changedValues[i]->size()));
+            }
+         }
+      }
+
+      stream << unsigned(newParams.size());
+      for (unsigned i = 0; i < newParams.size(); ++i)
+      {
+         const dtGame::MessageParameter& param = *newParams[i];
+         stream << param.GetDataType().GetTypeId();
+         stream << param.GetName();
+         stream << param.IsList();
+         stream.WriteBinary(newValues[i].data(), unsigned(newValues[i].size()));
+
+         ParameterSlot newSlot;
+         newSlot.mType = &param.GetDataType();
+         newSlot.mName = param.GetName();
+         newSlot.mIsList = param.IsList();
+         newSlot.mValue.swap(newValues[i]);
+
+         int slot = FindSlot(state, newSlot.mName);
+         if (slot >= 0)
+         {
+            state.mSlots[slot] = newSlot;
+         }
+         else
+         {
+            state.mSlots.push_back(newSlot);
+         }
+      }
+
+      if (base.mSequence == 0U)
+      {
+         ++mFullUpdatesWritten;
+      }
+      else
+      {
+         ++mDeltaUpdatesWritten;
+      }
+
+      sent.mPending.push_back(state);
+      while (sent.mPending.size() > MAX_UNACKED_UPDATES)
+      {
+         sent.mPending.pop_front();
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool ActorDeltaCache::ReadUpdate(dtGame::ActorUpdateMessage& message, dtUtil::DataStream& stream)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      const dtCore::UniqueId& actorId = message.GetAboutActorId();
+
+      unsigned sequence = 0U, baseSequence = 0U;
+      bool headerChanged = false;
+      stream >> sequence;
+      stream >> baseSequence;
+      stream >> headerChanged;
+
+      ReceivedStates& states = mReceived[actorId];
+
+      static const ActorState EMPTY_STATE;
+      const ActorState* base = &EMPTY_STATE;
+      if (baseSequence != 0U)
+      {
+         // The sender only moves its baseline forward, so anything older can go.
+         while (!states.empty() && states.front().mSequence != baseSequence)
+         {
+            states.pop_front();
+         }
+
+         if (states.empty())
+         {
+            LOGN_WARNING("dtNetGM", "Received an actor update for " + actorId.ToString()
+                  + " against a baseline that is not known.  Asking the sender to start over.");
+            mPendingAcks[actorId] = 0U;
+            return false;
+         }
+         base = &states.front();
+      }
+
+      ActorState state;
+      state.mSequence = sequence;
+      state.mSlots = base->mSlots;
+      if (headerChanged)
+      {
+         stream >> state.mHeader;
+      }
+      else
+      {
+         state.mHeader = base->mHeader;
+      }
+
+      std::vector<dtGame::MessageParameter*> headerParams;
+      message.GetParameterList(headerParams);
+      if (!state.mHeader.empty())
+      {
+         std::vector<char> bytes(state.mHeader.begin(), state.mHeader.end());
+         dtUtil::DataStream headerStream(&bytes[0], unsigned(bytes.size()), false);
+         for (unsigned i = 0; i < headerParams.size(); ++i)
+         {
+            if (headerParams[i]->GetName() != dtGame::ActorUpdateMessage::UPDATE_GROUP_PARAMETER)
+            {
+               headerParams[i]->FromDataStream(headerStream);
+            }
+         }
+      }
+
+      unsigned baseSlotCount = 0U;
+      stream >> baseSlotCount;
+      if (baseSlotCount != base->mSlots.size())
+      {
+         LOGN_ERROR("dtNetGM", "Received an actor update for " + actorId.ToString() + " that does not match its baseline.");
+         mPendingAcks[actorId] = 0U;
+         return false;
+      }
+
+      if (baseSlotCount > 0U)
+      {
+         std::vector<unsigned char> present((baseSlotCount + 7U) / 8U, 0);
+         std::vector<unsigned char> changed(present.size(), 0);
+         stream.ReadBinary(reinterpret_cast<char*>(&present[0]), unsigned(present.size()));
+         stream.ReadBinary(reinterpret_cast<char*>(&changed[0]), unsigned(changed.size()));
+
+         for (unsigned i = 0; i < baseSlotCount; ++i)
+         {
+            if (!GetBit(present, i))
+            {
+               continue;
+            }
+
+            ParameterSlot& slot = state.mSlots[i];
+            dtCore::RefPtr<dtGame::MessageParameter> param = dtGame::MessageParameter::CreateFromType(*slot.mType, slot.mName, slot.mIsList);
+            if (GetBit(changed, i))
+            {
+               slot.mValue = ReadValue(*param, stream);
+            }
+            else
+            {
+               ReadValue(*param, slot.mValue);
+            }
+            message.AddUpdateParameter(*param);
+         }
+      }
+
+      unsigned newCount = 0U;
+      stream >> newCount;
+      for (unsigned i = 0; i < newCount; ++i)
+      {
+         unsigned char typeId = 0;
+         ParameterSlot newSlot;
+         stream >> typeId;
+         stream >> newSlot.mName;
+         stream >> newSlot.mIsList;
+
+         newSlot.mType = FindDataType(typeId);
+         if (newSlot.mType == NULL)
+         {
+            LOGN_ERROR("dtNetGM", "Received an actor update for " + actorId.ToString() + " with an unknown parameter type.");
+            mPendingAcks[actorId] = 0U;
+            return false;
+         }
+
+         dtCore::RefPtr<dtGame::MessageParameter> param = dtGame::MessageParameter::CreateFromType(*newSlot.mType, newSlot.mName, newSlot.mIsList);
+         newSlot.mValue = ReadValue(*param, stream);
+         // a parameter whose type changed may already be there from the baseline part.
+         if (message.GetUpdateParameter(newSlot.mName) == NULL)
+         {
+            message.AddUpdateParameter(*param);
+         }
+
+         int slot = FindSlot(state, newSlot.mName);
+         if (slot >= 0)
+         {
+            state.mSlots[slot] = newSlot;
+         }
+         else
+         {
+            state.mSlots.push_back(newSlot);
+         }
+      }
+
+      states.push_back(state);
+      while (states.size() > MAX_RECEIVED_STATES)
+      {
+         states.pop_front();
+      }
+
+      mPendingAcks[actorId] = sequence;
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ActorDeltaCache::ProcessAcks(const dtGame::NetActorUpdateAckMessage& ackMessage)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      for (unsigned i = 0; i < ackMessage.GetAckCount(); ++i)
+      {
+         std::map<dtCore::UniqueId, SentActor>::iterator found = mSent.find(ackMessage.GetAckActorId(i));
+         if (found == mSent.end())
+         {
+            continue;
+         }
+
+         SentActor& sent = found->second;
+         unsigned sequence = ackMessage.GetAckSequence(i);
+         if (sequence == 0U)
+         {
+            // The receiver lost track, so the next update goes out without a baseline.
+            sent.mAcked = ActorState();
+            sent.mPending.clear();
+            continue;
+         }
+
+         std::deque<ActorState>::iterator pending = sent.mPending.begin();
+         while (pending != sent.mPending.end() && pending->mSequence != sequence)
+         {
+            ++pending;
+         }
+
+         // Not found means a newer ack already moved the baseline past it.
+         if (pending != sent.mPending.end())
+         {
+            sent.mAcked = *pending;
+            sent.mPending.erase(sent.mPending.begin(), pending + 1);
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool ActorDeltaCache::TakePendingAcks(dtGame::NetActorUpdateAckMessage& ackMessage)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      if (mPendingAcks.empty())
+      {
+         return false;
+      }
+
+      std::map<dtCore::UniqueId, unsigned>::const_iterator i, iend = mPendingAcks.end();
+      for (i = mPendingAcks.begin(); i != iend; ++i)
+      {
+         ackMessage.AddAck(i->first, i->second);
+      }
+      mPendingAcks.clear();
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ActorDeltaCache::RemoveActor(const dtCore::UniqueId& actorId)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mSent.erase(actorId);
+      mReceived.erase(actorId);
+      mPendingAcks.erase(actorId);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void ActorDeltaCache::Clear()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      mSent.clear();
+      mReceived.clear();
+      mPendingAcks.clear();
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned ActorDeltaCache::GetDeltaUpdatesWritten() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mDeltaUpdatesWritten;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned ActorDeltaCache::GetFullUpdatesWritten() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+      return mFullUpdatesWritten;
+   }
+}
@@ -153,6 +153,13 @@ namespace dtNetGM
       mMachineInfoServer = new dtGame::MachineInfo("Server");
       *mMachineInfoServer = msg.GetSource();
 
+      // offer the server the newest wire format this client can read, if the server knows the offer message.
+      const dtGame::NetConnectionMessage* connectionMsg = dynamic_cast<const dtGame::NetConnectionMessage*>(&msg);
+      if (connectionMsg != NULL && connectionMsg->GetProtocolVersion() >= 1U)
+      {
+         SendWireFormatMessage(msg.GetSource());
+      }
+
       LOGN_INFO("dtNetGM", "Connection accepted by " + msg.GetSource().GetName() + " {" + msg.GetSource().GetHostName() + "}");
    }
 
@@ -244,10 +251,12 @@ namespace dtNetGM
    ////////////////////////////////////////////////////////////////////
    void ClientNetworkComponent::SendRequestConnectionMessage()
    {
-      dtCore::RefPtr<dtGame::MachineInfoMessage> message;
+      dtCore::RefPtr<dtGame::NetConnectionMessage> message;
       GetGameManager()->GetMessageFactory().CreateMessage(dtGame::MessageType::NETCLIENT_REQUEST_CONNECTION, message);
       message->SetDestination(GetServer());
       message->SetMachineInfo(GetGameManager()->GetMachineInfo());
+      message->SetProtocolVersion(NETWORK_PROTOCOL_VERSION);
+
       SendNetworkMessage(*message, dtNetGM::NetworkComponent::DestinationType::ALL_NOT_CLIENTS);
    }
 
@@ -37,6 +37,8 @@ namespace dtNetGM
       , mMachineInfo(new dtGame::MachineInfo())
       , mGneConnection(NULL)
       , mConnectedClient(false)
+      , mWireFormat(&WireFormat::TEXT_IDS)
+      , mActorDeltaCache(new ActorDeltaCache())
       , mLastStream(0)
    {
       mMachineInfo->SetName("Not Connected");
@@ -84,6 +86,8 @@ namespace dtNetGM
       mNetworkComponent->OnDisconnect(*this);
 
       mConnectedClient = false;
+      mWireFormat = &WireFormat::TEXT_IDS;
+      mActorDeltaCache->Clear();
    }
 
    void NetworkBridge::Disconnect(int waitTime)
@@ -31,7 +31,9 @@
 #include <dtGame/messagetype.h>
 #include <dtGame/messagefactory.h>
 #include <dtGame/basemessages.h>
+#include <dtGame/actorupdatemessage.h>
 #include <dtUtil/log.h>
+#include <dtUtil/mathdefines.h>
 #include <dtUtil/threadpool.h>
 #include <dtCore/system.h>
 
@@ -67,6 +69,58 @@ namespace dtNetGM
       OpenThreads::Atomic mQueued;
    };
 
+   ////////////////////////////////////////////////////////////////////////////////
+   ////////////////////////////////////////////////////////////////////////////////
+   /**
+    * Encodes one message at most once per wire format while it is sent to several connections
+    * that may not all have agreed on the same format.  Actor updates in the delta format depend on
+    * each connection's baselines, so those are encoded again for every connection.
+    */
+   class MessageStreamCache
+   {
+   public:
+      MessageStreamCache(NetworkComponent& component, const dtGame::Message& message)
+      : mComponent(component)
+      , mMessage(message)
+      , mPerBridge(message.GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED
+            || message.GetMessageType() == dtGame::MessageType::INFO_ACTOR_DELETED)
+      {
+         for (unsigned i = 0; i < FORMAT_COUNT; ++i)
+         {
+            mHasStream[i] = false;
+         }
+      }
+
+      dtUtil::DataStream& GetStream(NetworkBridge& bridge)
+      {
+         const WireFormat& format = bridge.GetWireFormat();
+         if (format == WireFormat::BINARY_DELTA && mPerBridge)
+         {
+            mBridgeStream.ClearBuffer();
+            mComponent.WriteToDataStream(mMessage, mBridgeStream, format, &bridge);
+            return mBridgeStream;
+         }
+
+         unsigned index = dtUtil::Min(format.GetVersion(), FORMAT_COUNT - 1U);
+         if (!mHasStream[index])
+         {
+            mComponent.WriteToDataStream(mMessage, mStreams[index], format, &bridge);
+            mHasStream[index] = true;
+         }
+         return mStreams[index];
+      }
+
+   private:
+      static const unsigned FORMAT_COUNT = 3U;
+
+      NetworkComponent& mComponent;
+      const dtGame::Message& mMessage;
+      bool mPerBridge;
+      dtUtil::DataStream mStreams[FORMAT_COUNT];
+      bool mHasStream[FORMAT_COUNT];
+      dtUtil::DataStream mBridgeStream;
+   };
+
    ////////////////////////////////////////////////////////////////////////////////
    ////////////////////////////////////////////////////////////////////////////////
    IMPLEMENT_ENUM(MessageActionCode);
@@ -99,6 +153,8 @@ namespace dtNetGM
 
    NetworkComponent::NetworkComponent(dtCore::SystemComponentType& type)
    : dtGame::GMComponent(*TYPE)
+   , mBinaryWireFormatEnabled(true)
+   , mActorUpdateDeltasEnabled(true)
    , mShuttingDown(false)
    , mReliable(true)
    , mRateOut(0)
@@ -117,6 +173,8 @@ namespace dtNetGM
    , mGameName(gameName)
    , mGameVersion(gameVersion)
    , mGNELogFile(logFile)
+   , mBinaryWireFormatEnabled(true)
+   , mActorUpdateDeltasEnabled(true)
    , mShuttingDown(false)
    , mReliable(true)
    , mRateOut(0)
@@ -144,6 +202,8 @@ namespace dtNetGM
    DT_IMPLEMENT_ACCESSOR(NetworkComponent, std::string, GameName);
    DT_IMPLEMENT_ACCESSOR(NetworkComponent, int, GameVersion);
    DT_IMPLEMENT_ACCESSOR(NetworkComponent, std::string, GNELogFile);
+   DT_IMPLEMENT_ACCESSOR(NetworkComponent, bool, BinaryWireFormatEnabled);
+   DT_IMPLEMENT_ACCESSOR(NetworkComponent, bool, ActorUpdateDeltasEnabled);
 
    ////////////////////////////////////////////////////////////////////////////////
    void NetworkComponent::BuildPropertyMap()
@@ -156,6 +216,8 @@ namespace dtNetGM
       DT_REGISTER_PROPERTY(GameName, "The Name of this game from the perspective or the networking.", RegHelperType, propReg);
       DT_REGISTER_PROPERTY(GameVersion, "The version this game from the perspective or the networking.", RegHelperType, propReg);
       DT_REGISTER_PROPERTY(GNELogFile, "The log file for the GNE networking library.", RegHelperType, propReg);
+      DT_REGISTER_PROPERTY(BinaryWireFormatEnabled, "Offer the binary message wire format to peers that support it.", RegHelperType, propReg);
+      DT_REGISTER_PROPERTY(ActorUpdateDeltasEnabled, "Send only the changed parameters of actor updates to peers that support it.", RegHelperType, propReg);
    }
 
    ////////////////////////////////////////////////////////////////////////////////
@@ -457,6 +519,8 @@ namespace dtNetGM
    ////////////////////////////////////////////////////////////////////////////////
    void NetworkComponent::DoEndOfTick()
    {
+      SendActorUpdateAcks();
+
       if (!mMessageBufferOut.empty())
       {
          // At the end of the frame, we want to make sure we queue up all remaining messages.
@@ -474,6 +538,36 @@ namespace dtNetGM
       }
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::SendActorUpdateAcks()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+      dtCore::RefPtr<dtGame::NetActorUpdateAckMessage> ackMsg;
+      for (std::vector<NetworkBridge*>::iterator iter = mConnections.begin(); iter != mConnections.end(); iter++)
+      {
+         NetworkBridge* bridge = *iter;
+         if (!bridge->IsConnectedClient() || bridge->GetWireFormat() != WireFormat::BINARY_DELTA)
+         {
+            continue;
+         }
+
+         if (!ackMsg.valid())
+         {
+            GetGameManager()->GetMessageFactory().CreateMessage(dtGame::MessageType::NET_ACTOR_UPDATE_ACK, ackMsg);
+         }
+
+         if (bridge->GetActorDeltaCache().TakePendingAcks(*ackMsg))
+         {
+            ackMsg->SetDestination(&bridge->GetMachineInfo());
+            dtUtil::DataStream ackStream = CreateDataStream(*ackMsg, bridge->GetWireFormat(), bridge);
+            bridge->SendDataStream(ackStream, true);
+            // the message holds the acks for one connection only.
+            ackMsg = NULL;
+         }
+      }
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    void NetworkComponent::StartSendTask()
    {
@@ -546,10 +640,7 @@ namespace dtNetGM
       if (!networkBridge.IsConnectedClient())
       {
          // Read MessageType::mId for special case
-         dataStream.Rewind();
-         unsigned short msgId = 0;
-         dataStream.Read(msgId);
-         dataStream.Rewind();
+         unsigned short msgId = PeekMessageTypeId(dataStream);
 
          if (msgId == dtGame::MessageType::NETCLIENT_REQUEST_CONNECTION.GetId()
                || msgId == dtGame::MessageType::NETSERVER_ACCEPT_CONNECTION.GetId())
@@ -582,11 +673,59 @@ namespace dtNetGM
       message = CreateMessage(dataStream, networkBridge);
       if (message.valid())
       {
+         // The wire format only matters to this connection, so it is neither forwarded nor sent to the GM.
+         if (message->GetMessageType() == dtGame::MessageType::NET_WIRE_FORMAT)
+         {
+            ProcessNetWireFormat(static_cast<const dtGame::NetWireFormatMessage&>(*message), networkBridge);
+            return;
+         }
+         else if (message->GetMessageType() == dtGame::MessageType::NET_ACTOR_UPDATE_ACK)
+         {
+            ProcessNetActorUpdateAck(static_cast<const dtGame::NetActorUpdateAckMessage&>(*message), networkBridge);
+            return;
+         }
+
          OnReceivedNetworkMessage(*message, networkBridge);
          ForwardMessage(*message, networkBridge);
       }
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   const WireFormat& NetworkComponent::GetNewestEnabledWireFormat() const
+   {
+      if (!GetBinaryWireFormatEnabled())
+      {
+         return WireFormat::TEXT_IDS;
+      }
+      return GetActorUpdateDeltasEnabled() ? WireFormat::BINARY_DELTA : WireFormat::BINARY;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::ProcessNetWireFormat(const dtGame::NetWireFormatMessage& msg, NetworkBridge& networkBridge)
+   {
+      unsigned agreedVersion = dtUtil::Min(GetNewestEnabledWireFormat().GetVersion(), msg.GetWireFormatVersion());
+
+      networkBridge.SetWireFormat(WireFormat::GetByVersion(agreedVersion));
+
+      LOGN_DEBUG("dtNetGM", "Using wire format " + networkBridge.GetWireFormat().GetName() + " for messages to " + networkBridge.GetHostDescription());
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::SendWireFormatMessage(const dtGame::MachineInfo& destination)
+   {
+      dtCore::RefPtr<dtGame::NetWireFormatMessage> wireFormatMsg;
+      GetGameManager()->GetMessageFactory().CreateMessage(dtGame::MessageType::NET_WIRE_FORMAT, wireFormatMsg);
+      wireFormatMsg->SetDestination(&destination);
+      wireFormatMsg->SetWireFormatVersion(GetNewestEnabledWireFormat().GetVersion());
+      SendNetworkMessage(*wireFormatMsg);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::ProcessNetActorUpdateAck(const dtGame::NetActorUpdateAckMessage& msg, NetworkBridge& networkBridge)
+   {
+      networkBridge.GetActorDeltaCache().ProcessAcks(msg);
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    void NetworkComponent::ForwardMessage(const dtGame::Message& message, NetworkBridge& networkBridge)
    {
@@ -599,13 +738,13 @@ namespace dtNetGM
          //         }
 
          // forward the message to any other connections
-         dtUtil::DataStream dataStreamFwd = CreateDataStream(message);
+         MessageStreamCache streams(*this, message);
          for (std::vector<dtNetGM::NetworkBridge*>::iterator iter = mConnections.begin(); iter != mConnections.end(); iter++)
          {
             dtNetGM::NetworkBridge* bridge = *iter;
             if (bridge != &networkBridge && bridge->IsConnectedClient() && bridge->GetMachineInfo() != message.GetSource())
             {
-               bridge->SendDataStream(dataStreamFwd, true);
+               bridge->SendDataStream(streams.GetStream(*bridge), true);
             }
          }
       }
@@ -737,8 +876,8 @@ namespace dtNetGM
          return;
       }
 
-      // Create the MessageDataStream
-      dtUtil::DataStream dataStream = CreateDataStream(message);
+      // Each connection may have agreed on a different wire format, so the streams are created as needed.
+      MessageStreamCache streams(*this, message);
 
       if (destinationType == DestinationType::DESTINATION)
       {
@@ -746,7 +885,7 @@ namespace dtNetGM
          {
             if ((*iter)->GetMachineInfo() == *(message.GetDestination()))
             {
-               (*iter)->SendDataStream(dataStream, true);
+               (*iter)->SendDataStream(streams.GetStream(**iter), true);
                return;
             }
          }
@@ -759,7 +898,7 @@ namespace dtNetGM
             {
                if ((*iter)->IsConnectedClient())
                {
-                  (*iter)->SendDataStream(dataStream, true);
+                  (*iter)->SendDataStream(streams.GetStream(**iter), true);
                }
             }
          } // DestinationType::ALL_CLIENTS
@@ -770,7 +909,7 @@ namespace dtNetGM
             {
                if (!(*iter)->IsConnectedClient())
                {
-                  (*iter)->SendDataStream(dataStream, true);
+                  (*iter)->SendDataStream(streams.GetStream(**iter), true);
                }
             }
          } // DestinationType::ALL_NOT_CLIENTS
@@ -778,32 +917,84 @@ namespace dtNetGM
    }
 
    ////////////////////////////////////////////////////////////////////////////////
-   dtUtil::DataStream NetworkComponent::CreateDataStream(const dtGame::Message& message)
+   dtUtil::DataStream NetworkComponent::CreateDataStream(const dtGame::Message& message, const WireFormat& format,
+         NetworkBridge* networkBridge)
    {
       dtUtil::DataStream stream;
+      WriteToDataStream(message, stream, format, networkBridge);
+      return stream;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void NetworkComponent::WriteToDataStream(const dtGame::Message& message, dtUtil::DataStream& stream, const WireFormat& format,
+         NetworkBridge* networkBridge)
+   {
+      // deltas are relative to one connection, so they can't be written without it.
+      bool delta = format == WireFormat::BINARY_DELTA && networkBridge != NULL;
 
-      stream.Write(message.GetMessageType().GetId()); // MessageType.mId
-      stream.Write(message.GetSource().GetUniqueId().ToString()); // Source
-      if (message.GetDestination() != NULL)
+      if (format != WireFormat::TEXT_IDS)
       {
-         stream.Write(message.GetDestination()->GetUniqueId().ToString()); // Destination
+         static const dtCore::UniqueId NULL_ID("");
+
+         stream.Write(WireFormat::BINARY_STREAM_MARKER);
+         stream.Write((unsigned char)(delta ? WireFormat::BINARY_DELTA.GetVersion() : WireFormat::BINARY.GetVersion()));
+         stream.Write(message.GetMessageType().GetId()); // MessageType.mId
+         WriteBinaryUniqueId(stream, message.GetSource().GetUniqueId()); // Source
+         WriteBinaryUniqueId(stream, message.GetDestination() != NULL ? message.GetDestination()->GetUniqueId() : NULL_ID); // Destination
+         WriteBinaryUniqueId(stream, message.GetSendingActorId()); // Sending Actor
+         WriteBinaryUniqueId(stream, message.GetAboutActorId()); // About Actor
       }
       else
       {
-         stream.Write(std::string(""));
+         stream.Write(message.GetMessageType().GetId()); // MessageType.mId
+         stream.Write(message.GetSource().GetUniqueId().ToString()); // Source
+         if (message.GetDestination() != NULL)
+         {
+            stream.Write(message.GetDestination()->GetUniqueId().ToString()); // Destination
+         }
+         else
+         {
+            stream.Write(std::string(""));
+         }
+         stream.Write(message.GetSendingActorId().ToString()); // Sending Actor
+         stream.Write(message.GetAboutActorId().ToString()); // About Actor
       }
-      stream.Write(message.GetSendingActorId().ToString()); // Sending Actor
-      stream.Write(message.GetAboutActorId().ToString()); // About Actor
 
-      message.ToDataStream(stream);
+      if (delta && message.GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED)
+      {
+         networkBridge->GetActorDeltaCache().WriteUpdate(static_cast<const dtGame::ActorUpdateMessage&>(message), stream);
+      }
+      else
+      {
+         if (delta && message.GetMessageType() == dtGame::MessageType::INFO_ACTOR_DELETED)
+         {
+            // The receiver drops its side when it reads the delete.
+            networkBridge->GetActorDeltaCache().RemoveActor(message.GetAboutActorId());
+         }
+         message.ToDataStream(stream);
+      }
 
       if (message.GetCausingMessage() != NULL)
       {
-         stream.AppendDataStream(CreateDataStream(*message.GetCausingMessage()));
-         // append causing message??
+         // the causing message is written right after with a full header of its own.
+         WriteToDataStream(*message.GetCausingMessage(), stream, format, networkBridge);
       }
+   }
 
-      return stream;
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned short NetworkComponent::PeekMessageTypeId(dtUtil::DataStream& dataStream)
+   {
+      dataStream.Rewind();
+      unsigned short msgId = 0;
+      dataStream.Read(msgId);
+      if (msgId == WireFormat::BINARY_STREAM_MARKER)
+      {
+         unsigned char version = 0;
+         dataStream.Read(version);
+         dataStream.Read(msgId);
+      }
+      dataStream.Rewind();
+      return msgId;
    }
 
    ////////////////////////////////////////////////////////////////////////////////
@@ -819,9 +1010,25 @@ namespace dtNetGM
       dtCore::RefPtr<dtGame::Message> msg;
       unsigned short msgId = 0;
 
-      // MessageType.mId
+      // MessageType.mId, or the marker for a binary stream
       dataStream.Read(msgId);
 
+      bool binary = false;
+      bool delta = false;
+      if (msgId == WireFormat::BINARY_STREAM_MARKER)
+      {
+         unsigned char version = 0;
+         dataStream.Read(version);
+         if (version != WireFormat::BINARY.GetVersion() && version != WireFormat::BINARY_DELTA.GetVersion())
+         {
+            LOGN_ERROR("dtNetGM", "Received a binary message stream with an unsupported wire format version " + dtUtil::ToString(unsigned(version)) + ".");
+            return NULL;
+         }
+         binary = true;
+         delta = version == WireFormat::BINARY_DELTA.GetVersion();
+         dataStream.Read(msgId);
+      }
+
       try
       {
          const dtGame::MessageType& messageType = gm->GetMessageFactory().GetMessageTypeById(msgId);
@@ -850,12 +1057,31 @@ namespace dtNetGM
          return NULL;
       }
 
-      std::string szUniqueId;
+      dtCore::UniqueId sourceId(false), destinationId(false), sendingActorId(false), aboutActorId(false);
+      if (binary)
+      {
+         if (!ReadBinaryUniqueId(dataStream, sourceId) || !ReadBinaryUniqueId(dataStream, destinationId)
+               || !ReadBinaryUniqueId(dataStream, sendingActorId) || !ReadBinaryUniqueId(dataStream, aboutActorId))
+         {
+            LOGN_ERROR("dtNetGM", "Received a binary message stream with an invalid id in the header.  MessageId = " + dtUtil::ToString(msgId));
+            return NULL;
+         }
+      }
+      else
+      {
+         std::string szUniqueId;
+         dataStream.Read(szUniqueId);
+         sourceId = szUniqueId;
+         dataStream.Read(szUniqueId);
+         destinationId = szUniqueId;
+         dataStream.Read(szUniqueId);
+         sendingActorId = szUniqueId;
+         dataStream.Read(szUniqueId);
+         aboutActorId = szUniqueId;
+      }
 
       // Source
-      dataStream.Read(szUniqueId);
-
-      const dtGame::MachineInfo* machInfo = GetMachineInfo(dtCore::UniqueId(szUniqueId));
+      const dtGame::MachineInfo* machInfo = GetMachineInfo(sourceId);
 
       if (machInfo != NULL)
       {
@@ -869,29 +1095,37 @@ namespace dtNetGM
       }
 
       // Destination
-      dataStream.Read(szUniqueId);
-      if (szUniqueId.size() != 0)
+      if (!destinationId.IsNull())
       {
-         msg->SetDestination(GetMachineInfo(dtCore::UniqueId(szUniqueId)));
+         msg->SetDestination(GetMachineInfo(destinationId));
       }
 
-      // Sending Actor
-      dataStream.Read(szUniqueId);
-      msg->SetSendingActorId(dtCore::UniqueId(szUniqueId));
+      msg->SetSendingActorId(sendingActorId);
+      msg->SetAboutActorId(aboutActorId);
 
-      // About Actor
-      dataStream.Read(szUniqueId);
-      msg->SetAboutActorId(dtCore::UniqueId(szUniqueId));
-
-      msg->FromDataStream(dataStream);
+      if (delta && msg->GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED)
+      {
+         if (!networkBridge.GetActorDeltaCache().ReadUpdate(static_cast<dtGame::ActorUpdateMessage&>(*msg), dataStream))
+         {
+            return NULL;
+         }
+      }
+      else
+      {
+         if (delta && msg->GetMessageType() == dtGame::MessageType::INFO_ACTOR_DELETED)
+         {
+            networkBridge.GetActorDeltaCache().RemoveActor(aboutActorId);
+         }
+         msg->FromDataStream(dataStream);
+      }
 
       if (dataStream.GetRemainingReadSize() != 0)
       {
-         dtCore::RefPtr<dtGame::Message> msg = CreateMessage(dataStream, networkBridge);
-         if (msg.valid())
+         dtCore::RefPtr<dtGame::Message> causingMsg = CreateMessage(dataStream, networkBridge);
+         if (causingMsg.valid())
          {
             // more information, there must be a causing message!
-            msg->SetCausingMessage(msg);
+            msg->SetCausingMessage(causingMsg.get());
          }
       }
       return msg;
@@ -258,16 +258,25 @@ namespace dtNetGM
 
          // Generate a NETSERVER_ACCEPT_CONNECTION message
          // send the MachineInfo of our server to  the new client
-         dtCore::RefPtr<dtGame::MachineInfoMessage> acceptMsg;
+         dtCore::RefPtr<dtGame::NetConnectionMessage> acceptMsg;
          GetGameManager()->GetMessageFactory().CreateMessage(dtGame::MessageType::NETSERVER_ACCEPT_CONNECTION, acceptMsg);
          acceptMsg->SetDestination(&msg.GetSource());
          acceptMsg->SetMachineInfo(GetGameManager()->GetMachineInfo());
+         acceptMsg->SetProtocolVersion(NETWORK_PROTOCOL_VERSION);
          SendNetworkMessage(*acceptMsg);
 
          // inform new client of connected clients
          SendConnectedClientMessage(msg.GetSource());
          GetConnection(msg.GetSource())->SetClientConnected(true);
 
+         // Offer the new client the newest wire format this server can read, if the client knows the offer message.
+         // It is sent after the client is marked connected, so the reply isn't dropped as coming from a stranger.
+         const dtGame::NetConnectionMessage* connectionMsg = dynamic_cast<const dtGame::NetConnectionMessage*>(&msg);
+         if (connectionMsg != NULL && connectionMsg->GetProtocolVersion() >= 1U)
+         {
+            SendWireFormatMessage(msg.GetSource());
+         }
+
          // Let the new client (and any others) know what the current frame sync mode is
          SendFrameSyncControlMessage();
       }
@@ -0,0 +1,131 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ * Copyright (C) 2005-2010, Alion Science and Technology.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <dtNetGM/wireformat.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/datastream.h>
+
+namespace dtNetGM
+{
+   ////////////////////////////////////////////////////////////////////////////////
+   ////////////////////////////////////////////////////////////////////////////////
+   IMPLEMENT_ENUM(WireFormat);
+   WireFormat::WireFormat(const std::string& name, unsigned version)
+   : dtUtil::Enumeration(name)
+   , mVersion(version)
+   {
+      AddInstance(this);
+   }
+
+   const WireFormat WireFormat::TEXT_IDS("TEXT_IDS", 0U);
+   const WireFormat WireFormat::BINARY("BINARY", 1U);
+   const WireFormat WireFormat::BINARY_DELTA("BINARY_DELTA", 2U);
+
+   ////////////////////////////////////////////////////////////////////////////////
+   const WireFormat& WireFormat::GetByVersion(unsigned version)
+   {
+      const WireFormat* result = &TEXT_IDS;
+      const std::vector<WireFormat*>& formats = EnumerateType();
+      for (std::vector<WireFormat*>::const_iterator i = formats.begin(); i != formats.end(); ++i)
+      {
+         if ((*i)->GetVersion() <= version && (*i)->GetVersion() > result->GetVersion())
+         {
+            result = *i;
+         }
+      }
+      return *result;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ////////////////////////////////////////////////////////////////////////////////
+   namespace
+   {
+      enum BinaryIdTag
+      {
+         ID_TAG_NULL = 0,
+         ID_TAG_UUID = 1,
+         ID_TAG_STRING = 2
+      };
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool UniqueIdToBytes(const dtCore::UniqueId& id, unsigned char bytesOut[UNIQUE_ID_BYTE_COUNT])
+   {
+      return id.ToBytes(bytesOut);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void UniqueIdFromBytes(const unsigned char bytes[UNIQUE_ID_BYTE_COUNT], dtCore::UniqueId& idOut)
+   {
+      idOut.FromBytes(bytes);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void WriteBinaryUniqueId(dtUtil::DataStream& stream, const dtCore::UniqueId& id)
+   {
+      if (id.IsNull())
+      {
+         stream.Write((unsigned char)ID_TAG_NULL);
+         return;
+      }
+
+      unsigned char bytes[UNIQUE_ID_BYTE_COUNT];
+      if (UniqueIdToBytes(id, bytes))
+      {
+         stream.Write((unsigned char)ID_TAG_UUID);
+         stream.WriteBinary(reinterpret_cast<const char*>(bytes), UNIQUE_ID_BYTE_COUNT);
+      }
+      else
+      {
+         stream.Write((unsigned char)ID_TAG_STRING);
+         stream.Write(id.ToString());
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool ReadBinaryUniqueId(dtUtil::DataStream& stream, dtCore::UniqueId& idOut)
+   {
+      unsigned char tag = ID_TAG_NULL;
+      stream.Read(tag);
+
+      switch (tag)
+      {
+      case ID_TAG_NULL:
+         idOut = std::string();
+         break;
+      case ID_TAG_UUID:
+      {
+         unsigned char bytes[UNIQUE_ID_BYTE_COUNT];
+         stream.ReadBinary(reinterpret_cast<char*>(bytes), UNIQUE_ID_BYTE_COUNT);
+         UniqueIdFromBytes(bytes, idOut);
+         break;
+      }
+      case ID_TAG_STRING:
+      {
+         std::string text;
+         stream.Read(text);
+         idOut = text;
+         break;
+      }
+      default:
+         return false;
+      }
+      return true;
+   }
+}
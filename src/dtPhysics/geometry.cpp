@@ -29,7 +29,12 @@
 #include <dtPhysics/trianglerecorder.h>
 #include <dtPhysics/convexhull.h>
 #include <dtUtil/exception.h>
+#include <dtUtil/fileutils.h>
+#include <dtUtil/log.h>
 #include <dtUtil/mathdefines.h>
+#include <osg/Timer>
+#include <cstdio>
+#include <sstream>
 
 namespace dtPhysics
 {
@@ -54,6 +59,19 @@ namespace dtPhysics
 
    static MeshCache gMeshCache;
 
+   static std::string gDiskCacheDirectory;
+
+   /// 64 bit FNV-1a so entry names are stable across runs, platforms and processes.
+   static unsigned long long HashForDiskCache(unsigned long long hash, const std::string& str)
+   {
+      for (std::string::const_iterator i = str.begin(), iend = str.end(); i != iend; ++i)
+      {
+         hash ^= static_cast<unsigned char>(*i);
+         hash *= 1099511628211ULL;
+      }
+      return hash;
+   }
+
    /////////////////////////////////////////////////
    VertexData::VertexData()
       : mCurrentScale(Real(1.0), Real(1.0), Real(1.0))
@@ -119,7 +137,8 @@ namespace dtPhysics
 
 
    /////////////////////////////////////////////////
-   void VertexData::GetOrCreateCachedDataForNode(dtCore::RefPtr<VertexData>& dataOut, const osg::Node* nodeToParse, const std::string& cacheKey, bool polytope)
+   void VertexData::GetOrCreateCachedDataForNode(dtCore::RefPtr<VertexData>& dataOut, const osg::Node* nodeToParse, const std::string& cacheKey, bool polytope,
+            const std::string& sourceFile)
    {
       bool newData = false;
       if (cacheKey != NO_CACHE_KEY)
@@ -132,6 +151,12 @@ namespace dtPhysics
          newData = true;
       }
 
+      // Only named data is kept on disk. Unnamed data would never be found again.
+      if (newData && cacheKey != NO_CACHE_KEY && LoadFromDiskCache(*dataOut, cacheKey, sourceFile))
+      {
+         newData = false;
+      }
+
       if (newData)
       {
          TriangleRecorder tr;
@@ -147,7 +172,106 @@ namespace dtPhysics
          {
             dataOut->ConvertToPolytope();
          }
+
+         if (cacheKey != NO_CACHE_KEY)
+         {
+            SaveToDiskCache(*dataOut, cacheKey, sourceFile);
+         }
+      }
+   }
+
+   ////////////////////////////////////////////////////////////
+   void VertexData::SetDiskCacheDirectory(const std::string& dir)
+   {
+      gDiskCacheDirectory = dir;
+      dtUtil::FileUtils::GetInstance().CleanupFileString(gDiskCacheDirectory);
+   }
+
+   ////////////////////////////////////////////////////////////
+   const std::string& VertexData::GetDiskCacheDirectory()
+   {
+      return gDiskCacheDirectory;
+   }
+
+   ////////////////////////////////////////////////////////////
+   std::string VertexData::GetDiskCacheFileName(const std::string& cacheKey, const std::string& sourceFile)
+   {
+      if (gDiskCacheDirectory.empty() || sourceFile.empty())
+      {
+         return std::string();
+      }
+
+      // The size and time stamp are part of the name, so a changed source just misses the cache.
+      dtUtil::FileInfo info = dtUtil::FileUtils::GetInstance().GetFileInfo(sourceFile);
+      if (info.fileType != dtUtil::REGULAR_FILE)
+      {
+         return std::string();
+      }
+
+      std::ostringstream ss;
+      ss << cacheKey << '\n' << info.fileName << '\n' << info.size << '\n' << info.lastModified;
+
+      std::ostringstream fileName;
+      fileName << gDiskCacheDirectory << '/' << std::hex << HashForDiskCache(14695981039346656037ULL, ss.str()) << ".dtphys";
+      return fileName.str();
+   }
+
+   ////////////////////////////////////////////////////////////
+   bool VertexData::LoadFromDiskCache(VertexData& dataOut, const std::string& cacheKey, const std::string& sourceFile)
+   {
+      std::string entry = GetDiskCacheFileName(cacheKey, sourceFile);
+      if (entry.empty() || !dtUtil::FileUtils::GetInstance().FileExists(entry))
+      {
+         return false;
+      }
+
+      dtCore::RefPtr<VertexData> readerData = new VertexData;
+      if (!PhysicsReaderWriter::LoadTriangleDataFile(*readerData, entry) || readerData->mIndices.empty())
+      {
+         LOG_WARNING("Ignoring unreadable physics disk cache entry \"" + entry + "\" for cache key \"" + cacheKey + "\".");
+         return false;
+      }
+
+      dataOut.Swap(*readerData);
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////
+   bool VertexData::SaveToDiskCache(const VertexData& data, const std::string& cacheKey, const std::string& sourceFile)
+   {
+      std::string entry = GetDiskCacheFileName(cacheKey, sourceFile);
+      if (entry.empty())
+      {
+         return false;
+      }
+
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+      try
+      {
+         fileUtils.MakeDirectoryEX(gDiskCacheDirectory);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         ex.LogException(dtUtil::Log::LOG_WARNING);
+         return false;
+      }
+
+      // Write the entry under a name no other process will use, then rename it into place.
+      std::ostringstream tempName;
+      tempName << entry << '.' << std::hex << osg::Timer::instance()->tick() << '_' << reinterpret_cast<size_t>(&data) << ".tmp";
+
+      if (!PhysicsReaderWriter::SaveTriangleDataFile(data, tempName.str()))
+      {
+         return false;
+      }
+
+      if (std::rename(tempName.str().c_str(), entry.c_str()) != 0)
+      {
+         // Another process may have written the same entry first, which is fine.
+         std::remove(tempName.str().c_str());
+         return fileUtils.FileExists(entry);
       }
+      return true;
    }
 
    ////////////////////////////////////////////////////////////
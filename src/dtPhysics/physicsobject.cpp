@@ -566,7 +566,24 @@ namespace dtPhysics
             if (nodeToLoad != nullptr)
             {
                bool polytope = GetPrimitiveType() == PrimitiveType::CONVEX_HULL;
-               VertexData::GetOrCreateCachedDataForNode(data, nodeToLoad, polytope && !cachingKey.empty() ? cachingKey + POLYTOPE_SUFFIX : cachingKey, polytope);
+
+               // The mesh file is only needed to validate disk cache entries, so don't look it up otherwise.
+               std::string sourceFile;
+               if (!cachingKey.empty() && !VertexData::GetDiskCacheDirectory().empty()
+                        && GetMeshResource() != dtCore::ResourceDescriptor::NULL_RESOURCE)
+               {
+                  try
+                  {
+                     sourceFile = dtCore::Project::GetInstance().GetResourcePath(GetMeshResource());
+                  }
+                  catch (const dtUtil::Exception&)
+                  {
+                     // Without a source file the data is just not cached on disk.
+                  }
+               }
+
+               VertexData::GetOrCreateCachedDataForNode(data, nodeToLoad, polytope && !cachingKey.empty() ? cachingKey + POLYTOPE_SUFFIX : cachingKey, polytope,
+                        sourceFile);
             }
             else
             {
@@ -593,22 +610,21 @@ namespace dtPhysics
 
       std::string fileToLoad;
 
-      bool dataNew = true;
-      if (cachingKey != VertexData::NO_CACHE_KEY)
-      {
-         dataNew = VertexData::GetOrCreateCachedData(vertDataOut, polytope ? cachingKey + POLYTOPE_SUFFIX : cachingKey );
-      }
-      else
+      std::string key = cachingKey != VertexData::NO_CACHE_KEY ? cachingKey : GetMeshResource().GetResourceIdentifier();
+      if (polytope)
       {
-         dataNew = VertexData::GetOrCreateCachedData(vertDataOut, polytope ? GetMeshResource().GetResourceIdentifier() + POLYTOPE_SUFFIX : GetMeshResource().GetResourceIdentifier() );
+         key += POLYTOPE_SUFFIX;
       }
 
+      bool dataNew = VertexData::GetOrCreateCachedData(vertDataOut, key);
+
       if (dataNew)
       {
          // throw the exception
          fileToLoad = dtCore::Project::GetInstance().GetResourcePath(GetMeshResource());
 
-         if (!fileToLoad.empty())
+         // The disk cache holds data cooked by an earlier run or another process.
+         if (!fileToLoad.empty() && !VertexData::LoadFromDiskCache(*vertDataOut, key, fileToLoad))
          {
             dtCore::RefPtr<VertexData> readerData = new VertexData;
 
@@ -622,6 +638,7 @@ namespace dtPhysics
                {
                   vertDataOut->ConvertToPolytope();
                }
+               VertexData::SaveToDiskCache(*vertDataOut, key, fileToLoad);
             }
             else
             {
@@ -180,7 +180,12 @@ namespace dtUtil
    ////////////////////////////////////////////////////////////////////
    void DateTime::SetToLocalTime()
    {
-      time_t t = time(NULL);
+      SetToLocalTime(time(NULL));
+   }
+
+   ////////////////////////////////////////////////////////////////////
+   void DateTime::SetToLocalTime(time_t t)
+   {
       struct tm timeParts;
       GetLocalTime(&t, timeParts);
       SetTime(timeParts);
@@ -32,11 +32,15 @@
 
 
 
+#include <OpenThreads/Atomic>
 #include <OpenThreads/Mutex>
 #include <OpenThreads/ScopedLock>
+#include <OpenThreads/Thread>
 
 #include <algorithm>
 #include <cstdarg>
+#include <ctime>
+#include <sstream>
 //#include <cstdio>
 #include <dtUtil/hashmap.h>
 
@@ -57,10 +61,186 @@ namespace dtUtil
    static Log::LogMessageType DEFAULT_LOG_LEVEL(Log::LOG_WARNING);
 
 
+   //////////////////////////////////////////////////////////////////////////
+   class LogImpl //: std::stringbuf
+   {
+   public:
+      LogImpl(const std::string& name)
+      : mOutputStreamBit(Log::STANDARD)
+      , mName(name)
+      , mLevel(DEFAULT_LOG_LEVEL)
+      , mObservers()
+      {
+      }
+
+      unsigned int mOutputStreamBit; ///<the current output stream option
+      std::string mName;
+      Log::LogMessageType mLevel;
+      Log::LogObserverContainer mObservers;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   /**
+    * A message copied by the thread that logged it.  The time conversion and the file name are left for the
+    * drain thread.  The slots are reused, so the strings keep their capacity and copying rarely allocates.
+    * The drain thread frees the strings of a slot that holds more than MAX_RETAINED_BYTES, so one long message
+    * doesn't keep its memory for the life of the queue.
+    */
+   struct QueuedLogMessage
+   {
+      QueuedLogMessage()
+      : mLog(NULL)
+      , mType(Log::LOG_DEBUG)
+      , mOutputStreamBit(0)
+      , mLine(0)
+      , mFrameNumber(0)
+      , mHasLogTime(false)
+      , mRawTime(0)
+      , mSize(0)
+      {
+      }
+
+      static const unsigned MAX_RETAINED_BYTES = 256;
+
+      /// @return the memory held by the slot, which is what counts against the budget.
+      unsigned GetMemoryUsed() const
+      {
+         return unsigned(sizeof(QueuedLogMessage) + mFile.capacity() + mMethod.capacity() + mMsg.capacity());
+      }
+
+      /// Frees the strings if they hold more than MAX_RETAINED_BYTES.
+      void TrimStrings()
+      {
+         if (GetMemoryUsed() - sizeof(QueuedLogMessage) > MAX_RETAINED_BYTES)
+         {
+            std::string().swap(mFile);
+            std::string().swap(mMethod);
+            std::string().swap(mMsg);
+         }
+      }
+
+      const Log* mLog;
+      Log::LogMessageType mType;
+      unsigned int mOutputStreamBit;
+      int mLine;
+      unsigned mFrameNumber;
+      /// true if mTime came from the log time provider, otherwise mRawTime is converted to local time.
+      bool mHasLogTime;
+      DateTime mTime;
+      time_t mRawTime;
+      std::string mFile;
+      std::string mMethod;
+      std::string mMsg;
+      unsigned mSize;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   /**
+    * A ring of messages filled by one logging thread and emptied by the drain thread.  Neither side locks.
+    * The counts only ever increase, and the increments are full barriers, so a slot is written before the
+    * other side sees the count that covers it.
+    */
+   class LogQueue : public osg::Referenced
+   {
+   public:
+      static const unsigned NUM_SLOTS = 1024;
+
+      LogQueue()
+      : mInUse(1U)
+      , mSlots(NUM_SLOTS)
+      , mWriteCount(0U)
+      , mReadCount(0U)
+      , mBytesPushed(0U)
+      , mBytesPopped(0U)
+      {
+      }
+
+      /// Called by the owning thread.  @return the slot to fill, or NULL if the queue is full.
+      QueuedLogMessage* GetFreeSlot()
+      {
+         const unsigned writeCount = mWriteCount;
+         if (writeCount - unsigned(mReadCount) >= NUM_SLOTS)
+         {
+            return NULL;
+         }
+         return &mSlots[writeCount & (NUM_SLOTS - 1)];
+      }
+
+      /// Called by the owning thread after filling the slot from GetFreeSlot.
+      void Push()
+      {
+         const QueuedLogMessage& msg = mSlots[unsigned(mWriteCount) & (NUM_SLOTS - 1)];
+         // Only this thread changes the pushed count, so the exchange is just a store.
+         mBytesPushed.exchange(unsigned(mBytesPushed) + msg.mSize);
+         ++mWriteCount;
+      }
+
+      /// Called by the drain thread.  @return the oldest message, or NULL if the queue is empty.
+      QueuedLogMessage* GetFront()
+      {
+         const unsigned readCount = mReadCount;
+         if (readCount == unsigned(mWriteCount))
+         {
+            return NULL;
+         }
+         return &mSlots[readCount & (NUM_SLOTS - 1)];
+      }
+
+      /// Called by the drain thread after sending the message from GetFront.
+      void Pop()
+      {
+         const QueuedLogMessage& msg = mSlots[unsigned(mReadCount) & (NUM_SLOTS - 1)];
+         mBytesPopped.exchange(unsigned(mBytesPopped) + msg.mSize);
+         ++mReadCount;
+      }
+
+      unsigned GetQueuedBytes() const
+      {
+         // Popped is read first, so it can't include bytes pushed after the pushed count was read.
+         const unsigned popped = mBytesPopped;
+         return unsigned(mBytesPushed) - popped;
+      }
+
+      unsigned GetWriteCount() const { return mWriteCount; }
+      unsigned GetReadCount() const { return mReadCount; }
+
+      /// 1 while a thread owns the queue.  A queue whose thread exited is handed to the next new thread.
+      OpenThreads::Atomic mInUse;
+
+   private:
+      std::vector<QueuedLogMessage> mSlots;
+      OpenThreads::Atomic mWriteCount;
+      OpenThreads::Atomic mReadCount;
+      OpenThreads::Atomic mBytesPushed;
+      OpenThreads::Atomic mBytesPopped;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   /// Gives the queue back when its thread exits.
+   class ThreadLogQueueHolder
+   {
+   public:
+      ~ThreadLogQueueHolder()
+      {
+         if (mQueue.valid())
+         {
+            mQueue->mInUse.exchange(0U);
+         }
+      }
+
+      osg::ref_ptr<LogQueue> mQueue;
+   };
+
+   static thread_local ThreadLogQueueHolder sThreadLogQueue;
+
+   class LogDrainThread;
+
    //////////////////////////////////////////////////////////////////////////
    class LogManager: public osg::Referenced
    {
    public:
+      static const unsigned MAX_LOG_QUEUES = 256;
+
       osg::ref_ptr<LogObserver> mLogObserverConsole; ///writes to console
       osg::ref_ptr<LogObserverFile> mLogObserverFile; ///writes to file
       osg::observer_ptr<osg::Referenced> mLogTimeProviderAsRef;
@@ -71,16 +251,18 @@ namespace dtUtil
       : mLogObserverConsole(new LogObserverConsole())
       , mLogObserverFile(new LogObserverFile())
       , mLogTimeProvider(NULL)
+      , mNumQueues(0U)
+      , mAsync(0U)
+      , mAsyncMemoryBudget(4U * 1024U * 1024U)
+      , mNumDropped(0U)
+      , mNumDroppedReported(0U)
+      , mNumEnqueuing(0U)
+      , mDrainThread(NULL)
       {
       }
 
       ////////////////////////////////////////////////////////////////
-      ~LogManager()
-      {
-         mInstances.clear();
-         mLogObserverConsole = NULL;
-         mLogObserverFile = NULL;
-      }
+      ~LogManager();
 
       ////////////////////////////////////////////////////////////////
       bool AddInstance(const std::string& name, Log* log)
@@ -125,11 +307,375 @@ namespace dtUtil
     	  return mLogTimeProviderAsRef.valid() && mLogTimeProvider != NULL;
       }
 
+      ////////////////////////////////////////////////////////////////
+      /// Calls the observers selected by the output bits.  The caller holds mMutex.
+      void SendToObservers(const LogImpl& impl, unsigned int outputStreamBit, const LogObserver::LogData& logData)
+      {
+         if (dtUtil::Bits::Has(outputStreamBit, Log::TO_FILE))
+         {
+            mLogObserverFile->LogMessage(logData);
+         }
+
+         if (dtUtil::Bits::Has(outputStreamBit, Log::TO_CONSOLE))
+         {
+            mLogObserverConsole->LogMessage(logData);
+         }
+
+         if (dtUtil::Bits::Has(outputStreamBit, Log::TO_OBSERVER) && !impl.mObservers.empty())
+         {
+            Log::LogObserverContainer::const_iterator itr = impl.mObservers.begin();
+            while (itr != impl.mObservers.end())
+            {
+               (*itr)->LogMessage(logData);
+               ++itr;
+            }
+         }
+      }
+
+      bool IsAsynchronous() const
+      {
+         return unsigned(mAsync) != 0U;
+      }
+
+      void SetAsynchronous(bool async);
+
+      ////////////////////////////////////////////////////////////////
+      /**
+       * Copies a message into the calling thread's queue, or drops it if the queue is full or the memory budget is
+       * used up.
+       * @return false if the thread has no queue because there are too many threads, so the message should be
+       *         logged right away.
+       */
+      bool Enqueue(const Log& log, const std::string& file, const std::string& method, int line,
+               const std::string& msg, Log::LogMessageType msgType)
+      {
+         // Counted before checking the flag, so SetAsynchronous(false) either makes this log right away or
+         // waits for the message to be queued before writing out the queues.
+         ++mNumEnqueuing;
+         if (!IsAsynchronous())
+         {
+            --mNumEnqueuing;
+            return false;
+         }
+
+         LogQueue* queue = GetThreadQueue();
+         if (queue == NULL)
+         {
+            --mNumEnqueuing;
+            return false;
+         }
+
+         // The strings may be bigger once copied, so the size is counted again below.
+         const unsigned size = unsigned(sizeof(QueuedLogMessage) + file.size() + method.size() + msg.size());
+         QueuedLogMessage* entry = queue->GetFreeSlot();
+         if (entry == NULL || GetQueuedBytes() + size > unsigned(mAsyncMemoryBudget))
+         {
+            ++mNumDropped;
+            --mNumEnqueuing;
+            return true;
+         }
+
+         entry->mLog = &log;
+         entry->mType = msgType;
+         entry->mOutputStreamBit = log.mImpl->mOutputStreamBit;
+         entry->mLine = line;
+         entry->mHasLogTime = IsLogTimeProviderValid();
+         if (entry->mHasLogTime)
+         {
+            entry->mFrameNumber = mLogTimeProvider->GetFrameNumber();
+            entry->mTime = mLogTimeProvider->GetDateTime();
+         }
+         else
+         {
+            entry->mFrameNumber = 0;
+            entry->mRawTime = time(NULL);
+         }
+         entry->mFile = file;
+         entry->mMethod = method;
+         entry->mMsg = msg;
+         entry->mSize = entry->GetMemoryUsed();
+         queue->Push();
+         --mNumEnqueuing;
+         return true;
+      }
+
+      ////////////////////////////////////////////////////////////////
+      /**
+       * Sends every queued message to the observers.  Each queue is emptied while holding mMutex, so the thread
+       * that stopped a drain thread can finish the queues even if a new drain thread has already started.
+       */
+      unsigned DrainQueues()
+      {
+         unsigned numSent = 0;
+         const unsigned numQueues = mNumQueues;
+         for (unsigned i = 0; i < numQueues; ++i)
+         {
+            LogQueue& queue = *mQueues[i];
+            if (queue.GetFront() == NULL)
+            {
+               continue;
+            }
+
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            QueuedLogMessage* entry = NULL;
+            while ((entry = queue.GetFront()) != NULL)
+            {
+               LogObserver::LogData logData;
+               if (entry->mHasLogTime)
+               {
+                  logData.frameNumber = entry->mFrameNumber;
+                  logData.time = entry->mTime;
+               }
+               else
+               {
+                  logData.time.SetToLocalTime(entry->mRawTime);
+               }
+
+               logData.type = entry->mType;
+               logData.logName = entry->mLog->mImpl->mName;
+               logData.file = osgDB::getSimpleFileName(entry->mFile);
+               logData.method = entry->mMethod;
+               logData.line = entry->mLine;
+               logData.msg = entry->mMsg;
+               SendToObservers(*entry->mLog->mImpl, entry->mOutputStreamBit, logData);
+
+               entry->TrimStrings();
+               queue.Pop();
+               ++numSent;
+            }
+         }
+
+         ReportDroppedMessages();
+         return numSent;
+      }
+
+      void FlushAsynchronous();
+
+      unsigned GetAsyncMemoryBudget() const
+      {
+         return mAsyncMemoryBudget;
+      }
+
+      void SetAsyncMemoryBudget(unsigned bytes)
+      {
+         mAsyncMemoryBudget.exchange(bytes);
+      }
+
+      unsigned GetNumDroppedMessages() const
+      {
+         return mNumDropped;
+      }
+
       OpenThreads::Mutex mMutex;
    private:
+      ////////////////////////////////////////////////////////////////
+      /// @return the calling thread's queue, creating or reusing one the first time, or NULL if there are too many.
+      LogQueue* GetThreadQueue()
+      {
+         if (!sThreadLogQueue.mQueue.valid())
+         {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mQueueMutex);
+            const unsigned numQueues = mNumQueues;
+            for (unsigned i = 0; i < numQueues && !sThreadLogQueue.mQueue.valid(); ++i)
+            {
+               if (unsigned(mQueues[i]->mInUse) == 0U)
+               {
+                  mQueues[i]->mInUse.exchange(1U);
+                  sThreadLogQueue.mQueue = mQueues[i];
+               }
+            }
+
+            if (!sThreadLogQueue.mQueue.valid() && numQueues < MAX_LOG_QUEUES)
+            {
+               sThreadLogQueue.mQueue = new LogQueue();
+               mQueues[numQueues] = sThreadLogQueue.mQueue;
+               // The increment publishes the new queue to the drain thread.
+               ++mNumQueues;
+            }
+         }
+         return sThreadLogQueue.mQueue.get();
+      }
+
+      ////////////////////////////////////////////////////////////////
+      unsigned GetQueuedBytes() const
+      {
+         unsigned queuedBytes = 0;
+         const unsigned numQueues = mNumQueues;
+         for (unsigned i = 0; i < numQueues; ++i)
+         {
+            queuedBytes += mQueues[i]->GetQueuedBytes();
+         }
+         return queuedBytes;
+      }
+
+      ////////////////////////////////////////////////////////////////
+      /// Writes how many messages were dropped since the last report to the file and console.
+      void ReportDroppedMessages()
+      {
+         // Runs on every pass of the drain thread, so only lock if something was dropped.
+         const unsigned numDropped = mNumDropped;
+         if (numDropped == unsigned(mNumDroppedReported))
+         {
+            return;
+         }
+
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+         const unsigned numReported = mNumDroppedReported;
+         if (numDropped == numReported)
+         {
+            return;
+         }
+
+         std::ostringstream ss;
+         ss << (numDropped - numReported) << " log messages were dropped because the asynchronous log "
+            << "queues were full or over their memory budget.";
+         mNumDroppedReported.exchange(numDropped);
+
+         LogObserver::LogData logData;
+         logData.time.SetToLocalTime();
+         logData.type = Log::LOG_WARNING;
+         logData.method = "ReportDroppedMessages";
+         logData.msg = ss.str();
+
+         mLogObserverFile->LogMessage(logData);
+         mLogObserverConsole->LogMessage(logData);
+      }
+
       dtUtil::HashMap<std::string, osg::ref_ptr<Log> > mInstances;
+
+      /// Queues are only added, and a queue is published by incrementing mNumQueues, so the drain thread doesn't lock.
+      osg::ref_ptr<LogQueue> mQueues[MAX_LOG_QUEUES];
+      OpenThreads::Atomic mNumQueues;
+      /// Guards adding queues, and starting and stopping the drain thread.
+      OpenThreads::Mutex mQueueMutex;
+
+      OpenThreads::Atomic mAsync;
+      OpenThreads::Atomic mAsyncMemoryBudget;
+      OpenThreads::Atomic mNumDropped;
+      OpenThreads::Atomic mNumDroppedReported;
+      /// The number of threads between checking IsAsynchronous and queueing their message.
+      OpenThreads::Atomic mNumEnqueuing;
+      LogDrainThread* mDrainThread;
+   };
+
+   //////////////////////////////////////////////////////////////////////////
+   /// Empties the log queues and calls the observers for asynchronous logging.
+   class LogDrainThread : public OpenThreads::Thread
+   {
+   public:
+      LogDrainThread(LogManager& manager)
+      : mManager(manager)
+      , mStopRequested(0U)
+      {
+      }
+
+      virtual void run()
+      {
+         while (true)
+         {
+            if (mManager.DrainQueues() == 0)
+            {
+               if (unsigned(mStopRequested) != 0U)
+               {
+                  break;
+               }
+               microSleep(1000);
+            }
+         }
+      }
+
+      /// Ends the thread once the queues are empty and waits for it to exit.
+      void Stop()
+      {
+         mStopRequested.exchange(1U);
+         join();
+      }
+
+   private:
+      LogManager& mManager;
+      OpenThreads::Atomic mStopRequested;
    };
 
+   ////////////////////////////////////////////////////////////////
+   LogManager::~LogManager()
+   {
+      SetAsynchronous(false);
+      mInstances.clear();
+      mLogObserverConsole = NULL;
+      mLogObserverFile = NULL;
+   }
+
+   ////////////////////////////////////////////////////////////////
+   void LogManager::SetAsynchronous(bool async)
+   {
+      LogDrainThread* stoppedThread = NULL;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mQueueMutex);
+         if (async && mDrainThread == NULL)
+         {
+            mDrainThread = new LogDrainThread(*this);
+            if (mDrainThread->start() != 0)
+            {
+               delete mDrainThread;
+               mDrainThread = NULL;
+               return;
+            }
+            mAsync.exchange(1U);
+         }
+         else if (!async && mDrainThread != NULL)
+         {
+            mAsync.exchange(0U);
+            stoppedThread = mDrainThread;
+            mDrainThread = NULL;
+         }
+      }
+
+      // Joined outside the lock, since an observer on the drain thread may be logging and need a queue.
+      if (stoppedThread != NULL)
+      {
+         stoppedThread->Stop();
+         delete stoppedThread;
+
+         // Threads that saw the flag before it was turned off may still be queueing.  New ones log right away.
+         while (unsigned(mNumEnqueuing) != 0U)
+         {
+            OpenThreads::Thread::YieldCurrentThread();
+         }
+
+         // Anything queued between the last pass of the thread and turning off the flag.
+         DrainQueues();
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////
+   void LogManager::FlushAsynchronous()
+   {
+      unsigned numQueues = 0;
+      unsigned writeCounts[MAX_LOG_QUEUES];
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mQueueMutex);
+         if (mDrainThread == NULL)
+         {
+            return;
+         }
+
+         numQueues = mNumQueues;
+         for (unsigned i = 0; i < numQueues; ++i)
+         {
+            writeCounts[i] = mQueues[i]->GetWriteCount();
+         }
+      }
+
+      for (unsigned i = 0; i < numQueues; ++i)
+      {
+         // The counts wrap, so compare the difference.
+         while (int(writeCounts[i] - mQueues[i]->GetReadCount()) > 0 && IsAsynchronous())
+         {
+            OpenThreads::Thread::microSleep(100);
+         }
+      }
+   }
+
    ////////////////////////////////////////////////////////////////////
    ////////////////////////////////////////////////////////////////////
    const std::string LogFile::LOG_DEFAULT_NAME("");
@@ -171,24 +717,6 @@ namespace dtUtil
       return sTitle;
    }
 
-   //////////////////////////////////////////////////////////////////////////
-   //////////////////////////////////////////////////////////////////////////
-   class LogImpl //: std::stringbuf
-   {
-   public:
-      LogImpl(const std::string& name)
-      : mOutputStreamBit(Log::STANDARD)
-      , mName(name)
-      , mLevel(DEFAULT_LOG_LEVEL)
-      , mObservers()
-      {
-      }
-
-      unsigned int mOutputStreamBit; ///<the current output stream option
-      std::string mName;
-      Log::LogMessageType mLevel;
-      Log::LogObserverContainer mObservers;
-   };
 //   /** Stream buffer calling notify handler when buffer is synchronized (usually on std::endl).
 //    * Stream stores last notification severity to pass it to handler call.
 //    */
@@ -259,6 +787,10 @@ namespace dtUtil
          return;
       }
 
+      if (LOG_MANAGER->IsAsynchronous() && LOG_MANAGER->Enqueue(*this, file, method, line, msg, msgType))
+      {
+         return;
+      }
 
       OpenThreads::ScopedLock<OpenThreads::Mutex> lock(LOG_MANAGER->mMutex);
       bool hasLogTimeProvider = LOG_MANAGER->IsLogTimeProviderValid();
@@ -281,26 +813,7 @@ namespace dtUtil
       logData.line = line;
       logData.msg = msg;
 
-
-      if (dtUtil::Bits::Has(mImpl->mOutputStreamBit, Log::TO_FILE))
-      {
-         LOG_MANAGER->mLogObserverFile->LogMessage(logData);
-      }
-
-      if (dtUtil::Bits::Has(mImpl->mOutputStreamBit, Log::TO_CONSOLE))
-      {
-         LOG_MANAGER->mLogObserverConsole->LogMessage(logData);
-      }
-
-      if (dtUtil::Bits::Has(mImpl->mOutputStreamBit, Log::TO_OBSERVER) && !mImpl->mObservers.empty())
-      {
-         Log::LogObserverContainer::iterator itr = mImpl->mObservers.begin();
-         while (itr != mImpl->mObservers.end())
-         {
-            (*itr)->LogMessage(logData);
-            ++itr;
-         }
-      }
+      LOG_MANAGER->SendToObservers(*mImpl, mImpl->mOutputStreamBit, logData);
    }
 
    //////////////////////////////////////////////////////////////////////////
@@ -355,6 +868,9 @@ namespace dtUtil
 
       if (dtUtil::Bits::Has(mImpl->mOutputStreamBit, Log::TO_FILE))
       {
+         // Keep the rule after the messages logged before it.
+         LOG_MANAGER->FlushAsynchronous();
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(LOG_MANAGER->mMutex);
          LOG_MANAGER->mLogObserverFile->LogHorizRule();
       }
    }
@@ -508,9 +1024,62 @@ namespace dtUtil
 	  }
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   void Log::SetAsynchronous(bool async)
+   {
+      if (LOG_MANAGER == NULL)
+      {
+         LOG_MANAGER = new LogManager;
+      }
+      LOG_MANAGER->SetAsynchronous(async);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   bool Log::IsAsynchronous()
+   {
+      return LOG_MANAGER.valid() && LOG_MANAGER->IsAsynchronous();
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void Log::SetAsyncMemoryBudget(unsigned bytes)
+   {
+      if (LOG_MANAGER == NULL)
+      {
+         LOG_MANAGER = new LogManager;
+      }
+      LOG_MANAGER->SetAsyncMemoryBudget(bytes);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned Log::GetAsyncMemoryBudget()
+   {
+      if (LOG_MANAGER == NULL)
+      {
+         LOG_MANAGER = new LogManager;
+      }
+      return LOG_MANAGER->GetAsyncMemoryBudget();
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   unsigned Log::GetNumDroppedMessages()
+   {
+      return LOG_MANAGER.valid() ? LOG_MANAGER->GetNumDroppedMessages() : 0U;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   void Log::FlushAsynchronous()
+   {
+      if (LOG_MANAGER.valid())
+      {
+         LOG_MANAGER->FlushAsynchronous();
+      }
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    void Log::AddObserver(LogObserver& observer)
    {
+      // The drain thread reads the observers while asynchronous logging is on.
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(LOG_MANAGER->mMutex);
       mImpl->mObservers.push_back(&observer);
    }
 
@@ -529,6 +1098,7 @@ namespace dtUtil
    ////////////////////////////////////////////////////////////////////////////////
    void Log::RemoveObserver(LogObserver& observer)
    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(LOG_MANAGER->mMutex);
       LogObserverContainer::iterator found = std::find(mImpl->mObservers.begin(),
                                                        mImpl->mObservers.end(), &observer);
       if (found != mImpl->mObservers.end())
@@ -0,0 +1,183 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include <prefix/dtutilprefix.h>
+#include <dtUtil/mswinmacros.h>
+#include <dtUtil/mappedfile.h>
+#include <dtUtil/log.h>
+
+#ifdef DELTA_WIN32
+#   include <dtUtil/mswin.h>
+#else
+#   include <sys/types.h>
+#   include <sys/stat.h>
+#   include <sys/mman.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+namespace dtUtil
+{
+   /////////////////////////////////////////////////////////////////////////////
+   MappedFile::MappedFile()
+      : mData(NULL)
+      , mSize(0)
+      , mFileHandle(NULL)
+      , mMappingHandle(NULL)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   MappedFile::~MappedFile()
+   {
+      Close();
+   }
+
+#ifdef DELTA_WIN32
+   /////////////////////////////////////////////////////////////////////////////
+   bool MappedFile::Open(const std::string& fileName)
+   {
+      Close();
+
+      HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+      if (file == INVALID_HANDLE_VALUE)
+      {
+         LOG_WARNING("Unable to open file \"" + fileName + "\" for mapping.");
+         return false;
+      }
+
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+      {
+         CloseHandle(file);
+         return false;
+      }
+
+      HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      if (mapping == NULL)
+      {
+         LOG_WARNING("Unable to create a file mapping for \"" + fileName + "\".");
+         CloseHandle(file);
+         return false;
+      }
+
+      const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      if (data == NULL)
+      {
+         LOG_WARNING("Unable to map a view of \"" + fileName + "\".");
+         CloseHandle(mapping);
+         CloseHandle(file);
+         return false;
+      }
+
+      mFileName = fileName;
+      mData = static_cast<const char*>(data);
+      mSize = size_t(size.QuadPart);
+      mFileHandle = file;
+      mMappingHandle = mapping;
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MappedFile::Close()
+   {
+      if (mData != NULL)
+      {
+         UnmapViewOfFile(mData);
+         CloseHandle(HANDLE(mMappingHandle));
+         CloseHandle(HANDLE(mFileHandle));
+      }
+      mData = NULL;
+      mSize = 0;
+      mFileHandle = NULL;
+      mMappingHandle = NULL;
+      mFileName.clear();
+   }
+
+#else
+   /////////////////////////////////////////////////////////////////////////////
+   bool MappedFile::Open(const std::string& fileName)
+   {
+      Close();
+
+      int fd = open(fileName.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+         LOG_WARNING("Unable to open file \"" + fileName + "\" for mapping.");
+         return false;
+      }
+
+      struct stat fileStat;
+      if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+      {
+         close(fd);
+         return false;
+      }
+
+      void* data = mmap(NULL, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      // The mapping holds its own reference to the file.
+      close(fd);
+      if (data == MAP_FAILED)
+      {
+         LOG_WARNING("Unable to map \"" + fileName + "\".");
+         return false;
+      }
+
+      mFileName = fileName;
+      mData = static_cast<const char*>(data);
+      mSize = size_t(fileStat.st_size);
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void MappedFile::Close()
+   {
+      if (mData != NULL)
+      {
+         munmap(const_cast<char*>(mData), mSize);
+      }
+      mData = NULL;
+      mSize = 0;
+      mFileName.clear();
+   }
+#endif
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool MappedFile::IsOpen() const
+   {
+      return mData != NULL;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const char* MappedFile::GetData() const
+   {
+      return mData;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   size_t MappedFile::GetSize() const
+   {
+      return mSize;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   const std::string& MappedFile::GetFileName() const
+   {
+      return mFileName;
+   }
+}
@@ -0,0 +1,619 @@
+/*
+ * Delta3D Open Source Game and Simulation Engine
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <prefix/dtutilprefix.h>
+#include <dtUtil/recordingfile.h>
+#include <dtUtil/log.h>
+#include <dtUtil/mappedfile.h>
+#include <dtUtil/mathdefines.h>
+#include <dtUtil/stringutils.h>
+#include <osg/Endian>
+
+#include <algorithm>
+#include <cstring>
+
+namespace dtUtil
+{
+   namespace RecordingFileConstants
+   {
+      const char MAGIC[8] = { 'D', 'T', 'R', 'E', 'C', 'B', 'I', 'N' };
+      const char INDEX_MAGIC[8] = { 'D', 'T', 'R', 'E', 'C', 'I', 'D', 'X' };
+      const unsigned VERSION = 1;
+   }
+
+   // magic, version, number of sources
+   static const unsigned FILE_HEADER_SIZE = 8 + 4 + 4;
+   // frame count, first time, last time, decoded size, stored size
+   static const unsigned CHUNK_HEADER_SIZE = 4 + 8 + 8 + 4 + 4;
+   // offset, first time, last time, frame count
+   static const unsigned INDEX_ENTRY_SIZE = 8 + 8 + 8 + 4;
+   // index offset, index magic
+   static const unsigned FOOTER_SIZE = 8 + 8;
+   // time, size, encoded size
+   static const unsigned FRAME_HEADER_SIZE = 8 + 4 + 4;
+
+   /// The high bit of a control byte marks a run of zeros, otherwise it is followed by literal bytes.
+   static const unsigned char ZERO_RUN_FLAG = 0x80;
+   static const unsigned MAX_RUN = 128;
+
+   /////////////////////////////////////////////////////////////////////////////
+   /**
+    * Reads a little endian value at any offset in the mapped file.  DataStream only takes 32 bit sizes
+    * and positions, so it is used only for the chunk contents, which are always smaller than that.
+    */
+   template <typename T>
+   static T ReadLittleEndian(const char* data, size_t offset)
+   {
+      T value;
+      memcpy(&value, data + offset, sizeof(T));
+      if (osg::getCpuByteOrder() != osg::LittleEndian)
+      {
+         osg::swapBytes(reinterpret_cast<char*>(&value), sizeof(T));
+      }
+      return value;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   // The chunk is written a frame at a time, and WriteBinary only grows the buffer by what it needs.
+   static void ReserveForWrite(dtUtil::DataStream& stream, unsigned size)
+   {
+      unsigned available = stream.GetBufferCapacity() - stream.GetWritePosition();
+      if (available < size)
+      {
+         stream.IncreaseBufferSize(dtUtil::Max(size - available, stream.GetBufferCapacity()));
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   static void EncodeZeroRuns(const char* data, unsigned size, std::vector<char>& out)
+   {
+      out.clear();
+      unsigned i = 0;
+      while (i < size)
+      {
+         if (data[i] == 0)
+         {
+            unsigned run = 1;
+            while (i + run < size && run < MAX_RUN && data[i + run] == 0)
+            {
+               ++run;
+            }
+            out.push_back(char(ZERO_RUN_FLAG | (run - 1)));
+            i += run;
+         }
+         else
+         {
+            // A single zero is cheaper to keep in the literal than to split it.
+            const unsigned start = i;
+            while (i < size && i - start < MAX_RUN && !(data[i] == 0 && (i + 1 >= size || data[i + 1] == 0)))
+            {
+               ++i;
+            }
+            out.push_back(char(i - start - 1));
+            out.insert(out.end(), data + start, data + i);
+         }
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   static bool DecodeZeroRuns(const char* in, unsigned inSize, char* out, unsigned outSize)
+   {
+      unsigned i = 0, o = 0;
+      while (i < inSize)
+      {
+         const unsigned char control = static_cast<unsigned char>(in[i++]);
+         const unsigned run = (control & ~ZERO_RUN_FLAG) + 1;
+         if (o + run > outSize)
+         {
+            return false;
+         }
+
+         if ((control & ZERO_RUN_FLAG) != 0)
+         {
+            memset(out + o, 0, run);
+         }
+         else
+         {
+            if (i + run > inSize)
+            {
+               return false;
+            }
+            memcpy(out + o, in + i, run);
+            i += run;
+         }
+         o += run;
+      }
+      return o == outSize;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   RecordingFileWriter::RecordingFileWriter()
+      : mFileOffset(0)
+      , mCurrentChunkRawSize(0)
+      , mFramesPerChunk(DEFAULT_FRAMES_PER_CHUNK)
+      , mNumFrames(0)
+   {
+      mChunkData.SetForceLittleEndian(true);
+      memset(&mCurrentChunk, 0, sizeof(mCurrentChunk));
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   RecordingFileWriter::~RecordingFileWriter()
+   {
+      Close();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RecordingFileWriter::Open(const std::string& fileName, unsigned numSources)
+   {
+      Close();
+
+      mStream.open(fileName.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+      if (!mStream.is_open())
+      {
+         LOG_ERROR("Unable to open recording file \"" + fileName + "\" for writing.");
+         return false;
+      }
+
+      dtUtil::DataStream header;
+      header.SetForceLittleEndian(true);
+      header.WriteBinary(RecordingFileConstants::MAGIC, sizeof(RecordingFileConstants::MAGIC));
+      header << RecordingFileConstants::VERSION;
+      header << numSources;
+      mStream.write(header.GetBuffer(), header.GetBufferSize());
+
+      mFileOffset = header.GetBufferSize();
+      mChunks.clear();
+      mNumFrames = 0;
+      mCurrentChunk.mNumFrames = 0;
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RecordingFileWriter::Close()
+   {
+      if (mStream.is_open())
+      {
+         Flush();
+         WriteIndex();
+         mStream.close();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RecordingFileWriter::IsOpen() const
+   {
+      return mStream.is_open();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RecordingFileWriter::WriteFrame(double time, const char* data, unsigned size)
+   {
+      if (!mStream.is_open())
+      {
+         LOG_ERROR("Unable to write a frame because no recording file is open.");
+         return;
+      }
+
+      if (mCurrentChunk.mNumFrames == 0)
+      {
+         mChunkData.ClearBuffer();
+         mCurrentChunkRawSize = 0;
+         mPreviousFrame.clear();
+         mCurrentChunk.mFirstTime = time;
+      }
+
+      mDelta.resize(size);
+      for (unsigned i = 0; i < size; ++i)
+      {
+         mDelta[i] = (i < mPreviousFrame.size()) ? char(data[i] ^ mPreviousFrame[i]) : data[i];
+      }
+      EncodeZeroRuns(mDelta.empty() ? NULL : &mDelta[0], size, mEncoded);
+
+      const unsigned encodedSize = unsigned(mEncoded.size());
+      ReserveForWrite(mChunkData, FRAME_HEADER_SIZE + encodedSize);
+      mChunkData << time;
+      mChunkData << size;
+      mChunkData << encodedSize;
+      if (encodedSize > 0)
+      {
+         mChunkData.WriteBinary(&mEncoded[0], encodedSize);
+      }
+
+      mPreviousFrame.assign(data, data + size);
+      mCurrentChunkRawSize += size;
+      mCurrentChunk.mLastTime = time;
+      ++mCurrentChunk.mNumFrames;
+      ++mNumFrames;
+
+      if (mCurrentChunk.mNumFrames >= mFramesPerChunk)
+      {
+         Flush();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RecordingFileWriter::Flush()
+   {
+      if (!mStream.is_open() || mCurrentChunk.mNumFrames == 0)
+      {
+         return;
+      }
+
+      dtUtil::DataStream header;
+      header.SetForceLittleEndian(true);
+      header << mCurrentChunk.mNumFrames;
+      header << mCurrentChunk.mFirstTime;
+      header << mCurrentChunk.mLastTime;
+      header << mCurrentChunkRawSize;
+      header << mChunkData.GetBufferSize();
+
+      mStream.write(header.GetBuffer(), header.GetBufferSize());
+      mStream.write(mChunkData.GetBuffer(), mChunkData.GetBufferSize());
+      mStream.flush();
+
+      mCurrentChunk.mOffset = mFileOffset;
+      mChunks.push_back(mCurrentChunk);
+      mFileOffset += header.GetBufferSize() + mChunkData.GetBufferSize();
+
+      mCurrentChunk.mNumFrames = 0;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RecordingFileWriter::WriteIndex()
+   {
+      dtUtil::DataStream index;
+      index.SetForceLittleEndian(true);
+      index.SetBufferSize(4 + unsigned(mChunks.size()) * INDEX_ENTRY_SIZE + FOOTER_SIZE);
+
+      index << unsigned(mChunks.size());
+      for (size_t i = 0; i < mChunks.size(); ++i)
+      {
+         const ChunkInfo& chunk = mChunks[i];
+         index << chunk.mOffset;
+         index << chunk.mFirstTime;
+         index << chunk.mLastTime;
+         index << chunk.mNumFrames;
+      }
+      index << mFileOffset;
+      index.WriteBinary(RecordingFileConstants::INDEX_MAGIC, sizeof(RecordingFileConstants::INDEX_MAGIC));
+
+      mStream.write(index.GetBuffer(), index.GetBufferSize());
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RecordingFileWriter::SetFramesPerChunk(unsigned framesPerChunk)
+   {
+      mFramesPerChunk = dtUtil::Max(framesPerChunk, 1U);
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned RecordingFileWriter::GetFramesPerChunk() const
+   {
+      return mFramesPerChunk;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned RecordingFileWriter::GetNumFrames() const
+   {
+      return mNumFrames;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   /////////////////////////////////////////////////////////////////////////////
+   RecordingFileReader::RecordingFileReader()
+      : mNumSources(0)
+      , mNumFrames(0)
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   RecordingFileReader::~RecordingFileReader()
+   {
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RecordingFileReader::IsRecordingFile(const std::string& fileName)
+   {
+      std::ifstream stream(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+      if (!stream.is_open())
+      {
+         return false;
+      }
+
+      char magic[sizeof(RecordingFileConstants::MAGIC)];
+      stream.read(magic, sizeof(magic));
+      return stream.gcount() == std::streamsize(sizeof(magic))
+         && memcmp(magic, RecordingFileConstants::MAGIC, sizeof(magic)) == 0;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RecordingFileReader::Open(const std::string& fileName)
+   {
+      Close();
+
+      osg::ref_ptr<MappedFile> file = new MappedFile();
+      if (!file->Open(fileName))
+      {
+         LOG_ERROR("Unable to open recording file \"" + fileName + "\".");
+         return false;
+      }
+
+      if (file->GetSize() < FILE_HEADER_SIZE
+         || memcmp(file->GetData(), RecordingFileConstants::MAGIC, sizeof(RecordingFileConstants::MAGIC)) != 0)
+      {
+         LOG_ERROR("The file \"" + fileName + "\" is not a recording file.");
+         return false;
+      }
+
+      const unsigned version = ReadLittleEndian<unsigned>(file->GetData(), sizeof(RecordingFileConstants::MAGIC));
+      if (version > RecordingFileConstants::VERSION)
+      {
+         LOG_ERROR("The recording file \"" + fileName + "\" was written by a newer version and can't be read.");
+         return false;
+      }
+      mNumSources = ReadLittleEndian<unsigned>(file->GetData(), sizeof(RecordingFileConstants::MAGIC) + 4);
+
+      mFile = file;
+      if (!ReadIndex())
+      {
+         LOG_WARNING("The recording file \"" + fileName + "\" has no valid chunk index, probably because it was not closed.  "
+                  "It will be rebuilt from the chunks that were written.");
+         ScanChunks();
+      }
+
+      mNumFrames = 0;
+      for (size_t i = 0; i < mChunks.size(); ++i)
+      {
+         mNumFrames += mChunks[i].mNumFrames;
+      }
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RecordingFileReader::ReadIndex()
+   {
+      const size_t size = mFile->GetSize();
+      const char* data = mFile->GetData();
+      if (size < FILE_HEADER_SIZE + 4 + FOOTER_SIZE
+         || memcmp(data + size - sizeof(RecordingFileConstants::INDEX_MAGIC), RecordingFileConstants::INDEX_MAGIC,
+               sizeof(RecordingFileConstants::INDEX_MAGIC)) != 0)
+      {
+         return false;
+      }
+
+      const unsigned long long indexOffset = ReadLittleEndian<unsigned long long>(data, size - FOOTER_SIZE);
+      if (indexOffset < FILE_HEADER_SIZE || indexOffset + 4 > size - FOOTER_SIZE)
+      {
+         return false;
+      }
+
+      const unsigned numChunks = ReadLittleEndian<unsigned>(data, size_t(indexOffset));
+      if (indexOffset + 4 + (unsigned long long)(numChunks) * INDEX_ENTRY_SIZE != size - FOOTER_SIZE)
+      {
+         return false;
+      }
+
+      mChunks.resize(numChunks);
+      size_t entry = size_t(indexOffset) + 4;
+      for (unsigned i = 0; i < numChunks; ++i, entry += INDEX_ENTRY_SIZE)
+      {
+         ChunkInfo& chunk = mChunks[i];
+         chunk.mOffset = ReadLittleEndian<unsigned long long>(data, entry);
+         chunk.mFirstTime = ReadLittleEndian<double>(data, entry + 8);
+         chunk.mLastTime = ReadLittleEndian<double>(data, entry + 16);
+         chunk.mNumFrames = ReadLittleEndian<unsigned>(data, entry + 24);
+
+         // The chunks lie between the file header and the index, so ReadChunk can trust the offsets.
+         if (chunk.mOffset < FILE_HEADER_SIZE || chunk.mOffset + CHUNK_HEADER_SIZE > indexOffset)
+         {
+            mChunks.clear();
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RecordingFileReader::ScanChunks()
+   {
+      size_t size = mFile->GetSize();
+      const char* data = mFile->GetData();
+
+      // If only the index is damaged, stop at it rather than reading it as a chunk.
+      if (size >= FILE_HEADER_SIZE + FOOTER_SIZE
+         && memcmp(data + size - sizeof(RecordingFileConstants::INDEX_MAGIC), RecordingFileConstants::INDEX_MAGIC,
+               sizeof(RecordingFileConstants::INDEX_MAGIC)) == 0)
+      {
+         const unsigned long long indexOffset = ReadLittleEndian<unsigned long long>(data, size - FOOTER_SIZE);
+         if (indexOffset >= FILE_HEADER_SIZE && indexOffset < size)
+         {
+            size = size_t(indexOffset);
+         }
+      }
+
+      mChunks.clear();
+      size_t offset = FILE_HEADER_SIZE;
+      while (offset + CHUNK_HEADER_SIZE <= size)
+      {
+         ChunkInfo chunk;
+         chunk.mNumFrames = ReadLittleEndian<unsigned>(data, offset);
+         chunk.mFirstTime = ReadLittleEndian<double>(data, offset + 4);
+         chunk.mLastTime = ReadLittleEndian<double>(data, offset + 12);
+         const unsigned storedSize = ReadLittleEndian<unsigned>(data, offset + 24);
+
+         // A chunk cut off by a crash is dropped.
+         if (chunk.mNumFrames == 0 || storedSize > size - offset - CHUNK_HEADER_SIZE)
+         {
+            break;
+         }
+
+         chunk.mOffset = offset;
+         mChunks.push_back(chunk);
+         offset += CHUNK_HEADER_SIZE + storedSize;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   void RecordingFileReader::Close()
+   {
+      mFile = NULL;
+      mChunks.clear();
+      mNumSources = 0;
+      mNumFrames = 0;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RecordingFileReader::IsOpen() const
+   {
+      return mFile.valid();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned RecordingFileReader::GetNumSources() const
+   {
+      return mNumSources;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned RecordingFileReader::GetNumChunks() const
+   {
+      return unsigned(mChunks.size());
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned RecordingFileReader::GetNumFrames() const
+   {
+      return mNumFrames;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   double RecordingFileReader::GetStartTime() const
+   {
+      return mChunks.empty() ? 0.0 : mChunks.front().mFirstTime;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   double RecordingFileReader::GetEndTime() const
+   {
+      return mChunks.empty() ? 0.0 : mChunks.back().mLastTime;
+   }
+
+   namespace
+   {
+      struct ChunkStartsAfter
+      {
+         template <typename ChunkInfoT>
+         bool operator()(double time, const ChunkInfoT& chunk) const
+         {
+            return time < chunk.mFirstTime;
+         }
+      };
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   unsigned RecordingFileReader::FindChunk(double time) const
+   {
+      std::vector<ChunkInfo>::const_iterator i = std::upper_bound(mChunks.begin(), mChunks.end(), time, ChunkStartsAfter());
+      if (i == mChunks.begin())
+      {
+         return 0;
+      }
+      return unsigned(i - mChunks.begin()) - 1;
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   bool RecordingFileReader::ReadChunk(unsigned chunkIndex, Chunk& chunkOut) const
+   {
+      chunkOut.mFrames.clear();
+      if (chunkIndex >= mChunks.size())
+      {
+         return false;
+      }
+
+      const ChunkInfo& info = mChunks[chunkIndex];
+      const char* data = mFile->GetData();
+      const size_t size = mFile->GetSize();
+      if (info.mOffset + CHUNK_HEADER_SIZE > size)
+      {
+         LOG_ERROR("Recording chunk " + dtUtil::ToString(chunkIndex) + " is corrupt.");
+         return false;
+      }
+
+      const size_t chunkOffset = size_t(info.mOffset);
+      const unsigned numFrames = ReadLittleEndian<unsigned>(data, chunkOffset);
+      const unsigned rawSize = ReadLittleEndian<unsigned>(data, chunkOffset + 20);
+      const unsigned storedSize = ReadLittleEndian<unsigned>(data, chunkOffset + 24);
+
+      if (numFrames == 0 || storedSize > size - chunkOffset - CHUNK_HEADER_SIZE)
+      {
+         LOG_ERROR("Recording chunk " + dtUtil::ToString(chunkIndex) + " is corrupt.");
+         return false;
+      }
+
+      chunkOut.mData.resize(rawSize);
+      chunkOut.mFrames.reserve(numFrames);
+
+      dtUtil::DataStream stream(const_cast<char*>(data + chunkOffset + CHUNK_HEADER_SIZE), storedSize, false);
+      stream.SetForceLittleEndian(true);
+
+      try
+      {
+         unsigned offset = 0;
+         unsigned previousOffset = 0, previousSize = 0;
+         for (unsigned i = 0; i < numFrames; ++i)
+         {
+            Frame frame;
+            unsigned encodedSize = 0;
+            stream >> frame.mTime >> frame.mSize >> encodedSize;
+            frame.mOffset = offset;
+
+            if (frame.mSize > rawSize - offset || encodedSize > stream.GetRemainingReadSize()
+               || !DecodeZeroRuns(stream.GetBuffer() + stream.GetReadPosition(), encodedSize,
+                     frame.mSize > 0 ? &chunkOut.mData[offset] : NULL, frame.mSize))
+            {
+               LOG_ERROR("Recording chunk " + dtUtil::ToString(chunkIndex) + " is corrupt.");
+               chunkOut.mFrames.clear();
+               return false;
+            }
+            stream.Seekg(encodedSize, DataStream::SeekTypeEnum::CURRENT);
+
+            // Undo the delta against the previous frame.
+            char* current = frame.mSize > 0 ? &chunkOut.mData[offset] : NULL;
+            const unsigned overlap = dtUtil::Min(frame.mSize, previousSize);
+            for (unsigned b = 0; b < overlap; ++b)
+            {
+               current[b] ^= chunkOut.mData[previousOffset + b];
+            }
+
+            chunkOut.mFrames.push_back(frame);
+            previousOffset = offset;
+            previousSize = frame.mSize;
+            offset += frame.mSize;
+         }
+      }
+      catch (const dtUtil::DataStreamBufferReadError&)
+      {
+         LOG_ERROR("Recording chunk " + dtUtil::ToString(chunkIndex) + " is truncated.");
+         chunkOut.mFrames.clear();
+         return false;
+      }
+
+      return true;
+   }
+}
@@ -1,157 +1,159 @@
 #include "prefix/dtutilprefix.h"
 #include <dtUtil/refstring.h>
+#include <dtUtil/hashmap.h>
 #include <ostream>
+#include <cstring>
 
-#if defined( _LIBCPP_VERSION ) || (defined(_MSC_VER) && _MSC_VER >= 1700)
-#  include <unordered_set>
-#  define _UNORDERED_MAP
-#elif defined(__GNUG__)
-#  include <ext/hash_set>
-namespace __gnu_cxx
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+namespace dtUtil
 {
-   template<>
-     struct hash<std::string>
-     {
-      size_t operator()(const std::string& string) const
-        { return dtUtil::__hash_string(string.c_str()); }
-     };
-}
-#elif defined(_MSC_VER)
-#  include <hash_set>
-#else
-#  include <set>
-#endif
+   /// The number of separately locked parts of the table.  It must be a power of 2.
+   static const size_t NUM_INTERN_SHARDS = 64;
 
-#define USE_TABLE 1
+   /// The entries are keyed by their precomputed hash, so the map should use it as is.
+   struct InternHash
+   {
+      size_t operator()(size_t hash) const { return hash; }
+   };
+
+   /**
+    * One part of the intern table.  A string always goes into the shard picked by its hash, so threads
+    * interning different strings rarely wait on each other.
+    */
+   struct InternShard
+   {
+      typedef dtUtil::HashMultiMap<size_t, RefString::Entry, InternHash> EntryMap;
 
-#define THREAD_SAFETY 1
+      OpenThreads::Mutex mMutex;
+      EntryMap mEntries;
+   };
 
-#if THREAD_SAFETY
-#include <OpenThreads/Mutex>
-#endif
+   struct InternTable
+   {
+      InternShard mShards[NUM_INTERN_SHARDS];
+      OpenThreads::Atomic mCount;
+   };
 
-namespace dtUtil
-{
-   static size_t StringCount = 0;
-#if USE_TABLE
-
-#if THREAD_SAFETY
-   static OpenThreads::Mutex gStringSetMutex;
-#endif
-
-#ifdef _UNORDERED_MAP
-   static std::unordered_set<std::string> StringSet(3000);
-#elif defined(__GNUG__)
-   static __gnu_cxx::hash_set<std::string> StringSet(3000);
-#elif defined(_MSC_VER)
-   static stdext::hash_set<std::string> StringSet;
-#else
-   static std::set<std::string> StringSet;
-#endif
-#endif
+   /////////////////////////////////////////////////////////////
+   // RefStrings are created by static initializers everywhere, so the table is created on first use.
+   // It is never deleted so that RefStrings used during static destruction are still valid.
+   static InternTable& GetInternTable()
+   {
+      static InternTable* table = new InternTable;
+      return *table;
+   }
+
+   /////////////////////////////////////////////////////////////
+   // Same as __hash_string, so a RefString has the same hash as the std::string with the same value.
+   static size_t HashChars(const char* value, size_t length)
+   {
+      unsigned long h = 0;
+      for (size_t i = 0; i < length; ++i)
+      {
+         h = 5 * h + value[i];
+      }
+      return size_t(h);
+   }
+
+   /////////////////////////////////////////////////////////////
+   static const RefString::Entry* FindEntry(const InternShard::EntryMap& entries, size_t hash, const char* value, size_t length)
+   {
+      std::pair<InternShard::EntryMap::const_iterator, InternShard::EntryMap::const_iterator> range = entries.equal_range(hash);
+      for (; range.first != range.second; ++range.first)
+      {
+         const std::string& str = range.first->second.mString;
+         if (str.size() == length && std::memcmp(str.data(), value, length) == 0)
+         {
+            return &range.first->second;
+         }
+      }
+      return NULL;
+   }
+
+   /////////////////////////////////////////////////////////////
    size_t RefString::GetSharedStringCount()
    {
-      return StringCount;
+      return size_t(unsigned(GetInternTable().mCount));
    }
 
    /////////////////////////////////////////////////////////////
-   RefString::RefString(const std::string& value): mString(NULL)
+   RefString::RefString(const std::string& value): mEntry(NULL)
    {
-      Intern(value);
+      Intern(value.data(), value.size());
    }
 
    /////////////////////////////////////////////////////////////
-   RefString::RefString(const char* value): mString(NULL)
+   RefString::RefString(const char* value): mEntry(NULL)
    {
-      Intern(value);
+      Intern(value, std::strlen(value));
    }
 
    /////////////////////////////////////////////////////////////
-   RefString::RefString(const RefString& toCopy): mString(NULL)
-   {
-#if USE_TABLE
-      //If we are using the table, we'll get the same pointer anyway.
-      mString = toCopy.mString;
-#else
-      Intern(*toCopy.mString);
-#endif
+   RefString::RefString(const RefString& toCopy): mEntry(toCopy.mEntry)
+   {
    }
 
    /////////////////////////////////////////////////////////////
    RefString::~RefString()
    {
-#if !USE_TABLE
-      delete mString;
-      --StringCount;
-#endif
    }
 
    /////////////////////////////////////////////////////////////
    RefString RefString::operator+(const std::string& string) const
    {
-      return RefString(*mString + string);
+      return RefString(mEntry->mString + string);
    }
 
    /////////////////////////////////////////////////////////////
    RefString RefString::operator+(const RefString& refString) const
    {
-      return RefString(*mString + *refString.mString);
+      return RefString(mEntry->mString + refString.mEntry->mString);
    }
 
    /////////////////////////////////////////////////////////////
    RefString RefString::operator+(const char* str) const
    {
-      return RefString(*mString + str);
+      return RefString(mEntry->mString + str);
    }
 
    /////////////////////////////////////////////////////////////
    dtUtil::RefString& RefString::operator=(const std::string& value)
    {
-      Intern(value);
+      Intern(value.data(), value.size());
       return *this;
    }
 
    /////////////////////////////////////////////////////////////
    dtUtil::RefString& RefString::operator=(const dtUtil::RefString& value)
    {
-      if (this == &value)
-         return *this;
-#if USE_TABLE
-      //If we are using the table, we'll get the same pointer anyway.
-      mString = value.mString;
-#else
-      Intern(*value.mString);
-#endif
+      mEntry = value.mEntry;
       return *this;
    }
 
    /////////////////////////////////////////////////////////////
-   void RefString::Intern(const std::string& value)
+   void RefString::Intern(const char* value, size_t length)
    {
-#if USE_TABLE
-
-#if THREAD_SAFETY
-      // for thread safety, lock this section
-      gStringSetMutex.lock();
-#endif
+      const size_t hash = HashChars(value, length);
 
-      //One can only insert a string once, but it will still return the iterator.
-      mString = &(*StringSet.insert(value).first);
-      StringCount = StringSet.size();
+      InternTable& table = GetInternTable();
+      InternShard& shard = table.mShards[(hash ^ (hash >> 7)) & (NUM_INTERN_SHARDS - 1)];
 
-#if THREAD_SAFETY
-      gStringSetMutex.unlock();
-#endif
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
 
-#else
-      if (mString != NULL)
+      const Entry* entry = FindEntry(shard.mEntries, hash, value, length);
+      if (entry == NULL)
       {
-         delete mString;
-         --StringCount;
+         Entry newEntry;
+         newEntry.mString.assign(value, length);
+         newEntry.mHash = hash;
+         // The entries never move, so the pointer is good for the life of the program.
+         entry = &shard.mEntries.insert(std::make_pair(hash, newEntry))->second;
+         ++table.mCount;
       }
-      mString = new std::string(value);
-      ++StringCount;
-#endif
+      mEntry = entry;
    }
 
    /////////////////////////////////////////////////////////////
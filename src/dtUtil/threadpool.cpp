@@ -33,7 +33,7 @@
 #include <OpenThreads/Atomic>
 #include <OpenThreads/Block>
 #include <OpenThreads/Mutex>
-#include <queue>
+#include <deque>
 #include <set>
 #include <map>
 #include <algorithm>
@@ -44,50 +44,28 @@ namespace dtUtil
 
    class TaskThread;
 
-template<class _Ty,
-   class _Container = std::vector<_Ty>,
-   class _Pr = std::less<typename _Container::value_type> >
-   class checked_priority_queue : public std::priority_queue<_Ty, _Container, _Pr>
-   {
-   public:
-      typedef std::priority_queue<_Ty, _Container, _Pr> BaseClass;
-      bool checkme()
-      {
-         for (unsigned i = 1; i < BaseClass::c.size(); ++i)
-         {
-            // c[0] should have the highest priority.
-            if (BaseClass::c[0] < BaseClass::c[i])
-               return false;
-         }
-         return true;
-      }
-   };
-
-
    class DT_UTIL_EXPORT TaskQueue : public osg::Referenced
    {
    public:
 
       static const unsigned MAX_QUEUE_ID = 15;
 
-      TaskQueue();
+      /**
+       * @param numWorkerThreads the number of threads that will be added.  One extra deque is created
+       *                         for the threads outside the pool, such as the one calling ExecuteTasks.
+       */
+      TaskQueue(unsigned numWorkerThreads);
 
       /** Return true if the operation queue is empty. */
-      bool Empty() const { return mTasks.empty(); }
+      bool Empty() const { return unsigned(mNumQueuedTasks) == 0U; }
 
       /** Return the num of pending tasks that are sitting in the TaskQueue.*/
-      unsigned int GetNumTasksInQueue() const { return unsigned(mTasks.size()); }
+      unsigned int GetNumTasksInQueue() const { return unsigned(mNumQueuedTasks); }
 
       /** Add a task to end of TaskQueue, this will be
       * executed by the task thread once this operation gets to the head of the queue.*/
       void Add(ThreadPoolTask& task, unsigned queueId);
 
-      //           /** Remove task from TaskQueue.*/
-      //           void Remove(ThreadPoolTask& task);
-      //
-      //           /** Remove named task from TaskQueue.*/
-      //           void Remove(const dtUtil::RefString& name);
-
       /** Remove all tasks from TaskQueue.*/
       void RemoveAllTasks();
 
@@ -100,9 +78,10 @@ template<class _Ty,
       * @param blockIfEmpty if the queue is empty at the start, then block until a task is queued or the block
       *                     is otherwise released.
       * @param maxQueueId execute only tasks with a queue id less than equal to the one passed it.
+      * @param lane the deque to take tasks from first, before stealing from the others.
       * @return true if a task was executed.
       */
-      bool ExecuteSingleTask(bool blockIfEmpty = true, unsigned maxQueueId = INT_MAX);
+      bool ExecuteSingleTask(bool blockIfEmpty, unsigned maxQueueId, unsigned lane);
 
       /** Release tasks block that is used to block threads that are waiting on an empty tasks queue.*/
       void ReleaseTasksBlock();
@@ -112,6 +91,9 @@ template<class _Ty,
       /** Get the set of TaskThreads that are sharing this TaskQueue. */
       const TaskThreads& getTaskThreads() const { return mTaskThreads; }
 
+      /** @return the number of task deques, one per worker thread plus one for outside threads. */
+      unsigned GetNumLanes() const { return unsigned(mLanes.size()); }
+
    protected:
 
       virtual ~TaskQueue();
@@ -125,185 +107,231 @@ template<class _Ty,
       {
          dtCore::RefPtr<ThreadPoolTask> mTask;
          unsigned mQueueId;
-         // We want low to high, not high to low.
-         bool operator < (const TaskQueueItem& item) const { return mQueueId > item.mQueueId; }
       };
 
-      typedef checked_priority_queue<TaskQueueItem> Tasks;
+      /**
+       * The tasks owned by one worker thread, split by queue id.  The owner takes from the front, so tasks run
+       * in the order they were added and kept tasks go to the back, and thieves take from the back so they
+       * rarely want the same end.
+       */
+      struct Lane
+      {
+         OpenThreads::Mutex mMutex;
+         std::deque<TaskQueueItem> mTasks[MAX_QUEUE_ID + 1U];
+      };
+
+      /// @return the lane of the calling thread if it is a worker of this queue, otherwise lane 0.
+      unsigned GetLaneForCurrentThread() const;
 
-      OpenThreads::Mutex     mTasksMutex;
+      /// Takes the next task with the lowest queue id, first from the given lane and then from the others.
+      bool TakeTask(unsigned lane, unsigned maxQueueId, TaskQueueItem& itemOut);
+      bool TakeFromLane(unsigned lane, unsigned queueId, bool front, TaskQueueItem& itemOut);
+
+      std::vector<Lane*>     mLanes;
       OpenThreads::Block     mTasksBlock;
-      Tasks                  mTasks;
+      OpenThreads::Atomic    mNumQueuedTasks;
+      OpenThreads::Atomic    mNextLane;
 
       TaskThreads            mTaskThreads;
+      OpenThreads::Atomic    mQueuedTasks[MAX_QUEUE_ID + 1U];
       OpenThreads::Atomic    mInProcessTasks[MAX_QUEUE_ID + 1U];
    };
 
-   TaskQueue::TaskQueue():
+   class  TaskThread : public osg::Referenced, public OpenThreads::Thread
+   {
+   public:
+      TaskThread(TaskQueue& queue, unsigned lane);
+
+      /** Run does the operation thread run loop.*/
+      virtual void run();
+
+      /** Cancel this thread.*/
+      virtual int cancel();
+
+      const TaskQueue* GetTaskQueue() const { return mTaskQueue.get(); }
+      unsigned GetLane() const { return mLane; }
+
+   protected:
+
+      virtual ~TaskThread();
+
+      OpenThreads::Mutex         mThreadMutex;
+      dtCore::RefPtr<TaskQueue>  mTaskQueue;
+      unsigned mLane;
+      volatile bool mDone;
+   };
+
+   TaskQueue::TaskQueue(unsigned numWorkerThreads):
        osg::Referenced(true)
    {
+      mLanes.resize(numWorkerThreads + 1U);
+      for (unsigned i = 0; i < mLanes.size(); ++i)
+      {
+         mLanes[i] = new Lane;
+      }
    }
 
    TaskQueue::~TaskQueue()
    {
+      for (unsigned i = 0; i < mLanes.size(); ++i)
+      {
+         delete mLanes[i];
+      }
+   }
+
+   unsigned TaskQueue::GetLaneForCurrentThread() const
+   {
+      TaskThread* taskThread = dynamic_cast<TaskThread*>(OpenThreads::Thread::CurrentThread());
+      if (taskThread != NULL && taskThread->GetTaskQueue() == this)
+      {
+         return taskThread->GetLane();
+      }
+      return 0U;
    }
 
    void TaskQueue::Add(ThreadPoolTask& task, unsigned queueId)
    {
       dtUtil::Clamp(queueId, 0U, MAX_QUEUE_ID);
 
-      // acquire the lock on the operations queue to prevent anyone else from modifying it at the same time
-      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mTasksMutex);
+      unsigned lane = GetLaneForCurrentThread();
+      if (lane == 0U)
+      {
+         // Spread tasks from outside the pool over all the lanes so the workers don't all steal from one.
+         lane = unsigned(++mNextLane) % GetNumLanes();
+      }
 
       TaskQueueItem newItem;
       newItem.mTask = &task;
       newItem.mQueueId = queueId;
-      // add the operation to the end of the list
-      mTasks.push(newItem);
 
+      // The counts go up before the task is visible so they never drop below the number of queued tasks.
       ++mInProcessTasks[queueId];
+      ++mQueuedTasks[queueId];
+      ++mNumQueuedTasks;
+
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mLanes[lane]->mMutex);
+         mLanes[lane]->mTasks[queueId].push_back(newItem);
+      }
 
       mTasksBlock.release();
    }
 
-//   void TaskQueue::Remove(ThreadPoolTask& task)
-//   {
-//       // acquire the lock on the operations queue to prevent anyone else for modifying it at the same time
-//       OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mTasksMutex);
-//
-//       for(Tasks::iterator itr = mTasks.begin();
-//           itr!=mTasks.end();)
-//       {
-//           if ((*itr)==&task)
-//           {
-//               bool needToResetCurrentIterator = (mCurrentTaskIterator == itr);
-//
-//               itr = mTasks.erase(itr);
-//
-//               if (needToResetCurrentIterator) mCurrentTaskIterator = itr;
-//
-//           }
-//           else ++itr;
-//       }
-//
-//       if (Empty())
-//       {
-//           mTasksBlock.reset();
-//       }
-//   }
-
-//   void TaskQueue::Remove(const dtUtil::RefString& name)
-//   {
-//       // acquire the lock on the operations queue to prevent anyone else for modifying it at the same time
-//       OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mTasksMutex);
-//
-//       // find the remove all operations with specified name
-//       for(Tasks::iterator itr = mTasks.begin();
-//           itr!=mTasks.end();)
-//       {
-//           if ((*itr)->GetName() == name)
-//           {
-//               bool needToResetCurrentIterator = (mCurrentTaskIterator == itr);
-//
-//               itr = mTasks.erase(itr);
-//
-//               if (needToResetCurrentIterator) mCurrentTaskIterator = itr;
-//           }
-//           else ++itr;
-//       }
-//
-//       if (Empty())
-//       {
-//           mTasksBlock.reset();
-//       }
-//   }
-
    void TaskQueue::RemoveAllTasks()
    {
-       OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mTasksMutex);
-
-       while (!Empty())
-       {
-          mTasks.pop();
-       }
+      for (unsigned lane = 0; lane < mLanes.size(); ++lane)
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mLanes[lane]->mMutex);
+         for (unsigned queueId = 0; queueId <= MAX_QUEUE_ID; ++queueId)
+         {
+            std::deque<TaskQueueItem>& tasks = mLanes[lane]->mTasks[queueId];
+            for (unsigned i = 0; i < tasks.size(); ++i)
+            {
+               --mNumQueuedTasks;
+               --mQueuedTasks[queueId];
+               --mInProcessTasks[queueId];
+            }
+            tasks.clear();
+         }
+      }
 
-        mTasksBlock.reset();
+      mTasksBlock.reset();
    }
 
-   bool TaskQueue::ExecuteSingleTask(bool blockIfEmpty, unsigned maxQueueId)
+   bool TaskQueue::TakeFromLane(unsigned lane, unsigned queueId, bool front, TaskQueueItem& itemOut)
    {
-      dtUtil::Clamp(maxQueueId, 0U, MAX_QUEUE_ID);
-
-      bool wasEmpty = false;
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mLanes[lane]->mMutex);
+      std::deque<TaskQueueItem>& tasks = mLanes[lane]->mTasks[queueId];
+      if (tasks.empty())
+      {
+         return false;
+      }
 
-      dtCore::RefPtr<ThreadPoolTask> currentTask = NULL;
-      unsigned queueId = 0;
+      if (front)
       {
-         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mTasksMutex);
+         itemOut = tasks.front();
+         tasks.pop_front();
+      }
+      else
+      {
+         itemOut = tasks.back();
+         tasks.pop_back();
+      }
+      return true;
+   }
 
-         if (Empty())
+   bool TaskQueue::TakeTask(unsigned lane, unsigned maxQueueId, TaskQueueItem& itemOut)
+   {
+      const unsigned numLanes = GetNumLanes();
+      for (unsigned queueId = 0; queueId <= maxQueueId; ++queueId)
+      {
+         // Lower queue ids always go first, so only look in the lanes when there is something with this id.
+         if (unsigned(mQueuedTasks[queueId]) == 0U)
          {
-            wasEmpty = true;
+            continue;
          }
-         else
-         {
-            //if (!mTasks.checkme())
-            //{
-            //   LOG_ERROR("Task Queue was not in the correct order");
-            //}
 
-            queueId = mTasks.top().mQueueId;
-
-            if (queueId > maxQueueId)
-            {
-               return false;
-            }
-
-            currentTask = mTasks.top().mTask;
-
-            mTasks.pop();
+         bool found = TakeFromLane(lane, queueId, true, itemOut);
+         for (unsigned i = 1; !found && i < numLanes; ++i)
+         {
+            found = TakeFromLane((lane + i) % numLanes, queueId, false, itemOut);
+         }
 
-            if (Empty())
+         if (found)
+         {
+            --mQueuedTasks[queueId];
+            if (--mNumQueuedTasks == 0U)
             {
                mTasksBlock.reset();
+               // A task added between the decrement and the reset would have had its release undone.
+               if (unsigned(mNumQueuedTasks) > 0U)
+               {
+                  mTasksBlock.release();
+               }
             }
+            return true;
          }
       }
+      return false;
+   }
+
+   bool TaskQueue::ExecuteSingleTask(bool blockIfEmpty, unsigned maxQueueId, unsigned lane)
+   {
+      dtUtil::Clamp(maxQueueId, 0U, MAX_QUEUE_ID);
 
-      // if the code above decided that the queue was empty when inside the lock
-      // and the caller specified that it should block...
-      if (wasEmpty)
+      TaskQueueItem item;
+      if (!TakeTask(lane, maxQueueId, item))
       {
          if (blockIfEmpty && mTasksBlock.block(1000))
          {
             // if the block was released without a timeout, execute again, but with no blocking
             // The reason for no blocking is that we don't want to keep re-blocking if we don't
             // get a task, that would be bad.
-            return ExecuteSingleTask(false, maxQueueId);
+            return ExecuteSingleTask(false, maxQueueId, lane);
          }
          else
          {
             return false;
          }
       }
-      else
-      {
-         /// execute
-         (*currentTask)();
 
-         if (currentTask->GetKeep())
-         {
-            // re-add the task before decrementing the in process count so that code won't think all tasks are done
-            Add(*currentTask, queueId);
-         }
-         else
-         {
-            currentTask->ReleaseWaitBlock();
-         }
+      /// execute
+      (*item.mTask)();
 
-         --mInProcessTasks[queueId];
+      if (item.mTask->GetKeep())
+      {
+         // re-add the task before decrementing the in process count so that code won't think all tasks are done
+         Add(*item.mTask, item.mQueueId);
+      }
+      else
+      {
+         // queue the continuations before decrementing the in process count for the same reason.
+         item.mTask->Complete();
+         item.mTask->ReleaseWaitBlock();
       }
 
+      --mInProcessTasks[item.mQueueId];
+
       return true;
    }
 
@@ -311,6 +339,7 @@ template<class _Ty,
    {
       dtUtil::Clamp(maxQueueId, 0U, MAX_QUEUE_ID);
 
+      unsigned lane = GetLaneForCurrentThread();
       unsigned tasksInProcess = 0;
 
       do
@@ -331,7 +360,7 @@ template<class _Ty,
             }
          }
       }
-      while (ExecuteSingleTask(false, maxQueueId) || tasksInProcess > 0);
+      while (ExecuteSingleTask(false, maxQueueId, lane) || tasksInProcess > 0);
    }
 
    void TaskQueue::ReleaseTasksBlock()
@@ -349,29 +378,10 @@ template<class _Ty,
       mTaskThreads.erase(thread);
    }
 
-   class  TaskThread : public osg::Referenced, public OpenThreads::Thread
-   {
-   public:
-      TaskThread(TaskQueue& queue);
-
-      /** Run does the operation thread run loop.*/
-      virtual void run();
-
-      /** Cancel this thread.*/
-      virtual int cancel();
-
-   protected:
-
-      virtual ~TaskThread();
-
-      OpenThreads::Mutex         mThreadMutex;
-      dtCore::RefPtr<TaskQueue>  mTaskQueue;
-      volatile bool mDone;
-   };
-
-   TaskThread::TaskThread(TaskQueue& queue)
+   TaskThread::TaskThread(TaskQueue& queue, unsigned lane)
    : osg::Referenced(true)
    , mTaskQueue(&queue)
+   , mLane(lane)
    , mDone(false)
    {
    }
@@ -415,7 +425,7 @@ template<class _Ty,
 
          //printf("Preparing To Run a task! %p \n", this);
          // execute any task and block if there are none
-         if ((!queue->ExecuteSingleTask() && !mDone) || firstTime)
+         if ((!queue->ExecuteSingleTask(true, INT_MAX, mLane) && !mDone) || firstTime)
          {
             //printf("Yielding worker thread! %p \n", this);
             OpenThreads::Thread::YieldCurrentThread();
@@ -440,6 +450,9 @@ template<class _Ty,
    : osg::Referenced(true)
    , mName("Task")
    , mKeep(false)
+   , mPendingDependencies(0U)
+   , mDeferredQueue(-1)
+   , mComplete(false)
    {
       //default it to released.
       mBlockUntilComplete.release();
@@ -479,6 +492,83 @@ template<class _Ty,
       return result;
    }
 
+   //////////////////////////////////////
+   void ThreadPoolTask::AddDependency(ThreadPoolTask& prerequisite)
+   {
+      // Always lock the prerequisite first.  Complete() never holds two of these locks at once.
+      OpenThreads::ScopedLock<OpenThreads::Mutex> prerequisiteLock(prerequisite.mDependencyMutex);
+      if (prerequisite.mComplete)
+      {
+         return;
+      }
+
+      prerequisite.mContinuations.push_back(this);
+
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mDependencyMutex);
+      ++mPendingDependencies;
+   }
+
+   //////////////////////////////////////
+   void ThreadPoolTask::ResetCompletion()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mDependencyMutex);
+      mComplete = false;
+   }
+
+   //////////////////////////////////////
+   unsigned ThreadPoolTask::GetNumPendingDependencies() const
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mDependencyMutex);
+      return mPendingDependencies;
+   }
+
+   //////////////////////////////////////
+   bool ThreadPoolTask::DeferUntilDependenciesComplete(int queue)
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mDependencyMutex);
+      if (mPendingDependencies > 0U)
+      {
+         mDeferredQueue = queue;
+         return true;
+      }
+      mComplete = false;
+      return false;
+   }
+
+   //////////////////////////////////////
+   void ThreadPoolTask::Complete()
+   {
+      std::vector<dtCore::RefPtr<ThreadPoolTask> > continuations;
+      {
+         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mDependencyMutex);
+         mComplete = true;
+         continuations.swap(mContinuations);
+      }
+
+      for (unsigned i = 0; i < continuations.size(); ++i)
+      {
+         int queue = continuations[i]->ReleaseDependency();
+         if (queue >= 0)
+         {
+            ThreadPool::AddTask(*continuations[i], ThreadPool::PoolQueue(queue));
+         }
+      }
+   }
+
+   //////////////////////////////////////
+   int ThreadPoolTask::ReleaseDependency()
+   {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mDependencyMutex);
+      --mPendingDependencies;
+      int queue = -1;
+      if (mPendingDependencies == 0U)
+      {
+         queue = mDeferredQueue;
+         mDeferredQueue = -1;
+      }
+      return queue;
+   }
+
    //////////////////////////////////////////////////
    //////////////////////////////////////////////////
 
@@ -522,9 +612,6 @@ template<class _Ty,
          numThreads = OpenThreads::GetNumberOfProcessors() - 1;
       }
 
-      gThreadPoolImpl.mTaskQueue = new TaskQueue;
-      gThreadPoolImpl.mBackgroundQueue = gThreadPoolImpl.mTaskQueue;
-
       if (numThreads <= 0)
       {
          // On a single core box, or if the user specifies 0 worker threads,
@@ -532,16 +619,24 @@ template<class _Ty,
          // Immediate stuff will only be run when ExecuteTasks is called.
          numThreads = 1;
          gThreadPoolImpl.mTaskThreadForBackgroundOnly = true;
-         gThreadPoolImpl.mBackgroundQueue = new TaskQueue;
+         gThreadPoolImpl.mTaskQueue = new TaskQueue(0U);
+         gThreadPoolImpl.mBackgroundQueue = new TaskQueue(1U);
+      }
+      else
+      {
+         gThreadPoolImpl.mTaskThreadForBackgroundOnly = false;
+         gThreadPoolImpl.mTaskQueue = new TaskQueue(unsigned(numThreads));
+         gThreadPoolImpl.mBackgroundQueue = gThreadPoolImpl.mTaskQueue;
       }
 
-      gThreadPoolImpl.mIOQueue = new TaskQueue;
+      gThreadPoolImpl.mIOQueue = new TaskQueue(1U);
 
       for (int i = 0; i < numThreads; ++i)
       {
          dtCore::RefPtr<TaskThread> newThread;
          // the background queue may also be the main task queue.
-         newThread = new TaskThread(*gThreadPoolImpl.mBackgroundQueue);
+         // lane 0 is for threads outside the pool.
+         newThread = new TaskThread(*gThreadPoolImpl.mBackgroundQueue, unsigned(i) + 1U);
 
          gThreadPoolImpl.mTaskThreads.push_back(newThread);
          newThread->start();
@@ -550,7 +645,7 @@ template<class _Ty,
       {
          dtCore::RefPtr<TaskThread> newThread;
          // the make a thread just for the io queue.
-         newThread = new TaskThread(*gThreadPoolImpl.mIOQueue);
+         newThread = new TaskThread(*gThreadPoolImpl.mIOQueue, 1U);
 
          gThreadPoolImpl.mTaskThreads.push_back(newThread);
          newThread->start();
@@ -573,6 +668,12 @@ template<class _Ty,
    void ThreadPool::AddTask(ThreadPoolTask& task, PoolQueue queue)
    {
       task.ResetWaitBlock();
+      if (task.DeferUntilDependenciesComplete(queue))
+      {
+         // One of the tasks it depends on will add it.
+         return;
+      }
+
       if (queue == IMMEDIATE)
       {
          gThreadPoolImpl.mTaskQueue->Add(task, 0);
@@ -605,6 +706,12 @@ template<class _Ty,
       return gThreadPoolImpl.mTaskThreads.size();
    }
 
+   //////////////////////////////////////////////////
+   bool ThreadPool::HasImmediateWorkerThreads()
+   {
+      return gThreadPoolImpl.mInitialized && !gThreadPoolImpl.mTaskThreadForBackgroundOnly;
+   }
+
    //////////////////////////////////////////////////
    //////////////////////////////////////////////////
    //////////////////////////////////////////////////
@@ -27,29 +27,78 @@
 #include <dtUtil/log.h>
 
 #include <tbb/parallel_for.h>
-#include <tbb/blocked_range3d.h>
-#include <tbb/mutex.h>
+#include <tbb/blocked_range.h>
 #include <tbb/task_scheduler_init.h>
 
 #include <dtCore/timer.h>
 
+#include <algorithm>
+#include <memory>
+
 namespace dtVoxel
 {
-   int HashVec3WithMap(std::map<osg::Vec3, int>& vectorMap, const osg::Vec3& vec, bool& inserted)
+   // The sample layers along z in one slab of the mesh.
+   static const int LAYERS_PER_CHUNK = 4;
+
+   static const GLuint NO_VERTEX = ~GLuint(0);
+
+   // Cell edge n of PolygonizeCube as the offset of the sample it starts on and its axis.
+   static const int CELL_EDGES[12][4] =
+   {
+      { 0, 0, 0, 0 }, { 1, 0, 0, 1 }, { 0, 1, 0, 0 }, { 0, 0, 0, 1 },
+      { 0, 0, 1, 0 }, { 1, 0, 1, 1 }, { 0, 1, 1, 0 }, { 0, 0, 1, 1 },
+      { 0, 0, 0, 2 }, { 1, 0, 0, 2 }, { 1, 1, 0, 2 }, { 0, 1, 0, 2 }
+   };
+
+   // The corners of a cell in PolygonizeCube order as offsets from its lowest corner.
+   static const int CELL_CORNERS[8][3] =
+   {
+      { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 },
+      { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 }
+   };
+
+   /*
+    * Computes where the isolevel falls along a row of edges as a fraction from a to b.
+    * It's written without branches over plain arrays so the compiler can vectorize it.  The result is only
+    * meaningful for the edges the surface crosses, so equal values just have to avoid dividing by 0.
+    */
+   static void InterpolateEdgeRow(const float* a, const float* b, int count, float iso, float* t)
    {
-      inserted = true;
-      int index = vectorMap.size();
-      auto insertResult = vectorMap.insert(std::make_pair(vec, index));
-      //if insert fails
-      if (!insertResult.second)
+      for (int n = 0; n < count; ++n)
       {
-         //take the existing index
-         index = insertResult.first->second;
-         inserted = false;
+         float delta = b[n] - a[n];
+         float safeDelta = delta != 0.0f ? delta : 1.0f;
+         t[n] = (iso - a[n]) / safeDelta;
       }
+   }
 
-      return index;
-   }   
+   static bool IsCrossed(float a, float b, float iso)
+   {
+      return (a < iso) != (b < iso);
+   }
+
+   template <typename Chunk, typename Func>
+   static void ForEachChunk(std::vector<Chunk>& chunks, bool parallel, Func func)
+   {
+      if (parallel)
+      {
+         tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1U),
+            [&](const tbb::blocked_range<size_t>& r)
+         {
+            for (size_t c = r.begin(); c != r.end(); ++c)
+            {
+               func(chunks[c]);
+            }
+         });
+      }
+      else
+      {
+         for (size_t c = 0; c < chunks.size(); ++c)
+         {
+            func(chunks[c]);
+         }
+      }
+   }
 
    CreateMeshTask::CreateMeshTask(const osg::Vec3& offset, const osg::Vec3& texelSize, const osg::Vec3i& resolution, double isolevel, openvdb::FloatGrid::Ptr grid)
       : mSkipBackFaces(true)
@@ -67,12 +116,14 @@ namespace dtVoxel
       , mDirtyBounds()
       , mMesh(new osg::Geode())
       , mGrid(grid)
-      , mCacheData()
    {
-      if (mCacheTriangleData)
+      for (int z = 0; z <= mResolution[2]; z += LAYERS_PER_CHUNK)
       {
-         mCacheData.resize(mResolution[0] * mResolution[1] * mResolution[2]);
-         mOccupancy.resize(mResolution[0] * mResolution[1] * mResolution[2], 0);
+         MeshChunk chunk;
+         chunk.mBeginZ = z;
+         chunk.mEndZ = dtUtil::Min(z + LAYERS_PER_CHUNK, mResolution[2] + 1);
+         chunk.mNumVerts = chunk.mNumIndices = chunk.mFirstVert = chunk.mFirstIndex = chunk.mIndicesWritten = 0U;
+         mChunks.push_back(chunk);
       }
    }
 
@@ -80,8 +131,16 @@ namespace dtVoxel
    {
       mMesh = nullptr;
       mGrid = nullptr;
-      mOccupancy.clear();
-      mCacheData.clear();
+   }
+
+   void CreateMeshTask::SetMode(GenerateMode mode)
+   {
+      mMode = mode;
+   }
+
+   CreateMeshTask::GenerateMode CreateMeshTask::GetMode() const
+   {
+      return mMode;
    }
 
    bool CreateMeshTask::IsDone() const
@@ -117,169 +176,86 @@ namespace dtVoxel
 
    void CreateMeshTask::RunSingleThreaded()
    {
-      dtCore::Timer_t startTime = dtCore::Timer::Instance()->Tick();
-
-      openvdb::tools::GridSampler<openvdb::FloatGrid::ConstAccessor, openvdb::tools::PointSampler> sampler(mGrid->getConstAccessor(), mGrid->transform());
-
-      TRIANGLE triangles[5];
-
-      std::map<osg::Vec3, int> vectorMap;
-
-      dtCore::RefPtr<osg::Geometry> geom = new osg::Geometry();
-      dtCore::RefPtr<osg::Vec3Array> vertArray = new osg::Vec3Array();
-      dtCore::RefPtr<osg::DrawElementsUInt> drawElements = new osg::DrawElementsUInt(GL_TRIANGLES);
+      BuildMesh(false);
+   }
 
-      for (int i = 0; i < mResolution[0]; ++i)
+   void CreateMeshTask::RunMultiThreads()
+   {
+      // The thread count only applies while the scheduler is alive, so it has to outlive the build.
+      std::unique_ptr<tbb::task_scheduler_init> init;
+      if (mMode == UseSetNumThreads)
       {
-         for (int j = 0; j < mResolution[1]; ++j)
-         {
-            for (int k = 0; k < mResolution[2]; ++k)
-            {
-               int numTriangles = SampleSingleCell(i, j, k, sampler, triangles);
-
-               for (int n = 0; n < numTriangles; ++n)
-               {
-                  if (mSkipBackFaces && triangles[n].n[0].z() < 0.0 && triangles[n].n[1].z() < 0.0 && triangles[n].n[2].z() < 0.0)
-                  {
-                     //skipping triangle 
-                  }
-                  else
-                  {
-                     for (int i = 0; i < 3; ++i)
-                     {
-                        bool inserted = false;
-                        int numVerts = vertArray->size();
-                        int index = HashVec3WithMap(vectorMap, triangles[n].p[i], inserted);
-
-                        if (inserted)
-                        {
-                           vertArray->push_back(triangles[n].p[i]);
-                        }
-
-                        drawElements->addElement(index);
-                     }
-                  }
-               }
-            }
-         }
+         init.reset(new tbb::task_scheduler_init(mNumThreads));
       }
 
-      //std::cout << "Num Verts " << vertArray->getNumElements() << std::endl;
-
-
-      geom->setVertexArray(vertArray);
-      geom->addPrimitiveSet(drawElements);
-
-      mMesh->addDrawable(geom);
-
-      vectorMap.clear();
-      mIsDone = true;
-   
-      mTime = dtCore::Timer::Instance()->DeltaMil(startTime, dtCore::Timer::Instance()->Tick());
-      LOGN_DEBUG("createmeshtask.cpp", "Time to update cell ms: " + dtUtil::ToString(mTime));
+      BuildMesh(true);
    }
 
-   void CreateMeshTask::RunMultiThreads()
+   void CreateMeshTask::BuildMesh(bool parallel)
    {
-      int trianglesSkipped = 0;
-      if (mMode == UseMaxThreads)
-      {
-         tbb::task_scheduler_init init();
-      }
-      else
+      dtCore::Timer_t startTime = dtCore::Timer::Instance()->Tick();
+
+      size_t numSamples = size_t(mResolution[0] + 1) * size_t(mResolution[1] + 1) * size_t(mResolution[2] + 1);
+      bool onlyDirty = mUseCache && mUseBoundingBox && mSamples.size() == numSamples;
+      if (!onlyDirty)
       {
-         tbb::task_scheduler_init init(mNumThreads);
+         mSamples.resize(numSamples);
       }
+      mEdgeVertices.resize(numSamples * 3U);
 
-      dtCore::Timer_t startTime = dtCore::Timer::Instance()->Tick();
-      dtCore::RefPtr<osg::Geometry> geom = new osg::Geometry();
-      dtCore::RefPtr<osg::Vec3Array> vertArray = new osg::Vec3Array();
-      dtCore::RefPtr<osg::DrawElementsUInt> drawElements = new osg::DrawElementsUInt(GL_TRIANGLES);
+      ForEachChunk(mChunks, parallel, [this, onlyDirty](MeshChunk& chunk)
+      {
+         SampleChunk(chunk, onlyDirty);
+      });
 
-      tbb::mutex /*hashMtx,*/ elemMtx;
+      // The slabs count first so each one knows where in the output to write.
+      ForEachChunk(mChunks, parallel, [this](MeshChunk& chunk)
+      {
+         CountChunk(chunk);
+      });
 
-      tbb::parallel_for(tbb::blocked_range3d<int>(0, mResolution[0], 1U, 0, mResolution[1], 16U, 0, mResolution[2], 9U),
-         [&](const tbb::blocked_range3d<int>& r)
+      unsigned numVerts = 0U, numIndices = 0U;
+      for (size_t c = 0; c < mChunks.size(); ++c)
       {
-         openvdb::tools::GridSampler<openvdb::FloatGrid::ConstAccessor, openvdb::tools::PointSampler> sampler(mGrid->getConstAccessor(), mGrid->transform());
-         // It may not be as efficient for rendering to have one per thread, but having to lock a shared kills performance.
-         std::map<osg::Vec3, int> vectorMap;
+         mChunks[c].mFirstVert = numVerts;
+         mChunks[c].mFirstIndex = numIndices;
+         numVerts += mChunks[c].mNumVerts;
+         numIndices += mChunks[c].mNumIndices;
+      }
 
-         dtCore::RefPtr<osg::Vec3Array> vertArraySub = new osg::Vec3Array();
-         dtCore::RefPtr<osg::DrawElementsUInt> drawElementsSub = new osg::DrawElementsUInt(GL_TRIANGLES);
+      dtCore::RefPtr<osg::Geometry> geom = new osg::Geometry();
+      dtCore::RefPtr<osg::Vec3Array> vertArray = new osg::Vec3Array(numVerts);
+      dtCore::RefPtr<osg::DrawElementsUInt> drawElements = new osg::DrawElementsUInt(GL_TRIANGLES, numIndices);
 
-         int numTrisDropped = 0;
+      if (numIndices > 0U)
+      {
+         osg::Vec3* verts = &vertArray->front();
+         GLuint* indices = &drawElements->front();
 
-         //this is always 1 because the actual values are interploated from 0-1 using the iso value property now
-         const float isolevel = 1.0f;
+         ForEachChunk(mChunks, parallel, [this, verts](MeshChunk& chunk)
+         {
+            WriteChunkVertices(chunk, verts);
+         });
 
-         //reusing this improves performance by quite a bit
-         osg::Vec3 vertlist[12];
-         GRIDCELL grid;
-         TRIANGLE triangles[5];
+         // Cells use the vertices on the edges of the next slab, so all of them have to be written first.
+         ForEachChunk(mChunks, parallel, [this, verts, indices](MeshChunk& chunk)
+         {
+            WriteChunkIndices(chunk, verts, indices);
+         });
 
-         for (int k = r.cols().begin(); k < r.cols().end(); ++k)
+         // Skipped back faces leave gaps at the end of each slab's range, so close them up.
+         unsigned written = 0U;
+         for (size_t c = 0; c < mChunks.size(); ++c)
          {
-            for (int j = r.rows().begin(); j < r.rows().end(); ++j)
+            const MeshChunk& chunk = mChunks[c];
+            if (written != chunk.mFirstIndex && chunk.mIndicesWritten > 0U)
             {
-               for (int i = r.pages().begin(); i < r.pages().end(); ++i)
-               {
-                  int numTriangles = SampleSingleCell(i, j, k, sampler, triangles);
-
-                  for (int n = 0; n < numTriangles; ++n)
-                  {
-                     if (mSkipBackFaces && triangles[n].n[0].z() < 0.0 && triangles[n].n[1].z() < 0.0 && triangles[n].n[2].z() < 0.0)
-                     {
-                        //skipping triangle 
-                        ++numTrisDropped;
-                     }
-                     else
-                     {
-                        for (int i = 0; i < 3; ++i)
-                        {
-                           bool inserted = false;
-                           int index = -1;
-                           {
-                              index = HashVec3WithMap(vectorMap, triangles[n].p[i], inserted);
-                              if (inserted)
-                              {
-                                 vertArraySub->push_back(triangles[n].p[i]);
-                                 if ((vertArraySub->size() - 1) != unsigned(index))
-                                 {
-                                    printf("Error! %lu %d\n", vertArraySub->size(), index);
-                                 }
-                              }
-                           }
-
-                           drawElementsSub->addElement(index);
-
-                        }
-                     }
-                  }
-               }
+               std::copy(indices + chunk.mFirstIndex, indices + chunk.mFirstIndex + chunk.mIndicesWritten, indices + written);
             }
+            written += chunk.mIndicesWritten;
          }
-         tbb::mutex::scoped_lock sl(elemMtx);
-
-         //this seems to cause a performance bottleneck in VS2013 x64
-         vertArray->reserve(vertArray->size() + vertArraySub->size());
-
-         int startingIdx = vertArray->size();
-         vertArray->insert(vertArray->end(), vertArraySub->begin(), vertArraySub->end());
-
-         //this seems to cause a performance bottleneck in VS2013 x64
-         drawElements->reserve(drawElements->size() + drawElementsSub->size());
-
-         for (auto itr = drawElementsSub->begin(), itrEnd = drawElementsSub->end(); itr != itrEnd; ++itr)
-         {
-            drawElements->push_back((*itr) + startingIdx);
-         }
-
-         trianglesSkipped += numTrisDropped;
-         //drawElements->insert(drawElements->end(), drawElementsSub->begin(), drawElementsSub->end());
-      });
-      //std::cout << "Num Verts " << vertArray->getNumElements() << std::endl;
-
+         drawElements->resize(written);
+      }
 
       geom->setVertexArray(vertArray);
       geom->addPrimitiveSet(drawElements);
@@ -291,14 +267,18 @@ namespace dtVoxel
          //setup to use the cache next time through
          mUseCache = true;
       }
+      else
+      {
+         std::vector<float>().swap(mSamples);
+         std::vector<GLuint>().swap(mEdgeVertices);
+      }
 
       mIsDone = true;
       mTime = dtCore::Timer::Instance()->DeltaMil(startTime, dtCore::Timer::Instance()->Tick());
       LOGN_DEBUG("createmeshtask.cpp", "Time to update cell ms: " + dtUtil::ToString(mTime));
-      //LOGN_DEBUG("createmeshtask.cpp", "Num Backfaces Removed " + dtUtil::ToString(trianglesSkipped));
    }
 
-   double CreateMeshTask::SampleCoord(double x, double y, double z, openvdb::tools::GridSampler<openvdb::FloatGrid::ConstAccessor, openvdb::tools::PointSampler>& fastSampler)
+   double CreateMeshTask::SampleCoord(double x, double y, double z, SamplerType& fastSampler)
    {
       double result = (fastSampler.wsSample(openvdb::Vec3R(x, y, z)));
       
@@ -308,108 +288,211 @@ namespace dtVoxel
       return result;
    }
 
-   int CreateMeshTask::ComputeIndex(int i, int j, int k) const
+   int CreateMeshTask::ComputeSampleIndex(int i, int j, int k) const
    {
-      return (k * mResolution[1] * mResolution[0]) + (j * mResolution[0]) + i;
+      return (k * (mResolution[1] + 1) + j) * (mResolution[0] + 1) + i;
    }
 
-   int CreateMeshTask::SampleSingleCell(int i, int j, int k, openvdb::tools::GridSampler<openvdb::FloatGrid::ConstAccessor, openvdb::tools::PointSampler>& sampler, TRIANGLE* triangles)
-   {  
-      //this is always 1 because the actual values are interploated from 0-1 using the iso value property now
-      const float isolevel = 1.0f;
-
-      int index = ComputeIndex(i, j, k);
-      
-      double worldX = mOffset[0] + (i * mTexelSize[0]);
-      double worldY = mOffset[1] + (j * mTexelSize[1]);
-      double worldZ = mOffset[2] + (k * mTexelSize[2]);
-      
-      osg::Vec3 from(worldX, worldY, worldZ);
+   void CreateMeshTask::SampleChunk(const MeshChunk& chunk, bool onlyDirty)
+   {
+      // The sampler only keeps a pointer to the accessor.
+      openvdb::FloatGrid::ConstAccessor accessor = mGrid->getConstAccessor();
+      SamplerType sampler(accessor, mGrid->transform());
 
+      // A sample changes the cells around it, so read the ones up to a texel outside the bounds again too.
+      osg::BoundingBox resampleBounds(mDirtyBounds._min - mTexelSize, mDirtyBounds._max + mTexelSize);
 
-      if (mUseCache)
+      for (int k = chunk.mBeginZ; k < chunk.mEndZ; ++k)
       {
-         if (!mUseBoundingBox)
-         {         
-            LOGN_WARNING("createmeshtask.cpp", "No Bounding Box set, but task is attempting to load from cache.");
+         double worldZ = mOffset[2] + (k * mTexelSize[2]);
+         if (onlyDirty && (worldZ < resampleBounds.zMin() || worldZ > resampleBounds.zMax()))
+         {
+            continue;
          }
-         else
+
+         for (int j = 0; j <= mResolution[1]; ++j)
          {
-            osg::Vec3 origin(worldX, worldY, worldZ);
-            osg::BoundingBox cellBB(from - (mTexelSize * 1.5), from + (mTexelSize * 2.0));
-            
-            //only read the cached data if we did not modify this cell
-            if (!mDirtyBounds.intersects(cellBB))
+            double worldY = mOffset[1] + (j * mTexelSize[1]);
+            if (onlyDirty && (worldY < resampleBounds.yMin() || worldY > resampleBounds.yMax()))
             {
-               int numTriangles = mOccupancy[index];
-
-               CopyTriangleData(&(mCacheData[index].mTris[0]), triangles, numTriangles);
+               continue;
+            }
 
-               //exit out early with cached data
-               return numTriangles;
-            }            
-            else
+            float* row = &mSamples[ComputeSampleIndex(0, j, k)];
+            for (int i = 0; i <= mResolution[0]; ++i)
             {
-               //continue and regenerate cached data
+               double worldX = mOffset[0] + (i * mTexelSize[0]);
+               if (!onlyDirty || (worldX >= resampleBounds.xMin() && worldX <= resampleBounds.xMax()))
+               {
+                  row[i] = SampleCoord(worldX, worldY, worldZ, sampler);
+               }
             }
          }
       }
+   }
 
+   void CreateMeshTask::CountChunk(MeshChunk& chunk)
+   {
+      //this is always 1 because the actual values are interploated from 0-1 using the iso value property now
+      const float isolevel = 1.0f;
 
-      GRIDCELL grid;
-      osg::Vec3 vertlist[12];
-
-      grid.p[0] = from;
-      grid.val[0] = SampleCoord(grid.p[0].x(), grid.p[0].y(), grid.p[0].z(), sampler);
+      const int rx = mResolution[0], ry = mResolution[1], rz = mResolution[2];
+      unsigned numVerts = 0U, numIndices = 0U;
+      float corners[8];
 
-      grid.p[1].set(from[0] + mTexelSize[0], from[1], from[2]);
-      grid.val[1] = SampleCoord(grid.p[1].x(), grid.p[1].y(), grid.p[1].z(), sampler);
- 
-      grid.p[2].set(from[0] + mTexelSize[0], from[1] + mTexelSize[1], from[2]);
-      grid.val[2] = SampleCoord(grid.p[2].x(), grid.p[2].y(), grid.p[2].z(), sampler);
+      for (int k = chunk.mBeginZ; k < chunk.mEndZ; ++k)
+      {
+         for (int j = 0; j <= ry; ++j)
+         {
+            const float* row = &mSamples[ComputeSampleIndex(0, j, k)];
+            const float* rowY = j < ry ? &mSamples[ComputeSampleIndex(0, j + 1, k)] : NULL;
+            const float* rowZ = k < rz ? &mSamples[ComputeSampleIndex(0, j, k + 1)] : NULL;
 
-      grid.p[3].set(from[0], from[1] + mTexelSize[1], from[2]);
-      grid.val[3] = SampleCoord(grid.p[3].x(), grid.p[3].y(), grid.p[3].z(), sampler);
+            for (int i = 0; i <= rx; ++i)
+            {
+               numVerts += unsigned(i < rx && IsCrossed(row[i], row[i + 1], isolevel));
+               numVerts += unsigned(rowY != NULL && IsCrossed(row[i], rowY[i], isolevel));
+               numVerts += unsigned(rowZ != NULL && IsCrossed(row[i], rowZ[i], isolevel));
 
-      grid.p[4].set(from[0], from[1], from[2] + mTexelSize[2]);
-      grid.val[4] = SampleCoord(grid.p[4].x(), grid.p[4].y(), grid.p[4].z(), sampler);
+               if (i < rx && rowY != NULL && rowZ != NULL)
+               {
+                  for (int c = 0; c < 8; ++c)
+                  {
+                     corners[c] = mSamples[ComputeSampleIndex(i + CELL_CORNERS[c][0], j + CELL_CORNERS[c][1], k + CELL_CORNERS[c][2])];
+                  }
 
-      grid.p[5].set(from[0] + mTexelSize[0], from[1], from[2] + mTexelSize[2]);
-      grid.val[5] = SampleCoord(grid.p[5].x(), grid.p[5].y(), grid.p[5].z(), sampler);
+                  const int* edges = GetCubeTriangleEdges(ComputeCubeIndex(corners, isolevel));
+                  while (*edges != -1)
+                  {
+                     ++numIndices;
+                     ++edges;
+                  }
+               }
+            }
+         }
+      }
 
-      grid.p[6].set(from[0] + mTexelSize[0], from[1] + mTexelSize[1], from[2] + mTexelSize[2]);
-      grid.val[6] = SampleCoord(grid.p[6].x(), grid.p[6].y(), grid.p[6].z(), sampler);
+      chunk.mNumVerts = numVerts;
+      chunk.mNumIndices = numIndices;
+   }
 
-      grid.p[7].set(from[0], from[1] + mTexelSize[1], from[2] + mTexelSize[2]);
-      grid.val[7] = SampleCoord(grid.p[7].x(), grid.p[7].y(), grid.p[7].z(), sampler);
+   void CreateMeshTask::WriteChunkVertices(const MeshChunk& chunk, osg::Vec3* verts)
+   {
+      //this is always 1 because the actual values are interploated from 0-1 using the iso value property now
+      const float isolevel = 1.0f;
 
+      const int rx = mResolution[0], ry = mResolution[1], rz = mResolution[2];
+      GLuint nextVert = chunk.mFirstVert;
+      std::vector<float> t[3];
+      t[0].resize(rx + 1);
+      t[1].resize(rx + 1);
+      t[2].resize(rx + 1);
 
-      int numTriangles = PolygonizeCube(grid, isolevel, triangles, &vertlist[0]);
-      
-      if (mCacheTriangleData)
+      for (int k = chunk.mBeginZ; k < chunk.mEndZ; ++k)
       {
-         mOccupancy[index] = numTriangles;
-         
-         if (numTriangles > 0)
+         for (int j = 0; j <= ry; ++j)
          {
-            CopyTriangleData(triangles, &(mCacheData[index].mTris[0]), numTriangles);
+            const float* row = &mSamples[ComputeSampleIndex(0, j, k)];
+            const float* rowY = j < ry ? &mSamples[ComputeSampleIndex(0, j + 1, k)] : NULL;
+            const float* rowZ = k < rz ? &mSamples[ComputeSampleIndex(0, j, k + 1)] : NULL;
+
+            InterpolateEdgeRow(row, row + 1, rx, isolevel, &t[0][0]);
+            if (rowY != NULL)
+            {
+               InterpolateEdgeRow(row, rowY, rx + 1, isolevel, &t[1][0]);
+            }
+            if (rowZ != NULL)
+            {
+               InterpolateEdgeRow(row, rowZ, rx + 1, isolevel, &t[2][0]);
+            }
+
+            GLuint* edgeVerts = &mEdgeVertices[size_t(ComputeSampleIndex(0, j, k)) * 3U];
+            osg::Vec3 from(mOffset[0], mOffset[1] + (j * mTexelSize[1]), mOffset[2] + (k * mTexelSize[2]));
+
+            for (int i = 0; i <= rx; ++i, edgeVerts += 3)
+            {
+               from[0] = mOffset[0] + (i * mTexelSize[0]);
+
+               edgeVerts[0] = edgeVerts[1] = edgeVerts[2] = NO_VERTEX;
+               if (i < rx && IsCrossed(row[i], row[i + 1], isolevel))
+               {
+                  verts[nextVert].set(from[0] + t[0][i] * mTexelSize[0], from[1], from[2]);
+                  edgeVerts[0] = nextVert++;
+               }
+               if (rowY != NULL && IsCrossed(row[i], rowY[i], isolevel))
+               {
+                  verts[nextVert].set(from[0], from[1] + t[1][i] * mTexelSize[1], from[2]);
+                  edgeVerts[1] = nextVert++;
+               }
+               if (rowZ != NULL && IsCrossed(row[i], rowZ[i], isolevel))
+               {
+                  verts[nextVert].set(from[0], from[1], from[2] + t[2][i] * mTexelSize[2]);
+                  edgeVerts[2] = nextVert++;
+               }
+            }
          }
       }
-
-      return numTriangles;
    }
 
-   void CreateMeshTask::CopyTriangleData(const TRIANGLE* triData, TRIANGLE* toFill, int numTris)
+   void CreateMeshTask::WriteChunkIndices(MeshChunk& chunk, const osg::Vec3* verts, GLuint* indices)
    {
-      for (int cachedTriangle = 0; cachedTriangle < numTris; ++cachedTriangle)
+      //this is always 1 because the actual values are interploated from 0-1 using the iso value property now
+      const float isolevel = 1.0f;
+
+      GLuint* out = indices + chunk.mFirstIndex;
+      GLuint* outStart = out;
+      float corners[8];
+      GLuint cellVerts[12];
+
+      int endZ = dtUtil::Min(chunk.mEndZ, mResolution[2]);
+      for (int k = chunk.mBeginZ; k < endZ; ++k)
       {
-         for (int vertNum = 0; vertNum < 3; ++vertNum)
+         for (int j = 0; j < mResolution[1]; ++j)
          {
-            //copy the normal and position for each vertex of each triangle
-            toFill[cachedTriangle].p[vertNum].set(triData[cachedTriangle].p[vertNum]);
-            toFill[cachedTriangle].n[vertNum].set(triData[cachedTriangle].n[vertNum]);
+            for (int i = 0; i < mResolution[0]; ++i)
+            {
+               for (int c = 0; c < 8; ++c)
+               {
+                  corners[c] = mSamples[ComputeSampleIndex(i + CELL_CORNERS[c][0], j + CELL_CORNERS[c][1], k + CELL_CORNERS[c][2])];
+               }
+
+               int cubeIndex = ComputeCubeIndex(corners, isolevel);
+               if (GetCubeEdges(cubeIndex) == 0)
+               {
+                  continue;
+               }
+
+               for (int e = 0; e < 12; ++e)
+               {
+                  const int* edge = CELL_EDGES[e];
+                  cellVerts[e] = mEdgeVertices[size_t(ComputeSampleIndex(i + edge[0], j + edge[1], k + edge[2])) * 3U + edge[3]];
+               }
+
+               for (const int* edges = GetCubeTriangleEdges(cubeIndex); *edges != -1; edges += 3)
+               {
+                  GLuint a = cellVerts[edges[0]], b = cellVerts[edges[1]], c = cellVerts[edges[2]];
+
+                  if (mSkipBackFaces)
+                  {
+                     // Same winding and normal as PolygonizeCube.
+                     osg::Vec3 normal = (verts[c] - verts[a]) ^ (verts[b] - verts[a]);
+                     if (normal.z() < 0.0f)
+                     {
+                        //skipping triangle
+                        continue;
+                     }
+                  }
+
+                  out[0] = a;
+                  out[1] = b;
+                  out[2] = c;
+                  out += 3;
+               }
+            }
          }
       }
+
+      chunk.mIndicesWritten = unsigned(out - outStart);
    }
 
    void CreateMeshTask::UpdateWithBounds(const osg::BoundingBox& bb)
@@ -19,6 +19,7 @@
 
 #include <dtVoxel/voxelblock.h>
 #include <dtUtil/log.h>
+#include <dtUtil/mathdefines.h>
 #include <dtUtil/fileutils.h>
 #include <dtUtil/stringutils.h>
 #include <dtCore/project.h>
@@ -31,6 +32,7 @@
 #include <osg/PagedLOD>
 
 #include <tbb/parallel_for.h>
+#include <cmath>
 #include <iostream>
 
 namespace dtVoxel
@@ -162,7 +164,27 @@ namespace dtVoxel
       return mOffset;
    }
 
-   void VoxelBlock::CollectDirtyCells(VoxelActor& voxelActor, const osg::BoundingBox& bb, const osg::Vec3i& textureResolution, std::list<VoxelCellUpdateInfo>& dirtyCells)
+   /***
+    * Interleaves the bits of the cell coordinates of a position, 21 per axis, so positions near each other get
+    * keys near each other.
+    */
+   static unsigned long long ComputeCellKey(const osg::Vec3& pos, const osg::Vec3& cellSize)
+   {
+      unsigned long long key = 0ULL;
+      for (int axis = 0; axis < 3; ++axis)
+      {
+         // Offset so negative coordinates sort before positive ones.
+         long long coord = (long long)(std::floor(pos[axis] / cellSize[axis])) + (1LL << 20);
+         unsigned long long bits = (unsigned long long)(dtUtil::Max(0LL, dtUtil::Min(coord, (1LL << 21) - 1LL)));
+         for (int bit = 0; bit < 21; ++bit)
+         {
+            key |= ((bits >> bit) & 1ULL) << (bit * 3 + axis);
+         }
+      }
+      return key;
+   }
+
+   void VoxelBlock::CollectDirtyCells(VoxelActor& voxelActor, const osg::BoundingBox& bb, const osg::Vec3i& textureResolution, VoxelCellUpdateMap& dirtyCells)
    {
       osg::BoundingBox bounds(mOffset, mOffset + mWSDimensions);
 
@@ -213,14 +235,21 @@ namespace dtVoxel
                                  updateInfo.mCell = vc;
                                  updateInfo.mNodeToUpdate = fv.mFoundNode;
                                  updateInfo.mCellIndex.set(x, y, z);
+                                 updateInfo.mCenter.set(mOffset[0] + (x + 0.5f) * mWSCellDimensions[0],
+                                                        mOffset[1] + (y + 0.5f) * mWSCellDimensions[1],
+                                                        mOffset[2] + (z + 0.5f) * mWSCellDimensions[2]);
                                  updateInfo.mStarted = false;
                                  updateInfo.mLODNode = fv.mLOD;
 
-                                 vc->SetDirty(true);
-
                                  //std::cout << "Adding nodes to dirty cells" << std::endl;
 
-                                 dirtyCells.push_back(updateInfo);
+                                 // Never replace an entry that is already there.  Its task may have started, and
+                                 // UpdateGrid has to regenerate the cell that task was started for.  If this cell
+                                 // isn't added, it stays clean so a later change collects it again.
+                                 if (dirtyCells.insert(std::make_pair(ComputeCellKey(updateInfo.mCenter, mWSCellDimensions), updateInfo)).second)
+                                 {
+                                    vc->SetDirty(true);
+                                 }
                               }
 
                               osg::Vec3 pos(x * mWSCellDimensions[0], y * mWSCellDimensions[1], z * mWSCellDimensions[2]);
@@ -28,6 +28,7 @@
 #include <osg/PagedLOD>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range3d.h>
 
@@ -178,12 +179,12 @@ namespace dtVoxel
 
       //std::cout << "UpdateGrid " << mDirtyCells.size() << " dirty cells." << std::endl;
 
-      std::list<VoxelCellUpdateInfo>::iterator iter = mDirtyCells.begin();
-      std::list<VoxelCellUpdateInfo>::iterator iterEnd = mDirtyCells.end();
+      VoxelCellUpdateMap::iterator iter = mDirtyCells.begin();
+      VoxelCellUpdateMap::iterator iterEnd = mDirtyCells.end();
 
       for (; iter != iterEnd;)
       {
-         VoxelCellUpdateInfo& updateInfo = *iter;
+         VoxelCellUpdateInfo& updateInfo = iter->second;
 
          if (updateInfo.mStarted && updateInfo.mCell->CheckTaskStatus())
          {
@@ -201,10 +202,18 @@ namespace dtVoxel
 
    void VoxelGrid::BeginNewUpdates(const osg::Vec3& newCameraPos, unsigned maxCellsToUpdate, bool allowBackgroundThreading)
    {
+      // Start the cells nearest the camera first so the changes the player can see show up first.
+      mUpdateOrder.clear();
+      for (auto iter = mDirtyCells.begin(); iter != mDirtyCells.end(); ++iter)
+      {
+         mUpdateOrder.push_back(std::make_pair((iter->second.mCenter - newCameraPos).length2(), &iter->second));
+      }
+      std::sort(mUpdateOrder.begin(), mUpdateOrder.end());
+
       unsigned runCount = maxCellsToUpdate;
-      for (auto iter = mDirtyCells.begin(); runCount > 0 && iter != mDirtyCells.end(); ++iter)
+      for (auto iter = mUpdateOrder.begin(); runCount > 0 && iter != mUpdateOrder.end(); ++iter)
       {
-         VoxelCellUpdateInfo& updateInfo = *iter;
+         VoxelCellUpdateInfo& updateInfo = *iter->second;
          if (updateInfo.mCell->RunTask(allowBackgroundThreading))
          {
             updateInfo.mStarted = true;
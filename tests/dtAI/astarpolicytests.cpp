@@ -0,0 +1,312 @@
+/* -*-c++-*-
+ * allTests - This source file (.h & .cpp) - Using 'The MIT License'
+ * Copyright (C) 2006-2008, MOVES Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtAI/astar.h>
+#include <dtAI/astarnode.h>
+#include <dtAI/astarcostfunc.h>
+#include <dtAI/astarpolicy.h>
+#include <dtAI/astarwaypointutils.h>
+
+#include <dtCore/timer.h>
+#include <dtUtil/log.h>
+#include <dtUtil/stringutils.h>
+
+#include <cstdlib>
+#include <list>
+#include <vector>
+
+namespace dtTest
+{
+   /**
+    * A square grid with walls.  Every 8th column is a wall with a one cell gap, alternating between
+    * the top and the bottom row, so the shortest path snakes through the whole grid and the search
+    * has to expand most of it.
+    */
+   class TestGrid
+   {
+   public:
+      TestGrid(unsigned width)
+         : mWidth(width)
+         , mBlocked(width * width, false)
+      {
+         for (unsigned x = 7; x < width - 1; x += 8)
+         {
+            unsigned gapY = ((x / 8) % 2 == 0) ? width - 1 : 0;
+            for (unsigned y = 0; y < width; ++y)
+            {
+               mBlocked[y * width + x] = (y != gapY);
+            }
+         }
+      }
+
+      unsigned GetWidth() const { return mWidth; }
+      unsigned GetCellCount() const { return mWidth * mWidth; }
+      bool IsBlocked(unsigned cell) const { return mBlocked[cell]; }
+
+      void GetNeighbors(unsigned cell, unsigned* neighborsOut, unsigned& countOut) const
+      {
+         unsigned x = cell % mWidth;
+         unsigned y = cell / mWidth;
+         countOut = 0;
+         if (x > 0 && !mBlocked[cell - 1]) { neighborsOut[countOut++] = cell - 1; }
+         if (x + 1 < mWidth && !mBlocked[cell + 1]) { neighborsOut[countOut++] = cell + 1; }
+         if (y > 0 && !mBlocked[cell - mWidth]) { neighborsOut[countOut++] = cell - mWidth; }
+         if (y + 1 < mWidth && !mBlocked[cell + mWidth]) { neighborsOut[countOut++] = cell + mWidth; }
+      }
+
+      static TestGrid* sGrid;
+
+   private:
+      unsigned mWidth;
+      std::vector<bool> mBlocked;
+   };
+
+   TestGrid* TestGrid::sGrid = NULL;
+
+   class GridNode: public dtAI::AStarNode<GridNode, unsigned, const unsigned*, float>
+   {
+   public:
+      GridNode(node_type* pParent, unsigned pData, cost_type pGn, cost_type pHn)
+         : BaseType(pParent, pData, pGn, pHn)
+         , mNeighborCount(0)
+      {
+         TestGrid::sGrid->GetNeighbors(pData, mNeighbors, mNeighborCount);
+      }
+
+      /*virtual*/ iterator begin() const { return mNeighbors; }
+      /*virtual*/ iterator end() const { return mNeighbors + mNeighborCount; }
+
+   private:
+      unsigned mNeighbors[4];
+      unsigned mNeighborCount;
+   };
+
+   /// Manhattan distance, which is also the cost of a step between neighbors.
+   class GridCostFunc: public dtAI::AStarCostFunc<unsigned, float>
+   {
+   public:
+      float operator()(unsigned pFrom, unsigned pTo) const
+      {
+         unsigned width = TestGrid::sGrid->GetWidth();
+         int dx = int(pFrom % width) - int(pTo % width);
+         int dy = int(pFrom / width) - int(pTo / width);
+         return float(std::abs(dx) + std::abs(dy));
+      }
+   };
+
+   typedef std::list<unsigned> GridPath;
+   typedef dtAI::AStar<GridNode, GridCostFunc, GridPath, dtAI::AStarTimer> DefaultGridAStar;
+   typedef dtAI::AStar<GridNode, GridCostFunc, GridPath, dtAI::AStarTimer, dtAI::AStarIndexedPolicy<> > IndexedGridAStar;
+
+   ////////////////////////////////////////////////////////////////////////////////
+   class AStarPolicyTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(AStarPolicyTests);
+      CPPUNIT_TEST(TestHashTable);
+      CPPUNIT_TEST(TestIndexedOpenList);
+      CPPUNIT_TEST(TestIndexedMatchesDefault);
+      CPPUNIT_TEST(TestIndexedReuse);
+      //CPPUNIT_TEST(TestPerformance); //disabled - just used for benchmarking
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void tearDown()
+      {
+         delete TestGrid::sGrid;
+         TestGrid::sGrid = NULL;
+      }
+
+      void TestHashTable()
+      {
+         dtAI::AStarHashTable<unsigned, unsigned, dtAI::AStarDataHash> table;
+         CPPUNIT_ASSERT(table.Find(3U) == NULL);
+
+         // enough to make it grow a few times
+         for (unsigned i = 0; i < 1000; ++i)
+         {
+            table.Set(i * 7U, i);
+         }
+         CPPUNIT_ASSERT_EQUAL(size_t(1000), table.size());
+         for (unsigned i = 0; i < 1000; ++i)
+         {
+            unsigned* value = table.Find(i * 7U);
+            CPPUNIT_ASSERT(value != NULL);
+            CPPUNIT_ASSERT_EQUAL(i, *value);
+         }
+         CPPUNIT_ASSERT(table.Find(1U) == NULL);
+
+         table.Set(14U, 99U);
+         CPPUNIT_ASSERT_EQUAL(size_t(1000), table.size());
+         CPPUNIT_ASSERT_EQUAL(99U, *table.Find(14U));
+
+         table.Clear();
+         CPPUNIT_ASSERT_EQUAL(size_t(0), table.size());
+         CPPUNIT_ASSERT(table.Find(14U) == NULL);
+
+         table.Set(14U, 1U);
+         CPPUNIT_ASSERT_EQUAL(1U, *table.Find(14U));
+         CPPUNIT_ASSERT(table.Find(21U) == NULL);
+
+         dtAI::AStarDataHash hash;
+         CPPUNIT_ASSERT_EQUAL(hash(0.0f), hash(-0.0f));
+      }
+
+      void TestIndexedOpenList()
+      {
+         TestGrid::sGrid = new TestGrid(16);
+
+         dtAI::AStarNodePool<GridNode> pool;
+         dtAI::AStarIndexedOpenList<GridNode, dtAI::AStarDataHash> open;
+
+         for (unsigned i = 0; i < 20; ++i)
+         {
+            open.Push(pool.Create(NULL, i, float((i * 7) % 20), 0.0f));
+         }
+         CPPUNIT_ASSERT_EQUAL(size_t(20), open.size());
+
+         // decrease-key on data 5, which costs 15
+         GridNode* five = open.Find(5);
+         CPPUNIT_ASSERT(five != NULL);
+         open.Replace(five, pool.Create(NULL, 5, -1.0f, 0.0f));
+
+         // pushing a more expensive duplicate keeps the cheap node
+         open.Push(pool.Create(NULL, 5, 50.0f, 0.0f));
+         CPPUNIT_ASSERT_EQUAL(size_t(20), open.size());
+
+         GridNode* first = open.Pop();
+         CPPUNIT_ASSERT_EQUAL(5U, first->GetData());
+         CPPUNIT_ASSERT(open.Find(5) == NULL);
+
+         float lastCost = -1.0f;
+         while (!open.empty())
+         {
+            GridNode* node = open.Pop();
+            CPPUNIT_ASSERT(node->GetCostToNode() >= lastCost);
+            lastCost = node->GetCostToNode();
+         }
+         CPPUNIT_ASSERT(open.Pop() == NULL);
+
+         pool.Clear();
+      }
+
+      void TestIndexedMatchesDefault()
+      {
+         TestGrid::sGrid = new TestGrid(40);
+         unsigned start = 0;
+         unsigned goal = TestGrid::sGrid->GetCellCount() - 1;
+
+         DefaultGridAStar defaultAStar;
+         defaultAStar.Reset(start, goal);
+         CPPUNIT_ASSERT_EQUAL(dtAI::PATH_FOUND, defaultAStar.FindPath());
+
+         IndexedGridAStar indexedAStar;
+         indexedAStar.Reset(start, goal);
+         CPPUNIT_ASSERT_EQUAL(dtAI::PATH_FOUND, indexedAStar.FindPath());
+
+         CheckPath(indexedAStar.GetPath(), start, goal);
+         CPPUNIT_ASSERT_EQUAL(defaultAStar.GetPath().size(), indexedAStar.GetPath().size());
+         CPPUNIT_ASSERT_EQUAL(defaultAStar.GetConfig().mTotalCost, indexedAStar.GetConfig().mTotalCost);
+
+         // a wall cell can't be reached
+         indexedAStar.Reset(start, 7);
+         CPPUNIT_ASSERT_EQUAL(dtAI::NO_PATH, indexedAStar.FindPath());
+      }
+
+      void TestIndexedReuse()
+      {
+         TestGrid::sGrid = new TestGrid(40);
+         unsigned goal = TestGrid::sGrid->GetCellCount() - 1;
+
+         // The pool and tables are kept between searches, so the same search must give the same answer.
+         IndexedGridAStar indexedAStar;
+         indexedAStar.Reset(0, goal);
+         CPPUNIT_ASSERT_EQUAL(dtAI::PATH_FOUND, indexedAStar.FindPath());
+         GridPath firstPath = indexedAStar.GetPath();
+
+         indexedAStar.Reset(goal, 0);
+         CPPUNIT_ASSERT_EQUAL(dtAI::PATH_FOUND, indexedAStar.FindPath());
+         CPPUNIT_ASSERT_EQUAL(firstPath.size(), indexedAStar.GetPath().size());
+
+         indexedAStar.Reset(0, goal);
+         CPPUNIT_ASSERT_EQUAL(dtAI::PATH_FOUND, indexedAStar.FindPath());
+         CPPUNIT_ASSERT(firstPath == indexedAStar.GetPath());
+
+         // partial paths continue from where they stopped
+         indexedAStar.Reset(0, goal);
+         indexedAStar.GetConfig().mMaxNodesExplored = 50;
+         CPPUNIT_ASSERT_EQUAL(dtAI::PARTIAL_PATH, indexedAStar.FindPath());
+      }
+
+      void TestPerformance()
+      {
+         // 10k, 100k and 1M cells
+         const unsigned widths[] = { 100, 317, 1000 };
+
+         dtCore::Timer timer;
+         for (unsigned i = 0; i < sizeof(widths) / sizeof(widths[0]); ++i)
+         {
+            delete TestGrid::sGrid;
+            TestGrid::sGrid = new TestGrid(widths[i]);
+            unsigned goal = TestGrid::sGrid->GetCellCount() - 1;
+
+            IndexedGridAStar indexedAStar;
+            indexedAStar.Reset(0, goal);
+            dtCore::Timer_t startTime = timer.Tick();
+            CPPUNIT_ASSERT_EQUAL(dtAI::PATH_FOUND, indexedAStar.FindPath());
+            double indexedMs = timer.DeltaMil(startTime, timer.Tick());
+            CheckPath(indexedAStar.GetPath(), 0, goal);
+
+            DefaultGridAStar defaultAStar;
+            defaultAStar.Reset(0, goal);
+            startTime = timer.Tick();
+            CPPUNIT_ASSERT_EQUAL(dtAI::PATH_FOUND, defaultAStar.FindPath());
+            double defaultMs = timer.DeltaMil(startTime, timer.Tick());
+            CPPUNIT_ASSERT_EQUAL(defaultAStar.GetConfig().mTotalCost, indexedAStar.GetConfig().mTotalCost);
+
+            LOG_INFO("AStar on " + dtUtil::ToString(TestGrid::sGrid->GetCellCount()) + " cells, "
+               + dtUtil::ToString(indexedAStar.GetConfig().mTotalNodesExplored) + " nodes explored: indexed policy "
+               + dtUtil::ToString(indexedMs) + " ms, default policy " + dtUtil::ToString(defaultMs) + " ms");
+         }
+      }
+
+   private:
+      void CheckPath(const GridPath& path, unsigned start, unsigned goal)
+      {
+         CPPUNIT_ASSERT(!path.empty());
+         CPPUNIT_ASSERT_EQUAL(start, path.front());
+         CPPUNIT_ASSERT_EQUAL(goal, path.back());
+
+         GridCostFunc cost;
+         GridPath::const_iterator previous = path.begin();
+         for (GridPath::const_iterator i = ++path.begin(); i != path.end(); ++i, ++previous)
+         {
+            CPPUNIT_ASSERT(!TestGrid::sGrid->IsBlocked(*i));
+            CPPUNIT_ASSERT_EQUAL(1.0f, cost(*previous, *i));
+         }
+      }
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(AStarPolicyTests);
+}
@@ -95,6 +95,7 @@
 
 #include <cstdio>
 #include <ctime>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -113,6 +114,7 @@ class MapTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST(TestIsMapFileValid);
    CPPUNIT_TEST(TestLoadMapIntoScene);
    CPPUNIT_TEST(TestMapSaveAndLoad);
+   CPPUNIT_TEST(TestMapSaveAndLoadBinary);
    CPPUNIT_TEST(TestMapSaveAndLoadEvents);
    CPPUNIT_TEST(TestMapSaveAndLoadGroup);
    CPPUNIT_TEST(TestMapSaveAndLoadPropertyContainerProperty);
@@ -144,6 +146,7 @@ public:
    void TestMapLibraryHandling();
    void TestMapEventsModified();
    void TestMapSaveAndLoad();
+   void TestMapSaveAndLoadBinary();
    void TestMapSaveAndLoadEvents();
    void TestMapSaveAndLoadGroup();
    void TestMapSaveAndLoadPropertyContainerProperty();
@@ -265,6 +268,8 @@ void MapTests::tearDown()
    dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
    bool shouldPopDir;
 
+   dtCore::Project::GetInstance().SetSaveMapsAsBinary(false);
+
    std::string currentDir = fileUtils.CurrentDirectory();
    std::string projectDir("dtCore");
    shouldPopDir = currentDir.substr(currentDir.size() - projectDir.size()) == projectDir;
@@ -1323,6 +1328,100 @@ void MapTests::TestMapSaveAndLoad()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////
+void MapTests::TestMapSaveAndLoadBinary()
+{
+   dtCore::Project& project = dtCore::Project::GetInstance();
+   project.SetSaveMapsAsBinary(true);
+
+   try
+   {
+      const std::string mapName("Neato Map");
+      const std::string mapFileName("neatomap");
+
+      dtCore::ActorFactory::GetInstance().LoadActorRegistry(mExampleLibraryName);
+
+      dtCore::Map* map = &project.CreateMap(mapName, mapFileName);
+      map->AddLibrary(mExampleLibraryName, "1.0");
+      map->SetDescription("Saved in the binary format.");
+
+      dtCore::RefPtr<dtCore::GameEvent> gameEvent = new dtCore::GameEvent("binaryEvent", "Test Description");
+      map->GetEventManager().AddEvent(*gameEvent);
+
+      dtCore::RefPtr<dtCore::BaseActorObject> first = dtCore::ActorFactory::GetInstance().CreateActor(*ExampleActorLib::TEST_ACTOR_PROPERTY_TYPE.get());
+      dtCore::RefPtr<dtCore::BaseActorObject> second = dtCore::ActorFactory::GetInstance().CreateActor(*ExampleActorLib::TEST_ACTOR_PROPERTY_TYPE.get());
+      first->SetName("first");
+      second->SetName("second");
+      map->AddProxy(*first);
+      map->AddProxy(*second);
+
+      GetActorProperty<dtCore::StringActorProperty>(*first, dtCore::DataType::STRING)->SetValue("binary < & > string");
+      GetActorProperty<dtCore::FloatActorProperty>(*first, dtCore::DataType::FLOAT)->SetValue(12345.12345f);
+      GetActorProperty<dtCore::DoubleActorProperty>(*first, dtCore::DataType::DOUBLE)->SetValue(12345.54321);
+      GetActorProperty<dtCore::IntActorProperty>(*first, dtCore::DataType::INT)->SetValue(-123345);
+      GetActorProperty<dtCore::Vec3dActorProperty>(*first, dtCore::DataType::VEC3D)->SetValue(osg::Vec3d(1.5, 2.5, 3.5));
+      GetActorProperty<dtCore::ColorRgbaActorProperty>(*first, dtCore::DataType::RGBACOLOR)->SetValue(osg::Vec4(0.1f, 0.2f, 0.3f, 0.4f));
+      GetActorProperty<dtCore::BitMaskActorProperty>(*first, dtCore::DataType::BIT_MASK)->SetValue(0xFF00FF00);
+      GetActorProperty<dtCore::ResourceActorProperty>(*first, dtCore::DataType::SOUND)->SetValue(dtCore::ResourceDescriptor("test", "somethingelse"));
+      GetActorProperty<dtCore::ActorIDActorProperty>(*first, dtCore::DataType::ACTOR)->SetValue(second->GetId());
+
+      // Snapshot every property so the binary load can be compared to what was saved.
+      std::map<std::string, std::string> expectedValues;
+      std::vector<dtCore::ActorProperty*> props;
+      first->GetPropertyList(props);
+      for (size_t i = 0; i < props.size(); ++i)
+      {
+         expectedValues[props[i]->GetName()] = props[i]->ToString();
+      }
+
+      const dtCore::UniqueId firstId = first->GetId();
+      first = NULL;
+      second = NULL;
+
+      project.SaveMap(*map);
+
+      // The writer should produce a file the parser recognizes as binary.
+      const std::string binaryFile("binarytest.dtmap");
+      dtCore::RefPtr<dtCore::MapWriter> writer = new dtCore::MapWriter();
+      writer->SetBinary(true);
+      writer->Save(*map, binaryFile);
+      CPPUNIT_ASSERT(dtCore::MapBinaryParser::IsBinaryMap(binaryFile));
+      dtUtil::FileUtils::GetInstance().FileDelete(binaryFile);
+
+      project.CloseMap(*map, true);
+      map = NULL;
+
+      map = &project.GetMap(mapName);
+      CPPUNIT_ASSERT_EQUAL(std::string("Saved in the binary format."), map->GetDescription());
+      CPPUNIT_ASSERT_EQUAL(2U, unsigned(map->GetAllProxies().size()));
+      CPPUNIT_ASSERT(map->GetEventManager().FindEvent(gameEvent->GetUniqueId()) != NULL);
+
+      dtCore::BaseActorObject* loaded = map->GetProxyById(firstId);
+      CPPUNIT_ASSERT(loaded != NULL);
+      CPPUNIT_ASSERT_EQUAL(std::string("first"), loaded->GetName());
+
+      props.clear();
+      loaded->GetPropertyList(props);
+      for (size_t i = 0; i < props.size(); ++i)
+      {
+         if (props[i]->IsReadOnly())
+         {
+            continue;
+         }
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Property " + props[i]->GetName() + " should survive the binary round trip.",
+                  expectedValues[props[i]->GetName()], props[i]->ToString());
+      }
+
+      project.DeleteMap(*map, true);
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      project.SetSaveMapsAsBinary(false);
+      CPPUNIT_FAIL((std::string("Error: ") + e.What()).c_str());
+   }
+   project.SetSaveMapsAsBinary(false);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 void MapTests::TestMapSaveAndLoadEvents()
 {
@@ -54,6 +54,8 @@
 // project.
 #include <dtCore/resourceactorproperty.h>
 
+#include <osgDB/FileNameUtils>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 namespace dtCore
@@ -797,6 +799,35 @@ void ProjectTests::TestResources()
       CPPUNIT_ASSERT_EQUAL(testResult, testResultUpper);
 #endif
 
+      CPPUNIT_ASSERT(p.GetResourcePathCacheEnabled());
+      unsigned cacheHits = p.GetResourcePathCacheHits();
+      unsigned cacheMisses = p.GetResourcePathCacheMisses();
+      CPPUNIT_ASSERT_EQUAL(expectedPath, p.GetResourcePath(rd));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("A repeated lookup should come from the cache.", cacheHits + 1U, p.GetResourcePathCacheHits());
+      CPPUNIT_ASSERT_EQUAL(cacheMisses, p.GetResourcePathCacheMisses());
+
+      p.RefreshResourcePathCache();
+      CPPUNIT_ASSERT_EQUAL(expectedPath, p.GetResourcePath(rd));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("A lookup after a refresh should search the contexts.", cacheMisses + 1U, p.GetResourcePathCacheMisses());
+
+      // A file copied into the context by something else isn't in the index, but it should still be found.
+      std::string copiedPath = osgDB::getFilePath(expectedPath) + dtUtil::FileUtils::PATH_SEPARATOR + "flatdirtcopy.ive";
+      std::string copiedId = rd.GetResourceIdentifier();
+      copiedId.replace(copiedId.rfind("flatdirt.ive"), std::string("flatdirt.ive").size(), "flatdirtcopy.ive");
+      fileUtils.FileCopy(expectedPath, copiedPath, true);
+      CPPUNIT_ASSERT_EQUAL(copiedPath, p.GetResourcePath(dtCore::ResourceDescriptor(copiedId)));
+      fileUtils.FileDelete(copiedPath);
+      p.RefreshResourcePathCache();
+      CPPUNIT_ASSERT_THROW(p.GetResourcePath(dtCore::ResourceDescriptor(copiedId)),
+            dtCore::ProjectFileNotFoundException);
+
+      p.SetResourcePathCacheEnabled(false);
+      cacheHits = p.GetResourcePathCacheHits();
+      CPPUNIT_ASSERT_EQUAL(expectedPath, p.GetResourcePath(rd));
+      CPPUNIT_ASSERT_EQUAL(expectedPath, p.GetResourcePath(rd));
+      CPPUNIT_ASSERT_EQUAL(cacheHits, p.GetResourcePathCacheHits());
+      p.SetResourcePathCacheEnabled(true);
+
       for (std::set<std::string>::const_iterator i = mapNames.begin(); i != mapNames.end(); i++)
       {
          logger->LogMessage(dtUtil::Log::LOG_DEBUG, __FUNCTION__,  __LINE__, "Found map named %s.", i->c_str());
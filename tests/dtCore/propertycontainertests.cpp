@@ -114,6 +114,7 @@ namespace dtCore
       CPPUNIT_TEST(TestPropertyMetaDataDefaults);
       CPPUNIT_TEST(TestPropertyCopy);
       CPPUNIT_TEST(TestPropertyCopyMetaData);
+      CPPUNIT_TEST(TestPropertySchema);
       CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -202,6 +203,47 @@ namespace dtCore
          CPPUNIT_ASSERT(!boolProp2->GetSendInFullUpdate());
          CPPUNIT_ASSERT(boolProp2->GetSendInPartialUpdate());
       }
+
+      void TestPropertySchema()
+      {
+         TestPCPtr pc1 = new TestPropertyContainer;
+         TestPCPtr pc2 = new TestPropertyContainer;
+
+         CPPUNIT_ASSERT(pc1->GetPropertySchema() != nullptr);
+         CPPUNIT_ASSERT_EQUAL(pc1->GetNumProperties(), pc1->GetPropertySchema()->GetNumProperties());
+         CPPUNIT_ASSERT_EQUAL(1, pc1->GetPropertyIndex("Int"));
+         CPPUNIT_ASSERT(pc1->GetPropertyByIndex(1) == pc1->GetProperty("Int"));
+         CPPUNIT_ASSERT_EQUAL(-1, pc1->GetPropertyIndex("NotAProperty"));
+         CPPUNIT_ASSERT(pc1->GetPropertyByIndex(pc1->GetNumProperties()) == nullptr);
+
+         // Once built, containers of the same type with the same properties share one schema.
+         pc1->InitDefaults();
+         pc2->InitDefaults();
+         CPPUNIT_ASSERT(pc1->GetPropertySchema() == pc2->GetPropertySchema());
+         CPPUNIT_ASSERT(pc1->GetPropertySchema()->IsShared());
+         CPPUNIT_ASSERT_EQUAL(5, pc2->GetPropertyIndex("String"));
+         CPPUNIT_ASSERT(pc2->GetPropertyByIndex(5) == pc2->GetProperty("String"));
+
+         // Changing the properties of one container must not change the shared schema.
+         PropertyPtr boolProp = pc2->GetProperty("Bool");
+         pc2->RemoveProperty("Bool");
+         CPPUNIT_ASSERT(pc2->GetProperty("Bool") == nullptr);
+         CPPUNIT_ASSERT(pc1->GetPropertySchema() != pc2->GetPropertySchema());
+         CPPUNIT_ASSERT_EQUAL(0, pc2->GetPropertyIndex("Int"));
+         CPPUNIT_ASSERT_EQUAL(1, pc1->GetPropertyIndex("Int"));
+
+         pc2->AddProperty(boolProp.get());
+         CPPUNIT_ASSERT_EQUAL(int(pc2->GetNumProperties()) - 1, pc2->GetPropertyIndex("Bool"));
+         CPPUNIT_ASSERT(pc2->GetProperty("Bool") == boolProp.get());
+         CPPUNIT_ASSERT_EQUAL(0, pc1->GetPropertyIndex("Bool"));
+
+         // Copying by name still works when the schemas differ.
+         pc1->SetBool(true);
+         pc1->SetInt(21);
+         pc2->CopyPropertiesFrom(*pc1);
+         CPPUNIT_ASSERT_EQUAL(true, pc2->GetBool());
+         CPPUNIT_ASSERT_EQUAL(21, pc2->GetInt());
+      }
    private:
    };
 
@@ -66,6 +66,8 @@ class TransformableTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST(TestGetTransformNotInScene);
    CPPUNIT_TEST(TestGetTransformFromInactiveTransformable);
    CPPUNIT_TEST(TestGetTransformFromInactiveParent);
+   CPPUNIT_TEST(TestCachedAbsoluteMatrix);
+   CPPUNIT_TEST(TestGetAbsoluteMatrices);
    CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -95,6 +97,8 @@ public:
    void TestGetTransformNotInScene();
    void TestGetTransformFromInactiveTransformable();
    void TestGetTransformFromInactiveParent();
+   void TestCachedAbsoluteMatrix();
+   void TestGetAbsoluteMatrices();
 
 private:
    bool CompareMatrix(const osg::Matrix& rhs, const osg::Matrix& lhs) const;
@@ -680,3 +684,100 @@ void TransformableTests::TestGetTransformFromInactiveParent()
       dtUtil::Equivalent(childStartXYZ+parentStartXYZ, endXform.GetTranslation(), TEST_EPSILON));
 }
 
+void TransformableTests::TestCachedAbsoluteMatrix()
+{
+   using namespace dtCore;
+   RefPtr<Transformable> parent = new Transformable("parent");
+   RefPtr<Transformable> child = new Transformable("child");
+   RefPtr<Transformable> grandChild = new Transformable("grandChild");
+   parent->AddChild(child.get());
+   child->AddChild(grandChild.get());
+
+   CPPUNIT_ASSERT(!grandChild->GetCacheAbsoluteMatrix());
+   child->SetCacheAbsoluteMatrix(true);
+   grandChild->SetCacheAbsoluteMatrix(true);
+   CPPUNIT_ASSERT(grandChild->GetCacheAbsoluteMatrix());
+
+   parent->SetTransform(mTransform);
+   Transform childXform;
+   childXform.Set(1.0f, 2.0f, 3.0f, 45.0f, 0.0f, 0.0f);
+   child->SetTransform(childXform, Transformable::REL_CS);
+   grandChild->SetTransform(childXform, Transformable::REL_CS);
+
+   osg::Matrix expected, cached;
+   Transformable::GetAbsoluteMatrix(grandChild->GetOSGNode(), expected);
+   grandChild->GetAbsoluteMatrix(cached);
+   CPPUNIT_ASSERT(CompareMatrix(expected, cached));
+
+   // Moving the top parent must reach the cache two levels down.
+   Transform moved;
+   moved.Set(-5.0f, 7.0f, 11.0f, 0.0f, 10.0f, 0.0f);
+   parent->SetTransform(moved);
+   Transformable::GetAbsoluteMatrix(grandChild->GetOSGNode(), expected);
+   grandChild->GetAbsoluteMatrix(cached);
+   CPPUNIT_ASSERT(CompareMatrix(expected, cached));
+
+   Transform absXform;
+   grandChild->GetTransform(absXform, Transformable::ABS_CS);
+   osg::Matrix absMatrix;
+   absXform.Get(absMatrix);
+   CPPUNIT_ASSERT(CompareMatrix(expected, absMatrix));
+
+   // Changes made behind the Transformable's back show up on the next cache frame.
+   osg::Matrix stale = cached;
+   parent->GetMatrixNode()->setMatrix(osg::Matrix::translate(100.0f, 0.0f, 0.0f));
+   grandChild->GetAbsoluteMatrix(cached);
+   CPPUNIT_ASSERT(CompareMatrix(stale, cached));
+
+   Transformable::AdvanceAbsoluteMatrixCacheFrame();
+   Transformable::GetAbsoluteMatrix(grandChild->GetOSGNode(), expected);
+   grandChild->GetAbsoluteMatrix(cached);
+   CPPUNIT_ASSERT(CompareMatrix(expected, cached));
+   CPPUNIT_ASSERT(!CompareMatrix(stale, cached));
+
+   // Reparenting clears the cache too.
+   child->RemoveChild(grandChild.get());
+   grandChild->GetAbsoluteMatrix(cached);
+   CPPUNIT_ASSERT(CompareMatrix(grandChild->GetMatrix(), cached));
+}
+
+void TransformableTests::TestGetAbsoluteMatrices()
+{
+   using namespace dtCore;
+   std::vector<RefPtr<Transformable> > parents;
+   std::vector<Transformable*> xformables;
+
+   for (unsigned i = 0; i < 5; ++i)
+   {
+      RefPtr<Transformable> parent = new Transformable("parent");
+      Transform xform;
+      xform.Set(float(i), 2.0f * float(i), -1.0f, 15.0f * float(i), 0.0f, 5.0f);
+      parent->SetTransform(xform);
+      parents.push_back(parent);
+
+      for (unsigned j = 0; j < 10; ++j)
+      {
+         RefPtr<Transformable> child = new Transformable("child");
+         parent->AddChild(child.get());
+         xform.Set(float(j), 0.0f, 1.0f, 0.0f, 3.0f * float(j), 0.0f);
+         child->SetTransform(xform, Transformable::REL_CS);
+         child->SetCacheAbsoluteMatrix(j % 2 == 0);
+         xformables.push_back(child.get());
+      }
+      xformables.push_back(parent.get());
+   }
+
+   std::vector<osg::Matrix> matrices;
+   Transformable::GetAbsoluteMatrices(xformables, matrices);
+   CPPUNIT_ASSERT_EQUAL(xformables.size(), matrices.size());
+
+   for (unsigned i = 0; i < xformables.size(); ++i)
+   {
+      osg::Matrix expected, single;
+      Transformable::GetAbsoluteMatrix(xformables[i]->GetOSGNode(), expected);
+      CPPUNIT_ASSERT(CompareMatrix(expected, matrices[i]));
+
+      xformables[i]->GetAbsoluteMatrix(single);
+      CPPUNIT_ASSERT(CompareMatrix(expected, single));
+   }
+}
@@ -0,0 +1,283 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtCore/uniqueid.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/stringutils.h>
+#include <OpenThreads/Thread>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace dtCore
+{
+   /// Creates, copies and drops text ids over and over, so their entries are freed and interned again.
+   class TextIdThread : public OpenThreads::Thread
+   {
+   public:
+      TextIdThread(const std::vector<std::string>& texts, unsigned passes)
+      : mTexts(texts)
+      , mPasses(passes)
+      , mMismatches(0U)
+      {
+      }
+
+      virtual void run()
+      {
+         for (unsigned pass = 0; pass < mPasses; ++pass)
+         {
+            for (size_t i = 0; i < mTexts.size(); ++i)
+            {
+               UniqueId id(mTexts[i]);
+               UniqueId copy(id);
+               if (copy.ToString() != mTexts[i] || copy < id || id < copy)
+               {
+                  ++mMismatches;
+               }
+            }
+         }
+      }
+
+      const std::vector<std::string>& mTexts;
+      unsigned mPasses;
+      unsigned mMismatches;
+   };
+
+   class UniqueIdTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(UniqueIdTests);
+         CPPUNIT_TEST(TestGenerate);
+         CPPUNIT_TEST(TestTextRoundTrip);
+         CPPUNIT_TEST(TestOrdering);
+         CPPUNIT_TEST(TestBytes);
+         CPPUNIT_TEST(TestDataStream);
+         CPPUNIT_TEST(TestTextLifetime);
+         CPPUNIT_TEST(TestConcurrentTextIds);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void TestGenerate()
+      {
+         CPPUNIT_ASSERT_EQUAL(size_t(UniqueId::BYTE_COUNT), sizeof(UniqueId));
+
+         UniqueId nullId(false);
+         CPPUNIT_ASSERT(nullId.IsNull());
+         CPPUNIT_ASSERT(nullId.ToString().empty());
+         CPPUNIT_ASSERT(nullId == UniqueId(""));
+
+         UniqueId id1, id2;
+         CPPUNIT_ASSERT(!id1.IsNull());
+         CPPUNIT_ASSERT(id1 != id2);
+
+         // New ids are canonical, so they are binary.
+         unsigned char bytes[UniqueId::BYTE_COUNT];
+         CPPUNIT_ASSERT(id1.ToBytes(bytes));
+         CPPUNIT_ASSERT_EQUAL(size_t(36), id1.ToString().size());
+         CPPUNIT_ASSERT(UniqueId(id1.ToString()) == id1);
+      }
+
+      void TestTextRoundTrip()
+      {
+         const std::string texts[] =
+         {
+            "0123abcd-4567-89ef-0123-456789abcdef",
+            "0123ABCD-4567-89EF-0123-456789ABCDEF",
+            "00000000-0000-0000-0123-456789abcdef",
+            "taguniqueid",
+            "tag:12"
+         };
+
+         for (unsigned i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+         {
+            UniqueId id(texts[i]);
+            CPPUNIT_ASSERT_EQUAL(texts[i], id.ToString());
+            CPPUNIT_ASSERT(id == UniqueId(texts[i].c_str()));
+            CPPUNIT_ASSERT_EQUAL(dtUtil::hash<UniqueId>()(id), dtUtil::hash<UniqueId>()(UniqueId(texts[i])));
+
+            UniqueId assigned(false);
+            assigned = texts[i];
+            CPPUNIT_ASSERT(assigned == id);
+         }
+
+         CPPUNIT_ASSERT_MESSAGE("Ids that differ in case were different ids before, so they still must be.",
+                  UniqueId(texts[0]) != UniqueId(texts[1]));
+      }
+
+      void TestOrdering()
+      {
+         // Sorted the way their text sorts, whether they are binary or kept as text.
+         const std::string texts[] =
+         {
+            "",
+            "0123ABCD-4567-89EF-0123-456789ABCDEF",
+            "0123abcd-4567-89ef-0123-456789abcdef",
+            "0123abcd-4567-89ef-0123-456789abcdf0",
+            "8123abcd-4567-89ef-0123-456789abcdef",
+            "host",
+            "ABC"
+         };
+         const unsigned count = sizeof(texts) / sizeof(texts[0]);
+
+         std::set<UniqueId> ids;
+         std::set<std::string> sortedTexts;
+         for (unsigned i = 0; i < count; ++i)
+         {
+            ids.insert(UniqueId(texts[i]));
+            sortedTexts.insert(texts[i]);
+         }
+         CPPUNIT_ASSERT_EQUAL(size_t(count), ids.size());
+
+         std::set<std::string>::const_iterator text = sortedTexts.begin();
+         for (std::set<UniqueId>::const_iterator i = ids.begin(); i != ids.end(); ++i, ++text)
+         {
+            CPPUNIT_ASSERT_EQUAL(*text, i->ToString());
+         }
+
+         UniqueId a(texts[2]), b(texts[3]);
+         CPPUNIT_ASSERT(a < b && b > a && !(b < a) && !(a < a));
+      }
+
+      void TestBytes()
+      {
+         unsigned char bytes[UniqueId::BYTE_COUNT];
+         UniqueId canonical(std::string("0123abcd-4567-89ef-0123-456789abcdef"));
+         CPPUNIT_ASSERT(canonical.ToBytes(bytes));
+         CPPUNIT_ASSERT_EQUAL(0x01, int(bytes[0]));
+         CPPUNIT_ASSERT_EQUAL(0xef, int(bytes[15]));
+
+         UniqueId result(false);
+         result.FromBytes(bytes);
+         CPPUNIT_ASSERT(canonical == result);
+
+         CPPUNIT_ASSERT(!UniqueId(std::string("0123ABCD-4567-89EF-0123-456789ABCDEF")).ToBytes(bytes));
+         CPPUNIT_ASSERT(!UniqueId(std::string("hostname")).ToBytes(bytes));
+         CPPUNIT_ASSERT(!UniqueId(false).ToBytes(bytes));
+
+         // The first 8 bytes being 0 is stored differently, but must still act like a uuid.
+         unsigned char lowOnly[UniqueId::BYTE_COUNT] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+         result.FromBytes(lowOnly);
+         CPPUNIT_ASSERT(!result.IsNull());
+         CPPUNIT_ASSERT_EQUAL(std::string("00000000-0000-0000-0102-030405060708"), result.ToString());
+         CPPUNIT_ASSERT(result.ToBytes(bytes));
+         CPPUNIT_ASSERT(std::equal(lowOnly, lowOnly + UniqueId::BYTE_COUNT, bytes));
+      }
+
+      void TestDataStream()
+      {
+         UniqueId ids[] =
+         {
+            UniqueId(),
+            UniqueId(std::string("0123ABCD-4567-89EF-0123-456789ABCDEF")),
+            UniqueId(std::string("some host")),
+            UniqueId(false),
+            // Strings whose length is 128 mod 256 start with 0x80 when written little endian.
+            UniqueId(std::string(128, 'a')),
+            UniqueId(std::string(384, 'b'))
+         };
+         const unsigned count = sizeof(ids) / sizeof(ids[0]);
+
+         dtUtil::DataStream ds;
+         for (unsigned i = 0; i < count; ++i)
+         {
+            ds << ids[i];
+            WriteCompactUniqueId(ds, ids[i]);
+         }
+
+         // The text form is what older versions wrote, so it has to stay the same.
+         dtUtil::DataStream textCheck;
+         textCheck << ids[0].ToString();
+         CPPUNIT_ASSERT(std::equal(textCheck.GetBuffer(), textCheck.GetBuffer() + textCheck.GetBufferSize(), ds.GetBuffer()));
+
+         for (unsigned i = 0; i < count; ++i)
+         {
+            UniqueId text(false), compact(false);
+            ds >> text >> compact;
+            CPPUNIT_ASSERT(ids[i] == text);
+            CPPUNIT_ASSERT(ids[i] == compact);
+         }
+         CPPUNIT_ASSERT_EQUAL(0U, ds.GetRemainingReadSize());
+
+         dtUtil::DataStream sizeCheck;
+         WriteCompactUniqueId(sizeCheck, ids[0]);
+         CPPUNIT_ASSERT_EQUAL(UniqueId::BYTE_COUNT + 2U, sizeCheck.GetBufferSize());
+      }
+
+      void TestTextLifetime()
+      {
+         UniqueId copy(false);
+         {
+            UniqueId original(std::string("released host"));
+            copy = original;
+            UniqueId copied(original);
+            CPPUNIT_ASSERT(copied == original);
+         }
+         // The copy keeps the text alive after the id it came from is gone.
+         CPPUNIT_ASSERT_EQUAL(std::string("released host"), copy.ToString());
+
+         UniqueId other(std::string("other host"));
+         copy = other;
+         UniqueId& alias = copy;
+         copy = alias;
+         CPPUNIT_ASSERT_EQUAL(std::string("other host"), copy.ToString());
+
+         // Once nothing holds a text, its slot is reused without mixing the texts up.
+         UniqueId reused(std::string("new host"));
+         CPPUNIT_ASSERT_EQUAL(std::string("new host"), reused.ToString());
+         CPPUNIT_ASSERT(reused != copy);
+         CPPUNIT_ASSERT(UniqueId(std::string("released host")).ToString() == "released host");
+
+         copy.FromBytes(reinterpret_cast<const unsigned char*>("0123456789abcdef"));
+         CPPUNIT_ASSERT_EQUAL(std::string("other host"), other.ToString());
+      }
+
+      void TestConcurrentTextIds()
+      {
+         std::vector<std::string> texts;
+         for (unsigned i = 0; i < 20; ++i)
+         {
+            texts.push_back("shared host " + dtUtil::ToString(i));
+         }
+
+         std::vector<TextIdThread*> threads;
+         for (unsigned i = 0; i < 4; ++i)
+         {
+            threads.push_back(new TextIdThread(texts, 200U));
+            threads.back()->start();
+         }
+         for (unsigned i = 0; i < threads.size(); ++i)
+         {
+            threads[i]->join();
+            CPPUNIT_ASSERT_EQUAL(0U, threads[i]->mMismatches);
+            delete threads[i];
+         }
+
+         for (size_t i = 0; i < texts.size(); ++i)
+         {
+            CPPUNIT_ASSERT_EQUAL(texts[i], UniqueId(texts[i]).ToString());
+         }
+      }
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(UniqueIdTests);
+}
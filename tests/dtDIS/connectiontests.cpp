@@ -23,11 +23,17 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <dtDIS/connection.h>
+#include <dtDIS/packetring.h>
+#include <dtDIS/packetreceiver.h>
 #include <DIS/DataStream.h>
 
 #include <dtCore/timer.h>
+#include <dtUtil/log.h>
 
 #include <cstdlib>  // for NULL
+#include <algorithm>
+#include <sstream>
+#include <vector>
 
 
 namespace dtDIS
@@ -40,10 +46,33 @@ namespace dtDIS
       void teardown(); 
 
       void TestConnection();
+      void TestPacketRing();
+      void TestLoopbackReceiveModes();
+      void TestLoopbackLoad();
 
       CPPUNIT_TEST_SUITE( ConnectionTests );
          CPPUNIT_TEST( TestConnection );
+         CPPUNIT_TEST( TestPacketRing );
+         CPPUNIT_TEST( TestLoopbackReceiveModes );
+         //CPPUNIT_TEST( TestLoopbackLoad ); //disabled - just used for benchmarking
       CPPUNIT_TEST_SUITE_END();
+
+   private:
+      /// the ways a frame can take data off the socket.
+      enum ReceiveMode
+      {
+         ONE_READ_PER_FRAME,
+         DRAIN_PER_FRAME,
+         RECEIVE_THREAD
+      };
+
+      /// sends numPackets PDU sized datagrams to itself in frames of packetsPerFrame, reading them as it goes.
+      /// @param logResults true to log the loss and the rate.
+      void RunLoopbackLoad(ReceiveMode mode, unsigned numPackets, unsigned packetsPerFrame, bool logResults);
+
+      /// reads what a frame would read in the given mode and counts the sequence numbers.
+      void ReceiveFrame(ReceiveMode mode, dtDIS::PacketReceiver& receiver, dtDIS::PacketRing& ring,
+                        unsigned& received, unsigned& outOfOrder, unsigned& nextSequence);
    };
 
 }
@@ -103,3 +132,151 @@ void ConnectionTests::TestConnection()
    discon.Disconnect();
 }
 
+void ConnectionTests::TestPacketRing()
+{
+   dtDIS::PacketRing ring(5, 16);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("The capacity should round up to a power of two.", 8U, ring.GetCapacity());
+   CPPUNIT_ASSERT_EQUAL(size_t(16), ring.GetPacketSize());
+
+   size_t numbytes(99);
+   CPPUNIT_ASSERT(ring.BeginRead(numbytes) == NULL);
+   CPPUNIT_ASSERT_EQUAL(size_t(0), numbytes);
+
+   // go around the ring a few times so the counts wrap the buffer.
+   for (unsigned pass = 0; pass < 3; ++pass)
+   {
+      for (unsigned i = 0; i < ring.GetCapacity(); ++i)
+      {
+         char* buffer = ring.BeginWrite();
+         CPPUNIT_ASSERT(buffer != NULL);
+         buffer[0] = char(pass * 10 + i);
+         ring.EndWrite(i + 1);
+      }
+      CPPUNIT_ASSERT_MESSAGE("A full ring should not give out a buffer.", ring.BeginWrite() == NULL);
+      CPPUNIT_ASSERT_EQUAL(ring.GetCapacity(), ring.GetSize());
+
+      for (unsigned i = 0; i < ring.GetCapacity(); ++i)
+      {
+         const char* buffer = ring.BeginRead(numbytes);
+         CPPUNIT_ASSERT(buffer != NULL);
+         CPPUNIT_ASSERT_EQUAL(size_t(i + 1), numbytes);
+         CPPUNIT_ASSERT_EQUAL(char(pass * 10 + i), buffer[0]);
+         ring.EndRead();
+      }
+      CPPUNIT_ASSERT_EQUAL(0U, ring.GetSize());
+      CPPUNIT_ASSERT(ring.BeginRead(numbytes) == NULL);
+   }
+}
+
+void ConnectionTests::TestLoopbackReceiveModes()
+{
+   const unsigned numPackets(200);
+   const unsigned packetsPerFrame(20);
+
+   RunLoopbackLoad(ONE_READ_PER_FRAME, numPackets, packetsPerFrame, false);
+   RunLoopbackLoad(DRAIN_PER_FRAME, numPackets, packetsPerFrame, false);
+   RunLoopbackLoad(RECEIVE_THREAD, numPackets, packetsPerFrame, false);
+}
+
+void ConnectionTests::TestLoopbackLoad()
+{
+   // A busy exercise sends a few thousand entity states a second, and a frame is ~16ms.
+   const unsigned numPackets(20000);
+   const unsigned packetsPerFrame(100);
+
+   RunLoopbackLoad(ONE_READ_PER_FRAME, numPackets, packetsPerFrame, true);
+   RunLoopbackLoad(DRAIN_PER_FRAME, numPackets, packetsPerFrame, true);
+   RunLoopbackLoad(RECEIVE_THREAD, numPackets, packetsPerFrame, true);
+}
+
+void ConnectionTests::RunLoopbackLoad(ReceiveMode mode, unsigned numPackets, unsigned packetsPerFrame, bool logResults)
+{
+   unsigned int inport( 1259 );
+   std::string host("234.235.236.237");
+   DIS::Endian endian(DIS::BIG);
+   const unsigned int mtu(1500);
+   // the size of an entity state PDU without articulations.
+   const unsigned int pduSize(144);
+
+   dtDIS::Connection discon;
+   discon.Connect(inport, host.c_str(), false);
+
+   dtDIS::PacketRing ring(1024, mtu);
+   dtDIS::PacketReceiver receiver(discon, ring);
+   if (mode == RECEIVE_THREAD)
+   {
+      receiver.start();
+   }
+
+   unsigned received(0), outOfOrder(0), nextSequence(0);
+   std::vector<char> pdu(pduSize, 0);
+
+   dtCore::Timer timer;
+   dtCore::Timer_t start = timer.Tick();
+
+   for (unsigned sent = 0; sent < numPackets; )
+   {
+      // one frame worth of outgoing traffic.
+      for (unsigned i = 0; i < packetsPerFrame && sent < numPackets; ++i, ++sent)
+      {
+         DIS::DataStream outbuf(endian);
+         outbuf << sent;
+         std::copy(&outbuf[0], &outbuf[0] + outbuf.size(), pdu.begin());
+         discon.Send(&pdu[0], pdu.size());
+      }
+
+      ReceiveFrame(mode, receiver, ring, received, outOfOrder, nextSequence);
+   }
+
+   // give the last datagrams time to arrive, then run one more frame.
+   dtCore::AppSleep(100);
+   ReceiveFrame(mode, receiver, ring, received, outOfOrder, nextSequence);
+
+   double seconds = timer.DeltaSec(start, timer.Tick());
+   receiver.Stop();
+   discon.Disconnect();
+
+   if (logResults)
+   {
+      static const char* const MODE_NAMES[] = { "one read per frame", "drain per frame", "receive thread" };
+      std::ostringstream ss;
+      ss << "DIS loopback with " << MODE_NAMES[mode] << ": sent " << numPackets << " PDUs in "
+         << (numPackets + packetsPerFrame - 1) / packetsPerFrame << " frames, received " << received
+         << " (" << (numPackets - received) * 100.0 / numPackets << "% lost, "
+         << receiver.GetDroppedCount() << " dropped by a full ring, " << outOfOrder << " out of order) in "
+         << seconds << " seconds, " << received / seconds << " PDUs per second.";
+      LOG_INFO(ss.str());
+   }
+
+   CPPUNIT_ASSERT_MESSAGE("Nothing was read. Check your firewall settings.", received > 0);
+   CPPUNIT_ASSERT(received + receiver.GetDroppedCount() <= numPackets);
+}
+
+void ConnectionTests::ReceiveFrame(ReceiveMode mode, dtDIS::PacketReceiver& receiver, dtDIS::PacketRing& ring,
+                                   unsigned& received, unsigned& outOfOrder, unsigned& nextSequence)
+{
+   if (mode == ONE_READ_PER_FRAME)
+   {
+      receiver.Drain(1);
+   }
+   else if (mode == DRAIN_PER_FRAME)
+   {
+      receiver.Drain(ring.GetCapacity());
+   }
+
+   size_t numbytes(0);
+   for (const char* buffer = ring.BeginRead(numbytes); buffer != NULL; buffer = ring.BeginRead(numbytes))
+   {
+      DIS::DataStream inbuf(DIS::BIG);
+      inbuf.SetStream(buffer, numbytes, DIS::BIG);
+      unsigned sequence(0);
+      inbuf >> sequence;
+      if (sequence < nextSequence)
+      {
+         ++outOfOrder;
+      }
+      nextSequence = sequence + 1;
+      ++received;
+      ring.EndRead();
+   }
+}
@@ -0,0 +1,144 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtGame/asynclogstreamwriter.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace dtGame
+{
+   class AsyncLogStreamWriterTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(AsyncLogStreamWriterTests);
+         CPPUNIT_TEST(TestWriteOnThread);
+         CPPUNIT_TEST(TestWriteWithoutThread);
+         CPPUNIT_TEST(TestWriteError);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp()
+      {
+         mFile = tmpfile();
+         CPPUNIT_ASSERT(mFile != NULL);
+      }
+
+      void tearDown()
+      {
+         if (mFile != NULL)
+         {
+            fclose(mFile);
+            mFile = NULL;
+         }
+      }
+
+      void TestWriteOnThread()
+      {
+         const char prefix[] = "HEAD";
+         fwrite(prefix, 1, 4, mFile);
+
+         // Small buffers, so the ring fills and wraps many times, and some records are bigger than a buffer.
+         AsyncLogStreamWriter writer(mFile, 3, 64);
+         CPPUNIT_ASSERT_EQUAL(4L, writer.GetFileOffset());
+         writer.start();
+
+         std::string expected(prefix, 4);
+         for (unsigned i = 0; i < 2000; ++i)
+         {
+            std::string header(1 + i % 7, char('a' + i % 26));
+            std::string body(i % 10 == 0 ? 150 : i % 13, char('0' + i % 10));
+            CPPUNIT_ASSERT(writer.Write(header.data(), header.size(), body.data(), body.size()));
+            expected += header;
+            expected += body;
+         }
+         CPPUNIT_ASSERT_EQUAL(long(expected.size()), writer.GetFileOffset());
+
+         writer.Stop();
+         CPPUNIT_ASSERT(!writer.HasError());
+         CPPUNIT_ASSERT_EQUAL(0U, writer.GetNumPendingBuffers());
+         CPPUNIT_ASSERT_EQUAL(0U, writer.GetDroppedCount());
+         CPPUNIT_ASSERT_EQUAL(expected, ReadFile());
+      }
+
+      void TestWriteWithoutThread()
+      {
+         AsyncLogStreamWriter writer(mFile, 2, 16);
+         // Without the thread, full buffers are written on the calling thread, so nothing is dropped.
+         writer.SetDropWhenFull(true);
+
+         std::string expected;
+         for (unsigned i = 0; i < 100; ++i)
+         {
+            std::string record(5, char('A' + i % 26));
+            CPPUNIT_ASSERT(writer.Write(record.data(), record.size()));
+            expected += record;
+         }
+         writer.Flush();
+         CPPUNIT_ASSERT_EQUAL(0U, writer.GetDroppedCount());
+         CPPUNIT_ASSERT_EQUAL(expected, ReadFile());
+      }
+
+      void TestWriteError()
+      {
+         fclose(mFile);
+         std::string fileName = "asynclogstreamwritertest.tmp";
+         mFile = fopen(fileName.c_str(), "wb");
+         CPPUNIT_ASSERT(mFile != NULL);
+         fclose(mFile);
+         // Read only, so writing fails.
+         mFile = fopen(fileName.c_str(), "rb");
+         CPPUNIT_ASSERT(mFile != NULL);
+
+         AsyncLogStreamWriter writer(mFile, 2, 16);
+         writer.start();
+         const std::string record(40, 'x');
+         writer.Write(record.data(), record.size());
+         writer.Flush();
+         CPPUNIT_ASSERT(writer.HasError());
+         CPPUNIT_ASSERT(!writer.GetError().empty());
+         CPPUNIT_ASSERT_MESSAGE("Writing should stop once it fails.", !writer.Write(record.data(), record.size()));
+         writer.Stop();
+
+         fclose(mFile);
+         mFile = NULL;
+         remove(fileName.c_str());
+      }
+
+   private:
+      std::string ReadFile()
+      {
+         fflush(mFile);
+         fseek(mFile, 0L, SEEK_END);
+         long size = ftell(mFile);
+         fseek(mFile, 0L, SEEK_SET);
+         std::vector<char> contents(size_t(size) + 1);
+         size_t numRead = fread(&contents[0], 1, size_t(size), mFile);
+         return std::string(&contents[0], numRead);
+      }
+
+      FILE* mFile;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(AsyncLogStreamWriterTests);
+}
@@ -58,6 +58,7 @@
 #include <dtCore/actortype.h>
 
 #include <dtActors/engineactorregistry.h>
+#include <dtUtil/threadpool.h>
 
 #include "basegmtests.h"
 
@@ -148,6 +149,7 @@ namespace dtGame
          CPPUNIT_TEST(TestActorRegistration);
          CPPUNIT_TEST(TestSimpleBehaviorLocal);
          CPPUNIT_TEST(TestSimpleBehaviorRemote);
+         CPPUNIT_TEST(TestManyRemoteActorsOnThreadPool);
          CPPUNIT_TEST(TestSmoothingStepsCalc);
          CPPUNIT_TEST(TestSmoothingStepsCalcFastUpdate);
          CPPUNIT_TEST(TestDRArticulationStopCounts);
@@ -712,6 +714,67 @@ namespace dtGame
             TestSimpleBehavior(true);
          }
 
+         void TestManyRemoteActorsOnThreadPool()
+         {
+            bool initializedPool = false;
+            if (!dtUtil::ThreadPool::IsInitialized())
+            {
+               dtUtil::ThreadPool::Init();
+               initializedPool = true;
+            }
+
+            // Enough to be split into tasks.
+            const unsigned numActors = 3 * DeadReckoningComponent::MIN_ACTORS_PER_TASK + 5;
+            std::vector<dtCore::RefPtr<GameActorProxy> > actors;
+            std::vector<dtCore::RefPtr<DeadReckoningActorComponent> > helpers;
+            for (unsigned i = 0; i < numActors; ++i)
+            {
+               dtCore::RefPtr<GameActorProxy> actor;
+               mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, actor);
+               CPPUNIT_ASSERT(actor.valid());
+
+               dtCore::RefPtr<DeadReckoningActorComponent> helper = new DeadReckoningActorComponent;
+               helper->SetDeadReckoningAlgorithm(DeadReckoningAlgorithm::STATIC);
+               helper->SetGroundClampType(dtGame::GroundClampTypeEnum::NONE);
+               helper->SetLastKnownTranslation(osg::Vec3(float(i), 2.0f * float(i), 10.0f));
+
+               mGM->AddActor(*actor, true, false);
+               mDeadReckoningComponent->RegisterActor(*actor, *helper);
+               actors.push_back(actor);
+               helpers.push_back(helper);
+            }
+
+            // Unregistering one has to drop it from the next tick without disturbing the rest.
+            mDeadReckoningComponent->UnregisterActor(*actors.back());
+            helpers.back()->SetLastKnownTranslation(osg::Vec3(-1.0f, -1.0f, -1.0f));
+
+            dtCore::System::GetInstance().Step();
+
+            dtCore::Transform xform;
+            osg::Vec3 pos;
+            for (unsigned i = 0; i < numActors; ++i)
+            {
+               actors[i]->GetDrawable<dtCore::Transformable>()->GetTransform(xform);
+               xform.GetTranslation(pos);
+               osg::Vec3 expected(float(i), 2.0f * float(i), 10.0f);
+               if (i == numActors - 1)
+               {
+                  expected.set(0.0f, 0.0f, 0.0f);
+               }
+
+               std::ostringstream ss;
+               ss << "Actor " << i << " should be at " << expected << " but it is at " << pos;
+               CPPUNIT_ASSERT_MESSAGE(ss.str(), dtUtil::Equivalent(pos, expected, 1e-3f));
+               CPPUNIT_ASSERT_MESSAGE("The updated flag should be cleared on the registered actors.",
+                        i == numActors - 1 || !helpers[i]->IsUpdated());
+            }
+
+            if (initializedPool)
+            {
+               dtUtil::ThreadPool::Shutdown();
+            }
+         }
+
          void TestSmoothingStepsCalc()
          {
             dtCore::RefPtr<DeadReckoningActorComponent> helper = new DeadReckoningActorComponent;
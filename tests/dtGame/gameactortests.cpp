@@ -93,6 +93,9 @@ class GameActorTests : public dtGame::BaseGMTestFixture
       CPPUNIT_TEST(TestActorIsInGM);
       CPPUNIT_TEST(TestOnRemovedActor);
       CPPUNIT_TEST(TestUnregisterNextInvokable);
+      CPPUNIT_TEST(TestListenerChangesDuringMessage);
+      CPPUNIT_TEST(TestListenerDispatch);
+      //CPPUNIT_TEST(TestListenerDispatchPerformance); //disabled - just used for benchmarking
       CPPUNIT_TEST(TestFullUpdateFlags);
       CPPUNIT_TEST(TestPartialUpdateFlags);
 
@@ -115,10 +118,14 @@ public:
    void TestActorIsInGM();
    void TestOnRemovedActor();
    void TestUnregisterNextInvokable();
+   void TestListenerChangesDuringMessage();
+   void TestListenerDispatch();
+   void TestListenerDispatchPerformance();
    void TestFullUpdateFlags();
    void TestPartialUpdateFlags();
 
 private:
+   void RunListenerDispatch(unsigned numActors, unsigned numSteps, bool logResults);
 };
 
 
@@ -1106,3 +1113,158 @@ void GameActorTests::TestUnregisterNextInvokable()
 
    dtCore::System::GetInstance().Step();
 }
+
+namespace
+{
+   /// Counts the messages sent to an invokable, and can unregister another listener on the first one.
+   class MessageCounter
+   {
+   public:
+      MessageCounter()
+      : mCount(0U)
+      , mGM(NULL)
+      , mActorToUnregister(NULL)
+      {}
+
+      void Count(const dtGame::Message& message)
+      {
+         ++mCount;
+         if (mActorToUnregister != NULL)
+         {
+            mGM->UnregisterForMessagesAboutActor(message.GetMessageType(), message.GetAboutActorId(),
+                     *mActorToUnregister, "Count");
+            mActorToUnregister = NULL;
+         }
+      }
+
+      unsigned mCount;
+      dtGame::GameManager* mGM;
+      dtGame::GameActorProxy* mActorToUnregister;
+   };
+}
+
+//////////////////////////////////////////////////////
+void GameActorTests::TestListenerChangesDuringMessage()
+{
+   dtCore::RefPtr<dtGame::GameActorProxy> gap1, gap2, target;
+   mGM->CreateActor("ExampleActors", "Test1Actor", gap1);
+   mGM->CreateActor("ExampleActors", "Test1Actor", gap2);
+   mGM->CreateActor("ExampleActors", "Test1Actor", target);
+   mGM->AddActor(*gap1, false, false);
+   mGM->AddActor(*gap2, false, false);
+   mGM->AddActor(*target, false, false);
+
+   MessageCounter counter1, counter2, counter3;
+   counter1.mGM = mGM.get();
+   counter1.mActorToUnregister = gap2.get();
+   gap1->AddInvokable(*new dtGame::Invokable("Count", dtUtil::MakeFunctor(&MessageCounter::Count, &counter1)));
+   gap2->AddInvokable(*new dtGame::Invokable("Count", dtUtil::MakeFunctor(&MessageCounter::Count, &counter2)));
+
+   mGM->RegisterForMessagesAboutActor(dtGame::MessageType::INFO_TIMER_ELAPSED, target->GetId(), *gap1, "Count");
+   mGM->RegisterForMessagesAboutActor(dtGame::MessageType::INFO_TIMER_ELAPSED, target->GetId(), *gap2, "Count");
+
+   dtCore::RefPtr<dtGame::Message> message = mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED);
+   message->SetAboutActorId(target->GetId());
+
+   mGM->SendMessage(*message);
+   dtCore::System::GetInstance().Step(0.016);
+
+   CPPUNIT_ASSERT_EQUAL(1U, counter1.mCount);
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("A listener unregistered by an earlier one for the same message should not get it.",
+            0U, counter2.mCount);
+
+   std::vector<std::pair<dtGame::GameActorProxy*, std::string> > toFill;
+   mGM->GetRegistrantsForMessagesAboutActor(dtGame::MessageType::INFO_TIMER_ELAPSED, target->GetId(), toFill);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), toFill.size());
+   CPPUNIT_ASSERT(toFill[0].first == gap1.get());
+
+   // Replacing the invokable with one of the same name should send to the new one.
+   gap1->RemoveInvokable("Count");
+   gap1->AddInvokable(*new dtGame::Invokable("Count", dtUtil::MakeFunctor(&MessageCounter::Count, &counter3)));
+
+   mGM->SendMessage(*message);
+   dtCore::System::GetInstance().Step(0.016);
+
+   CPPUNIT_ASSERT_EQUAL(1U, counter1.mCount);
+   CPPUNIT_ASSERT_EQUAL(1U, counter3.mCount);
+
+   // And removing it should stop the messages even though the listener is still registered.
+   gap1->RemoveInvokable("Count");
+
+   mGM->SendMessage(*message);
+   dtCore::System::GetInstance().Step(0.016);
+
+   CPPUNIT_ASSERT_EQUAL(1U, counter3.mCount);
+
+   mGM->UnregisterAllMessageListenersForActor(*gap1);
+   mGM->GetRegistrantsForMessagesAboutActor(dtGame::MessageType::INFO_TIMER_ELAPSED, target->GetId(), toFill);
+   CPPUNIT_ASSERT(toFill.empty());
+}
+
+//////////////////////////////////////////////////////
+void GameActorTests::TestListenerDispatch()
+{
+   RunListenerDispatch(100U, 3U, false);
+}
+
+//////////////////////////////////////////////////////
+void GameActorTests::TestListenerDispatchPerformance()
+{
+   RunListenerDispatch(10000U, 10U, true);
+}
+
+//////////////////////////////////////////////////////
+void GameActorTests::RunListenerDispatch(unsigned numActors, unsigned numSteps, bool logResults)
+{
+   std::vector<dtCore::RefPtr<dtGame::GameActorProxy> > actors(numActors);
+   std::vector<MessageCounter> counters(numActors);
+   for (unsigned i = 0; i < numActors; ++i)
+   {
+      mGM->CreateActor("ExampleActors", "Test1Actor", actors[i]);
+      mGM->AddActor(*actors[i], false, false);
+      actors[i]->AddInvokable(*new dtGame::Invokable("Count", dtUtil::MakeFunctor(&MessageCounter::Count, &counters[i])));
+   }
+
+   // Each actor listens to messages about the next one.
+   std::vector<dtCore::RefPtr<dtGame::Message> > messages(numActors);
+   for (unsigned i = 0; i < numActors; ++i)
+   {
+      const dtCore::UniqueId& aboutId = actors[(i + 1) % numActors]->GetId();
+      mGM->RegisterForMessagesAboutActor(dtGame::MessageType::INFO_TIMER_ELAPSED, aboutId, *actors[i], "Count");
+      messages[i] = mGM->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED);
+      messages[i]->SetAboutActorId(aboutId);
+   }
+
+   dtCore::System::GetInstance().Step(0.016);
+
+   dtCore::Timer timer;
+   dtCore::Timer_t start = timer.Tick();
+   for (unsigned step = 0; step < numSteps; ++step)
+   {
+      for (unsigned i = 0; i < numActors; ++i)
+      {
+         mGM->SendMessage(*messages[i]);
+      }
+      dtCore::System::GetInstance().Step(0.016);
+   }
+   double seconds = timer.DeltaSec(start, timer.Tick());
+
+   for (unsigned i = 0; i < numActors; ++i)
+   {
+      CPPUNIT_ASSERT_EQUAL(numSteps, counters[i].mCount);
+   }
+
+   if (logResults)
+   {
+      std::ostringstream ss;
+      ss << "Listener dispatch for " << numActors << " actors: " << numActors * numSteps << " messages in "
+         << seconds << " seconds, " << double(numActors * numSteps) / seconds << " messages per second, including ticks.";
+      LOG_INFO(ss.str());
+   }
+
+   for (unsigned i = 0; i < numActors; ++i)
+   {
+      mGM->DeleteActor(*actors[i]);
+   }
+   dtCore::System::GetInstance().Step(0.016);
+}
@@ -50,6 +50,8 @@
 #include <dtCore/map.h>
 #include <dtCore/project.h>
 #include <dtCore/resourcedescriptor.h>
+#include <dtCore/transform.h>
+#include <dtCore/transformable.h>
 
 #include <dtGame/actorupdatemessage.h>
 #include <dtGame/basemessages.h>
@@ -76,6 +78,7 @@
 #include <osg/io_utils>
 #include <osg/Math>
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -86,6 +89,7 @@ class GameManagerTests : public dtGame::BaseGMTestFixture
         CPPUNIT_TEST(TestFindActorByType);
         CPPUNIT_TEST(TestFindActorByWrongType);
         CPPUNIT_TEST(TestFindActorByName);
+        CPPUNIT_TEST(TestFindActorsInRadius);
 
         CPPUNIT_TEST(TestDataStream);
 
@@ -108,6 +112,7 @@ class GameManagerTests : public dtGame::BaseGMTestFixture
         CPPUNIT_TEST(TestPrototypeActors);
         CPPUNIT_TEST(TestGMShutdown);
         CPPUNIT_TEST(TestGMSettingsServerClientRoles);
+        CPPUNIT_TEST(TestGMSettingsMessagePools);
         CPPUNIT_TEST(TestOpenCloseAdditionalMaps);
 
         CPPUNIT_TEST(TestBatchAdd);
@@ -129,6 +134,7 @@ public:
    void TestFindActorByType();
    void TestFindActorByWrongType();
    void TestFindActorByName();
+   void TestFindActorsInRadius();
 
    void TestDataStream();
 
@@ -152,6 +158,7 @@ public:
    void TestPrototypeActors();
    void TestGMShutdown();
    void TestGMSettingsServerClientRoles();
+   void TestGMSettingsMessagePools();
    void TestOpenCloseAdditionalMaps();
 
    void TestBatchAdd();
@@ -316,6 +323,78 @@ void GameManagerTests::TestFindActorByName()
    }
 }
 
+/////////////////////////////////////////////////
+void GameManagerTests::TestFindActorsInRadius()
+{
+   // Ten actors in a row along x, 10 apart.
+   std::vector<dtCore::RefPtr<dtActors::GameMeshActor> > actors;
+   for (unsigned i = 0; i < 10; ++i)
+   {
+      dtCore::RefPtr<dtActors::GameMeshActor> p;
+      mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, p);
+      CPPUNIT_ASSERT(p != NULL);
+
+      dtCore::Transform xform;
+      xform.SetTranslation(osg::Vec3(float(i) * 10.0f, 0.0f, 0.0f));
+      p->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+
+      mGM->AddActor(*p, false, false);
+      actors.push_back(p);
+   }
+
+   // Actors without a transformable drawable are never found.
+   dtCore::RefPtr<dtActors::TaskActorGameEventProxy> testEventProxy;
+   mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_EVENT_TASK_ACTOR_TYPE, testEventProxy);
+   mGM->AddActor(*testEventProxy, false, false);
+
+   dtCore::ActorPtrVector found;
+   mGM->FindActorsInRadius(osg::Vec3(20.0f, 0.0f, 0.0f), 10.5f, found);
+   CPPUNIT_ASSERT_EQUAL(size_t(3), found.size());
+   CPPUNIT_ASSERT(std::find(found.begin(), found.end(), actors[1].get()) != found.end());
+   CPPUNIT_ASSERT(std::find(found.begin(), found.end(), actors[2].get()) != found.end());
+   CPPUNIT_ASSERT(std::find(found.begin(), found.end(), actors[3].get()) != found.end());
+
+   mGM->FindActorsInBox(osg::BoundingBox(-1.0f, -1.0f, -1.0f, 15.0f, 1.0f, 1.0f), found);
+   CPPUNIT_ASSERT_EQUAL(size_t(2), found.size());
+
+   mGM->FindNearestActors(osg::Vec3(1000.0f, 0.0f, 0.0f), 2U, found);
+   CPPUNIT_ASSERT_EQUAL(size_t(2), found.size());
+   CPPUNIT_ASSERT(found[0] == actors[9].get());
+   CPPUNIT_ASSERT(found[1] == actors[8].get());
+
+   // Moves are picked up by the next query.
+   dtCore::Transform xform;
+   xform.SetTranslation(osg::Vec3(2000.0f, 0.0f, 0.0f));
+   actors[0]->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+   mGM->FindNearestActors(osg::Vec3(1000.0f, 0.0f, 0.0f), 1U, found);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), found.size());
+   CPPUNIT_ASSERT(found[0] == actors[0].get());
+
+   // Moving a parent moves the actors attached to it.
+   mGM->GetScene().RemoveChild(actors[1]->GetDrawable());
+   actors[2]->GetDrawable()->AddChild(actors[1]->GetDrawable());
+   xform.SetTranslation(osg::Vec3(-500.0f, 0.0f, 0.0f));
+   actors[2]->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+   mGM->FindActorsInRadius(osg::Vec3(-500.0f, 0.0f, 0.0f), 50.0f, found);
+   CPPUNIT_ASSERT_EQUAL(size_t(2), found.size());
+   actors[2]->GetDrawable()->RemoveChild(actors[1]->GetDrawable());
+   mGM->GetScene().AddChild(actors[1]->GetDrawable());
+   xform.SetTranslation(osg::Vec3(10.0f, 0.0f, 0.0f));
+   actors[1]->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+   xform.SetTranslation(osg::Vec3(20.0f, 0.0f, 0.0f));
+   actors[2]->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+
+   mGM->DeleteActor(*actors[0]);
+   dtCore::System::GetInstance().Step();
+   mGM->FindActorsInRadius(osg::Vec3(2000.0f, 0.0f, 0.0f), 50.0f, found);
+   CPPUNIT_ASSERT(found.empty());
+
+   mGM->SetSpatialIndexCellSize(2.0f);
+   CPPUNIT_ASSERT_EQUAL(2.0f, mGM->GetSpatialIndexCellSize());
+   mGM->FindActorsInRadius(osg::Vec3(20.0f, 0.0f, 0.0f), 10.5f, found);
+   CPPUNIT_ASSERT_EQUAL(size_t(3), found.size());
+}
+
 /////////////////////////////////////////////////
 void GameManagerTests::TestPrototypeActors()
 {
@@ -2052,6 +2131,37 @@ void GameManagerTests::TestBatchAddWithAddActor()
 }
 
 
+//////////////////////////////////////////////////
+void GameManagerTests::TestGMSettingsMessagePools()
+{
+   dtGame::MessageFactory& factory = mGM->GetMessageFactory();
+   dtGame::GMSettings& settings = mGM->GetGMSettings();
+
+   CPPUNIT_ASSERT_EQUAL(4U, settings.GetTickMessagePoolSize());
+   CPPUNIT_ASSERT_EQUAL(64U, settings.GetTimerMessagePoolSize());
+   CPPUNIT_ASSERT_EQUAL(1024U, settings.GetActorUpdateMessagePoolSize());
+
+   // Changed before the first tick, so the defaults are never used.
+   settings.SetActorUpdateMessagePoolSize(0U);
+   settings.SetTimerMessagePoolSize(8U);
+   dtCore::System::GetInstance().Step(0.016f);
+
+   CPPUNIT_ASSERT_EQUAL(4U, factory.GetMessagePoolSize(dtGame::MessageType::TICK_LOCAL));
+   CPPUNIT_ASSERT_EQUAL(4U, factory.GetMessagePoolSize(dtGame::MessageType::SYSTEM_POST_FRAME));
+   CPPUNIT_ASSERT_EQUAL(8U, factory.GetMessagePoolSize(dtGame::MessageType::INFO_TIMER_ELAPSED));
+   CPPUNIT_ASSERT_EQUAL(0U, factory.GetMessagePoolSize(dtGame::MessageType::INFO_ACTOR_UPDATED));
+
+   // Changes after that are picked up on the next tick.
+   settings.SetTickMessagePoolSize(0U);
+   settings.SetActorUpdateMessagePoolSize(16U);
+   dtCore::System::GetInstance().Step(0.016f);
+
+   CPPUNIT_ASSERT_EQUAL(0U, factory.GetMessagePoolSize(dtGame::MessageType::TICK_LOCAL));
+   CPPUNIT_ASSERT_EQUAL(0U, factory.GetMessagePoolSize(dtGame::MessageType::SYSTEM_POST_FRAME));
+   CPPUNIT_ASSERT_EQUAL(8U, factory.GetMessagePoolSize(dtGame::MessageType::INFO_TIMER_ELAPSED));
+   CPPUNIT_ASSERT_EQUAL(16U, factory.GetMessagePoolSize(dtGame::MessageType::INFO_ACTOR_UPDATED));
+}
+
 //////////////////////////////////////////////////
 void GameManagerTests::TestGMSettingsServerClientRoles()
 {
@@ -31,8 +31,13 @@
 #include <dtCore/refptr.h>
 #include <dtCore/system.h>
 #include <dtGame/gamemanager.h>
+#include <dtGame/defaultnetworkpublishingcomponent.h>
 #include <dtGame/gmcomponent.h>
+#include <dtGame/gmsettings.h>
+#include <dtGame/messagetype.h>
 #include <dtUtil/stringutils.h>
+#include <dtUtil/threadpool.h>
+#include <OpenThreads/Atomic>
 
 class GMComponentTests : public CPPUNIT_NS::TestFixture
 {
@@ -40,6 +45,7 @@ class GMComponentTests : public CPPUNIT_NS::TestFixture
    CPPUNIT_TEST(TestComponentRemovingItselfDuringMessage);
    CPPUNIT_TEST(TestComponentRemovingAnotherDuringMessage);
    CPPUNIT_TEST(TestComponentAddingAnotherDuringMessage);
+   CPPUNIT_TEST(TestConcurrentComponentDispatch);
    //CPPUNIT_TEST(TestComponentMessagePerformance); //disabled - just used for benchmarking
    CPPUNIT_TEST_SUITE_END();
 
@@ -50,6 +56,7 @@ public:
    void TestComponentRemovingItselfDuringMessage();
    void TestComponentRemovingAnotherDuringMessage();
    void TestComponentAddingAnotherDuringMessage();
+   void TestConcurrentComponentDispatch();
    void TestComponentMessagePerformance();
 };
 
@@ -194,6 +201,118 @@ void GMComponentTests::TestComponentAddingAnotherDuringMessage()
    scene = NULL;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+class ConcurrentCounterComp : public dtGame::GMComponent
+{
+public:
+   ConcurrentCounterComp(const std::string& name):
+      dtGame::GMComponent(name)
+      {
+         SetConcurrentSafe(true);
+      }
+
+      virtual void ProcessMessage(const dtGame::Message& message)
+      {
+         if (message.GetMessageType() == dtGame::MessageType::TICK_LOCAL)
+         {
+            ++mTickCount;
+         }
+      }
+
+      OpenThreads::Atomic mTickCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+class SerialOrderComp : public dtGame::GMComponent
+{
+public:
+   SerialOrderComp(const std::string& name, std::vector<std::string>& order):
+      dtGame::GMComponent(name)
+      , mOrder(order)
+      , mTickCount(0)
+      {}
+
+      virtual void ProcessMessage(const dtGame::Message& message)
+      {
+         if (message.GetMessageType() == dtGame::MessageType::TICK_LOCAL)
+         {
+            mOrder.push_back(GetName());
+            ++mTickCount;
+         }
+      }
+
+      std::vector<std::string>& mOrder;
+      unsigned mTickCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void GMComponentTests::TestConcurrentComponentDispatch()
+{
+   int oldNumWorkerThreads = -1;
+   if (dtUtil::ThreadPool::IsInitialized())
+   {
+      oldNumWorkerThreads = dtUtil::ThreadPool::GetNumImmediateWorkerThreads();
+      dtUtil::ThreadPool::Shutdown();
+   }
+
+   // With 0 worker threads, the tasks have to run on the calling thread.
+   const int workerCounts[] = { -1, 0 };
+   for (unsigned w = 0; w < 2; ++w)
+   {
+      dtUtil::ThreadPool::Init(workerCounts[w]);
+
+      dtCore::RefPtr<dtCore::Scene> scene = new dtCore::Scene();
+      dtCore::RefPtr<dtGame::GameManager> gm = new dtGame::GameManager(*scene);
+      gm->GetGMSettings().SetConcurrentComponentDispatch(true);
+
+      std::vector<std::string> order;
+      std::vector<dtCore::RefPtr<ConcurrentCounterComp> > concurrentComps;
+      std::vector<dtCore::RefPtr<SerialOrderComp> > serialComps;
+      for (int i = 0; i < 8; ++i)
+      {
+         // Interleave them so the serial ones are not all next to each other in the component list.
+         concurrentComps.push_back(new ConcurrentCounterComp("Concurrent" + dtUtil::ToString(i)));
+         gm->AddComponent(*concurrentComps.back());
+         serialComps.push_back(new SerialOrderComp("Serial" + dtUtil::ToString(i), order));
+         gm->AddComponent(*serialComps.back());
+      }
+
+      const unsigned numSteps = 10;
+      dtCore::System::GetInstance().Start();
+      for (unsigned step = 0; step < numSteps; ++step)
+      {
+         dtCore::System::GetInstance().Step();
+      }
+
+      for (unsigned i = 0; i < concurrentComps.size(); ++i)
+      {
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Each concurrent component should get each tick exactly once.",
+                                      numSteps, unsigned(concurrentComps[i]->mTickCount));
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Each serial component should get each tick exactly once.",
+                                      numSteps, serialComps[i]->mTickCount);
+      }
+
+      CPPUNIT_ASSERT_EQUAL(size_t(numSteps) * serialComps.size(), order.size());
+      for (unsigned i = 0; i < order.size(); ++i)
+      {
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Serial components should still get messages in the order they were added.",
+                                      serialComps[i % serialComps.size()]->GetName(), order[i]);
+      }
+
+      gm->Shutdown();
+      gm = NULL;
+      scene = NULL;
+
+      dtUtil::ThreadPool::Shutdown();
+   }
+
+   dtUtil::ThreadPool::Init(oldNumWorkerThreads);
+
+   dtCore::RefPtr<dtGame::DefaultNetworkPublishingComponent> publisher = new dtGame::DefaultNetworkPublishingComponent();
+   CPPUNIT_ASSERT_MESSAGE("The network publisher only reads the GM, so it should be concurrent safe.",
+                          publisher->GetConcurrentSafe());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void GMComponentTests::TestComponentMessagePerformance()
 {
@@ -78,6 +78,7 @@ class GMLoggerTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestBinaryLogStreamDeleteLog);
       CPPUNIT_TEST(TestBinaryLogStreamReadWriteErrors);
       CPPUNIT_TEST(TestBinaryLogStreamReadWriteMessages);
+      CPPUNIT_TEST(TestBinaryLogStreamMappedReads);
       CPPUNIT_TEST(TestBinaryLogStreamTags);
       CPPUNIT_TEST(TestBinaryLogStreamKeyFrames);
       CPPUNIT_TEST(TestBinaryLogStreamTagsAndKeyFrames);
@@ -109,6 +110,7 @@ class GMLoggerTests : public CPPUNIT_NS::TestFixture
       void TestBinaryLogStreamOpen();
       void TestBinaryLogStreamReadWriteErrors();
       void TestBinaryLogStreamReadWriteMessages();
+      void TestBinaryLogStreamMappedReads();
       void TestBinaryLogStreamTags();
       void TestBinaryLogStreamKeyFrames();
       void TestBinaryLogStreamTagsAndKeyFrames();
@@ -569,6 +571,70 @@ void GMLoggerTests::TestBinaryLogStreamReadWriteMessages()
    }
 }
 
+//////////////////////////////////////////////////////////////////////////
+void GMLoggerTests::TestBinaryLogStreamMappedReads()
+{
+   dtGame::MessageFactory& msgFactory = mGameManager->GetMessageFactory();
+   dtCore::RefPtr<dtGame::BinaryLogStream> stream =  new dtGame::BinaryLogStream(msgFactory);
+   dtCore::RefPtr<dtGame::TickMessage> tickMessage;
+   msgFactory.CreateMessage(dtGame::MessageType::TICK_LOCAL, tickMessage);
+   const unsigned numMessages = 300;
+
+   try
+   {
+      CPPUNIT_ASSERT_MESSAGE("Mapped reads should be on by default.", stream->GetMappedReads());
+
+      stream->Create(TESTS_DIR,LOGFILE);
+      for (unsigned i = 0; i < numMessages; ++i)
+      {
+         tickMessage->SetSimulationTime(double(i));
+         stream->WriteMessage(*tickMessage, double(i));
+      }
+      stream->Close();
+
+      for (unsigned pass = 0; pass < 2; ++pass)
+      {
+         const bool mapped = pass == 0;
+         stream->SetMappedReads(mapped);
+         // A small window, so the prefetch tasks wrap many times if the thread pool is running.
+         stream->SetPrefetchWindow(8);
+         stream->Open(TESTS_DIR,LOGFILE);
+         CPPUNIT_ASSERT_EQUAL(mapped ? numMessages : 0U, stream->GetNumIndexedMessages());
+
+         double timeStamp = -1.0;
+         for (unsigned i = 0; i < numMessages; ++i)
+         {
+            dtCore::RefPtr<dtGame::Message> msg = stream->ReadMessage(timeStamp);
+            CPPUNIT_ASSERT(msg.valid());
+            CPPUNIT_ASSERT(msg->GetMessageType() == dtGame::MessageType::TICK_LOCAL);
+            CPPUNIT_ASSERT_EQUAL(double(i), timeStamp);
+            CPPUNIT_ASSERT_EQUAL(double(i), static_cast<dtGame::TickMessage&>(*msg).GetSimulationTime());
+         }
+         CPPUNIT_ASSERT(!stream->ReadMessage(timeStamp).valid());
+
+         CPPUNIT_ASSERT_EQUAL(mapped, stream->SeekToTime(150.5));
+         if (mapped)
+         {
+            CPPUNIT_ASSERT(!stream->IsEndOfStream());
+            CPPUNIT_ASSERT(stream->ReadMessage(timeStamp).valid());
+            CPPUNIT_ASSERT_EQUAL(151.0, timeStamp);
+
+            CPPUNIT_ASSERT(stream->SeekToTime(0.0));
+            CPPUNIT_ASSERT(stream->ReadMessage(timeStamp).valid());
+            CPPUNIT_ASSERT_EQUAL(0.0, timeStamp);
+
+            CPPUNIT_ASSERT(stream->SeekToTime(double(numMessages)));
+            CPPUNIT_ASSERT(!stream->ReadMessage(timeStamp).valid());
+         }
+         stream->Close();
+      }
+   }
+   catch(const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL(e.ToString());
+   }
+}
+
 //////////////////////////////////////////////////////////////////////////
 void GMLoggerTests::TestBinaryLogStreamTags()
 {
@@ -35,6 +35,7 @@
 #include <osg/Node>
 
 #include <dtUtil/mathdefines.h>
+#include <dtUtil/threadpool.h>
 
 #include <dtCore/transform.h>
 #include <dtCore/transformable.h>
@@ -171,6 +172,7 @@ namespace dtGame
          CPPUNIT_TEST(TestClampThreePoint);
          CPPUNIT_TEST(TestClampIntermittent);
          CPPUNIT_TEST(TestClampTransformUnchanged);
+         CPPUNIT_TEST(TestClampLargeBatchOnThreadPool);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -895,6 +897,52 @@ namespace dtGame
             CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPos2.z(), pos2.z(), errorTolerance);
          }
 
+         ///////////////////////////////////////////////////////////////////////
+         void TestClampLargeBatchOnThreadPool()
+         {
+            dtCore::RefPtr<dtActors::InfiniteTerrainActorProxy> terrainActor;
+            dtCore::InfiniteTerrain* terrain = NULL;
+            CreateTestTerrain(terrainActor, terrain);
+            mGroundClamper->SetTerrainActor(terrain);
+
+            // More than one isector holds, so the batch has to be split.
+            const unsigned numActors = 75;
+            std::vector<dtCore::RefPtr<GameActorProxy> > actors(numActors);
+            // The clamper holds on to the data until FinishUp, so it must not move.
+            std::vector<GroundClampingData> clampData(numActors);
+
+            for (unsigned i = 0; i < numActors; ++i)
+            {
+               mGM->CreateActor(*dtActors::EngineActorRegistry::GAME_MESH_ACTOR_TYPE, actors[i]);
+               CPPUNIT_ASSERT(actors[i].valid());
+               clampData[i].SetGroundClampType(dtGame::GroundClampTypeEnum::FULL);
+               clampData[i].SetAdjustRotationToGround(false);
+
+               dtCore::Transform xform;
+               xform.SetTranslation(osg::Vec3(float(i) - 40.0f, 20.0f - float(i % 7) * 5.0f, 0.0f));
+               actors[i]->GetDrawable<dtCore::Transformable>()->SetTransform(xform);
+
+               mGroundClamper->ClampToGround(BaseGroundClamper::GroundClampRangeType::RANGED,
+                  0.0, xform, *actors[i], clampData[i], true);
+            }
+
+            CPPUNIT_ASSERT_EQUAL(numActors, mGroundClamper->GetClampBatchSize());
+
+            mGroundClamper->AddBatchTasksToThreadPool();
+            dtUtil::ThreadPool::ExecuteTasks();
+            mGroundClamper->FinishUp();
+            CPPUNIT_ASSERT_EQUAL(0U, mGroundClamper->GetClampBatchSize());
+
+            for (unsigned i = 0; i < numActors; ++i)
+            {
+               dtCore::Transform xform;
+               osg::Vec3 pos;
+               actors[i]->GetDrawable<dtCore::Transformable>()->GetTransform(xform);
+               xform.GetTranslation(pos);
+               CPPUNIT_ASSERT_DOUBLES_EQUAL(terrain->GetHeight(pos.x(), pos.y(), true), pos.z(), 0.1f);
+            }
+         }
+
          ///////////////////////////////////////////////////////////////////////
          void TestClampTransformUnchanged()
          {
@@ -50,11 +50,13 @@
 
 #include <dtUtil/fileutils.h>
 #include <dtUtil/datastream.h>
+#include <dtUtil/threadpool.h>
 
 #include <dtGame/messageparameter.h>
 #include <dtGame/machineinfo.h>
 #include <dtGame/gameactor.h>
 #include <dtGame/basemessages.h>
+#include <dtGame/gmsettings.h>
 #include <dtGame/messagetype.h>
 #include <dtGame/messagefactory.h>
 #include <dtGame/gamemanager.h>
@@ -80,6 +82,8 @@ class MessageTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestOperatorEquals);
       CPPUNIT_TEST(TestBaseMessages);
       CPPUNIT_TEST(TestMessageFactory);
+      CPPUNIT_TEST(TestMessagePooling);
+      //CPPUNIT_TEST(TestMessagePoolPerformance); //disabled - just used for benchmarking
       CPPUNIT_TEST(TestMessageDelivery);
       CPPUNIT_TEST(TestActorPublish);
       CPPUNIT_TEST(TestPauseResume);
@@ -88,6 +92,8 @@ class MessageTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestTimeScaling);
       CPPUNIT_TEST(TestTimeChange);
       CPPUNIT_TEST(TestChangeMap);
+      CPPUNIT_TEST(TestChangeMapTimeSliced);
+      CPPUNIT_TEST(TestChangeMapInBackground);
       CPPUNIT_TEST(TestChangeMapGameEvents);
       CPPUNIT_TEST(TestChangeMapErrorConditions);
       CPPUNIT_TEST(TestDefaultMessageProcessorWithPauseResumeRequests);
@@ -115,6 +121,8 @@ public:
    void TestOperatorEquals();
    void TestBaseMessages();
    void TestMessageFactory();
+   void TestMessagePooling();
+   void TestMessagePoolPerformance();
    void TestMessageDelivery();
    void TestActorPublish();
    void TestPauseResume();
@@ -124,6 +132,8 @@ public:
    void TestTimeChange();
    void TestChangeMapGameEvents();
    void TestChangeMap();
+   void TestChangeMapTimeSliced();
+   void TestChangeMapInBackground();
    void TestChangeMapErrorConditions();
    void TestDefaultMessageProcessorWithPauseResumeRequests();
    void TestDefaultMessageProcessorWithMapRequests();
@@ -618,6 +628,105 @@ void MessageTests::TestMessageFactory()
    }
 }
 
+//////////////////////////////////////////////////////////////////////////
+void MessageTests::TestMessagePooling()
+{
+   dtCore::RefPtr<dtGame::MachineInfo> machine = new dtGame::MachineInfo();
+   dtGame::MessageFactory factory("Pool Test", *machine);
+
+   CPPUNIT_ASSERT_EQUAL(0U, factory.GetMessagePoolSize(dtGame::MessageType::INFO_TIMER_ELAPSED));
+   factory.SetMessagePoolSize(dtGame::MessageType::INFO_TIMER_ELAPSED, 2U);
+   CPPUNIT_ASSERT_EQUAL(2U, factory.GetMessagePoolSize(dtGame::MessageType::INFO_TIMER_ELAPSED));
+
+   dtCore::RefPtr<dtGame::TimerElapsedMessage> timerMsg;
+   factory.CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED, timerMsg);
+   dtGame::TimerElapsedMessage* firstMessage = timerMsg.get();
+
+   // Fill in everything so we can see it's reset.
+   dtCore::RefPtr<dtGame::Message> causingMsg = factory.CreateMessage(dtGame::MessageType::INFO_PAUSED);
+   dtCore::RefPtr<dtGame::MachineInfo> otherMachine = new dtGame::MachineInfo();
+   timerMsg->SetTimerName("Ding");
+   timerMsg->SetLateTime(3.3f);
+   timerMsg->SetAboutActorId(dtCore::UniqueId());
+   timerMsg->SetSendingActorId(dtCore::UniqueId());
+   timerMsg->SetCausingMessage(causingMsg.get());
+   timerMsg->SetDestination(otherMachine.get());
+   timerMsg->SetSource(*otherMachine);
+
+   timerMsg = NULL;
+   factory.CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED, timerMsg);
+   CPPUNIT_ASSERT_MESSAGE("The message should be reused once nothing references it.", timerMsg.get() == firstMessage);
+
+   dtCore::RefPtr<dtGame::TimerElapsedMessage> newMsg = new dtGame::TimerElapsedMessage();
+   CPPUNIT_ASSERT_EQUAL(newMsg->GetTimerName(), timerMsg->GetTimerName());
+   CPPUNIT_ASSERT_EQUAL(newMsg->GetLateTime(), timerMsg->GetLateTime());
+   CPPUNIT_ASSERT(timerMsg->GetAboutActorId().ToString().empty());
+   CPPUNIT_ASSERT(timerMsg->GetSendingActorId().ToString().empty());
+   CPPUNIT_ASSERT(timerMsg->GetCausingMessage() == NULL);
+   CPPUNIT_ASSERT(timerMsg->GetDestination() == NULL);
+   CPPUNIT_ASSERT(timerMsg->GetSource() == *machine);
+   CPPUNIT_ASSERT(timerMsg->GetMessageType() == dtGame::MessageType::INFO_TIMER_ELAPSED);
+
+   // Fill the pool and go over it.
+   dtCore::RefPtr<dtGame::Message> secondMsg = factory.CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED);
+   dtCore::RefPtr<dtGame::Message> thirdMsg = factory.CreateMessage(dtGame::MessageType::INFO_TIMER_ELAPSED);
+   CPPUNIT_ASSERT(secondMsg != timerMsg && thirdMsg != timerMsg && thirdMsg != secondMsg);
+
+   std::vector<dtGame::MessageFactory::MessagePoolStatistics> stats;
+   factory.GetMessagePoolStatistics(stats);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), stats.size());
+   CPPUNIT_ASSERT(stats[0].mMessageType == &dtGame::MessageType::INFO_TIMER_ELAPSED);
+   CPPUNIT_ASSERT_EQUAL(1U, stats[0].mHits);
+   CPPUNIT_ASSERT_EQUAL(3U, stats[0].mMisses);
+   CPPUNIT_ASSERT_EQUAL(2U, stats[0].mNumPooled);
+   CPPUNIT_ASSERT_EQUAL(2U, stats[0].mMaxPooled);
+
+   // Types without a pool aren't counted.
+   causingMsg = factory.CreateMessage(dtGame::MessageType::INFO_PAUSED);
+   factory.GetMessagePoolStatistics(stats);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), stats.size());
+
+   factory.SetMessagePoolSize(dtGame::MessageType::INFO_TIMER_ELAPSED, 0U);
+   CPPUNIT_ASSERT_EQUAL(0U, factory.GetMessagePoolSize(dtGame::MessageType::INFO_TIMER_ELAPSED));
+   factory.GetMessagePoolStatistics(stats);
+   CPPUNIT_ASSERT(stats.empty());
+}
+
+//////////////////////////////////////////////////////////////////////////
+void MessageTests::TestMessagePoolPerformance()
+{
+   const unsigned numMessages = 200000U;
+   dtCore::RefPtr<dtGame::MachineInfo> machine = new dtGame::MachineInfo();
+   dtGame::MessageFactory factory("Pool Test", *machine);
+
+   dtCore::Timer timer;
+   double seconds[2];
+   for (unsigned pooled = 0; pooled < 2; ++pooled)
+   {
+      factory.SetMessagePoolSize(dtGame::MessageType::INFO_ACTOR_UPDATED, pooled * 64U);
+
+      dtCore::Timer_t start = timer.Tick();
+      for (unsigned i = 0; i < numMessages; ++i)
+      {
+         dtCore::RefPtr<dtGame::ActorUpdateMessage> updateMsg;
+         factory.CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, updateMsg);
+         updateMsg->SetName("Sheep");
+      }
+      seconds[pooled] = timer.DeltaSec(start, timer.Tick());
+   }
+
+   std::ostringstream ss;
+   ss << "Creating " << numMessages << " actor update messages took " << seconds[0] << " seconds without a pool and "
+      << seconds[1] << " seconds with one.";
+   LOG_INFO(ss.str());
+
+   std::vector<dtGame::MessageFactory::MessagePoolStatistics> stats;
+   factory.GetMessagePoolStatistics(stats);
+   CPPUNIT_ASSERT_EQUAL(size_t(1), stats.size());
+   CPPUNIT_ASSERT_EQUAL(numMessages - 1U, stats[0].mHits);
+   CPPUNIT_ASSERT_EQUAL(1U, stats[0].mMisses);
+}
+
 //////////////////////////////////////////////////////////////////////////
 void MessageTests::TestMessageDelivery()
 {
@@ -1395,6 +1504,134 @@ void MessageTests::TestChangeMap()
 //   }
 }
 
+void MessageTests::TestChangeMapTimeSliced()
+{
+   try
+   {
+      dtCore::Project& project = dtCore::Project::GetInstance();
+      dtGame::GameManager::NameVector mapNamesExpected;
+      mapNamesExpected.push_back("Many Game Actors");
+
+      dtCore::RefPtr<dtCore::Map> map = &project.CreateMap(mapNamesExpected[0], "mga");
+      createActors(*map);
+      map->AddLibrary(mTestGameActorLibrary, "1.0");
+      map->AddLibrary(mTestActorLibrary, "1.0");
+      // minus one for the Crash Actor, which throws in OnEnteredWorld.
+      const size_t expectedNumActors = map->GetAllProxies().size() - 1;
+
+      project.SaveMap(*map);
+      project.CloseMap(*map);
+
+      dtGame::TestComponent& tc = *new dtGame::TestComponent("name");
+      mGameManager->AddComponent(tc, dtGame::GameManager::ComponentPriority::NORMAL);
+
+      // Small enough that every frame only adds one actor.
+      mGameManager->GetGMSettings().SetMapLoadTimeSliceMS(0.0001f);
+      mGameManager->ChangeMapSet(mapNamesExpected, false);
+
+      dtCore::AppSleep(10);
+      dtCore::System::GetInstance().Step();
+
+      CPPUNIT_ASSERT_MESSAGE("An INFO_MAP_LOAD_BEGIN message should have been processed.",
+               tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_LOAD_BEGIN).valid());
+      CPPUNIT_ASSERT_EQUAL(size_t(0), mGameManager->GetNumAllActors());
+
+      unsigned numProgressMessages = 0;
+      unsigned lastActorsAdded = 0;
+      for (unsigned frame = 0; frame < 1000U && !tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_CHANGED).valid(); ++frame)
+      {
+         tc.reset();
+         dtCore::System::GetInstance().Step();
+
+         dtCore::RefPtr<const dtGame::Message> progress = tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_CHANGE_LOAD_PROGRESS);
+         CPPUNIT_ASSERT_MESSAGE("Every frame of the load should send a progress message.", progress.valid());
+
+         const dtGame::MapLoadProgressMessage& progressMsg = static_cast<const dtGame::MapLoadProgressMessage&>(*progress);
+         CheckMapNames(progressMsg, mapNamesExpected);
+         CPPUNIT_ASSERT_MESSAGE("Every frame should add at least one actor.", progressMsg.GetActorsAdded() > lastActorsAdded);
+         CPPUNIT_ASSERT(progressMsg.GetActorsAdded() <= progressMsg.GetTotalActors());
+         lastActorsAdded = progressMsg.GetActorsAdded();
+         ++numProgressMessages;
+      }
+
+      CPPUNIT_ASSERT_MESSAGE("The map change should have finished.",
+               tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_CHANGED).valid());
+      CPPUNIT_ASSERT_MESSAGE("The actors should have been added over several frames.", numProgressMessages > 1U);
+      CPPUNIT_ASSERT_EQUAL(expectedNumActors, mGameManager->GetNumAllActors());
+      CPPUNIT_ASSERT(!mGameManager->IsPaused());
+   }
+   catch(const dtUtil::Exception& e)
+   {
+      CPPUNIT_FAIL(e.ToString());
+   }
+}
+
+void MessageTests::TestChangeMapInBackground()
+{
+   bool initializedPool = false;
+   if (!dtUtil::ThreadPool::IsInitialized())
+   {
+      dtUtil::ThreadPool::Init();
+      initializedPool = true;
+   }
+
+   try
+   {
+      dtCore::Project& project = dtCore::Project::GetInstance();
+      dtGame::GameManager::NameVector mapNamesExpected;
+      mapNamesExpected.push_back("Background Game Actors");
+
+      dtCore::RefPtr<dtCore::Map> map = &project.CreateMap(mapNamesExpected[0], "bga");
+      createActors(*map);
+      map->AddLibrary(mTestGameActorLibrary, "1.0");
+      map->AddLibrary(mTestActorLibrary, "1.0");
+      // minus one for the Crash Actor, which throws in OnEnteredWorld.
+      const size_t expectedNumActors = map->GetAllProxies().size() - 1;
+
+      project.SaveMap(*map);
+      project.CloseMap(*map);
+      map = NULL;
+
+      dtGame::TestComponent& tc = *new dtGame::TestComponent("name");
+      mGameManager->AddComponent(tc, dtGame::GameManager::ComponentPriority::NORMAL);
+
+      mGameManager->GetGMSettings().SetOpenMapsInBackground(true);
+      mGameManager->ChangeMapSet(mapNamesExpected, false);
+
+      bool sawLoadBegin = false;
+      for (unsigned frame = 0; frame < 1000U && !tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_CHANGED).valid(); ++frame)
+      {
+         tc.reset();
+         dtCore::AppSleep(1);
+         dtCore::System::GetInstance().Step();
+         sawLoadBegin = sawLoadBegin || tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_LOAD_BEGIN).valid();
+      }
+
+      mGameManager->GetGMSettings().SetOpenMapsInBackground(false);
+
+      CPPUNIT_ASSERT_MESSAGE("The map change should have finished.",
+               tc.FindProcessMessageOfType(dtGame::MessageType::INFO_MAP_CHANGED).valid());
+      CPPUNIT_ASSERT_MESSAGE("An INFO_MAP_LOAD_BEGIN message should be sent once the maps are open.", sawLoadBegin);
+      CPPUNIT_ASSERT(project.IsMapOpen(mapNamesExpected[0]));
+      CPPUNIT_ASSERT_EQUAL(expectedNumActors, mGameManager->GetNumAllActors());
+      CPPUNIT_ASSERT(!mGameManager->IsPaused());
+   }
+   catch(const dtUtil::Exception& e)
+   {
+      mGameManager->GetGMSettings().SetOpenMapsInBackground(false);
+      if (initializedPool)
+      {
+         dtUtil::ThreadPool::Shutdown();
+      }
+      CPPUNIT_FAIL(e.ToString());
+   }
+
+   if (initializedPool)
+   {
+      dtUtil::ThreadPool::Shutdown();
+   }
+}
+
 void MessageTests::TestGameEventMessage()
 {
    try
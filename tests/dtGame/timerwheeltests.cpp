@@ -0,0 +1,207 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtGame/timerwheel.h>
+
+namespace dtGame
+{
+   class TimerWheelTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(TimerWheelTests);
+         CPPUNIT_TEST(TestExpireInOrder);
+         CPPUNIT_TEST(TestRepeat);
+         CPPUNIT_TEST(TestFarTimers);
+         CPPUNIT_TEST(TestRemove);
+         CPPUNIT_TEST(TestClockJumps);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp()
+      {
+         mActor1 = dtCore::UniqueId();
+         mActor2 = dtCore::UniqueId();
+      }
+
+      void tearDown()
+      {
+         mExpired.clear();
+      }
+
+      void TestExpireInOrder()
+      {
+         TimerWheel wheel;
+         wheel.Add("C", mActor1, 3500);
+         wheel.Add("A", mActor1, 1200);
+         wheel.Add("B", mActor2, 1200);
+         wheel.Add("D", mActor2, 900000);
+         CPPUNIT_ASSERT_EQUAL(4U, wheel.GetNumTimers());
+
+         wheel.Advance(1100, mExpired);
+         CPPUNIT_ASSERT(mExpired.empty());
+
+         // Due in the same tick as the clock, but not yet.
+         wheel.Advance(1199, mExpired);
+         CPPUNIT_ASSERT(mExpired.empty());
+
+         wheel.Advance(5000, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(3), mExpired.size());
+         // Timers due at the same time expire in the order they were added.
+         CPPUNIT_ASSERT_EQUAL(std::string("A"), mExpired[0].mName.Get());
+         CPPUNIT_ASSERT(mExpired[0].mAboutActor == mActor1);
+         CPPUNIT_ASSERT_EQUAL(std::string("B"), mExpired[1].mName.Get());
+         CPPUNIT_ASSERT(mExpired[1].mAboutActor == mActor2);
+         CPPUNIT_ASSERT_EQUAL(std::string("C"), mExpired[2].mName.Get());
+         CPPUNIT_ASSERT_EQUAL(dtCore::Timer_t(3500), mExpired[2].mTime);
+         CPPUNIT_ASSERT_EQUAL(1U, wheel.GetNumTimers());
+
+         wheel.Advance(900000, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), mExpired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("D"), mExpired[0].mName.Get());
+         CPPUNIT_ASSERT_EQUAL(0U, wheel.GetNumTimers());
+      }
+
+      void TestRepeat()
+      {
+         TimerWheel wheel;
+         TimerWheel::Handle handle = wheel.Add("Repeat", mActor1, 10000, true, 10000);
+
+         wheel.Advance(10000, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), mExpired.size());
+         CPPUNIT_ASSERT(wheel.IsActive(handle));
+
+         // Several intervals late still only expires once.
+         wheel.Advance(45000, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), mExpired.size());
+         CPPUNIT_ASSERT_EQUAL(dtCore::Timer_t(20000), mExpired[0].mTime);
+
+         wheel.Advance(45000, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), mExpired.size());
+         CPPUNIT_ASSERT_EQUAL(dtCore::Timer_t(30000), mExpired[0].mTime);
+
+         CPPUNIT_ASSERT(wheel.Remove(handle));
+         CPPUNIT_ASSERT(!wheel.IsActive(handle));
+         CPPUNIT_ASSERT(!wheel.Remove(handle));
+         wheel.Advance(100000, mExpired);
+         CPPUNIT_ASSERT(mExpired.empty());
+      }
+
+      void TestFarTimers()
+      {
+         // With 1 microsecond ticks, these land on every level of the wheel and past the top one.
+         TimerWheel wheel(1);
+         const dtCore::Timer_t times[] = { 100ULL, 70000ULL, 20000000ULL, 5000000000ULL, 9000000000000ULL };
+         const unsigned numTimes = sizeof(times) / sizeof(times[0]);
+         for (unsigned i = 0; i < numTimes; ++i)
+         {
+            wheel.Add("Far", mActor1, times[i]);
+         }
+
+         // Turn the wheel in steps small enough that it doesn't just reschedule everything.
+         unsigned expired = 0;
+         dtCore::Timer_t clock = 0;
+         while (clock < 30000000ULL)
+         {
+            clock += 200;
+            wheel.Advance(clock, mExpired);
+            for (unsigned i = 0; i < mExpired.size(); ++i)
+            {
+               CPPUNIT_ASSERT_EQUAL(times[expired], mExpired[i].mTime);
+               CPPUNIT_ASSERT(mExpired[i].mTime <= clock && mExpired[i].mTime > clock - 200);
+               ++expired;
+            }
+         }
+         CPPUNIT_ASSERT_EQUAL(3U, expired);
+
+         wheel.Advance(10000000000000ULL, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(2), mExpired.size());
+         CPPUNIT_ASSERT_EQUAL(times[3], mExpired[0].mTime);
+         CPPUNIT_ASSERT_EQUAL(times[4], mExpired[1].mTime);
+      }
+
+      void TestRemove()
+      {
+         TimerWheel wheel;
+         dtCore::UniqueId global(false);
+         wheel.Add("A", mActor1, 1000);
+         wheel.Add("A", mActor1, 2000, true, 1000);
+         wheel.Add("B", mActor1, 1000);
+         wheel.Add("A", mActor2, 1000);
+         wheel.Add("A", global, 1000);
+         wheel.Add("B", global, 1000);
+
+         CPPUNIT_ASSERT_EQUAL(2U, wheel.Remove("A", &mActor1));
+         CPPUNIT_ASSERT_EQUAL(0U, wheel.Remove("A", &mActor1));
+         CPPUNIT_ASSERT_EQUAL(4U, wheel.GetNumTimers());
+
+         // No actor removes the name for every actor.
+         CPPUNIT_ASSERT_EQUAL(2U, wheel.Remove("A", NULL));
+         CPPUNIT_ASSERT_EQUAL(2U, wheel.GetNumTimers());
+
+         CPPUNIT_ASSERT_EQUAL(1U, wheel.RemoveForActor(mActor1));
+         CPPUNIT_ASSERT_EQUAL(0U, wheel.RemoveForActor(mActor2));
+
+         wheel.Advance(5000, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), mExpired.size());
+         CPPUNIT_ASSERT(mExpired[0].mAboutActor == global);
+
+         TimerWheel::Handle handle = wheel.Add("C", mActor2, 8000);
+         wheel.Clear();
+         CPPUNIT_ASSERT_EQUAL(0U, wheel.GetNumTimers());
+         CPPUNIT_ASSERT(!wheel.IsActive(handle));
+
+         // The slot of the cleared timer is reused, but the old handle must not remove the new timer.
+         TimerWheel::Handle newHandle = wheel.Add("C", mActor2, 8000);
+         CPPUNIT_ASSERT(!wheel.Remove(handle));
+         CPPUNIT_ASSERT(wheel.IsActive(newHandle));
+      }
+
+      void TestClockJumps()
+      {
+         TimerWheel wheel;
+         wheel.Advance(50000000, mExpired);
+         wheel.Add("Later", mActor1, 50100000);
+         wheel.Add("MuchLater", mActor1, 90000000);
+
+         // Back in time, nothing is due.
+         wheel.Advance(10000000, mExpired);
+         CPPUNIT_ASSERT(mExpired.empty());
+         wheel.Add("Soon", mActor2, 10001000);
+
+         wheel.Advance(10001000, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(1), mExpired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("Soon"), mExpired[0].mName.Get());
+
+         // Far forward, everything due expires at once.
+         wheel.Advance(100000000, mExpired);
+         CPPUNIT_ASSERT_EQUAL(size_t(2), mExpired.size());
+         CPPUNIT_ASSERT_EQUAL(std::string("Later"), mExpired[0].mName.Get());
+         CPPUNIT_ASSERT_EQUAL(std::string("MuchLater"), mExpired[1].mName.Get());
+      }
+
+   private:
+      dtCore::UniqueId mActor1, mActor2;
+      std::vector<TimerWheel::ExpiredTimer> mExpired;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(TimerWheelTests);
+}
@@ -0,0 +1,273 @@
+/* -*-c++-*-
+ * allTests - This source file (.h & .cpp) - Using 'The MIT License'
+ * Copyright (C) 2010, Alion Science and Technology Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+// Must be first because of a hawknl conflict with osg.  This is not a directly required include, but indirectly
+#include <osgDB/Serializer>
+
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtNetGM/actordeltacache.h>
+#include <dtNetGM/networkbridge.h>
+#include <dtNetGM/servernetworkcomponent.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtGame/actorupdatemessage.h>
+#include <dtGame/basemessages.h>
+
+#include <dtCore/datatype.h>
+#include <dtCore/scene.h>
+#include <dtCore/refptr.h>
+#include <dtUtil/datastream.h>
+
+#include <dtABC/application.h>
+
+extern dtABC::Application& GetGlobalApplication();
+
+/**
+ * @class ActorDeltaCacheTests
+ * @brief Unit tests for delta compressed actor updates
+ */
+class ActorDeltaCacheTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(ActorDeltaCacheTests);
+   CPPUNIT_TEST(TestFullThenDelta);
+   CPPUNIT_TEST(TestPartialAndNewParameters);
+   CPPUNIT_TEST(TestUnknownBaselineResets);
+   CPPUNIT_TEST(TestUnackedUpdatesGoFull);
+   CPPUNIT_TEST(TestNetworkComponentStreams);
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+   void setUp()
+   {
+      mGameManager = new dtGame::GameManager(*GetGlobalApplication().GetScene());
+      mNetComp = new dtNetGM::ServerNetworkComponent("actordeltacachetests", 1);
+      mGameManager->AddComponent(*mNetComp, dtGame::GameManager::ComponentPriority::NORMAL);
+      mSender = new dtNetGM::ActorDeltaCache();
+      mReceiver = new dtNetGM::ActorDeltaCache();
+      mActorId = dtCore::UniqueId();
+   }
+
+   void tearDown()
+   {
+      mSender = NULL;
+      mReceiver = NULL;
+      if (mGameManager.valid())
+      {
+         mGameManager->RemoveComponent(*mNetComp);
+      }
+      mNetComp = NULL;
+      mGameManager = NULL;
+   }
+
+   void TestFullThenDelta()
+   {
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update = CreateUpdate(1.0f);
+      unsigned fullSize = 0;
+      CheckRoundTrip(*update, &fullSize);
+      CPPUNIT_ASSERT_EQUAL(1U, mSender->GetFullUpdatesWritten());
+
+      // Until the ack arrives, updates still can't use the baseline.
+      CheckRoundTrip(*update);
+      CPPUNIT_ASSERT_EQUAL(2U, mSender->GetFullUpdatesWritten());
+
+      Ack();
+
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> moved = CreateUpdate(2.0f);
+      unsigned deltaSize = 0;
+      CheckRoundTrip(*moved, &deltaSize);
+      CPPUNIT_ASSERT_EQUAL(1U, mSender->GetDeltaUpdatesWritten());
+      CPPUNIT_ASSERT_MESSAGE("Only the translation changed, so the delta should be much smaller.", deltaSize * 2U < fullSize);
+   }
+
+   void TestPartialAndNewParameters()
+   {
+      CheckRoundTrip(*CreateUpdate(1.0f));
+      Ack();
+
+      // Partial update with only some of the baseline parameters and one new one.
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> partial;
+      mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, partial);
+      partial->SetAboutActorId(mActorId);
+      partial->SetName("Tank");
+      partial->SetActorTypeName("Tank");
+      partial->SetActorTypeCategory("dtcore.examples");
+      partial->SetPartialUpdate(true);
+      partial->AddUpdateParameter("Translation", dtCore::DataType::VEC3)->FromString("5.0 5.0 5.0");
+      partial->AddUpdateParameter("Damage State", dtCore::DataType::STRING)->FromString("Damaged");
+
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> result = CheckRoundTrip(*partial);
+      CPPUNIT_ASSERT(result->IsPartialUpdate());
+      CPPUNIT_ASSERT_MESSAGE("Parameters left out of a partial update must stay out.", result->GetUpdateParameter("Rotation") == NULL);
+      CPPUNIT_ASSERT(result->GetUpdateParameter("Damage State") != NULL);
+      Ack();
+
+      // A parameter whose type changes is sent in full again.
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> retyped = CreateUpdate(3.0f);
+      retyped->AddUpdateParameter("Damage State", dtCore::DataType::INT)->FromString("2");
+      result = CheckRoundTrip(*retyped);
+      CPPUNIT_ASSERT(!result->IsPartialUpdate());
+      CPPUNIT_ASSERT(result->GetUpdateParameter("Damage State")->GetDataType() == dtCore::DataType::INT);
+   }
+
+   void TestUnknownBaselineResets()
+   {
+      CheckRoundTrip(*CreateUpdate(1.0f));
+      Ack();
+
+      // The receiver loses its state, e.g. the actor was deleted locally.
+      mReceiver->RemoveActor(mActorId);
+
+      dtUtil::DataStream ds;
+      mSender->WriteUpdate(*CreateUpdate(2.0f), ds);
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> result = CreateEmptyUpdate();
+      CPPUNIT_ASSERT(!mReceiver->ReadUpdate(*result, ds));
+
+      dtCore::RefPtr<dtGame::NetActorUpdateAckMessage> ack;
+      mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::NET_ACTOR_UPDATE_ACK, ack);
+      CPPUNIT_ASSERT(mReceiver->TakePendingAcks(*ack));
+      CPPUNIT_ASSERT_EQUAL(1U, ack->GetAckCount());
+      CPPUNIT_ASSERT_EQUAL(0U, ack->GetAckSequence(0));
+      mSender->ProcessAcks(*ack);
+
+      unsigned fullBefore = mSender->GetFullUpdatesWritten();
+      CheckRoundTrip(*CreateUpdate(3.0f));
+      CPPUNIT_ASSERT_EQUAL(fullBefore + 1U, mSender->GetFullUpdatesWritten());
+   }
+
+   void TestUnackedUpdatesGoFull()
+   {
+      CheckRoundTrip(*CreateUpdate(1.0f));
+      Ack();
+
+      for (unsigned i = 0; i < dtNetGM::ActorDeltaCache::MAX_UNACKED_UPDATES; ++i)
+      {
+         CheckRoundTrip(*CreateUpdate(float(i)));
+      }
+      CPPUNIT_ASSERT_EQUAL(dtNetGM::ActorDeltaCache::MAX_UNACKED_UPDATES, mSender->GetDeltaUpdatesWritten());
+
+      unsigned fullBefore = mSender->GetFullUpdatesWritten();
+      CheckRoundTrip(*CreateUpdate(100.0f));
+      CPPUNIT_ASSERT_EQUAL(fullBefore + 1U, mSender->GetFullUpdatesWritten());
+   }
+
+   void TestNetworkComponentStreams()
+   {
+      dtCore::RefPtr<dtNetGM::NetworkBridge> sendBridge = new dtNetGM::NetworkBridge(mNetComp.get());
+      dtCore::RefPtr<dtNetGM::NetworkBridge> receiveBridge = new dtNetGM::NetworkBridge(mNetComp.get());
+
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update = CreateUpdate(1.0f);
+      dtUtil::DataStream full = mNetComp->CreateDataStream(*update, dtNetGM::WireFormat::BINARY_DELTA, sendBridge.get());
+      dtCore::RefPtr<dtGame::Message> result = mNetComp->CreateMessage(full, *receiveBridge);
+      CPPUNIT_ASSERT(result.valid());
+      CheckEqual(*update, *result);
+
+      dtCore::RefPtr<dtGame::NetActorUpdateAckMessage> ack;
+      mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::NET_ACTOR_UPDATE_ACK, ack);
+      CPPUNIT_ASSERT(receiveBridge->GetActorDeltaCache().TakePendingAcks(*ack));
+      sendBridge->GetActorDeltaCache().ProcessAcks(*ack);
+
+      update = CreateUpdate(2.0f);
+      dtUtil::DataStream delta = mNetComp->CreateDataStream(*update, dtNetGM::WireFormat::BINARY_DELTA, sendBridge.get());
+      result = mNetComp->CreateMessage(delta, *receiveBridge);
+      CPPUNIT_ASSERT(result.valid());
+      CheckEqual(*update, *result);
+      CPPUNIT_ASSERT(delta.GetBufferSize() < full.GetBufferSize());
+
+      // Without a bridge there is no baseline, so the stream falls back to plain binary.
+      dtUtil::DataStream plain = mNetComp->CreateDataStream(*update, dtNetGM::WireFormat::BINARY_DELTA);
+      result = mNetComp->CreateMessage(plain, *receiveBridge);
+      CPPUNIT_ASSERT(result.valid());
+      CheckEqual(*update, *result);
+   }
+
+private:
+   dtCore::RefPtr<dtGame::ActorUpdateMessage> CreateEmptyUpdate()
+   {
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update;
+      mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update);
+      update->SetAboutActorId(mActorId);
+      return update;
+   }
+
+   dtCore::RefPtr<dtGame::ActorUpdateMessage> CreateUpdate(float x)
+   {
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update = CreateEmptyUpdate();
+      update->SetName("Tank");
+      update->SetActorTypeName("Tank");
+      update->SetActorTypeCategory("dtcore.examples");
+      update->AddUpdateParameter("Translation", dtCore::DataType::VEC3)->FromString(dtUtil::ToString(x) + " 2.0 3.0");
+      update->AddUpdateParameter("Rotation", dtCore::DataType::VEC3)->FromString("4.0 5.0 6.0");
+      update->AddUpdateParameter("Velocity Vector", dtCore::DataType::VEC3)->FromString("7.0 8.0 9.0");
+      update->AddUpdateParameter("Last Known Translation", dtCore::DataType::VEC3)->FromString("1.0 2.0 3.0");
+      update->AddUpdateParameter("Last Known Rotation", dtCore::DataType::VEC3)->FromString("4.0 5.0 6.0");
+      update->AddUpdateParameter("Dead Reckoning Algorithm", dtCore::DataType::ENUMERATION)->FromString("Velocity Only");
+      return update;
+   }
+
+   void CheckEqual(const dtGame::Message& expected, const dtGame::Message& actual)
+   {
+      std::string expectedString, actualString;
+      expected.ToString(expectedString);
+      actual.ToString(actualString);
+      CPPUNIT_ASSERT_EQUAL(expectedString, actualString);
+   }
+
+   dtCore::RefPtr<dtGame::ActorUpdateMessage> CheckRoundTrip(const dtGame::ActorUpdateMessage& update, unsigned* size = NULL)
+   {
+      dtUtil::DataStream ds;
+      mSender->WriteUpdate(update, ds);
+      if (size != NULL)
+      {
+         *size = ds.GetBufferSize();
+      }
+
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> result = CreateEmptyUpdate();
+      CPPUNIT_ASSERT(mReceiver->ReadUpdate(*result, ds));
+      CPPUNIT_ASSERT_EQUAL(0U, ds.GetRemainingReadSize());
+      CheckEqual(update, *result);
+      return result;
+   }
+
+   void Ack()
+   {
+      dtCore::RefPtr<dtGame::NetActorUpdateAckMessage> ack;
+      mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::NET_ACTOR_UPDATE_ACK, ack);
+      CPPUNIT_ASSERT(mReceiver->TakePendingAcks(*ack));
+      mSender->ProcessAcks(*ack);
+   }
+
+   dtCore::RefPtr<dtGame::GameManager> mGameManager;
+   dtCore::RefPtr<dtNetGM::ServerNetworkComponent> mNetComp;
+   dtCore::RefPtr<dtNetGM::ActorDeltaCache> mSender;
+   dtCore::RefPtr<dtNetGM::ActorDeltaCache> mReceiver;
+   dtCore::UniqueId mActorId;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ActorDeltaCacheTests);
@@ -0,0 +1,261 @@
+/* -*-c++-*-
+ * allTests - This source file (.h & .cpp) - Using 'The MIT License'
+ * Copyright (C) 2010, Alion Science and Technology Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+// Must be first because of a hawknl conflict with osg.  This is not a directly required include, but indirectly
+#include <osgDB/Serializer>
+
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <dtNetGM/wireformat.h>
+#include <dtNetGM/networkbridge.h>
+#include <dtNetGM/servernetworkcomponent.h>
+
+#include <dtGame/gamemanager.h>
+#include <dtGame/messagefactory.h>
+#include <dtGame/messagetype.h>
+#include <dtGame/actorupdatemessage.h>
+#include <dtGame/basemessages.h>
+
+#include <dtCore/datatype.h>
+#include <dtCore/scene.h>
+#include <dtCore/timer.h>
+#include <dtCore/uniqueid.h>
+#include <dtCore/refptr.h>
+#include <dtUtil/datastream.h>
+#include <dtUtil/log.h>
+
+#include <dtABC/application.h>
+
+extern dtABC::Application& GetGlobalApplication();
+
+/**
+ * @class WireFormatTests
+ * @brief Unit tests for the dtNetGM message wire formats
+ */
+class WireFormatTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(WireFormatTests);
+   CPPUNIT_TEST(TestGetByVersion);
+   CPPUNIT_TEST(TestUniqueIdBytes);
+   CPPUNIT_TEST(TestBinaryUniqueIdStream);
+   CPPUNIT_TEST(TestConnectionProtocolVersion);
+   CPPUNIT_TEST(TestMessageRoundTrip);
+   //CPPUNIT_TEST(TestThroughput); //disabled - just used for benchmarking
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+   void setUp()
+   {
+      mGameManager = new dtGame::GameManager(*GetGlobalApplication().GetScene());
+      mNetComp = new dtNetGM::ServerNetworkComponent("wireformattests", 1);
+      mGameManager->AddComponent(*mNetComp, dtGame::GameManager::ComponentPriority::NORMAL);
+      mBridge = new dtNetGM::NetworkBridge(mNetComp.get());
+   }
+
+   void tearDown()
+   {
+      mBridge = NULL;
+      if (mGameManager.valid())
+      {
+         mGameManager->RemoveComponent(*mNetComp);
+      }
+      mNetComp = NULL;
+      mGameManager = NULL;
+   }
+
+   void TestGetByVersion()
+   {
+      CPPUNIT_ASSERT(dtNetGM::WireFormat::GetByVersion(0) == dtNetGM::WireFormat::TEXT_IDS);
+      CPPUNIT_ASSERT(dtNetGM::WireFormat::GetByVersion(1) == dtNetGM::WireFormat::BINARY);
+      CPPUNIT_ASSERT_MESSAGE("A newer peer should get the newest format this side knows.",
+            dtNetGM::WireFormat::GetByVersion(1000) == dtNetGM::WireFormat::GetNewest());
+   }
+
+   void TestUniqueIdBytes()
+   {
+      unsigned char bytes[dtNetGM::UNIQUE_ID_BYTE_COUNT];
+
+      dtCore::UniqueId canonical(std::string("0123abcd-4567-89ef-0123-456789abcdef"));
+      CPPUNIT_ASSERT(dtNetGM::UniqueIdToBytes(canonical, bytes));
+      CPPUNIT_ASSERT_EQUAL(0x01, int(bytes[0]));
+      CPPUNIT_ASSERT_EQUAL(0xef, int(bytes[15]));
+
+      dtCore::UniqueId result(false);
+      dtNetGM::UniqueIdFromBytes(bytes, result);
+      CPPUNIT_ASSERT_EQUAL(canonical, result);
+
+      dtCore::UniqueId upperCase(std::string("0123ABCD-4567-89EF-0123-456789ABCDEF"));
+      CPPUNIT_ASSERT_MESSAGE("Upper case would not round trip, so it must not be packed.",
+            !dtNetGM::UniqueIdToBytes(upperCase, bytes));
+      CPPUNIT_ASSERT(!dtNetGM::UniqueIdToBytes(dtCore::UniqueId(std::string("hostname")), bytes));
+      CPPUNIT_ASSERT(!dtNetGM::UniqueIdToBytes(dtCore::UniqueId(false), bytes));
+   }
+
+   void TestConnectionProtocolVersion()
+   {
+      dtCore::RefPtr<dtGame::NetConnectionMessage> request;
+      mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::NETCLIENT_REQUEST_CONNECTION, request);
+      CPPUNIT_ASSERT(request.valid());
+      CPPUNIT_ASSERT_EQUAL(0U, request->GetProtocolVersion());
+      request->SetMachineInfo(mGameManager->GetMachineInfo());
+      request->SetProtocolVersion(dtNetGM::NETWORK_PROTOCOL_VERSION);
+
+      dtUtil::DataStream ds = mNetComp->CreateDataStream(*request, dtNetGM::WireFormat::TEXT_IDS);
+      dtCore::RefPtr<dtGame::Message> result = mNetComp->CreateMessage(ds, *mBridge);
+      CPPUNIT_ASSERT(result.valid());
+      dtGame::NetConnectionMessage* resultRequest = dynamic_cast<dtGame::NetConnectionMessage*>(result.get());
+      CPPUNIT_ASSERT(resultRequest != NULL);
+      CPPUNIT_ASSERT_EQUAL(dtNetGM::NETWORK_PROTOCOL_VERSION, resultRequest->GetProtocolVersion());
+      CPPUNIT_ASSERT_EQUAL(request->GetMachineInfoName(), resultRequest->GetMachineInfoName());
+      CPPUNIT_ASSERT_MESSAGE("The version must not be read as a causing message.", result->GetCausingMessage() == NULL);
+
+      // An older peer reads the same body as a plain machine info message.  What is left over must look like
+      // a message type it doesn't know, so it gets dropped.
+      dtCore::RefPtr<dtGame::MachineInfoMessage> older;
+      mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_CLIENT_CONNECTED, older);
+      dtUtil::DataStream body;
+      request->ToDataStream(body);
+      older->FromDataStream(body);
+      CPPUNIT_ASSERT_EQUAL(request->GetMachineInfoName(), older->GetMachineInfoName());
+      CPPUNIT_ASSERT_EQUAL((unsigned short)(dtGame::NetConnectionMessage::PROTOCOL_VERSION_MARKER), dtNetGM::NetworkComponent::PeekMessageTypeId(body));
+      CPPUNIT_ASSERT_THROW(mGameManager->GetMessageFactory().GetMessageTypeById(dtGame::NetConnectionMessage::PROTOCOL_VERSION_MARKER),
+            dtGame::MessageFactory::MessageTypeNotRegisteredException);
+
+      // A request from an older peer has no version.
+      dtUtil::DataStream olderBody;
+      older->ToDataStream(olderBody);
+      request->FromDataStream(olderBody);
+      CPPUNIT_ASSERT_EQUAL(0U, request->GetProtocolVersion());
+      CPPUNIT_ASSERT_EQUAL(0U, olderBody.GetRemainingReadSize());
+   }
+
+   void TestBinaryUniqueIdStream()
+   {
+      dtCore::UniqueId ids[4] =
+      {
+         dtCore::UniqueId(),
+         dtCore::UniqueId(std::string("0123ABCD-4567-89EF-0123-456789ABCDEF")),
+         dtCore::UniqueId(std::string("some host")),
+         dtCore::UniqueId(false)
+      };
+
+      dtUtil::DataStream ds;
+      for (unsigned i = 0; i < 4; ++i)
+      {
+         dtNetGM::WriteBinaryUniqueId(ds, ids[i]);
+      }
+
+      for (unsigned i = 0; i < 4; ++i)
+      {
+         dtCore::UniqueId result(false);
+         CPPUNIT_ASSERT(dtNetGM::ReadBinaryUniqueId(ds, result));
+         CPPUNIT_ASSERT_EQUAL(ids[i], result);
+      }
+      CPPUNIT_ASSERT_EQUAL(0U, ds.GetRemainingReadSize());
+   }
+
+   void TestMessageRoundTrip()
+   {
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update = CreateUpdate();
+      dtCore::RefPtr<dtGame::Message> causing = mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::TICK_LOCAL);
+      update->SetCausingMessage(causing.get());
+
+      const dtNetGM::WireFormat* formats[2] = { &dtNetGM::WireFormat::TEXT_IDS, &dtNetGM::WireFormat::BINARY };
+      for (unsigned i = 0; i < 2; ++i)
+      {
+         dtUtil::DataStream ds = mNetComp->CreateDataStream(*update, *formats[i]);
+         CPPUNIT_ASSERT_EQUAL(dtGame::MessageType::INFO_ACTOR_UPDATED.GetId(), dtNetGM::NetworkComponent::PeekMessageTypeId(ds));
+
+         dtCore::RefPtr<dtGame::Message> result = mNetComp->CreateMessage(ds, *mBridge);
+         CPPUNIT_ASSERT_MESSAGE("Format " + formats[i]->GetName() + " should decode.", result.valid());
+         CPPUNIT_ASSERT(result->GetMessageType() == dtGame::MessageType::INFO_ACTOR_UPDATED);
+         CPPUNIT_ASSERT_EQUAL(update->GetAboutActorId(), result->GetAboutActorId());
+         CPPUNIT_ASSERT_EQUAL(update->GetSendingActorId(), result->GetSendingActorId());
+
+         std::string expected, actual;
+         update->ToString(expected);
+         result->ToString(actual);
+         CPPUNIT_ASSERT_EQUAL(expected, actual);
+
+         CPPUNIT_ASSERT_MESSAGE("The causing message should come through too.", result->GetCausingMessage() != NULL);
+         CPPUNIT_ASSERT(result->GetCausingMessage()->GetMessageType() == dtGame::MessageType::TICK_LOCAL);
+      }
+
+      dtUtil::DataStream textStream = mNetComp->CreateDataStream(*update, dtNetGM::WireFormat::TEXT_IDS);
+      dtUtil::DataStream binaryStream = mNetComp->CreateDataStream(*update, dtNetGM::WireFormat::BINARY);
+      CPPUNIT_ASSERT_MESSAGE("The binary stream should be smaller.", binaryStream.GetBufferSize() < textStream.GetBufferSize());
+   }
+
+   /// Encodes and decodes the same update in each format and logs the rate.
+   void TestThroughput()
+   {
+      const unsigned count = 5000;
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update = CreateUpdate();
+
+      const dtNetGM::WireFormat* formats[2] = { &dtNetGM::WireFormat::TEXT_IDS, &dtNetGM::WireFormat::BINARY };
+      for (unsigned i = 0; i < 2; ++i)
+      {
+         dtCore::Timer testClock;
+         dtCore::Timer_t testClockStart = testClock.Tick();
+
+         unsigned totalBytes = 0;
+         for (unsigned j = 0; j < count; ++j)
+         {
+            dtUtil::DataStream ds = mNetComp->CreateDataStream(*update, *formats[i]);
+            totalBytes += ds.GetBufferSize();
+            CPPUNIT_ASSERT(mNetComp->CreateMessage(ds, *mBridge).valid());
+         }
+
+         double seconds = testClock.DeltaSec(testClockStart, testClock.Tick());
+         LOG_INFO("Wire format " + formats[i]->GetName() + ": " + dtUtil::ToString(count) + " actor updates, "
+               + dtUtil::ToString(totalBytes / count) + " bytes each, "
+               + dtUtil::ToString(seconds > 0.0 ? double(count) / seconds : 0.0) + " messages per second.");
+      }
+   }
+
+private:
+   dtCore::RefPtr<dtGame::ActorUpdateMessage> CreateUpdate()
+   {
+      dtCore::RefPtr<dtGame::ActorUpdateMessage> update;
+      mGameManager->GetMessageFactory().CreateMessage(dtGame::MessageType::INFO_ACTOR_UPDATED, update);
+      update->SetAboutActorId(dtCore::UniqueId());
+      update->SetSendingActorId(dtCore::UniqueId());
+      update->SetName("Tank");
+      update->SetActorTypeName("Tank");
+      update->SetActorTypeCategory("dtcore.examples");
+      update->AddUpdateParameter("Translation", dtCore::DataType::VEC3)->FromString("1.0 2.0 3.0");
+      update->AddUpdateParameter("Rotation", dtCore::DataType::VEC3)->FromString("4.0 5.0 6.0");
+      update->AddUpdateParameter("Velocity Vector", dtCore::DataType::VEC3)->FromString("7.0 8.0 9.0");
+      return update;
+   }
+
+   dtCore::RefPtr<dtGame::GameManager> mGameManager;
+   dtCore::RefPtr<dtNetGM::ServerNetworkComponent> mNetComp;
+   dtCore::RefPtr<dtNetGM::NetworkBridge> mBridge;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WireFormatTests);
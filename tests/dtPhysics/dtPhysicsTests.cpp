@@ -63,6 +63,7 @@
 #include <dtPhysics/palutil.h>
 
 #include <osg/Geode>
+#include <osg/Group>
 #include <osg/Shape>
 #include <osg/ShapeDrawable>
 #include <osg/ComputeBoundsVisitor>
@@ -104,6 +105,7 @@ namespace dtPhysics
       CPPUNIT_TEST(testComponentPerEngine);
       CPPUNIT_TEST(testCallbacksPerEngine);
       CPPUNIT_TEST(testPhysicsReaderWriter);
+      CPPUNIT_TEST(testVertexDataDiskCache);
       CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -143,6 +145,7 @@ namespace dtPhysics
       void testComponentPerEngine();
       void testCallbacksPerEngine();
       void testPhysicsReaderWriter();
+      void testVertexDataDiskCache();
 
       // used so we have a place to test actors
       // not called multiple times like the others.
@@ -2117,4 +2120,57 @@ namespace dtPhysics
       CPPUNIT_ASSERT(data->GetMaterialIndex(MAT_NAME_C) == 5);
       CPPUNIT_ASSERT(data->GetMaterialCount() == 3);
    }
+
+   /////////////////////////////////////////////////////////
+   void dtPhysicsTests::testVertexDataDiskCache()
+   {
+      const std::string cacheDir("temp_dtPhysicsDiskCache");
+      const std::string cacheKey("diskCacheCrate");
+      dtUtil::FileUtils& fileUtils = dtUtil::FileUtils::GetInstance();
+
+      std::string path = dtUtil::FindFileInPathList("../examples/data/StaticMeshes/physics_crate.ive");
+      dtCore::RefPtr<osg::Node> box = osgDB::readNodeFile(path);
+      CPPUNIT_ASSERT(box.valid());
+
+      dtPhysics::VertexData::ClearAllCachedData();
+      CPPUNIT_ASSERT(dtPhysics::VertexData::GetDiskCacheDirectory().empty());
+      CPPUNIT_ASSERT(dtPhysics::VertexData::GetDiskCacheFileName(cacheKey, path).empty());
+
+      dtPhysics::VertexData::SetDiskCacheDirectory(cacheDir);
+      try
+      {
+         std::string entry = dtPhysics::VertexData::GetDiskCacheFileName(cacheKey, path);
+         CPPUNIT_ASSERT(!entry.empty());
+         CPPUNIT_ASSERT_MESSAGE("Entries are only made for source files that exist",
+                  dtPhysics::VertexData::GetDiskCacheFileName(cacheKey, "notAFile.ive").empty());
+         CPPUNIT_ASSERT(entry != dtPhysics::VertexData::GetDiskCacheFileName(cacheKey + "_Polytope", path));
+
+         dtCore::RefPtr<dtPhysics::VertexData> cooked;
+         dtPhysics::VertexData::GetOrCreateCachedDataForNode(cooked, box.get(), cacheKey, false, path);
+         CPPUNIT_ASSERT(cooked.valid() && !cooked->mIndices.empty());
+         CPPUNIT_ASSERT_MESSAGE("Cooking the node should write the disk cache entry", fileUtils.FileExists(entry));
+
+         // Start as a new process would.  An empty node can't be cooked, so the data must come from disk.
+         dtPhysics::VertexData::ClearAllCachedData();
+         dtCore::RefPtr<osg::Group> empty = new osg::Group;
+         dtCore::RefPtr<dtPhysics::VertexData> loaded;
+         dtPhysics::VertexData::GetOrCreateCachedDataForNode(loaded, empty.get(), cacheKey, false, path);
+         CPPUNIT_ASSERT(loaded.valid());
+         CPPUNIT_ASSERT(loaded != cooked);
+         CPPUNIT_ASSERT(cooked->mVertices == loaded->mVertices);
+         CPPUNIT_ASSERT(cooked->mIndices == loaded->mIndices);
+         CPPUNIT_ASSERT(cooked->mMaterialFlags == loaded->mMaterialFlags);
+         CPPUNIT_ASSERT(dtPhysics::VertexData::FindCachedData(cacheKey) == loaded);
+      }
+      catch (const dtUtil::Exception& ex)
+      {
+         dtPhysics::VertexData::SetDiskCacheDirectory(std::string());
+         fileUtils.DirDelete(cacheDir, true);
+         CPPUNIT_FAIL(ex.ToString());
+      }
+
+      dtPhysics::VertexData::SetDiskCacheDirectory(std::string());
+      dtPhysics::VertexData::ClearAllCachedData();
+      fileUtils.DirDelete(cacheDir, true);
+   }
 }
@@ -33,7 +33,11 @@
 #include <dtUtil/fileutils.h>
 #include <dtUtil/logobserver.h>
 #include <dtUtil/datapathutils.h>
+#include <dtUtil/stringutils.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include <OpenThreads/Thread>
+#include <map>
+#include <vector>
 
 /**
  * @class LogTests
@@ -51,6 +55,7 @@ class LogTests : public CPPUNIT_NS::TestFixture
       CPPUNIT_TEST(TestOutputStream);
       CPPUNIT_TEST(TestAddingCustomLogObserver);
       CPPUNIT_TEST(TestTriggeringCustomLogObserver);
+      CPPUNIT_TEST(TestAsynchronousLogging);
    CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -84,6 +89,8 @@ class LogTests : public CPPUNIT_NS::TestFixture
 
       void TestTriggeringCustomLogObserver();
 
+      void TestAsynchronousLogging();
+
    private:
       std::string mMsgStr;
       std::string mSource;
@@ -408,3 +415,110 @@ void LogTests::TestTriggeringCustomLogObserver()
 
    Log::GetInstance().RemoveObserver(*testObserver);
 }
+
+//////////////////////////////////////////////////////////////////////////
+/// Keeps the messages of each method name in the order they arrived.
+class RecordingObserver : public dtUtil::LogObserver
+{
+public:
+   virtual void LogMessage(const LogData& logData)
+   {
+      mMessages[logData.method].push_back(logData.msg);
+   }
+
+   std::map<std::string, std::vector<std::string> > mMessages;
+protected:
+   virtual ~RecordingObserver() {};
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// Logs numbered messages with its name as the method.
+class LoggingThread : public OpenThreads::Thread
+{
+public:
+   LoggingThread(const std::string& name, unsigned count)
+   : mName(name)
+   , mCount(count)
+   {
+   }
+
+   virtual void run()
+   {
+      for (unsigned i = 0; i < mCount; ++i)
+      {
+         dtUtil::Log::GetInstance().LogMessage(__FILE__, mName, __LINE__, dtUtil::ToString(i), dtUtil::Log::LOG_ALWAYS);
+      }
+   }
+
+   std::string mName;
+   unsigned mCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void LogTests::TestAsynchronousLogging()
+{
+   using namespace dtUtil;
+
+   const unsigned int oldBits = Log::GetInstance().GetOutputStreamBit();
+   const unsigned oldBudget = Log::GetAsyncMemoryBudget();
+   dtCore::RefPtr<RecordingObserver> observer = new RecordingObserver();
+   Log::GetInstance().AddObserver(*observer);
+   Log::GetInstance().SetOutputStreamBit(Log::TO_OBSERVER);
+
+   // Other tests may have dropped messages, so only the ones dropped here are checked.
+   const unsigned oldNumDropped = Log::GetNumDroppedMessages();
+
+   Log::SetAsynchronous(true);
+   CPPUNIT_ASSERT(Log::IsAsynchronous());
+
+   // Small enough that nothing is dropped even if the threads end up sharing one queue of 1024 slots,
+   // which happens when a thread starts after another one exits.
+   const unsigned numPerThread = 200;
+   std::vector<LoggingThread*> threads;
+   for (unsigned i = 0; i < 3; ++i)
+   {
+      threads.push_back(new LoggingThread("thread" + dtUtil::ToString(i), numPerThread));
+      threads.back()->start();
+   }
+   LoggingThread mainThread("main", numPerThread);
+   mainThread.run();
+
+   for (unsigned i = 0; i < threads.size(); ++i)
+   {
+      threads[i]->join();
+      delete threads[i];
+   }
+   Log::FlushAsynchronous();
+
+   CPPUNIT_ASSERT_EQUAL(oldNumDropped, Log::GetNumDroppedMessages());
+   CPPUNIT_ASSERT_EQUAL(size_t(4), observer->mMessages.size());
+   std::map<std::string, std::vector<std::string> >::const_iterator i, iend = observer->mMessages.end();
+   for (i = observer->mMessages.begin(); i != iend; ++i)
+   {
+      CPPUNIT_ASSERT_EQUAL(size_t(numPerThread), i->second.size());
+      for (unsigned j = 0; j < numPerThread; ++j)
+      {
+         CPPUNIT_ASSERT_EQUAL_MESSAGE("Messages from one thread should stay in order.",
+                  dtUtil::ToString(j), i->second[j]);
+      }
+   }
+
+   // Nothing fits in a one byte budget, so the messages are dropped rather than queued.
+   Log::SetAsyncMemoryBudget(1U);
+   observer->mMessages.clear();
+   LOG_ALWAYS("dropped");
+   LOG_ALWAYS("dropped");
+   Log::FlushAsynchronous();
+   CPPUNIT_ASSERT_EQUAL(oldNumDropped + 2U, Log::GetNumDroppedMessages());
+   CPPUNIT_ASSERT(observer->mMessages.empty());
+
+   Log::SetAsyncMemoryBudget(oldBudget);
+   LOG_ALWAYS("not dropped");
+   Log::SetAsynchronous(false);
+   CPPUNIT_ASSERT(!Log::IsAsynchronous());
+   CPPUNIT_ASSERT_EQUAL_MESSAGE("Turning asynchronous logging off should write the queued messages.",
+            size_t(1), observer->mMessages.size());
+
+   Log::GetInstance().SetOutputStreamBit(oldBits);
+   Log::GetInstance().RemoveObserver(*observer);
+}
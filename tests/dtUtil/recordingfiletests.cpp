@@ -0,0 +1,206 @@
+/* -*-c++-*-
+* allTests - This source file (.h & .cpp) - Using 'The MIT License'
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtUtil/recordingfile.h>
+#include <dtUtil/fileutils.h>
+#include <dtCore/refptr.h>
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace dtUtil
+{
+   static const unsigned NUM_FRAMES = 1000;
+   static const unsigned FRAMES_PER_CHUNK = 100;
+
+   class RecordingFileTests : public CPPUNIT_NS::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(RecordingFileTests);
+         CPPUNIT_TEST(TestWriteAndRead);
+         CPPUNIT_TEST(TestFindChunk);
+         CPPUNIT_TEST(TestCompression);
+         CPPUNIT_TEST(TestReadUnclosedFile);
+         CPPUNIT_TEST(TestReadCorruptIndex);
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void setUp()
+      {
+         mFileName = "recordingFileTest.dtrec";
+      }
+
+      void tearDown()
+      {
+         dtUtil::FileUtils::GetInstance().FileDelete(mFileName);
+      }
+
+      /// Mostly constant data with a counter, the way a slowly moving object would look.  Every 300th frame is longer.
+      static void MakeFrame(unsigned index, std::vector<char>& frame)
+      {
+         frame.assign((index % 300 == 299) ? 96 : 64, 'x');
+         std::memcpy(&frame[0], &index, sizeof(index));
+         frame[20] = char(index / 50);
+      }
+
+      static double FrameTime(unsigned index)
+      {
+         return index / 60.0;
+      }
+
+      void WriteFrames(RecordingFileWriter& writer, unsigned count)
+      {
+         std::vector<char> frame;
+         for (unsigned i = 0; i < count; ++i)
+         {
+            MakeFrame(i, frame);
+            writer.WriteFrame(FrameTime(i), &frame[0], unsigned(frame.size()));
+         }
+      }
+
+      void CheckFrames(RecordingFileReader& reader, unsigned expectedFrames)
+      {
+         CPPUNIT_ASSERT_EQUAL(expectedFrames, reader.GetNumFrames());
+
+         RecordingFileReader::Chunk chunk;
+         std::vector<char> expected;
+         unsigned frameIndex = 0;
+         for (unsigned c = 0; c < reader.GetNumChunks(); ++c)
+         {
+            CPPUNIT_ASSERT(reader.ReadChunk(c, chunk));
+            for (unsigned f = 0; f < chunk.mFrames.size(); ++f, ++frameIndex)
+            {
+               const RecordingFileReader::Frame& frame = chunk.mFrames[f];
+               MakeFrame(frameIndex, expected);
+               CPPUNIT_ASSERT_DOUBLES_EQUAL(FrameTime(frameIndex), frame.mTime, 1e-9);
+               CPPUNIT_ASSERT_EQUAL(unsigned(expected.size()), frame.mSize);
+               CPPUNIT_ASSERT(std::memcmp(&expected[0], &chunk.mData[frame.mOffset], frame.mSize) == 0);
+            }
+         }
+         CPPUNIT_ASSERT_EQUAL(expectedFrames, frameIndex);
+      }
+
+      void TestWriteAndRead()
+      {
+         dtCore::RefPtr<RecordingFileWriter> writer = new RecordingFileWriter();
+         writer->SetFramesPerChunk(FRAMES_PER_CHUNK);
+         CPPUNIT_ASSERT(writer->Open(mFileName, 2));
+         WriteFrames(*writer, NUM_FRAMES);
+         CPPUNIT_ASSERT_EQUAL(NUM_FRAMES, writer->GetNumFrames());
+         writer->Close();
+         CPPUNIT_ASSERT(!writer->IsOpen());
+
+         CPPUNIT_ASSERT(RecordingFileReader::IsRecordingFile(mFileName));
+
+         dtCore::RefPtr<RecordingFileReader> reader = new RecordingFileReader();
+         CPPUNIT_ASSERT(reader->Open(mFileName));
+         CPPUNIT_ASSERT_EQUAL(2U, reader->GetNumSources());
+         CPPUNIT_ASSERT_EQUAL(NUM_FRAMES / FRAMES_PER_CHUNK, reader->GetNumChunks());
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(FrameTime(0), reader->GetStartTime(), 1e-9);
+         CPPUNIT_ASSERT_DOUBLES_EQUAL(FrameTime(NUM_FRAMES - 1), reader->GetEndTime(), 1e-9);
+         CheckFrames(*reader, NUM_FRAMES);
+
+         RecordingFileReader::Chunk chunk;
+         CPPUNIT_ASSERT(!reader->ReadChunk(reader->GetNumChunks(), chunk));
+      }
+
+      void TestFindChunk()
+      {
+         dtCore::RefPtr<RecordingFileWriter> writer = new RecordingFileWriter();
+         writer->SetFramesPerChunk(FRAMES_PER_CHUNK);
+         CPPUNIT_ASSERT(writer->Open(mFileName, 1));
+         WriteFrames(*writer, NUM_FRAMES);
+         writer->Close();
+
+         dtCore::RefPtr<RecordingFileReader> reader = new RecordingFileReader();
+         CPPUNIT_ASSERT(reader->Open(mFileName));
+
+         CPPUNIT_ASSERT_EQUAL(0U, reader->FindChunk(-1.0));
+         CPPUNIT_ASSERT_EQUAL(0U, reader->FindChunk(FrameTime(0)));
+         CPPUNIT_ASSERT_EQUAL(5U, reader->FindChunk(FrameTime(550)));
+         CPPUNIT_ASSERT_EQUAL(5U, reader->FindChunk(FrameTime(500)));
+         CPPUNIT_ASSERT_EQUAL(4U, reader->FindChunk(FrameTime(499)));
+         CPPUNIT_ASSERT_EQUAL(reader->GetNumChunks() - 1, reader->FindChunk(FrameTime(NUM_FRAMES * 2)));
+      }
+
+      void TestCompression()
+      {
+         dtCore::RefPtr<RecordingFileWriter> writer = new RecordingFileWriter();
+         CPPUNIT_ASSERT(writer->Open(mFileName, 1));
+         WriteFrames(*writer, NUM_FRAMES);
+         writer->Close();
+
+         // Each frame is at least 64 bytes, but only changes in a few of them.
+         size_t fileSize = dtUtil::FileUtils::GetInstance().GetFileInfo(mFileName).size;
+         CPPUNIT_ASSERT_MESSAGE("The frames should be stored as deltas.", fileSize < NUM_FRAMES * 64 / 2);
+      }
+
+      void TestReadUnclosedFile()
+      {
+         dtCore::RefPtr<RecordingFileWriter> writer = new RecordingFileWriter();
+         writer->SetFramesPerChunk(FRAMES_PER_CHUNK);
+         CPPUNIT_ASSERT(writer->Open(mFileName, 1));
+         WriteFrames(*writer, 450);
+         writer->Flush();
+
+         // The index is only written on close, so the reader has to find the chunks itself.
+         dtCore::RefPtr<RecordingFileReader> reader = new RecordingFileReader();
+         CPPUNIT_ASSERT(reader->Open(mFileName));
+         CPPUNIT_ASSERT_EQUAL(5U, reader->GetNumChunks());
+         CheckFrames(*reader, 450);
+
+         reader->Close();
+         writer->Close();
+      }
+
+      void TestReadCorruptIndex()
+      {
+         dtCore::RefPtr<RecordingFileWriter> writer = new RecordingFileWriter();
+         writer->SetFramesPerChunk(FRAMES_PER_CHUNK);
+         CPPUNIT_ASSERT(writer->Open(mFileName, 1));
+         WriteFrames(*writer, NUM_FRAMES);
+         writer->Close();
+
+         // Point the first index entry far past the end of the file.
+         std::fstream file(mFileName.c_str(), std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+         unsigned long long indexOffset = 0;
+         file.seekg(-16, std::ios_base::end);
+         file.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset));
+         const unsigned long long badOffset = 0x100000000ULL;
+         file.seekp(std::streamoff(indexOffset + 4), std::ios_base::beg);
+         file.write(reinterpret_cast<const char*>(&badOffset), sizeof(badOffset));
+         file.close();
+
+         // The bad index is thrown away and the chunks are found by walking them.
+         dtCore::RefPtr<RecordingFileReader> reader = new RecordingFileReader();
+         CPPUNIT_ASSERT(reader->Open(mFileName));
+         CPPUNIT_ASSERT_EQUAL(NUM_FRAMES / FRAMES_PER_CHUNK, reader->GetNumChunks());
+         CheckFrames(*reader, NUM_FRAMES);
+      }
+
+   private:
+      std::string mFileName;
+   };
+
+   CPPUNIT_TEST_SUITE_REGISTRATION(RecordingFileTests);
+}
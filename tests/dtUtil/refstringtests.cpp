@@ -28,10 +28,43 @@
 #include <prefix/unittestprefix.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <dtUtil/refstring.h>
+#include <dtUtil/log.h>
+#include <dtUtil/stringutils.h>
+#include <dtCore/timer.h>
+#include <OpenThreads/Thread>
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 namespace dtUtil
 {
+   /// Interns the same set of strings over and over, keeping the results of the last pass.
+   class InternThread : public OpenThreads::Thread
+   {
+   public:
+      InternThread(const std::vector<std::string>& strings, unsigned passes)
+      : mStrings(strings)
+      , mPasses(passes)
+      {
+      }
+
+      virtual void run()
+      {
+         for (unsigned pass = 0; pass < mPasses; ++pass)
+         {
+            mResults.clear();
+            for (size_t i = 0; i < mStrings.size(); ++i)
+            {
+               mResults.push_back(dtUtil::RefString(mStrings[i]));
+            }
+         }
+      }
+
+      const std::vector<std::string>& mStrings;
+      unsigned mPasses;
+      std::vector<dtUtil::RefString> mResults;
+   };
+
    /// Math unit tests for dtUtil
    class RefStringTests : public CPPUNIT_NS::TestFixture
    {
@@ -39,6 +72,9 @@ namespace dtUtil
          CPPUNIT_TEST( TestCopyConstructorAndAssignment );
          CPPUNIT_TEST( TestSamePointer );
          CPPUNIT_TEST( TestOperators );
+         CPPUNIT_TEST( TestHash );
+         CPPUNIT_TEST( TestConcurrentIntern );
+         //CPPUNIT_TEST( TestConcurrentInternPerformance ); //disabled - just used for benchmarking
       CPPUNIT_TEST_SUITE_END();
 
       public:
@@ -130,7 +166,86 @@ namespace dtUtil
             CPPUNIT_ASSERT_EQUAL(testString, ss.str());
          }
 
+         void TestHash()
+         {
+            dtUtil::RefString one("booga booga");
+            dtUtil::RefString two(std::string("booga booga"));
+            dtUtil::RefString three("booga booga booga");
+
+            CPPUNIT_ASSERT_EQUAL(one.GetHash(), two.GetHash());
+            CPPUNIT_ASSERT_EQUAL(dtUtil::__hash_string("booga booga"), one.GetHash());
+            CPPUNIT_ASSERT_EQUAL(dtUtil::hash<dtUtil::RefString>()(one), one.GetHash());
+
+            CPPUNIT_ASSERT(!(one < two));
+            CPPUNIT_ASSERT(one < three);
+            CPPUNIT_ASSERT(!(three < one));
+         }
+
+         void TestConcurrentIntern()
+         {
+            RunConcurrentIntern(2U, false);
+         }
+
+         void TestConcurrentInternPerformance()
+         {
+            RunConcurrentIntern(50U, true);
+         }
+
       private:
+         void RunConcurrentIntern(unsigned passes, bool logResults)
+         {
+            const unsigned numStrings = 2000U;
+            std::vector<std::string> strings;
+            for (unsigned i = 0; i < numStrings; ++i)
+            {
+               strings.push_back("Concurrent Intern " + dtUtil::ToString(i));
+            }
+
+            const unsigned maxThreads = unsigned(std::max(OpenThreads::GetNumberOfProcessors(), 2));
+            dtCore::Timer timer;
+            for (unsigned numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+            {
+               std::vector<InternThread*> threads;
+               for (unsigned i = 0; i < numThreads; ++i)
+               {
+                  threads.push_back(new InternThread(strings, passes));
+               }
+
+               dtCore::Timer_t startTime = timer.Tick();
+               for (unsigned i = 0; i < numThreads; ++i)
+               {
+                  threads[i]->start();
+               }
+               for (unsigned i = 0; i < numThreads; ++i)
+               {
+                  threads[i]->join();
+               }
+               double seconds = timer.DeltaSec(startTime, timer.Tick());
+
+               for (unsigned i = 0; i < numThreads; ++i)
+               {
+                  CPPUNIT_ASSERT_EQUAL(size_t(numStrings), threads[i]->mResults.size());
+                  for (unsigned j = 0; j < numStrings; ++j)
+                  {
+                     CPPUNIT_ASSERT_EQUAL(strings[j], threads[i]->mResults[j].Get());
+                     CPPUNIT_ASSERT_MESSAGE("Every thread should get the same interned string.",
+                              threads[i]->mResults[j] == threads[0]->mResults[j]);
+                  }
+               }
+
+               for (unsigned i = 0; i < numThreads; ++i)
+               {
+                  delete threads[i];
+               }
+
+               if (logResults)
+               {
+                  LOG_INFO("RefString intern with " + dtUtil::ToString(numThreads) + " threads: "
+                     + dtUtil::ToString(unsigned(double(numThreads * numStrings * passes) / std::max(seconds, 0.000001)))
+                     + " strings per second");
+               }
+            }
+         }
    };
 
    // Registers the fixture into the 'registry'
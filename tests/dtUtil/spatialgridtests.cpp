@@ -0,0 +1,301 @@
+/* -*-c++-*-
+ * allTests - This source file (.h & .cpp) - Using 'The MIT License'
+ * Copyright (C) 2010, Alion Science and Technology Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This software was developed by Alion Science and Technology Corporation under
+ * circumstances in which the U. S. Government may have rights in the software.
+ */
+
+#include <prefix/unittestprefix.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <dtUtil/spatialgrid.h>
+#include <dtUtil/log.h>
+#include <dtCore/timer.h>
+#include <osg/Vec3>
+#include <osg/BoundingBox>
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+class SpatialGridTests : public CPPUNIT_NS::TestFixture
+{
+   CPPUNIT_TEST_SUITE(SpatialGridTests);
+      CPPUNIT_TEST(TestInsertMoveRemove);
+      CPPUNIT_TEST(TestQueriesMatchLinearSearch);
+      CPPUNIT_TEST(TestNearestFarAway);
+      //CPPUNIT_TEST(TestPerformance); //disabled - just used for benchmarking
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+   typedef dtUtil::SpatialGrid<int> GridType;
+
+   void setUp()
+   {
+      std::srand(42);
+      mPositions.clear();
+      mAlive.clear();
+      mHandles.clear();
+   }
+
+   void tearDown()
+   {
+   }
+
+   void TestInsertMoveRemove()
+   {
+      GridType grid(10.0f);
+      CPPUNIT_ASSERT(grid.IsEmpty());
+
+      GridType::Handle a = grid.Insert(1, osg::Vec3(1.0f, 1.0f, 1.0f));
+      GridType::Handle b = grid.Insert(2, osg::Vec3(55.0f, 1.0f, 1.0f));
+      CPPUNIT_ASSERT_EQUAL(size_t(2), grid.GetSize());
+      CPPUNIT_ASSERT_EQUAL(1, grid.Get(a));
+      CPPUNIT_ASSERT_EQUAL(2, grid.Get(b));
+
+      std::vector<int> found;
+      grid.FindInRadius(osg::Vec3(0.0f, 0.0f, 0.0f), 5.0f, found);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), found.size());
+      CPPUNIT_ASSERT_EQUAL(1, found[0]);
+
+      // Move b into the search, first within its cell and then across cells.
+      grid.Move(b, osg::Vec3(52.0f, 1.0f, 1.0f));
+      CPPUNIT_ASSERT(grid.GetPosition(b) == osg::Vec3(52.0f, 1.0f, 1.0f));
+      grid.Move(b, osg::Vec3(-2.0f, 0.0f, 0.0f));
+      found.clear();
+      grid.FindInRadius(osg::Vec3(0.0f, 0.0f, 0.0f), 5.0f, found);
+      std::sort(found.begin(), found.end());
+      CPPUNIT_ASSERT_EQUAL(size_t(2), found.size());
+      CPPUNIT_ASSERT_EQUAL(1, found[0]);
+      CPPUNIT_ASSERT_EQUAL(2, found[1]);
+
+      grid.Remove(a);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), grid.GetSize());
+      found.clear();
+      grid.FindInRadius(osg::Vec3(0.0f, 0.0f, 0.0f), 5.0f, found);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), found.size());
+      CPPUNIT_ASSERT_EQUAL(2, found[0]);
+
+      // The handle of a removed item is reused.
+      GridType::Handle c = grid.Insert(3, osg::Vec3(100.0f, 100.0f, 100.0f));
+      CPPUNIT_ASSERT_EQUAL(a, c);
+
+      found.clear();
+      grid.FindNearest(osg::Vec3(90.0f, 90.0f, 90.0f), 5U, found);
+      CPPUNIT_ASSERT_EQUAL(size_t(2), found.size());
+      CPPUNIT_ASSERT_EQUAL(3, found[0]);
+      CPPUNIT_ASSERT_EQUAL(2, found[1]);
+
+      found.clear();
+      grid.FindNearest(osg::Vec3(90.0f, 90.0f, 90.0f), 5U, found, 20.0f);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), found.size());
+
+      grid.Clear();
+      CPPUNIT_ASSERT(grid.IsEmpty());
+      found.clear();
+      grid.FindNearest(osg::Vec3(0.0f, 0.0f, 0.0f), 1U, found);
+      CPPUNIT_ASSERT(found.empty());
+   }
+
+   void TestQueriesMatchLinearSearch()
+   {
+      GridType grid(10.0f);
+      FillGrid(grid, 5000U, 1000.0f);
+
+      // Move some and remove some so the cells have been shuffled.
+      for (unsigned i = 0; i < mPositions.size(); i += 3)
+      {
+         mPositions[i] += osg::Vec3(37.0f, -12.0f, 4.0f);
+         grid.Move(mHandles[i], mPositions[i]);
+      }
+      for (unsigned i = 0; i < mPositions.size(); i += 7)
+      {
+         grid.Remove(mHandles[i]);
+         mAlive[i] = false;
+      }
+
+      for (unsigned pass = 0; pass < 2; ++pass)
+      {
+         if (pass == 1)
+         {
+            grid.SetCellSize(3.0f);
+         }
+
+         for (unsigned q = 0; q < 100; ++q)
+         {
+            osg::Vec3 center = RandomPos(1200.0f);
+
+            std::vector<int> found;
+            grid.FindInRadius(center, 50.0f, found);
+            std::vector<int> expected;
+            for (unsigned i = 0; i < mPositions.size(); ++i)
+            {
+               if (mAlive[i] && (mPositions[i] - center).length2() <= 50.0f * 50.0f)
+               {
+                  expected.push_back(int(i));
+               }
+            }
+            std::sort(found.begin(), found.end());
+            CPPUNIT_ASSERT(expected == found);
+
+            osg::BoundingBox box(center, center + osg::Vec3(80.0f, 40.0f, 20.0f));
+            found.clear();
+            grid.FindInBox(box, found);
+            expected.clear();
+            for (unsigned i = 0; i < mPositions.size(); ++i)
+            {
+               if (mAlive[i] && box.contains(mPositions[i]))
+               {
+                  expected.push_back(int(i));
+               }
+            }
+            std::sort(found.begin(), found.end());
+            CPPUNIT_ASSERT(expected == found);
+
+            found.clear();
+            grid.FindNearest(center, 8U, found);
+            std::vector<float> distances;
+            for (unsigned i = 0; i < mPositions.size(); ++i)
+            {
+               if (mAlive[i])
+               {
+                  distances.push_back((mPositions[i] - center).length2());
+               }
+            }
+            std::sort(distances.begin(), distances.end());
+            CPPUNIT_ASSERT_EQUAL(size_t(8), found.size());
+            for (unsigned i = 0; i < found.size(); ++i)
+            {
+               CPPUNIT_ASSERT_EQUAL(distances[i], (mPositions[found[i]] - center).length2());
+            }
+         }
+      }
+   }
+
+   void TestNearestFarAway()
+   {
+      GridType grid(1.0f);
+      FillGrid(grid, 100U, 10.0f);
+
+      // A query thousands of cells away from everything should still find the nearest ones.
+      std::vector<int> found;
+      grid.FindNearest(osg::Vec3(5000.0f, 0.0f, 0.0f), 3U, found);
+      CPPUNIT_ASSERT_EQUAL(size_t(3), found.size());
+
+      float best = FLT_MAX;
+      for (unsigned i = 0; i < mPositions.size(); ++i)
+      {
+         best = std::min(best, (mPositions[i] - osg::Vec3(5000.0f, 0.0f, 0.0f)).length2());
+      }
+      CPPUNIT_ASSERT_EQUAL(best, (mPositions[found[0]] - osg::Vec3(5000.0f, 0.0f, 0.0f)).length2());
+   }
+
+   void TestPerformance()
+   {
+      const unsigned numItems = 10000U;
+      const unsigned numFrames = 20U;
+      const unsigned queriesPerFrame = 500U;
+      const float queryRadius = 40.0f;
+
+      GridType grid(queryRadius);
+      FillGrid(grid, numItems, 2000.0f);
+      std::vector<osg::Vec3> startPositions = mPositions;
+
+      dtCore::Timer timer;
+      size_t gridFound = 0, linearFound = 0;
+
+      // Every item moves each frame as actors would, then the frame's queries run.
+      dtCore::Timer_t start = timer.Tick();
+      for (unsigned frame = 0; frame < numFrames; ++frame)
+      {
+         for (unsigned i = 0; i < numItems; ++i)
+         {
+            mPositions[i] += osg::Vec3(1.0f, 0.5f, 0.0f);
+            grid.Move(mHandles[i], mPositions[i]);
+         }
+
+         std::vector<int> found;
+         for (unsigned q = 0; q < queriesPerFrame; ++q)
+         {
+            found.clear();
+            grid.FindInRadius(mPositions[q], queryRadius, found);
+            gridFound += found.size();
+         }
+      }
+      double gridSeconds = timer.DeltaSec(start, timer.Tick());
+
+      mPositions = startPositions;
+      start = timer.Tick();
+      for (unsigned frame = 0; frame < numFrames; ++frame)
+      {
+         for (unsigned i = 0; i < numItems; ++i)
+         {
+            mPositions[i] += osg::Vec3(1.0f, 0.5f, 0.0f);
+         }
+
+         for (unsigned q = 0; q < queriesPerFrame; ++q)
+         {
+            const osg::Vec3& center = mPositions[q];
+            for (unsigned i = 0; i < numItems; ++i)
+            {
+               if ((mPositions[i] - center).length2() <= queryRadius * queryRadius)
+               {
+                  ++linearFound;
+               }
+            }
+         }
+      }
+      double linearSeconds = timer.DeltaSec(start, timer.Tick());
+
+      std::ostringstream ss;
+      ss << numFrames << " frames of moving " << numItems << " items and " << queriesPerFrame
+         << " radius queries took " << gridSeconds << " seconds with the grid and "
+         << linearSeconds << " seconds with a linear search.";
+      LOG_INFO(ss.str());
+
+      CPPUNIT_ASSERT_EQUAL(linearFound, gridFound);
+   }
+
+private:
+   osg::Vec3 RandomPos(float extent)
+   {
+      return osg::Vec3(
+         (float(std::rand()) / float(RAND_MAX) * 2.0f - 1.0f) * extent,
+         (float(std::rand()) / float(RAND_MAX) * 2.0f - 1.0f) * extent,
+         (float(std::rand()) / float(RAND_MAX)) * extent * 0.1f);
+   }
+
+   void FillGrid(GridType& grid, unsigned count, float extent)
+   {
+      for (unsigned i = 0; i < count; ++i)
+      {
+         mPositions.push_back(RandomPos(extent));
+         mAlive.push_back(true);
+         mHandles.push_back(grid.Insert(int(i), mPositions.back()));
+      }
+   }
+
+   std::vector<osg::Vec3> mPositions;
+   std::vector<bool> mAlive;
+   std::vector<GridType::Handle> mHandles;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SpatialGridTests);
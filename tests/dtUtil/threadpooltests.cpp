@@ -30,6 +30,12 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <dtUtil/threadpool.h>
 #include <dtUtil/log.h>
+#include <dtUtil/stringutils.h>
+#include <dtCore/timer.h>
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Thread>
+#include <algorithm>
+#include <vector>
 
 class TestTask : public dtUtil::ThreadPoolTask
 {
@@ -71,6 +77,72 @@ public:
    DT_DECLARE_ACCESSOR_INLINE(bool, OkayToDelete);
 };
 
+/// Records the order it finished in, so continuations can be checked.
+class OrderedTask : public dtUtil::ThreadPoolTask
+{
+public:
+   OrderedTask(OpenThreads::Atomic& counter)
+   : mCounter(counter)
+   , mOrder(0U)
+   {
+   }
+
+   virtual void operator()()
+   {
+      mOrder = ++mCounter;
+   }
+
+   OpenThreads::Atomic& mCounter;
+   unsigned mOrder;
+};
+
+/// Splits its work into child tasks from inside a worker, so the other workers have to steal them.
+class SpawningTask : public dtUtil::ThreadPoolTask
+{
+public:
+   SpawningTask(OpenThreads::Atomic& counter, unsigned numChildren)
+   : mCounter(counter)
+   {
+      for (unsigned i = 0; i < numChildren; ++i)
+      {
+         mChildren.push_back(new OrderedTask(counter));
+      }
+   }
+
+   virtual void operator()()
+   {
+      for (unsigned i = 0; i < mChildren.size(); ++i)
+      {
+         dtUtil::ThreadPool::AddTask(*mChildren[i]);
+      }
+   }
+
+   OpenThreads::Atomic& mCounter;
+   std::vector<dtCore::RefPtr<OrderedTask> > mChildren;
+};
+
+/// A small, fixed amount of work for timing the scheduler itself.
+class BenchmarkTask : public dtUtil::ThreadPoolTask
+{
+public:
+   BenchmarkTask()
+   : mResult(0U)
+   {
+   }
+
+   virtual void operator()()
+   {
+      unsigned value = mResult;
+      for (unsigned i = 0; i < 200U; ++i)
+      {
+         value = value * 1664525U + 1013904223U;
+      }
+      mResult = value;
+   }
+
+   unsigned mResult;
+};
+
 /**
  * @class ThreadPoolTests
  * @brief Unit tests for the string utils class
@@ -78,7 +150,11 @@ public:
 class ThreadPoolTests : public CPPUNIT_NS::TestFixture {
    CPPUNIT_TEST_SUITE(ThreadPoolTests);
    CPPUNIT_TEST(TestImmediateTasks);
+   CPPUNIT_TEST(TestHasImmediateWorkerThreads);
    CPPUNIT_TEST(TestBackgroundTasksWithBlock);
+   CPPUNIT_TEST(TestContinuations);
+   CPPUNIT_TEST(TestTasksAddedByTasks);
+   //CPPUNIT_TEST(TestThroughput); //disabled - just used for benchmarking
    CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -101,6 +177,22 @@ class ThreadPoolTests : public CPPUNIT_NS::TestFixture {
       dtUtil::ThreadPool::Init(mOldNumImmediateWorkerThreads);
    }
 
+   void TestHasImmediateWorkerThreads()
+   {
+      CPPUNIT_ASSERT(dtUtil::ThreadPool::HasImmediateWorkerThreads());
+
+      dtUtil::ThreadPool::Shutdown();
+      CPPUNIT_ASSERT(!dtUtil::ThreadPool::HasImmediateWorkerThreads());
+
+      // With no workers, only ExecuteTasks runs immediate tasks.
+      dtUtil::ThreadPool::Init(0);
+      CPPUNIT_ASSERT(!dtUtil::ThreadPool::HasImmediateWorkerThreads());
+
+      dtUtil::ThreadPool::Shutdown();
+      dtUtil::ThreadPool::Init(1);
+      CPPUNIT_ASSERT(dtUtil::ThreadPool::HasImmediateWorkerThreads());
+   }
+
    void TestImmediateTasks()
    {
       std::vector<dtCore::RefPtr<TestTask> > testTasks;
@@ -144,6 +236,114 @@ class ThreadPoolTests : public CPPUNIT_NS::TestFixture {
       }
    }
 
+   void TestContinuations()
+   {
+      OpenThreads::Atomic counter;
+      dtCore::RefPtr<OrderedTask> first = new OrderedTask(counter);
+      dtCore::RefPtr<OrderedTask> second = new OrderedTask(counter);
+      dtCore::RefPtr<OrderedTask> join = new OrderedTask(counter);
+      dtCore::RefPtr<OrderedTask> background = new OrderedTask(counter);
+
+      join->AddDependency(*first);
+      join->AddDependency(*second);
+      background->AddDependency(*join);
+      CPPUNIT_ASSERT_EQUAL(2U, join->GetNumPendingDependencies());
+
+      // Adding the continuations first must not run them.
+      dtUtil::ThreadPool::AddTask(*background, dtUtil::ThreadPool::BACKGROUND);
+      dtUtil::ThreadPool::AddTask(*join);
+      CPPUNIT_ASSERT(!join->WaitUntilComplete(10));
+      CPPUNIT_ASSERT_EQUAL(0U, join->mOrder);
+
+      dtUtil::ThreadPool::AddTask(*first);
+      dtUtil::ThreadPool::AddTask(*second);
+      // The join is queued before its last dependency counts as done, so this waits for it too.
+      dtUtil::ThreadPool::ExecuteTasks();
+
+      CPPUNIT_ASSERT(first->mOrder > 0U);
+      CPPUNIT_ASSERT(second->mOrder > 0U);
+      CPPUNIT_ASSERT(join->mOrder > first->mOrder);
+      CPPUNIT_ASSERT(join->mOrder > second->mOrder);
+      CPPUNIT_ASSERT_EQUAL(0U, join->GetNumPendingDependencies());
+
+      CPPUNIT_ASSERT(background->WaitUntilComplete(1000));
+      CPPUNIT_ASSERT(background->mOrder > join->mOrder);
+
+      // A dependency on a task that already ran is satisfied right away.
+      dtCore::RefPtr<OrderedTask> late = new OrderedTask(counter);
+      late->AddDependency(*first);
+      CPPUNIT_ASSERT_EQUAL(0U, late->GetNumPendingDependencies());
+      dtUtil::ThreadPool::AddTask(*late);
+      dtUtil::ThreadPool::ExecuteTasks();
+      CPPUNIT_ASSERT(late->mOrder > background->mOrder);
+
+      // Once a reused task is reset, a new dependency waits for its next run.
+      first->ResetCompletion();
+      dtCore::RefPtr<OrderedTask> next = new OrderedTask(counter);
+      next->AddDependency(*first);
+      CPPUNIT_ASSERT_EQUAL(1U, next->GetNumPendingDependencies());
+      dtUtil::ThreadPool::AddTask(*next);
+      CPPUNIT_ASSERT(!next->WaitUntilComplete(10));
+      CPPUNIT_ASSERT_EQUAL(0U, next->mOrder);
+
+      dtUtil::ThreadPool::AddTask(*first);
+      dtUtil::ThreadPool::ExecuteTasks();
+      CPPUNIT_ASSERT(next->WaitUntilComplete(1000));
+      CPPUNIT_ASSERT(first->mOrder > late->mOrder);
+      CPPUNIT_ASSERT(next->mOrder > first->mOrder);
+   }
+
+   void TestTasksAddedByTasks()
+   {
+      OpenThreads::Atomic counter;
+      const unsigned numChildren = 200U;
+      dtCore::RefPtr<SpawningTask> parent = new SpawningTask(counter, numChildren);
+
+      dtUtil::ThreadPool::AddTask(*parent);
+      dtUtil::ThreadPool::ExecuteTasks();
+
+      // the children are added before the parent counts as done, so all of them must have run.
+      CPPUNIT_ASSERT_EQUAL(numChildren, unsigned(counter));
+      for (unsigned i = 0; i < numChildren; ++i)
+      {
+         CPPUNIT_ASSERT(parent->mChildren[i]->mOrder > 0U);
+      }
+   }
+
+   void TestThroughput()
+   {
+      const unsigned numTasks = 20000U;
+      std::vector<dtCore::RefPtr<BenchmarkTask> > tasks;
+      for (unsigned i = 0; i < numTasks; ++i)
+      {
+         tasks.push_back(new BenchmarkTask);
+      }
+
+      dtCore::Timer timer;
+      int maxWorkers = std::max(OpenThreads::GetNumberOfProcessors() - 1, 1);
+      for (int workers = 0; workers <= maxWorkers; workers = (workers == 0) ? 1 : workers * 2)
+      {
+         dtUtil::ThreadPool::Shutdown();
+         dtUtil::ThreadPool::Init(workers);
+
+         dtCore::Timer_t startTime = timer.Tick();
+         for (unsigned i = 0; i < numTasks; ++i)
+         {
+            dtUtil::ThreadPool::AddTask(*tasks[i]);
+         }
+         dtUtil::ThreadPool::ExecuteTasks();
+         double seconds = timer.DeltaSec(startTime, timer.Tick());
+
+         for (unsigned i = 0; i < numTasks; ++i)
+         {
+            CPPUNIT_ASSERT(tasks[i]->WaitUntilComplete(1000));
+         }
+
+         LOG_INFO("ThreadPool with " + dtUtil::ToString(workers) + " worker threads plus the main thread: "
+            + dtUtil::ToString(unsigned(double(numTasks) / std::max(seconds, 0.000001))) + " tasks per second");
+      }
+   }
+
    private:
       unsigned mOldNumImmediateWorkerThreads;
 };
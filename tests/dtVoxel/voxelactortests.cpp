@@ -26,6 +26,9 @@
 #include <dtVoxel/voxelactor.h>
 #include <dtVoxel/voxelactorregistry.h>
 #include <dtVoxel/aabbintersector.h>
+#include <dtVoxel/createmeshtask.h>
+#include <osg/Geode>
+#include <osg/Geometry>
 #include "../dtGame/basegmtests.h"
 
 #include <dtVoxel/voxelmessagetype.h>
@@ -45,6 +48,7 @@ namespace dtVoxel
          CPPUNIT_TEST(testVoxelActorRemoteUpdate);
          CPPUNIT_TEST(testVolumeUpdateMessageToFromStream);
          CPPUNIT_TEST(testVoxelColliderAABB);
+         CPPUNIT_TEST(testCreateMeshTask);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -254,6 +258,85 @@ namespace dtVoxel
             CPPUNIT_FAIL(ex.ToString());
          }
       }
+
+      /// Sets the voxels within radius of center that are also inside a sphere of sphereRadius at the origin.
+      static void FillBall(openvdb::FloatGrid& grid, const openvdb::Coord& center, int radius, float value, float sphereRadius)
+      {
+         openvdb::FloatGrid::Accessor accessor = grid.getAccessor();
+         for (int x = -radius; x <= radius; ++x)
+         {
+            for (int y = -radius; y <= radius; ++y)
+            {
+               for (int z = -radius; z <= radius; ++z)
+               {
+                  openvdb::Coord c = center.offsetBy(x, y, z);
+                  if (x * x + y * y + z * z <= radius * radius && c.asVec3d().length() <= sphereRadius)
+                  {
+                     accessor.setValue(c, value);
+                  }
+               }
+            }
+         }
+      }
+
+      static osg::Geometry* BuildMesh(CreateMeshTask& task, CreateMeshTask::GenerateMode mode, dtCore::RefPtr<osg::Geode>& holder)
+      {
+         task.SetMode(mode);
+         task();
+         CPPUNIT_ASSERT(task.IsDone());
+         holder = task.TakeGeometry();
+         CPPUNIT_ASSERT_EQUAL(1U, holder->getNumDrawables());
+         return holder->getDrawable(0)->asGeometry();
+      }
+
+      static void CheckSameMesh(osg::Geometry& expected, osg::Geometry& actual)
+      {
+         const osg::DrawElementsUInt& expectedIndices = static_cast<const osg::DrawElementsUInt&>(*expected.getPrimitiveSet(0));
+         const osg::DrawElementsUInt& actualIndices = static_cast<const osg::DrawElementsUInt&>(*actual.getPrimitiveSet(0));
+         const osg::Vec3Array& expectedVerts = static_cast<const osg::Vec3Array&>(*expected.getVertexArray());
+         const osg::Vec3Array& actualVerts = static_cast<const osg::Vec3Array&>(*actual.getVertexArray());
+
+         CPPUNIT_ASSERT_EQUAL(expectedIndices.size(), actualIndices.size());
+         CPPUNIT_ASSERT_EQUAL(expectedVerts.size(), actualVerts.size());
+         for (unsigned i = 0; i < expectedIndices.size(); ++i)
+         {
+            CPPUNIT_ASSERT(actualIndices[i] < actualVerts.size());
+            CPPUNIT_ASSERT_EQUAL(expectedVerts[expectedIndices[i]], actualVerts[actualIndices[i]]);
+         }
+      }
+
+      void testCreateMeshTask()
+      {
+         const osg::Vec3 offset(-12.0f, -12.0f, -12.0f);
+         const osg::Vec3 texelSize(0.5f, 0.5f, 0.5f);
+         const osg::Vec3i resolution(48, 48, 48);
+
+         openvdb::FloatGrid::Ptr grid = openvdb::FloatGrid::create(0.0f);
+         FillBall(*grid, openvdb::Coord(0, 0, 0), 9, 2.0f, 9.0f);
+
+         dtCore::RefPtr<osg::Geode> singleHolder, multiHolder, updatedHolder;
+
+         dtCore::RefPtr<CreateMeshTask> singleTask = new CreateMeshTask(offset, texelSize, resolution, 1.0, grid);
+         osg::Geometry* single = BuildMesh(*singleTask, CreateMeshTask::RunInSingleThread, singleHolder);
+
+         dtCore::RefPtr<CreateMeshTask> multiTask = new CreateMeshTask(offset, texelSize, resolution, 1.0, grid);
+         osg::Geometry* multi = BuildMesh(*multiTask, CreateMeshTask::Default, multiHolder);
+
+         CPPUNIT_ASSERT(single->getPrimitiveSet(0)->getNumIndices() > 0U);
+         CheckSameMesh(*single, *multi);
+
+         // Mesh the sphere with a hole in it, then fill the hole and only remesh around it as a deformation would.
+         FillBall(*grid, openvdb::Coord(0, 0, 9), 3, 0.0f, 9.0f);
+         dtCore::RefPtr<CreateMeshTask> updateTask = new CreateMeshTask(offset, texelSize, resolution, 1.0, grid);
+         osg::Geometry* holed = BuildMesh(*updateTask, CreateMeshTask::Default, updatedHolder);
+         CPPUNIT_ASSERT(holed->getPrimitiveSet(0)->getNumIndices() != multi->getPrimitiveSet(0)->getNumIndices());
+
+         FillBall(*grid, openvdb::Coord(0, 0, 9), 3, 2.0f, 9.0f);
+         updateTask->UpdateWithBounds(osg::BoundingBox(osg::Vec3(-4.0f, -4.0f, 5.0f), osg::Vec3(4.0f, 4.0f, 13.0f)));
+         osg::Geometry* updated = BuildMesh(*updateTask, CreateMeshTask::Default, updatedHolder);
+
+         CheckSameMesh(*multi, *updated);
+      }
    };
 
    CPPUNIT_TEST_SUITE_REGISTRATION(VoxelActorTests);
@@ -0,0 +1,97 @@
+/* -*-c++-*-
+ * MapConvert - main (.h & .cpp) - Using 'The MIT License'
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+///Utility to load a Map and save it in either the xml or the binary map format.
+/// Examples
+///     MapConvert.exe "c:/DemoMap" MyCoolMap MyCoolMap.dtmap
+///            will write MyCoolMap into MyCoolMap.dtmap in the binary format
+///     MapConvert.exe "c:/DemoMap" MyCoolMap MyCoolMap.dtmap xml
+///            will write MyCoolMap into MyCoolMap.dtmap as xml
+
+#include <dtUtil/log.h>
+#include <dtCore/project.h>
+#include <dtCore/exceptionenum.h>
+#include <dtCore/map.h>
+#include <dtCore/mapxml.h>
+
+void usage(const std::string& progName)
+{
+   LOG_ALWAYS("usage:" + progName + " <Project Context Path> <Map Name> <outputFile> [binary|xml]");
+}
+
+int main(int argc, char** argv)
+{
+   if (argc < 4)
+   {
+      usage(std::string(argv[0]));
+      return 1;
+   }
+
+   const std::string contextPath(argv[1]);
+   const std::string mapName(argv[2]);
+   const std::string outputFilename(argv[3]);
+   bool binary = true;
+
+   if (argc > 4)
+   {
+      const std::string format(argv[4]);
+      if (format == "xml")
+      {
+         binary = false;
+      }
+      else if (format != "binary")
+      {
+         usage(std::string(argv[0]));
+         return 1;
+      }
+   }
+
+   try
+   {
+      dtCore::Project::GetInstance().SetContext(contextPath, true);
+   }
+   catch (dtCore::ProjectInvalidContextException& e)
+   {
+      LOG_ERROR("Could not load project context");
+      e.LogException();
+      return 1;
+   }
+
+   try
+   {
+      dtCore::Map& map = dtCore::Project::GetInstance().GetMap(mapName);
+
+      dtCore::RefPtr<dtCore::MapWriter> writer = new dtCore::MapWriter();
+      writer->SetBinary(binary);
+      writer->Save(map, outputFilename);
+   }
+   catch (const dtUtil::Exception& e)
+   {
+      e.LogException();
+      return 1;
+   }
+
+   LOG_ALWAYS("Map written to: " + outputFilename + (binary ? " as binary." : " as xml."));
+
+   dtCore::Project::GetInstance().CloseAllMaps(true);
+   return 0;
+}